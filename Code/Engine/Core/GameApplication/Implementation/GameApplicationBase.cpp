@@ -17,6 +17,7 @@
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Time/Timestamp.h>
+#include <Foundation/Utilities/Metrics.h>
 #include <Texture/Image/Image.h>
 
 ezGameApplicationBase* ezGameApplicationBase::s_pGameApplicationBaseInstance = nullptr;
@@ -528,9 +529,11 @@ void ezGameApplicationBase::Run_FinishFrame()
 {
   ezTelemetry::PerFrameUpdate();
   ezResourceManager::PerFrameUpdate();
+  ezFileSystem::PerFrameUpdate();
   ezTaskSystem::FinishFrameTasks();
   ezFrameAllocator::Swap();
   ezProfilingSystem::StartNewFrame();
+  ezMetrics::Update();
 
   // if many messages have been logged, make sure they get written to disk
   ezLog::Flush(100, ezTime::MakeFromSeconds(10));
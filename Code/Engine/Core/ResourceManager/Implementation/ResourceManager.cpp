@@ -6,6 +6,7 @@
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Metrics.h>
 
 /// \todo Do not unload resources while they are acquired
 /// \todo Resource Type Memory Thresholds
@@ -25,6 +26,8 @@
 ezUniquePtr<ezResourceManagerState> ezResourceManager::s_pState;
 ezMutex ezResourceManager::s_ResourceMutex;
 
+static ezMetricGauge s_LoadingQueueLength("Resource Manager/Loading Queue");
+
 // clang-format off
 EZ_BEGIN_SUBSYSTEM_DECLARATION(Core, ResourceManager)
 
@@ -488,6 +491,8 @@ void ezResourceManager::PerFrameUpdate()
     }
 
     s_pState->m_ResourcesToUnloadOnMainThread.Clear();
+
+    s_LoadingQueueLength.Set(s_pState->m_LoadingQueue.GetCount());
   }
 
   if (s_pState->m_AutoFreeUnusedTimeout.IsPositive())
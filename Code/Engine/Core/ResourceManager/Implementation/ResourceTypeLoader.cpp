@@ -3,10 +3,12 @@
 #include <Core/ResourceManager/Resource.h>
 #include <Core/ResourceManager/ResourceTypeLoader.h>
 #include <Foundation/Containers/Blob.h>
+#include <Foundation/IO/AsyncFileReader.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/ConditionVariable.h>
 
 struct FileResourceLoadData
 {
@@ -14,6 +16,13 @@ struct FileResourceLoadData
   ezRawMemoryStreamReader m_Reader;
 };
 
+// Smaller files are read directly, handing them to the reader's thread would cost more than the read itself
+static constexpr ezUInt64 s_uiMinAsyncReadSize = 256 * 1024;
+static constexpr ezUInt64 s_uiAsyncReadChunkSize = 1024 * 1024;
+
+ezResourceLoaderFromFile::ezResourceLoaderFromFile() = default;
+ezResourceLoaderFromFile::~ezResourceLoaderFromFile() = default;
+
 ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pResource)
 {
   EZ_PROFILE_SCOPE("ReadResourceFile");
@@ -51,7 +60,12 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   const ezUInt64 uiOffset = w.GetNumWrittenBytes();
 
-  File.ReadBytes(pBlobPtr + uiOffset, uiFileSize);
+  // archives and other virtual data directories can only be read through the file reader
+  if (uiFileSize < s_uiMinAsyncReadSize || !ezOSFile::ExistsFile(File.GetFilePathAbsolute()) ||
+      ReadFileAsync(File.GetFilePathAbsolute(), uiFileSize, pBlobPtr + uiOffset).Failed())
+  {
+    File.ReadBytes(pBlobPtr + uiOffset, uiFileSize);
+  }
 
   pData->m_Reader.Reset(pBlobPtr, w.GetNumWrittenBytes() + uiFileSize);
   res.m_pDataStream = &pData->m_Reader;
@@ -60,6 +74,64 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
   return res;
 }
 
+ezResult ezResourceLoaderFromFile::ReadFileAsync(ezStringView sAbsolutePath, ezUInt64 uiFileSize, ezUInt8* pDestination)
+{
+  {
+    EZ_LOCK(m_FileReaderMutex);
+
+    if (m_pFileReader == nullptr)
+    {
+      m_pFileReader = EZ_DEFAULT_NEW(ezAsyncFileReader);
+    }
+  }
+
+  // Several data loading tasks may use the reader at the same time, so wait for this file's reads only, instead of using WaitForAll().
+  ezHybridArray<ezAsyncFileRead, 16> reads;
+  for (ezUInt64 uiOffset = 0; uiOffset < uiFileSize; uiOffset += s_uiAsyncReadChunkSize)
+  {
+    ezAsyncFileRead& read = reads.ExpandAndGetRef();
+    read.m_sAbsolutePath = sAbsolutePath;
+    read.m_uiOffset = uiOffset;
+    read.m_uiSize = ezMath::Min(s_uiAsyncReadChunkSize, uiFileSize - uiOffset);
+    read.m_pDestination = pDestination + uiOffset;
+  }
+
+  // the waiting thread can only return once the last callback has released the lock, so the state can live on the stack
+  struct ChunkReads
+  {
+    ezConditionVariable m_Done;
+    ezUInt32 m_uiReadsLeft = 0;
+    bool m_bFailed = false;
+  };
+
+  ChunkReads state;
+  state.m_uiReadsLeft = reads.GetCount();
+
+  m_pFileReader->Submit(reads, [pState = &state](const ezAsyncFileRead& read, ezUInt64 uiBytesRead, ezResult result)
+    {
+      EZ_LOCK(pState->m_Done);
+
+      if (result.Failed() || uiBytesRead != read.m_uiSize)
+      {
+        pState->m_bFailed = true;
+      }
+
+      if (--pState->m_uiReadsLeft == 0)
+      {
+        pState->m_Done.SignalAll();
+      }
+    });
+
+  EZ_LOCK(state.m_Done);
+
+  while (state.m_uiReadsLeft > 0)
+  {
+    state.m_Done.UnlockWaitForSignalAndLock();
+  }
+
+  return state.m_bFailed ? EZ_FAILURE : EZ_SUCCESS;
+}
+
 void ezResourceLoaderFromFile::CloseDataStream(const ezResource* pResource, const ezResourceLoadData& loaderData)
 {
   FileResourceLoadData* pData = static_cast<FileResourceLoadData*>(loaderData.m_pCustomLoaderData);
@@ -4,6 +4,16 @@
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Utilities/Metrics.h>
+
+namespace
+{
+  constexpr double s_DataLoadTimeBucketsMS[] = {1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0, 200.0, 500.0, 1000.0};
+
+  ezMetricCounter s_DataLoads("Resource Manager/Data Loads");
+  ezMetricHistogram s_DataLoadTime("Resource Manager/Data Load Time (ms)", s_DataLoadTimeBucketsMS);
+} // namespace
 
 ezResourceManagerWorkerDataLoad::ezResourceManagerWorkerDataLoad() = default;
 ezResourceManagerWorkerDataLoad::~ezResourceManagerWorkerDataLoad() = default;
@@ -48,8 +58,12 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
   EZ_ASSERT_DEV(pLoader != nullptr, "No Loader function available for Resource Type '{0}'", pResourceToLoad->GetDynamicRTTI()->GetTypeName());
 
+  ezStopwatch loadTimer;
   ezResourceLoadData LoaderData = pLoader->OpenDataStream(pResourceToLoad);
 
+  s_DataLoads.Add();
+  s_DataLoadTime.Record(loadTimer.GetRunningTotal().GetMilliseconds());
+
   // we need this info later to do some work in a lock, all the directly following code is outside the lock
   const bool bResourceIsLoadedOnMainThread = pResourceToLoad->GetBaseResourceFlags().IsAnySet(ezResourceFlags::UpdateOnMainThread);
 
@@ -3,7 +3,11 @@
 #include <Core/ResourceManager/Implementation/Declarations.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/Stream.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Time/Timestamp.h>
+#include <Foundation/Types/UniquePtr.h>
+
+class ezAsyncFileReader;
 
 /// \brief Data returned by ezResourceTypeLoader implementations.
 struct EZ_CORE_DLL ezResourceLoadData
@@ -56,12 +60,23 @@ public:
 /// The loader will interpret the ezResource 'resource ID' as a path, read that full file into a memory stream.
 /// The file modification data is stored as well.
 /// Resources that use this loader can update their data as if they were reading the file directly.
+///
+/// Larger files that are stored directly on disk are read in chunks through an ezAsyncFileReader, which keeps several reads in flight.
 class EZ_CORE_DLL ezResourceLoaderFromFile : public ezResourceTypeLoader
 {
 public:
+  ezResourceLoaderFromFile();
+  ~ezResourceLoaderFromFile();
+
   virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override;
   virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& loaderData) override;
   virtual bool IsResourceOutdated(const ezResource* pResource) const override;
+
+private:
+  ezResult ReadFileAsync(ezStringView sAbsolutePath, ezUInt64 uiFileSize, ezUInt8* pDestination);
+
+  ezMutex m_FileReaderMutex;
+  ezUniquePtr<ezAsyncFileReader> m_pFileReader;
 };
 
 
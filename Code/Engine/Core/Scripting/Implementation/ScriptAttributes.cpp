@@ -40,5 +40,12 @@ ezScriptBaseClassFunctionAttribute::ezScriptBaseClassFunctionAttribute(ezUInt16
 {
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezScriptThreadSafeAttribute, 1, ezRTTIDefaultAllocator<ezScriptThreadSafeAttribute>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
 
 EZ_STATICLINK_FILE(Core, Core_Scripting_Implementation_ScriptAttributes);
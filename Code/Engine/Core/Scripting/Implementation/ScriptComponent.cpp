@@ -6,11 +6,12 @@
 #include <Core/WorldSerializer/WorldWriter.h>
 
 // clang-format off
-EZ_BEGIN_COMPONENT_TYPE(ezScriptComponent, 1, ezComponentMode::Static)
+EZ_BEGIN_COMPONENT_TYPE(ezScriptComponent, 2, ezComponentMode::Static)
 {
   EZ_BEGIN_PROPERTIES
   {
     EZ_ACCESSOR_PROPERTY("UpdateInterval", GetUpdateInterval, SetUpdateInterval)->AddAttributes(new ezClampValueAttribute(ezTime::MakeZero(), ezVariant())),
+    EZ_ACCESSOR_PROPERTY("UpdateInParallel", GetUpdateInParallel, SetUpdateInParallel),
     EZ_ACCESSOR_PROPERTY("ScriptClass", GetScriptClassFile, SetScriptClassFile)->AddAttributes(new ezAssetBrowserAttribute("CompatibleAsset_ScriptClass")),
     EZ_MAP_ACCESSOR_PROPERTY("Parameters", GetParameters, GetParameter, SetParameter, RemoveParameter)->AddAttributes(new ezExposedParametersAttribute("ScriptClass")),
   }
@@ -40,6 +41,7 @@ void ezScriptComponent::SerializeComponent(ezWorldWriter& stream) const
 
   s << m_hScriptClass;
   s << m_UpdateInterval;
+  s << m_bUpdateInParallel;
 
   ezUInt16 uiNumParams = static_cast<ezUInt16>(m_Parameters.GetCount());
   s << uiNumParams;
@@ -54,12 +56,17 @@ void ezScriptComponent::SerializeComponent(ezWorldWriter& stream) const
 void ezScriptComponent::DeserializeComponent(ezWorldReader& stream)
 {
   SUPER::DeserializeComponent(stream);
-  // const ezUInt32 uiVersion = stream.GetComponentTypeVersion(GetStaticRTTI());
+  const ezUInt32 uiVersion = stream.GetComponentTypeVersion(GetStaticRTTI());
   auto& s = stream.GetStream();
 
   s >> m_hScriptClass;
   s >> m_UpdateInterval;
 
+  if (uiVersion >= 2)
+  {
+    s >> m_bUpdateInParallel;
+  }
+
   ezUInt16 uiNumParams = 0;
   s >> uiNumParams;
   m_Parameters.Reserve(uiNumParams);
@@ -182,6 +189,18 @@ ezTime ezScriptComponent::GetUpdateInterval() const
   return m_UpdateInterval;
 }
 
+void ezScriptComponent::SetUpdateInParallel(bool bUpdateInParallel)
+{
+  m_bUpdateInParallel = bUpdateInParallel;
+
+  AddUpdateFunctionToSchedule();
+}
+
+bool ezScriptComponent::GetUpdateInParallel() const
+{
+  return m_bUpdateInParallel;
+}
+
 const ezRangeView<const char*, ezUInt32> ezScriptComponent::GetParameters() const
 {
   return ezRangeView<const char*, ezUInt32>([]() -> ezUInt32
@@ -310,12 +329,27 @@ void ezScriptComponent::AddUpdateFunctionToSchedule()
   if (auto pUpdateFunction = GetScriptFunction(ezComponent_ScriptBaseClassFunctions::Update))
   {
     const bool bOnlyWhenSimulating = true;
-    pModule->AddUpdateFunctionToSchedule(pUpdateFunction, m_pInstance.Borrow(), m_UpdateInterval, bOnlyWhenSimulating);
+
+    bool bUpdateInParallel = false;
+    if (m_bUpdateInParallel)
+    {
+      bUpdateInParallel = m_pInstance->CanUpdateInParallel(pUpdateFunction);
+
+      if (!bUpdateInParallel)
+      {
+        ezLog::Warning("Script class '{}' can't be updated in parallel and is updated serially instead.", GetScriptClassFile());
+      }
+    }
+
+    pModule->AddUpdateFunctionToSchedule(pUpdateFunction, m_pInstance.Borrow(), m_UpdateInterval, bOnlyWhenSimulating, bUpdateInParallel);
+    m_bIsUpdatedInParallel = bUpdateInParallel;
   }
 }
 
 void ezScriptComponent::RemoveUpdateFunctionToSchedule()
 {
+  m_bIsUpdatedInParallel = false;
+
   auto pModule = GetWorld()->GetOrCreateModule<ezScriptWorldModule>();
   if (auto pUpdateFunction = GetScriptFunction(ezComponent_ScriptBaseClassFunctions::Update))
   {
@@ -2,6 +2,7 @@
 
 #include <Core/Scripting/ScriptClassResource.h>
 #include <Core/Scripting/ScriptWorldModule.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 // clang-format off
 EZ_IMPLEMENT_WORLD_MODULE(ezScriptWorldModule);
@@ -9,6 +10,8 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezScriptWorldModule, 1, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+static thread_local bool s_bIsExecutingInParallel = false;
+
 ezScriptWorldModule::ezScriptWorldModule(ezWorld* pWorld)
   : ezWorldModule(pWorld)
 {
@@ -26,20 +29,38 @@ void ezScriptWorldModule::Initialize()
 
     RegisterUpdateFunction(updateDesc);
   }
+
+  {
+    auto updateDesc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezScriptWorldModule::CallParallelUpdateFunctions, this);
+    updateDesc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
+
+    RegisterUpdateFunction(updateDesc);
+  }
 }
 
 void ezScriptWorldModule::WorldClear()
 {
   m_Scheduler.Clear();
+  m_ParallelScheduler.Clear();
 }
 
-void ezScriptWorldModule::AddUpdateFunctionToSchedule(const ezAbstractFunctionProperty* pFunction, void* pInstance, ezTime updateInterval, bool bOnlyWhenSimulating)
+void ezScriptWorldModule::AddUpdateFunctionToSchedule(const ezAbstractFunctionProperty* pFunction, void* pInstance, ezTime updateInterval, bool bOnlyWhenSimulating, bool bUpdateInParallel)
 {
   FunctionContext context;
   context.m_pFunctionAndFlags.SetPtrAndFlags(pFunction, bOnlyWhenSimulating ? FunctionContext::Flags::OnlyWhenSimulating : FunctionContext::Flags::None);
   context.m_pInstance = pInstance;
 
-  m_Scheduler.AddOrUpdateWork(context, updateInterval);
+  // the function might have been scheduled with a different mode before
+  if (bUpdateInParallel)
+  {
+    m_Scheduler.RemoveWork(context);
+    m_ParallelScheduler.AddOrUpdateWork(context, updateInterval);
+  }
+  else
+  {
+    m_ParallelScheduler.RemoveWork(context);
+    m_Scheduler.AddOrUpdateWork(context, updateInterval);
+  }
 }
 
 void ezScriptWorldModule::RemoveUpdateFunctionToSchedule(const ezAbstractFunctionProperty* pFunction, void* pInstance)
@@ -49,6 +70,13 @@ void ezScriptWorldModule::RemoveUpdateFunctionToSchedule(const ezAbstractFunctio
   context.m_pInstance = pInstance;
 
   m_Scheduler.RemoveWork(context);
+  m_ParallelScheduler.RemoveWork(context);
+}
+
+// static
+bool ezScriptWorldModule::IsExecutingInParallel()
+{
+  return s_bIsExecutingInParallel;
 }
 
 ezScriptCoroutineHandle ezScriptWorldModule::CreateCoroutine(const ezRTTI* pCoroutineType, ezStringView sName, ezScriptInstance& inout_instance, ezScriptCoroutineCreationMode::Enum creationMode, ezScriptCoroutine*& out_pCoroutine)
@@ -155,21 +183,23 @@ bool ezScriptWorldModule::IsCoroutineFinished(ezScriptCoroutineHandle hCoroutine
   return m_RunningScriptCoroutines.Contains(hCoroutine.GetInternalID()) == false;
 }
 
-void ezScriptWorldModule::CallUpdateFunctions(const ezWorldModule::UpdateContext& context)
+ezTime ezScriptWorldModule::GetUpdateDeltaTime() const
 {
-  ezWorld* pWorld = GetWorld();
+  const ezWorld* pWorld = GetWorld();
 
-  ezTime deltaTime;
   if (pWorld->GetWorldSimulationEnabled())
   {
-    deltaTime = pWorld->GetClock().GetTimeDiff();
+    return pWorld->GetClock().GetTimeDiff();
   }
   else
   {
-    deltaTime = ezClock::GetGlobalClock()->GetTimeDiff();
+    return ezClock::GetGlobalClock()->GetTimeDiff();
   }
+}
 
-  m_Scheduler.Update(deltaTime,
+void ezScriptWorldModule::CallUpdateFunctions(const ezWorldModule::UpdateContext& context)
+{
+  m_Scheduler.Update(GetUpdateDeltaTime(),
     [this](const FunctionContext& context, ezTime deltaTime)
     {
       if (GetWorld()->GetWorldSimulationEnabled() || context.m_pFunctionAndFlags.GetFlags() == FunctionContext::Flags::None)
@@ -199,5 +229,36 @@ void ezScriptWorldModule::CallUpdateFunctions(const ezWorldModule::UpdateContext
   m_DeadScriptCoroutines.Clear();
 }
 
+void ezScriptWorldModule::CallParallelUpdateFunctions(const ezWorldModule::UpdateContext& context)
+{
+  // gather all functions that are due this frame, the scheduler itself is not thread-safe
+  m_ParallelFunctionCalls.Clear();
+
+  m_ParallelScheduler.Update(GetUpdateDeltaTime(),
+    [this](const FunctionContext& context, ezTime deltaTime)
+    {
+      if (GetWorld()->GetWorldSimulationEnabled() || context.m_pFunctionAndFlags.GetFlags() == FunctionContext::Flags::None)
+      {
+        m_ParallelFunctionCalls.PushBack({context, deltaTime});
+      }
+    });
+
+  m_uiNumParallelUpdateFunctionCalls += m_ParallelFunctionCalls.GetCount();
+
+  ezTaskSystem::ParallelForSingle(
+    m_ParallelFunctionCalls.GetArrayPtr(), [](const ParallelFunctionCall& call)
+    {
+      const bool bWasExecutingInParallel = s_bIsExecutingInParallel;
+      s_bIsExecutingInParallel = true;
+
+      ezVariant args[] = {call.m_DeltaTime};
+      ezVariant returnValue;
+      call.m_Context.m_pFunctionAndFlags->Execute(call.m_Context.m_pInstance, ezMakeArrayPtr(args), returnValue);
+
+      s_bIsExecutingInParallel = bWasExecutingInParallel;
+    },
+    "ParallelScriptUpdate");
+}
+
 
 EZ_STATICLINK_FILE(Core, Core_Scripting_Implementation_ScriptWorldModule);
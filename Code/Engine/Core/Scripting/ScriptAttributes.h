@@ -36,3 +36,15 @@ public:
 private:
   ezUInt16 m_uiIndex;
 };
+
+//////////////////////////////////////////////////////////////////////////
+
+/// \brief Add this attribute to a script function, or to a class to affect all its script functions, to allow calling them from scripts that are updated in parallel.
+///
+/// Such functions must not modify the world and have to synchronize all access to other shared state themselves.
+/// Const member functions don't need this attribute, they are assumed to have no side effects anyway.
+/// \see ezScriptComponent::SetUpdateInParallel()
+class EZ_CORE_DLL ezScriptThreadSafeAttribute : public ezPropertyAttribute
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezScriptThreadSafeAttribute, ezPropertyAttribute);
+};
@@ -16,6 +16,7 @@ EZ_BEGIN_STATIC_REFLECTED_TYPE(ezScriptExtensionClass_Log, ezNoBase, 1, ezRTTINo
   EZ_BEGIN_ATTRIBUTES
   {
     new ezScriptExtensionAttribute("Log"),
+    new ezScriptThreadSafeAttribute(),
   }
   EZ_END_ATTRIBUTES;
 }
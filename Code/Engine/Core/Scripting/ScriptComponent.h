@@ -40,6 +40,18 @@ public:
   void SetUpdateInterval(ezTime interval);     // [ property ]
   ezTime GetUpdateInterval() const;            // [ property ]
 
+  /// \brief If enabled, the Update function of the script is executed in the async phase, in parallel with other scripts.
+  ///
+  /// Only enable this for scripts that don't modify the world directly. Messages sent by the script are queued and delivered after the async phase.
+  /// Script implementations that don't support parallel execution are still updated serially.
+  void SetUpdateInParallel(bool bUpdateInParallel); // [ property ]
+  bool GetUpdateInParallel() const;                 // [ property ]
+
+  /// \brief Returns whether the Update function is currently scheduled to be executed in parallel.
+  ///
+  /// This is false if UpdateInParallel is disabled or the script can't be updated in parallel.
+  bool IsUpdatedInParallel() const { return m_bIsUpdatedInParallel; }
+
   //////////////////////////////////////////////////////////////////////////
   // Exposed Parameters
   const ezRangeView<const char*, ezUInt32> GetParameters() const;
@@ -64,6 +76,8 @@ private:
 
   ezScriptClassResourceHandle m_hScriptClass;
   ezTime m_UpdateInterval = ezTime::MakeZero();
+  bool m_bUpdateInParallel = false;
+  bool m_bIsUpdatedInParallel = false;
 
   ezSharedPtr<ezScriptRTTI> m_pScriptType;
   ezUniquePtr<ezScriptInstance> m_pInstance;
@@ -75,6 +75,12 @@ public:
   virtual void SetInstanceVariable(const ezHashedString& sName, const ezVariant& value) = 0;
   virtual ezVariant GetInstanceVariable(const ezHashedString& sName) = 0;
 
+  /// \brief Returns whether the given update function of this instance may run concurrently with the update functions of other instances.
+  ///
+  /// Only returns true if the script implementation doesn't rely on shared state that isn't thread-safe.
+  /// Whether the instance is actually updated in parallel is decided by the owner, e.g. ezScriptComponent::SetUpdateInParallel().
+  virtual bool CanUpdateInParallel(const ezAbstractFunctionProperty* pUpdateFunction) const { return false; }
+
 private:
   ezReflectedClass& m_Owner;
   ezWorld* m_pWorld = nullptr;
@@ -22,9 +22,21 @@ public:
   virtual void Initialize() override;
   virtual void WorldClear() override;
 
-  void AddUpdateFunctionToSchedule(const ezAbstractFunctionProperty* pFunction, void* pInstance, ezTime updateInterval, bool bOnlyWhenSimulating);
+  /// \brief Schedules the given function to be called on pInstance every updateInterval.
+  ///
+  /// If bUpdateInParallel is set, the function is called during the async phase, in parallel with all other functions that have been scheduled this way.
+  /// Such functions must not modify the world directly, see IsExecutingInParallel().
+  void AddUpdateFunctionToSchedule(const ezAbstractFunctionProperty* pFunction, void* pInstance, ezTime updateInterval, bool bOnlyWhenSimulating, bool bUpdateInParallel = false);
   void RemoveUpdateFunctionToSchedule(const ezAbstractFunctionProperty* pFunction, void* pInstance);
 
+  /// \brief Returns true while the calling thread executes a scheduled update function in parallel with other update functions.
+  ///
+  /// Script implementations have to queue all changes to the world in this case, e.g. post messages instead of sending them directly.
+  static bool IsExecutingInParallel();
+
+  /// \brief Returns how many update functions have been called in parallel since the world module was created.
+  ezUInt64 GetNumParallelUpdateFunctionCalls() const { return m_uiNumParallelUpdateFunctionCalls; }
+
   /// \name Coroutine Functions
   ///@{
 
@@ -73,8 +85,20 @@ public:
 
 private:
   void CallUpdateFunctions(const ezWorldModule::UpdateContext& context);
+  void CallParallelUpdateFunctions(const ezWorldModule::UpdateContext& context);
+  ezTime GetUpdateDeltaTime() const;
 
   ezIntervalScheduler<FunctionContext> m_Scheduler;
+  ezIntervalScheduler<FunctionContext> m_ParallelScheduler;
+
+  struct ParallelFunctionCall
+  {
+    FunctionContext m_Context;
+    ezTime m_DeltaTime;
+  };
+
+  ezDynamicArray<ParallelFunctionCall> m_ParallelFunctionCalls;
+  ezUInt64 m_uiNumParallelUpdateFunctionCalls = 0;
 
   ezIdTable<ezScriptCoroutineId, ezUniquePtr<ezScriptCoroutine>> m_RunningScriptCoroutines;
   ezHashTable<ezScriptInstance*, ezSmallArray<ezScriptCoroutineHandle, 8>> m_InstanceToScriptCoroutines;
@@ -601,6 +601,9 @@ private:
     void UpdateGlobalBounds();
     void UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& ref_spatialSystem);
 
+    /// \brief Updates the global bounds and returns true if the spatial data has to be updated with the new global bounds.
+    bool UpdateGlobalBoundsAndCheckSpatialData();
+
     void UpdateLastGlobalTransform(ezUInt32 uiUpdateCounter);
 
     void RecreateSpatialData(ezSpatialSystem& ref_spatialSystem);
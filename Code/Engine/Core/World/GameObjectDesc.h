@@ -9,8 +9,6 @@
 /// \brief Describes the initial state of a game object.
 struct EZ_CORE_DLL ezGameObjectDesc
 {
-  EZ_DECLARE_POD_TYPE();
-
   bool m_bActiveFlag = true;                       ///< Whether the object should have the 'active flag' set. See ezGameObject::SetActiveFlag().
   bool m_bDynamic = false;                         ///< Whether the object should start out as 'dynamic'. See ezGameObject::MakeDynamic().
   ezUInt16 m_uiTeamID = 0;                         ///< See ezGameObject::GetTeamID().
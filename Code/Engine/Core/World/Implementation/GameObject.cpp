@@ -1183,12 +1183,7 @@ void ezGameObject::TransformationData::UpdateGlobalBounds(ezSpatialSystem* pSpat
 
 void ezGameObject::TransformationData::UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& ref_spatialSystem)
 {
-  ezSimdBBoxSphere oldGlobalBounds = m_globalBounds;
-
-  UpdateGlobalBounds();
-
-  const bool bIsAlwaysVisible = m_localBounds.m_BoxHalfExtents.w() != ezSimdFloat::MakeZero();
-  if (m_hSpatialData.IsInvalidated() == false && bIsAlwaysVisible == false && m_globalBounds != oldGlobalBounds)
+  if (UpdateGlobalBoundsAndCheckSpatialData())
   {
     ref_spatialSystem.UpdateSpatialDataBounds(m_hSpatialData, m_globalBounds);
   }
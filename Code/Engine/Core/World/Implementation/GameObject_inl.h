@@ -592,7 +592,22 @@ EZ_ALWAYS_INLINE void ezGameObject::TransformationData::UpdateGlobalTransformWit
 EZ_FORCE_INLINE void ezGameObject::TransformationData::UpdateGlobalBounds()
 {
   m_globalBounds = m_localBounds;
-  m_globalBounds.Transform(m_globalTransform);
+
+  // Most objects don't have any bounds (negative radius), there is nothing to transform in that case.
+  if (m_localBounds.m_CenterAndRadius.w() >= ezSimdFloat::MakeZero())
+  {
+    m_globalBounds.Transform(m_globalTransform);
+  }
+}
+
+EZ_FORCE_INLINE bool ezGameObject::TransformationData::UpdateGlobalBoundsAndCheckSpatialData()
+{
+  ezSimdBBoxSphere oldGlobalBounds = m_globalBounds;
+
+  UpdateGlobalBounds();
+
+  const bool bIsAlwaysVisible = m_localBounds.m_BoxHalfExtents.w() != ezSimdFloat::MakeZero();
+  return m_hSpatialData.IsInvalidated() == false && bIsAlwaysVisible == false && m_globalBounds != oldGlobalBounds;
 }
 
 EZ_ALWAYS_INLINE void ezGameObject::TransformationData::UpdateLastGlobalTransform(ezUInt32 uiUpdateCounter)
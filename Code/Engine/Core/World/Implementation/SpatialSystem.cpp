@@ -19,6 +19,14 @@ void ezSpatialSystem::StartNewFrame()
   ++m_uiFrameCounter;
 }
 
+void ezSpatialSystem::UpdateSpatialDataBounds(ezArrayPtr<const BoundsUpdate> updates)
+{
+  for (const BoundsUpdate& update : updates)
+  {
+    UpdateSpatialDataBounds(update.m_hData, update.m_Bounds);
+  }
+}
+
 void ezSpatialSystem::FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const
 {
   out_objects.Clear();
@@ -47,6 +55,20 @@ void ezSpatialSystem::FindObjectsInBox(const ezBoundingBox& box, const QueryPara
     });
 }
 
+void ezSpatialSystem::FindObjectsAlongRay(const ezVec3& vStart, const ezVec3& vDirection, float fMaxDistance, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const
+{
+  out_objects.Clear();
+
+  FindObjectsAlongRay(
+    vStart, vDirection, fMaxDistance, queryParams,
+    [&](ezGameObject* pObject, float fDistance)
+    {
+      out_objects.PushBack(pObject);
+
+      return ezVisitorExecution::Continue;
+    });
+}
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
 void ezSpatialSystem::GetInternalStats(ezStringBuilder& ref_sSb) const
 {
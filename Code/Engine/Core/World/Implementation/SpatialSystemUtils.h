@@ -0,0 +1,386 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
+
+/// \brief Helper functions that are shared between the different spatial system implementations.
+namespace ezInternal::SpatialSystemUtils
+{
+  /// \brief The 6 frustum planes transposed into SoA layout so that a bounding volume can be tested against 4 planes at once.
+  struct PlaneData
+  {
+    ezSimdVec4f m_x0x1x2x3;
+    ezSimdVec4f m_y0y1y2y3;
+    ezSimdVec4f m_z0z1z2z3;
+    ezSimdVec4f m_w0w1w2w3;
+
+    ezSimdVec4f m_x4x5x4x5;
+    ezSimdVec4f m_y4y5y4y5;
+    ezSimdVec4f m_z4z5z4z5;
+    ezSimdVec4f m_w4w5w4w5;
+  };
+
+  EZ_FORCE_INLINE PlaneData ComputePlaneData(const ezFrustum& frustum)
+  {
+    PlaneData planeData;
+
+    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
+    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
+    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
+    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
+    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
+    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
+    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
+
+    ezSimdMat4f helperMat;
+    helperMat.SetRows(plane0, plane1, plane2, plane3);
+
+    planeData.m_x0x1x2x3 = helperMat.m_col0;
+    planeData.m_y0y1y2y3 = helperMat.m_col1;
+    planeData.m_z0z1z2z3 = helperMat.m_col2;
+    planeData.m_w0w1w2w3 = helperMat.m_col3;
+
+    helperMat.SetRows(plane4, plane5, plane4, plane5);
+
+    planeData.m_x4x5x4x5 = helperMat.m_col0;
+    planeData.m_y4y5y4y5 = helperMat.m_col1;
+    planeData.m_z4z5z4z5 = helperMat.m_col2;
+    planeData.m_w4w5w4w5 = helperMat.m_col3;
+
+    return planeData;
+  }
+
+  /// \brief Computes the bounding box of the frustum corner points.
+  EZ_FORCE_INLINE ezSimdBBox ComputeFrustumBoundingBox(const ezFrustum& frustum)
+  {
+    ezVec3 cornerPoints[8];
+    frustum.ComputeCornerPoints(cornerPoints).AssertSuccess();
+
+    ezSimdVec4f simdCornerPoints[8];
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      simdCornerPoints[i] = ezSimdConversion::ToVec3(cornerPoints[i]);
+    }
+
+    return ezSimdBBox::MakeFromPoints(simdCornerPoints, 8);
+  }
+
+  /// \brief Returns true if the object should be skipped because of the given include and exclude tags.
+  EZ_ALWAYS_INLINE bool FilterByTags(const ezTagSet& tags, const ezTagSet* pIncludeTags, const ezTagSet* pExcludeTags)
+  {
+    if (pExcludeTags != nullptr && !pExcludeTags->IsEmpty() && pExcludeTags->IsAnySet(tags))
+      return true;
+
+    if (pIncludeTags != nullptr && !pIncludeTags->IsEmpty() && !pIncludeTags->IsAnySet(tags))
+      return true;
+
+    return false;
+  }
+
+  EZ_ALWAYS_INLINE bool UseTagsFilter(const ezSpatialSystem::QueryParams& queryParams)
+  {
+    return (queryParams.m_pIncludeTags && queryParams.m_pIncludeTags->IsEmpty() == false) || (queryParams.m_pExcludeTags && queryParams.m_pExcludeTags->IsEmpty() == false);
+  }
+
+  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
+  {
+    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
+    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
+    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
+    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
+
+    ezSimdVec4f dot_0123;
+    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
+
+    ezSimdVec4f dot_4545;
+    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
+
+    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
+    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
+    return (cmp_0123 || cmp_4545).NoneSet<4>();
+  }
+
+  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
+  {
+    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
+    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
+    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
+    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
+
+    ezSimdVec4f dotA_0123;
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
+
+    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
+    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
+    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
+    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
+
+    ezSimdVec4f dotB_0123;
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
+
+    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
+    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
+    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
+    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
+
+    ezSimdVec4f dot_A45B45;
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
+
+    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
+    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
+    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
+
+    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
+    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
+
+    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
+    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
+
+    return result;
+  }
+
+  /// \brief Tests a box against the frustum planes.
+  ///
+  /// Returns ezVolumePosition::Outside if the box is fully outside of at least one plane, ezVolumePosition::Inside if it is fully
+  /// inside of all planes and ezVolumePosition::Intersecting otherwise.
+  EZ_FORCE_INLINE ezVolumePosition::Enum BoxFrustumIntersect(const ezSimdBBox& box, const PlaneData& planeData)
+  {
+    const ezSimdVec4f center = box.GetCenter();
+    const ezSimdVec4f halfExtents = box.GetHalfExtents();
+
+    ezSimdVec4f pos_xxxx(center.x());
+    ezSimdVec4f pos_yyyy(center.y());
+    ezSimdVec4f pos_zzzz(center.z());
+
+    ezSimdVec4f ext_xxxx(halfExtents.x());
+    ezSimdVec4f ext_yyyy(halfExtents.y());
+    ezSimdVec4f ext_zzzz(halfExtents.z());
+
+    ezSimdVec4f dot_0123;
+    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
+
+    ezSimdVec4f radius_0123;
+    radius_0123 = ext_xxxx.CompMul(planeData.m_x0x1x2x3.Abs());
+    radius_0123 = ezSimdVec4f::MulAdd(ext_yyyy, planeData.m_y0y1y2y3.Abs(), radius_0123);
+    radius_0123 = ezSimdVec4f::MulAdd(ext_zzzz, planeData.m_z0z1z2z3.Abs(), radius_0123);
+
+    ezSimdVec4f dot_4545;
+    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
+
+    ezSimdVec4f radius_4545;
+    radius_4545 = ext_xxxx.CompMul(planeData.m_x4x5x4x5.Abs());
+    radius_4545 = ezSimdVec4f::MulAdd(ext_yyyy, planeData.m_y4y5y4y5.Abs(), radius_4545);
+    radius_4545 = ezSimdVec4f::MulAdd(ext_zzzz, planeData.m_z4z5z4z5.Abs(), radius_4545);
+
+    if ((dot_0123 > radius_0123 || dot_4545 > radius_4545).AnySet<4>())
+      return ezVolumePosition::Outside;
+
+    if ((dot_0123 < -radius_0123 && dot_4545 < -radius_4545).AllSet<4>())
+      return ezVolumePosition::Inside;
+
+    return ezVolumePosition::Intersecting;
+  }
+
+  /// \brief A ray prepared for repeated slab tests against boxes.
+  struct RayData
+  {
+    ezSimdVec4f m_vOrigin;
+    ezSimdVec4f m_vInvDirection;
+    float m_fMaxDistance;
+  };
+
+  EZ_FORCE_INLINE RayData ComputeRayData(const ezVec3& vStart, const ezVec3& vDirection, float fMaxDistance)
+  {
+    RayData rayData;
+    rayData.m_vOrigin = ezSimdConversion::ToVec3(vStart);
+
+    // Clamp instead of dividing by zero so that axis parallel rays never produce 0 * inf = NaN in the slab test
+    const ezSimdVec4f vHuge(1e30f);
+    rayData.m_vInvDirection = ezSimdConversion::ToVec3(vDirection).GetReciprocal().CompMin(vHuge).CompMax(-vHuge);
+    rayData.m_fMaxDistance = fMaxDistance;
+
+    return rayData;
+  }
+
+  /// \brief Returns whether the ray hits the box within its max distance.
+  ///
+  /// The enter distance is zero if the ray starts inside the box, the exit distance is clamped to the max distance of the ray.
+  EZ_FORCE_INLINE bool RayBoxIntersect(const ezSimdBBox& box, const RayData& rayData, float& out_fEnterDistance, float& out_fExitDistance)
+  {
+    const ezSimdVec4f t0 = (box.m_Min - rayData.m_vOrigin).CompMul(rayData.m_vInvDirection);
+    const ezSimdVec4f t1 = (box.m_Max - rayData.m_vOrigin).CompMul(rayData.m_vInvDirection);
+
+    const float fEnter = ezMath::Max<float>(t0.CompMin(t1).HorizontalMax<3>(), 0.0f);
+    const float fExit = ezMath::Min<float>(t0.CompMax(t1).HorizontalMin<3>(), rayData.m_fMaxDistance);
+
+    out_fEnterDistance = fEnter;
+    out_fExitDistance = fExit;
+    return fEnter <= fExit;
+  }
+
+  /// \brief Binary heap operations on an array, the element for which none other IsHigherPriority is at index 0.
+  ///
+  /// IsHigherPriority(a, b) must return true if a should be popped before b.
+  template <typename T, typename Compare>
+  void HeapPush(ezDynamicArrayBase<T>& ref_heap, const T& value, Compare isHigherPriority)
+  {
+    ezUInt32 uiIndex = ref_heap.GetCount();
+    ref_heap.PushBack(value);
+
+    while (uiIndex > 0)
+    {
+      const ezUInt32 uiParent = (uiIndex - 1) / 2;
+      if (!isHigherPriority(ref_heap[uiIndex], ref_heap[uiParent]))
+        break;
+
+      ezMath::Swap(ref_heap[uiIndex], ref_heap[uiParent]);
+      uiIndex = uiParent;
+    }
+  }
+
+  /// \brief Removes the top element of a heap built with HeapPush.
+  template <typename T, typename Compare>
+  void HeapPop(ezDynamicArrayBase<T>& ref_heap, Compare isHigherPriority)
+  {
+    ref_heap[0] = ref_heap.PeekBack();
+    ref_heap.PopBack();
+
+    const ezUInt32 uiCount = ref_heap.GetCount();
+    ezUInt32 uiIndex = 0;
+    while (true)
+    {
+      const ezUInt32 uiLeft = uiIndex * 2 + 1;
+      const ezUInt32 uiRight = uiLeft + 1;
+      ezUInt32 uiBest = uiIndex;
+
+      if (uiLeft < uiCount && isHigherPriority(ref_heap[uiLeft], ref_heap[uiBest]))
+        uiBest = uiLeft;
+      if (uiRight < uiCount && isHigherPriority(ref_heap[uiRight], ref_heap[uiBest]))
+        uiBest = uiRight;
+
+      if (uiBest == uiIndex)
+        break;
+
+      ezMath::Swap(ref_heap[uiIndex], ref_heap[uiBest]);
+      uiIndex = uiBest;
+    }
+  }
+
+  /// \brief Collects the results of an ordered query and hands them out by ascending distance.
+  ///
+  /// Objects that are in multiple of the queried categories are only added once, identified by their spatial data index.
+  /// Unbounded results are kept in a min-heap so Emit() can take the closest one, bounded results are kept in a max-heap
+  /// so the farthest one can be replaced once the maximum number of results has been reached.
+  class SortedQueryResults
+  {
+  public:
+    /// \param uiMaxResults Once this many results have been added, only results closer than the farthest one are kept.
+    SortedQueryResults(ezUInt32 uiMaxResults = ezInvalidIndex)
+      : m_uiMaxResults(uiMaxResults)
+    {
+    }
+
+    /// \brief The distance up to which new results are still accepted.
+    EZ_ALWAYS_INLINE float GetMaxDistance(float fQueryMaxDistance) const
+    {
+      return IsFull() ? m_Results[0].m_fDistance : fQueryMaxDistance;
+    }
+
+    EZ_ALWAYS_INLINE bool IsFull() const { return m_Results.GetCount() >= m_uiMaxResults; }
+
+    void Add(ezGameObject* pObject, ezUInt32 uiDataIndex, float fDistance)
+    {
+      if (IsFull() && fDistance >= m_Results[0].m_fDistance)
+        return;
+
+      if (!m_AddedDataIndices.Insert(uiDataIndex))
+      {
+        if (IsBounded())
+        {
+          if (IsFull())
+          {
+            HeapPop(m_Results, &IsFarther);
+          }
+
+          HeapPush(m_Results, {pObject, fDistance}, &IsFarther);
+        }
+        else
+        {
+          HeapPush(m_Results, {pObject, fDistance}, &IsCloser);
+        }
+      }
+    }
+
+    /// \brief Passes all results up to the given distance to the callback, closest first, and removes them.
+    ///
+    /// Only supported for unbounded results.
+    ezVisitorExecution::Enum Emit(float fMaxDistance, const ezSpatialSystem::RayQueryCallback& callback)
+    {
+      EZ_ASSERT_DEBUG(!IsBounded(), "Emit is only supported for unbounded query results");
+
+      while (!m_Results.IsEmpty() && m_Results[0].m_fDistance <= fMaxDistance)
+      {
+        const Result result = m_Results[0];
+        HeapPop(m_Results, &IsCloser);
+
+        if (callback(result.m_pObject, result.m_fDistance) == ezVisitorExecution::Stop)
+          return ezVisitorExecution::Stop;
+      }
+
+      return ezVisitorExecution::Continue;
+    }
+
+    /// \brief Appends all results to out_objects, closest first.
+    void GetObjects(ezDynamicArray<ezGameObject*>& out_objects) const
+    {
+      ezHybridArray<Result, 64> sortedResults(m_Results);
+      sortedResults.Sort(ResultComparer());
+
+      for (const Result& result : sortedResults)
+      {
+        out_objects.PushBack(result.m_pObject);
+      }
+    }
+
+  private:
+    struct Result
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezGameObject* m_pObject;
+      float m_fDistance;
+    };
+
+    struct ResultComparer
+    {
+      EZ_ALWAYS_INLINE bool Less(const Result& a, const Result& b) const { return a.m_fDistance < b.m_fDistance; }
+      EZ_ALWAYS_INLINE bool Equal(const Result& a, const Result& b) const { return a.m_fDistance == b.m_fDistance; }
+    };
+
+    static bool IsCloser(const Result& a, const Result& b) { return a.m_fDistance < b.m_fDistance; }
+    static bool IsFarther(const Result& a, const Result& b) { return a.m_fDistance > b.m_fDistance; }
+
+    EZ_ALWAYS_INLINE bool IsBounded() const { return m_uiMaxResults != ezInvalidIndex; }
+
+    ezUInt32 m_uiMaxResults;
+    ezHybridArray<Result, 64> m_Results;
+    ezHashSet<ezUInt32> m_AddedDataIndices;
+  };
+} // namespace ezInternal::SpatialSystemUtils
@@ -0,0 +1,1441 @@
+#include <Core/CorePCH.h>
+
+#include <Core/World/Implementation/SpatialSystemUtils.h>
+#include <Core/World/SpatialSystem_DynamicBVH.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
+
+ezCVarFloat cvar_SpatialBVHRebuildThreshold("Spatial.BVH.RebuildThreshold", 1.5f, ezCVarFlags::Default, "Relative growth of the summed node surface area through refits after which a tree is rebuilt");
+ezCVarInt cvar_SpatialBVHBackgroundBuildThreshold("Spatial.BVH.BackgroundBuildThreshold", 4096, ezCVarFlags::Default, "Number of objects in a tree from which on it is rebuilt in the background instead of synchronously");
+
+namespace
+{
+  using ezInternal::SpatialSystemUtils::FilterByTags;
+  using ezInternal::SpatialSystemUtils::PlaneData;
+  using ezInternal::SpatialSystemUtils::RayData;
+  using ezInternal::SpatialSystemUtils::SortedQueryResults;
+  using ezInternal::SpatialSystemUtils::SphereFrustumIntersect;
+
+  enum
+  {
+    NUM_SAH_BINS = 16,
+    NUM_SAH_AXES = 4,
+    SIZE_AXIS = 3,
+    MAX_PRIMITIVES_PER_LEAF = 4,
+    MAX_PRIMITIVES_PER_FORCED_LEAF = 16,
+    MIN_NUM_UNSORTED_PRIMITIVES_FOR_REBUILD = 32,
+  };
+
+  /// Half of the surface area is enough for the surface area heuristic since only the ratios matter.
+  EZ_ALWAYS_INLINE float GetHalfSurfaceArea(const ezSimdBBox& box)
+  {
+    const ezSimdVec4f extents = box.GetExtents();
+    return extents.Dot<3>(extents.Get<ezSwizzle::YZXW>());
+  }
+
+  /// Objects are tested with their bounding sphere like in the grid, so the nodes need to enclose the sphere as well as the box.
+  EZ_ALWAYS_INLINE ezSimdBBox GetPrimitiveBox(const ezSimdBSphere& sphere, const ezSimdVec4f& halfExtents)
+  {
+    return ezSimdBBox::MakeFromCenterAndHalfExtents(sphere.GetCenter(), halfExtents.CompMax(sphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>()));
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_DynamicBVH::Node
+{
+  EZ_DECLARE_POD_TYPE();
+
+  EZ_ALWAYS_INLINE bool IsLeaf() const { return m_uiFirstChildIndex == ezInvalidIndex; }
+
+  ezSimdBBox m_Bounds;
+  ezUInt32 m_uiFirstChildIndex; ///< The second child directly follows the first one. ezInvalidIndex for leaf nodes.
+  ezUInt32 m_uiParentIndex;
+  ezUInt32 m_uiFirstPrimitive; ///< The primitives of a node and all its children are stored consecutively.
+  ezUInt32 m_uiNumPrimitives;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/// \brief Input and output of a tree build. Only accessed by the build task while the build is running.
+struct ezSpatialSystem_DynamicBVH::BuildData
+{
+  BuildData(ezAllocator* pAlignedAllocator, ezAllocator* pAllocator)
+    : m_BoundingSpheres(pAlignedAllocator)
+    , m_BoundingBoxHalfExtents(pAlignedAllocator)
+    , m_DataIndices(pAllocator)
+    , m_Nodes(pAlignedAllocator)
+    , m_LeafIndices(pAllocator)
+  {
+  }
+
+  void Build()
+  {
+    EZ_PROFILE_SCOPE("Build Spatial BVH");
+
+    const ezUInt32 uiNumPrimitives = m_DataIndices.GetCount();
+
+    m_Nodes.Clear();
+    m_LeafIndices.Clear();
+
+    if (uiNumPrimitives == 0)
+      return;
+
+    ezAllocator* pAlignedAllocator = m_Nodes.GetAllocator();
+    ezAllocator* pAllocator = m_DataIndices.GetAllocator();
+
+    ezDynamicArray<ezSimdBBox> boxes(pAlignedAllocator);
+    ezDynamicArray<ezVec3> centers(pAllocator);
+    ezDynamicArray<ezUInt32> order(pAllocator);
+    boxes.SetCountUninitialized(uiNumPrimitives);
+    centers.SetCountUninitialized(uiNumPrimitives);
+    order.SetCountUninitialized(uiNumPrimitives);
+
+    for (ezUInt32 i = 0; i < uiNumPrimitives; ++i)
+    {
+      boxes[i] = GetPrimitiveBox(m_BoundingSpheres[i], m_BoundingBoxHalfExtents[i]);
+      centers[i] = ezSimdConversion::ToVec3(m_BoundingSpheres[i].GetCenter());
+      order[i] = i;
+    }
+
+    m_Nodes.Reserve(2 * (uiNumPrimitives / MAX_PRIMITIVES_PER_LEAF) + 1);
+
+    {
+      Node& root = m_Nodes.ExpandAndGetRef();
+      root.m_uiFirstChildIndex = ezInvalidIndex;
+      root.m_uiParentIndex = ezInvalidIndex;
+      root.m_uiFirstPrimitive = 0;
+      root.m_uiNumPrimitives = uiNumPrimitives;
+    }
+
+    struct Bin
+    {
+      ezSimdBBox m_Bounds;
+      ezUInt32 m_uiCount;
+    };
+
+    ezHybridArray<ezUInt32, 64> nodeStack;
+    nodeStack.PushBack(0);
+
+    while (!nodeStack.IsEmpty())
+    {
+      const ezUInt32 uiNodeIndex = nodeStack.PeekBack();
+      nodeStack.PopBack();
+
+      const ezUInt32 uiFirst = m_Nodes[uiNodeIndex].m_uiFirstPrimitive;
+      const ezUInt32 uiCount = m_Nodes[uiNodeIndex].m_uiNumPrimitives;
+      const ezUInt32 uiEnd = uiFirst + uiCount;
+
+      ezSimdBBox bounds = ezSimdBBox::MakeInvalid();
+      ezBoundingBox centerBounds = ezBoundingBox::MakeInvalid();
+      for (ezUInt32 i = uiFirst; i < uiEnd; ++i)
+      {
+        bounds.ExpandToInclude(boxes[order[i]]);
+        centerBounds.ExpandToInclude(centers[order[i]]);
+      }
+
+      m_Nodes[uiNodeIndex].m_Bounds = bounds;
+
+      if (uiCount <= MAX_PRIMITIVES_PER_LEAF)
+        continue;
+
+      // Find the best split with a binned surface area heuristic. Besides the three spatial axes, the primitives are also binned
+      // by their size relative to the node, which allows the build to move huge objects out of the way of many small ones.
+      const ezVec3 vCenterMin = centerBounds.m_vMin;
+      const ezVec3 vCenterExtents = centerBounds.GetExtents();
+      const float fNodeArea = GetHalfSurfaceArea(bounds);
+
+      float binScales[NUM_SAH_AXES];
+      for (ezUInt32 uiAxis = 0; uiAxis < 3; ++uiAxis)
+      {
+        const float fExtents = vCenterExtents.GetData()[uiAxis];
+        binScales[uiAxis] = fExtents > ezMath::SmallEpsilon<float>() ? (NUM_SAH_BINS * (1.0f - ezMath::LargeEpsilon<float>())) / fExtents : 0.0f;
+      }
+      binScales[SIZE_AXIS] = fNodeArea > 0.0f ? 0.5f : 0.0f; // one bin per factor of two in size
+
+      auto GetBinIndex = [&](ezUInt32 uiPrimitive, ezUInt32 uiAxis) -> ezUInt32
+      {
+        float fKey;
+        if (uiAxis == SIZE_AXIS)
+        {
+          fKey = ezMath::Log2(fNodeArea / ezMath::Max(GetHalfSurfaceArea(boxes[uiPrimitive]), ezMath::SmallEpsilon<float>()));
+        }
+        else
+        {
+          fKey = centers[uiPrimitive].GetData()[uiAxis] - vCenterMin.GetData()[uiAxis];
+        }
+
+        return static_cast<ezUInt32>(ezMath::Clamp(fKey * binScales[uiAxis], 0.0f, static_cast<float>(NUM_SAH_BINS - 1)));
+      };
+
+      float fBestCost = ezMath::MaxValue<float>();
+      ezInt32 iBestAxis = -1;
+      ezUInt32 uiBestSplit = 0;
+
+      for (ezUInt32 uiAxis = 0; uiAxis < NUM_SAH_AXES; ++uiAxis)
+      {
+        if (binScales[uiAxis] == 0.0f)
+          continue;
+
+        Bin bins[NUM_SAH_BINS];
+        for (auto& bin : bins)
+        {
+          bin.m_Bounds = ezSimdBBox::MakeInvalid();
+          bin.m_uiCount = 0;
+        }
+
+        for (ezUInt32 i = uiFirst; i < uiEnd; ++i)
+        {
+          const ezUInt32 uiPrimitive = order[i];
+          const ezUInt32 uiBin = GetBinIndex(uiPrimitive, uiAxis);
+
+          bins[uiBin].m_Bounds.ExpandToInclude(boxes[uiPrimitive]);
+          bins[uiBin].m_uiCount++;
+        }
+
+        float rightAreas[NUM_SAH_BINS];
+        ezUInt32 rightCounts[NUM_SAH_BINS];
+        {
+          ezSimdBBox rightBounds = ezSimdBBox::MakeInvalid();
+          ezUInt32 uiRightCount = 0;
+          for (ezUInt32 uiBin = NUM_SAH_BINS - 1; uiBin > 0; --uiBin)
+          {
+            rightBounds.ExpandToInclude(bins[uiBin].m_Bounds);
+            uiRightCount += bins[uiBin].m_uiCount;
+
+            rightAreas[uiBin] = uiRightCount > 0 ? GetHalfSurfaceArea(rightBounds) : 0.0f;
+            rightCounts[uiBin] = uiRightCount;
+          }
+        }
+
+        ezSimdBBox leftBounds = ezSimdBBox::MakeInvalid();
+        ezUInt32 uiLeftCount = 0;
+        for (ezUInt32 uiSplit = 0; uiSplit < NUM_SAH_BINS - 1; ++uiSplit)
+        {
+          leftBounds.ExpandToInclude(bins[uiSplit].m_Bounds);
+          uiLeftCount += bins[uiSplit].m_uiCount;
+
+          if (uiLeftCount == 0 || rightCounts[uiSplit + 1] == 0)
+            continue;
+
+          const float fCost = uiLeftCount * GetHalfSurfaceArea(leftBounds) + rightCounts[uiSplit + 1] * rightAreas[uiSplit + 1];
+          if (fCost < fBestCost)
+          {
+            fBestCost = fCost;
+            iBestAxis = uiAxis;
+            uiBestSplit = uiSplit;
+          }
+        }
+      }
+
+      // Traversal cost is assumed to be equal to the cost of testing one primitive
+      const float fLeafCost = uiCount * fNodeArea;
+      const float fSplitCost = fNodeArea + fBestCost;
+
+      if (uiCount <= MAX_PRIMITIVES_PER_FORCED_LEAF && (iBestAxis < 0 || fSplitCost >= fLeafCost))
+        continue;
+
+      ezUInt32 uiMid = uiFirst + uiCount / 2;
+      if (iBestAxis >= 0)
+      {
+        ezUInt32 uiLeft = uiFirst;
+        ezUInt32 uiRight = uiEnd;
+        while (uiLeft < uiRight)
+        {
+          if (GetBinIndex(order[uiLeft], iBestAxis) <= uiBestSplit)
+          {
+            ++uiLeft;
+          }
+          else
+          {
+            --uiRight;
+            ezMath::Swap(order[uiLeft], order[uiRight]);
+          }
+        }
+
+        if (uiLeft > uiFirst && uiLeft < uiEnd)
+        {
+          uiMid = uiLeft;
+        }
+      }
+
+      const ezUInt32 uiFirstChildIndex = m_Nodes.GetCount();
+      m_Nodes[uiNodeIndex].m_uiFirstChildIndex = uiFirstChildIndex;
+
+      Node& leftChild = m_Nodes.ExpandAndGetRef();
+      leftChild.m_uiFirstChildIndex = ezInvalidIndex;
+      leftChild.m_uiParentIndex = uiNodeIndex;
+      leftChild.m_uiFirstPrimitive = uiFirst;
+      leftChild.m_uiNumPrimitives = uiMid - uiFirst;
+
+      Node& rightChild = m_Nodes.ExpandAndGetRef();
+      rightChild.m_uiFirstChildIndex = ezInvalidIndex;
+      rightChild.m_uiParentIndex = uiNodeIndex;
+      rightChild.m_uiFirstPrimitive = uiMid;
+      rightChild.m_uiNumPrimitives = uiEnd - uiMid;
+
+      nodeStack.PushBack(uiFirstChildIndex + 1);
+      nodeStack.PushBack(uiFirstChildIndex);
+    }
+
+    // Reorder the primitives so that the primitives of each node are stored consecutively
+    {
+      ezDynamicArray<ezSimdBSphere> sortedSpheres(pAlignedAllocator);
+      ezDynamicArray<ezSimdVec4f> sortedHalfExtents(pAlignedAllocator);
+      ezDynamicArray<ezUInt32> sortedDataIndices(pAllocator);
+      sortedSpheres.SetCountUninitialized(uiNumPrimitives);
+      sortedHalfExtents.SetCountUninitialized(uiNumPrimitives);
+      sortedDataIndices.SetCountUninitialized(uiNumPrimitives);
+
+      for (ezUInt32 i = 0; i < uiNumPrimitives; ++i)
+      {
+        const ezUInt32 uiPrimitive = order[i];
+        sortedSpheres[i] = m_BoundingSpheres[uiPrimitive];
+        sortedHalfExtents[i] = m_BoundingBoxHalfExtents[uiPrimitive];
+        sortedDataIndices[i] = m_DataIndices[uiPrimitive];
+      }
+
+      m_BoundingSpheres.Swap(sortedSpheres);
+      m_BoundingBoxHalfExtents.Swap(sortedHalfExtents);
+      m_DataIndices.Swap(sortedDataIndices);
+    }
+
+    m_LeafIndices.SetCountUninitialized(uiNumPrimitives);
+    for (ezUInt32 uiNodeIndex = 0; uiNodeIndex < m_Nodes.GetCount(); ++uiNodeIndex)
+    {
+      const Node& node = m_Nodes[uiNodeIndex];
+      if (!node.IsLeaf())
+        continue;
+
+      for (ezUInt32 i = 0; i < node.m_uiNumPrimitives; ++i)
+      {
+        m_LeafIndices[node.m_uiFirstPrimitive + i] = uiNodeIndex;
+      }
+    }
+  }
+
+  // Input, reordered by the build
+  ezDynamicArray<ezSimdBSphere> m_BoundingSpheres;
+  ezDynamicArray<ezSimdVec4f> m_BoundingBoxHalfExtents;
+  ezDynamicArray<ezUInt32> m_DataIndices;
+
+  // Output
+  ezDynamicArray<Node> m_Nodes;
+  ezDynamicArray<ezUInt32> m_LeafIndices;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_DynamicBVH::Tree
+{
+  Tree(ezSpatialSystem_DynamicBVH& ref_system, ezSpatialData::Category category)
+    : m_Nodes(&ref_system.m_AlignedAllocator)
+    , m_BoundingSpheres(&ref_system.m_AlignedAllocator)
+    , m_BoundingBoxHalfExtents(&ref_system.m_AlignedAllocator)
+    , m_DataIndices(&ref_system.m_Allocator)
+    , m_LeafIndices(&ref_system.m_Allocator)
+    , m_DataIndexToPrimitive(&ref_system.m_Allocator)
+    , m_AlwaysVisibleDataIndices(&ref_system.m_Allocator)
+    , m_DirtyNodeIndices(&ref_system.m_Allocator)
+    , m_Category(category)
+  {
+  }
+
+  ~Tree()
+  {
+    if (m_pBuildTask != nullptr)
+    {
+      ezTaskSystem::WaitForGroup(m_BuildTaskGroupID);
+    }
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetNumPrimitives() const { return m_DataIndices.GetCount(); }
+  EZ_ALWAYS_INLINE ezUInt32 GetNumUnsortedPrimitives() const { return m_DataIndices.GetCount() - m_uiNumBuiltPrimitives; }
+  EZ_ALWAYS_INLINE ezUInt32 GetNumLivePrimitives() const { return m_DataIndices.GetCount() - m_uiNumRemovedPrimitives; }
+
+  void AddPrimitive(const ezSimdBBoxSphere& bounds, ezUInt32 uiDataIndex)
+  {
+    if (uiDataIndex >= m_DataIndexToPrimitive.GetCount())
+    {
+      m_DataIndexToPrimitive.SetCount(uiDataIndex + 1, ezInvalidIndex);
+    }
+
+    EZ_ASSERT_DEBUG(m_DataIndexToPrimitive[uiDataIndex] == ezInvalidIndex, "data has already been added to the tree");
+    m_DataIndexToPrimitive[uiDataIndex] = m_DataIndices.GetCount();
+
+    // New primitives go to the unsorted list at the end until the next build
+    m_BoundingSpheres.PushBack(bounds.GetSphere());
+    m_BoundingBoxHalfExtents.PushBack(bounds.m_BoxHalfExtents);
+    m_DataIndices.PushBack(uiDataIndex);
+  }
+
+  void RemovePrimitive(ezUInt32 uiDataIndex)
+  {
+    const ezUInt32 uiPrimitive = m_DataIndexToPrimitive[uiDataIndex];
+    m_DataIndexToPrimitive[uiDataIndex] = ezInvalidIndex;
+
+    if (uiPrimitive < m_uiNumBuiltPrimitives)
+    {
+      // Primitives in the tree can't be moved, so they are only marked as removed and cleaned up by the next build
+      m_DataIndices[uiPrimitive] = ezInvalidIndex;
+      ++m_uiNumRemovedPrimitives;
+
+      MarkDirty(m_LeafIndices[uiPrimitive]);
+    }
+    else
+    {
+      const ezUInt32 uiLastPrimitive = m_DataIndices.GetCount() - 1;
+      if (uiPrimitive != uiLastPrimitive)
+      {
+        m_DataIndexToPrimitive[m_DataIndices[uiLastPrimitive]] = uiPrimitive;
+      }
+
+      m_BoundingSpheres.RemoveAtAndSwap(uiPrimitive);
+      m_BoundingBoxHalfExtents.RemoveAtAndSwap(uiPrimitive);
+      m_DataIndices.RemoveAtAndSwap(uiPrimitive);
+    }
+  }
+
+  void UpdatePrimitiveBounds(ezUInt32 uiDataIndex, const ezSimdBBoxSphere& bounds)
+  {
+    const ezUInt32 uiPrimitive = m_DataIndexToPrimitive[uiDataIndex];
+
+    m_BoundingSpheres[uiPrimitive] = bounds.GetSphere();
+    m_BoundingBoxHalfExtents[uiPrimitive] = bounds.m_BoxHalfExtents;
+
+    if (uiPrimitive >= m_uiNumBuiltPrimitives)
+      return;
+
+    // Grow the nodes above the primitive right away so that queries stay correct. They are tightened again by the next refit.
+    const ezSimdBBox box = GetPrimitiveBox(bounds.GetSphere(), bounds.m_BoxHalfExtents);
+
+    ezUInt32 uiNodeIndex = m_LeafIndices[uiPrimitive];
+    MarkDirty(uiNodeIndex);
+
+    while (uiNodeIndex != ezInvalidIndex)
+    {
+      Node& node = m_Nodes[uiNodeIndex];
+      if (node.m_Bounds.Contains(box))
+        break;
+
+      m_fSumNodeAreas -= GetHalfSurfaceArea(node.m_Bounds);
+      node.m_Bounds.ExpandToInclude(box);
+      m_fSumNodeAreas += GetHalfSurfaceArea(node.m_Bounds);
+
+      uiNodeIndex = node.m_uiParentIndex;
+    }
+  }
+
+  EZ_ALWAYS_INLINE void MarkDirty(ezUInt32 uiNodeIndex)
+  {
+    if (!m_DirtyNodeBits.IsBitSet(uiNodeIndex))
+    {
+      m_DirtyNodeBits.SetBit(uiNodeIndex);
+      m_DirtyNodeIndices.PushBack(uiNodeIndex);
+    }
+  }
+
+  void RefitNode(ezUInt32 uiNodeIndex)
+  {
+    Node& node = m_Nodes[uiNodeIndex];
+    ezSimdBBox bounds;
+
+    if (node.IsLeaf())
+    {
+      bounds = ezSimdBBox::MakeInvalid();
+
+      const ezUInt32 uiEnd = node.m_uiFirstPrimitive + node.m_uiNumPrimitives;
+      for (ezUInt32 i = node.m_uiFirstPrimitive; i < uiEnd; ++i)
+      {
+        if (m_DataIndices[i] != ezInvalidIndex)
+        {
+          bounds.ExpandToInclude(GetPrimitiveBox(m_BoundingSpheres[i], m_BoundingBoxHalfExtents[i]));
+        }
+      }
+
+      if (!bounds.IsValid())
+      {
+        // All primitives have been removed, collapse the node so it doesn't inflate its parents
+        bounds = ezSimdBBox::MakeFromCenterAndHalfExtents(node.m_Bounds.GetCenter(), ezSimdVec4f::MakeZero());
+      }
+    }
+    else
+    {
+      bounds = m_Nodes[node.m_uiFirstChildIndex].m_Bounds;
+      bounds.ExpandToInclude(m_Nodes[node.m_uiFirstChildIndex + 1].m_Bounds);
+    }
+
+    m_fSumNodeAreas += GetHalfSurfaceArea(bounds) - GetHalfSurfaceArea(node.m_Bounds);
+    node.m_Bounds = bounds;
+  }
+
+  void Refit()
+  {
+    if (m_DirtyNodeIndices.IsEmpty())
+      return;
+
+    EZ_PROFILE_SCOPE("Refit Spatial BVH");
+
+    // Add all parents of the dirty leaves
+    const ezUInt32 uiNumDirtyLeaves = m_DirtyNodeIndices.GetCount();
+    for (ezUInt32 i = 0; i < uiNumDirtyLeaves; ++i)
+    {
+      ezUInt32 uiParentIndex = m_Nodes[m_DirtyNodeIndices[i]].m_uiParentIndex;
+      while (uiParentIndex != ezInvalidIndex && !m_DirtyNodeBits.IsBitSet(uiParentIndex))
+      {
+        MarkDirty(uiParentIndex);
+        uiParentIndex = m_Nodes[uiParentIndex].m_uiParentIndex;
+      }
+    }
+
+    // Children always have a higher index than their parent, so refitting in descending order updates all children first
+    m_DirtyNodeIndices.Sort();
+    for (ezUInt32 i = m_DirtyNodeIndices.GetCount(); i-- > 0;)
+    {
+      const ezUInt32 uiNodeIndex = m_DirtyNodeIndices[i];
+      RefitNode(uiNodeIndex);
+      m_DirtyNodeBits.ClearBit(uiNodeIndex);
+    }
+
+    m_DirtyNodeIndices.Clear();
+  }
+
+  void RefitAll()
+  {
+    m_DirtyNodeIndices.Clear();
+    m_DirtyNodeBits.Clear();
+    m_DirtyNodeBits.SetCount(m_Nodes.GetCount());
+
+    for (ezUInt32 i = m_Nodes.GetCount(); i-- > 0;)
+    {
+      RefitNode(i);
+    }
+
+    double fSumNodeAreas = 0.0;
+    for (auto& node : m_Nodes)
+    {
+      fSumNodeAreas += GetHalfSurfaceArea(node.m_Bounds);
+    }
+
+    m_fSumNodeAreas = fSumNodeAreas;
+    m_fBuiltSumNodeAreas = fSumNodeAreas;
+  }
+
+  bool NeedsRebuild() const
+  {
+    if (GetNumUnsortedPrimitives() > ezMath::Max<ezUInt32>(MIN_NUM_UNSORTED_PRIMITIVES_FOR_REBUILD, m_uiNumBuiltPrimitives / 8))
+      return true;
+
+    if (m_uiNumRemovedPrimitives > m_uiNumBuiltPrimitives / 4)
+      return true;
+
+    return m_fSumNodeAreas > m_fBuiltSumNodeAreas * ezMath::Max(cvar_SpatialBVHRebuildThreshold.GetValue(), 1.0f);
+  }
+
+  ezDynamicArray<Node> m_Nodes;
+
+  // Primitives [0, m_uiNumBuiltPrimitives) are referenced by the tree nodes, all others are unsorted and tested linearly.
+  ezDynamicArray<ezSimdBSphere> m_BoundingSpheres;
+  ezDynamicArray<ezSimdVec4f> m_BoundingBoxHalfExtents;
+  ezDynamicArray<ezUInt32> m_DataIndices; ///< ezInvalidIndex for removed primitives.
+  ezDynamicArray<ezUInt32> m_LeafIndices; ///< The leaf node for each built primitive.
+  ezUInt32 m_uiNumBuiltPrimitives = 0;
+  ezUInt32 m_uiNumRemovedPrimitives = 0;
+
+  ezDynamicArray<ezUInt32> m_DataIndexToPrimitive;
+  ezDynamicArray<ezUInt32> m_AlwaysVisibleDataIndices;
+
+  ezDynamicArray<ezUInt32> m_DirtyNodeIndices;
+  ezDynamicBitfield m_DirtyNodeBits;
+
+  double m_fSumNodeAreas = 0.0;
+  double m_fBuiltSumNodeAreas = 0.0;
+
+  ezUniquePtr<BuildData> m_pBuildData;
+  ezSharedPtr<ezTask> m_pBuildTask;
+  ezTaskGroupID m_BuildTaskGroupID;
+
+  const ezSpatialData::Category m_Category;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace ezInternal
+{
+  struct BVHQueryHelper
+  {
+    using Node = ezSpatialSystem_DynamicBVH::Node;
+    using Tree = ezSpatialSystem_DynamicBVH::Tree;
+
+    struct Stats
+    {
+      ezUInt32 m_uiNumObjectsTested = 0;
+      ezUInt32 m_uiNumObjectsPassed = 0;
+    };
+
+    template <typename T, bool UseTagsFilter>
+    static ezVisitorExecution::Enum ShapeQuery(const ezSpatialSystem_DynamicBVH& system, const Tree& tree, const T& shape, const ezSpatialSystem::QueryParams& queryParams, Stats& ref_stats, const ezSpatialSystem::QueryCallback& callback)
+    {
+      auto boundingSpheres = tree.m_BoundingSpheres.GetData();
+      auto dataIndices = tree.m_DataIndices.GetData();
+
+      auto TestPrimitives = [&](ezUInt32 uiFirst, ezUInt32 uiEnd)
+      {
+        ref_stats.m_uiNumObjectsTested += uiEnd - uiFirst;
+
+        for (ezUInt32 i = uiFirst; i < uiEnd; ++i)
+        {
+          const ezUInt32 uiDataIndex = dataIndices[i];
+          if (uiDataIndex == ezInvalidIndex || !shape.Overlaps(boundingSpheres[i]))
+            continue;
+
+          auto& data = system.m_DataTable.GetValueUnchecked(uiDataIndex);
+
+          if constexpr (UseTagsFilter)
+          {
+            if (FilterByTags(data.m_Tags, queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
+              continue;
+          }
+
+          ref_stats.m_uiNumObjectsPassed++;
+
+          if (callback(data.m_pObject) == ezVisitorExecution::Stop)
+            return ezVisitorExecution::Stop;
+        }
+
+        return ezVisitorExecution::Continue;
+      };
+
+      if (!tree.m_Nodes.IsEmpty())
+      {
+        ezHybridArray<ezUInt32, 64> nodeStack;
+        nodeStack.PushBack(0);
+
+        while (!nodeStack.IsEmpty())
+        {
+          const Node& node = tree.m_Nodes[nodeStack.PeekBack()];
+          nodeStack.PopBack();
+
+          if (!node.m_Bounds.Overlaps(shape))
+            continue;
+
+          if (node.IsLeaf())
+          {
+            if (TestPrimitives(node.m_uiFirstPrimitive, node.m_uiFirstPrimitive + node.m_uiNumPrimitives) == ezVisitorExecution::Stop)
+              return ezVisitorExecution::Stop;
+          }
+          else
+          {
+            nodeStack.PushBack(node.m_uiFirstChildIndex + 1);
+            nodeStack.PushBack(node.m_uiFirstChildIndex);
+          }
+        }
+      }
+
+      if (TestPrimitives(tree.m_uiNumBuiltPrimitives, tree.GetNumPrimitives()) == ezVisitorExecution::Stop)
+        return ezVisitorExecution::Stop;
+
+      for (ezUInt32 uiDataIndex : tree.m_AlwaysVisibleDataIndices)
+      {
+        auto& data = system.m_DataTable.GetValueUnchecked(uiDataIndex);
+
+        if constexpr (UseTagsFilter)
+        {
+          if (FilterByTags(data.m_Tags, queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
+            continue;
+        }
+
+        ref_stats.m_uiNumObjectsPassed++;
+
+        if (callback(data.m_pObject) == ezVisitorExecution::Stop)
+          return ezVisitorExecution::Stop;
+      }
+
+      return ezVisitorExecution::Continue;
+    }
+
+    struct FrustumQueryData
+    {
+      PlaneData m_PlaneData;
+      ezDynamicArray<const ezGameObject*>* m_pOutObjects;
+      ezUInt64 m_uiFrameIdxAndType;
+      ezSpatialSystem::IsOccludedFunc m_IsOccludedCB;
+    };
+
+    template <bool UseTagsFilter, bool UseOcclusionCallback>
+    static void FrustumQuery(const ezSpatialSystem_DynamicBVH& system, const Tree& tree, const FrustumQueryData& queryData, const ezSpatialSystem::QueryParams& queryParams, Stats& ref_stats)
+    {
+      const PlaneData& planeData = queryData.m_PlaneData;
+
+      auto boundingSpheres = tree.m_BoundingSpheres.GetData();
+      auto boundingBoxHalfExtents = tree.m_BoundingBoxHalfExtents.GetData();
+      auto dataIndices = tree.m_DataIndices.GetData();
+
+      auto AddVisibleObject = [&](const ezSpatialSystem_DynamicBVH::Data& data)
+      {
+        data.m_LastVisibleFrameIdxAndVisType.Max(queryData.m_uiFrameIdxAndType);
+        queryData.m_pOutObjects->PushBack(data.m_pObject);
+
+        ref_stats.m_uiNumObjectsPassed++;
+      };
+
+      auto TestPrimitives = [&](ezUInt32 uiFirst, ezUInt32 uiEnd, bool bTestFrustum)
+      {
+        ref_stats.m_uiNumObjectsTested += uiEnd - uiFirst;
+
+        for (ezUInt32 i = uiFirst; i < uiEnd; ++i)
+        {
+          const ezUInt32 uiDataIndex = dataIndices[i];
+          if (uiDataIndex == ezInvalidIndex)
+            continue;
+
+          if (bTestFrustum && !SphereFrustumIntersect(boundingSpheres[i], planeData))
+            continue;
+
+          auto& data = system.m_DataTable.GetValueUnchecked(uiDataIndex);
+
+          if constexpr (UseTagsFilter)
+          {
+            if (FilterByTags(data.m_Tags, queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
+              continue;
+          }
+
+          if constexpr (UseOcclusionCallback)
+          {
+            const ezSimdBBox bbox = ezSimdBBox::MakeFromCenterAndHalfExtents(boundingSpheres[i].GetCenter(), boundingBoxHalfExtents[i]);
+            if (queryData.m_IsOccludedCB(bbox))
+              continue;
+          }
+
+          AddVisibleObject(data);
+        }
+      };
+
+      if (!tree.m_Nodes.IsEmpty())
+      {
+        ezHybridArray<ezUInt32, 64> nodeStack;
+        nodeStack.PushBack(0);
+
+        while (!nodeStack.IsEmpty())
+        {
+          const Node& node = tree.m_Nodes[nodeStack.PeekBack()];
+          nodeStack.PopBack();
+
+          const ezVolumePosition::Enum pos = ezInternal::SpatialSystemUtils::BoxFrustumIntersect(node.m_Bounds, planeData);
+          if (pos == ezVolumePosition::Outside)
+            continue;
+
+          if (pos == ezVolumePosition::Inside)
+          {
+            // The whole sub-tree is visible, no need to test the individual objects against the frustum
+            TestPrimitives(node.m_uiFirstPrimitive, node.m_uiFirstPrimitive + node.m_uiNumPrimitives, false);
+          }
+          else if (node.IsLeaf())
+          {
+            TestPrimitives(node.m_uiFirstPrimitive, node.m_uiFirstPrimitive + node.m_uiNumPrimitives, true);
+          }
+          else
+          {
+            nodeStack.PushBack(node.m_uiFirstChildIndex + 1);
+            nodeStack.PushBack(node.m_uiFirstChildIndex);
+          }
+        }
+      }
+
+      TestPrimitives(tree.m_uiNumBuiltPrimitives, tree.GetNumPrimitives(), true);
+
+      for (ezUInt32 uiDataIndex : tree.m_AlwaysVisibleDataIndices)
+      {
+        auto& data = system.m_DataTable.GetValueUnchecked(uiDataIndex);
+
+        if constexpr (UseTagsFilter)
+        {
+          if (FilterByTags(data.m_Tags, queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
+            continue;
+        }
+
+        AddVisibleObject(data);
+      }
+    }
+
+    struct RayMetric
+    {
+      EZ_ALWAYS_INLINE bool GetDistance(const ezSimdBBox& box, float fMaxDistance, float& out_fDistance) const
+      {
+        float fExitDistance;
+        return ezInternal::SpatialSystemUtils::RayBoxIntersect(box, m_RayData, out_fDistance, fExitDistance) && out_fDistance <= fMaxDistance;
+      }
+
+      RayData m_RayData;
+    };
+
+    struct PointMetric
+    {
+      EZ_ALWAYS_INLINE bool GetDistance(const ezSimdBBox& box, float fMaxDistance, float& out_fDistance) const
+      {
+        out_fDistance = box.GetDistanceTo(m_vPosition);
+        return out_fDistance <= fMaxDistance;
+      }
+
+      ezSimdVec4f m_vPosition;
+    };
+
+    /// \brief Walks the nodes of all given trees ordered by their distance, closest first.
+    ///
+    /// Before a node is opened, emitFunc is called with its distance, at that point all objects closer than that have been added to the results.
+    template <typename Metric, bool UseTagsFilter, typename EmitFunc>
+    static ezVisitorExecution::Enum OrderedQuery(const ezSpatialSystem_DynamicBVH& system, const Metric& metric, float fMaxDistance, const ezSpatialSystem::QueryParams& queryParams, SortedQueryResults& ref_results, Stats& ref_stats, EmitFunc emitFunc)
+    {
+      struct NodeEntry
+      {
+        EZ_DECLARE_POD_TYPE();
+
+        const Tree* m_pTree;
+        ezUInt32 m_uiNodeIndex;
+        float m_fDistance;
+      };
+
+      // Min-heap by distance, the closest node is always at index 0
+      ezHybridArray<NodeEntry, 64> nodes;
+      auto IsCloser = [](const NodeEntry& a, const NodeEntry& b)
+      {
+        return a.m_fDistance < b.m_fDistance;
+      };
+
+      auto AddNode = [&](const Tree& tree, ezUInt32 uiNodeIndex)
+      {
+        float fDistance;
+        if (!metric.GetDistance(tree.m_Nodes[uiNodeIndex].m_Bounds, ref_results.GetMaxDistance(fMaxDistance), fDistance))
+          return;
+
+        ezInternal::SpatialSystemUtils::HeapPush(nodes, {&tree, uiNodeIndex, fDistance}, IsCloser);
+      };
+
+      auto TestPrimitives = [&](const Tree& tree, ezUInt32 uiFirst, ezUInt32 uiEnd)
+      {
+        auto boundingSpheres = tree.m_BoundingSpheres.GetData();
+        auto boundingBoxHalfExtents = tree.m_BoundingBoxHalfExtents.GetData();
+        auto dataIndices = tree.m_DataIndices.GetData();
+
+        ref_stats.m_uiNumObjectsTested += uiEnd - uiFirst;
+
+        for (ezUInt32 i = uiFirst; i < uiEnd; ++i)
+        {
+          const ezUInt32 uiDataIndex = dataIndices[i];
+          if (uiDataIndex == ezInvalidIndex)
+            continue;
+
+          const ezSimdBBox objectBox = ezSimdBBox::MakeFromCenterAndHalfExtents(boundingSpheres[i].GetCenter(), boundingBoxHalfExtents[i]);
+
+          float fDistance;
+          if (!metric.GetDistance(objectBox, ref_results.GetMaxDistance(fMaxDistance), fDistance))
+            continue;
+
+          auto& data = system.m_DataTable.GetValueUnchecked(uiDataIndex);
+
+          if constexpr (UseTagsFilter)
+          {
+            if (FilterByTags(data.m_Tags, queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
+              continue;
+          }
+
+          ref_stats.m_uiNumObjectsPassed++;
+          ref_results.Add(data.m_pObject, uiDataIndex, fDistance);
+        }
+      };
+
+      system.ForEachTree(queryParams.m_uiCategoryBitmask,
+        [&](const Tree& tree)
+        {
+          TestPrimitives(tree, tree.m_uiNumBuiltPrimitives, tree.GetNumPrimitives());
+
+          if (!tree.m_Nodes.IsEmpty())
+          {
+            AddNode(tree, 0);
+          }
+
+          return ezVisitorExecution::Continue;
+        });
+
+      while (!nodes.IsEmpty())
+      {
+        const NodeEntry entry = nodes[0];
+        if (entry.m_fDistance > ref_results.GetMaxDistance(fMaxDistance))
+          break;
+
+        if (emitFunc(entry.m_fDistance) == ezVisitorExecution::Stop)
+          return ezVisitorExecution::Stop;
+
+        ezInternal::SpatialSystemUtils::HeapPop(nodes, IsCloser);
+
+        const Tree& tree = *entry.m_pTree;
+        const Node& node = tree.m_Nodes[entry.m_uiNodeIndex];
+
+        if (node.IsLeaf())
+        {
+          TestPrimitives(tree, node.m_uiFirstPrimitive, node.m_uiFirstPrimitive + node.m_uiNumPrimitives);
+        }
+        else
+        {
+          AddNode(tree, node.m_uiFirstChildIndex);
+          AddNode(tree, node.m_uiFirstChildIndex + 1);
+        }
+      }
+
+      return ezVisitorExecution::Continue;
+    }
+  };
+} // namespace ezInternal
+
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_DynamicBVH, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezSpatialSystem_DynamicBVH::ezSpatialSystem_DynamicBVH()
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_Trees(&m_Allocator)
+  , m_DataTable(&m_Allocator)
+{
+  m_Trees.SetCount(MAX_NUM_TREES);
+}
+
+ezSpatialSystem_DynamicBVH::~ezSpatialSystem_DynamicBVH() = default;
+
+void ezSpatialSystem_DynamicBVH::RebuildAllTrees()
+{
+  EZ_PROFILE_SCOPE("RebuildAllTrees");
+
+  for (auto& pTree : m_Trees)
+  {
+    if (pTree == nullptr)
+      continue;
+
+    if (pTree->m_pBuildTask != nullptr)
+    {
+      ezTaskSystem::WaitForGroup(pTree->m_BuildTaskGroupID);
+      FinishBuild(*pTree);
+    }
+
+    pTree->Refit();
+
+    if (pTree->GetNumUnsortedPrimitives() > 0 || pTree->m_uiNumRemovedPrimitives > 0 || pTree->m_fSumNodeAreas > pTree->m_fBuiltSumNodeAreas)
+    {
+      StartBuild(*pTree, false);
+    }
+  }
+}
+
+void ezSpatialSystem_DynamicBVH::GetAllNodeBoxes(ezDynamicArray<ezBoundingBox>& out_boundingBoxes, ezSpatialData::Category filterCategory /*= ezInvalidSpatialDataCategory*/, ezUInt32 uiMaxDepth /*= 8*/) const
+{
+  const ezUInt32 uiCategoryBitmask = filterCategory != ezInvalidSpatialDataCategory ? filterCategory.GetBitmask() : 0xFFFFFFFF;
+
+  ForEachTree(uiCategoryBitmask,
+    [&](const Tree& tree)
+    {
+      if (tree.m_Nodes.IsEmpty())
+        return ezVisitorExecution::Continue;
+
+      struct StackEntry
+      {
+        EZ_DECLARE_POD_TYPE();
+
+        ezUInt32 m_uiNodeIndex;
+        ezUInt32 m_uiDepth;
+      };
+
+      ezHybridArray<StackEntry, 64> nodeStack;
+      nodeStack.PushBack({0, 0});
+
+      while (!nodeStack.IsEmpty())
+      {
+        const StackEntry entry = nodeStack.PeekBack();
+        nodeStack.PopBack();
+
+        const Node& node = tree.m_Nodes[entry.m_uiNodeIndex];
+        out_boundingBoxes.PushBack(ezSimdConversion::ToBBox(node.m_Bounds));
+
+        if (!node.IsLeaf() && entry.m_uiDepth < uiMaxDepth)
+        {
+          nodeStack.PushBack({node.m_uiFirstChildIndex, entry.m_uiDepth + 1});
+          nodeStack.PushBack({node.m_uiFirstChildIndex + 1, entry.m_uiDepth + 1});
+        }
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+}
+
+void ezSpatialSystem_DynamicBVH::StartNewFrame()
+{
+  SUPER::StartNewFrame();
+
+  EZ_PROFILE_SCOPE("Update Spatial BVH");
+
+  const ezUInt32 uiBackgroundBuildThreshold = ezMath::Max(cvar_SpatialBVHBackgroundBuildThreshold.GetValue(), 0);
+
+  for (auto& pTree : m_Trees)
+  {
+    if (pTree == nullptr)
+      continue;
+
+    if (pTree->m_pBuildTask != nullptr)
+    {
+      if (!ezTaskSystem::IsTaskGroupFinished(pTree->m_BuildTaskGroupID))
+      {
+        pTree->Refit();
+        continue;
+      }
+
+      FinishBuild(*pTree);
+    }
+
+    pTree->Refit();
+
+    if (pTree->NeedsRebuild())
+    {
+      StartBuild(*pTree, pTree->GetNumLivePrimitives() >= uiBackgroundBuildThreshold);
+    }
+  }
+}
+
+ezSpatialDataHandle ezSpatialSystem_DynamicBVH::CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  return AddSpatialDataToTrees(bounds, pObject, uiCategoryBitmask, tags, false);
+}
+
+ezSpatialDataHandle ezSpatialSystem_DynamicBVH::CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  return AddSpatialDataToTrees(ezSimdBBoxSphere(), pObject, uiCategoryBitmask, tags, true);
+}
+
+void ezSpatialSystem_DynamicBVH::DeleteSpatialData(const ezSpatialDataHandle& hData)
+{
+  Data oldData;
+  EZ_VERIFY(m_DataTable.Remove(hData.GetInternalID(), &oldData), "Invalid spatial data handle");
+
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+  ForEachTree(oldData.m_uiCategoryBitmask,
+    [&](Tree& ref_tree)
+    {
+      if (oldData.m_bAlwaysVisible)
+      {
+        ref_tree.m_AlwaysVisibleDataIndices.RemoveAndSwap(uiDataIndex);
+      }
+      else
+      {
+        ref_tree.RemovePrimitive(uiDataIndex);
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+}
+
+void ezSpatialSystem_DynamicBVH::UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  // No need to update bounds for always visible data
+  if (pData->m_bAlwaysVisible)
+    return;
+
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+  ForEachTree(pData->m_uiCategoryBitmask,
+    [&](Tree& ref_tree)
+    {
+      ref_tree.UpdatePrimitiveBounds(uiDataIndex, bounds);
+      return ezVisitorExecution::Continue;
+    });
+}
+
+void ezSpatialSystem_DynamicBVH::UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject)
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  pData->m_pObject = pObject;
+}
+
+void ezSpatialSystem_DynamicBVH::FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsInSphere");
+
+  ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+
+  const bool bUseTagsFilter = ezInternal::SpatialSystemUtils::UseTagsFilter(queryParams);
+  ezInternal::BVHQueryHelper::Stats stats;
+
+  ForEachTree(queryParams.m_uiCategoryBitmask,
+    [&](const Tree& tree)
+    {
+      return bUseTagsFilter ? ezInternal::BVHQueryHelper::ShapeQuery<ezSimdBSphere, true>(*this, tree, simdSphere, queryParams, stats, callback)
+                            : ezInternal::BVHQueryHelper::ShapeQuery<ezSimdBSphere, false>(*this, tree, simdSphere, queryParams, stats, callback);
+    });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_DynamicBVH::FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsInBox");
+
+  ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  const bool bUseTagsFilter = ezInternal::SpatialSystemUtils::UseTagsFilter(queryParams);
+  ezInternal::BVHQueryHelper::Stats stats;
+
+  ForEachTree(queryParams.m_uiCategoryBitmask,
+    [&](const Tree& tree)
+    {
+      return bUseTagsFilter ? ezInternal::BVHQueryHelper::ShapeQuery<ezSimdBBox, true>(*this, tree, simdBox, queryParams, stats, callback)
+                            : ezInternal::BVHQueryHelper::ShapeQuery<ezSimdBBox, false>(*this, tree, simdBox, queryParams, stats, callback);
+    });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_DynamicBVH::FindObjectsAlongRay(const ezVec3& vStart, const ezVec3& vDirection, float fMaxDistance, const QueryParams& queryParams, RayQueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsAlongRay");
+
+  ezInternal::BVHQueryHelper::RayMetric metric;
+  metric.m_RayData = ezInternal::SpatialSystemUtils::ComputeRayData(vStart, vDirection, fMaxDistance);
+
+  SortedQueryResults results;
+  ezInternal::BVHQueryHelper::Stats stats;
+
+  // Hits that are closer than the next node can't be preceded by any other hit anymore
+  auto EmitFunc = [&](float fDistance)
+  {
+    return results.Emit(fDistance, callback);
+  };
+
+  const ezVisitorExecution::Enum res = ezInternal::SpatialSystemUtils::UseTagsFilter(queryParams)
+                                         ? ezInternal::BVHQueryHelper::OrderedQuery<ezInternal::BVHQueryHelper::RayMetric, true>(*this, metric, fMaxDistance, queryParams, results, stats, EmitFunc)
+                                         : ezInternal::BVHQueryHelper::OrderedQuery<ezInternal::BVHQueryHelper::RayMetric, false>(*this, metric, fMaxDistance, queryParams, results, stats, EmitFunc);
+
+  if (res == ezVisitorExecution::Continue)
+  {
+    results.Emit(fMaxDistance, callback);
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_DynamicBVH::FindNearestObjects(const ezVec3& vPosition, ezUInt32 uiMaxObjects, float fMaxDistance, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const
+{
+  EZ_PROFILE_SCOPE("FindNearestObjects");
+
+  out_objects.Clear();
+
+  if (uiMaxObjects == 0)
+    return;
+
+  ezInternal::BVHQueryHelper::PointMetric metric;
+  metric.m_vPosition = ezSimdConversion::ToVec3(vPosition);
+
+  SortedQueryResults results(uiMaxObjects);
+  ezInternal::BVHQueryHelper::Stats stats;
+
+  auto EmitFunc = [](float)
+  {
+    return ezVisitorExecution::Continue;
+  };
+
+  if (ezInternal::SpatialSystemUtils::UseTagsFilter(queryParams))
+    ezInternal::BVHQueryHelper::OrderedQuery<ezInternal::BVHQueryHelper::PointMetric, true>(*this, metric, fMaxDistance, queryParams, results, stats, EmitFunc);
+  else
+    ezInternal::BVHQueryHelper::OrderedQuery<ezInternal::BVHQueryHelper::PointMetric, false>(*this, metric, fMaxDistance, queryParams, results, stats, EmitFunc);
+
+  results.GetObjects(out_objects);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_DynamicBVH::FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::IsOccludedFunc IsOccluded, ezVisibilityState visType) const
+{
+  EZ_PROFILE_SCOPE("FindVisibleObjects");
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezStopwatch timer;
+#endif
+
+  ezInternal::BVHQueryHelper::FrustumQueryData queryData;
+  queryData.m_PlaneData = ezInternal::SpatialSystemUtils::ComputePlaneData(frustum);
+  queryData.m_pOutObjects = &out_Objects;
+  queryData.m_uiFrameIdxAndType = (m_uiFrameCounter << 4) | static_cast<ezUInt64>(visType);
+  queryData.m_IsOccludedCB = IsOccluded;
+
+  const bool bUseTagsFilter = ezInternal::SpatialSystemUtils::UseTagsFilter(queryParams);
+  ezInternal::BVHQueryHelper::Stats stats;
+
+  ForEachTree(queryParams.m_uiCategoryBitmask,
+    [&](const Tree& tree)
+    {
+      if (IsOccluded.IsValid())
+      {
+        if (bUseTagsFilter)
+          ezInternal::BVHQueryHelper::FrustumQuery<true, true>(*this, tree, queryData, queryParams, stats);
+        else
+          ezInternal::BVHQueryHelper::FrustumQuery<false, true>(*this, tree, queryData, queryParams, stats);
+      }
+      else
+      {
+        if (bUseTagsFilter)
+          ezInternal::BVHQueryHelper::FrustumQuery<true, false>(*this, tree, queryData, queryParams, stats);
+        else
+          ezInternal::BVHQueryHelper::FrustumQuery<false, false>(*this, tree, queryData, queryParams, stats);
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+    queryParams.m_pStats->m_TimeTaken = timer.GetRunningTotal();
+  }
+#endif
+}
+
+ezVisibilityState ezSpatialSystem_DynamicBVH::GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  if (pData->m_bAlwaysVisible)
+    return ezVisibilityState::Direct;
+
+  const ezUInt64 uiLastVisibleFrameIdxAndVisType = pData->m_LastVisibleFrameIdxAndVisType;
+  const ezUInt64 uiLastVisibleFrameIdx = (uiLastVisibleFrameIdxAndVisType >> 4);
+  const ezUInt64 uiLastVisibilityType = (uiLastVisibleFrameIdxAndVisType & static_cast<ezUInt64>(15)); // mask out lower 4 bits
+
+  if (m_uiFrameCounter > uiLastVisibleFrameIdx + uiNumFramesBeforeInvisible)
+    return ezVisibilityState::Invisible;
+
+  return static_cast<ezVisibilityState>(uiLastVisibilityType);
+}
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+void ezSpatialSystem_DynamicBVH::GetInternalStats(ezStringBuilder& sb) const
+{
+  ezUInt32 uiNumActiveTrees = 0;
+  for (auto& pTree : m_Trees)
+  {
+    uiNumActiveTrees += (pTree != nullptr) ? 1 : 0;
+  }
+
+  sb.SetFormat("Num Trees: {}\n", uiNumActiveTrees);
+
+  for (auto& pTree : m_Trees)
+  {
+    if (pTree == nullptr)
+      continue;
+
+    const double fDegradation = pTree->m_fBuiltSumNodeAreas > 0.0 ? pTree->m_fSumNodeAreas / pTree->m_fBuiltSumNodeAreas : 1.0;
+
+    sb.AppendFormat(" \nCategory: {}\n", ezSpatialData::GetCategoryName(pTree->m_Category));
+    sb.AppendFormat("Nodes: {}, Objects: {}, Unsorted: {}, Removed: {}, Always Visible: {}\n", pTree->m_Nodes.GetCount(), pTree->GetNumLivePrimitives(), pTree->GetNumUnsortedPrimitives(), pTree->m_uiNumRemovedPrimitives, pTree->m_AlwaysVisibleDataIndices.GetCount());
+    sb.AppendFormat("Refit Degradation: {}, Building: {}\n", ezArgF(fDegradation, 2), pTree->m_pBuildTask != nullptr);
+  }
+}
+#endif
+
+ezSpatialDataHandle ezSpatialSystem_DynamicBVH::AddSpatialDataToTrees(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible)
+{
+  Data data;
+  data.m_pObject = pObject;
+  data.m_Tags = tags;
+  data.m_uiCategoryBitmask = uiCategoryBitmask;
+  data.m_bAlwaysVisible = bAlwaysVisible;
+
+  auto hData = ezSpatialDataHandle(m_DataTable.Insert(data));
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+  ezUInt32 uiTreeBitmask = uiCategoryBitmask;
+  while (uiTreeBitmask > 0)
+  {
+    const ezUInt32 uiTreeIndex = ezMath::FirstBitLow(uiTreeBitmask);
+    uiTreeBitmask &= uiTreeBitmask - 1;
+
+    auto& pTree = m_Trees[uiTreeIndex];
+    if (pTree == nullptr)
+    {
+      pTree = EZ_NEW(&m_Allocator, Tree, *this, ezSpatialData::Category(static_cast<ezUInt16>(uiTreeIndex)));
+    }
+
+    if (bAlwaysVisible)
+    {
+      pTree->m_AlwaysVisibleDataIndices.PushBack(uiDataIndex);
+    }
+    else
+    {
+      pTree->AddPrimitive(bounds, uiDataIndex);
+    }
+  }
+
+  return hData;
+}
+
+template <typename Functor>
+EZ_FORCE_INLINE void ezSpatialSystem_DynamicBVH::ForEachTree(ezUInt32 uiCategoryBitmask, Functor func) const
+{
+  while (uiCategoryBitmask > 0)
+  {
+    const ezUInt32 uiTreeIndex = ezMath::FirstBitLow(uiCategoryBitmask);
+    uiCategoryBitmask &= uiCategoryBitmask - 1;
+
+    auto& pTree = m_Trees[uiTreeIndex];
+    if (pTree == nullptr)
+      continue;
+
+    if (func(*pTree) == ezVisitorExecution::Stop)
+      break;
+  }
+}
+
+void ezSpatialSystem_DynamicBVH::StartBuild(Tree& ref_tree, bool bBackground)
+{
+  EZ_PROFILE_SCOPE("StartBuild");
+
+  EZ_ASSERT_DEBUG(ref_tree.m_pBuildTask == nullptr, "A build is already running for this tree");
+
+  ref_tree.m_pBuildData = EZ_NEW(&m_Allocator, BuildData, &m_AlignedAllocator, &m_Allocator);
+  BuildData* pBuildData = ref_tree.m_pBuildData.Borrow();
+
+  // Take a snapshot of all live primitives
+  const ezUInt32 uiNumLivePrimitives = ref_tree.GetNumLivePrimitives();
+  pBuildData->m_BoundingSpheres.Reserve(uiNumLivePrimitives);
+  pBuildData->m_BoundingBoxHalfExtents.Reserve(uiNumLivePrimitives);
+  pBuildData->m_DataIndices.Reserve(uiNumLivePrimitives);
+
+  for (ezUInt32 i = 0; i < ref_tree.GetNumPrimitives(); ++i)
+  {
+    const ezUInt32 uiDataIndex = ref_tree.m_DataIndices[i];
+    if (uiDataIndex == ezInvalidIndex)
+      continue;
+
+    pBuildData->m_BoundingSpheres.PushBack(ref_tree.m_BoundingSpheres[i]);
+    pBuildData->m_BoundingBoxHalfExtents.PushBack(ref_tree.m_BoundingBoxHalfExtents[i]);
+    pBuildData->m_DataIndices.PushBack(uiDataIndex);
+  }
+
+  if (bBackground)
+  {
+    ref_tree.m_pBuildTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "Build Spatial BVH", ezTaskNesting::Never, [pBuildData]()
+      { pBuildData->Build(); });
+
+    ref_tree.m_BuildTaskGroupID = ezTaskSystem::StartSingleTask(ref_tree.m_pBuildTask, ezTaskPriority::In4Frames);
+  }
+  else
+  {
+    pBuildData->Build();
+    FinishBuild(ref_tree);
+  }
+}
+
+void ezSpatialSystem_DynamicBVH::FinishBuild(Tree& ref_tree)
+{
+  EZ_PROFILE_SCOPE("FinishBuild");
+
+  BuildData& buildData = *ref_tree.m_pBuildData;
+
+  const ezUInt32 uiNumBuiltPrimitives = buildData.m_DataIndices.GetCount();
+  ezUInt32 uiNumRemovedPrimitives = 0;
+
+  ezDynamicArray<ezUInt32> dataIndexToPrimitive(&m_Allocator);
+  dataIndexToPrimitive.SetCount(ref_tree.m_DataIndexToPrimitive.GetCount(), ezInvalidIndex);
+
+  // Objects might have been moved or removed while the tree was built in the background
+  for (ezUInt32 i = 0; i < uiNumBuiltPrimitives; ++i)
+  {
+    const ezUInt32 uiDataIndex = buildData.m_DataIndices[i];
+    const ezUInt32 uiOldPrimitive = ref_tree.m_DataIndexToPrimitive[uiDataIndex];
+
+    if (uiOldPrimitive == ezInvalidIndex)
+    {
+      buildData.m_DataIndices[i] = ezInvalidIndex;
+      ++uiNumRemovedPrimitives;
+      continue;
+    }
+
+    dataIndexToPrimitive[uiDataIndex] = i;
+    buildData.m_BoundingSpheres[i] = ref_tree.m_BoundingSpheres[uiOldPrimitive];
+    buildData.m_BoundingBoxHalfExtents[i] = ref_tree.m_BoundingBoxHalfExtents[uiOldPrimitive];
+  }
+
+  // Objects that have been added in the meantime go to the unsorted list of the new tree
+  for (ezUInt32 i = 0; i < ref_tree.GetNumPrimitives(); ++i)
+  {
+    const ezUInt32 uiDataIndex = ref_tree.m_DataIndices[i];
+    if (uiDataIndex == ezInvalidIndex || dataIndexToPrimitive[uiDataIndex] != ezInvalidIndex)
+      continue;
+
+    dataIndexToPrimitive[uiDataIndex] = buildData.m_DataIndices.GetCount();
+    buildData.m_BoundingSpheres.PushBack(ref_tree.m_BoundingSpheres[i]);
+    buildData.m_BoundingBoxHalfExtents.PushBack(ref_tree.m_BoundingBoxHalfExtents[i]);
+    buildData.m_DataIndices.PushBack(uiDataIndex);
+  }
+
+  ref_tree.m_Nodes.Swap(buildData.m_Nodes);
+  ref_tree.m_BoundingSpheres.Swap(buildData.m_BoundingSpheres);
+  ref_tree.m_BoundingBoxHalfExtents.Swap(buildData.m_BoundingBoxHalfExtents);
+  ref_tree.m_DataIndices.Swap(buildData.m_DataIndices);
+  ref_tree.m_LeafIndices.Swap(buildData.m_LeafIndices);
+  ref_tree.m_DataIndexToPrimitive.Swap(dataIndexToPrimitive);
+  ref_tree.m_uiNumBuiltPrimitives = uiNumBuiltPrimitives;
+  ref_tree.m_uiNumRemovedPrimitives = uiNumRemovedPrimitives;
+
+  ref_tree.RefitAll();
+
+  ref_tree.m_pBuildData.Clear();
+  ref_tree.m_pBuildTask = nullptr;
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_DynamicBVH);
@@ -1,32 +1,34 @@
 #include <Core/CorePCH.h>
 
+#include <Core/World/Implementation/SpatialSystemUtils.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Utilities/Metrics.h>
 
 ezCVarInt cvar_SpatialQueriesCachingThreshold("Spatial.Queries.CachingThreshold", 100, ezCVarFlags::Default, "Number of objects that are tested for a query before it is considered for caching");
-
-struct PlaneData
-{
-  ezSimdVec4f m_x0x1x2x3;
-  ezSimdVec4f m_y0y1y2y3;
-  ezSimdVec4f m_z0z1z2z3;
-  ezSimdVec4f m_w0w1w2w3;
-
-  ezSimdVec4f m_x4x5x4x5;
-  ezSimdVec4f m_y4y5y4y5;
-  ezSimdVec4f m_z4z5z4z5;
-  ezSimdVec4f m_w4w5w4w5;
-};
+ezCVarInt cvar_SpatialQueriesParallelBinSize("Spatial.Queries.ParallelBinSize", 16, ezCVarFlags::Default, "Minimum number of grid cells per task when visibility queries are distributed across the task system. 0 disables it.");
 
 namespace
 {
+  ezMetricCounter s_GridQueries("Spatial System/Grid Queries");
+  ezMetricCounter s_ObjectsTested("Spatial System/Objects Tested");
+  ezMetricCounter s_ObjectsPassed("Spatial System/Objects Passed");
+
+  using ezInternal::SpatialSystemUtils::FilterByTags;
+  using ezInternal::SpatialSystemUtils::PlaneData;
+  using ezInternal::SpatialSystemUtils::RayData;
+  using ezInternal::SpatialSystemUtils::SortedQueryResults;
+  using ezInternal::SpatialSystemUtils::SphereFrustumIntersect;
+
   enum
   {
     MAX_CELL_INDEX = (1 << 20) - 1,
-    CELL_INDEX_MASK = (1 << 21) - 1
+    CELL_INDEX_MASK = (1 << 21) - 1,
+    MIN_BATCH_SIZE_FOR_PARALLEL_UPDATE = 256
   };
 
   EZ_ALWAYS_INLINE ezSimdVec4f ToVec3(const ezSimdVec4i& v)
@@ -70,17 +72,6 @@ namespace
     return a.IsEmpty();
   }
 
-  EZ_ALWAYS_INLINE bool FilterByTags(const ezTagSet& tags, const ezTagSet* pIncludeTags, const ezTagSet* pExcludeTags)
-  {
-    if (pExcludeTags != nullptr && !pExcludeTags->IsEmpty() && pExcludeTags->IsAnySet(tags))
-      return true;
-
-    if (pIncludeTags != nullptr && !pIncludeTags->IsEmpty() && !pIncludeTags->IsAnySet(tags))
-      return true;
-
-    return false;
-  }
-
   EZ_ALWAYS_INLINE bool CanBeCached(ezSpatialData::Category category)
   {
     return ezSpatialData::GetCategoryFlags(category).IsSet(ezSpatialData::Flags::FrequentChanges) == false;
@@ -106,73 +97,6 @@ namespace
     out_sSb.Append(" }");
   }
 #endif
-
-  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
-  {
-    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
-    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
-    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
-    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
-
-    ezSimdVec4f dot_0123;
-    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
-
-    ezSimdVec4f dot_4545;
-    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
-
-    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
-    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
-    return (cmp_0123 || cmp_4545).NoneSet<4>();
-  }
-
-  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
-  {
-    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
-    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
-    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
-    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotA_0123;
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
-
-    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
-    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
-    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
-    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotB_0123;
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
-
-    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
-    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
-    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
-    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
-
-    ezSimdVec4f dot_A45B45;
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
-
-    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
-    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
-    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
-
-    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
-    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
-
-    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
-    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
-
-    return result;
-  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -291,6 +215,7 @@ struct ezSpatialSystem_RegularGrid::Grid
       pNewCell->m_Bounds = cellBox;
 
       m_Cells.PushBack(pNewCell);
+      m_CellsBounds.ExpandToInclude(cellBox);
 
       return uiCellIndex;
     }
@@ -326,6 +251,31 @@ struct ezSpatialSystem_RegularGrid::Grid
     mapping = {};
   }
 
+  void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+  {
+    ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+    auto& mapping = m_CellDataMappings[uiDataIndex];
+    auto& pOldCell = m_Cells[mapping.m_uiCellIndex];
+
+    if (pOldCell->m_Bounds.GetBox().Contains(bounds.GetBox()))
+    {
+      pOldCell->m_BoundingSpheres[mapping.m_uiCellDataIndex] = bounds.GetSphere();
+      pOldCell->m_BoundingBoxHalfExtents[mapping.m_uiCellDataIndex] = bounds.m_BoxHalfExtents;
+    }
+    else
+    {
+      const ezTagSet tags = pOldCell->m_TagSets[mapping.m_uiCellDataIndex];
+      ezGameObject* objectPointer = pOldCell->m_ObjectPointers[mapping.m_uiCellDataIndex];
+
+      const ezUInt64 uiLastVisibleFrameIdxAndVisType = pOldCell->m_LastVisibleFrameIdxAndVisType[mapping.m_uiCellDataIndex];
+
+      RemoveSpatialData(hData);
+
+      AddSpatialData(bounds, tags, objectPointer, uiLastVisibleFrameIdxAndVisType, hData);
+    }
+  }
+
   bool MigrateSpatialDataFromOtherGrid(ezUInt32 uiDataIndex, const Grid& other)
   {
     // Data has already been added
@@ -408,6 +358,8 @@ struct ezSpatialSystem_RegularGrid::Grid
   ezHashTable<ezUInt64, ezUInt32, CellKeyHashHelper> m_CellKeyToCellIndex;
   static constexpr ezUInt32 m_uiOverflowCellIndex = 0;
 
+  ezSimdBBox m_CellsBounds = ezSimdBBox::MakeInvalid(); ///< Bounds of all regular cells, cells are never removed so this only grows.
+
   ezDynamicArray<CellDataMapping> m_CellDataMappings;
 
   const ezSpatialData::Category m_Category;
@@ -600,6 +552,110 @@ namespace ezInternal
 
       return ezVisitorExecution::Continue;
     }
+
+    struct OrderedQueryData
+    {
+      struct PendingCell
+      {
+        EZ_DECLARE_POD_TYPE();
+
+        const ezSpatialSystem_RegularGrid::Cell* m_pCell;
+        float m_fDistance;
+        bool m_bUseTagsFilter;
+      };
+
+      ezHashSet<const ezSpatialSystem_RegularGrid::Cell*> m_VisitedCells;
+      ezHybridArray<PendingCell, 64> m_PendingCells;
+
+      RayData m_RayData;
+      ezSimdVec4f m_vPosition;
+      float m_fMaxDistance;
+    };
+
+    /// Ordered queries visit the same cells multiple times while they widen their search area.
+    /// This callback only remembers each new cell together with its distance, the objects are tested once the cell is due.
+    template <bool UseTagsFilter, bool IsRayQuery>
+    static ezVisitorExecution::Enum GatherCellsCallback(const ezSpatialSystem_RegularGrid::Cell& cell, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_RegularGrid::Stats& ref_stats, void* pUserData, ezVisibilityState visType)
+    {
+      auto pQueryData = static_cast<OrderedQueryData*>(pUserData);
+      if (pQueryData->m_VisitedCells.Insert(&cell))
+        return ezVisitorExecution::Continue;
+
+      const ezSimdBBox cellBox = cell.m_Bounds.GetBox();
+      float fDistance;
+
+      if constexpr (IsRayQuery)
+      {
+        float fExitDistance;
+        if (!ezInternal::SpatialSystemUtils::RayBoxIntersect(cellBox, pQueryData->m_RayData, fDistance, fExitDistance))
+          return ezVisitorExecution::Continue;
+      }
+      else
+      {
+        fDistance = cellBox.GetDistanceTo(pQueryData->m_vPosition);
+        if (fDistance > pQueryData->m_fMaxDistance)
+          return ezVisitorExecution::Continue;
+      }
+
+      pQueryData->m_PendingCells.PushBack({&cell, fDistance, UseTagsFilter});
+      return ezVisitorExecution::Continue;
+    }
+
+    /// Tests the objects of all pending cells that are not farther away than the given distance.
+    template <typename Functor>
+    static void ProcessPendingCells(OrderedQueryData& ref_queryData, float fMaxDistance, Functor testObjects)
+    {
+      for (ezUInt32 i = ref_queryData.m_PendingCells.GetCount(); i-- > 0;)
+      {
+        const auto pendingCell = ref_queryData.m_PendingCells[i];
+        if (pendingCell.m_fDistance > fMaxDistance)
+          continue;
+
+        ref_queryData.m_PendingCells.RemoveAtAndSwap(i);
+        testObjects(*pendingCell.m_pCell, pendingCell.m_bUseTagsFilter);
+      }
+    }
+
+    template <bool UseTagsFilter, bool IsRayQuery>
+    static void TestObjects(const ezSpatialSystem_RegularGrid::Cell& cell, const ezSpatialSystem::QueryParams& queryParams, const OrderedQueryData& queryData, SortedQueryResults& ref_results, ezSpatialSystem_RegularGrid::Stats& ref_stats)
+    {
+      auto boundingSpheres = cell.m_BoundingSpheres.GetData();
+      auto boundingBoxHalfExtents = cell.m_BoundingBoxHalfExtents.GetData();
+      auto tagSets = cell.m_TagSets.GetData();
+      auto objectPointers = cell.m_ObjectPointers.GetData();
+      auto dataIndices = cell.m_DataIndices.GetData();
+
+      const ezUInt32 numSpheres = cell.m_BoundingSpheres.GetCount();
+      ref_stats.m_uiNumObjectsTested += numSpheres;
+
+      for (ezUInt32 i = 0; i < numSpheres; ++i)
+      {
+        const ezSimdBBox objectBox = ezSimdBBox::MakeFromCenterAndHalfExtents(boundingSpheres[i].GetCenter(), boundingBoxHalfExtents[i]);
+        float fDistance;
+
+        if constexpr (IsRayQuery)
+        {
+          float fExitDistance;
+          if (!ezInternal::SpatialSystemUtils::RayBoxIntersect(objectBox, queryData.m_RayData, fDistance, fExitDistance))
+            continue;
+        }
+        else
+        {
+          fDistance = objectBox.GetDistanceTo(queryData.m_vPosition);
+          if (fDistance > queryData.m_fMaxDistance)
+            continue;
+        }
+
+        if constexpr (UseTagsFilter)
+        {
+          if (FilterByTags(tagSets[i], queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
+            continue;
+        }
+
+        ref_stats.m_uiNumObjectsPassed++;
+        ref_results.Add(objectPointers[i], dataIndices[i], fDistance);
+      }
+    }
   };
 } // namespace ezInternal
 
@@ -774,27 +830,84 @@ void ezSpatialSystem_RegularGrid::UpdateSpatialDataBounds(const ezSpatialDataHan
   ForEachGrid(*pData, hData,
     [&](Grid& ref_grid, const CellDataMapping& mapping)
     {
-      auto& pOldCell = ref_grid.m_Cells[mapping.m_uiCellIndex];
+      ref_grid.UpdateSpatialDataBounds(hData, bounds);
+      return ezVisitorExecution::Continue;
+    });
+}
 
-      if (pOldCell->m_Bounds.GetBox().Contains(bounds.GetBox()))
-      {
-        pOldCell->m_BoundingSpheres[mapping.m_uiCellDataIndex] = bounds.GetSphere();
-        pOldCell->m_BoundingBoxHalfExtents[mapping.m_uiCellDataIndex] = bounds.m_BoxHalfExtents;
-      }
-      else
-      {
-        const ezTagSet tags = pOldCell->m_TagSets[mapping.m_uiCellDataIndex];
-        ezGameObject* objectPointer = pOldCell->m_ObjectPointers[mapping.m_uiCellDataIndex];
+void ezSpatialSystem_RegularGrid::UpdateSpatialDataBounds(ezArrayPtr<const BoundsUpdate> updates)
+{
+  EZ_PROFILE_SCOPE("UpdateSpatialDataBounds");
+
+  // Distribute the updates to the grids first, grids are independent of each other and can then be updated in parallel
+  m_GridBoundsUpdates.SetCount(m_Grids.GetCount());
+
+  for (ezUInt32 uiUpdateIndex = 0; uiUpdateIndex < updates.GetCount(); ++uiUpdateIndex)
+  {
+    const BoundsUpdate& update = updates[uiUpdateIndex];
+
+    Data* pData = nullptr;
+    EZ_VERIFY(m_DataTable.TryGetValue(update.m_hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+    // No need to update bounds for always visible data
+    if (IsAlwaysVisibleData(*pData))
+      continue;
+
+    const ezUInt32 uiDataIndex = update.m_hData.GetInternalID().m_InstanceIndex;
 
-        const ezUInt64 uiLastVisibleFrameIdxAndVisType = pOldCell->m_LastVisibleFrameIdxAndVisType[mapping.m_uiCellDataIndex];
+    ezUInt64 uiGridBitmask = pData->m_uiGridBitmask;
+    while (uiGridBitmask > 0)
+    {
+      const ezUInt32 uiGridIndex = ezMath::FirstBitLow(uiGridBitmask);
+      uiGridBitmask &= uiGridBitmask - 1;
+
+      const ezUInt32 uiCellIndex = m_Grids[uiGridIndex]->m_CellDataMappings[uiDataIndex].m_uiCellIndex;
+      m_GridBoundsUpdates[uiGridIndex].PushBack({uiCellIndex, uiUpdateIndex});
+    }
+  }
+
+  ezHybridArray<ezUInt32, MAX_NUM_GRIDS> gridsToUpdate;
+  for (ezUInt32 uiGridIndex = 0; uiGridIndex < m_GridBoundsUpdates.GetCount(); ++uiGridIndex)
+  {
+    if (!m_GridBoundsUpdates[uiGridIndex].IsEmpty())
+    {
+      gridsToUpdate.PushBack(uiGridIndex);
+    }
+  }
+
+  auto UpdateGrids = [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+  {
+    for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+    {
+      const ezUInt32 uiGridIndex = gridsToUpdate[i];
+      Grid& grid = *m_Grids[uiGridIndex];
 
-        ref_grid.RemoveSpatialData(hData);
+      // Process the updates cell by cell. Moving data to another cell changes the cell data indices of other entries,
+      // so the mapping is looked up again for every update.
+      auto& gridUpdates = m_GridBoundsUpdates[uiGridIndex];
+      gridUpdates.Sort();
 
-        ref_grid.AddSpatialData(bounds, tags, objectPointer, uiLastVisibleFrameIdxAndVisType, hData);
+      for (const GridBoundsUpdate& gridUpdate : gridUpdates)
+      {
+        const BoundsUpdate& update = updates[gridUpdate.m_uiUpdateIndex];
+        grid.UpdateSpatialDataBounds(update.m_hData, update.m_Bounds);
       }
 
-      return ezVisitorExecution::Continue;
-    });
+      gridUpdates.Clear();
+    }
+  };
+
+  if (gridsToUpdate.GetCount() > 1 && updates.GetCount() >= MIN_BATCH_SIZE_FOR_PARALLEL_UPDATE)
+  {
+    ezParallelForParams parallelForParams;
+    parallelForParams.m_uiBinSize = 1;
+
+    ezTaskSystem::ParallelForIndexed(0, gridsToUpdate.GetCount(), UpdateGrids, "UpdateSpatialDataBounds", ezTaskNesting::Never, parallelForParams);
+  }
+  else
+  {
+    UpdateGrids(0, gridsToUpdate.GetCount());
+  }
 }
 
 void ezSpatialSystem_RegularGrid::UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject)
@@ -841,69 +954,307 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBox(const ezBoundingBox& box, con
     &queryData, ezVisibilityState::Indirect);
 }
 
+void ezSpatialSystem_RegularGrid::FindObjectsAlongRay(const ezVec3& vStart, const ezVec3& vDirection, float fMaxDistance, const QueryParams& queryParams, RayQueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsAlongRay");
+
+  using ezInternal::QueryHelper;
+
+  QueryHelper::OrderedQueryData queryData;
+  queryData.m_RayData = ezInternal::SpatialSystemUtils::ComputeRayData(vStart, vDirection, fMaxDistance);
+
+  // Only the part of the ray that passes through regular cells needs to be walked, the overflow cell is visited by the first step anyways
+  float fStartDistance = 0.0f;
+  float fEndDistance = 0.0f;
+  {
+    const ezSimdBBox cellsBounds = GetCellsBoundsInMatchingGrids(queryParams.m_uiCategoryBitmask);
+    if (!cellsBounds.IsValid() || !ezInternal::SpatialSystemUtils::RayBoxIntersect(cellsBounds, queryData.m_RayData, fStartDistance, fEndDistance))
+    {
+      fStartDistance = 0.0f;
+      fEndDistance = 0.0f;
+    }
+  }
+
+  const ezSimdVec4f vSimdStart = ezSimdConversion::ToVec3(vStart);
+  const ezSimdVec4f vSimdDirection = ezSimdConversion::ToVec3(vDirection);
+  const float fStepSize = m_vCellSize.x() * 2.0f;
+
+  SortedQueryResults results;
+  Stats stats;
+
+  auto TestObjects = [&](const Cell& cell, bool bUseTagsFilter)
+  {
+    if (bUseTagsFilter)
+      QueryHelper::TestObjects<true, true>(cell, queryParams, queryData, results, stats);
+    else
+      QueryHelper::TestObjects<false, true>(cell, queryParams, queryData, results, stats);
+  };
+
+  float fSegmentStart = fStartDistance;
+  while (true)
+  {
+    const float fSegmentEnd = ezMath::Min(fSegmentStart + fStepSize, fEndDistance);
+
+    const ezSimdVec4f vSegmentStart = ezSimdVec4f::MulAdd(vSimdDirection, ezSimdFloat(fSegmentStart), vSimdStart);
+    const ezSimdVec4f vSegmentEnd = ezSimdVec4f::MulAdd(vSimdDirection, ezSimdFloat(fSegmentEnd), vSimdStart);
+    const ezSimdBBox segmentBox(vSegmentStart.CompMin(vSegmentEnd), vSegmentStart.CompMax(vSegmentEnd));
+
+    ForEachCellInBoxInMatchingGrids(segmentBox, queryParams,
+      &QueryHelper::GatherCellsCallback<false, true>,
+      &QueryHelper::GatherCellsCallback<true, true>,
+      &queryData, ezVisibilityState::Indirect);
+
+    // Every cell that the ray enters before the end of this segment is known now, so are all objects that are hit before it
+    QueryHelper::ProcessPendingCells(queryData, fSegmentEnd, TestObjects);
+
+    if (results.Emit(fSegmentEnd, callback) == ezVisitorExecution::Stop)
+      break;
+
+    if (fSegmentEnd >= fEndDistance)
+    {
+      // Objects in the overflow cell can be hit behind the last regular cell
+      results.Emit(fMaxDistance, callback);
+      break;
+    }
+
+    fSegmentStart = fSegmentEnd;
+  }
+
+  s_GridQueries.Add();
+  s_ObjectsTested.Add(stats.m_uiNumObjectsTested);
+  s_ObjectsPassed.Add(stats.m_uiNumObjectsPassed);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_RegularGrid::FindNearestObjects(const ezVec3& vPosition, ezUInt32 uiMaxObjects, float fMaxDistance, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const
+{
+  EZ_PROFILE_SCOPE("FindNearestObjects");
+
+  using ezInternal::QueryHelper;
+
+  out_objects.Clear();
+
+  if (uiMaxObjects == 0)
+    return;
+
+  QueryHelper::OrderedQueryData queryData;
+  queryData.m_vPosition = ezSimdConversion::ToVec3(vPosition);
+  queryData.m_fMaxDistance = fMaxDistance;
+
+  ezSimdBBox cellsBounds = GetCellsBoundsInMatchingGrids(queryParams.m_uiCategoryBitmask);
+  if (!cellsBounds.IsValid())
+  {
+    cellsBounds = ezSimdBBox::MakeFromCenterAndHalfExtents(queryData.m_vPosition, ezSimdVec4f::MakeZero());
+  }
+
+  SortedQueryResults results(uiMaxObjects);
+  Stats stats;
+
+  auto TestObjects = [&](const Cell& cell, bool bUseTagsFilter)
+  {
+    if (bUseTagsFilter)
+      QueryHelper::TestObjects<true, false>(cell, queryParams, queryData, results, stats);
+    else
+      QueryHelper::TestObjects<false, false>(cell, queryParams, queryData, results, stats);
+  };
+
+  // Grow the search box around the position until enough objects have been found that are closer than the box radius
+  float fRadius = m_vCellSize.x() * 0.5f;
+  while (true)
+  {
+    fRadius = ezMath::Min(fRadius, fMaxDistance);
+
+    const ezSimdBBox searchBox = ezSimdBBox::MakeFromCenterAndHalfExtents(queryData.m_vPosition, ezSimdVec4f(fRadius));
+    const ezSimdBBox clampedSearchBox(searchBox.m_Min.CompMax(cellsBounds.m_Min).CompMin(cellsBounds.m_Max), searchBox.m_Max.CompMin(cellsBounds.m_Max).CompMax(cellsBounds.m_Min));
+
+    ForEachCellInBoxInMatchingGrids(clampedSearchBox, queryParams,
+      &QueryHelper::GatherCellsCallback<false, false>,
+      &QueryHelper::GatherCellsCallback<true, false>,
+      &queryData, ezVisibilityState::Indirect);
+
+    const bool bLastStep = fRadius >= fMaxDistance || searchBox.Contains(cellsBounds);
+
+    // All objects within the radius are inside of cells that overlap the search box
+    QueryHelper::ProcessPendingCells(queryData, ezMath::Min(bLastStep ? fMaxDistance : fRadius, results.GetMaxDistance(fMaxDistance)), TestObjects);
+
+    if (bLastStep || (results.IsFull() && results.GetMaxDistance(fMaxDistance) <= fRadius))
+      break;
+
+    fRadius *= 2.0f;
+  }
+
+  results.GetObjects(out_objects);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+  }
+#endif
+}
+
 void ezSpatialSystem_RegularGrid::FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::IsOccludedFunc IsOccluded, ezVisibilityState visType) const
 {
   EZ_PROFILE_SCOPE("FindVisibleObjects");
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezStopwatch timer;
+
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+  }
 #endif
 
-  ezVec3 cornerPoints[8];
-  frustum.ComputeCornerPoints(cornerPoints).AssertSuccess();
+  const ezSimdBBox simdBox = ezInternal::SpatialSystemUtils::ComputeFrustumBoundingBox(frustum);
+
+  using CellFunc = ezVisitorExecution::Enum (*)(const Cell&, const QueryParams&, Stats&, void*, ezVisibilityState);
 
-  ezSimdVec4f simdCornerPoints[8];
-  for (ezUInt32 i = 0; i < 8; ++i)
+  struct GridEntry
   {
-    simdCornerPoints[i] = ezSimdConversion::ToVec3(cornerPoints[i]);
-  }
+    EZ_DECLARE_POD_TYPE();
 
-  const ezSimdBBox simdBox = ezSimdBBox::MakeFromPoints(simdCornerPoints, 8);
+    const Grid* m_pGrid;
+    CellFunc m_CellFunc;
+    bool m_bUseTagsFilter;
+    bool m_bIsCachedGrid;
+  };
 
-  ezInternal::QueryHelper::FrustumQueryData queryData;
+  struct CellEntry
   {
-    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
-    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
-    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
-    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
-    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
-    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
-    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
+    EZ_DECLARE_POD_TYPE();
 
-    ezSimdMat4f helperMat;
-    helperMat.SetRows(plane0, plane1, plane2, plane3);
+    const Cell* m_pCell;
+    ezUInt32 m_uiGridEntryIndex;
+  };
 
-    queryData.m_PlaneData.m_x0x1x2x3 = helperMat.m_col0;
-    queryData.m_PlaneData.m_y0y1y2y3 = helperMat.m_col1;
-    queryData.m_PlaneData.m_z0z1z2z3 = helperMat.m_col2;
-    queryData.m_PlaneData.m_w0w1w2w3 = helperMat.m_col3;
+  ezHybridArray<GridEntry, 4> grids;
+  ezDynamicArray<CellEntry> cells;
 
-    helperMat.SetRows(plane4, plane5, plane4, plane5);
+  // Gather all cells first, so the cell culling and the object tests can be distributed across the task system
+  {
+    EZ_PROFILE_SCOPE("Gather Cells");
 
-    queryData.m_PlaneData.m_x4x5x4x5 = helperMat.m_col0;
-    queryData.m_PlaneData.m_y4y5y4y5 = helperMat.m_col1;
-    queryData.m_PlaneData.m_z4z5z4z5 = helperMat.m_col2;
-    queryData.m_PlaneData.m_w4w5w4w5 = helperMat.m_col3;
+    ForEachMatchingGrid(queryParams,
+      [&](const Grid& grid, bool bUseTagsFilter, bool bIsCachedGrid)
+      {
+        CellFunc cellFunc;
+        if (IsOccluded.IsValid())
+        {
+          cellFunc = bUseTagsFilter ? &ezInternal::QueryHelper::FrustumQueryCallback<true, true> : &ezInternal::QueryHelper::FrustumQueryCallback<false, true>;
+        }
+        else
+        {
+          cellFunc = bUseTagsFilter ? &ezInternal::QueryHelper::FrustumQueryCallback<true, false> : &ezInternal::QueryHelper::FrustumQueryCallback<false, false>;
+        }
+
+        const ezUInt32 uiGridEntryIndex = grids.GetCount();
+        grids.PushBack({&grid, cellFunc, bUseTagsFilter, bIsCachedGrid});
 
+        grid.ForEachCellInBox(simdBox,
+          [&](const Cell& cell)
+          {
+            cells.PushBack({&cell, uiGridEntryIndex});
+            return ezVisitorExecution::Continue;
+          });
+      });
+  }
+
+  ezInternal::QueryHelper::FrustumQueryData queryData;
+  {
+    queryData.m_PlaneData = ezInternal::SpatialSystemUtils::ComputePlaneData(frustum);
     queryData.m_pOutObjects = &out_Objects;
     queryData.m_uiFrameCounter = m_uiFrameCounter;
 
     queryData.m_IsOccludedCB = IsOccluded;
   }
 
-  if (IsOccluded.IsValid())
+  auto ProcessCells = [&](ezUInt32 uiFirstCell, ezUInt32 uiEndCell, ezDynamicArray<const ezGameObject*>& out_visibleObjects, ezArrayPtr<Stats> gridStats)
   {
-    ForEachCellInBoxInMatchingGrids(simdBox, queryParams,
-      &ezInternal::QueryHelper::FrustumQueryCallback<false, true>,
-      &ezInternal::QueryHelper::FrustumQueryCallback<true, true>,
-      &queryData, visType);
+    ezInternal::QueryHelper::FrustumQueryData cellQueryData = queryData;
+    cellQueryData.m_pOutObjects = &out_visibleObjects;
+
+    for (ezUInt32 i = uiFirstCell; i < uiEndCell; ++i)
+    {
+      const CellEntry& cellEntry = cells[i];
+      const GridEntry& gridEntry = grids[cellEntry.m_uiGridEntryIndex];
+
+      gridEntry.m_CellFunc(*cellEntry.m_pCell, queryParams, gridStats[cellEntry.m_uiGridEntryIndex], &cellQueryData, visType);
+    }
+  };
+
+  const ezUInt32 uiNumCells = cells.GetCount();
+
+  ezParallelForParams parallelForParams;
+  parallelForParams.m_uiBinSize = ezMath::Max(cvar_SpatialQueriesParallelBinSize.GetValue(), 1);
+
+  ezUInt32 uiNumChunks = 1;
+  ezUInt64 uiNumCellsPerChunk = uiNumCells;
+  if (cvar_SpatialQueriesParallelBinSize.GetValue() > 0 && uiNumCells > parallelForParams.m_uiBinSize)
+  {
+    parallelForParams.DetermineThreading(uiNumCells, uiNumChunks, uiNumCellsPerChunk);
+  }
+
+  ezHybridArray<Stats, 4> gridStats;
+  gridStats.SetCount(grids.GetCount());
+
+  if (uiNumChunks <= 1)
+  {
+    ProcessCells(0, uiNumCells, out_Objects, gridStats);
   }
   else
   {
-    ForEachCellInBoxInMatchingGrids(simdBox, queryParams,
-      &ezInternal::QueryHelper::FrustumQueryCallback<false, false>,
-      &ezInternal::QueryHelper::FrustumQueryCallback<true, false>,
-      &queryData, visType);
+    // Every task writes into its own chunk, the chunks are appended in order afterwards so the result matches the serial one
+    struct Chunk
+    {
+      ezDynamicArray<const ezGameObject*> m_VisibleObjects;
+      ezHybridArray<Stats, 4> m_GridStats;
+    };
+
+    ezHybridArray<Chunk, 16> chunks;
+    chunks.SetCount(uiNumChunks);
+
+    for (auto& chunk : chunks)
+    {
+      chunk.m_GridStats.SetCount(grids.GetCount());
+    }
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiNumCells,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        const ezUInt32 uiChunkIndex = static_cast<ezUInt32>(uiStartIndex / uiNumCellsPerChunk);
+        EZ_ASSERT_DEBUG(uiChunkIndex < chunks.GetCount(), "Unexpected parallel for slicing");
+
+        Chunk& chunk = chunks[uiChunkIndex];
+        ProcessCells(uiStartIndex, uiEndIndex, chunk.m_VisibleObjects, chunk.m_GridStats);
+      },
+      "FindVisibleObjects", ezTaskNesting::Never, parallelForParams);
+
+    for (const auto& chunk : chunks)
+    {
+      out_Objects.PushBackRange(chunk.m_VisibleObjects);
+
+      for (ezUInt32 i = 0; i < grids.GetCount(); ++i)
+      {
+        gridStats[i].m_uiNumObjectsTested += chunk.m_GridStats[i].m_uiNumObjectsTested;
+        gridStats[i].m_uiNumObjectsPassed += chunk.m_GridStats[i].m_uiNumObjectsPassed;
+        gridStats[i].m_uiNumObjectsFiltered += chunk.m_GridStats[i].m_uiNumObjectsFiltered;
+      }
+    }
+  }
+
+  for (ezUInt32 i = 0; i < grids.GetCount(); ++i)
+  {
+    UpdateQueryStats(*grids[i].m_pGrid, queryParams, grids[i].m_bUseTagsFilter, grids[i].m_bIsCachedGrid, gridStats[i]);
   }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -1061,6 +1412,26 @@ EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::ForEachGrid(const Data& data,
   }
 }
 
+ezSimdBBox ezSpatialSystem_RegularGrid::GetCellsBoundsInMatchingGrids(ezUInt32 uiCategoryBitmask) const
+{
+  // Cached grids only contain a subset of the objects of their category, so looking at the category grids is enough
+  ezSimdBBox cellsBounds = ezSimdBBox::MakeInvalid();
+
+  while (uiCategoryBitmask > 0)
+  {
+    const ezUInt32 uiGridIndex = ezMath::FirstBitLow(uiCategoryBitmask);
+    uiCategoryBitmask &= uiCategoryBitmask - 1;
+
+    auto& pGrid = m_Grids[uiGridIndex];
+    if (pGrid != nullptr && pGrid->m_CellsBounds.IsValid())
+    {
+      cellsBounds.ExpandToInclude(pGrid->m_CellsBounds);
+    }
+  }
+
+  return cellsBounds;
+}
+
 void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBBox& box, const QueryParams& queryParams, CellCallback noFilterCallback, CellCallback filterByTagsCallback, void* pUserData, ezVisibilityState visType) const
 {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -1070,6 +1441,25 @@ void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBB
   }
 #endif
 
+  ForEachMatchingGrid(queryParams,
+    [&](const Grid& grid, bool bUseTagsFilter, bool bIsCachedGrid)
+    {
+      CellCallback cellCallback = bUseTagsFilter ? filterByTagsCallback : noFilterCallback;
+
+      Stats stats;
+      grid.ForEachCellInBox(box,
+        [&](const Cell& cell)
+        {
+          return cellCallback(cell, queryParams, stats, pUserData, visType);
+        });
+
+      UpdateQueryStats(grid, queryParams, bUseTagsFilter, bIsCachedGrid, stats);
+    });
+}
+
+template <typename Functor>
+void ezSpatialSystem_RegularGrid::ForEachMatchingGrid(const QueryParams& queryParams, Functor func) const
+{
   ezUInt32 uiGridBitmask = queryParams.m_uiCategoryBitmask;
 
   // search for cached grids that match the exact query params first
@@ -1086,27 +1476,11 @@ void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBB
 
     uiGridBitmask &= ~pGrid->m_Category.GetBitmask();
 
-    Stats stats;
-    pGrid->ForEachCellInBox(box,
-      [&](const Cell& cell)
-      {
-        return noFilterCallback(cell, queryParams, stats, pUserData, visType);
-      });
-
-    UpdateCacheCandidate(queryParams.m_pIncludeTags, queryParams.m_pExcludeTags, pGrid->m_Category, 0.0f);
-
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-    if (queryParams.m_pStats != nullptr)
-    {
-      queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
-      queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
-    }
-#endif
+    func(*pGrid, false, true);
   }
 
   // then search for the rest
-  const bool useTagsFilter = (queryParams.m_pIncludeTags && queryParams.m_pIncludeTags->IsEmpty() == false) || (queryParams.m_pExcludeTags && queryParams.m_pExcludeTags->IsEmpty() == false);
-  CellCallback cellCallback = useTagsFilter ? filterByTagsCallback : noFilterCallback;
+  const bool useTagsFilter = ezInternal::SpatialSystemUtils::UseTagsFilter(queryParams);
 
   while (uiGridBitmask > 0)
   {
@@ -1117,36 +1491,42 @@ void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBB
     if (pGrid == nullptr)
       continue;
 
-    Stats stats;
-    pGrid->ForEachCellInBox(box,
-      [&](const Cell& cell)
-      {
-        return cellCallback(cell, queryParams, stats, pUserData, visType);
-      });
+    func(*pGrid, useTagsFilter, false);
+  }
+}
 
-    if (pGrid->m_bCanBeCached && useTagsFilter)
-    {
-      const ezUInt32 totalNumObjectsAfterSpatialTest = stats.m_uiNumObjectsFiltered + stats.m_uiNumObjectsPassed;
-      const ezUInt32 cacheThreshold = ezUInt32(ezMath::Max(cvar_SpatialQueriesCachingThreshold.GetValue(), 1));
+void ezSpatialSystem_RegularGrid::UpdateQueryStats(const Grid& grid, const QueryParams& queryParams, bool bUseTagsFilter, bool bIsCachedGrid, const Stats& stats) const
+{
+  s_GridQueries.Add();
+  s_ObjectsTested.Add(stats.m_uiNumObjectsTested);
+  s_ObjectsPassed.Add(stats.m_uiNumObjectsPassed);
 
-      // 1.0 => all objects filtered, 0.0 => no object filtered by tags
-      const float filteredRatio = float(double(stats.m_uiNumObjectsFiltered) / totalNumObjectsAfterSpatialTest);
+  if (bIsCachedGrid)
+  {
+    UpdateCacheCandidate(queryParams.m_pIncludeTags, queryParams.m_pExcludeTags, grid.m_Category, 0.0f);
+  }
+  else if (grid.m_bCanBeCached && bUseTagsFilter)
+  {
+    const ezUInt32 totalNumObjectsAfterSpatialTest = stats.m_uiNumObjectsFiltered + stats.m_uiNumObjectsPassed;
+    const ezUInt32 cacheThreshold = ezUInt32(ezMath::Max(cvar_SpatialQueriesCachingThreshold.GetValue(), 1));
 
-      // Doesn't make sense to cache if there are only few objects in total or only few objects have been filtered
-      if (totalNumObjectsAfterSpatialTest > cacheThreshold && filteredRatio > 0.1f)
-      {
-        UpdateCacheCandidate(queryParams.m_pIncludeTags, queryParams.m_pExcludeTags, pGrid->m_Category, filteredRatio);
-      }
-    }
+    // 1.0 => all objects filtered, 0.0 => no object filtered by tags
+    const float filteredRatio = float(double(stats.m_uiNumObjectsFiltered) / totalNumObjectsAfterSpatialTest);
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-    if (queryParams.m_pStats != nullptr)
+    // Doesn't make sense to cache if there are only few objects in total or only few objects have been filtered
+    if (totalNumObjectsAfterSpatialTest > cacheThreshold && filteredRatio > 0.1f)
     {
-      queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
-      queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+      UpdateCacheCandidate(queryParams.m_pIncludeTags, queryParams.m_pExcludeTags, grid.m_Category, filteredRatio);
     }
-#endif
   }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+  }
+#endif
 }
 
 void ezSpatialSystem_RegularGrid::MigrateCachedGrid(ezUInt32 uiCandidateIndex)
@@ -7,7 +7,6 @@
 #include <Core/World/WorldModule.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
-#include <Foundation/Utilities/Stats.h>
 
 ezStaticArray<ezWorld*, ezWorld::GetMaxNumWorlds()> ezWorld::s_Worlds;
 
@@ -150,18 +149,62 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
 {
   CheckForWriteAccess();
 
+  ezGameObject* pParentObject = nullptr;
+  (void)TryGetObject(desc.m_hParent, pParentObject);
+
+  out_pObject = CreateObjectUnlinked(desc, pParentObject);
+  FinalizeCreatedObject(out_pObject);
+
+  return out_pObject->GetHandle();
+}
+
+void ezWorld::CreateObjects(ezArrayPtr<const ezGameObjectDesc> descs, ezArrayPtr<const ezUInt32> parentIndices, ezArrayPtr<ezGameObject*> out_objects)
+{
+  CheckForWriteAccess();
+
+  EZ_ASSERT_DEV(parentIndices.IsEmpty() || parentIndices.GetCount() == descs.GetCount(), "Invalid number of parent indices");
+  EZ_ASSERT_DEV(out_objects.GetCount() == descs.GetCount(), "Invalid size of the output array");
+
+  m_Data.m_Objects.Reserve(m_Data.m_Objects.GetCount() + descs.GetCount());
+
+  for (ezUInt32 i = 0; i < descs.GetCount(); ++i)
+  {
+    const ezUInt32 uiParentIndex = parentIndices.IsEmpty() ? ezInvalidIndex : parentIndices[i];
+
+    ezGameObject* pParentObject = nullptr;
+    if (uiParentIndex != ezInvalidIndex)
+    {
+      EZ_ASSERT_DEV(uiParentIndex < i, "Parents must be created before their children");
+      pParentObject = out_objects[uiParentIndex];
+    }
+    else
+    {
+      (void)TryGetObject(descs[i].m_hParent, pParentObject);
+    }
+
+    out_objects[i] = CreateObjectUnlinked(descs[i], pParentObject);
+  }
+
+  // parents always come first, so their global transform and their child count are up to date when their children are finalized
+  for (ezGameObject* pObject : out_objects)
+  {
+    FinalizeCreatedObject(pObject);
+  }
+}
+
+ezGameObject* ezWorld::CreateObjectUnlinked(const ezGameObjectDesc& desc, ezGameObject* pParentObject)
+{
   EZ_ASSERT_DEV(m_Data.m_Objects.GetCount() < GetMaxNumGameObjects(), "Max number of game objects reached: {}", GetMaxNumGameObjects());
 
-  ezGameObject* pParentObject = nullptr;
   ezGameObject::TransformationData* pParentData = nullptr;
   ezUInt32 uiParentIndex = 0;
   ezUInt64 uiHierarchyLevel = 0;
   bool bDynamic = desc.m_bDynamic;
 
-  if (TryGetObject(desc.m_hParent, pParentObject))
+  if (pParentObject != nullptr)
   {
     pParentData = pParentObject->m_pTransformationData;
-    uiParentIndex = desc.m_hParent.m_InternalId.m_InstanceIndex;
+    uiParentIndex = pParentObject->m_InternalId.m_InstanceIndex;
     uiHierarchyLevel = pParentObject->m_uiHierarchyLevel + 1; // if there is a parent hierarchy level is parent level + 1
     EZ_ASSERT_DEV(uiHierarchyLevel < GetMaxNumHierarchyLevels(), "Max hierarchy level reached: {}", GetMaxNumHierarchyLevels());
     bDynamic |= pParentObject->IsDynamic();
@@ -208,6 +251,16 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   pTransformationData->m_uiSpatialDataCategoryBitmask = 0;
   pTransformationData->m_uiStableRandomSeed = desc.m_uiStableRandomSeed;
 
+  // link the transformation data to the game object
+  pNewObject->m_pTransformationData = pTransformationData;
+
+  return pNewObject;
+}
+
+void ezWorld::FinalizeCreatedObject(ezGameObject* pObject)
+{
+  ezGameObject::TransformationData* pTransformationData = pObject->m_pTransformationData;
+
   // if seed is set to 0xFFFFFFFF, use the parent's seed to create a deterministic value for this object
   if (pTransformationData->m_uiStableRandomSeed == 0xFFFFFFFF && pTransformationData->m_pParentData != nullptr)
   {
@@ -228,16 +281,11 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
 
   pTransformationData->UpdateGlobalTransformNonRecursive(0);
 
-  // link the transformation data to the game object
-  pNewObject->m_pTransformationData = pTransformationData;
-
   // fix links
-  LinkToParent(pNewObject);
-
-  pNewObject->UpdateActiveState(pParentObject == nullptr ? true : pParentObject->IsActive());
+  LinkToParent(pObject);
 
-  out_pObject = pNewObject;
-  return ezGameObjectHandle(newId);
+  ezGameObject* pParentObject = pObject->GetParent();
+  pObject->UpdateActiveState(pParentObject == nullptr ? true : pParentObject->IsActive());
 }
 
 void ezWorld::DeleteObjectNow(const ezGameObjectHandle& hObject0, bool bAlsoDeleteEmptyParents /*= true*/)
@@ -446,13 +494,7 @@ void ezWorld::Update()
 
   EZ_LOG_BLOCK(m_Data.m_sName.GetData());
 
-  {
-    ezStringBuilder sStatName;
-    sStatName.SetFormat("World Update/{0}/Game Object Count", m_Data.m_sName);
-
-    ezStringBuilder sStatValue;
-    ezStats::SetStat(sStatName, GetObjectCount());
-  }
+  m_Data.m_pObjectCountMetric->Set(GetObjectCount());
 
   ++m_Data.m_uiUpdateCounter;
 
@@ -67,6 +67,13 @@ namespace ezInternal
     // insert dummy entry to save some checks
     m_Objects.Insert(nullptr);
 
+    {
+      ezStringBuilder sMetricName;
+      sMetricName.SetFormat("World Update/{0}/Game Object Count", m_sName);
+      m_sObjectCountMetricName = sMetricName;
+      m_pObjectCountMetric = EZ_NEW(&m_Allocator, ezMetricGauge, m_sObjectCountMetricName);
+    }
+
 #if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
     EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject::TransformationData) == 240);
 #else
@@ -311,12 +318,10 @@ namespace ezInternal
   {
     struct UserData
     {
-      ezSpatialSystem* m_pSpatialSystem;
       ezUInt32 m_uiUpdateCounter;
     };
 
     UserData userData;
-    userData.m_pSpatialSystem = m_pSpatialSystem.Borrow();
     userData.m_uiUpdateCounter = m_uiUpdateCounter;
 
     struct RootLevel
@@ -341,21 +346,17 @@ namespace ezInternal
 
     struct RootLevelWithSpatialData
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData0)
+      EZ_ALWAYS_INLINE static void Visit(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, BoundsUpdateArray& ref_boundsUpdates)
       {
-        auto pUserData = static_cast<UserData*>(pUserData0);
-        WorldData::UpdateGlobalTransformAndSpatialData(pData, pUserData->m_uiUpdateCounter, *pUserData->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        WorldData::UpdateGlobalTransformAndRecordBounds(pData, uiUpdateCounter, ref_boundsUpdates);
       }
     };
 
     struct WithParentWithSpatialData
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData0)
+      EZ_ALWAYS_INLINE static void Visit(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, BoundsUpdateArray& ref_boundsUpdates)
       {
-        auto pUserData = static_cast<UserData*>(pUserData0);
-        WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, pUserData->m_uiUpdateCounter, *pUserData->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        WorldData::UpdateGlobalTransformWithParentAndRecordBounds(pData, uiUpdateCounter, ref_boundsUpdates);
       }
     };
 
@@ -364,8 +365,6 @@ namespace ezInternal
     {
       auto dataPtr = hierarchy.m_Data.GetData();
 
-      // If we have no spatial system, we perform multi-threaded update as we do not
-      // have to acquire a write lock in the process.
       if (m_pSpatialSystem == nullptr)
       {
         TraverseHierarchyLevelMultiThreaded<RootLevel>(*dataPtr[0], &userData);
@@ -377,11 +376,29 @@ namespace ezInternal
       }
       else
       {
-        TraverseHierarchyLevel<RootLevelWithSpatialData>(*dataPtr[0], &userData);
+        // The spatial system is not thread-safe, so bounds changes are only recorded during the multi-threaded update
+        // and then applied in one batch, which also allows the spatial system to sort and distribute the updates.
+        TraverseHierarchyLevelMultiThreadedAndRecordBounds<RootLevelWithSpatialData>(*dataPtr[0], m_uiUpdateCounter);
 
         for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
         {
-          TraverseHierarchyLevel<WithParentWithSpatialData>(*dataPtr[i], &userData);
+          TraverseHierarchyLevelMultiThreadedAndRecordBounds<WithParentWithSpatialData>(*dataPtr[i], m_uiUpdateCounter);
+        }
+
+        if (!m_BoundsUpdates.IsEmpty())
+        {
+          BoundsUpdateArray& allBoundsUpdates = m_BoundsUpdates[0];
+          for (ezUInt32 i = 1; i < m_BoundsUpdates.GetCount(); ++i)
+          {
+            allBoundsUpdates.PushBackRange(m_BoundsUpdates[i]);
+            m_BoundsUpdates[i].Clear();
+          }
+
+          if (!allBoundsUpdates.IsEmpty())
+          {
+            m_pSpatialSystem->UpdateSpatialDataBounds(allBoundsUpdates);
+            allBoundsUpdates.Clear();
+          }
         }
       }
     }
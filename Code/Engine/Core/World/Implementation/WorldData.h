@@ -7,9 +7,11 @@
 #include <Foundation/Threading/DelegateTask.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Types/SharedPtr.h>
+#include <Foundation/Utilities/Metrics.h>
 
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Core/World/GameObject.h>
+#include <Core/World/SpatialSystem.h>
 #include <Core/World/WorldDesc.h>
 
 namespace ezInternal
@@ -129,6 +131,11 @@ namespace ezInternal
     template <typename VISITOR>
     ezVisitorExecution::Enum TraverseHierarchyLevelMultiThreaded(Hierarchy::DataBlockArray& blocks, void* pUserData = nullptr);
 
+    using BoundsUpdateArray = ezDynamicArray<ezSpatialSystem::BoundsUpdate, ezAlignedAllocatorWrapper>;
+
+    template <typename VISITOR>
+    void TraverseHierarchyLevelMultiThreadedAndRecordBounds(Hierarchy::DataBlockArray& blocks, ezUInt32 uiUpdateCounter);
+
     using VisitorFunc = ezDelegate<ezVisitorExecution::Enum(ezGameObject*)>;
     void TraverseBreadthFirst(VisitorFunc& func);
     void TraverseDepthFirst(VisitorFunc& func);
@@ -137,11 +144,14 @@ namespace ezInternal
     static void UpdateGlobalTransform(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter);
     static void UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter);
 
-    static void UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, ezSpatialSystem& spatialSystem);
-    static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, ezSpatialSystem& spatialSystem);
+    static void UpdateGlobalTransformAndRecordBounds(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, BoundsUpdateArray& ref_boundsUpdates);
+    static void UpdateGlobalTransformWithParentAndRecordBounds(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, BoundsUpdateArray& ref_boundsUpdates);
 
     void UpdateGlobalTransforms();
 
+    // Spatial data bounds changes recorded during the transform update, one array per task. They are applied to the spatial system in one batch.
+    ezDynamicArray<BoundsUpdateArray, ezLocalAllocatorWrapper> m_BoundsUpdates;
+
     void ResourceEventHandler(const ezResourceEvent& e);
 
     // game object lookups
@@ -241,6 +251,8 @@ namespace ezInternal
     mutable ezAtomicInteger32 m_iReadCounter;
 
     ezUInt32 m_uiUpdateCounter = 0;
+    ezString m_sObjectCountMetricName;
+    ezUniquePtr<ezMetricGauge> m_pObjectCountMetric;
     bool m_bSimulateWorld = true;
     bool m_bReportErrorWhenStaticObjectMoves = true;
 
@@ -60,6 +60,57 @@ namespace ezInternal
     return ezVisitorExecution::Continue;
   }
 
+  template <typename VISITOR>
+  void WorldData::TraverseHierarchyLevelMultiThreadedAndRecordBounds(Hierarchy::DataBlockArray& blocks, ezUInt32 uiUpdateCounter)
+  {
+    ezParallelForParams parallelForParams;
+    parallelForParams.m_uiBinSize = 100;
+    parallelForParams.m_uiMaxTasksPerThread = 2;
+    parallelForParams.m_pTaskAllocator = m_StackAllocator.GetCurrentAllocator();
+
+    const ezUInt32 uiNumBlocks = blocks.GetCount();
+    if (uiNumBlocks == 0)
+      return;
+
+    ezUInt32 uiNumTasks = 1;
+    ezUInt64 uiBlocksPerTask = uiNumBlocks;
+    if (uiNumBlocks > parallelForParams.m_uiBinSize)
+    {
+      parallelForParams.DetermineThreading(uiNumBlocks, uiNumTasks, uiBlocksPerTask);
+    }
+
+    if (m_BoundsUpdates.GetCount() < uiNumTasks)
+    {
+      m_BoundsUpdates.SetCount(uiNumTasks);
+    }
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiNumBlocks,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        // Every task writes into its own array, so no synchronization is needed
+        const ezUInt32 uiTaskIndex = static_cast<ezUInt32>(uiStartIndex / uiBlocksPerTask);
+        EZ_ASSERT_DEBUG(uiTaskIndex < uiNumTasks, "Unexpected parallel for slicing");
+
+        BoundsUpdateArray& boundsUpdates = m_BoundsUpdates[uiTaskIndex];
+
+        for (ezUInt32 uiBlockIndex = uiStartIndex; uiBlockIndex < uiEndIndex; ++uiBlockIndex)
+        {
+          WorldData::Hierarchy::DataBlock& block = blocks[uiBlockIndex];
+
+          ezGameObject::TransformationData* pCurrentData = block.m_pData;
+          ezGameObject::TransformationData* pEndData = block.m_pData + block.m_uiCount;
+
+          while (pCurrentData < pEndData)
+          {
+            VISITOR::Visit(pCurrentData, uiUpdateCounter, boundsUpdates);
+            ++pCurrentData;
+          }
+        }
+      },
+      "World DataBlock Traversal Task", ezTaskNesting::Never, parallelForParams);
+  }
+
   // static
   EZ_FORCE_INLINE void WorldData::UpdateGlobalTransform(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter)
   {
@@ -75,17 +126,25 @@ namespace ezInternal
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndRecordBounds(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, BoundsUpdateArray& ref_boundsUpdates)
   {
     pData->UpdateGlobalTransformWithoutParent(uiUpdateCounter);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+
+    if (pData->UpdateGlobalBoundsAndCheckSpatialData())
+    {
+      ref_boundsUpdates.PushBack({pData->m_globalBounds, pData->m_hSpatialData});
+    }
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndRecordBounds(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, BoundsUpdateArray& ref_boundsUpdates)
   {
     pData->UpdateGlobalTransformWithParent(uiUpdateCounter);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+
+    if (pData->UpdateGlobalBoundsAndCheckSpatialData())
+    {
+      ref_boundsUpdates.PushBack({pData->m_globalBounds, pData->m_hSpatialData});
+    }
   }
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -27,6 +27,21 @@ public:
   virtual void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) = 0;
   virtual void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) = 0;
 
+  struct BoundsUpdate
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezSimdBBoxSphere m_Bounds;
+    ezSpatialDataHandle m_hData;
+  };
+
+  /// \brief Updates the bounds of many spatial data objects at once.
+  ///
+  /// The world records all bounds changes during the transform update and passes them here in one batch.
+  /// The default implementation calls UpdateSpatialDataBounds for every entry, implementations can override this
+  /// to sort the updates by their location in the acceleration structure and to process independent parts in parallel.
+  virtual void UpdateSpatialDataBounds(ezArrayPtr<const BoundsUpdate> updates);
+
   ///@}
   /// \name Simple Queries
   ///@{
@@ -59,10 +74,33 @@ public:
   virtual void FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const;
   virtual void FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const = 0;
 
+  ///@}
+  /// \name Ordered Queries
+  ///@{
+
+  /// \brief Receives an object and the distance along the ray at which its bounding box is hit.
+  using RayQueryCallback = ezDelegate<ezVisitorExecution::Enum(ezGameObject*, float)>;
+
+  /// \brief Finds all objects whose bounding box is hit by the given ray and reports them ordered from front to back.
+  ///
+  /// vDirection has to be normalized. Objects that contain the start position are reported with a distance of zero.
+  /// The acceleration structure is only walked as far as needed, so returning ezVisitorExecution::Stop from the callback
+  /// after the first few hits makes the query cheap. Objects that are in multiple of the queried categories are only reported once.
+  /// Always visible objects don't have bounds and are never reported.
+  virtual void FindObjectsAlongRay(const ezVec3& vStart, const ezVec3& vDirection, float fMaxDistance, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const;
+  virtual void FindObjectsAlongRay(const ezVec3& vStart, const ezVec3& vDirection, float fMaxDistance, const QueryParams& queryParams, RayQueryCallback callback) const = 0;
+
+  /// \brief Finds up to uiMaxObjects objects that are closest to the given position, sorted by ascending distance.
+  ///
+  /// The distance is measured to the bounding box of an object, so it is zero for all objects that contain the position.
+  /// Objects that are in multiple of the queried categories are only reported once. Always visible objects are never reported.
+  virtual void FindNearestObjects(const ezVec3& vPosition, ezUInt32 uiMaxObjects, float fMaxDistance, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const = 0;
+
   ///@}
   /// \name Visibility Queries
   ///@{
 
+  /// \brief Returns true if the given box is occluded. Implementations may call this from multiple threads at the same time.
   using IsOccludedFunc = ezDelegate<bool(const ezSimdBBox&)>;
 
   virtual void FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_objects, IsOccludedFunc isOccluded, ezVisibilityState visType) const = 0;
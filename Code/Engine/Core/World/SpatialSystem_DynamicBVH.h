@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Containers/IdTable.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Types/UniquePtr.h>
+
+namespace ezInternal
+{
+  struct BVHQueryHelper;
+}
+
+/// \brief A spatial system that stores the spatial data of each category in a bounding volume hierarchy.
+///
+/// In contrast to ezSpatialSystem_RegularGrid, the hierarchy adapts to the size and the distribution of the objects,
+/// which makes it a better fit for worlds where object sizes range from centimeters to kilometers.
+///
+/// The trees are built with a binned surface area heuristic (SAH). Objects that move only refit the nodes above them,
+/// newly added objects are kept in a small unsorted list until the next build. Once a tree has degraded too much,
+/// a new one is built from a snapshot of the data, in the background for large trees, and swapped in at the start of a later frame.
+class EZ_CORE_DLL ezSpatialSystem_DynamicBVH : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_DynamicBVH, ezSpatialSystem);
+
+public:
+  ezSpatialSystem_DynamicBVH();
+  ~ezSpatialSystem_DynamicBVH();
+
+  /// \brief Waits for all running background builds, swaps the new trees in and synchronously rebuilds all trees that have unsorted objects.
+  ///
+  /// After this call all objects are in a freshly built tree. This is mostly useful after loading a level and for tests or benchmarks.
+  void RebuildAllTrees();
+
+  /// \brief Returns the bounding boxes of all tree nodes up to the given depth. Useful for debug visualizations.
+  void GetAllNodeBoxes(ezDynamicArray<ezBoundingBox>& out_boundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory, ezUInt32 uiMaxDepth = 8) const;
+
+private:
+  friend ezInternal::BVHQueryHelper;
+
+  // ezSpatialSystem implementation
+  virtual void StartNewFrame() override;
+
+  ezSpatialDataHandle CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+  ezSpatialDataHandle CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+
+  void DeleteSpatialData(const ezSpatialDataHandle& hData) override;
+
+  void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) override;
+  void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) override;
+
+  void FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const override;
+  void FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const override;
+
+  void FindObjectsAlongRay(const ezVec3& vStart, const ezVec3& vDirection, float fMaxDistance, const QueryParams& queryParams, RayQueryCallback callback) const override;
+  void FindNearestObjects(const ezVec3& vPosition, ezUInt32 uiMaxObjects, float fMaxDistance, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const override;
+
+  void FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::IsOccludedFunc IsOccluded, ezVisibilityState visType) const override;
+
+  ezVisibilityState GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const override;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  virtual void GetInternalStats(ezStringBuilder& sb) const override;
+#endif
+
+  ezProxyAllocator m_AlignedAllocator;
+
+  enum
+  {
+    MAX_NUM_TREES = 32 // one tree per category, matches the number of bits in the category bitmask
+  };
+
+  struct Node;
+  struct BuildData;
+  struct Tree;
+  ezDynamicArray<ezUniquePtr<Tree>> m_Trees;
+
+  struct Data
+  {
+    ezGameObject* m_pObject = nullptr;
+    ezTagSet m_Tags;
+    ezUInt32 m_uiCategoryBitmask = 0;
+    bool m_bAlwaysVisible = false;
+    mutable ezAtomicInteger64 m_LastVisibleFrameIdxAndVisType;
+  };
+
+  ezIdTable<ezSpatialDataId, Data, ezLocalAllocatorWrapper> m_DataTable;
+
+  ezSpatialDataHandle AddSpatialDataToTrees(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible);
+
+  template <typename Functor>
+  void ForEachTree(ezUInt32 uiCategoryBitmask, Functor func) const;
+
+  void StartBuild(Tree& ref_tree, bool bBackground);
+  void FinishBuild(Tree& ref_tree);
+};
@@ -36,11 +36,15 @@ private:
   void DeleteSpatialData(const ezSpatialDataHandle& hData) override;
 
   void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) override;
+  void UpdateSpatialDataBounds(ezArrayPtr<const BoundsUpdate> updates) override;
   void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) override;
 
   void FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const override;
   void FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const override;
 
+  void FindObjectsAlongRay(const ezVec3& vStart, const ezVec3& vDirection, float fMaxDistance, const QueryParams& queryParams, RayQueryCallback callback) const override;
+  void FindNearestObjects(const ezVec3& vPosition, ezUInt32 uiMaxObjects, float fMaxDistance, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_objects) const override;
+
   void FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::IsOccludedFunc IsOccluded, ezVisibilityState visType) const override;
 
   ezVisibilityState GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const override;
@@ -84,10 +88,34 @@ private:
   template <typename Functor>
   void ForEachGrid(const Data& data, const ezSpatialDataHandle& hData, Functor func) const;
 
+  struct GridBoundsUpdate
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiCellIndex;
+    ezUInt32 m_uiUpdateIndex;
+
+    bool operator<(const GridBoundsUpdate& other) const
+    {
+      if (m_uiCellIndex != other.m_uiCellIndex)
+        return m_uiCellIndex < other.m_uiCellIndex;
+
+      return m_uiUpdateIndex < other.m_uiUpdateIndex;
+    }
+  };
+
+  ezDynamicArray<ezDynamicArray<GridBoundsUpdate>> m_GridBoundsUpdates; ///< One array per grid, only used during batched bounds updates.
+
   struct Stats;
   using CellCallback = ezDelegate<ezVisitorExecution::Enum(const Cell&, const QueryParams&, Stats&, void*, ezVisibilityState)>;
+  ezSimdBBox GetCellsBoundsInMatchingGrids(ezUInt32 uiCategoryBitmask) const;
   void ForEachCellInBoxInMatchingGrids(const ezSimdBBox& box, const QueryParams& queryParams, CellCallback noFilterCallback, CellCallback filterByTagsCallback, void* pUserData, ezVisibilityState visType) const;
 
+  template <typename Functor>
+  void ForEachMatchingGrid(const QueryParams& queryParams, Functor func) const;
+
+  void UpdateQueryStats(const Grid& grid, const QueryParams& queryParams, bool bUseTagsFilter, bool bIsCachedGrid, const Stats& stats) const;
+
   struct CacheCandidate
   {
     ezTagSet m_IncludeTags;
@@ -43,6 +43,14 @@ public:
   /// \brief Create a new game object from the given description, writes a pointer to it to out_pObject and returns a handle to it.
   ezGameObjectHandle CreateObject(const ezGameObjectDesc& desc, ezGameObject*& out_pObject);
 
+  /// \brief Creates one game object for every entry in \a descs and writes pointers to them to \a out_objects, which must have the same size.
+  ///
+  /// All objects and their transformation data are created first, afterwards they are linked to their parents in a single pass.
+  /// \a parentIndices is either empty or has one entry per object. An entry that is smaller than the index of the object makes the object
+  /// at that index the parent, ezInvalidIndex means that ezGameObjectDesc::m_hParent is used instead.
+  /// This is used to instantiate large numbers of objects, e.g. from a baked world, where the parents are only known by index.
+  void CreateObjects(ezArrayPtr<const ezGameObjectDesc> descs, ezArrayPtr<const ezUInt32> parentIndices, ezArrayPtr<ezGameObject*> out_objects);
+
   /// \brief Deletes the given object, its children and all components.
   /// \note This function deletes the object immediately! It is unsafe to use this during a game update loop, as other objects
   /// may rely on this object staying valid for the rest of the frame.
@@ -385,6 +393,9 @@ private:
 
   void SetParent(ezGameObject* pObject, ezGameObject* pNewParent,
     ezGameObject::TransformPreservation preserve = ezGameObject::TransformPreservation::PreserveGlobal);
+  ezGameObject* CreateObjectUnlinked(const ezGameObjectDesc& desc, ezGameObject* pParentObject);
+  void FinalizeCreatedObject(ezGameObject* pObject);
+
   void LinkToParent(ezGameObject* pObject);
   void UnlinkFromParent(ezGameObject* pObject);
 
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Foundation/Math/Quat.h>
+#include <Foundation/Math/Vec3.h>
+
+/// \brief The binary layout of the flat world format that ezWorldWriter writes when SetFlatFormat(true) was called.
+///
+/// All data is stored in fixed-size records that are referenced through byte offsets relative to the start of the header,
+/// so that ezWorldReader can use the data directly from a memory mapped file, without parsing it into intermediate structures.
+/// Strings are stored once, zero terminated, and referenced by index. Index zero is always the empty string.
+/// Game objects are referenced by the same indices as in the stream format: zero is an invalid handle, root objects come first, then child objects.
+namespace ezFlatWorldFormat
+{
+  static constexpr ezUInt32 Magic = 0x57465A45; // 'EZFW'
+  static constexpr ezUInt32 Version = 1;
+
+  /// \brief When written to a stream, the flat data is preceded by this value instead of the regular world version, followed by the size of the flat data as ezUInt64.
+  static constexpr ezUInt8 StreamMarker = 0xF1;
+
+  /// \brief The alignment of the flat data and all sections in it.
+  static constexpr ezUInt32 Alignment = 16;
+
+  struct Header
+  {
+    ezUInt32 m_uiMagic = Magic;
+    ezUInt32 m_uiVersion = Version;
+    ezUInt64 m_uiTotalSize = 0;
+
+    ezUInt32 m_uiNumRootObjects = 0;
+    ezUInt32 m_uiNumChildObjects = 0;
+    ezUInt32 m_uiNumComponentTypes = 0;
+    ezUInt32 m_uiNumComponents = 0;
+    ezUInt32 m_uiNumStrings = 0;
+    ezUInt32 m_uiNumTagSets = 0;
+    ezUInt32 m_uiNumTagIndices = 0;
+    ezUInt32 m_uiComponentDataSize = 0;
+
+    ezUInt32 m_uiObjectsOffset = 0;        ///< Object[m_uiNumRootObjects + m_uiNumChildObjects]
+    ezUInt32 m_uiComponentTypesOffset = 0; ///< ComponentType[m_uiNumComponentTypes]
+    ezUInt32 m_uiComponentsOffset = 0;     ///< Component[m_uiNumComponents]
+    ezUInt32 m_uiTagSetsOffset = 0;        ///< TagSet[m_uiNumTagSets]
+    ezUInt32 m_uiTagIndicesOffset = 0;     ///< ezUInt32[m_uiNumTagIndices], string indices of the tags of all tag sets
+    ezUInt32 m_uiStringOffsetsOffset = 0;  ///< ezUInt32[m_uiNumStrings], offsets of the strings relative to m_uiStringDataOffset
+    ezUInt32 m_uiStringDataOffset = 0;
+    ezUInt32 m_uiComponentDataOffset = 0; ///< The data written by ezComponent::SerializeComponent() of all components, grouped by type
+  };
+
+  struct Object
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezVec3 m_vLocalPosition;
+    ezQuat m_qLocalRotation;
+    ezVec3 m_vLocalScaling;
+    float m_fLocalUniformScaling;
+    ezUInt32 m_uiParentIndex;
+    ezUInt32 m_uiNameString;
+    ezUInt32 m_uiGlobalKeyString;
+    ezUInt32 m_uiTagSet;
+    ezUInt32 m_uiStableRandomSeed;
+    ezUInt16 m_uiTeamID;
+    ezUInt8 m_uiFlags;
+    ezUInt8 m_uiPadding;
+
+    enum Flags : ezUInt8
+    {
+      Active = EZ_BIT(0),
+      Dynamic = EZ_BIT(1),
+    };
+  };
+
+  struct ComponentType
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiNameString;
+    ezUInt32 m_uiTypeVersion;
+    ezUInt32 m_uiFirstComponent;
+    ezUInt32 m_uiNumComponents;
+    ezUInt32 m_uiDataOffset; ///< Relative to Header::m_uiComponentDataOffset
+    ezUInt32 m_uiDataSize;
+  };
+
+  struct Component
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiOwnerIndex;
+    ezUInt8 m_uiActive;
+    ezUInt8 m_uiUserFlags;
+    ezUInt16 m_uiPadding;
+  };
+
+  struct TagSet
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiFirstTagIndex;
+    ezUInt32 m_uiNumTags;
+  };
+
+  EZ_CHECK_AT_COMPILETIME(sizeof(Header) == 80);
+  EZ_CHECK_AT_COMPILETIME(sizeof(Object) == 68);
+  EZ_CHECK_AT_COMPILETIME(sizeof(ComponentType) == 24);
+  EZ_CHECK_AT_COMPILETIME(sizeof(Component) == 8);
+  EZ_CHECK_AT_COMPILETIME(sizeof(TagSet) == 8);
+} // namespace ezFlatWorldFormat
@@ -1,10 +1,16 @@
 #include <Core/CorePCH.h>
 
+#include <Core/WorldSerializer/Implementation/FlatWorldFormat.h>
 #include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldSerializerAttributes.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/IO/StringDeduplicationContext.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/Progress.h>
 
+ezCVarBool cvar_WorldReaderParallelDeserialization("World.Reader.ParallelDeserialization", true, ezCVarFlags::Default, "Whether components with the ezThreadSafeDeserializationAttribute are deserialized on worker threads during instantiation");
+
 ezWorldReader::FindComponentTypeCallback ezWorldReader::s_FindComponentTypeCallback;
 
 ezWorldReader::ezWorldReader() = default;
@@ -17,6 +23,32 @@ ezResult ezWorldReader::ReadWorldDescription(ezStreamReader& inout_stream, bool
   m_uiVersion = 0;
   inout_stream >> m_uiVersion;
 
+  if (m_uiVersion == ezFlatWorldFormat::StreamMarker)
+  {
+    ezUInt8 padding[7];
+    inout_stream.ReadBytes(padding, sizeof(padding));
+
+    ezUInt64 uiFlatDataSize = 0;
+    inout_stream >> uiFlatDataSize;
+
+    if (uiFlatDataSize > ezMath::MaxValue<ezUInt32>())
+    {
+      ezLog::Error("Invalid flat world size ({} bytes).", uiFlatDataSize);
+      return EZ_FAILURE;
+    }
+
+    m_FlatDataCopy.SetCountUninitialized(static_cast<ezUInt32>(uiFlatDataSize));
+    if (inout_stream.ReadBytes(m_FlatDataCopy.GetData(), uiFlatDataSize) != uiFlatDataSize)
+    {
+      ezLog::Error("Flat world data is truncated.");
+      return EZ_FAILURE;
+    }
+
+    return ReadFlatData(m_FlatDataCopy, bWarningOnUknownSkip);
+  }
+
+  ClearFlatData();
+
   if (m_uiVersion < 8 || m_uiVersion > 10)
   {
     ezLog::Error("Invalid world version (got {}).", m_uiVersion);
@@ -77,6 +109,24 @@ ezResult ezWorldReader::ReadWorldDescription(ezStreamReader& inout_stream, bool
   return EZ_SUCCESS;
 }
 
+ezResult ezWorldReader::ReadFlatWorldDescription(ezArrayPtr<const ezUInt8> data, bool bWarningOnUknownSkip)
+{
+  // skip the marker, the padding and the size that ezWorldWriter writes in front of the flat data
+  if (data.GetCount() >= 16 && data[0] == ezFlatWorldFormat::StreamMarker)
+  {
+    data = data.GetSubArray(16);
+  }
+
+  if (!ezMemoryUtils::IsAligned(data.GetPtr(), EZ_ALIGNMENT_OF(ezFlatWorldFormat::Header)))
+  {
+    m_FlatDataCopy = data;
+    return ReadFlatData(m_FlatDataCopy, bWarningOnUknownSkip);
+  }
+
+  m_FlatDataCopy.Clear();
+  return ReadFlatData(data, bWarningOnUknownSkip);
+}
+
 ezUniquePtr<ezWorldReader::InstantiationContextBase> ezWorldReader::InstantiateWorld(ezWorld& ref_world, const ezUInt16* pOverrideTeamID, ezTime maxStepTime, ezProgress* pProgress)
 {
   ezPrefabInstantiationOptions options;
@@ -98,7 +148,8 @@ ezGameObjectHandle ezWorldReader::ReadGameObjectHandle()
   ezUInt32 idx = 0;
   *m_pStream >> idx;
 
-  return m_IndexToGameObjectHandle[idx];
+  const ezWorldReader& data = m_pSharedReader != nullptr ? *m_pSharedReader : *this;
+  return data.m_IndexToGameObjectHandle[idx];
 }
 
 void ezWorldReader::ReadComponentHandle(ezComponentHandle& out_hComponent)
@@ -111,9 +162,10 @@ void ezWorldReader::ReadComponentHandle(ezComponentHandle& out_hComponent)
 
   out_hComponent.Invalidate();
 
-  if (uiTypeIndex < m_ComponentTypes.GetCount())
+  const ezWorldReader& data = m_pSharedReader != nullptr ? *m_pSharedReader : *this;
+  if (uiTypeIndex < data.m_ComponentTypes.GetCount())
   {
-    auto& indexToHandle = m_ComponentTypes[uiTypeIndex].m_ComponentIndexToHandle;
+    auto& indexToHandle = data.m_ComponentTypes[uiTypeIndex].m_ComponentIndexToHandle;
     if (uiIndex < indexToHandle.GetCount())
     {
       out_hComponent = indexToHandle[uiIndex];
@@ -123,15 +175,18 @@ void ezWorldReader::ReadComponentHandle(ezComponentHandle& out_hComponent)
 
 ezUInt32 ezWorldReader::GetComponentTypeVersion(const ezRTTI* pRtti) const
 {
+  const ezWorldReader& data = m_pSharedReader != nullptr ? *m_pSharedReader : *this;
+
   ezUInt32 uiVersion = 0xFFFFFFFF;
-  m_ComponentTypeVersions.TryGetValue(pRtti, uiVersion);
+  data.m_ComponentTypeVersions.TryGetValue(pRtti, uiVersion);
 
   return uiVersion;
 }
 
 bool ezWorldReader::HasComponentOfType(const ezRTTI* pRtti) const
 {
-  return m_ComponentTypeVersions.Contains(pRtti);
+  const ezWorldReader& data = m_pSharedReader != nullptr ? *m_pSharedReader : *this;
+  return data.m_ComponentTypeVersions.Contains(pRtti);
 }
 
 void ezWorldReader::ClearAndCompact()
@@ -156,22 +211,39 @@ void ezWorldReader::ClearAndCompact()
 
   m_ComponentDataStream.Clear();
   m_ComponentDataStream.Compact();
+
+  ClearFlatData();
+
+  m_FlatDataCopy.Clear();
+  m_FlatDataCopy.Compact();
+
+  m_FlatStrings.Clear();
+  m_FlatStrings.Compact();
+
+  m_FlatTagSets.Clear();
+  m_FlatTagSets.Compact();
 }
 
 ezUInt64 ezWorldReader::GetHeapMemoryUsage() const
 {
   return m_IndexToGameObjectHandle.GetHeapMemoryUsage() + m_RootObjectsToCreate.GetHeapMemoryUsage() + m_ChildObjectsToCreate.GetHeapMemoryUsage() + m_ComponentTypes.GetHeapMemoryUsage() + m_ComponentTypeVersions.GetHeapMemoryUsage() + m_ComponentCreationStream.GetHeapMemoryUsage() +
-         m_ComponentDataStream.GetHeapMemoryUsage();
+         m_ComponentDataStream.GetHeapMemoryUsage() + m_FlatDataCopy.GetHeapMemoryUsage() + m_FlatStrings.GetHeapMemoryUsage() + m_FlatTagSets.GetHeapMemoryUsage();
 }
 
 ezUInt32 ezWorldReader::GetRootObjectCount() const
 {
+  if (IsFlatFormat())
+    return m_pFlatHeader->m_uiNumRootObjects;
+
   return m_RootObjectsToCreate.GetCount();
 }
 
 
 ezUInt32 ezWorldReader::GetChildObjectCount() const
 {
+  if (IsFlatFormat())
+    return m_pFlatHeader->m_uiNumChildObjects;
+
   return m_ChildObjectsToCreate.GetCount();
 }
 
@@ -226,24 +298,204 @@ void ezWorldReader::ReadComponentTypeInfo(ezUInt32 uiComponentTypeIdx)
   s >> sRttiName;
   s >> uiRttiVersion;
 
-  const ezRTTI* pRtti = nullptr;
+  const ezRTTI* pRtti = FindComponentType(sRttiName);
 
+  m_ComponentTypes[uiComponentTypeIdx].m_pRtti = pRtti;
+  m_ComponentTypes[uiComponentTypeIdx].m_bThreadSafeDeserialization = pRtti != nullptr && pRtti->GetAttributeByType<ezThreadSafeDeserializationAttribute>() != nullptr;
+  m_ComponentTypeVersions[pRtti] = uiRttiVersion;
+}
+
+// static
+const ezRTTI* ezWorldReader::FindComponentType(ezStringView sTypeName)
+{
   if (s_FindComponentTypeCallback.IsValid())
+    return s_FindComponentTypeCallback(sTypeName);
+
+  const ezRTTI* pRtti = ezRTTI::FindTypeByName(sTypeName);
+
+  if (pRtti == nullptr)
   {
-    pRtti = s_FindComponentTypeCallback(sRttiName);
+    ezLog::Error("Unknown component type '{0}'. Components of this type will be skipped.", sTypeName);
   }
-  else
+
+  return pRtti;
+}
+
+ezResult ezWorldReader::ReadFlatData(ezArrayPtr<const ezUInt8> data, bool bWarningOnUnknownSkip)
+{
+  using namespace ezFlatWorldFormat;
+
+  ClearFlatData();
+
+  m_pStream = nullptr;
+  m_pStringDedupReadContext = nullptr;
+  m_RootObjectsToCreate.Clear();
+  m_ChildObjectsToCreate.Clear();
+  m_ComponentTypes.Clear();
+  m_ComponentTypeVersions.Clear();
+  m_ComponentCreationStream.Clear();
+  m_ComponentDataStream.Clear();
+  m_uiTotalNumComponents = 0;
+
+  if (data.GetCount() < sizeof(Header))
+  {
+    ezLog::Error("Flat world data is too small.");
+    return EZ_FAILURE;
+  }
+
+  const Header& header = *reinterpret_cast<const Header*>(data.GetPtr());
+
+  if (header.m_uiMagic != Magic || header.m_uiVersion != Version)
+  {
+    ezLog::Error("Invalid flat world data (version {}).", header.m_uiVersion);
+    return EZ_FAILURE;
+  }
+
+  if (header.m_uiTotalSize > data.GetCount() || header.m_uiStringDataOffset > header.m_uiComponentDataOffset)
+  {
+    ezLog::Error("Flat world data is truncated.");
+    return EZ_FAILURE;
+  }
+
+  auto IsValidSection = [&](ezUInt32 uiOffset, ezUInt64 uiCount, ezUInt64 uiElementSize)
+  { return ezMemoryUtils::IsAligned(data.GetPtr() + uiOffset, EZ_ALIGNMENT_OF(ezUInt32)) && uiOffset + uiCount * uiElementSize <= header.m_uiTotalSize; };
+
+  const ezUInt64 uiNumObjects = ezUInt64(header.m_uiNumRootObjects) + header.m_uiNumChildObjects;
+
+  if (!IsValidSection(header.m_uiObjectsOffset, uiNumObjects, sizeof(Object)) ||
+      !IsValidSection(header.m_uiComponentTypesOffset, header.m_uiNumComponentTypes, sizeof(ComponentType)) ||
+      !IsValidSection(header.m_uiComponentsOffset, header.m_uiNumComponents, sizeof(Component)) ||
+      !IsValidSection(header.m_uiTagSetsOffset, header.m_uiNumTagSets, sizeof(TagSet)) ||
+      !IsValidSection(header.m_uiTagIndicesOffset, header.m_uiNumTagIndices, sizeof(ezUInt32)) ||
+      !IsValidSection(header.m_uiStringOffsetsOffset, header.m_uiNumStrings, sizeof(ezUInt32)) ||
+      !IsValidSection(header.m_uiComponentDataOffset, header.m_uiComponentDataSize, 1) ||
+      header.m_uiNumComponentTypes > ezMath::MaxValue<ezUInt16>() || header.m_uiNumStrings == 0 || header.m_uiNumTagSets == 0)
+  {
+    ezLog::Error("Invalid flat world data.");
+    return EZ_FAILURE;
+  }
+
+  // strings and tags are the only things that need to be looked up before instantiation
   {
-    pRtti = ezRTTI::FindTypeByName(sRttiName);
+    const ezUInt32* pStringOffsets = reinterpret_cast<const ezUInt32*>(data.GetPtr() + header.m_uiStringOffsetsOffset);
+    const char* pStringData = reinterpret_cast<const char*>(data.GetPtr() + header.m_uiStringDataOffset);
+    const ezUInt32 uiStringDataSize = header.m_uiComponentDataOffset - header.m_uiStringDataOffset;
 
-    if (pRtti == nullptr)
+    m_FlatStrings.SetCount(header.m_uiNumStrings);
+    for (ezUInt32 i = 0; i < header.m_uiNumStrings; ++i)
     {
-      ezLog::Error("Unknown component type '{0}'. Components of this type will be skipped.", sRttiName);
+      // the terminator has to be within the string data as well, otherwise we would read past the end of the mapped data
+      const char* pString = pStringData + pStringOffsets[i];
+      const char* pTerminator = pStringOffsets[i] < uiStringDataSize ? static_cast<const char*>(memchr(pString, 0, uiStringDataSize - pStringOffsets[i])) : nullptr;
+
+      if (pTerminator == nullptr)
+      {
+        ezLog::Error("Invalid flat world string table.");
+        return EZ_FAILURE;
+      }
+
+      m_FlatStrings[i].Assign(ezStringView(pString, pTerminator));
     }
   }
 
-  m_ComponentTypes[uiComponentTypeIdx].m_pRtti = pRtti;
-  m_ComponentTypeVersions[pRtti] = uiRttiVersion;
+  {
+    const TagSet* pTagSets = reinterpret_cast<const TagSet*>(data.GetPtr() + header.m_uiTagSetsOffset);
+    const ezUInt32* pTagIndices = reinterpret_cast<const ezUInt32*>(data.GetPtr() + header.m_uiTagIndicesOffset);
+
+    m_FlatTagSets.SetCount(header.m_uiNumTagSets);
+    for (ezUInt32 i = 0; i < header.m_uiNumTagSets; ++i)
+    {
+      const TagSet& tagSet = pTagSets[i];
+      if (ezUInt64(tagSet.m_uiFirstTagIndex) + tagSet.m_uiNumTags > header.m_uiNumTagIndices)
+      {
+        ezLog::Error("Invalid flat world tag table.");
+        return EZ_FAILURE;
+      }
+
+      for (ezUInt32 t = 0; t < tagSet.m_uiNumTags; ++t)
+      {
+        const ezUInt32 uiString = pTagIndices[tagSet.m_uiFirstTagIndex + t];
+        if (uiString < m_FlatStrings.GetCount())
+        {
+          m_FlatTagSets[i].Set(ezTagRegistry::GetGlobalRegistry().RegisterTag(m_FlatStrings[uiString]));
+        }
+      }
+    }
+  }
+
+  const ComponentType* pComponentTypes = reinterpret_cast<const ComponentType*>(data.GetPtr() + header.m_uiComponentTypesOffset);
+
+  m_ComponentTypes.SetCount(header.m_uiNumComponentTypes);
+  m_ComponentTypeVersions.Reserve(header.m_uiNumComponentTypes);
+  for (ezUInt32 i = 0; i < header.m_uiNumComponentTypes; ++i)
+  {
+    const ComponentType& type = pComponentTypes[i];
+
+    if (type.m_uiNameString >= m_FlatStrings.GetCount() || ezUInt64(type.m_uiFirstComponent) + type.m_uiNumComponents > header.m_uiNumComponents ||
+        ezUInt64(type.m_uiDataOffset) + type.m_uiDataSize > header.m_uiComponentDataSize)
+    {
+      ezLog::Error("Invalid flat world component type table.");
+      return EZ_FAILURE;
+    }
+
+    const ezRTTI* pRtti = FindComponentType(m_FlatStrings[type.m_uiNameString].GetView());
+
+    if (pRtti == nullptr && type.m_uiNumComponents > 0 && bWarningOnUnknownSkip)
+    {
+      ezLog::Warning("Skipping components of unknown type");
+    }
+
+    m_ComponentTypes[i].m_pRtti = pRtti;
+    m_ComponentTypes[i].m_uiNumComponents = type.m_uiNumComponents;
+    m_ComponentTypes[i].m_uiDataOffset = type.m_uiDataOffset;
+    m_ComponentTypes[i].m_bThreadSafeDeserialization = pRtti != nullptr && pRtti->GetAttributeByType<ezThreadSafeDeserializationAttribute>() != nullptr;
+    m_ComponentTypeVersions[pRtti] = type.m_uiTypeVersion;
+
+    if (pRtti != nullptr)
+    {
+      m_uiTotalNumComponents += type.m_uiNumComponents;
+    }
+  }
+
+  m_IndexToGameObjectHandle.Reserve(static_cast<ezUInt32>(uiNumObjects) + 1);
+
+  m_pFlatHeader = &header;
+  m_pFlatObjects = reinterpret_cast<const Object*>(data.GetPtr() + header.m_uiObjectsOffset);
+  m_pFlatComponentTypes = pComponentTypes;
+  m_pFlatComponents = reinterpret_cast<const Component*>(data.GetPtr() + header.m_uiComponentsOffset);
+  m_pFlatComponentData = data.GetPtr() + header.m_uiComponentDataOffset;
+
+  return EZ_SUCCESS;
+}
+
+void ezWorldReader::ClearFlatData()
+{
+  m_pFlatHeader = nullptr;
+  m_pFlatObjects = nullptr;
+  m_pFlatComponentTypes = nullptr;
+  m_pFlatComponents = nullptr;
+  m_pFlatComponentData = nullptr;
+}
+
+void ezWorldReader::GetFlatObjectDesc(ezUInt32 uiObjectIndex, ezGameObjectDesc& out_desc, ezStringView& out_sGlobalKey) const
+{
+  const ezFlatWorldFormat::Object& obj = m_pFlatObjects[uiObjectIndex];
+
+  out_desc.m_LocalPosition = obj.m_vLocalPosition;
+  out_desc.m_LocalRotation = obj.m_qLocalRotation;
+  out_desc.m_LocalScaling = obj.m_vLocalScaling;
+  out_desc.m_LocalUniformScaling = obj.m_fLocalUniformScaling;
+  out_desc.m_bActiveFlag = (obj.m_uiFlags & ezFlatWorldFormat::Object::Active) != 0;
+  out_desc.m_bDynamic = (obj.m_uiFlags & ezFlatWorldFormat::Object::Dynamic) != 0;
+  out_desc.m_uiTeamID = obj.m_uiTeamID;
+  out_desc.m_uiStableRandomSeed = obj.m_uiStableRandomSeed;
+  out_desc.m_hParent = obj.m_uiParentIndex < m_IndexToGameObjectHandle.GetCount() ? m_IndexToGameObjectHandle[obj.m_uiParentIndex] : ezGameObjectHandle();
+
+  // index zero is the empty string and the empty tag set
+  out_desc.m_sName = m_FlatStrings[obj.m_uiNameString < m_FlatStrings.GetCount() ? obj.m_uiNameString : 0];
+  out_desc.m_Tags = m_FlatTagSets[obj.m_uiTagSet < m_FlatTagSets.GetCount() ? obj.m_uiTagSet : 0];
+
+  out_sGlobalKey = obj.m_uiGlobalKeyString < m_FlatStrings.GetCount() ? m_FlatStrings[obj.m_uiGlobalKeyString].GetView() : ezStringView();
 }
 
 void ezWorldReader::ReadComponentDataToMemStream(bool warningOnUnknownSkip)
@@ -274,6 +526,10 @@ void ezWorldReader::ReadComponentDataToMemStream(bool warningOnUnknownSkip)
 
           m_uiTotalNumComponents += compTypeInfo.m_uiNumComponents;
         }
+        else
+        {
+          compTypeInfo.m_uiDataOffset = ref_writer.GetWritePosition();
+        }
 
         while (uiAllComponentsSize > 0)
         {
@@ -298,6 +554,23 @@ void ezWorldReader::ReadComponentDataToMemStream(bool warningOnUnknownSkip)
   }
 }
 
+void ezWorldReader::ComponentDataReader::Begin(const ezWorldReader& worldReader, ezUInt32 uiComponentTypeIdx)
+{
+  const ComponentTypeInfo& compTypeInfo = worldReader.m_ComponentTypes[uiComponentTypeIdx];
+
+  if (worldReader.IsFlatFormat())
+  {
+    m_FlatReader.Reset(worldReader.m_pFlatComponentData + compTypeInfo.m_uiDataOffset, worldReader.m_pFlatComponentTypes[uiComponentTypeIdx].m_uiDataSize);
+    m_pStream = &m_FlatReader;
+  }
+  else
+  {
+    m_StreamReader.SetStorage(&worldReader.m_ComponentDataStream);
+    m_StreamReader.SetReadPosition(compTypeInfo.m_uiDataOffset);
+    m_pStream = &m_StreamReader;
+  }
+}
+
 void ezWorldReader::ClearHandles()
 {
   m_IndexToGameObjectHandle.Clear();
@@ -350,8 +623,8 @@ ezWorldReader::InstantiationContext::InstantiationContext(ezWorldReader& ref_wor
   if (options.m_pProgress != nullptr)
   {
     m_pOverallProgressRange = EZ_DEFAULT_NEW(ezProgressRange, "Instantiate", Phase::Count, false, options.m_pProgress);
-    m_pOverallProgressRange->SetStepWeighting(Phase::CreateRootObjects, m_WorldReader.m_RootObjectsToCreate.GetCount() / 100.0f);
-    m_pOverallProgressRange->SetStepWeighting(Phase::CreateChildObjects, m_WorldReader.m_ChildObjectsToCreate.GetCount() / 100.0f);
+    m_pOverallProgressRange->SetStepWeighting(Phase::CreateRootObjects, m_WorldReader.GetRootObjectCount() / 100.0f);
+    m_pOverallProgressRange->SetStepWeighting(Phase::CreateChildObjects, m_WorldReader.GetChildObjectCount() / 100.0f);
     m_pOverallProgressRange->SetStepWeighting(Phase::CreateComponents, m_WorldReader.m_uiTotalNumComponents / 100.0f);
     m_pOverallProgressRange->SetStepWeighting(Phase::DeserializeComponents, m_WorldReader.m_uiTotalNumComponents / 100.0f);
     // Ten times more weight since init components takes way longer than the rest
@@ -386,7 +659,24 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
     {
       EZ_ASSERT_DEBUG(!m_Options.m_hParent.IsInvalidated(), "Parent must be provided when m_ReplaceNamedRootWithParent is specified.");
 
-      if (m_WorldReader.m_RootObjectsToCreate.GetCount() == 1 && m_WorldReader.m_RootObjectsToCreate[0].m_Desc.m_sName == m_Options.m_ReplaceNamedRootWithParent)
+      const ezGameObjectDesc* pRootDesc = nullptr;
+      ezGameObjectDesc flatRootDesc;
+
+      if (m_WorldReader.GetRootObjectCount() == 1)
+      {
+        if (m_WorldReader.IsFlatFormat())
+        {
+          ezStringView sGlobalKey;
+          m_WorldReader.GetFlatObjectDesc(0, flatRootDesc, sGlobalKey);
+          pRootDesc = &flatRootDesc;
+        }
+        else
+        {
+          pRootDesc = &m_WorldReader.m_RootObjectsToCreate[0].m_Desc;
+        }
+      }
+
+      if (pRootDesc != nullptr && pRootDesc->m_sName == m_Options.m_ReplaceNamedRootWithParent)
       {
         m_uiCurrentIndex = 1;
         m_WorldReader.m_IndexToGameObjectHandle.PushBack(m_Options.m_hParent);
@@ -399,7 +689,7 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
             m_Options.m_pCreatedRootObjectsOut->PushBack(pParent);
           }
 
-          if (m_WorldReader.m_RootObjectsToCreate[0].m_Desc.m_bDynamic)
+          if (pRootDesc->m_bDynamic)
           {
             pParent->MakeDynamic();
           }
@@ -407,7 +697,22 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
       }
     }
 
-    if (m_bUseTransform)
+    if (m_WorldReader.IsFlatFormat())
+    {
+      const ezUInt32 uiNumRootObjects = m_WorldReader.GetRootObjectCount();
+
+      if (m_bUseTransform)
+      {
+        if (!CreateFlatGameObjects<true>(0, uiNumRootObjects, m_Options.m_hParent, m_Options.m_pCreatedRootObjectsOut, endTime))
+          return StepResult::Continue;
+      }
+      else
+      {
+        if (!CreateFlatGameObjects<false>(0, uiNumRootObjects, m_Options.m_hParent, m_Options.m_pCreatedRootObjectsOut, endTime))
+          return StepResult::Continue;
+      }
+    }
+    else if (m_bUseTransform)
     {
       if (!CreateGameObjects<true>(m_WorldReader.m_RootObjectsToCreate, m_Options.m_hParent, m_Options.m_pCreatedRootObjectsOut, endTime))
         return StepResult::Continue;
@@ -424,7 +729,12 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
 
   if (m_Phase == Phase::CreateChildObjects)
   {
-    if (!CreateGameObjects<false>(m_WorldReader.m_ChildObjectsToCreate, ezGameObjectHandle(), m_Options.m_pCreatedChildObjectsOut, endTime))
+    if (m_WorldReader.IsFlatFormat())
+    {
+      if (!CreateFlatGameObjects<false>(m_WorldReader.GetRootObjectCount(), m_WorldReader.GetChildObjectCount(), ezGameObjectHandle(), m_Options.m_pCreatedChildObjectsOut, endTime))
+        return StepResult::Continue;
+    }
+    else if (!CreateGameObjects<false>(m_WorldReader.m_ChildObjectsToCreate, ezGameObjectHandle(), m_Options.m_pCreatedChildObjectsOut, endTime))
       return StepResult::Continue;
 
     m_CurrentReader.SetStorage(&m_WorldReader.m_ComponentCreationStream);
@@ -434,7 +744,12 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
 
   if (m_Phase == Phase::CreateComponents)
   {
-    if (m_WorldReader.m_ComponentCreationStream.GetStorageSize64() > 0)
+    if (m_WorldReader.IsFlatFormat())
+    {
+      if (!CreateFlatComponents(endTime))
+        return StepResult::Continue;
+    }
+    else if (m_WorldReader.m_ComponentCreationStream.GetStorageSize64() > 0)
     {
       m_WorldReader.m_pStringDedupReadContext->SetActive(true);
 
@@ -447,27 +762,30 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
         return StepResult::Continue;
     }
 
-    m_CurrentReader.SetStorage(&m_WorldReader.m_ComponentDataStream);
+    m_CurrentReader.SetStorage(nullptr);
+    CreateDeserializationTasks();
     m_Phase = Phase::DeserializeComponents;
     BeginNextProgressStep("DeserializeComponents");
   }
 
   if (m_Phase == Phase::DeserializeComponents)
   {
-    if (m_WorldReader.m_ComponentDataStream.GetStorageSize64() > 0)
+    if (m_WorldReader.IsFlatFormat())
+    {
+      // the flat format doesn't use string deduplication
+      if (!DeserializeComponents(endTime))
+        return StepResult::Continue;
+    }
+    else if (m_WorldReader.m_ComponentDataStream.GetStorageSize64() > 0)
     {
       m_WorldReader.m_pStringDedupReadContext->SetActive(true);
 
-      ezStreamReader* pPrevReader = m_WorldReader.m_pStream;
-      m_WorldReader.m_pStream = &m_CurrentReader;
-
-      EZ_SCOPE_EXIT(m_WorldReader.m_pStream = pPrevReader; m_WorldReader.m_pStringDedupReadContext->SetActive(false););
+      EZ_SCOPE_EXIT(m_WorldReader.m_pStringDedupReadContext->SetActive(false););
 
       if (!DeserializeComponents(endTime))
         return StepResult::Continue;
     }
 
-    m_CurrentReader.SetStorage(nullptr);
     m_Phase = Phase::AddComponentsToBatch;
     BeginNextProgressStep("AddComponentsToBatch");
   }
@@ -525,69 +843,108 @@ bool ezWorldReader::InstantiationContext::CreateGameObjects(const ezDynamicArray
 {
   EZ_PROFILE_SCOPE("ezWorldReader::CreateGameObjects");
 
+  if (m_uiCurrentIndex == 0 && out_pCreatedObjects)
+  {
+    out_pCreatedObjects->Reserve(out_pCreatedObjects->GetCount() + objects.GetCount());
+  }
+
   while (m_uiCurrentIndex < objects.GetCount())
   {
     auto& godesc = objects[m_uiCurrentIndex];
 
     ezGameObjectDesc desc = godesc.m_Desc; // make a copy
     desc.m_hParent = hParent.IsInvalidated() ? m_WorldReader.m_IndexToGameObjectHandle[godesc.m_uiParentHandleIdx] : hParent;
-    desc.m_bDynamic |= m_Options.m_bForceDynamic;
 
-    switch (m_Options.m_RandomSeedMode)
+    FinalizeGameObjectDesc<UseTransform>(desc);
+    CreateGameObject(desc, godesc.m_sGlobalKey, out_pCreatedObjects);
+
+    ++m_uiCurrentIndex;
+
+    // exit here to ensure that we at least did some work
+    if (ezTime::Now() >= endTime)
     {
-      case ezPrefabInstantiationOptions::RandomSeedMode::DeterministicFromParent:
-        desc.m_uiStableRandomSeed = 0xFFFFFFFF; // ezWorld::CreateObject() will either derive a deterministic value from the parent object, or assign a random value, if no parent exists
-        break;
+      SetSubProgressCompletion(static_cast<double>(m_uiCurrentIndex) / objects.GetCount());
+      return false;
+    }
+  }
 
-      case ezPrefabInstantiationOptions::RandomSeedMode::CompletelyRandom:
-        desc.m_uiStableRandomSeed = 0; // ezWorld::CreateObject() will assign a random value to this object
-        break;
+  m_uiCurrentIndex = 0;
 
-      case ezPrefabInstantiationOptions::RandomSeedMode::FixedFromSerialization:
-        // keep deserialized value
-        break;
+  return true;
+}
 
-      case ezPrefabInstantiationOptions::RandomSeedMode::CustomRootValue:
-        // we use the given seed root value to assign a deterministic (but different) value to each game object
-        desc.m_uiStableRandomSeed = NextStableRandomSeed(m_Options.m_uiCustomRandomSeedRootValue);
-        break;
-    }
+template <bool UseTransform>
+bool ezWorldReader::InstantiationContext::CreateFlatGameObjects(ezUInt32 uiFirstObject, ezUInt32 uiNumObjects, ezGameObjectHandle hParent, ezDynamicArray<ezGameObject*>* out_pCreatedObjects, ezTime endTime)
+{
+  EZ_PROFILE_SCOPE("ezWorldReader::CreateFlatGameObjects");
 
-    if (m_Options.m_pOverrideTeamID != nullptr)
-    {
-      desc.m_uiTeamID = *m_Options.m_pOverrideTeamID;
-    }
+  // small enough to not overshoot the step time by much, large enough to make the per batch overhead negligible
+  constexpr ezUInt32 uiBatchSize = 256;
+
+  if (m_uiCurrentIndex == 0 && out_pCreatedObjects)
+  {
+    out_pCreatedObjects->Reserve(out_pCreatedObjects->GetCount() + uiNumObjects);
+  }
+
+  auto& indexToGameObjectHandle = m_WorldReader.m_IndexToGameObjectHandle;
+
+  while (m_uiCurrentIndex < uiNumObjects)
+  {
+    const ezUInt32 uiBatchCount = ezMath::Min(uiBatchSize, uiNumObjects - m_uiCurrentIndex);
+
+    // object N has the handle index N + 1, index zero is the invalid handle
+    const ezUInt32 uiFirstHandleIndex = indexToGameObjectHandle.GetCount();
 
-    if (UseTransform)
+    m_FlatObjectDescs.SetCount(uiBatchCount);
+    m_FlatParentIndices.SetCountUninitialized(uiBatchCount);
+    m_FlatGlobalKeys.SetCount(uiBatchCount);
+    m_FlatCreatedObjects.SetCountUninitialized(uiBatchCount);
+
+    for (ezUInt32 i = 0; i < uiBatchCount; ++i)
     {
-      ezTransform tChild(desc.m_LocalPosition, desc.m_LocalRotation, desc.m_LocalScaling);
-      ezTransform tFinal;
-      tFinal = ezTransform::MakeGlobalTransform(m_RootTransform, tChild);
+      ezGameObjectDesc& desc = m_FlatObjectDescs[i];
+      m_WorldReader.GetFlatObjectDesc(uiFirstObject + m_uiCurrentIndex + i, desc, m_FlatGlobalKeys[i]);
+
+      const ezUInt32 uiParentHandleIndex = m_WorldReader.m_pFlatObjects[uiFirstObject + m_uiCurrentIndex + i].m_uiParentIndex;
+      m_FlatParentIndices[i] = ezInvalidIndex;
+
+      if (!hParent.IsInvalidated())
+      {
+        desc.m_hParent = hParent;
+      }
+      else if (uiParentHandleIndex >= uiFirstHandleIndex && uiParentHandleIndex - uiFirstHandleIndex < i)
+      {
+        // the parent is part of this batch and doesn't have a handle yet
+        m_FlatParentIndices[i] = uiParentHandleIndex - uiFirstHandleIndex;
+      }
 
-      desc.m_LocalPosition = tFinal.m_vPosition;
-      desc.m_LocalRotation = tFinal.m_qRotation;
-      desc.m_LocalScaling = tFinal.m_vScale;
+      FinalizeGameObjectDesc<UseTransform>(desc);
     }
 
-    ezGameObject* pObject = nullptr;
-    m_WorldReader.m_IndexToGameObjectHandle.PushBack(m_WorldReader.m_pWorld->CreateObject(desc, pObject));
+    m_WorldReader.m_pWorld->CreateObjects(m_FlatObjectDescs, m_FlatParentIndices, m_FlatCreatedObjects);
 
-    if (!godesc.m_sGlobalKey.IsEmpty())
+    for (ezUInt32 i = 0; i < uiBatchCount; ++i)
     {
-      pObject->SetGlobalKey(godesc.m_sGlobalKey);
+      ezGameObject* pObject = m_FlatCreatedObjects[i];
+      indexToGameObjectHandle.PushBack(pObject->GetHandle());
+
+      if (!m_FlatGlobalKeys[i].IsEmpty())
+      {
+        pObject->SetGlobalKey(m_FlatGlobalKeys[i]);
+      }
     }
 
     if (out_pCreatedObjects)
     {
-      out_pCreatedObjects->PushBack(pObject);
+      out_pCreatedObjects->PushBackRange(m_FlatCreatedObjects);
     }
 
-    ++m_uiCurrentIndex;
+    m_uiCurrentIndex += uiBatchCount;
 
     // exit here to ensure that we at least did some work
     if (ezTime::Now() >= endTime)
     {
-      SetSubProgressCompletion(static_cast<double>(m_uiCurrentIndex) / objects.GetCount());
+      SetSubProgressCompletion(static_cast<double>(m_uiCurrentIndex) / uiNumObjects);
       return false;
     }
   }
@@ -597,6 +954,64 @@ bool ezWorldReader::InstantiationContext::CreateGameObjects(const ezDynamicArray
   return true;
 }
 
+template <bool UseTransform>
+void ezWorldReader::InstantiationContext::FinalizeGameObjectDesc(ezGameObjectDesc& ref_desc)
+{
+  ref_desc.m_bDynamic |= m_Options.m_bForceDynamic;
+
+  switch (m_Options.m_RandomSeedMode)
+  {
+    case ezPrefabInstantiationOptions::RandomSeedMode::DeterministicFromParent:
+      ref_desc.m_uiStableRandomSeed = 0xFFFFFFFF; // ezWorld::CreateObject() will either derive a deterministic value from the parent object, or assign a random value, if no parent exists
+      break;
+
+    case ezPrefabInstantiationOptions::RandomSeedMode::CompletelyRandom:
+      ref_desc.m_uiStableRandomSeed = 0; // ezWorld::CreateObject() will assign a random value to this object
+      break;
+
+    case ezPrefabInstantiationOptions::RandomSeedMode::FixedFromSerialization:
+      // keep deserialized value
+      break;
+
+    case ezPrefabInstantiationOptions::RandomSeedMode::CustomRootValue:
+      // we use the given seed root value to assign a deterministic (but different) value to each game object
+      ref_desc.m_uiStableRandomSeed = NextStableRandomSeed(m_Options.m_uiCustomRandomSeedRootValue);
+      break;
+  }
+
+  if (m_Options.m_pOverrideTeamID != nullptr)
+  {
+    ref_desc.m_uiTeamID = *m_Options.m_pOverrideTeamID;
+  }
+
+  if (UseTransform)
+  {
+    ezTransform tChild(ref_desc.m_LocalPosition, ref_desc.m_LocalRotation, ref_desc.m_LocalScaling);
+    ezTransform tFinal;
+    tFinal = ezTransform::MakeGlobalTransform(m_RootTransform, tChild);
+
+    ref_desc.m_LocalPosition = tFinal.m_vPosition;
+    ref_desc.m_LocalRotation = tFinal.m_qRotation;
+    ref_desc.m_LocalScaling = tFinal.m_vScale;
+  }
+}
+
+void ezWorldReader::InstantiationContext::CreateGameObject(const ezGameObjectDesc& desc, ezStringView sGlobalKey, ezDynamicArray<ezGameObject*>* out_pCreatedObjects)
+{
+  ezGameObject* pObject = nullptr;
+  m_WorldReader.m_IndexToGameObjectHandle.PushBack(m_WorldReader.m_pWorld->CreateObject(desc, pObject));
+
+  if (!sGlobalKey.IsEmpty())
+  {
+    pObject->SetGlobalKey(sGlobalKey);
+  }
+
+  if (out_pCreatedObjects)
+  {
+    out_pCreatedObjects->PushBack(pObject);
+  }
+}
+
 bool ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
 {
   EZ_PROFILE_SCOPE("ezWorldReader::CreateComponents");
@@ -627,24 +1042,60 @@ bool ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
       ezUInt8 userFlags = 0;
       s >> userFlags;
 
-      ezGameObject* pOwnerObject = nullptr;
-      if (!m_WorldReader.m_pWorld->TryGetObject(hOwner, pOwnerObject))
+      EZ_ASSERT_DEBUG(uiComponentIdx == compTypeInfo.m_ComponentIndexToHandle.GetCount(), "Component index doesn't match");
+      CreateComponent(pManager, compTypeInfo, hOwner, bActive, userFlags);
+
+      ++m_uiCurrentIndex;
+      ++m_uiCurrentNumComponentsProcessed;
+
+      // exit here to ensure that we at least did some work
+      if (ezTime::Now() >= endTime)
       {
-        EZ_REPORT_FAILURE("Owner object must be not null");
+        SetSubProgressCompletion((double)m_uiCurrentNumComponentsProcessed / m_WorldReader.m_uiTotalNumComponents);
+        return false;
       }
+    }
 
-      ezComponent* pComponent = nullptr;
-      auto hComponent = pManager->CreateComponentNoInit(pOwnerObject, pComponent);
+    m_uiCurrentIndex = 0;
+  }
 
-      pComponent->SetActiveFlag(bActive);
+  m_uiCurrentIndex = 0;
+  m_uiCurrentComponentTypeIndex = 0;
+  m_uiCurrentNumComponentsProcessed = 0;
 
-      for (ezUInt8 j = 0; j < 8; ++j)
-      {
-        pComponent->SetUserFlag(j, (userFlags & EZ_BIT(j)) != 0);
-      }
+  return true;
+}
 
-      EZ_ASSERT_DEBUG(uiComponentIdx == compTypeInfo.m_ComponentIndexToHandle.GetCount(), "Component index doesn't match");
-      compTypeInfo.m_ComponentIndexToHandle.PushBack(hComponent);
+bool ezWorldReader::InstantiationContext::CreateFlatComponents(ezTime endTime)
+{
+  EZ_PROFILE_SCOPE("ezWorldReader::CreateFlatComponents");
+
+  const auto& indexToGameObjectHandle = m_WorldReader.m_IndexToGameObjectHandle;
+
+  for (; m_uiCurrentComponentTypeIndex < m_WorldReader.m_ComponentTypes.GetCount(); ++m_uiCurrentComponentTypeIndex)
+  {
+    auto& compTypeInfo = m_WorldReader.m_ComponentTypes[m_uiCurrentComponentTypeIndex];
+
+    // will be the case for all abstract component types
+    if (compTypeInfo.m_pRtti == nullptr || compTypeInfo.m_uiNumComponents == 0)
+      continue;
+
+    ezComponentManagerBase* pManager = m_WorldReader.m_pWorld->GetOrCreateManagerForComponentType(compTypeInfo.m_pRtti);
+    EZ_ASSERT_DEV(pManager != nullptr, "Cannot create components of type '{0}', manager is not available.", compTypeInfo.m_pRtti->GetTypeName());
+
+    const ezFlatWorldFormat::Component* pComponents = m_WorldReader.m_pFlatComponents + m_WorldReader.m_pFlatComponentTypes[m_uiCurrentComponentTypeIndex].m_uiFirstComponent;
+
+    if (m_uiCurrentIndex == 0)
+    {
+      compTypeInfo.m_ComponentIndexToHandle.Reserve(compTypeInfo.m_uiNumComponents + 1);
+    }
+
+    while (m_uiCurrentIndex < compTypeInfo.m_uiNumComponents)
+    {
+      const ezFlatWorldFormat::Component& comp = pComponents[m_uiCurrentIndex];
+      const ezGameObjectHandle hOwner = comp.m_uiOwnerIndex < indexToGameObjectHandle.GetCount() ? indexToGameObjectHandle[comp.m_uiOwnerIndex] : ezGameObjectHandle();
+
+      CreateComponent(pManager, compTypeInfo, hOwner, comp.m_uiActive != 0, comp.m_uiUserFlags);
 
       ++m_uiCurrentIndex;
       ++m_uiCurrentNumComponentsProcessed;
@@ -667,16 +1118,217 @@ bool ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
   return true;
 }
 
+void ezWorldReader::InstantiationContext::CreateComponent(ezComponentManagerBase* pManager, ComponentTypeInfo& ref_typeInfo, const ezGameObjectHandle& hOwner, bool bActive, ezUInt8 uiUserFlags)
+{
+  ezGameObject* pOwnerObject = nullptr;
+  if (!m_WorldReader.m_pWorld->TryGetObject(hOwner, pOwnerObject))
+  {
+    EZ_REPORT_FAILURE("Owner object must be not null");
+  }
+
+  ezComponent* pComponent = nullptr;
+  auto hComponent = pManager->CreateComponentNoInit(pOwnerObject, pComponent);
+
+  pComponent->SetActiveFlag(bActive);
+
+  for (ezUInt8 j = 0; j < 8; ++j)
+  {
+    pComponent->SetUserFlag(j, (uiUserFlags & EZ_BIT(j)) != 0);
+  }
+
+  ref_typeInfo.m_ComponentIndexToHandle.PushBack(hComponent);
+}
+
+/// \brief Deserializes all components of one type that has the ezThreadSafeDeserializationAttribute.
+///
+/// The task is started again in every Step() until all components are done and stops when the end time of the step is reached.
+/// It has its own ezWorldReader that reads from the data of this type, but resolves handles through the reader that owns the data.
+class ezWorldReader::InstantiationContext::DeserializationTask final : public ezTask
+{
+public:
+  DeserializationTask(const ezWorldReader& worldReader, ezUInt32 uiComponentTypeIdx, ezComponentManagerBase* pManager)
+    : m_uiComponentTypeIdx(uiComponentTypeIdx)
+    , m_pManager(pManager)
+  {
+    m_DataReader.Begin(worldReader, uiComponentTypeIdx);
+
+    m_Reader.m_pSharedReader = &worldReader;
+    m_Reader.m_pStream = m_DataReader.m_pStream;
+
+    ConfigureTask("DeserializeComponents", ezTaskNesting::Never);
+  }
+
+  bool IsDone() const
+  {
+    return m_uiCurrentIndex >= m_Reader.m_pSharedReader->m_ComponentTypes[m_uiComponentTypeIdx].m_ComponentIndexToHandle.GetCount();
+  }
+
+  virtual void Execute() override
+  {
+    const ezWorldReader& worldReader = *m_Reader.m_pSharedReader;
+    const auto& indexToHandle = worldReader.m_ComponentTypes[m_uiComponentTypeIdx].m_ComponentIndexToHandle;
+
+    // the string deduplication context is thread local, so it has to be activated on the thread that executes this task
+    ezStringDeduplicationReadContext* pContext = worldReader.IsFlatFormat() ? nullptr : worldReader.m_pStringDedupReadContext.Borrow();
+    ezStringDeduplicationReadContext* pPrevContext = ezStringDeduplicationReadContext::GetContext();
+
+    if (pContext != pPrevContext)
+    {
+      if (pPrevContext != nullptr)
+        pPrevContext->SetActive(false);
+      if (pContext != nullptr)
+        pContext->SetActive(true);
+    }
+
+    EZ_SCOPE_EXIT(if (pContext != pPrevContext) {
+      if (pContext != nullptr)
+        pContext->SetActive(false);
+      if (pPrevContext != nullptr)
+        pPrevContext->SetActive(true);
+    });
+
+    while (m_uiCurrentIndex < indexToHandle.GetCount())
+    {
+      ezComponent* pComponent = nullptr;
+      if (m_pManager->TryGetComponent(indexToHandle[m_uiCurrentIndex++], pComponent))
+      {
+        pComponent->DeserializeComponent(m_Reader);
+
+        ++m_uiNumProcessed;
+
+        // exit here to ensure that we at least did some work
+        if (ezTime::Now() >= m_EndTime)
+          return;
+      }
+    }
+  }
+
+  ezWorldReader m_Reader;
+  ComponentDataReader m_DataReader;
+  ezUInt32 m_uiComponentTypeIdx = 0;
+  ezComponentManagerBase* m_pManager = nullptr;
+
+  ezUInt32 m_uiCurrentIndex = 0;
+  ezUInt32 m_uiNumProcessed = 0; ///< Since the last step, for the progress
+  ezTime m_EndTime;
+};
+
+void ezWorldReader::InstantiationContext::CreateDeserializationTasks()
+{
+  m_DeserializationTasks.Clear();
+
+  if (!cvar_WorldReaderParallelDeserialization)
+    return;
+
+  // for a few components the task overhead isn't worth it
+  constexpr ezUInt32 uiMinComponentsPerTask = 32;
+
+  for (ezUInt32 uiTypeIdx = 0; uiTypeIdx < m_WorldReader.m_ComponentTypes.GetCount(); ++uiTypeIdx)
+  {
+    const auto& compTypeInfo = m_WorldReader.m_ComponentTypes[uiTypeIdx];
+    if (!compTypeInfo.m_bThreadSafeDeserialization || compTypeInfo.m_ComponentIndexToHandle.GetCount() <= uiMinComponentsPerTask)
+      continue;
+
+    ezComponentManagerBase* pManager = m_WorldReader.m_pWorld->GetManagerForComponentType(compTypeInfo.m_pRtti);
+    if (pManager == nullptr)
+      continue;
+
+    m_DeserializationTasks.PushBack(EZ_DEFAULT_NEW(DeserializationTask, m_WorldReader, uiTypeIdx, pManager));
+  }
+}
+
+ezTaskGroupID ezWorldReader::InstantiationContext::StartDeserializationTasks(ezTime endTime)
+{
+  ezTaskGroupID taskGroup;
+
+  for (auto& pTask : m_DeserializationTasks)
+  {
+    if (pTask->IsDone())
+      continue;
+
+    if (!taskGroup.IsValid())
+    {
+      taskGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+    }
+
+    pTask->m_EndTime = endTime;
+    ezTaskSystem::AddTaskToGroup(taskGroup, pTask);
+  }
+
+  if (taskGroup.IsValid())
+  {
+    ezTaskSystem::StartTaskGroup(taskGroup);
+  }
+
+  return taskGroup;
+}
+
 bool ezWorldReader::InstantiationContext::DeserializeComponents(ezTime endTime)
 {
   EZ_PROFILE_SCOPE("ezWorldReader::DeserializeComponents");
 
+  // types with the ezThreadSafeDeserializationAttribute are deserialized by tasks, while this thread takes care of all other types
+  const ezTaskGroupID taskGroup = StartDeserializationTasks(endTime);
+
+  bool bFinished = DeserializeComponentsOnThisThread(endTime);
+
+  if (taskGroup.IsValid())
+  {
+    // the tasks stop at the end time as well, so this doesn't take much longer than the step
+    ezTaskSystem::WaitForGroup(taskGroup);
+
+    for (auto& pTask : m_DeserializationTasks)
+    {
+      m_uiCurrentNumComponentsProcessed += pTask->m_uiNumProcessed;
+      pTask->m_uiNumProcessed = 0;
+
+      bFinished &= pTask->IsDone();
+    }
+  }
+
+  if (!bFinished)
+  {
+    SetSubProgressCompletion((double)m_uiCurrentNumComponentsProcessed / m_WorldReader.m_uiTotalNumComponents);
+    return false;
+  }
+
+  m_DeserializationTasks.Clear();
+
+  m_uiCurrentIndex = 0;
+  m_uiCurrentComponentTypeIndex = 0;
+  m_uiCurrentNumComponentsProcessed = 0;
+
+  return true;
+}
+
+bool ezWorldReader::InstantiationContext::DeserializeComponentsOnThisThread(ezTime endTime)
+{
+  auto HasTask = [&](ezUInt32 uiTypeIdx)
+  {
+    for (auto& pTask : m_DeserializationTasks)
+    {
+      if (pTask->m_uiComponentTypeIdx == uiTypeIdx)
+        return true;
+    }
+    return false;
+  };
+
+  ezStreamReader* pPrevReader = m_WorldReader.m_pStream;
+  EZ_SCOPE_EXIT(m_WorldReader.m_pStream = pPrevReader;);
+
   for (; m_uiCurrentComponentTypeIndex < m_WorldReader.m_ComponentTypes.GetCount(); ++m_uiCurrentComponentTypeIndex)
   {
     auto& compTypeInfo = m_WorldReader.m_ComponentTypes[m_uiCurrentComponentTypeIndex];
-    if (compTypeInfo.m_pRtti == nullptr)
+    if (compTypeInfo.m_pRtti == nullptr || HasTask(m_uiCurrentComponentTypeIndex))
       continue;
 
+    if (m_uiCurrentIndex == 0)
+    {
+      m_ComponentDataReader.Begin(m_WorldReader, m_uiCurrentComponentTypeIndex);
+    }
+
+    m_WorldReader.m_pStream = m_ComponentDataReader.m_pStream;
+
     while (m_uiCurrentIndex < compTypeInfo.m_ComponentIndexToHandle.GetCount())
     {
       ezComponent* pComponent = nullptr;
@@ -688,20 +1340,13 @@ bool ezWorldReader::InstantiationContext::DeserializeComponents(ezTime endTime)
 
         // exit here to ensure that we at least did some work
         if (ezTime::Now() >= endTime)
-        {
-          SetSubProgressCompletion((double)m_uiCurrentNumComponentsProcessed / m_WorldReader.m_uiTotalNumComponents);
           return false;
-        }
       }
     }
 
     m_uiCurrentIndex = 0;
   }
 
-  m_uiCurrentIndex = 0;
-  m_uiCurrentComponentTypeIndex = 0;
-  m_uiCurrentNumComponentsProcessed = 0;
-
   return true;
 }
 
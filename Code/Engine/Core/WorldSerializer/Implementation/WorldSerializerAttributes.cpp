@@ -0,0 +1,11 @@
+#include <Core/CorePCH.h>
+
+#include <Core/WorldSerializer/WorldSerializerAttributes.h>
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezThreadSafeDeserializationAttribute, 1, ezRTTIDefaultAllocator<ezThreadSafeDeserializationAttribute>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+
+EZ_STATICLINK_FILE(Core, Core_WorldSerializer_Implementation_WorldSerializerAttributes);
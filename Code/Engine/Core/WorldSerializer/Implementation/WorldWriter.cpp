@@ -1,5 +1,6 @@
 #include <Core/CorePCH.h>
 
+#include <Core/WorldSerializer/Implementation/FlatWorldFormat.h>
 #include <Core/WorldSerializer/WorldWriter.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/StringDeduplicationContext.h>
@@ -66,6 +67,9 @@ void ezWorldWriter::WriteObjects(ezStreamWriter& inout_stream, ezArrayPtr<const
 
 ezResult ezWorldWriter::WriteToStream()
 {
+  if (m_bFlatFormat)
+    return WriteFlatToStream();
+
   const ezUInt8 uiVersion = 10;
   *m_pStream << uiVersion;
 
@@ -83,13 +87,8 @@ ezResult ezWorldWriter::WriteToStream()
   *m_pStream << uiNumChildObjects;
   *m_pStream << uiNumComponentTypes;
 
-  // this is used to sort all component types by name, to make the file serialization deterministic
   ezMap<ezString, const ezRTTI*> sortedTypes;
-
-  for (auto it = m_AllComponents.GetIterator(); it.IsValid(); ++it)
-  {
-    sortedTypes[it.Key()->GetTypeName()] = it.Key();
-  }
+  SortComponentTypes(sortedTypes);
 
   AssignGameObjectIndices();
   AssignComponentHandleIndices(sortedTypes);
@@ -125,6 +124,215 @@ ezResult ezWorldWriter::WriteToStream()
   return EZ_SUCCESS;
 }
 
+ezResult ezWorldWriter::WriteFlatToStream()
+{
+  using namespace ezFlatWorldFormat;
+
+  IncludeAllComponentBaseTypes();
+
+  ezMap<ezString, const ezRTTI*> sortedTypes;
+  SortComponentTypes(sortedTypes);
+
+  AssignGameObjectIndices();
+  AssignComponentHandleIndices(sortedTypes);
+
+  Header header;
+  header.m_uiNumRootObjects = m_AllRootObjects.GetCount();
+  header.m_uiNumChildObjects = m_AllChildObjects.GetCount();
+  header.m_uiNumComponentTypes = m_AllComponents.GetCount();
+
+  // string pool, index 0 is the empty string
+  ezHashTable<ezString, ezUInt32> stringToIndex;
+  ezDynamicArray<ezUInt32> stringOffsets;
+  ezDynamicArray<char> stringData;
+
+  auto AddString = [&](ezStringView sString) -> ezUInt32
+  {
+    ezUInt32 uiIndex = stringOffsets.GetCount();
+    if (stringToIndex.TryGetValue(sString, uiIndex))
+      return uiIndex;
+
+    stringToIndex.Insert(sString, uiIndex);
+    stringOffsets.PushBack(stringData.GetCount());
+    stringData.PushBackRange(ezArrayPtr<const char>(sString.GetStartPointer(), sString.GetElementCount()));
+    stringData.PushBack('\0');
+    return uiIndex;
+  };
+
+  AddString("");
+
+  // tag set pool, index 0 is the empty tag set
+  ezHashTable<ezString, ezUInt32> tagSetToIndex;
+  ezDynamicArray<TagSet> tagSets;
+  ezDynamicArray<ezUInt32> tagIndices;
+  tagSets.PushBack({0, 0});
+
+  ezStringBuilder sTagSetKey;
+  auto AddTagSet = [&](const ezTagSet& tags) -> ezUInt32
+  {
+    if (tags.IsEmpty())
+      return 0;
+
+    sTagSetKey.Clear();
+    for (const ezTag& tag : tags)
+    {
+      sTagSetKey.Append(tag.GetTagString(), ";");
+    }
+
+    ezUInt32 uiIndex = tagSets.GetCount();
+    if (tagSetToIndex.TryGetValue(sTagSetKey, uiIndex))
+      return uiIndex;
+
+    tagSetToIndex.Insert(sTagSetKey, uiIndex);
+
+    TagSet& tagSet = tagSets.ExpandAndGetRef();
+    tagSet.m_uiFirstTagIndex = tagIndices.GetCount();
+    for (const ezTag& tag : tags)
+    {
+      tagIndices.PushBack(AddString(tag.GetTagString()));
+    }
+    tagSet.m_uiNumTags = tagIndices.GetCount() - tagSet.m_uiFirstTagIndex;
+    return uiIndex;
+  };
+
+  ezDynamicArray<Object> objects;
+  objects.SetCountUninitialized(m_AllRootObjects.GetCount() + m_AllChildObjects.GetCount());
+
+  ezUInt32 uiObjectIndex = 0;
+  auto WriteObject = [&](const ezGameObject* pObject)
+  {
+    Object& obj = objects[uiObjectIndex++];
+    obj.m_vLocalPosition = pObject->GetLocalPosition();
+    obj.m_qLocalRotation = pObject->GetLocalRotation();
+    obj.m_vLocalScaling = pObject->GetLocalScaling();
+    obj.m_fLocalUniformScaling = pObject->GetLocalUniformScaling();
+    obj.m_uiParentIndex = pObject->GetParent() ? GetGameObjectIndex(pObject->GetParent()->GetHandle()) : 0;
+    obj.m_uiNameString = AddString(pObject->GetName());
+    obj.m_uiGlobalKeyString = AddString(pObject->GetGlobalKey());
+    obj.m_uiTagSet = AddTagSet(pObject->GetTags());
+    obj.m_uiStableRandomSeed = pObject->GetStableRandomSeed();
+    obj.m_uiTeamID = pObject->GetTeamID();
+    obj.m_uiFlags = (pObject->GetActiveFlag() ? Object::Active : 0) | (pObject->IsDynamic() ? Object::Dynamic : 0);
+    obj.m_uiPadding = 0;
+  };
+
+  for (const auto* pObject : m_AllRootObjects)
+  {
+    WriteObject(pObject);
+  }
+
+  for (const auto* pObject : m_AllChildObjects)
+  {
+    WriteObject(pObject);
+  }
+
+  ezDynamicArray<ComponentType> componentTypes;
+  ezDynamicArray<Component> components;
+  ezDynamicArray<ezUInt8> componentData;
+
+  {
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> dataStorage(&componentData);
+    ezMemoryStreamWriter dataWriter(&dataStorage);
+
+    ezStreamWriter* pPrevStream = m_pStream;
+    m_pStream = &dataWriter;
+
+    for (auto it = sortedTypes.GetIterator(); it.IsValid(); ++it)
+    {
+      const ezDeque<const ezComponent*>& typeComponents = m_AllComponents[it.Value()].m_Components;
+
+      ComponentType& type = componentTypes.ExpandAndGetRef();
+      type.m_uiNameString = AddString(it.Value()->GetTypeName());
+      type.m_uiTypeVersion = it.Value()->GetTypeVersion();
+      type.m_uiFirstComponent = components.GetCount();
+      type.m_uiNumComponents = typeComponents.GetCount();
+      type.m_uiDataOffset = componentData.GetCount();
+
+      for (const ezComponent* pComponent : typeComponents)
+      {
+        ezUInt8 userFlags = 0;
+        for (ezUInt8 i = 0; i < 8; ++i)
+        {
+          userFlags |= pComponent->GetUserFlag(i) ? EZ_BIT(i) : 0;
+        }
+
+        Component& comp = components.ExpandAndGetRef();
+        comp.m_uiOwnerIndex = GetGameObjectIndex(pComponent->GetOwner()->GetHandle());
+        comp.m_uiActive = pComponent->GetActiveFlag() ? 1 : 0;
+        comp.m_uiUserFlags = userFlags;
+        comp.m_uiPadding = 0;
+
+        pComponent->SerializeComponent(*this);
+      }
+
+      type.m_uiDataSize = componentData.GetCount() - type.m_uiDataOffset;
+    }
+
+    m_pStream = pPrevStream;
+  }
+
+  header.m_uiNumComponents = components.GetCount();
+  header.m_uiNumStrings = stringOffsets.GetCount();
+  header.m_uiNumTagSets = tagSets.GetCount();
+  header.m_uiNumTagIndices = tagIndices.GetCount();
+  header.m_uiComponentDataSize = componentData.GetCount();
+
+  // place all sections one after the other
+  ezUInt64 uiOffset = sizeof(Header);
+  auto PlaceSection = [&](ezUInt64 uiSize) -> ezUInt32
+  {
+    uiOffset = ezMemoryUtils::AlignSize<ezUInt64>(uiOffset, Alignment);
+    const ezUInt64 uiSectionOffset = uiOffset;
+    uiOffset += uiSize;
+    return static_cast<ezUInt32>(uiSectionOffset);
+  };
+
+  header.m_uiObjectsOffset = PlaceSection(objects.GetArrayPtr().ToByteArray().GetCount());
+  header.m_uiComponentTypesOffset = PlaceSection(componentTypes.GetArrayPtr().ToByteArray().GetCount());
+  header.m_uiComponentsOffset = PlaceSection(components.GetArrayPtr().ToByteArray().GetCount());
+  header.m_uiTagSetsOffset = PlaceSection(tagSets.GetArrayPtr().ToByteArray().GetCount());
+  header.m_uiTagIndicesOffset = PlaceSection(tagIndices.GetArrayPtr().ToByteArray().GetCount());
+  header.m_uiStringOffsetsOffset = PlaceSection(stringOffsets.GetArrayPtr().ToByteArray().GetCount());
+  header.m_uiStringDataOffset = PlaceSection(stringData.GetCount());
+  header.m_uiComponentDataOffset = PlaceSection(componentData.GetCount());
+  header.m_uiTotalSize = ezMemoryUtils::AlignSize<ezUInt64>(uiOffset, Alignment);
+
+  EZ_ASSERT_ALWAYS(header.m_uiTotalSize <= ezMath::MaxValue<ezUInt32>(), "The flat world format does not support worlds larger than 4GB.");
+
+  ezDynamicArray<ezUInt8> data;
+  data.SetCount(static_cast<ezUInt32>(header.m_uiTotalSize));
+
+  auto CopySection = [&](ezUInt32 uiSectionOffset, ezArrayPtr<const ezUInt8> section)
+  {
+    ezMemoryUtils::Copy(data.GetData() + uiSectionOffset, section.GetPtr(), section.GetCount());
+  };
+
+  CopySection(0, ezArrayPtr<const Header>(&header, 1).ToByteArray());
+  CopySection(header.m_uiObjectsOffset, objects.GetArrayPtr().ToByteArray());
+  CopySection(header.m_uiComponentTypesOffset, componentTypes.GetArrayPtr().ToByteArray());
+  CopySection(header.m_uiComponentsOffset, components.GetArrayPtr().ToByteArray());
+  CopySection(header.m_uiTagSetsOffset, tagSets.GetArrayPtr().ToByteArray());
+  CopySection(header.m_uiTagIndicesOffset, tagIndices.GetArrayPtr().ToByteArray());
+  CopySection(header.m_uiStringOffsetsOffset, stringOffsets.GetArrayPtr().ToByteArray());
+  CopySection(header.m_uiStringDataOffset, stringData.GetArrayPtr().ToByteArray());
+  CopySection(header.m_uiComponentDataOffset, componentData);
+
+  // the marker and the size take up 16 bytes, so that the flat data keeps the alignment of the stream position
+  const ezUInt8 padding[7] = {};
+  *m_pStream << StreamMarker;
+  EZ_SUCCEED_OR_RETURN(m_pStream->WriteBytes(padding, sizeof(padding)));
+  *m_pStream << header.m_uiTotalSize;
+  return m_pStream->WriteBytes(data.GetData(), data.GetCount());
+}
+
+void ezWorldWriter::SortComponentTypes(ezMap<ezString, const ezRTTI*>& out_sortedTypes) const
+{
+  // this is used to sort all component types by name, to make the file serialization deterministic
+  for (auto it = m_AllComponents.GetIterator(); it.IsValid(); ++it)
+  {
+    out_sortedTypes[it.Key()->GetTypeName()] = it.Key();
+  }
+}
 
 void ezWorldWriter::AssignGameObjectIndices()
 {
@@ -209,16 +417,19 @@ void ezWorldWriter::Traverse(ezGameObject* pObject)
 
 void ezWorldWriter::WriteGameObjectHandle(const ezGameObjectHandle& hObject)
 {
-  auto it = m_WrittenGameObjectHandles.Find(hObject);
+  *m_pStream << GetGameObjectIndex(hObject);
+}
 
-  ezUInt32 uiIndex = 0;
+ezUInt32 ezWorldWriter::GetGameObjectIndex(const ezGameObjectHandle& hObject) const
+{
+  auto it = m_WrittenGameObjectHandles.Find(hObject);
 
   EZ_ASSERT_DEV(it.IsValid(), "Referenced object does not exist in the scene. This can happen, if it was optimized away, because it had no name, no children and no essential components.");
 
   if (it.IsValid())
-    uiIndex = it.Value();
+    return it.Value();
 
-  *m_pStream << uiIndex;
+  return 0;
 }
 
 void ezWorldWriter::WriteComponentHandle(const ezComponentHandle& hComponent)
@@ -3,6 +3,7 @@
 #include <Core/World/World.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/Stream.h>
+#include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Types/UniquePtr.h>
 
@@ -10,6 +11,14 @@ class ezStringDeduplicationReadContext;
 class ezProgress;
 class ezProgressRange;
 
+namespace ezFlatWorldFormat
+{
+  struct Header;
+  struct Object;
+  struct ComponentType;
+  struct Component;
+} // namespace ezFlatWorldFormat
+
 struct ezPrefabInstantiationOptions
 {
   ezGameObjectHandle m_hParent;
@@ -82,8 +91,18 @@ public:
   /// to actually get an objects into an ezWorld.
   /// By default, the method will warn if it skips bytes in the stream that are of unknown
   /// types. The warnings can be suppressed by setting warningOnUnkownSkip to false.
+  ///
+  /// If the stream contains a world in the flat format (see ezWorldWriter::SetFlatFormat()), the flat data is copied into memory.
   ezResult ReadWorldDescription(ezStreamReader& inout_stream, bool bWarningOnUnkownSkip = true);
 
+  /// \brief Prepares instantiating a world that was written in the flat format (see ezWorldWriter::SetFlatFormat()) directly from memory.
+  ///
+  /// The data may start either with the flat data itself or with the marker that ezWorldWriter writes in front of it.
+  /// Only the strings, tags and component types are looked up here, the game object and component records are used
+  /// as they are during instantiation. Therefore the memory, e.g. of a memory mapped file, has to stay valid as long as the world
+  /// gets instantiated from this reader. Only if the data is not properly aligned, it gets copied first.
+  ezResult ReadFlatWorldDescription(ezArrayPtr<const ezUInt8> data, bool bWarningOnUnkownSkip = true);
+
   /// \brief Creates one instance of the world that was previously read by ReadWorldDescription().
   ///
   /// This is identical to calling InstantiatePrefab() with identity values, however, it is a bit
@@ -168,6 +187,11 @@ private:
 
   void ReadGameObjectDesc(GameObjectToCreate& godesc);
   void ReadComponentTypeInfo(ezUInt32 uiComponentTypeIdx);
+  static const ezRTTI* FindComponentType(ezStringView sTypeName);
+  ezResult ReadFlatData(ezArrayPtr<const ezUInt8> data, bool bWarningOnUnknownSkip);
+  void ClearFlatData();
+  bool IsFlatFormat() const { return m_pFlatHeader != nullptr; }
+  void GetFlatObjectDesc(ezUInt32 uiObjectIndex, ezGameObjectDesc& out_desc, ezStringView& out_sGlobalKey) const;
   void ReadComponentDataToMemStream(bool warningOnUnknownSkip = true);
   void ClearHandles();
   ezUniquePtr<InstantiationContextBase> Instantiate(ezWorld& world, bool bUseTransform, const ezTransform& rootTransform, const ezPrefabInstantiationOptions& options);
@@ -186,6 +210,18 @@ private:
     const ezRTTI* m_pRtti = nullptr;
     ezDynamicArray<ezComponentHandle> m_ComponentIndexToHandle;
     ezUInt32 m_uiNumComponents = 0;
+    ezUInt64 m_uiDataOffset = 0; ///< Where the DeserializeComponent() data of this type starts, in m_ComponentDataStream or in the flat component data
+    bool m_bThreadSafeDeserialization = false; ///< The type has the ezThreadSafeDeserializationAttribute
+  };
+
+  /// \brief Reads the DeserializeComponent() data of one component type, independent of the data of all other types.
+  struct ComponentDataReader
+  {
+    void Begin(const ezWorldReader& worldReader, ezUInt32 uiComponentTypeIdx);
+
+    ezStreamReader* m_pStream = nullptr;
+    ezMemoryStreamReader m_StreamReader;
+    ezRawMemoryStreamReader m_FlatReader;
   };
 
   ezDynamicArray<ComponentTypeInfo> m_ComponentTypes;
@@ -196,6 +232,19 @@ private:
 
   ezUniquePtr<ezStringDeduplicationReadContext> m_pStringDedupReadContext;
 
+  // readers that deserialize components on worker threads only have their own stream, all lookups go to the reader that owns the data
+  const ezWorldReader* m_pSharedReader = nullptr;
+
+  // flat format, the records point into the data passed to ReadFlatWorldDescription() or into m_FlatDataCopy
+  const ezFlatWorldFormat::Header* m_pFlatHeader = nullptr;
+  const ezFlatWorldFormat::Object* m_pFlatObjects = nullptr;
+  const ezFlatWorldFormat::ComponentType* m_pFlatComponentTypes = nullptr;
+  const ezFlatWorldFormat::Component* m_pFlatComponents = nullptr;
+  const ezUInt8* m_pFlatComponentData = nullptr;
+  ezDynamicArray<ezUInt8> m_FlatDataCopy;
+  ezDynamicArray<ezHashedString> m_FlatStrings;
+  ezDynamicArray<ezTagSet> m_FlatTagSets;
+
   class InstantiationContext : public InstantiationContextBase
   {
   public:
@@ -208,8 +257,21 @@ private:
     template <bool UseTransform>
     bool CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, ezGameObjectHandle hParent, ezDynamicArray<ezGameObject*>* out_pCreatedObjects, ezTime endTime);
 
+    template <bool UseTransform>
+    bool CreateFlatGameObjects(ezUInt32 uiFirstObject, ezUInt32 uiNumObjects, ezGameObjectHandle hParent, ezDynamicArray<ezGameObject*>* out_pCreatedObjects, ezTime endTime);
+
+    template <bool UseTransform>
+    void FinalizeGameObjectDesc(ezGameObjectDesc& ref_desc);
+
+    void CreateGameObject(const ezGameObjectDesc& desc, ezStringView sGlobalKey, ezDynamicArray<ezGameObject*>* out_pCreatedObjects);
+    void CreateComponent(ezComponentManagerBase* pManager, ComponentTypeInfo& ref_typeInfo, const ezGameObjectHandle& hOwner, bool bActive, ezUInt8 uiUserFlags);
+
     bool CreateComponents(ezTime endTime);
+    bool CreateFlatComponents(ezTime endTime);
     bool DeserializeComponents(ezTime endTime);
+    bool DeserializeComponentsOnThisThread(ezTime endTime);
+    void CreateDeserializationTasks();
+    ezTaskGroupID StartDeserializationTasks(ezTime endTime);
     bool AddComponentsToBatch(ezTime endTime);
 
     void SetMaxStepTime(ezTime stepTime);
@@ -222,6 +284,8 @@ private:
     friend class ezWorldReader;
     ezWorldReader& m_WorldReader;
 
+    class DeserializationTask;
+
     bool m_bUseTransform = false;
     ezTransform m_RootTransform;
 
@@ -251,6 +315,14 @@ private:
     ezUInt32 m_uiCurrentComponentTypeIndex = 0;
     ezUInt64 m_uiCurrentNumComponentsProcessed = 0;
     ezMemoryStreamReader m_CurrentReader;
+    ComponentDataReader m_ComponentDataReader;
+    ezDynamicArray<ezSharedPtr<DeserializationTask>> m_DeserializationTasks;
+
+    // one batch of objects that are created at once from the flat format
+    ezDynamicArray<ezGameObjectDesc> m_FlatObjectDescs;
+    ezDynamicArray<ezUInt32> m_FlatParentIndices;
+    ezDynamicArray<ezStringView> m_FlatGlobalKeys;
+    ezDynamicArray<ezGameObject*> m_FlatCreatedObjects;
 
     ezUniquePtr<ezProgressRange> m_pOverallProgressRange;
     ezUniquePtr<ezProgressRange> m_pSubProgressRange;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Core/CoreDLL.h>
+#include <Foundation/Reflection/Reflection.h>
+
+/// \brief Add this attribute to a component type to allow ezWorldReader to call its DeserializeComponent() function on worker threads.
+///
+/// The components of such a type are deserialized by a separate task, while the owning thread deserializes the components of all other types.
+/// This is only allowed if DeserializeComponent() exclusively reads from the given ezWorldReader and writes to the component itself.
+/// It must not access the world, the owner object or other components. Loading resources is fine.
+/// The attribute is not inherited, every derived component type has to opt in separately.
+class EZ_CORE_DLL ezThreadSafeDeserializationAttribute : public ezPropertyAttribute
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezThreadSafeDeserializationAttribute, ezPropertyAttribute);
+
+public:
+  ezThreadSafeDeserializationAttribute() = default;
+};
@@ -45,9 +45,21 @@ public:
   /// \brief Returns an array containing all game object pointers that were written to the stream as child objects
   const ezDeque<const ezGameObject*>& GetAllWrittenChildObjects() const { return m_AllChildObjects; }
 
+  /// \brief Selects whether the following calls to WriteWorld() and WriteObjects() write the flat format.
+  ///
+  /// The flat format stores game objects and component creation data in fixed-size records with all strings and tags
+  /// pooled, so that ezWorldReader can use it directly from memory, e.g. from a memory mapped file, instead of parsing it.
+  /// It is larger than the regular format and meant for baked levels and prefabs that are loaded often.
+  /// The data written by the components' SerializeComponent() functions is the same in both formats.
+  void SetFlatFormat(bool bFlatFormat) { m_bFlatFormat = bFlatFormat; }
+  bool GetFlatFormat() const { return m_bFlatFormat; }
+
 private:
   void Clear();
   ezResult WriteToStream();
+  ezResult WriteFlatToStream();
+  void SortComponentTypes(ezMap<ezString, const ezRTTI*>& out_sortedTypes) const;
+  ezUInt32 GetGameObjectIndex(const ezGameObjectHandle& hObject) const;
   void AssignGameObjectIndices();
   void AssignComponentHandleIndices(const ezMap<ezString, const ezRTTI*>& sortedTypes);
   void IncludeAllComponentBaseTypes();
@@ -62,6 +74,7 @@ private:
 
   ezStreamWriter* m_pStream = nullptr;
   const ezTagSet* m_pExclude = nullptr;
+  bool m_bFlatFormat = false;
 
   ezDeque<const ezGameObject*> m_AllRootObjects;
   ezDeque<const ezGameObject*> m_AllChildObjects;
@@ -35,6 +35,73 @@ void ezSorting::InsertionSort(ezArrayPtr<T>& inout_arrayPtr, const Comparer& com
   InsertionSort(inout_arrayPtr, 0, inout_arrayPtr.GetCount() - 1, comparer);
 }
 
+template <typename T, typename KeyFunc>
+void ezSorting::RadixSort(ezArrayPtr<T> inout_arrayPtr, ezArrayPtr<T> scratch, KeyFunc getKey)
+{
+  EZ_ASSERT_DEV(scratch.GetCount() >= inout_arrayPtr.GetCount(), "The scratch array is too small ({} elements instead of {})", scratch.GetCount(), inout_arrayPtr.GetCount());
+
+  const ezUInt32 uiCount = inout_arrayPtr.GetCount();
+  if (uiCount <= 1)
+    return;
+
+  // build the histograms of all four key bytes in one go
+  ezUInt32 histograms[4][256] = {};
+
+  for (ezUInt32 i = 0; i < uiCount; ++i)
+  {
+    const ezUInt32 uiKey = getKey(inout_arrayPtr[i]);
+
+    ++histograms[0][uiKey & 0xFF];
+    ++histograms[1][(uiKey >> 8) & 0xFF];
+    ++histograms[2][(uiKey >> 16) & 0xFF];
+    ++histograms[3][uiKey >> 24];
+  }
+
+  T* pSrc = inout_arrayPtr.GetPtr();
+  T* pDst = scratch.GetPtr();
+
+  for (ezUInt32 uiPass = 0; uiPass < 4; ++uiPass)
+  {
+    ezUInt32* pHistogram = histograms[uiPass];
+    const ezUInt32 uiShift = uiPass * 8;
+
+    // all elements have the same value in this byte, so this pass wouldn't change the order
+    if (pHistogram[(getKey(pSrc[0]) >> uiShift) & 0xFF] == uiCount)
+      continue;
+
+    // turn the counts into the start offsets of the buckets
+    ezUInt32 uiOffset = 0;
+    for (ezUInt32 b = 0; b < 256; ++b)
+    {
+      const ezUInt32 uiBucketCount = pHistogram[b];
+      pHistogram[b] = uiOffset;
+      uiOffset += uiBucketCount;
+    }
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      pDst[pHistogram[(getKey(pSrc[i]) >> uiShift) & 0xFF]++] = pSrc[i];
+    }
+
+    ezMath::Swap(pSrc, pDst);
+  }
+
+  if (pSrc != inout_arrayPtr.GetPtr())
+  {
+    ezMemoryUtils::Copy(inout_arrayPtr.GetPtr(), pSrc, uiCount);
+  }
+}
+
+EZ_ALWAYS_INLINE ezUInt32 ezSorting::FloatToRadixKey(float fValue)
+{
+  ezUInt32 uiBits;
+  ezMemoryUtils::RawByteCopy(&uiBits, &fValue, sizeof(float));
+
+  // negative values have to be flipped entirely to reverse their order, positive values only need the sign bit set to come after them
+  const ezUInt32 uiMask = static_cast<ezUInt32>(-static_cast<ezInt32>(uiBits >> 31)) | 0x80000000u;
+  return uiBits ^ uiMask;
+}
+
 template <typename Container, typename Comparer>
 void ezSorting::QuickSort(Container& inout_container, ezUInt32 uiStartIndex, ezUInt32 uiEndIndex, const Comparer& in_comparer)
 {
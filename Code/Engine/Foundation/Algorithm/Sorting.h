@@ -27,6 +27,17 @@ public:
   template <typename T, typename Comparer>
   static void InsertionSort(ezArrayPtr<T>& inout_arrayPtr, const Comparer& comparer = Comparer()); // [tested]
 
+  /// \brief Sorts the elements in the array by an unsigned 32 bit key in ascending order, using a LSD radix sort (stable, not in-place).
+  ///
+  /// getKey is called with an element and has to return its key as ezUInt32. scratch has to have the same number of elements
+  /// as inout_arrayPtr, its content is undefined afterwards. Use FloatToRadixKey() to sort by float values.
+  /// For large arrays this is considerably faster than the comparison based sorts, since every element is only moved once per key byte.
+  template <typename T, typename KeyFunc>
+  static void RadixSort(ezArrayPtr<T> inout_arrayPtr, ezArrayPtr<T> scratch, KeyFunc getKey); // [tested]
+
+  /// \brief Converts a float into a key for RadixSort(), which sorts in the same order as the float values.
+  static ezUInt32 FloatToRadixKey(float fValue); // [tested]
+
 private:
   enum
   {
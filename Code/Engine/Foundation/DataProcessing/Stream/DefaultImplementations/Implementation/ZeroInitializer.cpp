@@ -14,8 +14,10 @@ EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
 ezProcessingStreamSpawnerZeroInitialized::ezProcessingStreamSpawnerZeroInitialized()
-
-  = default;
+{
+  // nothing to do in Process(), so it doesn't interrupt chains of tiled processors
+  m_bTileSafe = true;
+}
 
 void ezProcessingStreamSpawnerZeroInitialized::SetStreamName(ezStringView sStreamName)
 {
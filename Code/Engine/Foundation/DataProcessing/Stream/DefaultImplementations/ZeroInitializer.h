@@ -24,6 +24,7 @@ protected:
 
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
   virtual void Process(ezUInt64 uiNumElements) override {}
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
 
   ezHashedString m_sStreamName;
 
@@ -6,6 +6,7 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/MemoryUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 ezProcessingStreamGroup::ezProcessingStreamGroup()
 {
@@ -142,6 +143,19 @@ void ezProcessingStreamGroup::SetSize(ezUInt64 uiNumElements)
 /// processors).
 void ezProcessingStreamGroup::RemoveElement(ezUInt64 uiElementIndex)
 {
+  if (m_bProcessingTiles)
+  {
+    // tile safe processors only remove elements of their own tile and every tile is processed by a single thread
+    auto& tileRemoveIndices = m_TilePendingRemoveIndices[static_cast<ezUInt32>(uiElementIndex / m_uiTileSize)];
+
+    if (!tileRemoveIndices.Contains(uiElementIndex))
+    {
+      tileRemoveIndices.PushBack(uiElementIndex);
+    }
+
+    return;
+  }
+
   if (m_PendingRemoveIndices.Contains(uiElementIndex))
     return;
 
@@ -154,6 +168,13 @@ void ezProcessingStreamGroup::RemoveElement(ezUInt64 uiElementIndex)
 /// spawning will be queued.
 void ezProcessingStreamGroup::InitializeElements(ezUInt64 uiNumElements)
 {
+  if (m_bProcessingTiles)
+  {
+    EZ_LOCK(m_TileSpawnMutex);
+    m_uiPendingNumberOfElementsToSpawn += uiNumElements;
+    return;
+  }
+
   m_uiPendingNumberOfElementsToSpawn += uiNumElements;
 }
 
@@ -161,10 +182,16 @@ void ezProcessingStreamGroup::Process()
 {
   EnsureStreamAssignmentValid();
 
-  // TODO: Identify which processors work on which streams and find independent groups and use separate tasks for them?
-  for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
+  if (m_ExecutionMode != ExecutionMode::Sequential && m_uiNumActiveElements > 0)
   {
-    pStreamProcessor->Process(m_uiNumActiveElements);
+    ProcessTiled();
+  }
+  else
+  {
+    for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
+    {
+      pStreamProcessor->Process(m_uiNumActiveElements);
+    }
   }
 
   // Run any pending deletions which happened due to stream processor execution
@@ -176,6 +203,89 @@ void ezProcessingStreamGroup::Process()
 }
 
 
+void ezProcessingStreamGroup::ProcessTiled()
+{
+  const ezUInt64 uiNumTiles = (m_uiNumActiveElements + m_uiTileSize - 1) / m_uiTileSize;
+  m_TilePendingRemoveIndices.SetCount(static_cast<ezUInt32>(uiNumTiles));
+
+  for (ezUInt32 uiFirst = 0; uiFirst < m_Processors.GetCount();)
+  {
+    if (!m_Processors[uiFirst]->IsTileSafe())
+    {
+      m_Processors[uiFirst]->Process(m_uiNumActiveElements);
+      ++uiFirst;
+      continue;
+    }
+
+    // all consecutive tile safe processors work on one tile after the other, while its data is in the cache
+    ezUInt32 uiEnd = uiFirst + 1;
+    while (uiEnd < m_Processors.GetCount() && m_Processors[uiEnd]->IsTileSafe())
+    {
+      ++uiEnd;
+    }
+
+    const ezArrayPtr<ezProcessingStreamProcessor* const> processors = m_Processors.GetArrayPtr().GetSubArray(uiFirst, uiEnd - uiFirst);
+
+    m_bProcessingTiles = true;
+
+    if (m_ExecutionMode == ExecutionMode::TiledParallel && uiNumTiles > 1)
+    {
+      ezTaskSystem::ParallelForIndexed(
+        ezUInt64(0), uiNumTiles, [this, processors](ezUInt64 uiStartTile, ezUInt64 uiEndTile)
+        { ProcessTiles(processors, uiStartTile, uiEndTile - uiStartTile); },
+        "ezProcessingStreamGroup::ProcessTiles");
+    }
+    else
+    {
+      ProcessTiles(processors, 0, uiNumTiles);
+    }
+
+    m_bProcessingTiles = false;
+
+    uiFirst = uiEnd;
+  }
+
+  // merge the removals of all tiles, sorted, so that the result doesn't depend on the order in which the tiles were processed
+  const ezUInt32 uiNumRemovedBefore = m_PendingRemoveIndices.GetCount();
+
+  for (auto& tileRemoveIndices : m_TilePendingRemoveIndices)
+  {
+    m_PendingRemoveIndices.PushBackRange(tileRemoveIndices);
+    tileRemoveIndices.Clear();
+  }
+
+  if (m_PendingRemoveIndices.GetCount() > uiNumRemovedBefore)
+  {
+    m_PendingRemoveIndices.Sort();
+
+    // non tile safe processors may have removed the same elements
+    ezUInt32 uiNumUnique = 1;
+    for (ezUInt32 i = 1; i < m_PendingRemoveIndices.GetCount(); ++i)
+    {
+      if (m_PendingRemoveIndices[i] != m_PendingRemoveIndices[uiNumUnique - 1])
+      {
+        m_PendingRemoveIndices[uiNumUnique++] = m_PendingRemoveIndices[i];
+      }
+    }
+
+    m_PendingRemoveIndices.SetCountUninitialized(uiNumUnique);
+  }
+}
+
+void ezProcessingStreamGroup::ProcessTiles(ezArrayPtr<ezProcessingStreamProcessor* const> processors, ezUInt64 uiFirstTile, ezUInt64 uiNumTiles)
+{
+  for (ezUInt64 uiTile = uiFirstTile; uiTile < uiFirstTile + uiNumTiles; ++uiTile)
+  {
+    const ezUInt64 uiStartIndex = uiTile * m_uiTileSize;
+    const ezUInt64 uiNumElements = ezMath::Min(m_uiTileSize, m_uiNumActiveElements - uiStartIndex);
+
+    for (ezProcessingStreamProcessor* pStreamProcessor : processors)
+    {
+      pStreamProcessor->ProcessTile(uiStartIndex, uiNumElements);
+    }
+  }
+}
+
 void ezProcessingStreamGroup::RunPendingDeletions()
 {
   ezStreamGroupElementRemovedEvent e;
@@ -257,6 +367,15 @@ void ezProcessingStreamGroup::EnsureStreamAssignmentValid()
       pStreamProcessor->UpdateStreamBindings().IgnoreResult();
     }
 
+    // a tile should fit into the L1 cache with the data of all streams, the start of every tile stays aligned
+    ezUInt64 uiBytesPerElement = 0;
+    for (ezProcessingStream* pStream : m_DataStreams)
+    {
+      uiBytesPerElement += pStream->GetElementStride();
+    }
+
+    m_uiTileSize = ezMath::Max<ezUInt64>(32 * 1024 / ezMath::Max<ezUInt64>(uiBytesPerElement, 1), 64) & ~ezUInt64(15);
+
     m_bStreamAssignmentDirty = false;
   }
 }
@@ -18,6 +18,11 @@ ezProcessingStreamProcessor::~ezProcessingStreamProcessor()
   m_pStreamGroup = nullptr;
 }
 
+void ezProcessingStreamProcessor::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_REPORT_FAILURE("'{}' is flagged as tile safe, but doesn't implement ProcessTile().", GetDynamicRTTI()->GetTypeName());
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_DataProcessing_Stream_Implementation_ProcessingStreamProcessor);
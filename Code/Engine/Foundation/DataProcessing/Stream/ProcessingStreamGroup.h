@@ -3,8 +3,10 @@
 
 #include <Foundation/Basics.h>
 #include <Foundation/Communication/Event.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStream.h>
+#include <Foundation/Threading/Mutex.h>
 
 class ezProcessingStreamProcessor;
 class ezProcessingStreamGroup;
@@ -30,6 +32,14 @@ public:
   /// \brief Destructor
   ~ezProcessingStreamGroup();
 
+  /// \brief How Process() executes the stream processors.
+  enum class ExecutionMode
+  {
+    Sequential,    ///< Every processor processes all elements before the next processor runs.
+    Tiled,         ///< Consecutive tile safe processors (see ezProcessingStreamProcessor::IsTileSafe()) all process one cache-sized tile of elements before moving on to the next tile.
+    TiledParallel, ///< Like Tiled, but the tiles are distributed across the ezTaskSystem worker threads. Process() waits for the tasks, so it must not be called from a task that never waits.
+  };
+
   void Clear();
 
   /// \brief Adds a stream processor to the stream group.
@@ -67,6 +77,18 @@ public:
   /// \brief Runs the stream processors which have been added to the stream group.
   void Process();
 
+  /// \brief Sets how Process() executes the stream processors. Sequential by default.
+  ///
+  /// In the tiled modes, elements removed by tile safe processors are removed in ascending order, independent of the order of the
+  /// RemoveElement() calls. So the result doesn't depend on how the tiles were scheduled.
+  void SetExecutionMode(ExecutionMode mode) { m_ExecutionMode = mode; }
+
+  /// \brief Returns the mode set with SetExecutionMode().
+  ExecutionMode GetExecutionMode() const { return m_ExecutionMode; }
+
+  /// \brief Returns the number of elements per tile in the tiled execution modes, which depends on the size of all streams.
+  ezUInt64 GetTileSize() const { return m_uiTileSize; }
+
   /// \brief Returns the number of elements the streams store.
   inline ezUInt64 GetNumElements() const { return m_uiNumElements; }
 
@@ -89,6 +111,10 @@ private:
 
   void SortProcessorsByPriority();
 
+  void ProcessTiled();
+
+  void ProcessTiles(ezArrayPtr<ezProcessingStreamProcessor* const> processors, ezUInt64 uiFirstTile, ezUInt64 uiNumTiles);
+
   ezHybridArray<ezProcessingStreamProcessor*, 8> m_Processors;
 
   ezHybridArray<ezProcessingStream*, 8> m_DataStreams;
@@ -104,4 +130,13 @@ private:
   ezUInt64 m_uiHighestNumActiveElements;
 
   bool m_bStreamAssignmentDirty;
+
+  ExecutionMode m_ExecutionMode = ExecutionMode::Sequential;
+
+  ezUInt64 m_uiTileSize = 0;
+
+  // while tiles are processed, elements are removed per tile, since every tile is only processed by one thread
+  bool m_bProcessingTiles = false;
+  ezDynamicArray<ezDynamicArray<ezUInt64>> m_TilePendingRemoveIndices;
+  ezMutex m_TileSpawnMutex;
 };
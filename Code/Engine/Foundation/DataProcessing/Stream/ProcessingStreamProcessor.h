@@ -21,6 +21,9 @@ public:
   /// Used for sorting processors, to ensure a certain order. Lower priority == executed first.
   float m_fPriority = 0.0f;
 
+  /// \brief Whether the processor implements ProcessTile() and can thus be executed tile by tile, see ezProcessingStreamGroup::SetExecutionMode().
+  bool IsTileSafe() const { return m_bTileSafe; }
+
 protected:
   friend class ezProcessingStreamGroup;
 
@@ -35,7 +38,18 @@ protected:
   /// \brief The actual method which processes the data, will be called with the number of elements to process.
   virtual void Process(ezUInt64 uiNumElements) = 0;
 
+  /// \brief Processes only the elements in the range [uiStartIndex; uiStartIndex + uiNumElements).
+  ///
+  /// This is called instead of Process() when the stream group uses a tiled execution mode and m_bTileSafe is set.
+  /// Different tiles may be processed concurrently, so the implementation must only access the elements of its range
+  /// and must not modify any state of the processor itself. ezProcessingStreamGroup::RemoveElement() and ezProcessingStreamGroup::InitializeElements()
+  /// may be called, but only elements inside the range may be removed.
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements);
+
   /// \brief Back pointer to the stream group - will be set to the owner stream group when adding the stream processor to the group.
   /// Can be used to get stream pointers in UpdateStreamBindings();
   ezProcessingStreamGroup* m_pStreamGroup = nullptr;
+
+  /// \brief Set this in derived classes that implement ProcessTile().
+  bool m_bTileSafe = false;
 };
@@ -22,6 +22,12 @@ public:
   // all the source files from disk that should be put into the ezArchive
   ezDeque<SourceEntry> m_Entries;
 
+  /// \brief If enabled, small zstd compressed files are compressed with a dictionary that is shared by all files of the same type.
+  ///
+  /// The dictionaries are built from samples of the files with the same file extension and are stored in the archive.
+  /// This mostly pays off for large amounts of small files of the same type, which compress poorly on their own.
+  bool m_bUseCompressionDictionaries = false;
+
   enum class InclusionMode
   {
     Exclude,               ///< Do not add this file to the archive
@@ -31,6 +37,7 @@ public:
     Compress_zstd_average, ///< Add the file and try out compression. If compression does not help, the file will end up uncompressed in the archive.
     Compress_zstd_high,    ///< Add the file and try out compression. If compression does not help, the file will end up uncompressed in the archive.
     Compress_zstd_highest, ///< Add the file and try out compression. If compression does not help, the file will end up uncompressed in the archive.
+    Compress_zstd_seekable, ///< Add the file with ezArchiveCompressionMode::Compressed_zstd_seekable, for large files of which often only parts are read. If compression does not help, the file will end up uncompressed in the archive.
   };
 
   /// \brief Custom decider whether to include a file into the archive
@@ -46,6 +53,10 @@ public:
   ezResult WriteArchive(ezStringView sFile) const;
 
   /// \brief Writes the previously gathered files to the file stream
+  ///
+  /// Files are read and compressed in parallel on the task system, but written in the order of m_Entries, so the output is deterministic.
+  /// Files with identical content are only stored once, all their entries in the TOC reference the same data.
+  /// See m_bUseCompressionDictionaries for compressing small files with shared dictionaries.
   ezResult WriteArchive(ezStreamWriter& inout_stream) const;
 
 protected:
@@ -55,4 +66,6 @@ protected:
   virtual bool WriteFileProgressCallback(ezUInt64 bytesWritten, ezUInt64 bytesTotal) const;
   /// Override this to get a callback after a file has been processed. Gets additional information about the compression result and duration.
   virtual void WriteFileResultCallback(ezUInt32 uiCurEntry, ezUInt32 uiMaxEntries, ezStringView sSourceFile, ezUInt64 uiSourceSize, ezUInt64 uiStoredSize, ezTime duration) const {}
+  /// Override this to get a callback when a file was not stored, because it has the same content as a previously written file. \a uiStoredSize is the amount of bytes that were saved.
+  virtual void WriteFileDeduplicatedCallback(ezUInt32 uiCurEntry, ezUInt32 uiMaxEntries, ezStringView sSourceFile, ezStringView sDuplicateOfFile, ezUInt64 uiSourceSize, ezUInt64 uiStoredSize) const {}
 };
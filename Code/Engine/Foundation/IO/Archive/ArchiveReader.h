@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/MemoryMappedFile.h>
 #include <Foundation/Types/UniquePtr.h>
 
@@ -30,9 +31,19 @@ public:
   /// \brief Sets up \a memReader for reading the raw (potentially compressed) data that is stored for the given entry in the archive.
   void ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawMemoryStreamReader& ref_memReader) const;
 
+  /// \brief Returns a pointer to the raw (potentially compressed) data that is stored for the given entry.
+  ///
+  /// The size of the data is ezArchiveEntry::m_uiStoredDataSize.
+  const void* GetEntryRawData(ezUInt32 uiEntryIdx) const;
+
   /// \brief Creates a reader that will decompress the given file entry.
   ezUniquePtr<ezStreamReader> CreateEntryReader(ezUInt32 uiEntryIdx) const;
 
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  /// \brief Returns the prepared compression dictionary that is needed to decompress the given entry, or nullptr if it doesn't use one.
+  const ezCompressionDictionaryZstd* GetEntryDictionary(ezUInt32 uiEntryIdx) const;
+#endif
+
 protected:
   /// \brief Called by ExtractAllFiles() for progress reporting. Return false to abort.
   virtual bool ExtractNextFileCallback(ezUInt32 uiCurEntry, ezUInt32 uiMaxEntries, ezStringView sSourceFile) const;
@@ -45,4 +56,9 @@ protected:
   ezUInt8 m_uiArchiveVersion = 0;
   const void* m_pDataStart = nullptr;
   ezUInt64 m_uiMemFileSize = 0;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  /// The dictionaries from ezArchiveTOC::m_CompressionDictionaries, prepared once for all readers.
+  ezDynamicArray<ezUniquePtr<ezCompressionDictionaryZstd>> m_CompressionDictionaries;
+#endif
 };
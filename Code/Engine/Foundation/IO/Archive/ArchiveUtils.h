@@ -10,6 +10,7 @@ class ezMemoryMappedFile;
 class ezArchiveTOC;
 class ezArchiveEntry;
 class ezRawMemoryStreamReader;
+class ezCompressionDictionaryZstd;
 
 /// \brief Utilities for working with ezArchive files
 namespace ezArchiveUtils
@@ -85,7 +86,8 @@ namespace ezArchiveUtils
   /// \brief Creates a new stream reader which allows to read the uncompressed data for the given archive entry.
   ///
   /// Under the hood it may create different types of stream readers to uncompress or decode the data.
-  EZ_FOUNDATION_DLL ezUniquePtr<ezStreamReader> CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData);
+  /// If the entry references a compression dictionary, the prepared dictionary has to be passed in and must outlive the reader.
+  EZ_FOUNDATION_DLL ezUniquePtr<ezStreamReader> CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData, const ezCompressionDictionaryZstd* pDictionary = nullptr);
 
   EZ_FOUNDATION_DLL ezResult ReadZipHeader(ezStreamReader& inout_stream, ezUInt8& out_uiVersion);
   EZ_FOUNDATION_DLL ezResult ExtractZipTOC(const ezMemoryMappedFile& memFile, ezArchiveTOC& ref_toc);
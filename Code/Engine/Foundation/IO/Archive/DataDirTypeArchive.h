@@ -6,6 +6,7 @@
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
 #include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/SeekableCompressedStreamZstd.h>
 #include <Foundation/Time/Timestamp.h>
 
 class ezArchiveEntry;
@@ -14,6 +15,7 @@ namespace ezDataDirectory
 {
   class ArchiveReaderUncompressed;
   class ArchiveReaderZstd;
+  class ArchiveReaderZstdSeekable;
   class ArchiveReaderZip;
 
   class EZ_FOUNDATION_DLL ArchiveType : public ezDataDirectoryType
@@ -51,6 +53,8 @@ namespace ezDataDirectory
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZstd>, 4> m_ReadersZstd;
     ezHybridArray<ArchiveReaderZstd*, 4> m_FreeReadersZstd;
+    ezHybridArray<ezUniquePtr<ArchiveReaderZstdSeekable>, 4> m_ReadersZstdSeekable;
+    ezHybridArray<ArchiveReaderZstdSeekable*, 4> m_FreeReadersZstdSeekable;
 #endif
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZip>, 4> m_ReadersZip;
@@ -104,8 +108,34 @@ namespace ezDataDirectory
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
     virtual void InternalClose() override;
 
+    friend class ArchiveType;
+
+    const ezCompressionDictionaryZstd* m_pDictionary = nullptr;
     ezCompressedStreamReaderZstd m_CompressedStreamReader;
   };
+
+  /// \brief Reads entries that are stored with ezArchiveCompressionMode::Compressed_zstd_seekable.
+  ///
+  /// Skipping over data doesn't decompress it, so parts of large files can be read without decompressing everything before them.
+  class EZ_FOUNDATION_DLL ArchiveReaderZstdSeekable : public ArchiveReaderCommon
+  {
+    EZ_DISALLOW_COPY_AND_ASSIGN(ArchiveReaderZstdSeekable);
+
+  public:
+    ArchiveReaderZstdSeekable(ezInt32 iDataDirUserData);
+
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
+    virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+
+  protected:
+    virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
+    virtual void InternalClose() override;
+
+    friend class ArchiveType;
+
+    const void* m_pRawData = nullptr;
+    ezSeekableCompressedStreamReaderZstd m_CompressedStreamReader;
+  };
 #endif
 
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
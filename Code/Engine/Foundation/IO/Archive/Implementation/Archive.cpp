@@ -1,6 +1,8 @@
 #include <Foundation/FoundationPCH.h>
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Logging/Log.h>
 
 void operator<<(ezStreamWriter& inout_stream, const ezArchiveStoredString& value)
@@ -85,6 +87,40 @@ ezResult ezArchiveTOC::Serialize(ezStreamWriter& inout_stream) const
 
   EZ_SUCCEED_OR_RETURN(inout_stream.WriteArray(m_AllPathStrings));
 
+  // since archive version 5
+  {
+    inout_stream << m_CompressionDictionaries.GetCount();
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    ezDynamicArray<ezUInt8> compressed;
+
+    // dictionaries are made up of typical file content, so they compress well themselves
+    for (const auto& dictionary : m_CompressionDictionaries)
+    {
+      compressed.Clear();
+
+      {
+        ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&compressed);
+        ezMemoryStreamWriter writer(&storage);
+        ezCompressedStreamWriterZstd zstdWriter(&writer, 0, ezCompressedStreamWriterZstd::Compression::Highest);
+        EZ_SUCCEED_OR_RETURN(zstdWriter.WriteBytes(dictionary.GetData(), dictionary.GetCount()));
+        EZ_SUCCEED_OR_RETURN(zstdWriter.FinishCompressedStream());
+      }
+
+      inout_stream << dictionary.GetCount();
+      EZ_SUCCEED_OR_RETURN(inout_stream.WriteArray(compressed));
+    }
+#else
+    EZ_ASSERT_DEV(m_CompressionDictionaries.IsEmpty(), "Compression dictionaries require zstd support.");
+#endif
+
+    // stored separately, so that the entry format stays the same
+    for (const auto& entry : m_Entries)
+    {
+      inout_stream << entry.m_uiDictionaryIndex;
+    }
+  }
+
   return EZ_SUCCESS;
 }
 
@@ -117,7 +153,7 @@ struct ezHashHelper<ezOldTempHashedString>
 
 ezResult ezArchiveTOC::Deserialize(ezStreamReader& inout_stream, ezUInt8 uiArchiveVersion)
 {
-  EZ_ASSERT_ALWAYS(uiArchiveVersion <= 4, "Unsupported archive version {}", uiArchiveVersion);
+  EZ_ASSERT_ALWAYS(uiArchiveVersion <= 5, "Unsupported archive version {}", uiArchiveVersion);
 
   // we don't use the TOC version anymore, but the archive version instead
   const ezTypeVersion version = inout_stream.ReadVersion(2);
@@ -151,6 +187,54 @@ ezResult ezArchiveTOC::Deserialize(ezStreamReader& inout_stream, ezUInt8 uiArchi
 
   EZ_SUCCEED_OR_RETURN(inout_stream.ReadArray(m_AllPathStrings));
 
+  m_CompressionDictionaries.Clear();
+
+  if (uiArchiveVersion >= 5)
+  {
+    ezUInt32 uiNumDictionaries = 0;
+    inout_stream >> uiNumDictionaries;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    m_CompressionDictionaries.SetCount(uiNumDictionaries);
+
+    ezDynamicArray<ezUInt8> compressed;
+
+    for (auto& dictionary : m_CompressionDictionaries)
+    {
+      ezUInt32 uiDictionarySize = 0;
+      inout_stream >> uiDictionarySize;
+      EZ_SUCCEED_OR_RETURN(inout_stream.ReadArray(compressed));
+
+      ezRawMemoryStreamReader reader(compressed);
+      ezCompressedStreamReaderZstd zstdReader(&reader);
+
+      dictionary.SetCountUninitialized(uiDictionarySize);
+      if (zstdReader.ReadBytes(dictionary.GetData(), uiDictionarySize) != uiDictionarySize)
+      {
+        ezLog::Error("Archive is corrupt. Invalid compression dictionary.");
+        return EZ_FAILURE;
+      }
+    }
+#else
+    if (uiNumDictionaries > 0)
+    {
+      ezLog::Error("Archive uses compression dictionaries, but zstd support is not compiled in.");
+      return EZ_FAILURE;
+    }
+#endif
+
+    for (auto& entry : m_Entries)
+    {
+      inout_stream >> entry.m_uiDictionaryIndex;
+
+      if (entry.m_uiDictionaryIndex != ezInvalidIndex && entry.m_uiDictionaryIndex >= uiNumDictionaries)
+      {
+        ezLog::Error("Archive is corrupt. Invalid entry dictionary index.");
+        return EZ_FAILURE;
+      }
+    }
+  }
+
   if (bRecreateStringHashes)
   {
     ezLog::Info("Archive uses older string hashing, recomputing hashes.");
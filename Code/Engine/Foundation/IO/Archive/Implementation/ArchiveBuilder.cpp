@@ -1,11 +1,16 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/Algorithm/HashStream.h>
 #include <Foundation/IO/Archive/ArchiveBuilder.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/OSFile.h>
+#include <Foundation/IO/SeekableCompressedStreamZstd.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 
 void ezArchiveBuilder::AddFolder(ezStringView sAbsFolderPath, ezArchiveCompressionMode defaultMode /*= ezArchiveCompressionMode::Uncompressed*/, InclusionCallback callback /*= InclusionCallback()*/)
@@ -63,6 +68,10 @@ void ezArchiveBuilder::AddFolder(ezStringView sAbsFolderPath, ezArchiveCompressi
             compression = ezArchiveCompressionMode::Compressed_zstd;
             iCompressionLevel = static_cast<ezInt32>(ezCompressedStreamWriterZstd::Compression::Highest);
             break;
+          case InclusionMode::Compress_zstd_seekable:
+            compression = ezArchiveCompressionMode::Compressed_zstd_seekable;
+            iCompressionLevel = static_cast<ezInt32>(ezCompressedStreamWriterZstd::Compression::Average);
+            break;
 #  endif
         }
       }
@@ -94,6 +103,237 @@ ezResult ezArchiveBuilder::WriteArchive(ezStringView sFile) const
   return WriteArchive(file);
 }
 
+namespace
+{
+  // Files up to this size are read and compressed in memory on the task system, larger files are streamed and compressed with multiple zstd threads.
+  constexpr ezUInt64 s_uiMaxInMemoryEntrySize = 1024 * 1024 * 8;
+  // Bounds the memory that is needed for the file contents that are processed at the same time.
+  constexpr ezUInt32 s_uiEntriesPerBatch = 64;
+  // Only files up to this size are compressed with a dictionary, larger files have enough content of their own to refer back to.
+  constexpr ezUInt64 s_uiMaxDictionaryEntrySize = 1024 * 64;
+  // The dictionary is stored in the archive as well, so it has to be small compared to the files that use it.
+  constexpr ezUInt32 s_uiFilesPerDictionarySample = 16;
+  constexpr ezUInt32 s_uiMaxDictionarySamples = 64;
+  constexpr ezUInt32 s_uiMaxDictionarySize = 1024 * 64;
+
+  struct ezArchiveContentKey
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiHash0 = 0;
+    ezUInt64 m_uiHash1 = 0;
+    ezUInt64 m_uiSize = 0;
+
+    bool operator==(const ezArchiveContentKey& rhs) const { return m_uiHash0 == rhs.m_uiHash0 && m_uiHash1 == rhs.m_uiHash1 && m_uiSize == rhs.m_uiSize; }
+  };
+
+  struct ezArchiveContentKeyHashHelper
+  {
+    EZ_ALWAYS_INLINE static ezUInt32 Hash(const ezArchiveContentKey& value) { return ezHashingUtils::StringHashTo32(value.m_uiHash0); }
+    EZ_ALWAYS_INLINE static bool Equal(const ezArchiveContentKey& a, const ezArchiveContentKey& b) { return a == b; }
+  };
+
+  struct ezArchiveBuilderEntryData
+  {
+    ezUInt32 m_uiEntryIndex = 0;
+    ezResult m_Result = EZ_SUCCESS;
+    bool m_bInMemory = false;
+    ezUInt32 m_uiDuplicateOf = ezInvalidIndex;
+    ezArchiveContentKey m_Content;
+    ezArchiveCompressionMode m_CompressionMode = ezArchiveCompressionMode::Uncompressed;
+    ezUInt32 m_uiDictionaryIndex = ezInvalidIndex; ///< The dictionary that the data was compressed with.
+    ezDynamicArray<ezUInt8> m_Data;                ///< The file content or the compressed file content, for files that are processed in memory.
+  };
+
+  struct ezArchiveBuilderDictionary
+  {
+    ezDynamicArray<ezUInt8> m_Data;
+    ezUInt32 m_uiTocIndex = ezInvalidIndex; ///< Dictionaries are only added to the TOC once the first entry uses them.
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    ezCompressionDictionaryZstd m_Dictionary;
+#endif
+  };
+
+  constexpr ezUInt64 s_uiContentHashSeed1 = 0x9E3779B97F4A7C15ull;
+
+  void ReadAndHashEntry(const ezArchiveBuilder::SourceEntry& entry, ezArchiveBuilderEntryData& ref_data)
+  {
+    ezFileReader file;
+    if (file.Open(entry.m_sAbsSourcePath, 1024 * 1024).Failed())
+    {
+      ref_data.m_Result = EZ_FAILURE;
+      return;
+    }
+
+    ref_data.m_Content.m_uiSize = file.GetFileSize();
+
+    if (ref_data.m_Content.m_uiSize <= s_uiMaxInMemoryEntrySize)
+    {
+      ref_data.m_bInMemory = true;
+      ref_data.m_Data.SetCountUninitialized(static_cast<ezUInt32>(ref_data.m_Content.m_uiSize));
+
+      if (file.ReadBytes(ref_data.m_Data.GetData(), ref_data.m_Data.GetCount()) != ref_data.m_Data.GetCount())
+      {
+        ref_data.m_Result = EZ_FAILURE;
+        return;
+      }
+
+      ref_data.m_Content.m_uiHash0 = ezHashingUtils::xxHash64(ref_data.m_Data.GetData(), ref_data.m_Data.GetCount());
+      ref_data.m_Content.m_uiHash1 = ezHashingUtils::xxHash64(ref_data.m_Data.GetData(), ref_data.m_Data.GetCount(), s_uiContentHashSeed1);
+    }
+    else
+    {
+      ezHashStreamWriter64 hash0;
+      ezHashStreamWriter64 hash1(s_uiContentHashSeed1);
+
+      ezUInt8 buf[1024 * 32];
+      while (true)
+      {
+        const ezUInt64 uiRead = file.ReadBytes(buf, EZ_ARRAY_SIZE(buf));
+        if (uiRead == 0)
+          break;
+
+        hash0.WriteBytes(buf, uiRead).AssertSuccess();
+        hash1.WriteBytes(buf, uiRead).AssertSuccess();
+      }
+
+      ref_data.m_Content.m_uiHash0 = hash0.GetHashValue();
+      ref_data.m_Content.m_uiHash1 = hash1.GetHashValue();
+    }
+  }
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  /// Builds one dictionary for all zstd compressed entries with the same file extension and compression level.
+  ///
+  /// The dictionaries are raw content, made up of samples of the files that they are used for. Zstd refers back into the
+  /// dictionary content as if it had been compressed just before the file, so all the structure that files of one type share
+  /// doesn't have to be stored over and over again.
+  void BuildDictionaries(const ezDeque<ezArchiveBuilder::SourceEntry>& entries, ezDynamicArray<ezUniquePtr<ezArchiveBuilderDictionary>>& out_dictionaries, ezDynamicArray<ezUInt32>& out_entryDictionaries)
+  {
+    out_entryDictionaries.SetCount(entries.GetCount(), ezInvalidIndex);
+
+    ezHashTable<ezString, ezDynamicArray<ezUInt32>> groups;
+    ezStringBuilder sKey;
+
+    for (ezUInt32 i = 0; i < entries.GetCount(); ++i)
+    {
+      const ezArchiveBuilder::SourceEntry& e = entries[i];
+
+      if (e.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd)
+        continue;
+
+      sKey = ezPathUtils::GetFileExtension(e.m_sRelTargetPath);
+      sKey.ToLower();
+      sKey.AppendFormat(":{}", e.m_iCompressionLevel);
+
+      groups[sKey].PushBack(i);
+    }
+
+    ezDynamicArray<ezUInt8> sample;
+
+    for (auto it = groups.GetIterator(); it.IsValid(); ++it)
+    {
+      const ezDynamicArray<ezUInt32>& group = it.Value();
+
+      if (group.GetCount() < s_uiFilesPerDictionarySample)
+        continue;
+
+      ezUniquePtr<ezArchiveBuilderDictionary> pDictionary = EZ_DEFAULT_NEW(ezArchiveBuilderDictionary);
+
+      // pick the samples evenly from all files of the type
+      const ezUInt32 uiStep = ezMath::Max(s_uiFilesPerDictionarySample, group.GetCount() / s_uiMaxDictionarySamples);
+
+      for (ezUInt32 i = 0; i < group.GetCount() && pDictionary->m_Data.GetCount() < s_uiMaxDictionarySize; i += uiStep)
+      {
+        ezFileReader file;
+        if (file.Open(entries[group[i]].m_sAbsSourcePath).Failed() || file.GetFileSize() > s_uiMaxDictionaryEntrySize)
+          continue;
+
+        sample.SetCountUninitialized(static_cast<ezUInt32>(ezMath::Min<ezUInt64>(file.GetFileSize(), s_uiMaxDictionarySize - pDictionary->m_Data.GetCount())));
+        sample.SetCount(static_cast<ezUInt32>(file.ReadBytes(sample.GetData(), sample.GetCount())));
+
+        pDictionary->m_Data.PushBackRange(sample);
+      }
+
+      const ezInt32 iCompressionLevel = entries[group[0]].m_iCompressionLevel;
+
+      if (pDictionary->m_Dictionary.Create(pDictionary->m_Data, true, (ezCompressedStreamWriterZstd::Compression)iCompressionLevel).Failed())
+        continue;
+
+      for (ezUInt32 uiEntry : group)
+      {
+        out_entryDictionaries[uiEntry] = out_dictionaries.GetCount();
+      }
+
+      out_dictionaries.PushBack(std::move(pDictionary));
+    }
+  }
+#endif
+
+  void CompressEntry(const ezArchiveBuilder::SourceEntry& entry, ezArchiveBuilderEntryData& ref_data, ezUInt32 uiDictionaryIndex, const ezDynamicArray<ezUniquePtr<ezArchiveBuilderDictionary>>& dictionaries)
+  {
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    if (entry.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd && entry.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd_seekable)
+      return;
+
+    if (ref_data.m_Content.m_uiSize > s_uiMaxDictionaryEntrySize)
+    {
+      uiDictionaryIndex = ezInvalidIndex;
+    }
+
+    ezDynamicArray<ezUInt8> compressed;
+
+    if (entry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_seekable)
+    {
+      ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&compressed);
+      ezMemoryStreamWriter writer(&storage);
+
+      ezSeekableCompressedStreamWriterZstd zstdWriter(&writer, (ezCompressedStreamWriterZstd::Compression)entry.m_iCompressionLevel);
+
+      if (zstdWriter.WriteBytes(ref_data.m_Data.GetData(), ref_data.m_Data.GetCount()).Failed() || zstdWriter.FinishCompressedStream().Failed())
+      {
+        ref_data.m_Result = EZ_FAILURE;
+        return;
+      }
+    }
+    else
+    {
+      ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&compressed);
+      ezMemoryStreamWriter writer(&storage);
+
+      ezCompressedStreamWriterZstd zstdWriter;
+
+      if (uiDictionaryIndex != ezInvalidIndex)
+      {
+        zstdWriter.SetDictionary(&dictionaries[uiDictionaryIndex]->m_Dictionary);
+      }
+
+      // the entries are already compressed in parallel, so each one uses a single thread
+      zstdWriter.SetOutputStream(&writer, 0, (ezCompressedStreamWriterZstd::Compression)entry.m_iCompressionLevel);
+
+      if (zstdWriter.WriteBytes(ref_data.m_Data.GetData(), ref_data.m_Data.GetCount()).Failed() || zstdWriter.FinishCompressedStream().Failed())
+      {
+        ref_data.m_Result = EZ_FAILURE;
+        return;
+      }
+    }
+
+    // same rule as ezArchiveUtils::WriteEntryOptimal(): less than 20% size saving -> go uncompressed
+    if (compressed.GetCount() * 12ull < ref_data.m_Data.GetCount() * 10ull)
+    {
+      ref_data.m_Data.Swap(compressed);
+      ref_data.m_CompressionMode = entry.m_CompressionMode;
+      ref_data.m_uiDictionaryIndex = uiDictionaryIndex;
+    }
+#else
+    EZ_IGNORE_UNUSED(entry);
+    EZ_IGNORE_UNUSED(ref_data);
+    EZ_IGNORE_UNUSED(uiDictionaryIndex);
+    EZ_IGNORE_UNUSED(dictionaries);
+#endif
+  }
+} // namespace
+
 ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& inout_stream) const
 {
   EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteHeader(inout_stream));
@@ -105,27 +345,136 @@ ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& inout_stream) const
   ezUInt64 uiStreamSize = 0;
   const ezUInt32 uiNumEntries = m_Entries.GetCount();
 
+  // maps file contents to the index of the first entry that stored them
+  ezHashTable<ezArchiveContentKey, ezUInt32, ezArchiveContentKeyHashHelper> contentToEntry;
+
+  ezDynamicArray<ezArchiveBuilderEntryData> batch;
+
+  ezDynamicArray<ezUniquePtr<ezArchiveBuilderDictionary>> dictionaries;
+  ezDynamicArray<ezUInt32> entryDictionaries;
+  entryDictionaries.SetCount(uiNumEntries, ezInvalidIndex);
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (m_bUseCompressionDictionaries)
+  {
+    BuildDictionaries(m_Entries, dictionaries, entryDictionaries);
+  }
+#endif
+
+  ezParallelForParams parallelForParams;
+  parallelForParams.m_uiBinSize = 1;
+  parallelForParams.m_uiMaxTasksPerThread = 4;
+
   ezStopwatch sw;
 
-  for (ezUInt32 i = 0; i < uiNumEntries; ++i)
+  for (ezUInt32 uiBatchStart = 0; uiBatchStart < uiNumEntries; uiBatchStart += s_uiEntriesPerBatch)
   {
-    const SourceEntry& e = m_Entries[i];
+    const ezUInt32 uiBatchSize = ezMath::Min(s_uiEntriesPerBatch, uiNumEntries - uiBatchStart);
+
+    batch.Clear();
+    batch.SetCount(uiBatchSize);
+
+    for (ezUInt32 i = 0; i < uiBatchSize; ++i)
+    {
+      batch[i].m_uiEntryIndex = uiBatchStart + i;
+    }
+
+    ezTaskSystem::ParallelForSingle(
+      batch.GetArrayPtr(), [this](ezArchiveBuilderEntryData& data)
+      { ReadAndHashEntry(m_Entries[data.m_uiEntryIndex], data); },
+      "ReadArchiveEntries", parallelForParams);
+
+    // Decide in order which entries are duplicates, so that always the first entry with some content stores the data.
+    // Hash collisions are ruled out with two 64 bit hashes of the content and the content size.
+    for (ezArchiveBuilderEntryData& data : batch)
+    {
+      if (data.m_Result.Failed())
+        continue;
+
+      bool bExisted = false;
+      ezUInt32& uiFirstEntry = contentToEntry.FindOrAdd(data.m_Content, &bExisted);
+
+      if (bExisted)
+      {
+        data.m_uiDuplicateOf = uiFirstEntry;
+        data.m_Data.Clear();
+        data.m_Data.Compact();
+      }
+      else
+      {
+        uiFirstEntry = data.m_uiEntryIndex;
+      }
+    }
+
+    ezTaskSystem::ParallelForSingle(
+      batch.GetArrayPtr(), [&](ezArchiveBuilderEntryData& data)
+      {
+        if (data.m_bInMemory && data.m_Result.Succeeded() && data.m_uiDuplicateOf == ezInvalidIndex)
+        {
+          CompressEntry(m_Entries[data.m_uiEntryIndex], data, entryDictionaries[data.m_uiEntryIndex], dictionaries);
+        } },
+      "CompressArchiveEntries", parallelForParams);
+
+    for (ezArchiveBuilderEntryData& data : batch)
+    {
+      const ezUInt32 i = data.m_uiEntryIndex;
+      const SourceEntry& e = m_Entries[i];
 
-    const ezUInt32 uiPathStringOffset = toc.AddPathString(e.m_sRelTargetPath);
+      const ezUInt32 uiPathStringOffset = toc.AddPathString(e.m_sRelTargetPath);
 
-    sHashablePath = e.m_sRelTargetPath;
-    sHashablePath.ToLower();
+      sHashablePath = e.m_sRelTargetPath;
+      sHashablePath.ToLower();
 
-    toc.m_PathToEntryIndex[ezArchiveStoredString(ezHashingUtils::StringHash(sHashablePath), uiPathStringOffset)] = toc.m_Entries.GetCount();
+      toc.m_PathToEntryIndex[ezArchiveStoredString(ezHashingUtils::StringHash(sHashablePath), uiPathStringOffset)] = toc.m_Entries.GetCount();
 
-    if (!WriteNextFileCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath))
-      return EZ_FAILURE;
+      if (!WriteNextFileCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath))
+        return EZ_FAILURE;
 
-    ezArchiveEntry& tocEntry = toc.m_Entries.ExpandAndGetRef();
+      EZ_SUCCEED_OR_RETURN(data.m_Result);
 
-    EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(inout_stream, e.m_sAbsSourcePath, uiPathStringOffset, e.m_CompressionMode, e.m_iCompressionLevel, tocEntry, uiStreamSize, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this)));
+      if (data.m_uiDuplicateOf != ezInvalidIndex)
+      {
+        ezArchiveEntry tocEntry = toc.m_Entries[data.m_uiDuplicateOf];
+        tocEntry.m_uiPathStringOffset = uiPathStringOffset;
+        toc.m_Entries.PushBack(tocEntry);
+
+        WriteFileDeduplicatedCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath, m_Entries[data.m_uiDuplicateOf].m_sAbsSourcePath, tocEntry.m_uiUncompressedDataSize, tocEntry.m_uiStoredDataSize);
+        sw.Checkpoint();
+        continue;
+      }
+
+      ezArchiveEntry& tocEntry = toc.m_Entries.ExpandAndGetRef();
+
+      if (data.m_bInMemory)
+      {
+        EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryPreprocessed(inout_stream, data.m_Data, uiPathStringOffset, data.m_CompressionMode, static_cast<ezUInt32>(data.m_Content.m_uiSize), tocEntry, uiStreamSize));
+
+        if (data.m_uiDictionaryIndex != ezInvalidIndex)
+        {
+          ezArchiveBuilderDictionary& dictionary = *dictionaries[data.m_uiDictionaryIndex];
+
+          if (dictionary.m_uiTocIndex == ezInvalidIndex)
+          {
+            dictionary.m_uiTocIndex = toc.m_CompressionDictionaries.GetCount();
+            toc.m_CompressionDictionaries.PushBack(dictionary.m_Data);
+          }
 
-    WriteFileResultCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath, tocEntry.m_uiUncompressedDataSize, tocEntry.m_uiStoredDataSize, sw.Checkpoint());
+          tocEntry.m_uiDictionaryIndex = dictionary.m_uiTocIndex;
+        }
+
+        if (!WriteFileProgressCallback(data.m_Content.m_uiSize, data.m_Content.m_uiSize))
+          return EZ_FAILURE;
+
+        data.m_Data.Clear();
+        data.m_Data.Compact();
+      }
+      else
+      {
+        EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(inout_stream, e.m_sAbsSourcePath, uiPathStringOffset, e.m_CompressionMode, e.m_iCompressionLevel, tocEntry, uiStreamSize, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this)));
+      }
+
+      WriteFileResultCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath, tocEntry.m_uiUncompressedDataSize, tocEntry.m_uiStoredDataSize, sw.Checkpoint());
+    }
   }
 
   EZ_SUCCEED_OR_RETURN(ezArchiveUtils::AppendTOC(inout_stream, toc));
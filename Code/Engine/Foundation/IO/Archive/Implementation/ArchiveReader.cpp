@@ -71,7 +71,8 @@ ezResult ezArchiveReader::OpenArchive(ezStringView sPath)
         return EZ_FAILURE;
       }
 
-      if (e.m_uiUncompressedDataSize < e.m_uiStoredDataSize)
+      // the seek table of seekable entries is part of the stored data, so very small entries may grow
+      if (e.m_uiUncompressedDataSize < e.m_uiStoredDataSize && e.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd_seekable)
       {
         ezLog::Error("Archive is corrupt. Invalid compression info.");
         return EZ_FAILURE;
@@ -82,8 +83,33 @@ ezResult ezArchiveReader::OpenArchive(ezStringView sPath)
         ezLog::Error("Archive is corrupt. Invalid entry path-string offset.");
         return EZ_FAILURE;
       }
+
+      if (e.m_uiDictionaryIndex != ezInvalidIndex && e.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd)
+      {
+        ezLog::Error("Archive is corrupt. Only zstd compressed entries can use a dictionary.");
+        return EZ_FAILURE;
+      }
+    }
+  }
+
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  // prepare the dictionaries once, so that decompressing an entry does not have to do it again
+  {
+    m_CompressionDictionaries.Clear();
+
+    for (const auto& dictionary : m_ArchiveTOC.m_CompressionDictionaries)
+    {
+      ezUniquePtr<ezCompressionDictionaryZstd>& pDictionary = m_CompressionDictionaries.ExpandAndGetRef();
+      pDictionary = EZ_DEFAULT_NEW(ezCompressionDictionaryZstd);
+
+      if (pDictionary->Create(dictionary).Failed())
+      {
+        ezLog::Error("Archive is corrupt. Invalid compression dictionary.");
+        return EZ_FAILURE;
+      }
     }
   }
+#  endif
 
   return EZ_SUCCESS;
 #else
@@ -123,9 +149,30 @@ void ezArchiveReader::ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawM
 
 ezUniquePtr<ezStreamReader> ezArchiveReader::CreateEntryReader(ezUInt32 uiEntryIdx) const
 {
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  return ezArchiveUtils::CreateEntryReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart, GetEntryDictionary(uiEntryIdx));
+#else
   return ezArchiveUtils::CreateEntryReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart);
+#endif
+}
+
+const void* ezArchiveReader::GetEntryRawData(ezUInt32 uiEntryIdx) const
+{
+  return ezMemoryUtils::AddByteOffset(m_pDataStart, static_cast<std::ptrdiff_t>(m_ArchiveTOC.m_Entries[uiEntryIdx].m_uiDataStartOffset));
 }
 
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+const ezCompressionDictionaryZstd* ezArchiveReader::GetEntryDictionary(ezUInt32 uiEntryIdx) const
+{
+  const ezUInt32 uiDictionaryIndex = m_ArchiveTOC.m_Entries[uiEntryIdx].m_uiDictionaryIndex;
+
+  if (uiDictionaryIndex == ezInvalidIndex)
+    return nullptr;
+
+  return m_CompressionDictionaries[uiDictionaryIndex].Borrow();
+}
+#endif
+
 ezResult ezArchiveReader::ExtractFile(ezUInt32 uiEntryIdx, ezStringView sTargetFolder) const
 {
   ezStringView sFilePath = m_ArchiveTOC.GetEntryPathString(uiEntryIdx);
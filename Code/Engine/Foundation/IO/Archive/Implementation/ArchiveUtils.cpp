@@ -8,6 +8,7 @@
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/MemoryMappedFile.h>
 #include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/SeekableCompressedStreamZstd.h>
 #include <Foundation/Logging/Log.h>
 
 ezHybridArray<ezString, 4, ezStaticsAllocatorWrapper>& ezArchiveUtils::GetAcceptedArchiveFileExtensions()
@@ -40,11 +41,12 @@ ezResult ezArchiveUtils::WriteHeader(ezStreamWriter& inout_stream)
   const char* szTag = "EZARCHIVE";
   EZ_SUCCEED_OR_RETURN(inout_stream.WriteBytes(szTag, 10));
 
-  const ezUInt8 uiArchiveVersion = 4;
+  const ezUInt8 uiArchiveVersion = 5;
 
   // Version 2: Added end-of-file marker for file corruption (cutoff) detection
   // Version 3: HashedStrings changed from MurmurHash to xxHash
   // Version 4: use 64 Bit string hashes
+  // Version 5: TOC stores compression dictionaries, added seekable zstd entries
   inout_stream << uiArchiveVersion;
 
   const ezUInt8 uiPadding[5] = {0, 0, 0, 0, 0};
@@ -67,7 +69,7 @@ ezResult ezArchiveUtils::ReadHeader(ezStreamReader& inout_stream, ezUInt8& out_u
   out_uiVersion = 0;
   inout_stream >> out_uiVersion;
 
-  if (out_uiVersion != 1 && out_uiVersion != 2 && out_uiVersion != 3 && out_uiVersion != 4)
+  if (out_uiVersion != 1 && out_uiVersion != 2 && out_uiVersion != 3 && out_uiVersion != 4 && out_uiVersion != 5)
   {
     ezLog::Error("Unsupported archive version '{}'.", out_uiVersion);
     return EZ_FAILURE;
@@ -140,6 +142,7 @@ ezResult ezArchiveUtils::WriteEntry(
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
   ezCompressedStreamWriterZstd zstdWriter;
+  ezSeekableCompressedStreamWriterZstd seekableZstdWriter;
 #endif
 
   switch (compression)
@@ -154,6 +157,13 @@ ezResult ezArchiveUtils::WriteEntry(
       pWriter = &zstdWriter;
     }
     break;
+
+    case ezArchiveCompressionMode::Compressed_zstd_seekable:
+    {
+      seekableZstdWriter.SetOutputStream(&inout_stream, (ezCompressedStreamWriterZstd::Compression)iCompressionLevel);
+      pWriter = &seekableZstdWriter;
+    }
+    break;
 #endif
 
     default:
@@ -190,6 +200,11 @@ ezResult ezArchiveUtils::WriteEntry(
       EZ_SUCCEED_OR_RETURN(zstdWriter.FinishCompressedStream());
       inout_tocEntry.m_uiStoredDataSize = zstdWriter.GetWrittenBytes();
       break;
+
+    case ezArchiveCompressionMode::Compressed_zstd_seekable:
+      EZ_SUCCEED_OR_RETURN(seekableZstdWriter.FinishCompressedStream());
+      inout_tocEntry.m_uiStoredDataSize = seekableZstdWriter.GetWrittenBytes();
+      break;
 #endif
 
     case ezArchiveCompressionMode::Uncompressed:
@@ -252,8 +267,10 @@ public:
 
 #endif
 
-ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData)
+ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData, const ezCompressionDictionaryZstd* pDictionary /*= nullptr*/)
 {
+  EZ_ASSERT_DEV(entry.m_uiDictionaryIndex == ezInvalidIndex || pDictionary != nullptr, "The archive entry needs a compression dictionary.");
+
   ezUniquePtr<ezStreamReader> reader;
 
   switch (entry.m_CompressionMode)
@@ -272,7 +289,21 @@ ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEnt
       reader = EZ_DEFAULT_NEW(ezCompressedStreamReaderZstdWithSource);
       ezCompressedStreamReaderZstdWithSource* pRawReader = static_cast<ezCompressedStreamReaderZstdWithSource*>(reader.Borrow());
       ConfigureRawMemoryStreamReader(entry, pStartOfArchiveData, pRawReader->m_Source);
-      pRawReader->SetInputStream(&pRawReader->m_Source);
+      pRawReader->SetInputStream(&pRawReader->m_Source, pDictionary);
+      break;
+    }
+
+    case ezArchiveCompressionMode::Compressed_zstd_seekable:
+    {
+      ezUniquePtr<ezSeekableCompressedStreamReaderZstd> pSeekableReader = EZ_DEFAULT_NEW(ezSeekableCompressedStreamReaderZstd);
+
+      if (pSeekableReader->SetInputData(ezMemoryUtils::AddByteOffset(pStartOfArchiveData, static_cast<std::ptrdiff_t>(entry.m_uiDataStartOffset)), entry.m_uiStoredDataSize).Failed())
+      {
+        EZ_REPORT_FAILURE("Archive entry has an invalid seek table");
+        break;
+      }
+
+      reader = std::move(pSeekableReader);
       break;
     }
 #endif
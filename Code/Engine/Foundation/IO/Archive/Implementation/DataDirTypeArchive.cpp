@@ -85,6 +85,25 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(ezStringView
           m_ReadersZstd.PushBack(EZ_DEFAULT_NEW(ArchiveReaderZstd, 1));
           pReader = m_ReadersZstd.PeekBack().Borrow();
         }
+
+        static_cast<ArchiveReaderZstd*>(pReader)->m_pDictionary = m_ArchiveReader.GetEntryDictionary(uiEntryIndex);
+        break;
+      }
+
+      case ezArchiveCompressionMode::Compressed_zstd_seekable:
+      {
+        if (!m_FreeReadersZstdSeekable.IsEmpty())
+        {
+          pReader = m_FreeReadersZstdSeekable.PeekBack();
+          m_FreeReadersZstdSeekable.PopBack();
+        }
+        else
+        {
+          m_ReadersZstdSeekable.PushBack(EZ_DEFAULT_NEW(ArchiveReaderZstdSeekable, 3));
+          pReader = m_ReadersZstdSeekable.PeekBack().Borrow();
+        }
+
+        static_cast<ArchiveReaderZstdSeekable*>(pReader)->m_pRawData = m_ArchiveReader.GetEntryRawData(uiEntryIndex);
         break;
       }
 #endif
@@ -245,6 +264,12 @@ void ezDataDirectory::ArchiveType::OnReaderWriterClose(ezDataDirectoryReaderWrit
     m_FreeReadersZstd.PushBack(static_cast<ArchiveReaderZstd*>(pClosed));
     return;
   }
+
+  if (pClosed->GetDataDirUserData() == 3)
+  {
+    m_FreeReadersZstdSeekable.PushBack(static_cast<ArchiveReaderZstdSeekable*>(pClosed));
+    return;
+  }
 #endif
 
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
@@ -318,7 +343,7 @@ ezResult ezDataDirectory::ArchiveReaderZstd::InternalOpen(ezFileShareMode::Enum
 {
   EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
 
-  m_CompressedStreamReader.SetInputStream(&m_MemStreamReader);
+  m_CompressedStreamReader.SetInputStream(&m_MemStreamReader, m_pDictionary);
   return EZ_SUCCESS;
 }
 
@@ -326,6 +351,35 @@ void ezDataDirectory::ArchiveReaderZstd::InternalClose()
 {
   // nothing to do
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+ezDataDirectory::ArchiveReaderZstdSeekable::ArchiveReaderZstdSeekable(ezInt32 iDataDirUserData)
+  : ArchiveReaderCommon(iDataDirUserData)
+{
+}
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdSeekable::Skip(ezUInt64 uiBytes)
+{
+  return m_CompressedStreamReader.SkipBytes(uiBytes);
+}
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdSeekable::Read(void* pBuffer, ezUInt64 uiBytes)
+{
+  return m_CompressedStreamReader.ReadBytes(pBuffer, uiBytes);
+}
+
+ezResult ezDataDirectory::ArchiveReaderZstdSeekable::InternalOpen(ezFileShareMode::Enum FileShareMode)
+{
+  EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
+
+  return m_CompressedStreamReader.SetInputData(m_pRawData, m_uiCompressedSize);
+}
+
+void ezDataDirectory::ArchiveReaderZstdSeekable::InternalClose()
+{
+  // nothing to do
+}
 #endif
 
 //////////////////////////////////////////////////////////////////////////
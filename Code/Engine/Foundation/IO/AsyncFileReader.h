@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Threading/ConditionVariable.h>
+#include <Foundation/Types/Delegate.h>
+#include <Foundation/Types/UniquePtr.h>
+
+class ezAsyncFileReaderBackend;
+
+/// \brief Describes a single read operation that is executed by ezAsyncFileReader.
+struct ezAsyncFileRead
+{
+  ezStringView m_sAbsolutePath;   ///< The file to read from. The string is copied, so it only needs to stay valid until Submit() returns.
+  ezUInt64 m_uiOffset = 0;        ///< The byte offset in the file at which to start reading.
+  ezUInt64 m_uiSize = 0;          ///< The number of bytes to read.
+  void* m_pDestination = nullptr; ///< Receives the data. Must be able to hold m_uiSize bytes and stay valid until the read has completed.
+  void* m_pUserData = nullptr;    ///< Not used by ezAsyncFileReader, passed through to the completion callback.
+};
+
+/// \brief Executes many file reads in the background and reports each finished read through a callback.
+///
+/// Reads are queued with Submit() and executed by a backend, which keeps up to a configurable number of reads in flight at the same time.
+/// This allows to saturate fast disks, which a single thread doing one blocking read after the other can't do.
+///
+/// On Linux the reads are executed through io_uring, if the kernel supports it. Everywhere else (or when requested explicitly),
+/// a small pool of threads executes blocking reads.
+///
+/// The completion callback is executed on one of the backend's threads. With io_uring all callbacks are serialized on the single thread
+/// that owns the ring, so a slow callback delays every other read. With the thread pool, callbacks for different reads may run concurrently.
+/// Either way the callback should not do much more than handing the data over to someone else, e.g. by starting a task or raising a signal.
+///
+/// If io_uring stops working while reads are in flight, those reads are reported as failed and all further reads are executed
+/// by the thread pool.
+class EZ_FOUNDATION_DLL ezAsyncFileReader
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezAsyncFileReader);
+
+public:
+  /// \brief Called for every finished read.
+  ///
+  /// \a uiBytesRead is smaller than the requested size if the file ended before. If the file could not be opened or read, \a result is EZ_FAILURE.
+  using CompletionCallback = ezDelegate<void(const ezAsyncFileRead& read, ezUInt64 uiBytesRead, ezResult result)>;
+
+  enum class Backend
+  {
+    Default,    ///< Uses io_uring where available and falls back to ThreadPool otherwise.
+    ThreadPool, ///< Executes blocking reads on a pool of threads owned by the reader.
+  };
+
+  /// \brief Starts the backend. Up to \a uiMaxReadsInFlight reads are executed at the same time.
+  ezAsyncFileReader(ezUInt32 uiMaxReadsInFlight = 32, Backend backend = Backend::Default);
+
+  /// \brief Waits for all submitted reads to finish and shuts the backend down.
+  ~ezAsyncFileReader();
+
+  /// \brief Queues the given reads and returns immediately. \a callback is executed once for every read.
+  void Submit(ezArrayPtr<const ezAsyncFileRead> reads, CompletionCallback callback);
+
+  /// \brief Blocks until all reads that were submitted so far have finished and their callbacks have returned.
+  void WaitForAll();
+
+  /// \brief Returns the number of reads that were submitted but have not finished yet.
+  ezUInt32 GetNumPendingReads() const;
+
+  /// \brief Returns the maximum number of reads that are executed at the same time.
+  ezUInt32 GetMaxReadsInFlight() const { return m_uiMaxReadsInFlight; }
+
+  /// \brief Returns whether the reads are executed through io_uring, rather than by a thread pool.
+  ///
+  /// This still returns true after io_uring failed at runtime and the reader has switched over to the thread pool.
+  bool UsesIoUring() const { return m_bUsesIoUring; }
+
+private:
+  friend class ezAsyncFileReaderBackend;
+
+  struct QueuedRead
+  {
+    ezString m_sAbsolutePath;
+    ezAsyncFileRead m_Read;
+    CompletionCallback m_Callback;
+  };
+
+  bool DequeueRead(QueuedRead& out_read);
+  void FinishRead(const QueuedRead& read, ezUInt64 uiBytesRead, ezResult result);
+  ezUInt32 GetNumQueuedReads() const;
+
+  ezUInt32 m_uiMaxReadsInFlight = 0;
+  bool m_bUsesIoUring = false;
+
+  mutable ezConditionVariable m_QueueCondition;
+  ezDeque<QueuedRead> m_Queue;
+  ezUInt32 m_uiNumPendingReads = 0;
+
+  ezUniquePtr<ezAsyncFileReaderBackend> m_pBackend;
+};
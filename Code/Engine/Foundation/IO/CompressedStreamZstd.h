@@ -7,6 +7,8 @@
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
 
+class ezCompressionDictionaryZstd;
+
 /// \brief A stream reader that will decompress data that was stored using the ezCompressedStreamWriterZstd.
 ///
 /// The reader takes another reader as its source for the compressed data (e.g. a file or a memory stream).
@@ -24,7 +26,10 @@ public:
   ///
   /// Calling this a second time on the same instance is valid and allows to reuse the decoder, which is more efficient than creating a new
   /// one.
-  void SetInputStream(ezStreamReader* pInputStream); // [tested]
+  ///
+  /// If the data was compressed with a dictionary, the same dictionary has to be passed in here. It must stay alive until the reader
+  /// is done with the stream.
+  void SetInputStream(ezStreamReader* pInputStream, const ezCompressionDictionaryZstd* pDictionary = nullptr); // [tested]
 
   /// \brief Reads either uiBytesToRead or the amount of remaining bytes in the stream into pReadBuffer.
   ///
@@ -94,6 +99,12 @@ public:
   /// allocate internal structures once that final decision is made.
   void SetOutputStream(ezStreamWriter* pOutputStream, ezUInt32 uiMaxNumWorkerThreads, Compression ratio = Compression::Default, ezUInt32 uiCompressionCacheSizeKB = 4); // [tested]
 
+  /// \brief Sets the dictionary that is used for all streams that are set up with SetOutputStream() afterwards.
+  ///
+  /// The dictionary must have been created with compression enabled and must stay alive until the stream is finished.
+  /// Pass nullptr to go back to compressing without a dictionary. The compression level of the dictionary takes precedence.
+  void SetDictionary(const ezCompressionDictionaryZstd* pDictionary) { m_pDictionary = pDictionary; }
+
   /// \brief Compresses \a uiBytesToWrite from \a pWriteBuffer.
   ///
   /// Will output bursts of 256 bytes to the output stream every once in a while.
@@ -148,10 +159,48 @@ private:
   };
 
   ezStreamWriter* m_pOutputStream = nullptr;
+  const ezCompressionDictionaryZstd* m_pDictionary = nullptr;
   /*ZSTD_CStream*/ void* m_pZstdCStream = nullptr;
   /*ZSTD_outBuffer*/ OutBufferImpl m_OutBuffer;
 
   ezDynamicArray<ezUInt8> m_CompressedCache;
 };
 
+/// \brief A prepared zstd dictionary for ezCompressedStreamWriterZstd and ezCompressedStreamReaderZstd.
+///
+/// Small pieces of data compress badly on their own, because the compressor has nothing to refer back to.
+/// If many of them share content (e.g. assets of the same type), compressing them with a dictionary of that typical content
+/// gives much better results and speeds up decompression. The same dictionary data is needed for compression and decompression.
+///
+/// Preparing a dictionary is costly, so it should be done once and then be used for many streams. Once created, it may be used
+/// by multiple streams on different threads at the same time.
+class EZ_FOUNDATION_DLL ezCompressionDictionaryZstd
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezCompressionDictionaryZstd);
+
+public:
+  ezCompressionDictionaryZstd();
+  ~ezCompressionDictionaryZstd();
+
+  /// \brief Prepares the dictionary from \a dictionaryData.
+  ///
+  /// The data can either be a dictionary in the zstd format or just raw content that the compressed data is likely to share.
+  /// Only if \a bForCompression is set, the dictionary can be passed to ezCompressedStreamWriterZstd::SetDictionary(),
+  /// it is then prepared for the given compression level. It can always be used for decompression.
+  ezResult Create(ezConstByteArrayPtr dictionaryData, bool bForCompression = false, ezCompressedStreamWriterZstd::Compression ratio = ezCompressedStreamWriterZstd::Compression::Default);
+
+  /// \brief Releases the prepared dictionary.
+  void Clear();
+
+  /// \brief Whether Create() was called successfully.
+  bool IsValid() const { return m_pZstdDDict != nullptr; }
+
+private:
+  friend class ezCompressedStreamReaderZstd;
+  friend class ezCompressedStreamWriterZstd;
+
+  /*ZSTD_CDict*/ void* m_pZstdCDict = nullptr;
+  /*ZSTD_DDict*/ void* m_pZstdDDict = nullptr;
+};
+
 #endif // BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Containers/Map.h>
+#include <Foundation/IO/DirectoryWatcher.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
 #include <Foundation/IO/OSFile.h>
+#include <Foundation/Types/UniquePtr.h>
 
 namespace ezDataDirectory
 {
@@ -34,9 +37,23 @@ namespace ezDataDirectory
     /// access.
     static ezString s_sRedirectionPrefix;
 
+    /// If enabled, every folder data directory that is mounted afterwards builds an index of all the files it contains and keeps it up-to-date
+    /// through an ezDirectoryWatcher. Files that are not in the index are reported as missing without asking the OS, which makes looking up
+    /// files that only exist in some of the mounted data directories much cheaper.
+    /// Files that are created or deleted outside of ezFileSystem are picked up in ezFileSystem::PerFrameUpdate(), changes made through
+    /// ezFileSystem are visible right away.
+    /// Only works on platforms that support file iterators and directory watchers, otherwise this setting is ignored.
+    static bool s_bEnablePathIndex;
+
+    /// \brief Returns whether this data directory has built a path index, see s_bEnablePathIndex.
+    bool HasPathIndex() const;
+
     /// \brief When s_sRedirectionFile and s_sRedirectionPrefix are used to enable file redirection, this will reload those config files.
     virtual void ReloadExternalConfigs() override;
 
+    /// \brief Applies the pending directory watcher changes to the path index.
+    virtual void PerFrameUpdate() override;
+
     virtual const ezString128& GetRedirectedDataDirectoryPath() const override { return m_sRedirectedDataDirPath; }
 
   protected:
@@ -61,6 +78,12 @@ namespace ezDataDirectory
 
     void LoadRedirectionFile();
 
+    /// \brief Returns true if the path index knows for sure that the given file does not exist. Always returns false if there is no index.
+    bool IsMissingInPathIndex(ezStringView sFile);
+    void AddToPathIndex(ezStringView sFile);
+    void RemoveFromPathIndex(ezStringView sFile);
+    void BuildPathIndex();
+
     mutable ezMutex m_ReaderWriterMutex; ///< Locks m_Readers / m_Writers as well as the m_bIsInUse flag of each reader / writer.
     ezHybridArray<ezDataDirectory::FolderReader*, 4> m_Readers;
     ezHybridArray<ezDataDirectory::FolderWriter*, 4> m_Writers;
@@ -68,6 +91,15 @@ namespace ezDataDirectory
     mutable ezMutex m_RedirectionMutex;
     ezMap<ezString, ezString> m_FileRedirection;
     ezString128 m_sRedirectedDataDirPath;
+
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+    void CollectPathIndexKeys(ezStringView sAbsoluteFolder, ezDynamicArray<ezString>& out_keys) const;
+    void ApplyPathIndexChanges();
+
+    mutable ezMutex m_PathIndexMutex;
+    ezUniquePtr<ezDirectoryWatcher> m_pPathIndexWatcher;
+    ezHashSet<ezString> m_PathIndex;
+#endif
   };
 
 
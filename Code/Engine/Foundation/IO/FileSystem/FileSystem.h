@@ -135,6 +135,11 @@ public:
   /// \brief Calls ezDataDirectoryType::ReloadExternalConfigs() on all active data directories.
   static void ReloadAllExternalDataDirectoryConfigs();
 
+  /// \brief Calls ezDataDirectoryType::PerFrameUpdate() on all active data directories. Should be called once per frame.
+  ///
+  /// The data directories are updated without holding the file system mutex, so file accesses on other threads are not blocked.
+  static void PerFrameUpdate();
+
   ///@}
   /// \name Special Directories
   ///@{
@@ -327,6 +332,24 @@ private:
 
   static DataDirectoryInfo* GetDataDirForRoot(const ezString& sRoot);
 
+  struct DataDirLookup
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezDataDirectoryType* m_pDataDirectory;
+    ezStringView m_sRelPath;
+  };
+
+  using DataDirLookupArray = ezHybridArray<DataDirLookup, 16>;
+
+  /// \brief Collects all data directories that need to be checked for the given path, highest priority first.
+  ///
+  /// Only this step locks the file system mutex. The returned data directories stay alive, even if they get removed in the meantime,
+  /// until ReleaseDataDirectories() is called.
+  static void AcquireDataDirectoriesForLookup(ezStringView sPath, ezStringView sRootName, DataDirLookupArray& out_dataDirs);
+  static void ReleaseDataDirectories(const DataDirLookupArray& dataDirs);
+  static void ReleaseDataDirectory(ezDataDirectoryType* pDataDir);
+
   static void CleanUpRootName(ezStringBuilder& sRoot);
 
   static ezString s_sSdkRootDir;
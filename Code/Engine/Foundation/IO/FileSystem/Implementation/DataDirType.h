@@ -3,6 +3,7 @@
 #include <Foundation/Basics.h>
 #include <Foundation/IO/FileEnums.h>
 #include <Foundation/Strings/String.h>
+#include <Foundation/Threading/AtomicInteger.h>
 
 class ezDataDirectoryReaderWriterBase;
 class ezDataDirectoryReader;
@@ -36,6 +37,10 @@ public:
   ///        reloading and reapplying of configurations, without dismounting and remounting the data directory.
   virtual void ReloadExternalConfigs() {};
 
+  /// \brief Called once per frame through ezFileSystem::PerFrameUpdate(). Allows data directory types to process work that
+  ///        should not be done during file lookups, e.g. applying changes reported by a directory watcher.
+  virtual void PerFrameUpdate() {}
+
 protected:
   friend class ezFileSystem;
 
@@ -99,6 +104,11 @@ protected:
 
   /// \brief Derived classes can use 'GetDataDirectoryPath' to access this data.
   ezString128 m_sDataDirectoryPath;
+
+private:
+  /// \brief The file system holds one reference while the data directory is mounted and one for every lookup that is in progress.
+  /// RemoveDataDirectory() is called when the last reference is released.
+  ezAtomicInteger32 m_iFileSystemReferences = 1;
 };
 
 
@@ -19,10 +19,24 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, FolderDataDirectory)
 EZ_END_SUBSYSTEM_DECLARATION;
 // clang-format on
 
+namespace
+{
+  void GetPathIndexKey(ezStringView sFile, ezStringBuilder& out_sKey)
+  {
+    out_sKey = sFile;
+    out_sKey.MakeCleanPath();
+
+#if EZ_ENABLED(EZ_SUPPORTS_CASE_INSENSITIVE_PATHS)
+    out_sKey.ToLower();
+#endif
+  }
+} // namespace
+
 namespace ezDataDirectory
 {
   ezString FolderType::s_sRedirectionFile;
   ezString FolderType::s_sRedirectionPrefix;
+  bool FolderType::s_bEnablePathIndex = false;
 
   ezResult FolderReader::InternalOpen(ezFileShareMode::Enum FileShareMode)
   {
@@ -124,6 +138,8 @@ namespace ezDataDirectory
     sPath.AppendPath(sFile);
 
     ezOSFile::DeleteFile(sPath.GetData()).IgnoreResult();
+
+    RemoveFromPathIndex(sFile);
   }
 
   FolderType::~FolderType()
@@ -204,6 +220,9 @@ namespace ezDataDirectory
     ezStringBuilder sRedirectedAsset;
     ResolveAssetRedirection(sFile, sRedirectedAsset);
 
+    if (IsMissingInPathIndex(sRedirectedAsset))
+      return false;
+
     ezStringBuilder sPath = GetRedirectedDataDirectoryPath();
     sPath.AppendPath(sRedirectedAsset);
     return ezOSFile::ExistsFile(sPath);
@@ -257,6 +276,11 @@ namespace ezDataDirectory
 
     ReloadExternalConfigs();
 
+    if (s_bEnablePathIndex)
+    {
+      BuildPathIndex();
+    }
+
     return EZ_SUCCESS;
   }
 
@@ -294,6 +318,9 @@ namespace ezDataDirectory
     if (ezConversionUtils::IsStringUuid(sFileToOpen))
       return nullptr;
 
+    if (IsMissingInPathIndex(sFileToOpen))
+      return nullptr;
+
     FolderReader* pReader = nullptr;
     {
       EZ_LOCK(m_ReaderWriterMutex);
@@ -379,9 +406,208 @@ namespace ezDataDirectory
       return nullptr;
     }
 
+    // don't wait for the directory watcher, the file might be read again right away
+    AddToPathIndex(sFile);
+
     // if it succeeds, we return the reader
     return pWriter;
   }
+
+  void FolderType::PerFrameUpdate()
+  {
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+    if (m_pPathIndexWatcher == nullptr)
+      return;
+
+    ApplyPathIndexChanges();
+#endif
+  }
+
+  bool FolderType::HasPathIndex() const
+  {
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+    return m_pPathIndexWatcher != nullptr;
+#else
+    return false;
+#endif
+  }
+
+  bool FolderType::IsMissingInPathIndex(ezStringView sFile)
+  {
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+    if (m_pPathIndexWatcher == nullptr || ezPathUtils::IsAbsolutePath(sFile))
+      return false;
+
+    ezStringBuilder sKey;
+    GetPathIndexKey(sFile, sKey);
+
+    // External changes are applied in PerFrameUpdate(), the lookup itself never touches the directory watcher
+    EZ_LOCK(m_PathIndexMutex);
+    return !m_PathIndex.Contains(sKey);
+#else
+    EZ_IGNORE_UNUSED(sFile);
+    return false;
+#endif
+  }
+
+  void FolderType::AddToPathIndex(ezStringView sFile)
+  {
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+    if (m_pPathIndexWatcher == nullptr || ezPathUtils::IsAbsolutePath(sFile))
+      return;
+
+    ezStringBuilder sKey;
+    GetPathIndexKey(sFile, sKey);
+
+    EZ_LOCK(m_PathIndexMutex);
+    m_PathIndex.Insert(sKey);
+#else
+    EZ_IGNORE_UNUSED(sFile);
+#endif
+  }
+
+  void FolderType::RemoveFromPathIndex(ezStringView sFile)
+  {
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+    if (m_pPathIndexWatcher == nullptr || ezPathUtils::IsAbsolutePath(sFile))
+      return;
+
+    ezStringBuilder sKey;
+    GetPathIndexKey(sFile, sKey);
+
+    EZ_LOCK(m_PathIndexMutex);
+    m_PathIndex.Remove(sKey);
+#else
+    EZ_IGNORE_UNUSED(sFile);
+#endif
+  }
+
+  void FolderType::BuildPathIndex()
+  {
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+    EZ_LOCK(m_PathIndexMutex);
+
+    m_PathIndex.Clear();
+    m_pPathIndexWatcher = EZ_DEFAULT_NEW(ezDirectoryWatcher);
+
+    // Start watching before the folder is scanned, so that no change can get lost in between
+    const ezBitflags<ezDirectoryWatcher::Watch> whatToWatch = ezDirectoryWatcher::Watch::Creates | ezDirectoryWatcher::Watch::Deletes | ezDirectoryWatcher::Watch::Renames | ezDirectoryWatcher::Watch::Subdirectories;
+    if (m_pPathIndexWatcher->OpenDirectory(m_sRedirectedDataDirPath, whatToWatch).Failed())
+    {
+      ezLog::Warning("Can't watch data directory '{}' for changes, path index is disabled.", m_sRedirectedDataDirPath.GetView());
+      m_pPathIndexWatcher.Clear();
+      return;
+    }
+
+    ezDynamicArray<ezString> files;
+    CollectPathIndexKeys(m_sRedirectedDataDirPath, files);
+
+    for (const ezString& sFile : files)
+    {
+      m_PathIndex.Insert(sFile);
+    }
+#endif
+  }
+
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+
+  void FolderType::CollectPathIndexKeys(ezStringView sAbsoluteFolder, ezDynamicArray<ezString>& out_keys) const
+  {
+    ezStringBuilder sFile, sKey;
+
+    ezFileSystemIterator it;
+    for (it.StartSearch(sAbsoluteFolder, ezFileSystemIteratorFlags::ReportFilesRecursive); it.IsValid(); it.Next())
+    {
+      it.GetStats().GetFullPath(sFile);
+
+      if (sFile.MakeRelativeTo(m_sRedirectedDataDirPath).Succeeded())
+      {
+        GetPathIndexKey(sFile, sKey);
+        out_keys.PushBack(sKey);
+      }
+    }
+  }
+
+  void FolderType::ApplyPathIndexChanges()
+  {
+    struct FileChange
+    {
+      ezString m_sKey;
+      bool m_bAdded;
+    };
+
+    ezStringBuilder sKey;
+    ezDynamicArray<FileChange> fileChanges;
+    ezHybridArray<ezString, 16> removedFolders;
+    ezHybridArray<ezString, 16> addedFolders;
+
+    // The watcher is only ever polled from here, so this doesn't need the path index mutex
+    m_pPathIndexWatcher->EnumerateChanges([&](ezStringView sPath, ezDirectoryWatcherAction action, ezDirectoryWatcherType type)
+      {
+        sKey = sPath;
+        if (sKey.MakeRelativeTo(m_sRedirectedDataDirPath).Failed())
+          return;
+
+        GetPathIndexKey(sKey, sKey);
+
+        const bool bAdded = action == ezDirectoryWatcherAction::Added || action == ezDirectoryWatcherAction::RenamedNewName;
+        const bool bRemoved = action == ezDirectoryWatcherAction::Removed || action == ezDirectoryWatcherAction::RenamedOldName;
+
+        if (type == ezDirectoryWatcherType::File)
+        {
+          if (bAdded || bRemoved)
+            fileChanges.PushBack({sKey, bAdded});
+        }
+        else
+        {
+          // Not all platforms report the files inside of folders that are moved around, so these are handled explicitly
+          if (bAdded)
+            addedFolders.PushBack(sPath);
+          else if (bRemoved)
+            removedFolders.PushBack(sKey);
+        } });
+
+    // scanning new folders hits the disk, so do that before lookups get blocked
+    ezDynamicArray<ezString> addedFolderFiles;
+    for (const ezString& sFolder : addedFolders)
+    {
+      CollectPathIndexKeys(sFolder, addedFolderFiles);
+    }
+
+    if (fileChanges.IsEmpty() && removedFolders.IsEmpty() && addedFolderFiles.IsEmpty())
+      return;
+
+    EZ_LOCK(m_PathIndexMutex);
+
+    for (const FileChange& change : fileChanges)
+    {
+      if (change.m_bAdded)
+        m_PathIndex.Insert(change.m_sKey);
+      else
+        m_PathIndex.Remove(change.m_sKey);
+    }
+
+    for (ezStringBuilder sFolder : removedFolders)
+    {
+      sFolder.Append("/");
+
+      for (auto it = m_PathIndex.GetIterator(); it.IsValid();)
+      {
+        if (it.Key().StartsWith(sFolder))
+          it = m_PathIndex.Remove(it);
+        else
+          ++it;
+      }
+    }
+
+    for (const ezString& sFile : addedFolderFiles)
+    {
+      m_PathIndex.Insert(sFile);
+    }
+  }
+
+#endif
+
 } // namespace ezDataDirectory
 
 
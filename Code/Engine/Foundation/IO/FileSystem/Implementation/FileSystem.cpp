@@ -169,7 +169,7 @@ bool ezFileSystem::RemoveDataDirectory(ezStringView sRootName)
         s_pData->m_Event.Broadcast(fe);
       }
 
-      directory.m_pDataDirectory->RemoveDataDirectory();
+      ReleaseDataDirectory(directory.m_pDataDirectory);
       s_pData->m_DataDirectories.RemoveAtAndCopy(i);
 
       return true;
@@ -206,7 +206,7 @@ ezUInt32 ezFileSystem::RemoveDataDirectoryGroup(ezStringView sGroup)
 
       ++uiRemoved;
 
-      s_pData->m_DataDirectories[i].m_pDataDirectory->RemoveDataDirectory();
+      ReleaseDataDirectory(s_pData->m_DataDirectories[i].m_pDataDirectory);
       s_pData->m_DataDirectories.RemoveAtAndCopy(i);
     }
     else
@@ -234,7 +234,7 @@ void ezFileSystem::ClearAllDataDirectories()
       s_pData->m_Event.Broadcast(fe);
     }
 
-    s_pData->m_DataDirectories[i].m_pDataDirectory->RemoveDataDirectory();
+    ReleaseDataDirectory(s_pData->m_DataDirectories[i].m_pDataDirectory);
   }
 
   s_pData->m_DataDirectories.Clear();
@@ -324,6 +324,42 @@ ezStringView ezFileSystem::GetDataDirRelativePath(ezStringView sPath, ezUInt32 u
   return sPath;
 }
 
+void ezFileSystem::AcquireDataDirectoriesForLookup(ezStringView sPath, ezStringView sRootName, DataDirLookupArray& out_dataDirs)
+{
+  EZ_LOCK(s_pData->m_FsMutex);
+
+  // the last added data directory has the highest priority
+  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  {
+    // if a root is used, ignore all directories that do not have the same root name
+    if (!sRootName.IsEmpty() && s_pData->m_DataDirectories[i].m_sRootName != sRootName)
+      continue;
+
+    ezDataDirectoryType* pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+    pDataDir->m_iFileSystemReferences.Increment();
+
+    DataDirLookup& lookup = out_dataDirs.ExpandAndGetRef();
+    lookup.m_pDataDirectory = pDataDir;
+    lookup.m_sRelPath = GetDataDirRelativePath(sPath, i);
+  }
+}
+
+void ezFileSystem::ReleaseDataDirectories(const DataDirLookupArray& dataDirs)
+{
+  for (const DataDirLookup& dataDir : dataDirs)
+  {
+    ReleaseDataDirectory(dataDir.m_pDataDirectory);
+  }
+}
+
+void ezFileSystem::ReleaseDataDirectory(ezDataDirectoryType* pDataDir)
+{
+  if (pDataDir->m_iFileSystemReferences.Decrement() == 0)
+  {
+    pDataDir->RemoveDataDirectory();
+  }
+}
+
 
 ezFileSystem::DataDirectoryInfo* ezFileSystem::GetDataDirForRoot(const ezString& sRoot)
 {
@@ -394,20 +430,21 @@ bool ezFileSystem::ExistsFile(ezStringView sFile)
 
   const bool bOneSpecificDataDir = !sRootName.IsEmpty();
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  DataDirLookupArray dataDirs;
+  AcquireDataDirectoriesForLookup(sFile, sRootName, dataDirs);
 
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  bool bExists = false;
+  for (const DataDirLookup& dataDir : dataDirs)
   {
-    if (!sRootName.IsEmpty() && s_pData->m_DataDirectories[i].m_sRootName != sRootName)
-      continue;
-
-    ezStringView sRelPath = GetDataDirRelativePath(sFile, i);
-
-    if (s_pData->m_DataDirectories[i].m_pDataDirectory->ExistsFile(sRelPath, bOneSpecificDataDir))
-      return true;
+    if (dataDir.m_pDataDirectory->ExistsFile(dataDir.m_sRelPath, bOneSpecificDataDir))
+    {
+      bExists = true;
+      break;
+    }
   }
 
-  return false;
+  ReleaseDataDirectories(dataDirs);
+  return bExists;
 }
 
 
@@ -415,25 +452,26 @@ ezResult ezFileSystem::GetFileStats(ezStringView sFileOrFolder, ezFileStats& out
 {
   EZ_ASSERT_DEV(s_pData != nullptr, "FileSystem is not initialized.");
 
-  EZ_LOCK(s_pData->m_FsMutex);
-
   ezString sRootName;
   sFileOrFolder = ExtractRootName(sFileOrFolder, sRootName);
 
   const bool bOneSpecificDataDir = !sRootName.IsEmpty();
 
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
-  {
-    if (!sRootName.IsEmpty() && s_pData->m_DataDirectories[i].m_sRootName != sRootName)
-      continue;
-
-    ezStringView sRelPath = GetDataDirRelativePath(sFileOrFolder, i);
+  DataDirLookupArray dataDirs;
+  AcquireDataDirectoriesForLookup(sFileOrFolder, sRootName, dataDirs);
 
-    if (s_pData->m_DataDirectories[i].m_pDataDirectory->GetFileStats(sRelPath, bOneSpecificDataDir, out_stats).Succeeded())
-      return EZ_SUCCESS;
+  ezResult result = EZ_FAILURE;
+  for (const DataDirLookup& dataDir : dataDirs)
+  {
+    if (dataDir.m_pDataDirectory->GetFileStats(dataDir.m_sRelPath, bOneSpecificDataDir, out_stats).Succeeded())
+    {
+      result = EZ_SUCCESS;
+      break;
+    }
   }
 
-  return EZ_FAILURE;
+  ReleaseDataDirectories(dataDirs);
+  return result;
 }
 
 ezStringView ezFileSystem::ExtractRootName(ezStringView sPath, ezString& rootName)
@@ -454,8 +492,6 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(ezStringView sFile, ezFileSha
   if (sFile.IsEmpty())
     return nullptr;
 
-  EZ_LOCK(s_pData->m_FsMutex);
-
   ezString sRootName;
   sFile = ExtractRootName(sFile, sRootName);
 
@@ -465,44 +501,49 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(ezStringView sFile, ezFileSha
 
   const bool bOneSpecificDataDir = !sRootName.IsEmpty();
 
-  // the last added data directory has the highest priority
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
-  {
-    // if a root is used, ignore all directories that do not have the same root name
-    if (bOneSpecificDataDir && s_pData->m_DataDirectories[i].m_sRootName != sRootName)
-      continue;
+  // Only the mount table lookup needs the file system mutex, the data directories are probed without holding it
+  DataDirLookupArray dataDirs;
+  AcquireDataDirectoriesForLookup(sPath, sRootName, dataDirs);
 
-    ezStringView sRelPath = GetDataDirRelativePath(sPath, i);
+  ezDataDirectoryReader* pResult = nullptr;
 
+  for (const DataDirLookup& dataDir : dataDirs)
+  {
     if (bAllowFileEvents)
     {
       // Broadcast that we now try to open this file
       // Could be useful to check this file out before it is accessed
       FileEvent fe;
       fe.m_EventType = FileEventType::OpenFileAttempt;
-      fe.m_sFileOrDirectory = sRelPath;
+      fe.m_sFileOrDirectory = dataDir.m_sRelPath;
       fe.m_sOther = sRootName;
-      fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dataDir.m_pDataDirectory;
       s_pData->m_Event.Broadcast(fe);
     }
 
     // Let the data directory try to open the file.
-    ezDataDirectoryReader* pReader = s_pData->m_DataDirectories[i].m_pDataDirectory->OpenFileToRead(sRelPath, FileShareMode, bOneSpecificDataDir);
+    ezDataDirectoryReader* pReader = dataDir.m_pDataDirectory->OpenFileToRead(dataDir.m_sRelPath, FileShareMode, bOneSpecificDataDir);
 
     if (bAllowFileEvents && pReader != nullptr)
     {
       // Broadcast that this file has been opened.
       FileEvent fe;
       fe.m_EventType = FileEventType::OpenFileSucceeded;
-      fe.m_sFileOrDirectory = sRelPath;
+      fe.m_sFileOrDirectory = dataDir.m_sRelPath;
       fe.m_sOther = sRootName;
-      fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dataDir.m_pDataDirectory;
       s_pData->m_Event.Broadcast(fe);
 
-      return pReader;
+      pResult = pReader;
+      break;
     }
   }
 
+  ReleaseDataDirectories(dataDirs);
+
+  if (pResult != nullptr)
+    return pResult;
+
   if (bAllowFileEvents)
   {
     // Broadcast that opening this file failed.
@@ -820,6 +861,28 @@ void ezFileSystem::ReloadAllExternalDataDirectoryConfigs()
   }
 }
 
+void ezFileSystem::PerFrameUpdate()
+{
+  DataDirLookupArray dataDirs;
+
+  {
+    EZ_LOCK(s_pData->m_FsMutex);
+
+    for (auto& dd : s_pData->m_DataDirectories)
+    {
+      dd.m_pDataDirectory->m_iFileSystemReferences.Increment();
+      dataDirs.ExpandAndGetRef().m_pDataDirectory = dd.m_pDataDirectory;
+    }
+  }
+
+  for (const DataDirLookup& dataDir : dataDirs)
+  {
+    dataDir.m_pDataDirectory->PerFrameUpdate();
+  }
+
+  ReleaseDataDirectories(dataDirs);
+}
+
 void ezFileSystem::Startup()
 {
   s_pData = EZ_DEFAULT_NEW(FileSystemData);
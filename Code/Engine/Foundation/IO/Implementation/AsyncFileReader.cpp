@@ -0,0 +1,179 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/Implementation/AsyncFileReaderBackend.h>
+#include <Foundation/IO/OSFile.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+#  include <Foundation/Platform/Linux/AsyncFileReader_Linux.h>
+#endif
+
+ezAsyncFileReaderBackend_ThreadPool::ezAsyncFileReaderBackend_ThreadPool(ezAsyncFileReader* pOwner, ezUInt32 uiNumThreads)
+  : ezAsyncFileReaderBackend(pOwner)
+{
+  m_ReadsAvailable.Create().IgnoreResult();
+
+  for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+  {
+    m_Threads.PushBack(EZ_DEFAULT_NEW(WorkerThread, this));
+    m_Threads.PeekBack()->Start();
+  }
+}
+
+ezAsyncFileReaderBackend_ThreadPool::~ezAsyncFileReaderBackend_ThreadPool()
+{
+  m_bShutdown = true;
+
+  for (ezUInt32 i = 0; i < m_Threads.GetCount(); ++i)
+  {
+    m_ReadsAvailable.ReturnToken();
+  }
+
+  for (auto& pThread : m_Threads)
+  {
+    pThread->Join();
+  }
+}
+
+void ezAsyncFileReaderBackend_ThreadPool::ReadsQueued(ezUInt32 uiNumReads)
+{
+  for (ezUInt32 i = 0; i < uiNumReads; ++i)
+  {
+    m_ReadsAvailable.ReturnToken();
+  }
+}
+
+ezUInt32 ezAsyncFileReaderBackend_ThreadPool::WorkerThread::Run()
+{
+  m_pBackend->ExecuteReads();
+  return 0;
+}
+
+void ezAsyncFileReaderBackend_ThreadPool::ExecuteReads()
+{
+  QueuedRead read;
+
+  while (true)
+  {
+    m_ReadsAvailable.AcquireToken();
+
+    if (m_bShutdown)
+      return;
+
+    // there is at least one token per queued read, so this can only fail if somebody else took the read
+    if (!DequeueRead(read))
+      continue;
+
+    ezOSFile file;
+    if (file.Open(read.m_sAbsolutePath, ezFileOpenMode::Read).Failed())
+    {
+      FinishRead(read, 0, EZ_FAILURE);
+      continue;
+    }
+
+    file.SetFilePosition(static_cast<ezInt64>(read.m_Read.m_uiOffset), ezFileSeekMode::FromStart);
+    const ezUInt64 uiBytesRead = file.Read(read.m_Read.m_pDestination, read.m_Read.m_uiSize);
+
+    FinishRead(read, uiBytesRead, EZ_SUCCESS);
+  }
+}
+
+ezAsyncFileReader::ezAsyncFileReader(ezUInt32 uiMaxReadsInFlight /*= 32*/, Backend backend /*= Backend::Default*/)
+{
+  m_uiMaxReadsInFlight = ezMath::Max(uiMaxReadsInFlight, 1u);
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+  if (backend == Backend::Default)
+  {
+    ezUniquePtr<ezAsyncFileReaderBackend_IoUring> pIoUring = EZ_DEFAULT_NEW(ezAsyncFileReaderBackend_IoUring, this);
+    if (pIoUring->Initialize(m_uiMaxReadsInFlight).Succeeded())
+    {
+      m_pBackend = std::move(pIoUring);
+      m_bUsesIoUring = true;
+      return;
+    }
+  }
+#else
+  EZ_IGNORE_UNUSED(backend);
+#endif
+
+  m_uiMaxReadsInFlight = ezMath::Min(m_uiMaxReadsInFlight, ezAsyncFileReaderBackend_ThreadPool::MaxThreads);
+  m_pBackend = EZ_DEFAULT_NEW(ezAsyncFileReaderBackend_ThreadPool, this, m_uiMaxReadsInFlight);
+}
+
+ezAsyncFileReader::~ezAsyncFileReader()
+{
+  WaitForAll();
+
+  m_pBackend.Clear();
+}
+
+void ezAsyncFileReader::Submit(ezArrayPtr<const ezAsyncFileRead> reads, CompletionCallback callback)
+{
+  if (reads.IsEmpty())
+    return;
+
+  {
+    EZ_LOCK(m_QueueCondition);
+
+    for (const ezAsyncFileRead& read : reads)
+    {
+      QueuedRead& queued = m_Queue.ExpandAndGetRef();
+      queued.m_sAbsolutePath = read.m_sAbsolutePath;
+      queued.m_Read = read;
+      queued.m_Callback = callback;
+    }
+
+    m_uiNumPendingReads += reads.GetCount();
+  }
+
+  m_pBackend->ReadsQueued(reads.GetCount());
+}
+
+void ezAsyncFileReader::WaitForAll()
+{
+  EZ_LOCK(m_QueueCondition);
+
+  while (m_uiNumPendingReads > 0)
+  {
+    m_QueueCondition.UnlockWaitForSignalAndLock();
+  }
+}
+
+ezUInt32 ezAsyncFileReader::GetNumPendingReads() const
+{
+  EZ_LOCK(m_QueueCondition);
+  return m_uiNumPendingReads;
+}
+
+ezUInt32 ezAsyncFileReader::GetNumQueuedReads() const
+{
+  EZ_LOCK(m_QueueCondition);
+  return m_Queue.GetCount();
+}
+
+bool ezAsyncFileReader::DequeueRead(QueuedRead& out_read)
+{
+  EZ_LOCK(m_QueueCondition);
+
+  if (m_Queue.IsEmpty())
+    return false;
+
+  out_read = std::move(m_Queue.PeekFront());
+  m_Queue.PopFront();
+
+  // the string might have been moved, don't point into the queue
+  out_read.m_Read.m_sAbsolutePath = out_read.m_sAbsolutePath;
+  return true;
+}
+
+void ezAsyncFileReader::FinishRead(const QueuedRead& read, ezUInt64 uiBytesRead, ezResult result)
+{
+  read.m_Callback(read.m_Read, uiBytesRead, result);
+
+  EZ_LOCK(m_QueueCondition);
+
+  if (--m_uiNumPendingReads == 0)
+  {
+    m_QueueCondition.SignalAll();
+  }
+}
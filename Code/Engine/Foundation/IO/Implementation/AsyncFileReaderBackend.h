@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/IO/AsyncFileReader.h>
+#include <Foundation/Threading/Semaphore.h>
+#include <Foundation/Threading/Thread.h>
+
+/// \brief Base class for the parts of ezAsyncFileReader that actually execute the reads.
+///
+/// Backends fetch queued reads with DequeueRead() and have to call FinishRead() exactly once for each of them.
+class ezAsyncFileReaderBackend
+{
+public:
+  using QueuedRead = ezAsyncFileReader::QueuedRead;
+
+  ezAsyncFileReaderBackend(ezAsyncFileReader* pOwner)
+    : m_pOwner(pOwner)
+  {
+  }
+
+  /// \brief The backend must have finished all reads that it dequeued, when it gets destroyed.
+  virtual ~ezAsyncFileReaderBackend() = default;
+
+  /// \brief Called after \a uiNumReads new reads were queued.
+  virtual void ReadsQueued(ezUInt32 uiNumReads) = 0;
+
+protected:
+  bool DequeueRead(QueuedRead& out_read) { return m_pOwner->DequeueRead(out_read); }
+  void FinishRead(const QueuedRead& read, ezUInt64 uiBytesRead, ezResult result) { m_pOwner->FinishRead(read, uiBytesRead, result); }
+  ezUInt32 GetNumQueuedReads() const { return m_pOwner->GetNumQueuedReads(); }
+
+  ezAsyncFileReader* m_pOwner = nullptr;
+};
+
+/// \brief Executes the reads with blocking calls on a couple of threads.
+///
+/// Used on all platforms that have nothing better to offer and by the io_uring backend, once its ring has stopped working.
+class ezAsyncFileReaderBackend_ThreadPool : public ezAsyncFileReaderBackend
+{
+public:
+  /// Blocking reads scale with the number of threads, but at some point more threads only cost memory.
+  static constexpr ezUInt32 MaxThreads = 16;
+
+  ezAsyncFileReaderBackend_ThreadPool(ezAsyncFileReader* pOwner, ezUInt32 uiNumThreads);
+  ~ezAsyncFileReaderBackend_ThreadPool();
+
+  virtual void ReadsQueued(ezUInt32 uiNumReads) override;
+
+private:
+  class WorkerThread : public ezThread
+  {
+  public:
+    WorkerThread(ezAsyncFileReaderBackend_ThreadPool* pBackend)
+      : ezThread("ezAsyncFileReader")
+      , m_pBackend(pBackend)
+    {
+    }
+
+  private:
+    virtual ezUInt32 Run() override;
+
+    ezAsyncFileReaderBackend_ThreadPool* m_pBackend = nullptr;
+  };
+
+  void ExecuteReads();
+
+  ezSemaphore m_ReadsAvailable;
+  volatile bool m_bShutdown = false;
+  ezHybridArray<ezUniquePtr<WorkerThread>, 16> m_Threads;
+};
@@ -23,7 +23,7 @@ ezCompressedStreamReaderZstd::~ezCompressedStreamReaderZstd()
   }
 }
 
-void ezCompressedStreamReaderZstd::SetInputStream(ezStreamReader* pInputStream)
+void ezCompressedStreamReaderZstd::SetInputStream(ezStreamReader* pInputStream, const ezCompressionDictionaryZstd* pDictionary /*= nullptr*/)
 {
   m_InBuffer.pos = 0;
   m_InBuffer.size = 0;
@@ -35,7 +35,14 @@ void ezCompressedStreamReaderZstd::SetInputStream(ezStreamReader* pInputStream)
     m_pZstdDStream = ZSTD_createDStream();
   }
 
+  // this also resets any previously referenced dictionary
   ZSTD_initDStream(reinterpret_cast<ZSTD_DStream*>(m_pZstdDStream));
+
+  if (pDictionary != nullptr)
+  {
+    EZ_ASSERT_DEV(pDictionary->IsValid(), "The dictionary has not been created.");
+    ZSTD_DCtx_refDDict(reinterpret_cast<ZSTD_DStream*>(m_pZstdDStream), reinterpret_cast<const ZSTD_DDict*>(pDictionary->m_pZstdDDict));
+  }
 }
 
 ezUInt64 ezCompressedStreamReaderZstd::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
@@ -187,7 +194,8 @@ void ezCompressedStreamWriterZstd::SetOutputStream(ezStreamWriter* pOutputStream
     ezUInt32 uiMaxCoreCount = (uiMaxNumWorkerThreads > 0) ? ezMath::Clamp(ezSystemInformation::Get().GetCPUCoreCount(), 1u, uiMaxNumWorkerThreads) : 0u;
 
     ZSTD_CCtx_reset(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), ZSTD_reset_session_only);
-    ZSTD_CCtx_refCDict(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), nullptr);
+    EZ_ASSERT_DEV(m_pDictionary == nullptr || m_pDictionary->m_pZstdCDict != nullptr, "The dictionary has not been created for compression.");
+    ZSTD_CCtx_refCDict(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), m_pDictionary ? reinterpret_cast<const ZSTD_CDict*>(m_pDictionary->m_pZstdCDict) : nullptr);
     ZSTD_CCtx_setParameter(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), ZSTD_c_compressionLevel, (int)ratio);
     ZSTD_CCtx_setParameter(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), ZSTD_c_nbWorkers, uiMaxCoreCount);
 
@@ -304,4 +312,55 @@ ezResult ezCompressedStreamWriterZstd::WriteBytes(const void* pWriteBuffer, ezUI
   return EZ_SUCCESS;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+ezCompressionDictionaryZstd::ezCompressionDictionaryZstd() = default;
+
+ezCompressionDictionaryZstd::~ezCompressionDictionaryZstd()
+{
+  Clear();
+}
+
+ezResult ezCompressionDictionaryZstd::Create(ezConstByteArrayPtr dictionaryData, bool bForCompression /*= false*/, ezCompressedStreamWriterZstd::Compression ratio /*= ezCompressedStreamWriterZstd::Compression::Default*/)
+{
+  Clear();
+
+  if (dictionaryData.IsEmpty())
+    return EZ_FAILURE;
+
+  // both functions copy the data, so the dictionary does not depend on the lifetime of the input
+  m_pZstdDDict = ZSTD_createDDict(dictionaryData.GetPtr(), dictionaryData.GetCount());
+
+  if (m_pZstdDDict == nullptr)
+    return EZ_FAILURE;
+
+  if (bForCompression)
+  {
+    m_pZstdCDict = ZSTD_createCDict(dictionaryData.GetPtr(), dictionaryData.GetCount(), (int)ratio);
+
+    if (m_pZstdCDict == nullptr)
+    {
+      Clear();
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezCompressionDictionaryZstd::Clear()
+{
+  if (m_pZstdCDict != nullptr)
+  {
+    ZSTD_freeCDict(reinterpret_cast<ZSTD_CDict*>(m_pZstdCDict));
+    m_pZstdCDict = nullptr;
+  }
+
+  if (m_pZstdDDict != nullptr)
+  {
+    ZSTD_freeDDict(reinterpret_cast<ZSTD_DDict*>(m_pZstdDDict));
+    m_pZstdDDict = nullptr;
+  }
+}
+
 #endif
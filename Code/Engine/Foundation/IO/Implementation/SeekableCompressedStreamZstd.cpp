@@ -0,0 +1,295 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/SeekableCompressedStreamZstd.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+#  include <Foundation/IO/MemoryStream.h>
+#  include <zstd/zstd.h>
+
+// The stored data is the sequence of compressed frames, followed by the seek table:
+//   ezUInt32 compressed size of every frame
+//   ezUInt64 uncompressed size
+//   ezUInt32 uncompressed frame size
+//   ezUInt32 number of frames
+//   ezUInt32 magic value
+static constexpr ezUInt32 s_uiSeekTableMagic = 0x4B535A45; // 'EZSK'
+static constexpr ezUInt32 s_uiSeekTableFooterSize = sizeof(ezUInt64) + 3 * sizeof(ezUInt32);
+
+ezSeekableCompressedStreamWriterZstd::ezSeekableCompressedStreamWriterZstd() = default;
+
+ezSeekableCompressedStreamWriterZstd::ezSeekableCompressedStreamWriterZstd(ezStreamWriter* pOutputStream, ezCompressedStreamWriterZstd::Compression ratio /*= ezCompressedStreamWriterZstd::Compression::Default*/, ezUInt32 uiFrameSizeKB /*= 64*/)
+{
+  SetOutputStream(pOutputStream, ratio, uiFrameSizeKB);
+}
+
+ezSeekableCompressedStreamWriterZstd::~ezSeekableCompressedStreamWriterZstd()
+{
+  if (m_pOutputStream != nullptr)
+  {
+    FinishCompressedStream().IgnoreResult();
+  }
+
+  if (m_pZstdCCtx != nullptr)
+  {
+    ZSTD_freeCCtx(reinterpret_cast<ZSTD_CCtx*>(m_pZstdCCtx));
+    m_pZstdCCtx = nullptr;
+  }
+}
+
+void ezSeekableCompressedStreamWriterZstd::SetOutputStream(ezStreamWriter* pOutputStream, ezCompressedStreamWriterZstd::Compression ratio /*= ezCompressedStreamWriterZstd::Compression::Default*/, ezUInt32 uiFrameSizeKB /*= 64*/)
+{
+  if (m_pOutputStream == pOutputStream)
+    return;
+
+  // finish anything done on a previous output stream
+  FinishCompressedStream().IgnoreResult();
+
+  m_uiUncompressedSize = 0;
+  m_uiWrittenBytes = 0;
+  m_Frame.Clear();
+  m_CompressedFrameSizes.Clear();
+
+  if (pOutputStream != nullptr)
+  {
+    m_pOutputStream = pOutputStream;
+    m_iCompressionLevel = (ezInt32)ratio;
+    m_uiFrameSize = ezMath::Max(1u, uiFrameSizeKB) * 1024;
+
+    if (m_pZstdCCtx == nullptr)
+    {
+      m_pZstdCCtx = ZSTD_createCCtx();
+    }
+
+    m_Frame.Reserve(m_uiFrameSize);
+    m_CompressedFrame.SetCountUninitialized(static_cast<ezUInt32>(ZSTD_compressBound(m_uiFrameSize)));
+  }
+}
+
+ezResult ezSeekableCompressedStreamWriterZstd::WriteBytes(const void* pWriteBuffer, ezUInt64 uiBytesToWrite)
+{
+  EZ_ASSERT_DEV(m_pOutputStream != nullptr, "The stream is already closed, you cannot write more data to it.");
+
+  const ezUInt8* pSource = static_cast<const ezUInt8*>(pWriteBuffer);
+
+  while (uiBytesToWrite > 0)
+  {
+    const ezUInt32 uiToCopy = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiBytesToWrite, m_uiFrameSize - m_Frame.GetCount()));
+
+    m_Frame.PushBackRange(ezConstByteArrayPtr(pSource, uiToCopy));
+    m_uiUncompressedSize += uiToCopy;
+    pSource += uiToCopy;
+    uiBytesToWrite -= uiToCopy;
+
+    if (m_Frame.GetCount() == m_uiFrameSize)
+    {
+      EZ_SUCCEED_OR_RETURN(CompressFrame());
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezSeekableCompressedStreamWriterZstd::CompressFrame()
+{
+  ZSTD_CCtx* pCCtx = reinterpret_cast<ZSTD_CCtx*>(m_pZstdCCtx);
+
+  ZSTD_CCtx_reset(pCCtx, ZSTD_reset_session_only);
+  ZSTD_CCtx_setParameter(pCCtx, ZSTD_c_compressionLevel, m_iCompressionLevel);
+
+  const size_t res = ZSTD_compress2(pCCtx, m_CompressedFrame.GetData(), m_CompressedFrame.GetCount(), m_Frame.GetData(), m_Frame.GetCount());
+  EZ_VERIFY(!ZSTD_isError(res), "Compressing the zstd frame failed: '{0}'", ZSTD_getErrorName(res));
+
+  EZ_SUCCEED_OR_RETURN(m_pOutputStream->WriteBytes(m_CompressedFrame.GetData(), res));
+
+  m_CompressedFrameSizes.PushBack(static_cast<ezUInt32>(res));
+  m_uiWrittenBytes += res;
+  m_Frame.Clear();
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezSeekableCompressedStreamWriterZstd::FinishCompressedStream()
+{
+  if (m_pOutputStream == nullptr)
+    return EZ_SUCCESS;
+
+  if (!m_Frame.IsEmpty())
+  {
+    EZ_SUCCEED_OR_RETURN(CompressFrame());
+  }
+
+  ezStreamWriter& stream = *m_pOutputStream;
+
+  for (ezUInt32 uiSize : m_CompressedFrameSizes)
+  {
+    stream << uiSize;
+  }
+
+  stream << m_uiUncompressedSize;
+  stream << m_uiFrameSize;
+  stream << m_CompressedFrameSizes.GetCount();
+  stream << s_uiSeekTableMagic;
+
+  m_uiWrittenBytes += m_CompressedFrameSizes.GetCount() * sizeof(ezUInt32) + s_uiSeekTableFooterSize;
+  m_pOutputStream = nullptr;
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezSeekableCompressedStreamReaderZstd::ezSeekableCompressedStreamReaderZstd() = default;
+
+ezSeekableCompressedStreamReaderZstd::~ezSeekableCompressedStreamReaderZstd()
+{
+  if (m_pZstdDCtx != nullptr)
+  {
+    ZSTD_freeDCtx(reinterpret_cast<ZSTD_DCtx*>(m_pZstdDCtx));
+    m_pZstdDCtx = nullptr;
+  }
+}
+
+ezResult ezSeekableCompressedStreamReaderZstd::SetInputData(const void* pData, ezUInt64 uiDataSize)
+{
+  m_pData = nullptr;
+  m_uiUncompressedSize = 0;
+  m_uiReadPosition = 0;
+  m_uiCachedFrame = ezInvalidIndex;
+  m_FrameOffsets.Clear();
+
+  if (uiDataSize < s_uiSeekTableFooterSize)
+    return EZ_FAILURE;
+
+  ezUInt64 uiUncompressedSize = 0;
+  ezUInt32 uiFrameSize = 0;
+  ezUInt32 uiNumFrames = 0;
+  ezUInt32 uiMagic = 0;
+
+  {
+    ezRawMemoryStreamReader footer(ezMemoryUtils::AddByteOffset(pData, static_cast<std::ptrdiff_t>(uiDataSize - s_uiSeekTableFooterSize)), s_uiSeekTableFooterSize);
+    footer >> uiUncompressedSize;
+    footer >> uiFrameSize;
+    footer >> uiNumFrames;
+    footer >> uiMagic;
+  }
+
+  if (uiMagic != s_uiSeekTableMagic || uiFrameSize == 0 || (uiUncompressedSize + uiFrameSize - 1) / uiFrameSize != uiNumFrames)
+    return EZ_FAILURE;
+
+  const ezUInt64 uiTableSize = static_cast<ezUInt64>(uiNumFrames) * sizeof(ezUInt32) + s_uiSeekTableFooterSize;
+  if (uiTableSize > uiDataSize)
+    return EZ_FAILURE;
+
+  m_FrameOffsets.SetCountUninitialized(uiNumFrames + 1);
+  m_FrameOffsets[0] = 0;
+
+  ezRawMemoryStreamReader table(ezMemoryUtils::AddByteOffset(pData, static_cast<std::ptrdiff_t>(uiDataSize - uiTableSize)), uiTableSize);
+
+  for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+  {
+    ezUInt32 uiCompressedSize = 0;
+    table >> uiCompressedSize;
+    m_FrameOffsets[i + 1] = m_FrameOffsets[i] + uiCompressedSize;
+  }
+
+  if (m_FrameOffsets.PeekBack() != uiDataSize - uiTableSize)
+  {
+    m_FrameOffsets.Clear();
+    return EZ_FAILURE;
+  }
+
+  m_pData = static_cast<const ezUInt8*>(pData);
+  m_uiUncompressedSize = uiUncompressedSize;
+  m_uiFrameSize = uiFrameSize;
+
+  if (m_pZstdDCtx == nullptr)
+  {
+    m_pZstdDCtx = ZSTD_createDCtx();
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezUInt32 ezSeekableCompressedStreamReaderZstd::GetFrameUncompressedSize(ezUInt32 uiFrame) const
+{
+  return static_cast<ezUInt32>(ezMath::Min<ezUInt64>(m_uiFrameSize, m_uiUncompressedSize - static_cast<ezUInt64>(uiFrame) * m_uiFrameSize));
+}
+
+bool ezSeekableCompressedStreamReaderZstd::DecompressFrame(ezUInt32 uiFrame, void* pTarget) const
+{
+  const ezUInt32 uiSize = GetFrameUncompressedSize(uiFrame);
+  const ezUInt64 uiStart = m_FrameOffsets[uiFrame];
+
+  const size_t res = ZSTD_decompressDCtx(reinterpret_cast<ZSTD_DCtx*>(m_pZstdDCtx), pTarget, uiSize, m_pData + uiStart, static_cast<size_t>(m_FrameOffsets[uiFrame + 1] - uiStart));
+
+  if (ZSTD_isError(res) || res != uiSize)
+  {
+    EZ_REPORT_FAILURE("Decompressing zstd frame {} failed: '{}'", uiFrame, ZSTD_isError(res) ? ZSTD_getErrorName(res) : "size mismatch");
+    return false;
+  }
+
+  return true;
+}
+
+ezUInt64 ezSeekableCompressedStreamReaderZstd::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
+{
+  EZ_ASSERT_DEV(m_pData != nullptr, "No input data has been specified");
+
+  uiBytesToRead = ezMath::Min(uiBytesToRead, m_uiUncompressedSize - m_uiReadPosition);
+
+  if (pReadBuffer == nullptr)
+    return SkipBytes(uiBytesToRead);
+
+  ezUInt8* pTarget = static_cast<ezUInt8*>(pReadBuffer);
+  ezUInt64 uiBytesRead = 0;
+
+  while (uiBytesRead < uiBytesToRead)
+  {
+    const ezUInt32 uiFrame = static_cast<ezUInt32>(m_uiReadPosition / m_uiFrameSize);
+    const ezUInt32 uiOffsetInFrame = static_cast<ezUInt32>(m_uiReadPosition % m_uiFrameSize);
+    const ezUInt32 uiFrameBytes = GetFrameUncompressedSize(uiFrame);
+    const ezUInt32 uiToCopy = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiFrameBytes - uiOffsetInFrame, uiBytesToRead - uiBytesRead));
+
+    if (uiOffsetInFrame == 0 && uiToCopy == uiFrameBytes && uiFrame != m_uiCachedFrame)
+    {
+      // the entire frame is requested, decompress it directly into the target
+      if (!DecompressFrame(uiFrame, pTarget + uiBytesRead))
+        break;
+    }
+    else
+    {
+      if (uiFrame != m_uiCachedFrame)
+      {
+        m_CachedFrame.SetCountUninitialized(m_uiFrameSize);
+
+        if (!DecompressFrame(uiFrame, m_CachedFrame.GetData()))
+          break;
+
+        m_uiCachedFrame = uiFrame;
+      }
+
+      ezMemoryUtils::Copy(pTarget + uiBytesRead, m_CachedFrame.GetData() + uiOffsetInFrame, uiToCopy);
+    }
+
+    uiBytesRead += uiToCopy;
+    m_uiReadPosition += uiToCopy;
+  }
+
+  return uiBytesRead;
+}
+
+ezUInt64 ezSeekableCompressedStreamReaderZstd::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  const ezUInt64 uiSkipped = ezMath::Min(uiBytesToSkip, m_uiUncompressedSize - m_uiReadPosition);
+  m_uiReadPosition += uiSkipped;
+  return uiSkipped;
+}
+
+void ezSeekableCompressedStreamReaderZstd::SetReadPosition(ezUInt64 uiReadPosition)
+{
+  EZ_ASSERT_DEV(uiReadPosition <= m_uiUncompressedSize, "Read position {} is outside the data of size {}", uiReadPosition, m_uiUncompressedSize);
+  m_uiReadPosition = ezMath::Min(uiReadPosition, m_uiUncompressedSize);
+}
+
+#endif
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/Stream.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+/// \brief A stream writer that compresses the incoming data in independent frames of fixed size, so that it can be read at random positions.
+///
+/// Every frame of the uncompressed data is compressed on its own and written to the output stream.
+/// FinishCompressedStream() appends a seek table with the compressed size of every frame.
+/// ezSeekableCompressedStreamReaderZstd uses that table to only decompress the frames that are actually read.
+///
+/// Compared to ezCompressedStreamWriterZstd the compression ratio is slightly worse, because every frame starts without history.
+/// This format should only be used for large data of which typically only parts are read.
+class EZ_FOUNDATION_DLL ezSeekableCompressedStreamWriterZstd final : public ezStreamWriter
+{
+public:
+  ezSeekableCompressedStreamWriterZstd();
+
+  /// \brief The constructor takes another stream writer to pass the output into, a compression level and the uncompressed size of each frame.
+  ezSeekableCompressedStreamWriterZstd(ezStreamWriter* pOutputStream, ezCompressedStreamWriterZstd::Compression ratio = ezCompressedStreamWriterZstd::Compression::Default, ezUInt32 uiFrameSizeKB = 64);
+
+  /// \brief Calls FinishCompressedStream() internally.
+  ~ezSeekableCompressedStreamWriterZstd();
+
+  /// \brief Configures to which other ezStreamWriter the compressed data should be passed along.
+  ///
+  /// Smaller frames allow more fine-grained access when reading, larger frames give better compression.
+  /// If this is called a second time, the writer finishes up all work on the previous stream first.
+  void SetOutputStream(ezStreamWriter* pOutputStream, ezCompressedStreamWriterZstd::Compression ratio = ezCompressedStreamWriterZstd::Compression::Default, ezUInt32 uiFrameSizeKB = 64);
+
+  /// \brief Compresses \a uiBytesToWrite from \a pWriteBuffer. Every time a frame is full, it gets compressed and written to the output stream.
+  virtual ezResult WriteBytes(const void* pWriteBuffer, ezUInt64 uiBytesToWrite) override;
+
+  /// \brief Compresses the last frame and writes the seek table. After this, no more data can be written to the stream.
+  ezResult FinishCompressedStream();
+
+  /// \brief Returns the size of the data in its uncompressed state.
+  ezUInt64 GetUncompressedSize() const { return m_uiUncompressedSize; }
+
+  /// \brief Returns the exact number of bytes written to the output stream so far, including the seek table.
+  ezUInt64 GetWrittenBytes() const { return m_uiWrittenBytes; }
+
+private:
+  ezResult CompressFrame();
+
+  ezUInt64 m_uiUncompressedSize = 0;
+  ezUInt64 m_uiWrittenBytes = 0;
+  ezUInt32 m_uiFrameSize = 0;
+  ezInt32 m_iCompressionLevel = 0;
+
+  ezStreamWriter* m_pOutputStream = nullptr;
+  /*ZSTD_CCtx*/ void* m_pZstdCCtx = nullptr;
+
+  ezDynamicArray<ezUInt8> m_Frame;
+  ezDynamicArray<ezUInt8> m_CompressedFrame;
+  ezDynamicArray<ezUInt32> m_CompressedFrameSizes;
+};
+
+/// \brief Reads data that was written with ezSeekableCompressedStreamWriterZstd, from memory.
+///
+/// Since the reader needs random access to the compressed data, it works on a memory block (e.g. from a memory mapped file)
+/// and not on another stream. SkipBytes() and SetReadPosition() don't decompress anything, the next ReadBytes() only decompresses
+/// the frames that it touches. The last decompressed frame is cached, so small consecutive reads don't decompress a frame twice.
+class EZ_FOUNDATION_DLL ezSeekableCompressedStreamReaderZstd : public ezStreamReader
+{
+public:
+  ezSeekableCompressedStreamReaderZstd();
+  ~ezSeekableCompressedStreamReaderZstd();
+
+  /// \brief Configures the reader to decompress the given data. Fails if the data does not end with a valid seek table.
+  ///
+  /// The memory has to stay valid until the reader is done with it. Calling this a second time allows to reuse the decoder.
+  ezResult SetInputData(const void* pData, ezUInt64 uiDataSize);
+
+  /// \brief Reads either uiBytesToRead or the amount of remaining bytes in the stream into pReadBuffer.
+  virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override;
+
+  /// \brief Advances the read position without decompressing anything.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override;
+
+  /// \brief Moves the read position to the given position in the uncompressed data. Backwards seeking is allowed as well.
+  void SetReadPosition(ezUInt64 uiReadPosition);
+
+  /// \brief Returns the current position in the uncompressed data.
+  ezUInt64 GetReadPosition() const { return m_uiReadPosition; }
+
+  /// \brief Returns the size of the uncompressed data.
+  ezUInt64 GetUncompressedSize() const { return m_uiUncompressedSize; }
+
+private:
+  ezUInt32 GetFrameUncompressedSize(ezUInt32 uiFrame) const;
+  bool DecompressFrame(ezUInt32 uiFrame, void* pTarget) const;
+
+  const ezUInt8* m_pData = nullptr;
+  ezUInt64 m_uiUncompressedSize = 0;
+  ezUInt64 m_uiReadPosition = 0;
+  ezUInt32 m_uiFrameSize = 0;
+  ezUInt32 m_uiCachedFrame = ezInvalidIndex;
+
+  /*ZSTD_DCtx*/ void* m_pZstdDCtx = nullptr;
+
+  ezDynamicArray<ezUInt64> m_FrameOffsets; ///< Start of every frame in the compressed data, plus the end of the last frame.
+  ezDynamicArray<ezUInt8> m_CachedFrame;
+};
+
+#endif // BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
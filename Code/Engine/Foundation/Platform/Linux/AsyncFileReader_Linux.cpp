@@ -0,0 +1,434 @@
+#include <Foundation/FoundationPCH.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+#  include <Foundation/Logging/Log.h>
+#  include <Foundation/Threading/ThreadUtils.h>
+#  include <Foundation/Platform/Linux/AsyncFileReader_Linux.h>
+
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+namespace
+{
+  // liburing is not a dependency, the few syscalls that are needed are called directly
+  int IoUringSetup(ezUInt32 uiEntries, io_uring_params* pParams)
+  {
+#  if defined(__NR_io_uring_setup)
+    return static_cast<int>(syscall(__NR_io_uring_setup, uiEntries, pParams));
+#  else
+    errno = ENOSYS;
+    return -1;
+#  endif
+  }
+
+  int IoUringEnter(int iRing, ezUInt32 uiToSubmit, ezUInt32 uiMinComplete, ezUInt32 uiFlags)
+  {
+#  if defined(__NR_io_uring_enter)
+    return static_cast<int>(syscall(__NR_io_uring_enter, iRing, uiToSubmit, uiMinComplete, uiFlags, nullptr, 0));
+#  else
+    errno = ENOSYS;
+    return -1;
+#  endif
+  }
+
+  // user data of the entries that cancel reads, the reads use their slot index
+  constexpr ezUInt64 s_uiCancelUserData = 0xFFFFFFFFFFFFFFFFull;
+} // namespace
+
+ezUInt32 ezAsyncFileReaderBackend_IoUring::IoThread::Run()
+{
+  m_pBackend->ExecuteReads();
+  return 0;
+}
+
+ezAsyncFileReaderBackend_IoUring::ezAsyncFileReaderBackend_IoUring(ezAsyncFileReader* pOwner)
+  : ezAsyncFileReaderBackend(pOwner)
+{
+}
+
+ezAsyncFileReaderBackend_IoUring::~ezAsyncFileReaderBackend_IoUring()
+{
+  if (m_pThread != nullptr)
+  {
+    m_bShutdown = true;
+    m_ReadsAvailable.RaiseSignal();
+    m_pThread->Join();
+  }
+
+  m_pFallback.Clear();
+
+  for (auto it : m_OpenFiles)
+  {
+    close(it.Value().m_iFile);
+  }
+
+  DestroyRing();
+}
+
+void ezAsyncFileReaderBackend_IoUring::DestroyRing()
+{
+  if (m_pSubmissionEntries != nullptr)
+    munmap(m_pSubmissionEntries, m_uiSubmissionEntriesSize);
+
+  if (m_pCompletionRing != nullptr && m_pCompletionRing != m_pSubmissionRing)
+    munmap(m_pCompletionRing, m_uiCompletionRingSize);
+
+  if (m_pSubmissionRing != nullptr)
+    munmap(m_pSubmissionRing, m_uiSubmissionRingSize);
+
+  if (m_iRing >= 0)
+    close(m_iRing);
+
+  m_pSubmissionEntries = nullptr;
+  m_pCompletionRing = nullptr;
+  m_pSubmissionRing = nullptr;
+  m_iRing = -1;
+}
+
+ezResult ezAsyncFileReaderBackend_IoUring::Initialize(ezUInt32 uiMaxReadsInFlight)
+{
+  io_uring_params params = {};
+
+  m_iRing = IoUringSetup(uiMaxReadsInFlight, &params);
+  if (m_iRing < 0)
+  {
+    ezLog::Dev("io_uring is not available ({}), using blocking reads instead.", strerror(errno));
+    return EZ_FAILURE;
+  }
+
+  m_uiSubmissionRingSize = params.sq_off.array + params.sq_entries * sizeof(ezUInt32);
+  m_uiCompletionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  m_uiSubmissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+  const bool bSingleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (bSingleMapping)
+  {
+    m_uiSubmissionRingSize = ezMath::Max(m_uiSubmissionRingSize, m_uiCompletionRingSize);
+    m_uiCompletionRingSize = m_uiSubmissionRingSize;
+  }
+
+  m_pSubmissionRing = mmap(nullptr, m_uiSubmissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_iRing, IORING_OFF_SQ_RING);
+  if (m_pSubmissionRing == MAP_FAILED)
+  {
+    m_pSubmissionRing = nullptr;
+    ezLog::Dev("Failed to map the io_uring submission queue ({}), using blocking reads instead.", strerror(errno));
+    return EZ_FAILURE;
+  }
+
+  if (bSingleMapping)
+  {
+    m_pCompletionRing = m_pSubmissionRing;
+  }
+  else
+  {
+    m_pCompletionRing = mmap(nullptr, m_uiCompletionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_iRing, IORING_OFF_CQ_RING);
+    if (m_pCompletionRing == MAP_FAILED)
+    {
+      m_pCompletionRing = nullptr;
+      ezLog::Dev("Failed to map the io_uring completion queue ({}), using blocking reads instead.", strerror(errno));
+      return EZ_FAILURE;
+    }
+  }
+
+  void* pEntries = mmap(nullptr, m_uiSubmissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_iRing, IORING_OFF_SQES);
+  if (pEntries == MAP_FAILED)
+  {
+    ezLog::Dev("Failed to map the io_uring submission entries ({}), using blocking reads instead.", strerror(errno));
+    return EZ_FAILURE;
+  }
+  m_pSubmissionEntries = static_cast<io_uring_sqe*>(pEntries);
+
+  ezUInt8* pSubmissionRing = static_cast<ezUInt8*>(m_pSubmissionRing);
+  m_pSubmissionHead = reinterpret_cast<ezUInt32*>(pSubmissionRing + params.sq_off.head);
+  m_pSubmissionTail = reinterpret_cast<ezUInt32*>(pSubmissionRing + params.sq_off.tail);
+  m_uiSubmissionMask = *reinterpret_cast<ezUInt32*>(pSubmissionRing + params.sq_off.ring_mask);
+  m_pSubmissionArray = reinterpret_cast<ezUInt32*>(pSubmissionRing + params.sq_off.array);
+
+  ezUInt8* pCompletionRing = static_cast<ezUInt8*>(m_pCompletionRing);
+  m_pCompletionHead = reinterpret_cast<ezUInt32*>(pCompletionRing + params.cq_off.head);
+  m_pCompletionTail = reinterpret_cast<ezUInt32*>(pCompletionRing + params.cq_off.tail);
+  m_uiCompletionMask = *reinterpret_cast<ezUInt32*>(pCompletionRing + params.cq_off.ring_mask);
+  m_pCompletionEntries = reinterpret_cast<io_uring_cqe*>(pCompletionRing + params.cq_off.cqes);
+
+  // Every read has at most one entry in the submission queue at any time and the completion queue is at least as large,
+  // so neither of them can overflow. When the reads get canceled, every read has one more entry, which the completion queue,
+  // at twice the size of the submission queue, still has room for.
+  m_uiMaxReadsInFlight = ezMath::Min(uiMaxReadsInFlight, params.sq_entries);
+
+  // the slots must never be reallocated, the kernel holds pointers to their buffers
+  m_Slots.SetCount(m_uiMaxReadsInFlight);
+  m_FreeSlots.Reserve(m_uiMaxReadsInFlight);
+  for (ezUInt32 i = m_uiMaxReadsInFlight; i > 0; --i)
+  {
+    m_FreeSlots.PushBack(i - 1);
+  }
+
+  m_pThread = EZ_DEFAULT_NEW(IoThread, this);
+  m_pThread->Start();
+
+  return EZ_SUCCESS;
+}
+
+void ezAsyncFileReaderBackend_IoUring::ReadsQueued(ezUInt32 uiNumReads)
+{
+  EZ_LOCK(m_FallbackMutex);
+
+  if (m_pFallback != nullptr)
+  {
+    m_pFallback->ReadsQueued(uiNumReads);
+    return;
+  }
+
+  // If the thread is currently waiting for completions, it picks up the new reads once the next read has finished.
+  m_ReadsAvailable.RaiseSignal();
+}
+
+void ezAsyncFileReaderBackend_IoUring::ExecuteReads()
+{
+  while (true)
+  {
+    while (!m_FreeSlots.IsEmpty())
+    {
+      const ezUInt32 uiSlot = m_FreeSlots.PeekBack();
+      if (!DequeueRead(m_Slots[uiSlot].m_Read))
+        break;
+
+      m_FreeSlots.PopBack();
+      StartRead(uiSlot);
+    }
+
+    if (m_uiNumReadsInFlight == 0)
+    {
+      if (m_bShutdown)
+        return;
+
+      m_ReadsAvailable.WaitForSignal();
+      continue;
+    }
+
+    const int iSubmitted = IoUringEnter(m_iRing, m_uiNumUnsubmitted, 1, IORING_ENTER_GETEVENTS);
+    if (iSubmitted >= 0)
+    {
+      m_uiNumUnsubmitted -= static_cast<ezUInt32>(iSubmitted);
+    }
+    else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+    {
+      ezLog::Error("io_uring_enter failed ({}), switching to blocking reads.", strerror(errno));
+      SwitchToThreadPool();
+      return;
+    }
+
+    HandleCompletions();
+  }
+}
+
+void ezAsyncFileReaderBackend_IoUring::SwitchToThreadPool()
+{
+  // The kernel may still write into the buffers of reads that it has picked up, even after the ring was closed.
+  // So the reads are only reported as failed, once the kernel is done with all of them.
+  CancelAllReads();
+  DestroyRing();
+
+  EZ_LOCK(m_FallbackMutex);
+
+  const ezUInt32 uiNumThreads = ezMath::Min(m_uiMaxReadsInFlight, ezAsyncFileReaderBackend_ThreadPool::MaxThreads);
+  m_pFallback = EZ_DEFAULT_NEW(ezAsyncFileReaderBackend_ThreadPool, m_pOwner, uiNumThreads);
+
+  // Reads that are queued from now on are announced to the thread pool directly, the ones that are already waiting have to be announced here.
+  // A read that is queued concurrently may get announced twice, which the thread pool tolerates.
+  m_pFallback->ReadsQueued(GetNumQueuedReads());
+}
+
+void ezAsyncFileReaderBackend_IoUring::CancelAllReads()
+{
+  // whatever the kernel has finished already is still reported normally, but nothing is submitted again
+  HandleCompletions(true);
+
+  // entries that the kernel hasn't consumed yet are simply taken back, without SQPOLL it only consumes them in io_uring_enter
+  const ezUInt32 uiHead = __atomic_load_n(m_pSubmissionHead, __ATOMIC_ACQUIRE);
+  const ezUInt32 uiTail = *m_pSubmissionTail;
+
+  for (ezUInt32 i = uiHead; i != uiTail; ++i)
+  {
+    FinishSlot(static_cast<ezUInt32>(m_pSubmissionEntries[i & m_uiSubmissionMask].user_data), EZ_FAILURE);
+  }
+
+  __atomic_store_n(m_pSubmissionTail, uiHead, __ATOMIC_RELEASE);
+  m_uiNumUnsubmitted = 0;
+
+  // everything else is owned by the kernel
+  for (ezUInt32 uiSlot = 0; uiSlot < m_Slots.GetCount(); ++uiSlot)
+  {
+    if (m_Slots[uiSlot].m_iFile < 0)
+      continue;
+
+    const ezUInt32 uiIndex = *m_pSubmissionTail & m_uiSubmissionMask;
+
+    io_uring_sqe& entry = m_pSubmissionEntries[uiIndex];
+    ezMemoryUtils::ZeroFill(&entry, 1);
+    entry.opcode = IORING_OP_ASYNC_CANCEL;
+    entry.fd = -1;
+    entry.addr = uiSlot;
+    entry.user_data = s_uiCancelUserData;
+
+    m_pSubmissionArray[uiIndex] = uiIndex;
+    __atomic_store_n(m_pSubmissionTail, *m_pSubmissionTail + 1, __ATOMIC_RELEASE);
+
+    ++m_uiNumUnsubmitted;
+  }
+
+  while (m_uiNumReadsInFlight > 0)
+  {
+    const int iSubmitted = IoUringEnter(m_iRing, m_uiNumUnsubmitted, 1, IORING_ENTER_GETEVENTS);
+    if (iSubmitted >= 0)
+    {
+      m_uiNumUnsubmitted -= static_cast<ezUInt32>(iSubmitted);
+    }
+    else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+    {
+      // the reads can't be canceled then, but the kernel still posts their completions, once they are done
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(1));
+    }
+
+    HandleCompletions(true);
+  }
+}
+
+void ezAsyncFileReaderBackend_IoUring::StartRead(ezUInt32 uiSlot)
+{
+  Slot& slot = m_Slots[uiSlot];
+  slot.m_uiBytesRead = 0;
+  slot.m_iFile = AcquireFile(slot.m_Read.m_sAbsolutePath);
+
+  if (slot.m_iFile < 0)
+  {
+    FinishRead(slot.m_Read, 0, EZ_FAILURE);
+    m_FreeSlots.PushBack(uiSlot);
+    return;
+  }
+
+  ++m_uiNumReadsInFlight;
+  SubmitRead(uiSlot);
+}
+
+void ezAsyncFileReaderBackend_IoUring::SubmitRead(ezUInt32 uiSlot)
+{
+  Slot& slot = m_Slots[uiSlot];
+  const ezAsyncFileRead& read = slot.m_Read.m_Read;
+
+  slot.m_Buffer.iov_base = static_cast<ezUInt8*>(read.m_pDestination) + slot.m_uiBytesRead;
+  slot.m_Buffer.iov_len = static_cast<size_t>(read.m_uiSize - slot.m_uiBytesRead);
+
+  // only this thread writes to the submission queue
+  const ezUInt32 uiTail = *m_pSubmissionTail;
+  const ezUInt32 uiIndex = uiTail & m_uiSubmissionMask;
+
+  io_uring_sqe& entry = m_pSubmissionEntries[uiIndex];
+  ezMemoryUtils::ZeroFill(&entry, 1);
+  entry.opcode = IORING_OP_READV;
+  entry.fd = slot.m_iFile;
+  entry.off = read.m_uiOffset + slot.m_uiBytesRead;
+  entry.addr = reinterpret_cast<ezUInt64>(&slot.m_Buffer);
+  entry.len = 1;
+  entry.user_data = uiSlot;
+
+  m_pSubmissionArray[uiIndex] = uiIndex;
+  __atomic_store_n(m_pSubmissionTail, uiTail + 1, __ATOMIC_RELEASE);
+
+  ++m_uiNumUnsubmitted;
+}
+
+void ezAsyncFileReaderBackend_IoUring::HandleCompletions(bool bCanceling)
+{
+  ezUInt32 uiHead = *m_pCompletionHead;
+  const ezUInt32 uiTail = __atomic_load_n(m_pCompletionTail, __ATOMIC_ACQUIRE);
+
+  for (; uiHead != uiTail; ++uiHead)
+  {
+    const io_uring_cqe& completion = m_pCompletionEntries[uiHead & m_uiCompletionMask];
+    if (completion.user_data == s_uiCancelUserData)
+      continue;
+
+    const ezUInt32 uiSlot = static_cast<ezUInt32>(completion.user_data);
+    const ezInt32 iResult = completion.res;
+
+    Slot& slot = m_Slots[uiSlot];
+
+    if (iResult < 0)
+    {
+      if (!bCanceling && (iResult == -EINTR || iResult == -EAGAIN))
+        SubmitRead(uiSlot);
+      else
+        FinishSlot(uiSlot, EZ_FAILURE);
+
+      continue;
+    }
+
+    slot.m_uiBytesRead += static_cast<ezUInt64>(iResult);
+
+    // reads may return less data than requested, reading nothing means the end of the file was reached
+    if (iResult > 0 && slot.m_uiBytesRead < slot.m_Read.m_Read.m_uiSize)
+    {
+      if (bCanceling)
+        FinishSlot(uiSlot, EZ_FAILURE);
+      else
+        SubmitRead(uiSlot);
+
+      continue;
+    }
+
+    FinishSlot(uiSlot, EZ_SUCCESS);
+  }
+
+  __atomic_store_n(m_pCompletionHead, uiHead, __ATOMIC_RELEASE);
+}
+
+void ezAsyncFileReaderBackend_IoUring::FinishSlot(ezUInt32 uiSlot, ezResult result)
+{
+  Slot& slot = m_Slots[uiSlot];
+
+  ReleaseFile(slot.m_Read.m_sAbsolutePath);
+  slot.m_iFile = -1;
+
+  --m_uiNumReadsInFlight;
+  FinishRead(slot.m_Read, slot.m_uiBytesRead, result);
+
+  m_FreeSlots.PushBack(uiSlot);
+}
+
+int ezAsyncFileReaderBackend_IoUring::AcquireFile(const ezString& sPath)
+{
+  // Reads of the same file are often submitted together, e.g. for archives, so the file handles are shared.
+  OpenFile* pFile = nullptr;
+  if (!m_OpenFiles.TryGetValue(sPath, pFile))
+  {
+    const int iFile = open(sPath.GetData(), O_RDONLY | O_CLOEXEC);
+    if (iFile < 0)
+      return -1;
+
+    pFile = &m_OpenFiles[sPath];
+    pFile->m_iFile = iFile;
+  }
+
+  ++pFile->m_uiNumUsers;
+  return pFile->m_iFile;
+}
+
+void ezAsyncFileReaderBackend_IoUring::ReleaseFile(const ezString& sPath)
+{
+  OpenFile* pFile = nullptr;
+  if (!m_OpenFiles.TryGetValue(sPath, pFile))
+    return;
+
+  if (--pFile->m_uiNumUsers == 0)
+  {
+    close(pFile->m_iFile);
+    m_OpenFiles.Remove(sPath);
+  }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Foundation/FoundationInternal.h>
+EZ_FOUNDATION_INTERNAL_HEADER
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#  include <Foundation/Containers/HashTable.h>
+#  include <Foundation/IO/Implementation/AsyncFileReaderBackend.h>
+#  include <Foundation/Threading/Mutex.h>
+#  include <Foundation/Threading/Thread.h>
+#  include <Foundation/Threading/ThreadSignal.h>
+
+#  include <sys/uio.h>
+
+/// \brief Executes the reads of an ezAsyncFileReader through an io_uring.
+///
+/// A single thread owns the ring. It opens the files, submits up to the configured number of reads at once
+/// and calls the completion callbacks when the kernel reports the results, so all callbacks are serialized on that thread.
+///
+/// If the ring fails with a hard error, the reads that the kernel is still working on are canceled and waited for.
+/// Then all reads in flight are finished as failed and the thread hands the queue over to an ezAsyncFileReaderBackend_ThreadPool,
+/// which executes all further reads.
+class ezAsyncFileReaderBackend_IoUring : public ezAsyncFileReaderBackend
+{
+public:
+  ezAsyncFileReaderBackend_IoUring(ezAsyncFileReader* pOwner);
+  ~ezAsyncFileReaderBackend_IoUring();
+
+  /// \brief Sets up the ring and starts the thread. Fails if the kernel does not support io_uring or it is disabled.
+  ezResult Initialize(ezUInt32 uiMaxReadsInFlight);
+
+  virtual void ReadsQueued(ezUInt32 uiNumReads) override;
+
+private:
+  class IoThread : public ezThread
+  {
+  public:
+    IoThread(ezAsyncFileReaderBackend_IoUring* pBackend)
+      : ezThread("ezAsyncFileReader")
+      , m_pBackend(pBackend)
+    {
+    }
+
+  private:
+    virtual ezUInt32 Run() override;
+
+    ezAsyncFileReaderBackend_IoUring* m_pBackend = nullptr;
+  };
+
+  struct Slot
+  {
+    QueuedRead m_Read;
+    int m_iFile = -1;
+    ezUInt64 m_uiBytesRead = 0;
+    iovec m_Buffer;
+  };
+
+  struct OpenFile
+  {
+    int m_iFile = -1;
+    ezUInt32 m_uiNumUsers = 0;
+  };
+
+  void ExecuteReads();
+  void SwitchToThreadPool();
+  void CancelAllReads();
+  void DestroyRing();
+  void StartRead(ezUInt32 uiSlot);
+  void SubmitRead(ezUInt32 uiSlot);
+  void HandleCompletions(bool bCanceling = false);
+  void FinishSlot(ezUInt32 uiSlot, ezResult result);
+
+  int AcquireFile(const ezString& sPath);
+  void ReleaseFile(const ezString& sPath);
+
+  int m_iRing = -1;
+  ezUInt32 m_uiMaxReadsInFlight = 0;
+  ezUInt32 m_uiNumReadsInFlight = 0;
+  ezUInt32 m_uiNumUnsubmitted = 0;
+
+  void* m_pSubmissionRing = nullptr;
+  size_t m_uiSubmissionRingSize = 0;
+  void* m_pCompletionRing = nullptr;
+  size_t m_uiCompletionRingSize = 0;
+  struct io_uring_sqe* m_pSubmissionEntries = nullptr;
+  size_t m_uiSubmissionEntriesSize = 0;
+
+  ezUInt32* m_pSubmissionHead = nullptr;
+  ezUInt32* m_pSubmissionTail = nullptr;
+  ezUInt32 m_uiSubmissionMask = 0;
+  ezUInt32* m_pSubmissionArray = nullptr;
+  ezUInt32* m_pCompletionHead = nullptr;
+  ezUInt32* m_pCompletionTail = nullptr;
+  ezUInt32 m_uiCompletionMask = 0;
+  struct io_uring_cqe* m_pCompletionEntries = nullptr;
+
+  ezDynamicArray<Slot> m_Slots;
+  ezDynamicArray<ezUInt32> m_FreeSlots;
+  ezHashTable<ezString, OpenFile> m_OpenFiles;
+
+  ezThreadSignal m_ReadsAvailable;
+  volatile bool m_bShutdown = false;
+  ezUniquePtr<IoThread> m_pThread;
+
+  ezMutex m_FallbackMutex;
+  ezUniquePtr<ezAsyncFileReaderBackend_ThreadPool> m_pFallback;
+};
+
+#endif
@@ -21,4 +21,19 @@ ezTime ezTime::Now()
   return ezTime::MakeFromSeconds((double)mach_absolute_time() * g_TimeFactor);
 }
 
+ezUInt64 ezTime::NowTicks()
+{
+  return mach_absolute_time();
+}
+
+double ezTime::GetTicksPerSecond()
+{
+  return 1.0 / g_TimeFactor;
+}
+
+ezTime ezTime::MakeFromTicks(ezUInt64 uiTicks)
+{
+  return ezTime::MakeFromSeconds((double)uiTicks * g_TimeFactor);
+}
+
 #endif
@@ -16,3 +16,21 @@ ezTime ezTime::Now()
 
   return ezTime::MakeFromSeconds((double)sp.tv_sec + (double)(sp.tv_nsec / 1000000000.0));
 }
+
+ezUInt64 ezTime::NowTicks()
+{
+  struct timespec sp;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &sp);
+
+  return (ezUInt64)sp.tv_sec * 1000000000ull + (ezUInt64)sp.tv_nsec;
+}
+
+double ezTime::GetTicksPerSecond()
+{
+  return 1000000000.0;
+}
+
+ezTime ezTime::MakeFromTicks(ezUInt64 uiTicks)
+{
+  return ezTime::MakeFromSeconds((double)(uiTicks / 1000000000ull) + (double)(uiTicks % 1000000000ull) / 1000000000.0);
+}
@@ -5,6 +5,7 @@
 #  include <Foundation/Basics/Platform/Win/IncludeWindows.h>
 #  include <Foundation/Time/Time.h>
 
+static double g_fQpcFrequency;
 static double g_fInvQpcFrequency;
 
 void ezTime::Initialize()
@@ -12,6 +13,7 @@ void ezTime::Initialize()
   LARGE_INTEGER frequency;
   QueryPerformanceFrequency(&frequency);
 
+  g_fQpcFrequency = double(frequency.QuadPart);
   g_fInvQpcFrequency = 1.0 / double(frequency.QuadPart);
 }
 
@@ -35,4 +37,22 @@ ezTime ezTime::Now()
   return ezTime::MakeFromSeconds(double(temp.QuadPart) * g_fInvQpcFrequency);
 }
 
+ezUInt64 ezTime::NowTicks()
+{
+  LARGE_INTEGER temp;
+  QueryPerformanceCounter(&temp);
+
+  return static_cast<ezUInt64>(temp.QuadPart);
+}
+
+double ezTime::GetTicksPerSecond()
+{
+  return g_fQpcFrequency;
+}
+
+ezTime ezTime::MakeFromTicks(ezUInt64 uiTicks)
+{
+  return ezTime::MakeFromSeconds(double(uiTicks) * g_fInvQpcFrequency);
+}
+
 #endif
@@ -4,11 +4,19 @@
 #include <Foundation/Communication/DataTransfer.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
 #include <Foundation/IO/JSONWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
 #if EZ_ENABLED(EZ_USE_PROFILING)
@@ -62,6 +70,7 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, ProfilingSystem)
   {
     s_ProfileCaptureDataTransfer.DisableDataTransfer();
     ezPlugin::Events().RemoveEventHandler(s_PluginEventSubscription);
+    ezProfilingSystem::StopStreamingCapture();
     ezProfilingSystem::Reset();
   }
 
@@ -70,10 +79,21 @@ EZ_END_SUBSYSTEM_DECLARATION;
 
 namespace
 {
+  /// \brief The compact representation of a CPU scope in the ring buffers. Names and timestamps are only resolved in ezProfilingSystem::Capture().
+  struct CPUScopeEvent
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiBeginTicks;
+    ezUInt32 m_uiNameId;
+    float m_fDurationTicks; ///< A float keeps enough precision for the microsecond resolution of the output and can't overflow for long scopes.
+  };
+
   enum
   {
-    BUFFER_SIZE_OTHER_THREAD = 1024 * 1024,
-    BUFFER_SIZE_MAIN_THREAD = BUFFER_SIZE_OTHER_THREAD * 4 ///< Typically the main thread allocated a lot more profiling events than other threads
+    BUFFER_SIZE_OTHER_THREAD = 256 * 1024,
+    BUFFER_SIZE_MAIN_THREAD = BUFFER_SIZE_OTHER_THREAD * 4, ///< Typically the main thread allocated a lot more profiling events than other threads
+    BUFFER_SIZE_GPU = 1024 * 1024,
   };
 
   enum
@@ -81,22 +101,55 @@ namespace
     BUFFER_SIZE_FRAMES = 120 * 60,
   };
 
-  using GPUScopesBuffer = ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::GPUScope)>;
+  using GPUScopesBuffer = ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_GPU / sizeof(ezProfilingSystem::GPUScope)>;
 
   static ezUInt64 s_MainThreadId = 0;
 
+  /// \brief Events of one thread for a streaming capture. Only the owning thread appends events, the streaming thread reads all committed events.
+  struct StreamBlock
+  {
+    static constexpr ezUInt32 NUM_EVENTS = 4096;
+
+    CPUScopeEvent m_Events[NUM_EVENTS];
+    ezAtomicInteger32 m_iCommitted; ///< Number of events that are fully written.
+    ezUInt32 m_uiFlushed = 0;       ///< Number of events that were already written to the file. Only accessed by the streaming thread.
+    ezInt32 m_iSession = 0;
+    ezUInt64 m_uiThreadId = 0;
+  };
+
+  /// \brief Remembers the IDs of recently recorded dynamic names, so that recording them usually doesn't need to lock s_ScopeNamesMutex.
+  struct DynamicScopeNameCache
+  {
+    static constexpr ezUInt32 NUM_ENTRIES = 256;
+    static constexpr ezUInt32 NAME_SIZE = 48; ///< Longer names are not cached.
+
+    struct Entry
+    {
+      ezUInt64 m_uiKey = 0;
+      const char* m_szFunctionName = nullptr;
+      ezUInt32 m_uiNameId = ezInvalidIndex;
+      ezUInt32 m_uiNameLength = 0;
+      char m_szName[NAME_SIZE];
+    };
+
+    Entry m_Entries[NUM_ENTRIES];
+  };
+
   struct CpuScopesBufferBase
   {
     virtual ~CpuScopesBufferBase() = default;
 
     ezUInt64 m_uiThreadId = 0;
+    StreamBlock* m_pStreamBlock = nullptr;   ///< Changed while holding s_StreamMutex, by the owning thread or when StopStreamingCapture() detaches it.
+    ezAtomicInteger32 m_iAppendingToStream; ///< Non-zero while the owning thread writes into m_pStreamBlock.
+    DynamicScopeNameCache m_NameCache;       ///< Only accessed by the owning thread.
     bool IsMainThread() const { return m_uiThreadId == s_MainThreadId; }
   };
 
   template <ezUInt32 SizeInBytes>
   struct CpuScopesBuffer : public CpuScopesBufferBase
   {
-    ezStaticRingBuffer<ezProfilingSystem::CPUScope, SizeInBytes / sizeof(ezProfilingSystem::CPUScope)> m_Data;
+    ezStaticRingBuffer<CPUScopeEvent, SizeInBytes / sizeof(CPUScopeEvent)> m_Data;
   };
 
   CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>* CastToMainThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
@@ -120,11 +173,92 @@ namespace
   static ezHybridArray<ezUInt64, 16> s_DeadThreadIDs;
   static ezMutex s_ThreadInfosMutex;
 
+  EZ_CHECK_AT_COMPILETIME(sizeof(CPUScopeEvent) == 16);
+
 #  if EZ_ENABLED(EZ_PLATFORM_64BIT)
   EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::CPUScope) == 64);
   EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::GPUScope) == 64);
 #  endif
 
+  struct ScopeName
+  {
+    ezUntrackedString m_sName;
+    ezUntrackedString m_sFunctionName;
+    const char* m_szFunctionNamePtr = nullptr; ///< The pointer that was passed in, only used for identifying the call site.
+  };
+
+  // a deque, so that the function names that are handed out by Capture() stay valid when more names are added
+  // interned names are never removed, because the call sites cache their IDs
+  static ezDeque<ScopeName, ezStaticsAllocatorWrapper> s_ScopeNames;
+  static ezHashTable<ezUInt64, ezUInt32, ezHashHelper<ezUInt64>, ezStaticsAllocatorWrapper> s_ScopeNameLookup;
+  static ezMutex s_ScopeNamesMutex;
+
+  // Names that are built at runtime, e.g. "Task-{invocation}", could make the table grow forever, so their number is limited per function.
+  // Once the limit is reached, new dynamic names of that function all share one entry.
+  static constexpr ezUInt32 s_uiMaxDynamicScopeNamesPerFunction = 4096;
+  static ezHashTable<const char*, ezUInt32, ezHashHelper<const void*>, ezStaticsAllocatorWrapper> s_NumDynamicScopeNames; // protected by s_ScopeNamesMutex
+
+  //////////////////////////////////////////////////////////////////////////
+  // Streaming capture
+
+  enum
+  {
+    STREAM_FILE_MAGIC = 0x5350455A, // 'EZPS'
+    STREAM_FILE_VERSION = 2, ///< Version 2 added the time range to the event chunks.
+  };
+
+  /// \brief The file consists of a header followed by chunks. Each chunk starts with its type.
+  enum class StreamChunk : ezUInt8
+  {
+    Names = 1,  ///< Interned scope names: count, then ID, name and function name for each.
+    Thread = 2, ///< Thread ID and name.
+    Events = 3, ///< Thread ID, count, first begin and last end ticks and the raw CPUScopeEvents.
+    Frames = 4, ///< Array with the start ticks of frames.
+    Hitch = 5,  ///< The ticks at which a hitch was detected.
+  };
+
+  /// \brief A chunk of event data that is held back in memory until a hitch occurs.
+  struct BufferedStreamChunk
+  {
+    ezUInt64 m_uiTicks = 0;
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  class StreamingCaptureThread;
+
+  struct StreamingCaptureState
+  {
+    ezProfilingSystem::StreamingCaptureSettings m_Settings;
+    ezOSFile m_File;
+    bool m_bWriteFailed = false;
+
+    ezUniquePtr<StreamingCaptureThread> m_pThread;
+    ezThreadSignal m_WakeUp;
+    ezAtomicBool m_bStopRequested;
+
+    // only accessed by the streaming thread
+    ezUInt32 m_uiWrittenNames = 0;
+    ezHashSet<ezUInt64> m_WrittenThreads;
+    ezDeque<BufferedStreamChunk> m_BufferedChunks;
+    ezUInt64 m_uiBufferedBytes = 0;
+    ezUInt64 m_uiWriteUntilTicks = 0;
+  };
+
+  static ezAtomicBool s_bStreamingActive;
+  static ezAtomicInteger32 s_iStreamSession;
+  static ezAtomicInteger64 s_iDroppedStreamEvents;
+  static ezMutex s_StreamMutex;
+  static ezUniquePtr<StreamingCaptureState> s_pStreamState;
+
+  // protected by s_StreamMutex
+  static ezDynamicArray<StreamBlock*> s_FreeStreamBlocks;
+  static ezDynamicArray<StreamBlock*> s_RetiredStreamBlocks;
+  static ezUInt32 s_uiNumStreamBlocks = 0;
+  static ezUInt32 s_uiMaxStreamBlocks = 0;
+  static ezDynamicArray<ezUInt64> s_PendingStreamFrames;
+  static ezDynamicArray<ezUInt64> s_PendingStreamHitches;
+  static ezUInt64 s_uiLastFrameStartTicks = 0;
+
   static thread_local CpuScopesBufferBase* s_CpuScopes = nullptr;
   static ezDynamicArray<CpuScopesBufferBase*> s_AllCpuScopes;
   static ezMutex s_AllCpuScopesMutex;
@@ -133,6 +267,347 @@ namespace
   static ezDynamicArray<ezUniquePtr<GPUScopesBuffer>> s_GPUScopes;
 } // namespace
 
+namespace
+{
+  /// \brief Returns a block to the pool, or deletes it, if it is not needed anymore. s_StreamMutex must be locked.
+  void ReleaseStreamBlock(StreamBlock* pBlock)
+  {
+    if (s_bStreamingActive)
+    {
+      s_FreeStreamBlocks.PushBack(pBlock);
+    }
+    else
+    {
+      EZ_DEFAULT_DELETE(pBlock);
+      --s_uiNumStreamBlocks;
+    }
+  }
+
+  /// \brief Takes the current block away from a thread. s_StreamMutex must be locked.
+  void RetireStreamBlock(CpuScopesBufferBase* pScopes)
+  {
+    StreamBlock* pOldBlock = pScopes->m_pStreamBlock;
+    pScopes->m_pStreamBlock = nullptr;
+
+    if (pOldBlock != nullptr)
+    {
+      if (s_bStreamingActive && pOldBlock->m_iSession == s_iStreamSession)
+      {
+        // the streaming thread writes the remaining events and recycles the block afterwards
+        s_RetiredStreamBlocks.PushBack(pOldBlock);
+      }
+      else
+      {
+        ReleaseStreamBlock(pOldBlock);
+      }
+    }
+  }
+
+  StreamBlock* AcquireStreamBlock(CpuScopesBufferBase* pScopes)
+  {
+    EZ_LOCK(s_StreamMutex);
+
+    RetireStreamBlock(pScopes);
+
+    if (!s_bStreamingActive)
+      return nullptr;
+
+    StreamBlock* pBlock = nullptr;
+    if (!s_FreeStreamBlocks.IsEmpty())
+    {
+      pBlock = s_FreeStreamBlocks.PeekBack();
+      s_FreeStreamBlocks.PopBack();
+    }
+    else if (s_uiNumStreamBlocks < s_uiMaxStreamBlocks)
+    {
+      pBlock = EZ_DEFAULT_NEW(StreamBlock);
+      ++s_uiNumStreamBlocks;
+    }
+    else
+    {
+      // the streaming thread can't keep up
+      return nullptr;
+    }
+
+    pBlock->m_iCommitted = 0;
+    pBlock->m_uiFlushed = 0;
+    pBlock->m_iSession = s_iStreamSession;
+    pBlock->m_uiThreadId = pScopes->m_uiThreadId;
+
+    pScopes->m_pStreamBlock = pBlock;
+    return pBlock;
+  }
+
+  void AppendToStream(CpuScopesBufferBase* pScopes, const CPUScopeEvent& scope)
+  {
+    // StopStreamingCapture() waits for this to be reset, before it deletes the blocks that it detached from the threads
+    pScopes->m_iAppendingToStream.Increment();
+
+    StreamBlock* pBlock = pScopes->m_pStreamBlock;
+
+    if (pBlock == nullptr || pBlock->m_iSession != s_iStreamSession || pBlock->m_iCommitted == StreamBlock::NUM_EVENTS)
+    {
+      pBlock = AcquireStreamBlock(pScopes);
+    }
+
+    if (pBlock != nullptr)
+    {
+      pBlock->m_Events[pBlock->m_iCommitted] = scope;
+      pBlock->m_iCommitted.Increment();
+    }
+    else if (s_bStreamingActive)
+    {
+      // events that race with StopStreamingCapture() are simply too late, not dropped
+      s_iDroppedStreamEvents.Increment();
+    }
+
+    pScopes->m_iAppendingToStream.Decrement();
+  }
+
+  void WriteStreamData(StreamingCaptureState& ref_state, const ezDynamicArray<ezUInt8>& data)
+  {
+    if (data.IsEmpty() || ref_state.m_bWriteFailed)
+      return;
+
+    if (ref_state.m_File.Write(data.GetData(), data.GetCount()).Failed())
+    {
+      ref_state.m_bWriteFailed = true;
+      ezLog::Error("Writing the streaming profiling capture to '{}' failed.", ref_state.m_Settings.m_sFile);
+    }
+  }
+
+  void WriteStreamEvents(ezStreamWriter& inout_writer, StreamBlock* pBlock)
+  {
+    const ezUInt32 uiCommitted = pBlock->m_iCommitted;
+    if (uiCommitted <= pBlock->m_uiFlushed)
+      return;
+
+    const ezUInt32 uiCount = uiCommitted - pBlock->m_uiFlushed;
+
+    // the time range allows readers to skip chunks that are outside of the requested window
+    ezUInt64 uiMinBeginTicks = ezMath::MaxValue<ezUInt64>();
+    ezUInt64 uiMaxEndTicks = 0;
+    for (ezUInt32 i = pBlock->m_uiFlushed; i < uiCommitted; ++i)
+    {
+      const CPUScopeEvent& scope = pBlock->m_Events[i];
+      uiMinBeginTicks = ezMath::Min(uiMinBeginTicks, scope.m_uiBeginTicks);
+      uiMaxEndTicks = ezMath::Max(uiMaxEndTicks, scope.m_uiBeginTicks + static_cast<ezUInt64>(scope.m_fDurationTicks) + 1);
+    }
+
+    inout_writer << static_cast<ezUInt8>(StreamChunk::Events);
+    inout_writer << pBlock->m_uiThreadId;
+    inout_writer << uiCount;
+    inout_writer << uiMinBeginTicks;
+    inout_writer << uiMaxEndTicks;
+    inout_writer.WriteBytes(&pBlock->m_Events[pBlock->m_uiFlushed], sizeof(CPUScopeEvent) * uiCount).IgnoreResult();
+
+    pBlock->m_uiFlushed = uiCommitted;
+  }
+
+  /// \brief Writes everything that was recorded since the last flush. Only called by the streaming thread, or after it has finished.
+  ///
+  /// \a detachedBlocks are the blocks that StopStreamingCapture() took away from the threads, they are owned by the caller.
+  void FlushStream(StreamingCaptureState& ref_state, ezArrayPtr<StreamBlock* const> detachedBlocks = {})
+  {
+    ezDynamicArray<ezUInt8> metaData;
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> metaStorage(&metaData);
+    ezMemoryStreamWriter metaWriter(&metaStorage);
+
+    ezDynamicArray<ezUInt8> eventData;
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> eventStorage(&eventData);
+    ezMemoryStreamWriter eventWriter(&eventStorage);
+
+    // new scope names
+    {
+      EZ_LOCK(s_ScopeNamesMutex);
+
+      const ezUInt32 uiNumNames = s_ScopeNames.GetCount();
+      if (uiNumNames > ref_state.m_uiWrittenNames)
+      {
+        metaWriter << static_cast<ezUInt8>(StreamChunk::Names);
+        metaWriter << (uiNumNames - ref_state.m_uiWrittenNames);
+
+        for (ezUInt32 i = ref_state.m_uiWrittenNames; i < uiNumNames; ++i)
+        {
+          const ScopeName& name = s_ScopeNames[i];
+
+          metaWriter << i;
+          metaWriter << name.m_sName.GetView();
+          metaWriter << (name.m_szFunctionNamePtr != nullptr ? name.m_sFunctionName.GetView() : ezStringView());
+        }
+
+        ref_state.m_uiWrittenNames = uiNumNames;
+      }
+    }
+
+    // new threads
+    {
+      EZ_LOCK(s_ThreadInfosMutex);
+
+      for (const auto& info : s_ThreadInfos)
+      {
+        if (!ref_state.m_WrittenThreads.Insert(info.m_uiThreadId))
+        {
+          metaWriter << static_cast<ezUInt8>(StreamChunk::Thread);
+          metaWriter << info.m_uiThreadId;
+          metaWriter << info.m_sName;
+        }
+      }
+    }
+
+    ezHybridArray<StreamBlock*, 16> retiredBlocks;
+    ezHybridArray<ezUInt64, 16> hitches;
+
+    {
+      // prevents Reset() from deleting the blocks of dead threads while they are written
+      EZ_LOCK(s_AllCpuScopesMutex);
+
+      ezHybridArray<StreamBlock*, 16> currentBlocks;
+      ezHybridArray<ezUInt64, 16> frames;
+
+      {
+        EZ_LOCK(s_StreamMutex);
+
+        retiredBlocks = s_RetiredStreamBlocks;
+        s_RetiredStreamBlocks.Clear();
+
+        for (CpuScopesBufferBase* pScopes : s_AllCpuScopes)
+        {
+          if (pScopes->m_pStreamBlock != nullptr && pScopes->m_pStreamBlock->m_iSession == s_iStreamSession)
+          {
+            currentBlocks.PushBack(pScopes->m_pStreamBlock);
+          }
+        }
+
+        frames = s_PendingStreamFrames;
+        s_PendingStreamFrames.Clear();
+
+        hitches = s_PendingStreamHitches;
+        s_PendingStreamHitches.Clear();
+      }
+
+      // blocks that were retired and blocks that are still being filled are never recycled by anyone but this function
+      for (StreamBlock* pBlock : retiredBlocks)
+      {
+        WriteStreamEvents(eventWriter, pBlock);
+      }
+
+      for (StreamBlock* pBlock : currentBlocks)
+      {
+        WriteStreamEvents(eventWriter, pBlock);
+      }
+
+      for (StreamBlock* pBlock : detachedBlocks)
+      {
+        WriteStreamEvents(eventWriter, pBlock);
+      }
+
+      if (!frames.IsEmpty())
+      {
+        eventWriter << static_cast<ezUInt8>(StreamChunk::Frames);
+        eventWriter.WriteArray(frames).IgnoreResult();
+      }
+    }
+
+    {
+      EZ_LOCK(s_StreamMutex);
+
+      for (StreamBlock* pBlock : retiredBlocks)
+      {
+        ReleaseStreamBlock(pBlock);
+      }
+    }
+
+    WriteStreamData(ref_state, metaData);
+
+    ezDynamicArray<ezUInt8> hitchData;
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> hitchStorage(&hitchData);
+    ezMemoryStreamWriter hitchWriter(&hitchStorage);
+
+    for (ezUInt64 uiHitchTicks : hitches)
+    {
+      hitchWriter << static_cast<ezUInt8>(StreamChunk::Hitch);
+      hitchWriter << uiHitchTicks;
+    }
+
+    WriteStreamData(ref_state, hitchData);
+
+    if (!ref_state.m_Settings.m_bOnlyWriteHitches)
+    {
+      WriteStreamData(ref_state, eventData);
+      return;
+    }
+
+    const ezUInt64 uiNowTicks = ezTime::NowTicks();
+    const ezUInt64 uiWindowTicks = static_cast<ezUInt64>(ref_state.m_Settings.m_HitchWindow.GetSeconds() * ezTime::GetTicksPerSecond());
+
+    if (!hitches.IsEmpty())
+    {
+      // everything that was held back is within the window before the hitch
+      for (const BufferedStreamChunk& chunk : ref_state.m_BufferedChunks)
+      {
+        WriteStreamData(ref_state, chunk.m_Data);
+      }
+
+      ref_state.m_BufferedChunks.Clear();
+      ref_state.m_uiBufferedBytes = 0;
+
+      for (ezUInt64 uiHitchTicks : hitches)
+      {
+        ref_state.m_uiWriteUntilTicks = ezMath::Max(ref_state.m_uiWriteUntilTicks, uiHitchTicks + uiWindowTicks);
+      }
+    }
+
+    if (uiNowTicks <= ref_state.m_uiWriteUntilTicks)
+    {
+      WriteStreamData(ref_state, eventData);
+      return;
+    }
+
+    if (!eventData.IsEmpty())
+    {
+      ref_state.m_uiBufferedBytes += eventData.GetCount();
+
+      BufferedStreamChunk& chunk = ref_state.m_BufferedChunks.ExpandAndGetRef();
+      chunk.m_uiTicks = uiNowTicks;
+      chunk.m_Data = std::move(eventData);
+    }
+
+    const ezUInt64 uiMaxBufferedBytes = static_cast<ezUInt64>(ref_state.m_Settings.m_uiMaxHitchBufferMB) * 1024 * 1024;
+
+    while (!ref_state.m_BufferedChunks.IsEmpty() && (ref_state.m_BufferedChunks.PeekFront().m_uiTicks + uiWindowTicks < uiNowTicks || ref_state.m_uiBufferedBytes > uiMaxBufferedBytes))
+    {
+      ref_state.m_uiBufferedBytes -= ref_state.m_BufferedChunks.PeekFront().m_Data.GetCount();
+      ref_state.m_BufferedChunks.PopFront();
+    }
+  }
+
+  class StreamingCaptureThread : public ezThread
+  {
+  public:
+    StreamingCaptureThread(StreamingCaptureState& ref_state)
+      : ezThread("Profiling Stream")
+      , m_State(ref_state)
+    {
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (!m_State.m_bStopRequested)
+      {
+        m_State.m_WakeUp.WaitForSignal(m_State.m_Settings.m_FlushInterval);
+
+        FlushStream(m_State);
+      }
+
+      return 0;
+    }
+
+    StreamingCaptureState& m_State;
+  };
+} // namespace
+
 void ezProfilingSystem::ProfilingData::Clear()
 {
   m_uiFramesThreadID = 0;
@@ -596,6 +1071,9 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& ref_profilingD
 
   {
     EZ_LOCK(s_AllCpuScopesMutex);
+    EZ_LOCK(s_ScopeNamesMutex);
+
+    const double fSecondsPerTick = 1.0 / ezTime::GetTicksPerSecond();
 
     ref_profilingData.m_AllEventBuffers.Reserve(s_AllCpuScopes.GetCount());
     for (ezUInt32 i = 0; i < s_AllCpuScopes.GetCount(); ++i)
@@ -609,13 +1087,14 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& ref_profilingD
       targetEventBuffer.m_Data.SetCountUninitialized(uiSourceCount);
       for (ezUInt32 j = 0; j < uiSourceCount; ++j)
       {
-        const CPUScope& sourceEvent = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data[j] : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data[j];
+        const CPUScopeEvent& sourceEvent = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data[j] : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data[j];
+        const ScopeName& name = s_ScopeNames[sourceEvent.m_uiNameId];
 
         CPUScope& copiedEvent = targetEventBuffer.m_Data[j];
-        copiedEvent.m_szFunctionName = sourceEvent.m_szFunctionName;
-        copiedEvent.m_BeginTime = sourceEvent.m_BeginTime;
-        copiedEvent.m_EndTime = sourceEvent.m_EndTime;
-        ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
+        copiedEvent.m_szFunctionName = name.m_szFunctionNamePtr != nullptr ? name.m_sFunctionName.GetData() : nullptr;
+        copiedEvent.m_BeginTime = ezTime::MakeFromTicks(sourceEvent.m_uiBeginTicks);
+        copiedEvent.m_EndTime = copiedEvent.m_BeginTime + ezTime::MakeFromSeconds(sourceEvent.m_fDurationTicks * fSecondsPerTick);
+        ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, name.m_sName.GetData());
       }
     }
   }
@@ -682,16 +1161,569 @@ void ezProfilingSystem::StartNewFrame()
     s_FrameStartTimes.PopFront();
   }
 
-  s_FrameStartTimes.PushBack(ezTime::Now());
+  const ezUInt64 uiNowTicks = ezTime::NowTicks();
+  s_FrameStartTimes.PushBack(ezTime::MakeFromTicks(uiNowTicks));
+
+  if (s_bStreamingActive)
+  {
+    EZ_LOCK(s_StreamMutex);
+
+    if (s_pStreamState != nullptr)
+    {
+      const ezTime hitchThreshold = s_pStreamState->m_Settings.m_HitchThreshold;
+      if (hitchThreshold.IsPositive() && s_uiLastFrameStartTicks != 0 && ezTime::MakeFromTicks(uiNowTicks) - ezTime::MakeFromTicks(s_uiLastFrameStartTicks) > hitchThreshold)
+      {
+        s_PendingStreamHitches.PushBack(s_uiLastFrameStartTicks);
+      }
+
+      s_PendingStreamFrames.PushBack(uiNowTicks);
+    }
+  }
+
+  s_uiLastFrameStartTicks = uiNowTicks;
+}
+
+// static
+ezResult ezProfilingSystem::StartStreamingCapture(const StreamingCaptureSettings& settings)
+{
+  StopStreamingCapture();
+
+  ezUniquePtr<StreamingCaptureState> pState = EZ_DEFAULT_NEW(StreamingCaptureState);
+  pState->m_Settings = settings;
+
+  if (pState->m_File.Open(settings.m_sFile, ezFileOpenMode::Write).Failed())
+  {
+    ezLog::Error("Failed to open '{}' for the streaming profiling capture.", settings.m_sFile);
+    return EZ_FAILURE;
+  }
+
+  {
+    ezDynamicArray<ezUInt8> header;
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> headerStorage(&header);
+    ezMemoryStreamWriter headerWriter(&headerStorage);
+
+#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+    const ezUInt32 uiProcessID = static_cast<ezUInt32>(ezProcess::GetCurrentProcessID());
+#  else
+    const ezUInt32 uiProcessID = 0;
+#  endif
+
+    headerWriter << static_cast<ezUInt32>(STREAM_FILE_MAGIC);
+    headerWriter << static_cast<ezUInt8>(STREAM_FILE_VERSION);
+    headerWriter << ezTime::GetTicksPerSecond();
+    headerWriter << uiProcessID;
+
+    WriteStreamData(*pState, header);
+  }
+
+  {
+    EZ_LOCK(s_StreamMutex);
+
+    s_pStreamState = std::move(pState);
+    s_uiMaxStreamBlocks = ezMath::Max(settings.m_uiMaxBlocks, 1u);
+    s_iDroppedStreamEvents = 0;
+    s_PendingStreamFrames.Clear();
+    s_PendingStreamHitches.Clear();
+    s_iStreamSession.Increment();
+    s_bStreamingActive = true;
+  }
+
+  s_pStreamState->m_pThread = EZ_DEFAULT_NEW(StreamingCaptureThread, *s_pStreamState);
+  s_pStreamState->m_pThread->Start();
+
+  return EZ_SUCCESS;
+}
+
+// static
+void ezProfilingSystem::StopStreamingCapture()
+{
+  if (s_pStreamState == nullptr)
+    return;
+
+  // Once streaming is inactive, threads delete their blocks instead of retiring them.
+  // So all blocks of this session are taken away from them first, and only deleted after the final flush has written them.
+  ezDynamicArray<StreamBlock*> detachedBlocks;
+
+  {
+    // prevents Reset() from deleting the buffers of dead threads
+    EZ_LOCK(s_AllCpuScopesMutex);
+
+    {
+      EZ_LOCK(s_StreamMutex);
+      s_bStreamingActive = false;
+
+      detachedBlocks = s_RetiredStreamBlocks;
+      s_RetiredStreamBlocks.Clear();
+
+      for (CpuScopesBufferBase* pScopes : s_AllCpuScopes)
+      {
+        if (pScopes->m_pStreamBlock != nullptr && pScopes->m_pStreamBlock->m_iSession == s_iStreamSession)
+        {
+          detachedBlocks.PushBack(pScopes->m_pStreamBlock);
+          pScopes->m_pStreamBlock = nullptr;
+        }
+      }
+    }
+
+    // a thread may have read its block just before it was detached
+    for (CpuScopesBufferBase* pScopes : s_AllCpuScopes)
+    {
+      while (pScopes->m_iAppendingToStream > 0)
+      {
+        ezThreadUtils::YieldTimeSlice();
+      }
+    }
+  }
+
+  s_pStreamState->m_bStopRequested = true;
+  s_pStreamState->m_WakeUp.RaiseSignal();
+  s_pStreamState->m_pThread->Join();
+  s_pStreamState->m_pThread.Clear();
+
+  // everything that was recorded up to now
+  FlushStream(*s_pStreamState, detachedBlocks);
+
+  ezUniquePtr<StreamingCaptureState> pState;
+
+  {
+    EZ_LOCK(s_StreamMutex);
+
+    for (StreamBlock* pBlock : detachedBlocks)
+    {
+      EZ_DEFAULT_DELETE(pBlock);
+      --s_uiNumStreamBlocks;
+    }
+
+    // blocks of older sessions that are still held by threads are released when they record their next event
+    s_iStreamSession.Increment();
+
+    for (StreamBlock* pBlock : s_FreeStreamBlocks)
+    {
+      EZ_DEFAULT_DELETE(pBlock);
+      --s_uiNumStreamBlocks;
+    }
+
+    s_FreeStreamBlocks.Clear();
+    s_PendingStreamFrames.Clear();
+    s_PendingStreamHitches.Clear();
+
+    pState = std::move(s_pStreamState);
+  }
+
+  if (s_iDroppedStreamEvents > 0)
+  {
+    ezLog::Warning("The streaming profiling capture '{}' dropped {} events, because they were recorded faster than they could be written.", pState->m_Settings.m_sFile, (ezInt64)s_iDroppedStreamEvents);
+  }
+}
+
+// static
+bool ezProfilingSystem::IsStreamingCaptureActive()
+{
+  return s_bStreamingActive;
+}
+
+// static
+void ezProfilingSystem::TriggerStreamingCaptureHitch()
+{
+  if (!s_bStreamingActive)
+    return;
+
+  EZ_LOCK(s_StreamMutex);
+  s_PendingStreamHitches.PushBack(ezTime::NowTicks());
+}
+
+namespace
+{
+  /// \brief Reads a streaming capture through a small buffer, so that the file never has to be in memory as a whole.
+  class StreamFileReader : public ezStreamReader
+  {
+  public:
+    StreamFileReader(ezOSFile& ref_file)
+      : m_File(ref_file)
+    {
+    }
+
+    virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override
+    {
+      ezUInt8* pDestination = static_cast<ezUInt8*>(pReadBuffer);
+      ezUInt64 uiBytesRead = 0;
+
+      while (uiBytesRead < uiBytesToRead)
+      {
+        if (m_uiReadPos == m_uiBufferSize)
+        {
+          // large reads bypass the buffer
+          if (uiBytesToRead - uiBytesRead >= BUFFER_SIZE)
+            return uiBytesRead + m_File.Read(pDestination + uiBytesRead, uiBytesToRead - uiBytesRead);
+
+          m_uiBufferSize = static_cast<ezUInt32>(m_File.Read(m_Buffer, BUFFER_SIZE));
+          m_uiReadPos = 0;
+
+          if (m_uiBufferSize == 0)
+            break;
+        }
+
+        const ezUInt32 uiChunk = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(m_uiBufferSize - m_uiReadPos, uiBytesToRead - uiBytesRead));
+        ezMemoryUtils::Copy(pDestination + uiBytesRead, m_Buffer + m_uiReadPos, uiChunk);
+        m_uiReadPos += uiChunk;
+        uiBytesRead += uiChunk;
+      }
+
+      return uiBytesRead;
+    }
+
+    virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override
+    {
+      const ezUInt64 uiBuffered = ezMath::Min<ezUInt64>(m_uiBufferSize - m_uiReadPos, uiBytesToSkip);
+      m_uiReadPos += static_cast<ezUInt32>(uiBuffered);
+
+      if (uiBuffered == uiBytesToSkip)
+        return uiBytesToSkip;
+
+      const ezUInt64 uiFilePos = m_File.GetFilePosition();
+      const ezUInt64 uiFileSize = m_File.GetFileSize();
+      const ezUInt64 uiSkipInFile = ezMath::Min(uiBytesToSkip - uiBuffered, uiFileSize - ezMath::Min(uiFilePos, uiFileSize));
+
+      m_File.SetFilePosition(static_cast<ezInt64>(uiSkipInFile), ezFileSeekMode::FromCurrent);
+      return uiBuffered + uiSkipInFile;
+    }
+
+  private:
+    static constexpr ezUInt32 BUFFER_SIZE = 64 * 1024;
+
+    ezOSFile& m_File;
+    ezUInt32 m_uiReadPos = 0;
+    ezUInt32 m_uiBufferSize = 0;
+    ezUInt8 m_Buffer[BUFFER_SIZE];
+  };
+} // namespace
+
+// static
+ezResult ezProfilingSystem::ReadStreamingCapture(ezStringView sFile, ProfilingData& out_capture, ezTime windowStart, ezTime windowEnd, ezDynamicArray<ezTime>* out_pHitches)
+{
+  out_capture.Clear();
+
+  if (out_pHitches != nullptr)
+  {
+    out_pHitches->Clear();
+  }
+
+  ezOSFile file;
+  if (file.Open(sFile, ezFileOpenMode::Read).Failed())
+  {
+    ezLog::Error("Failed to open streaming profiling capture '{}'.", sFile);
+    return EZ_FAILURE;
+  }
+
+  // captures can get very large, so the file is read chunk by chunk and only the events within the window are kept
+  ezUniquePtr<StreamFileReader> pReader = EZ_DEFAULT_NEW(StreamFileReader, file);
+  StreamFileReader& reader = *pReader;
+
+  ezUInt32 uiMagic = 0;
+  ezUInt8 uiVersion = 0;
+  double fTicksPerSecond = 0;
+  ezUInt32 uiProcessID = 0;
+  reader >> uiMagic;
+  reader >> uiVersion;
+  reader >> fTicksPerSecond;
+  reader >> uiProcessID;
+
+  if (uiMagic != STREAM_FILE_MAGIC || uiVersion < 1 || uiVersion > STREAM_FILE_VERSION || fTicksPerSecond <= 0.0)
+  {
+    ezLog::Error("'{}' is not a valid streaming profiling capture.", sFile);
+    return EZ_FAILURE;
+  }
+
+  out_capture.m_uiProcessID = static_cast<ezOsProcessID>(uiProcessID);
+
+  auto TicksToTime = [=](ezUInt64 uiTicks)
+  { return ezTime::MakeFromSeconds(static_cast<double>(uiTicks) / fTicksPerSecond); };
+
+  const bool bOpenEnd = windowEnd.IsZero();
+  auto IsInWindow = [&](ezTime begin, ezTime end)
+  { return end >= windowStart && (bOpenEnd || begin <= windowEnd); };
+
+  struct StreamedName
+  {
+    ezString m_sName;
+    ezHashedString m_sFunctionName; ///< Keeps the function name alive for as long as the process runs, like the names in a regular capture.
+  };
+
+  // Names may be written after the first events that use them, so the events are only resolved once the whole file was read.
+  ezHashTable<ezUInt32, StreamedName> names;
+  ezMap<ezUInt64, ezDynamicArray<CPUScopeEvent>> events;
+  ezDynamicArray<ezUInt64> frames;
+  ezDynamicArray<CPUScopeEvent> chunkEvents;
+
+  ezStringBuilder sTemp;
+  bool bEndOfFile = false;
+
+  while (!bEndOfFile)
+  {
+    ezUInt8 uiChunk = 0;
+    if (reader.ReadBytes(&uiChunk, sizeof(ezUInt8)) == 0)
+      break;
+
+    switch (static_cast<StreamChunk>(uiChunk))
+    {
+      case StreamChunk::Names:
+      {
+        ezUInt32 uiCount = 0;
+        reader >> uiCount;
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          ezUInt32 uiNameId = 0;
+          reader >> uiNameId;
+
+          StreamedName& name = names[uiNameId];
+          reader >> sTemp;
+          name.m_sName = sTemp;
+          reader >> sTemp;
+          name.m_sFunctionName.Assign(sTemp);
+        }
+        break;
+      }
+
+      case StreamChunk::Thread:
+      {
+        ThreadInfo& info = out_capture.m_ThreadInfos.ExpandAndGetRef();
+        reader >> info.m_uiThreadId;
+        reader >> info.m_sName;
+        break;
+      }
+
+      case StreamChunk::Events:
+      {
+        ezUInt64 uiThreadId = 0;
+        ezUInt32 uiCount = 0;
+        reader >> uiThreadId;
+        reader >> uiCount;
+
+        const ezUInt64 uiBytes = sizeof(CPUScopeEvent) * uiCount;
+
+        if (uiVersion >= 2)
+        {
+          ezUInt64 uiMinBeginTicks = 0;
+          ezUInt64 uiMaxEndTicks = 0;
+          reader >> uiMinBeginTicks;
+          reader >> uiMaxEndTicks;
+
+          if (!IsInWindow(TicksToTime(uiMinBeginTicks), TicksToTime(uiMaxEndTicks)))
+          {
+            bEndOfFile = reader.SkipBytes(uiBytes) != uiBytes;
+            break;
+          }
+        }
+
+        // one chunk never holds more than the events of one stream block
+        if (uiCount > StreamBlock::NUM_EVENTS)
+        {
+          ezLog::Error("Streaming profiling capture '{}' is corrupted.", sFile);
+          return EZ_FAILURE;
+        }
+
+        chunkEvents.SetCountUninitialized(uiCount);
+        if (reader.ReadBytes(chunkEvents.GetData(), uiBytes) != uiBytes)
+        {
+          // the file was cut off, e.g. because the process crashed while writing
+          bEndOfFile = true;
+          break;
+        }
+
+        ezDynamicArray<CPUScopeEvent>* pThreadEvents = nullptr;
+        for (const CPUScopeEvent& sourceEvent : chunkEvents)
+        {
+          const ezTime beginTime = TicksToTime(sourceEvent.m_uiBeginTicks);
+          const ezTime endTime = beginTime + ezTime::MakeFromSeconds(sourceEvent.m_fDurationTicks / fTicksPerSecond);
+
+          if (!IsInWindow(beginTime, endTime))
+            continue;
+
+          if (pThreadEvents == nullptr)
+          {
+            pThreadEvents = &events[uiThreadId];
+          }
+
+          pThreadEvents->PushBack(sourceEvent);
+        }
+        break;
+      }
+
+      case StreamChunk::Frames:
+      {
+        ezDynamicArray<ezUInt64> chunkFrames;
+        if (reader.ReadArray(chunkFrames).Failed())
+        {
+          bEndOfFile = true;
+          break;
+        }
+
+        frames.PushBackRange(chunkFrames);
+        break;
+      }
+
+      case StreamChunk::Hitch:
+      {
+        ezUInt64 uiHitchTicks = 0;
+        reader >> uiHitchTicks;
+
+        if (out_pHitches != nullptr)
+        {
+          out_pHitches->PushBack(TicksToTime(uiHitchTicks));
+        }
+        break;
+      }
+
+      default:
+        ezLog::Error("Streaming profiling capture '{}' is corrupted.", sFile);
+        return EZ_FAILURE;
+    }
+  }
+
+  out_capture.m_AllEventBuffers.Reserve(events.GetCount());
+
+  for (auto it : events)
+  {
+    CPUScopesBufferFlat& eventBuffer = out_capture.m_AllEventBuffers.ExpandAndGetRef();
+    eventBuffer.m_uiThreadId = it.Key();
+
+    for (const CPUScopeEvent& sourceEvent : it.Value())
+    {
+      const ezTime beginTime = TicksToTime(sourceEvent.m_uiBeginTicks);
+      const ezTime endTime = beginTime + ezTime::MakeFromSeconds(sourceEvent.m_fDurationTicks / fTicksPerSecond);
+
+      const StreamedName* pName = names.GetValue(sourceEvent.m_uiNameId);
+      if (pName == nullptr)
+        continue;
+
+      CPUScope& scope = eventBuffer.m_Data.ExpandAndGetRef();
+      scope.m_szFunctionName = pName->m_sFunctionName.IsEmpty() ? nullptr : pName->m_sFunctionName.GetData();
+      scope.m_BeginTime = beginTime;
+      scope.m_EndTime = endTime;
+      ezStringUtils::Copy(scope.m_szName, CPUScope::NAME_SIZE, pName->m_sName.GetData());
+    }
+  }
+
+  for (ezUInt32 i = 0; i < frames.GetCount(); ++i)
+  {
+    const ezTime frameStart = TicksToTime(frames[i]);
+    if (IsInWindow(frameStart, frameStart))
+    {
+      out_capture.m_FrameStartTimes.PushBack(frameStart);
+      out_capture.m_uiFrameCount = i + 1;
+    }
+  }
+
+  return EZ_SUCCESS;
 }
 
 // static
 void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout)
 {
-  const ezTime duration = endTime - beginTime;
+  const double fTicksPerSecond = ezTime::GetTicksPerSecond();
+  const ezUInt64 uiBeginTicks = static_cast<ezUInt64>(beginTime.GetSeconds() * fTicksPerSecond);
+  const ezUInt64 uiEndTicks = static_cast<ezUInt64>(endTime.GetSeconds() * fTicksPerSecond);
+
+  AddCPUScope(ezInvalidIndex, sName, szFunctionName, uiBeginTicks, uiEndTicks, scopeTimeout);
+}
+
+namespace
+{
+  ezUInt64 ComputeScopeNameKey(ezStringView sName, const char* szFunctionName)
+  {
+    // the function name is identified by its pointer, it is always a string literal from EZ_SOURCE_FUNCTION
+    return ezHashingUtils::xxHash64String(sName, reinterpret_cast<ezUInt64>(szFunctionName));
+  }
+
+  /// \brief s_ScopeNamesMutex must be locked.
+  ezUInt32 InternScopeNameLocked(ezUInt64 uiKey, ezStringView sName, const char* szFunctionName, bool bDynamic)
+  {
+    // resolve hash collisions by probing the following keys
+    while (true)
+    {
+      const ezUInt32* pNameId = s_ScopeNameLookup.GetValue(uiKey);
+      if (pNameId == nullptr)
+        break;
+
+      const ScopeName& name = s_ScopeNames[*pNameId];
+      if (name.m_szFunctionNamePtr == szFunctionName && name.m_sName == sName)
+        return *pNameId;
+
+      ++uiKey;
+    }
+
+    if (bDynamic)
+    {
+      ezUInt32& uiNumDynamicNames = s_NumDynamicScopeNames[szFunctionName];
+      if (uiNumDynamicNames >= s_uiMaxDynamicScopeNamesPerFunction)
+      {
+        const ezStringView sOverflowName = "(too many dynamic scope names)";
+        return InternScopeNameLocked(ComputeScopeNameKey(sOverflowName, szFunctionName), sOverflowName, szFunctionName, false);
+      }
+
+      ++uiNumDynamicNames;
+    }
+
+    const ezUInt32 uiNameId = s_ScopeNames.GetCount();
+
+    ScopeName& name = s_ScopeNames.ExpandAndGetRef();
+    name.m_sName = sName;
+    name.m_sFunctionName = szFunctionName;
+    name.m_szFunctionNamePtr = szFunctionName;
+
+    s_ScopeNameLookup.Insert(uiKey, uiNameId);
+    return uiNameId;
+  }
+
+  ezUInt32 InternDynamicScopeName(DynamicScopeNameCache& ref_cache, ezStringView sName, const char* szFunctionName)
+  {
+    const ezUInt64 uiKey = ComputeScopeNameKey(sName, szFunctionName);
+    const ezUInt32 uiNameLength = sName.GetElementCount();
+
+    DynamicScopeNameCache::Entry& entry = ref_cache.m_Entries[uiKey % DynamicScopeNameCache::NUM_ENTRIES];
+    if (entry.m_uiNameId != ezInvalidIndex && entry.m_uiKey == uiKey && entry.m_szFunctionName == szFunctionName && entry.m_uiNameLength == uiNameLength &&
+        ezMemoryUtils::IsEqual(entry.m_szName, sName.GetStartPointer(), uiNameLength))
+    {
+      return entry.m_uiNameId;
+    }
+
+    ezUInt32 uiNameId;
+    {
+      EZ_LOCK(s_ScopeNamesMutex);
+      uiNameId = InternScopeNameLocked(uiKey, sName, szFunctionName, true);
+    }
+
+    if (uiNameLength <= DynamicScopeNameCache::NAME_SIZE)
+    {
+      entry.m_uiKey = uiKey;
+      entry.m_szFunctionName = szFunctionName;
+      entry.m_uiNameId = uiNameId;
+      entry.m_uiNameLength = uiNameLength;
+      ezMemoryUtils::Copy(entry.m_szName, sName.GetStartPointer(), uiNameLength);
+    }
+
+    return uiNameId;
+  }
+} // namespace
+
+// static
+ezUInt32 ezProfilingSystem::InternScopeName(ezStringView sName, const char* szFunctionName)
+{
+  const ezUInt64 uiKey = ComputeScopeNameKey(sName, szFunctionName);
+
+  EZ_LOCK(s_ScopeNamesMutex);
+  return InternScopeNameLocked(uiKey, sName, szFunctionName, false);
+}
+
+// static
+void ezProfilingSystem::AddCPUScope(ezUInt32 uiNameId, ezStringView sName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks, ezTime scopeTimeout)
+{
+  const double fTicksPerSecond = ezTime::GetTicksPerSecond();
+  const ezUInt64 uiDurationTicks = uiEndTicks - uiBeginTicks;
 
   // discard?
-  if (duration < ezTime::MakeFromMilliseconds(cvar_ProfilingDiscardThresholdMS))
+  if (static_cast<double>(uiDurationTicks) < cvar_ProfilingDiscardThresholdMS * 0.001 * fTicksPerSecond)
     return;
 
   ::CpuScopesBufferBase* pScopes = s_CpuScopes;
@@ -716,13 +1748,17 @@ void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionNa
     }
   }
 
-  CPUScope scope;
-  scope.m_szFunctionName = szFunctionName;
-  scope.m_BeginTime = beginTime;
-  scope.m_EndTime = endTime;
-  ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), sName.GetStartPointer(), sName.GetEndPointer());
+  if (uiNameId == ezInvalidIndex)
+  {
+    uiNameId = InternDynamicScopeName(pScopes->m_NameCache, sName, szFunctionName);
+  }
+
+  CPUScopeEvent scope;
+  scope.m_uiBeginTicks = uiBeginTicks;
+  scope.m_uiNameId = uiNameId;
+  scope.m_fDurationTicks = static_cast<float>(uiDurationTicks);
 
-  if (ezThreadUtils::IsMainThread())
+  if (pScopes->IsMainThread())
   {
     auto pMainThreadBuffer = CastToMainThreadEventBuffer(pScopes);
     if (!pMainThreadBuffer->m_Data.CanAppend())
@@ -743,9 +1779,18 @@ void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionNa
     pOtherThreadBuffer->m_Data.PushBack(scope);
   }
 
-  if (scopeTimeout.IsPositive() && duration > scopeTimeout && s_ScopeTimeoutCallback.IsValid())
+  if (s_bStreamingActive)
+  {
+    AppendToStream(pScopes, scope);
+  }
+
+  if (scopeTimeout.IsPositive() && s_ScopeTimeoutCallback.IsValid())
   {
-    s_ScopeTimeoutCallback(sName, szFunctionName, duration);
+    const ezTime duration = ezTime::MakeFromSeconds(static_cast<double>(uiDurationTicks) / fTicksPerSecond);
+    if (duration > scopeTimeout)
+    {
+      s_ScopeTimeoutCallback(sName, szFunctionName, duration);
+    }
   }
 }
 
@@ -781,6 +1826,13 @@ void ezProfilingSystem::Reset()
       CpuScopesBufferBase* pEventBuffer = s_AllCpuScopes[k];
       if (pEventBuffer->m_uiThreadId == uiThreadId)
       {
+        if (pEventBuffer->m_pStreamBlock != nullptr)
+        {
+          EZ_LOCK(s_StreamMutex);
+          EZ_DEFAULT_DELETE(pEventBuffer->m_pStreamBlock);
+          --s_uiNumStreamBlocks;
+        }
+
         EZ_DEFAULT_DELETE(pEventBuffer);
         // Forward order and no swap important, see comment above.
         s_AllCpuScopes.RemoveAtAndCopy(k);
@@ -803,6 +1855,13 @@ void ezProfilingSystem::SetThreadName(ezStringView sThreadName)
 // static
 void ezProfilingSystem::RemoveThread()
 {
+  // the stream block of the thread is handed back right away, otherwise it would stay allocated until the next Reset()
+  if (s_CpuScopes != nullptr)
+  {
+    EZ_LOCK(s_StreamMutex);
+    RetireStreamBlock(s_CpuScopes);
+  }
+
   EZ_LOCK(s_ThreadInfosMutex);
 
   s_DeadThreadIDs.PushBack((ezUInt64)ezThreadUtils::GetCurrentThreadID());
@@ -846,17 +1905,18 @@ void ezProfilingSystem::AddGPUScope(ezStringView sName, ezTime beginTime, ezTime
 
 //////////////////////////////////////////////////////////////////////////
 
-ezProfilingScope::ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout)
+ezProfilingScope::ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout, ezUInt32 uiNameId)
   : m_sName(sName)
   , m_szFunction(szFunctionName)
-  , m_BeginTime(ezTime::Now())
+  , m_uiBeginTicks(ezTime::NowTicks())
   , m_Timeout(timeout)
+  , m_uiNameId(uiNameId)
 {
 }
 
 ezProfilingScope::~ezProfilingScope()
 {
-  ezProfilingSystem::AddCPUScope(m_sName, m_szFunction, m_BeginTime, ezTime::Now(), m_Timeout);
+  ezProfilingSystem::AddCPUScope(m_uiNameId, m_sName, m_szFunction, m_uiBeginTicks, ezTime::NowTicks(), m_Timeout);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -866,9 +1926,9 @@ thread_local ezProfilingListScope* ezProfilingListScope::s_pCurrentList = nullpt
 ezProfilingListScope::ezProfilingListScope(ezStringView sListName, ezStringView sFirstSectionName, const char* szFunctionName)
   : m_sListName(sListName)
   , m_szListFunction(szFunctionName)
-  , m_ListBeginTime(ezTime::Now())
+  , m_uiListBeginTicks(ezTime::NowTicks())
   , m_sCurSectionName(sFirstSectionName)
-  , m_CurSectionBeginTime(m_ListBeginTime)
+  , m_uiCurSectionBeginTicks(m_uiListBeginTicks)
 {
   m_pPreviousList = s_pCurrentList;
   s_pCurrentList = this;
@@ -876,9 +1936,9 @@ ezProfilingListScope::ezProfilingListScope(ezStringView sListName, ezStringView
 
 ezProfilingListScope::~ezProfilingListScope()
 {
-  ezTime now = ezTime::Now();
-  ezProfilingSystem::AddCPUScope(m_sCurSectionName, nullptr, m_CurSectionBeginTime, now, ezTime::MakeZero());
-  ezProfilingSystem::AddCPUScope(m_sListName, m_szListFunction, m_ListBeginTime, now, ezTime::MakeZero());
+  const ezUInt64 uiNow = ezTime::NowTicks();
+  ezProfilingSystem::AddCPUScope(ezInvalidIndex, m_sCurSectionName, nullptr, m_uiCurSectionBeginTicks, uiNow, ezTime::MakeZero());
+  ezProfilingSystem::AddCPUScope(ezInvalidIndex, m_sListName, m_szListFunction, m_uiListBeginTicks, uiNow, ezTime::MakeZero());
 
   s_pCurrentList = m_pPreviousList;
 }
@@ -888,11 +1948,11 @@ void ezProfilingListScope::StartNextSection(ezStringView sNextSectionName)
 {
   ezProfilingListScope* pCurScope = s_pCurrentList;
 
-  ezTime now = ezTime::Now();
-  ezProfilingSystem::AddCPUScope(pCurScope->m_sCurSectionName, nullptr, pCurScope->m_CurSectionBeginTime, now, ezTime::MakeZero());
+  const ezUInt64 uiNow = ezTime::NowTicks();
+  ezProfilingSystem::AddCPUScope(ezInvalidIndex, pCurScope->m_sCurSectionName, nullptr, pCurScope->m_uiCurSectionBeginTicks, uiNow, ezTime::MakeZero());
 
   pCurScope->m_sCurSectionName = sNextSectionName;
-  pCurScope->m_CurSectionBeginTime = now;
+  pCurScope->m_uiCurSectionBeginTicks = uiNow;
 }
 
 #else
@@ -910,8 +1970,34 @@ void ezProfilingSystem::SetDiscardThreshold(ezTime threshold) {}
 
 void ezProfilingSystem::StartNewFrame() {}
 
+ezResult ezProfilingSystem::StartStreamingCapture(const StreamingCaptureSettings& settings)
+{
+  return EZ_FAILURE;
+}
+
+void ezProfilingSystem::StopStreamingCapture() {}
+
+bool ezProfilingSystem::IsStreamingCaptureActive()
+{
+  return false;
+}
+
+void ezProfilingSystem::TriggerStreamingCaptureHitch() {}
+
+ezResult ezProfilingSystem::ReadStreamingCapture(ezStringView sFile, ProfilingData& out_capture, ezTime windowStart, ezTime windowEnd, ezDynamicArray<ezTime>* out_pHitches)
+{
+  return EZ_FAILURE;
+}
+
 void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout) {}
 
+ezUInt32 ezProfilingSystem::InternScopeName(ezStringView sName, const char* szFunctionName)
+{
+  return ezInvalidIndex;
+}
+
+void ezProfilingSystem::AddCPUScope(ezUInt32 uiNameId, ezStringView sName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks, ezTime scopeTimeout) {}
+
 void ezProfilingSystem::Initialize() {}
 
 void ezProfilingSystem::Reset() {}
@@ -13,17 +13,43 @@ class ezThread;
 ///
 /// The constructor creates a new scope in the profiling system and the destructor pops the scope.
 /// You shouldn't need to use this directly, just use the macro EZ_PROFILE_SCOPE provided below.
+///
+/// Scope names are interned by the profiling system, so every recorded event only stores a small name ID instead of a copy of the name.
+/// When the name is a string literal, EZ_PROFILE_SCOPE interns it only once per call site. Otherwise the name is looked up when the scope gets recorded,
+/// usually in a small per-thread cache. The number of such dynamic names is limited per function, once the limit is reached, new ones are recorded
+/// under a shared placeholder name.
 class EZ_FOUNDATION_DLL ezProfilingScope
 {
 public:
-  ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout);
+  /// \brief Returns the interned ID for a name. EZ_PROFILE_SCOPE passes a function that caches the ID in a static variable of the call site.
+  using GetNameIdFunc = ezUInt32 (*)(const char* szName, const char* szFunctionName);
+
+  /// \brief Used for string literals, the name ID is retrieved through \a getNameId.
+  ///
+  /// \note Character arrays are assumed to be string literals, i.e. their content must not change between calls.
+  template <size_t N>
+  ezProfilingScope(const char (&szName)[N], const char* szFunctionName, ezTime timeout, GetNameIdFunc getNameId)
+    : ezProfilingScope(szName, szFunctionName, timeout, getNameId != nullptr ? getNameId(szName, szFunctionName) : ezInvalidIndex)
+  {
+  }
+
+  /// \brief Used for all other names, the name is interned when the scope gets recorded.
+  ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout, GetNameIdFunc getNameId = nullptr)
+    : ezProfilingScope(sName, szFunctionName, timeout, ezInvalidIndex)
+  {
+    EZ_IGNORE_UNUSED(getNameId);
+  }
+
   ~ezProfilingScope();
 
 protected:
+  ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout, ezUInt32 uiNameId);
+
   ezStringView m_sName;
   const char* m_szFunction;
-  ezTime m_BeginTime;
+  ezUInt64 m_uiBeginTicks;
   ezTime m_Timeout;
+  ezUInt32 m_uiNameId;
 };
 
 /// \brief This class implements a profiling scope similar to ezProfilingScope, but with additional sub-scopes which can be added easily without
@@ -49,10 +75,10 @@ protected:
 
   ezStringView m_sListName;
   const char* m_szListFunction;
-  ezTime m_ListBeginTime;
+  ezUInt64 m_uiListBeginTicks;
 
   ezStringView m_sCurSectionName;
-  ezTime m_CurSectionBeginTime;
+  ezUInt64 m_uiCurSectionBeginTicks;
 };
 
 /// \brief Helper functionality of the profiling system.
@@ -138,12 +164,58 @@ public:
   /// \brief Adds a new scoped event for the calling thread in the profiling system
   static void AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout);
 
+  /// \brief Returns a unique ID for the combination of scope name and function name.
+  ///
+  /// The same name and function always return the same ID. The IDs stay valid for the lifetime of the process.
+  /// In contrast to the dynamic names of recorded scopes, names interned through this function are not limited.
+  static ezUInt32 InternScopeName(ezStringView sName, const char* szFunctionName);
+
   /// \brief Get current frame counter
   static ezUInt64 GetFrameCount();
 
+  /// \brief Settings for StartStreamingCapture().
+  struct StreamingCaptureSettings
+  {
+    ezString m_sFile;                                            ///< Absolute path of the capture file. An existing file is overwritten.
+    ezTime m_FlushInterval = ezTime::MakeFromMilliseconds(100); ///< How often the background thread writes new events to the file.
+    ezUInt32 m_uiMaxBlocks = 64;                                 ///< How many event blocks (64 KB each) may be in flight. When all are in use, new events are dropped.
+    ezTime m_HitchThreshold;                                     ///< Frames that take longer than this are recorded as hitches. Zero disables the detection.
+    ezTime m_HitchWindow = ezTime::MakeFromSeconds(5);           ///< How much time before and after a hitch is preserved, if m_bOnlyWriteHitches is enabled.
+    ezUInt32 m_uiMaxHitchBufferMB = 64;                          ///< Upper bound for the events that are kept in memory while waiting for a hitch.
+    bool m_bOnlyWriteHitches = false;                            ///< If enabled, events are only written to disk when they are within m_HitchWindow of a hitch.
+  };
+
+  /// \brief Starts writing all CPU scopes and frames continuously to a compact binary file.
+  ///
+  /// In contrast to Capture(), which only contains what still fits into the ring buffers, a streaming capture can run for hours.
+  /// Every thread appends its events to a block, a background thread writes the blocks to the file in regular intervals.
+  /// Memory usage is bounded by StreamingCaptureSettings::m_uiMaxBlocks.
+  ///
+  /// Use ReadStreamingCapture() to extract a time window from the file, e.g. around one of the recorded hitches.
+  static ezResult StartStreamingCapture(const StreamingCaptureSettings& settings);
+
+  /// \brief Writes all remaining events and closes the file.
+  static void StopStreamingCapture();
+
+  static bool IsStreamingCaptureActive();
+
+  /// \brief Records a hitch at the current time. With StreamingCaptureSettings::m_bOnlyWriteHitches the events around it are written to disk.
+  static void TriggerStreamingCaptureHitch();
+
+  /// \brief Reads the data of a file written by a streaming capture that lies in the given time window.
+  ///
+  /// A zero \a windowEnd means everything up to the end of the file. All hitches of the file are returned in \a out_pHitches.
+  /// ProfilingData::Write() converts the result into the same JSON format as a regular capture.
+  static ezResult ReadStreamingCapture(ezStringView sFile, ProfilingData& out_capture, ezTime windowStart = ezTime::MakeZero(), ezTime windowEnd = ezTime::MakeZero(), ezDynamicArray<ezTime>* out_pHitches = nullptr);
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ProfilingSystem);
   friend ezUInt32 RunThread(ezThread* pThread);
+  friend class ezProfilingScope;
+  friend class ezProfilingListScope;
+
+  /// \brief Records a scope with timestamps from ezTime::NowTicks(). If uiNameId is invalid, the name is interned here.
+  static void AddCPUScope(ezUInt32 uiNameId, ezStringView sName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks, ezTime scopeTimeout);
 
   static void Initialize();
   /// \brief Removes profiling data of dead threads.
@@ -174,7 +246,7 @@ public:
 ///
 /// \sa ezProfilingScope
 /// \sa EZ_PROFILE_LIST_SCOPE
-#  define EZ_PROFILE_SCOPE(szScopeName) ezProfilingScope EZ_CONCAT(_ezProfilingScope, EZ_SOURCE_LINE)(szScopeName, EZ_SOURCE_FUNCTION, ezTime::MakeZero())
+#  define EZ_PROFILE_SCOPE(szScopeName) EZ_PROFILE_SCOPE_WITH_TIMEOUT(szScopeName, ezTime::MakeZero())
 
 
 /// \brief Same as EZ_PROFILE_SCOPE but if the scope takes longer than 'Timeout', the ezProfilingSystem's timeout callback is executed.
@@ -182,7 +254,12 @@ public:
 /// This can be used to log an error or save a callstack, etc. when a scope exceeds an expected amount of time.
 ///
 /// \sa ezProfilingSystem::SetScopeTimeoutCallback()
-#  define EZ_PROFILE_SCOPE_WITH_TIMEOUT(szScopeName, Timeout) ezProfilingScope EZ_CONCAT(_ezProfilingScope, EZ_SOURCE_LINE)(szScopeName, EZ_SOURCE_FUNCTION, Timeout)
+#  define EZ_PROFILE_SCOPE_WITH_TIMEOUT(szScopeName, Timeout)                                     \
+    ezProfilingScope EZ_CONCAT(_ezProfilingScope, EZ_SOURCE_LINE)(szScopeName, EZ_SOURCE_FUNCTION, Timeout, \
+      [](const char* szName, const char* szFunctionName) -> ezUInt32 {                                    \
+        static const ezUInt32 s_uiNameId = ezProfilingSystem::InternScopeName(szName, szFunctionName); \
+        return s_uiNameId;                                                                                \
+      })
 
 /// \brief Profiles the current scope using the given name as the overall list scope name and the section name for the first section in the list.
 ///
@@ -14,6 +14,18 @@ public:
   /// \brief Gets the current time
   static ezTime Now(); // [tested]
 
+  /// \brief Returns the raw value of the high-precision timer that Now() is based on.
+  ///
+  /// Reading the ticks is cheaper than Now() and a tick value is an integer that doesn't lose precision over time.
+  /// This is meant for code that records many timestamps, e.g. the profiling system, and converts them later with MakeFromTicks().
+  static ezUInt64 NowTicks();
+
+  /// \brief Returns how many ticks (as returned by NowTicks()) make up one second.
+  static double GetTicksPerSecond();
+
+  /// \brief Converts a value returned by NowTicks() into the same time that Now() would have returned at that moment.
+  [[nodiscard]] static ezTime MakeFromTicks(ezUInt64 uiTicks);
+
   /// \brief Creates an instance of ezTime that was initialized from nanoseconds.
   [[nodiscard]] EZ_ALWAYS_INLINE constexpr static ezTime MakeFromNanoseconds(double fNanoseconds) { return ezTime(fNanoseconds * 0.000000001); }
   [[nodiscard]] EZ_ALWAYS_INLINE constexpr static ezTime Nanoseconds(double fNanoseconds) { return ezTime(fNanoseconds * 0.000000001); }
@@ -0,0 +1,444 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Utilities/Metrics.h>
+#include <Foundation/Utilities/Stats.h>
+
+namespace
+{
+  struct MetricsRegistry
+  {
+    ezMutex m_Mutex;
+    ezDynamicArray<ezMetric*, ezStaticsAllocatorWrapper> m_Metrics;
+
+    ezTime m_PublishInterval = ezTime::MakeFromSeconds(1);
+    ezTime m_LastPublish;
+    ezUntrackedString m_sExportFile;
+  };
+
+  MetricsRegistry& GetMetricsRegistry()
+  {
+    // Created on first use, so that metrics that are global variables in other files can register themselves during static initialization.
+    // It is never destroyed, because such metrics unregister themselves during static destruction.
+    alignas(MetricsRegistry) static ezUInt8 s_RegistryStorage[sizeof(MetricsRegistry)];
+    static MetricsRegistry* s_pRegistry = new (s_RegistryStorage) MetricsRegistry();
+    return *s_pRegistry;
+  }
+
+  /// \brief A copy of the values of one metric, so that they can be published without holding the registry lock.
+  struct MetricSnapshot
+  {
+    ezString m_sName;
+    ezMetricType::Enum m_Type = ezMetricType::Counter;
+    double m_fValue = 0.0;
+
+    // histograms only
+    ezInt64 m_iCount = 0;
+    double m_fP50 = 0.0;
+    double m_fP95 = 0.0;
+    double m_fP99 = 0.0;
+  };
+
+  ezAtomicInteger32 s_iNextMetricShard;
+  thread_local ezUInt32 s_uiMetricShard = ezInvalidIndex;
+
+  EZ_ALWAYS_INLINE ezInt64 DoubleToBits(double fValue)
+  {
+    ezInt64 iBits;
+    ezMemoryUtils::RawByteCopy(&iBits, &fValue, sizeof(double));
+    return iBits;
+  }
+
+  EZ_ALWAYS_INLINE double BitsToDouble(ezInt64 iBits)
+  {
+    double fValue;
+    ezMemoryUtils::RawByteCopy(&fValue, &iBits, sizeof(double));
+    return fValue;
+  }
+
+  void AtomicAddDouble(ezAtomicInteger64& ref_iBits, double fValue)
+  {
+    ezInt64 iExpected = ref_iBits;
+    while (true)
+    {
+      const ezInt64 iPrevious = ref_iBits.CompareAndSwap(iExpected, DoubleToBits(BitsToDouble(iExpected) + fValue));
+      if (iPrevious == iExpected)
+        return;
+
+      iExpected = iPrevious;
+    }
+  }
+
+  /// \brief Prometheus only allows letters, digits, underscores and colons in metric names.
+  void MakePrometheusName(ezStringView sName, ezStringBuilder& out_sName)
+  {
+    out_sName = "ez_";
+
+    for (auto it = sName.GetIteratorFront(); it.IsValid(); ++it)
+    {
+      const ezUInt32 c = it.GetCharacter();
+      const bool bValid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+      out_sName.Append(bValid ? c : '_');
+    }
+  }
+
+  void TakeMetricsSnapshot(ezDynamicArray<MetricSnapshot>& out_snapshot)
+  {
+    MetricsRegistry& registry = GetMetricsRegistry();
+    EZ_LOCK(registry.m_Mutex);
+
+    out_snapshot.Clear();
+    out_snapshot.Reserve(registry.m_Metrics.GetCount());
+
+    for (const ezMetric* pMetric : registry.m_Metrics)
+    {
+      MetricSnapshot& snapshot = out_snapshot.ExpandAndGetRef();
+      snapshot.m_sName = pMetric->GetName();
+      snapshot.m_Type = pMetric->GetType();
+
+      switch (pMetric->GetType())
+      {
+        case ezMetricType::Counter:
+          snapshot.m_fValue = static_cast<double>(static_cast<const ezMetricCounter*>(pMetric)->GetValue());
+          break;
+
+        case ezMetricType::Gauge:
+          snapshot.m_fValue = static_cast<const ezMetricGauge*>(pMetric)->GetValue();
+          break;
+
+        case ezMetricType::Histogram:
+        {
+          const ezMetricHistogram* pHistogram = static_cast<const ezMetricHistogram*>(pMetric);
+          snapshot.m_iCount = pHistogram->GetCount();
+          snapshot.m_fValue = snapshot.m_iCount > 0 ? pHistogram->GetSum() / snapshot.m_iCount : 0.0;
+          snapshot.m_fP50 = pHistogram->GetPercentile(0.5);
+          snapshot.m_fP95 = pHistogram->GetPercentile(0.95);
+          snapshot.m_fP99 = pHistogram->GetPercentile(0.99);
+          break;
+        }
+
+          EZ_DEFAULT_CASE_NOT_IMPLEMENTED;
+      }
+    }
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+ezMetric::ezMetric(ezStringView sName, ezMetricType::Enum type)
+  : m_sName(sName)
+  , m_Type(type)
+{
+  ezMetrics::RegisterMetric(this);
+}
+
+ezMetric::~ezMetric()
+{
+  ezMetrics::UnregisterMetric(this);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezMetricCounter::ezMetricCounter(ezStringView sName)
+  : ezMetric(sName, ezMetricType::Counter)
+{
+}
+
+void ezMetricCounter::Add(ezInt64 iValue)
+{
+  ezUInt32 uiShard = s_uiMetricShard;
+
+  if (uiShard == ezInvalidIndex)
+  {
+    // threads are distributed round robin, so that the first few threads never share a shard
+    uiShard = static_cast<ezUInt32>(s_iNextMetricShard.PostIncrement()) % NUM_SHARDS;
+    s_uiMetricShard = uiShard;
+  }
+
+  m_Shards[uiShard].m_iValue.Add(iValue);
+}
+
+ezInt64 ezMetricCounter::GetValue() const
+{
+  ezInt64 iSum = 0;
+
+  for (const Shard& shard : m_Shards)
+  {
+    iSum += shard.m_iValue;
+  }
+
+  return iSum;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezMetricGauge::ezMetricGauge(ezStringView sName)
+  : ezMetric(sName, ezMetricType::Gauge)
+{
+}
+
+void ezMetricGauge::Set(double fValue)
+{
+  m_iValueBits = DoubleToBits(fValue);
+}
+
+void ezMetricGauge::Add(double fValue)
+{
+  AtomicAddDouble(m_iValueBits, fValue);
+}
+
+double ezMetricGauge::GetValue() const
+{
+  return BitsToDouble(m_iValueBits);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezMetricHistogram::ezMetricHistogram(ezStringView sName, ezArrayPtr<const double> bucketUpperBounds)
+  : ezMetric(sName, ezMetricType::Histogram)
+{
+  EZ_ASSERT_DEV(bucketUpperBounds.GetCount() <= MAX_BUCKETS, "Histogram '{}' has too many buckets ({}), only {} are supported.", sName, bucketUpperBounds.GetCount(), MAX_BUCKETS);
+
+  m_uiNumBuckets = ezMath::Min(bucketUpperBounds.GetCount(), MAX_BUCKETS);
+
+  for (ezUInt32 i = 0; i < m_uiNumBuckets; ++i)
+  {
+    EZ_ASSERT_DEV(i == 0 || bucketUpperBounds[i - 1] < bucketUpperBounds[i], "The bucket bounds of histogram '{}' are not sorted.", sName);
+    m_BucketUpperBounds[i] = bucketUpperBounds[i];
+  }
+}
+
+void ezMetricHistogram::Record(double fValue)
+{
+  ezUInt32 uiBucket = 0;
+  while (uiBucket < m_uiNumBuckets && fValue > m_BucketUpperBounds[uiBucket])
+  {
+    ++uiBucket;
+  }
+
+  m_BucketCounts[uiBucket].Increment();
+  m_iCount.Increment();
+  AtomicAddDouble(m_iSumBits, fValue);
+}
+
+double ezMetricHistogram::GetSum() const
+{
+  return BitsToDouble(m_iSumBits);
+}
+
+double ezMetricHistogram::GetPercentile(double fFraction) const
+{
+  ezInt64 iTotal = 0;
+  for (ezUInt32 i = 0; i <= m_uiNumBuckets; ++i)
+  {
+    iTotal += m_BucketCounts[i];
+  }
+
+  if (iTotal == 0 || m_uiNumBuckets == 0)
+    return 0.0;
+
+  const double fTarget = ezMath::Clamp(fFraction, 0.0, 1.0) * iTotal;
+  double fCumulative = 0.0;
+
+  for (ezUInt32 i = 0; i < m_uiNumBuckets; ++i)
+  {
+    const double fBucketCount = static_cast<double>(m_BucketCounts[i]);
+
+    if (fBucketCount > 0.0 && fCumulative + fBucketCount >= fTarget)
+    {
+      const double fLowerBound = i > 0 ? m_BucketUpperBounds[i - 1] : ezMath::Min(0.0, m_BucketUpperBounds[0]);
+      return ezMath::Lerp(fLowerBound, m_BucketUpperBounds[i], (fTarget - fCumulative) / fBucketCount);
+    }
+
+    fCumulative += fBucketCount;
+  }
+
+  // the value is in the overflow bucket, the best guess is the largest bound
+  return m_BucketUpperBounds[m_uiNumBuckets - 1];
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// static
+void ezMetrics::SetPublishInterval(ezTime interval)
+{
+  MetricsRegistry& registry = GetMetricsRegistry();
+  EZ_LOCK(registry.m_Mutex);
+  registry.m_PublishInterval = interval;
+}
+
+// static
+void ezMetrics::SetExportFile(ezStringView sFile)
+{
+  MetricsRegistry& registry = GetMetricsRegistry();
+  EZ_LOCK(registry.m_Mutex);
+  registry.m_sExportFile = sFile;
+}
+
+// static
+void ezMetrics::Update()
+{
+  MetricsRegistry& registry = GetMetricsRegistry();
+
+  {
+    EZ_LOCK(registry.m_Mutex);
+
+    const ezTime now = ezTime::Now();
+    if (registry.m_PublishInterval.IsZeroOrNegative() || now - registry.m_LastPublish < registry.m_PublishInterval)
+      return;
+
+    registry.m_LastPublish = now;
+  }
+
+  Publish();
+}
+
+// static
+void ezMetrics::Publish()
+{
+  ezDynamicArray<MetricSnapshot> snapshot;
+  TakeMetricsSnapshot(snapshot);
+
+  ezStringBuilder sStatName;
+
+  for (const MetricSnapshot& metric : snapshot)
+  {
+    switch (metric.m_Type)
+    {
+      case ezMetricType::Counter:
+        ezStats::SetStat(metric.m_sName, static_cast<ezInt64>(metric.m_fValue));
+        break;
+
+      case ezMetricType::Gauge:
+        ezStats::SetStat(metric.m_sName, metric.m_fValue);
+        break;
+
+      case ezMetricType::Histogram:
+        sStatName.Set(metric.m_sName, "/Count");
+        ezStats::SetStat(sStatName, metric.m_iCount);
+        sStatName.Set(metric.m_sName, "/Mean");
+        ezStats::SetStat(sStatName, metric.m_fValue);
+        sStatName.Set(metric.m_sName, "/P50");
+        ezStats::SetStat(sStatName, metric.m_fP50);
+        sStatName.Set(metric.m_sName, "/P95");
+        ezStats::SetStat(sStatName, metric.m_fP95);
+        sStatName.Set(metric.m_sName, "/P99");
+        ezStats::SetStat(sStatName, metric.m_fP99);
+        break;
+
+        EZ_DEFAULT_CASE_NOT_IMPLEMENTED;
+    }
+  }
+
+  ezStringBuilder sExportFile;
+
+  {
+    MetricsRegistry& registry = GetMetricsRegistry();
+    EZ_LOCK(registry.m_Mutex);
+    sExportFile = registry.m_sExportFile;
+  }
+
+  if (!sExportFile.IsEmpty())
+  {
+    WriteToFile(sExportFile).IgnoreResult();
+  }
+}
+
+// static
+void ezMetrics::WriteText(ezStringBuilder& out_sText)
+{
+  out_sText.Clear();
+
+  MetricsRegistry& registry = GetMetricsRegistry();
+  EZ_LOCK(registry.m_Mutex);
+
+  ezStringBuilder sName;
+  ezStringBuilder sBound;
+
+  for (const ezMetric* pMetric : registry.m_Metrics)
+  {
+    MakePrometheusName(pMetric->GetName(), sName);
+
+    switch (pMetric->GetType())
+    {
+      case ezMetricType::Counter:
+        out_sText.AppendFormat("# TYPE {} counter\n{} {}\n", sName, sName, static_cast<const ezMetricCounter*>(pMetric)->GetValue());
+        break;
+
+      case ezMetricType::Gauge:
+        out_sText.AppendFormat("# TYPE {} gauge\n{} {}\n", sName, sName, static_cast<const ezMetricGauge*>(pMetric)->GetValue());
+        break;
+
+      case ezMetricType::Histogram:
+      {
+        const ezMetricHistogram* pHistogram = static_cast<const ezMetricHistogram*>(pMetric);
+
+        out_sText.AppendFormat("# TYPE {} histogram\n", sName);
+
+        // Prometheus buckets are cumulative
+        ezInt64 iCumulative = 0;
+        for (ezUInt32 i = 0; i < pHistogram->GetBucketCount(); ++i)
+        {
+          iCumulative += pHistogram->GetBucketValueCount(i);
+          sBound.SetFormat("{}", pHistogram->GetBucketUpperBound(i));
+          out_sText.Append(sName, "_bucket{le=\"", sBound, "\"} ");
+          out_sText.AppendFormat("{}\n", iCumulative);
+        }
+
+        iCumulative += pHistogram->GetBucketValueCount(pHistogram->GetBucketCount());
+        out_sText.Append(sName, "_bucket{le=\"+Inf\"} ");
+        out_sText.AppendFormat("{}\n", iCumulative);
+        out_sText.AppendFormat("{}_sum {}\n{}_count {}\n", sName, pHistogram->GetSum(), sName, pHistogram->GetCount());
+        break;
+      }
+
+        EZ_DEFAULT_CASE_NOT_IMPLEMENTED;
+    }
+  }
+}
+
+// static
+ezResult ezMetrics::WriteToFile(ezStringView sFile)
+{
+  ezStringBuilder sText;
+  WriteText(sText);
+
+  // write to a temporary file first, so that a scraper never reads a half-written file
+  ezStringBuilder sTempFile(sFile, ".tmp");
+
+  {
+    ezOSFile file;
+    if (file.Open(sTempFile, ezFileOpenMode::Write).Failed())
+    {
+      ezLog::Error("Failed to write metrics to '{}'.", sTempFile);
+      return EZ_FAILURE;
+    }
+
+    EZ_SUCCEED_OR_RETURN(file.Write(sText.GetData(), sText.GetElementCount()));
+  }
+
+  // replacing the file in one step is atomic on POSIX, other platforms can't move onto an existing file
+  if (ezOSFile::MoveFileOrDirectory(sTempFile, sFile).Succeeded())
+    return EZ_SUCCESS;
+
+  EZ_SUCCEED_OR_RETURN(ezOSFile::DeleteFile(sFile));
+  return ezOSFile::MoveFileOrDirectory(sTempFile, sFile);
+}
+
+// static
+void ezMetrics::RegisterMetric(ezMetric* pMetric)
+{
+  MetricsRegistry& registry = GetMetricsRegistry();
+  EZ_LOCK(registry.m_Mutex);
+
+  registry.m_Metrics.PushBack(pMetric);
+}
+
+// static
+void ezMetrics::UnregisterMetric(ezMetric* pMetric)
+{
+  MetricsRegistry& registry = GetMetricsRegistry();
+  EZ_LOCK(registry.m_Mutex);
+
+  registry.m_Metrics.RemoveAndCopy(pMetric);
+}
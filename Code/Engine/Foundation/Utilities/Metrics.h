@@ -0,0 +1,153 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Time/Time.h>
+
+/// \brief Describes of which type a metric is. Use that info to cast an ezMetric* to the proper derived class.
+struct ezMetricType
+{
+  enum Enum
+  {
+    Counter,   ///< Can cast the ezMetric* to ezMetricCounter*
+    Gauge,     ///< Can cast the ezMetric* to ezMetricGauge*
+    Histogram, ///< Can cast the ezMetric* to ezMetricHistogram*
+    ENUM_COUNT
+  };
+};
+
+/// \brief Base class for all metrics. A metric is a typed value that can be updated cheaply from any thread.
+///
+/// In contrast to ezStats::SetStat(), updating a metric doesn't take a lock, doesn't look up a string and doesn't broadcast an event.
+/// Metrics are typically created once, as global variables or as members of long-lived objects, and then updated on hot paths.
+/// ezMetrics periodically publishes all registered metrics to ezStats (and thus ezTelemetry) and can export them to a text file.
+///
+/// The name may contain slashes to define groups, just like stat names. It is used as the stat name when publishing.
+/// The name string is not copied, so it must stay valid for as long as the metric exists.
+class EZ_FOUNDATION_DLL ezMetric
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezMetric);
+
+public:
+  ezStringView GetName() const { return m_sName; }
+  ezMetricType::Enum GetType() const { return m_Type; }
+
+protected:
+  ezMetric(ezStringView sName, ezMetricType::Enum type);
+  virtual ~ezMetric();
+
+private:
+  ezStringView m_sName;
+  ezMetricType::Enum m_Type;
+};
+
+/// \brief A value that only ever increases, e.g. the number of loaded resources.
+///
+/// Every thread adds to one of several counters on separate cache lines, so that threads that update the same counter concurrently
+/// don't fight over the same memory. The shards are only summed up when the value is read.
+class EZ_FOUNDATION_DLL ezMetricCounter : public ezMetric
+{
+public:
+  ezMetricCounter(ezStringView sName);
+
+  /// \brief Adds \a iValue to the counter.
+  void Add(ezInt64 iValue = 1);
+
+  /// \brief Returns the sum of all additions so far.
+  ezInt64 GetValue() const;
+
+private:
+  static constexpr ezUInt32 NUM_SHARDS = 8;
+
+  struct alignas(64) Shard
+  {
+    ezAtomicInteger64 m_iValue;
+  };
+
+  Shard m_Shards[NUM_SHARDS];
+};
+
+/// \brief A value that can go up and down, e.g. the currently allocated memory.
+class EZ_FOUNDATION_DLL ezMetricGauge : public ezMetric
+{
+public:
+  ezMetricGauge(ezStringView sName);
+
+  void Set(double fValue);
+  void Add(double fValue);
+  double GetValue() const;
+
+private:
+  ezAtomicInteger64 m_iValueBits;
+};
+
+/// \brief Counts how many recorded values fall into each of a fixed set of buckets, e.g. to track the distribution of frame times.
+///
+/// A value is counted in the first bucket whose upper bound is larger than or equal to the value.
+/// Values larger than the last bound are counted in an additional overflow bucket.
+class EZ_FOUNDATION_DLL ezMetricHistogram : public ezMetric
+{
+public:
+  static constexpr ezUInt32 MAX_BUCKETS = 15;
+
+  /// \brief The upper bounds of the buckets must be sorted ascendingly. At most MAX_BUCKETS bounds are used.
+  ezMetricHistogram(ezStringView sName, ezArrayPtr<const double> bucketUpperBounds);
+
+  void Record(double fValue);
+
+  /// \brief Returns the number of buckets, not including the overflow bucket.
+  ezUInt32 GetBucketCount() const { return m_uiNumBuckets; }
+  double GetBucketUpperBound(ezUInt32 uiBucket) const { return m_BucketUpperBounds[uiBucket]; }
+
+  /// \brief Returns how many values were counted in the given bucket. GetBucketCount() returns the overflow bucket.
+  ezInt64 GetBucketValueCount(ezUInt32 uiBucket) const { return m_BucketCounts[uiBucket]; }
+
+  /// \brief Returns how many values were recorded in total.
+  ezInt64 GetCount() const { return m_iCount; }
+
+  /// \brief Returns the sum of all recorded values.
+  double GetSum() const;
+
+  /// \brief Estimates the value below which the given fraction of all recorded values lies, by interpolating within the buckets.
+  double GetPercentile(double fFraction) const;
+
+private:
+  ezUInt32 m_uiNumBuckets = 0;
+  double m_BucketUpperBounds[MAX_BUCKETS];
+  ezAtomicInteger64 m_BucketCounts[MAX_BUCKETS + 1];
+  ezAtomicInteger64 m_iCount;
+  ezAtomicInteger64 m_iSumBits;
+};
+
+/// \brief Publishes and exports all registered metrics.
+///
+/// Update() should be called once per frame. Every publish interval it sets all metrics as stats through ezStats,
+/// and, if an export file is configured, writes them into that file in the Prometheus text format.
+class EZ_FOUNDATION_DLL ezMetrics
+{
+public:
+  /// \brief How often Update() publishes the metrics. Zero disables automatic publishing. The default is one second.
+  static void SetPublishInterval(ezTime interval);
+
+  /// \brief If set, every publish also writes all metrics to this file. The file is replaced atomically, so scrapers never see a partial file.
+  static void SetExportFile(ezStringView sFile);
+
+  /// \brief Publishes the metrics, if the publish interval has passed.
+  static void Update();
+
+  /// \brief Sets all metrics as stats through ezStats and writes the export file, if one is configured.
+  static void Publish();
+
+  /// \brief Writes all metrics in the Prometheus text exposition format.
+  static void WriteText(ezStringBuilder& out_sText);
+
+  /// \brief Writes all metrics in the Prometheus text exposition format into the given file.
+  static ezResult WriteToFile(ezStringView sFile);
+
+private:
+  friend class ezMetric;
+
+  static void RegisterMetric(ezMetric* pMetric);
+  static void UnregisterMetric(ezMetric* pMetric);
+};
@@ -11,6 +11,10 @@
 ///
 /// Uses Verlet Integration to update the cloth positions from velocities, and the "Jakobsen method" to enforce distance constraints.
 ///
+/// For the simulation the nodes are copied into a structure-of-arrays layout, so that the constraints of four nodes are solved at once.
+/// The nodes are split by a checkerboard pattern, such that no two nodes of the same color are direct neighbors.
+/// That way all nodes of one color can be moved at the same time, which behaves like solving the constraints one node after another.
+///
 /// Based on https://owlree.blog/posts/simulating-a-rope.html
 class EZ_GAMEENGINE_DLL ezClothSimulator
 {
@@ -46,9 +50,19 @@ public:
   bool HasEquilibrium(ezSimdFloat fAllowedMovement) const;
 
 private:
-  ezSimdFloat EnforceDistanceConstraint();
-  void UpdateNodePositions(const ezSimdFloat tDiffSqr);
-  ezSimdVec4f MoveTowards(const ezSimdVec4f posThis, const ezSimdVec4f posNext, ezSimdFloat factor, const ezSimdVec4f fallbackDir, ezSimdFloat& inout_fError, ezSimdFloat fSegLen);
+  void CopyNodesToSoA();
+  void CopyNodesFromSoA();
+
+  void SimulateStepSoA(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError);
+  void UpdateNodePositionsSoA(const ezSimdFloat tDiffSqr);
+  ezSimdFloat EnforceDistanceConstraintSoA(ezUInt32 uiColor);
+
+  float* GetSoAData(ezUInt32 uiColor, ezUInt32 uiChannel, ezInt32 iRow);
 
   ezTime m_LeftOverTimeStep;
+
+  ezUInt32 m_uiSoAStride = 0;
+  ezUInt8 m_uiSoAWidth = 0;
+  ezUInt8 m_uiSoAHeight = 0;
+  ezDynamicArray<float, ezAlignedAllocatorWrapper> m_SoAData;
 };
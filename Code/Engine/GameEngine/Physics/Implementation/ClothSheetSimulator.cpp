@@ -3,6 +3,60 @@
 #include <Foundation/SimdMath/SimdConversion.h>
 #include <GameEngine/Physics/ClothSheetSimulator.h>
 
+namespace
+{
+  enum SoAChannel
+  {
+    PosX,
+    PosY,
+    PosZ,
+    PrevX,
+    PrevY,
+    PrevZ,
+    WeightLeft,
+    WeightRight,
+    WeightUp,
+    WeightDown,
+    Movable,
+    NumChannels
+  };
+
+  /// \brief Moves four nodes towards (or away from) one neighbor each, to restore the segment length between them.
+  ///
+  /// The neighbor weight is zero for nodes that are fixed or don't have this neighbor.
+  EZ_ALWAYS_INLINE void ApplyDistanceConstraint(const ezSimdVec4f& vPosX, const ezSimdVec4f& vPosY, const ezSimdVec4f& vPosZ, const float* pOtherX, const float* pOtherY, const float* pOtherZ, const float* pWeight, const ezSimdFloat& fSegLen, float fFallbackX, float fFallbackY, ezSimdVec4f& inout_vMoveX, ezSimdVec4f& inout_vMoveY, ezSimdVec4f& inout_vMoveZ, ezSimdVec4f& inout_vError)
+  {
+    ezSimdVec4f dirX, dirY, dirZ, weight;
+    dirX.Load<4>(pOtherX);
+    dirY.Load<4>(pOtherY);
+    dirZ.Load<4>(pOtherZ);
+    weight.Load<4>(pWeight);
+
+    dirX -= vPosX;
+    dirY -= vPosY;
+    dirZ -= vPosZ;
+
+    ezSimdVec4f len = ezSimdVec4f::MulAdd(dirX, dirX, ezSimdVec4f::MulAdd(dirY, dirY, dirZ.CompMul(dirZ))).GetSqrt<ezMathAcc::FULL>();
+
+    // nodes at the same position are pushed apart along the grid axis
+    const ezSimdVec4b degenerate = len <= ezSimdVec4f(0.001f);
+    dirX = ezSimdVec4f::Select(degenerate, ezSimdVec4f(fFallbackX), dirX);
+    dirY = ezSimdVec4f::Select(degenerate, ezSimdVec4f(fFallbackY), dirY);
+    dirZ = ezSimdVec4f::Select(degenerate, ezSimdVec4f::MakeZero(), dirZ);
+    len = ezSimdVec4f::Select(degenerate, ezSimdVec4f(1.0f), len);
+
+    const ezSimdVec4f localError = (len - ezSimdVec4f(fSegLen)).CompMul(weight);
+    const ezSimdVec4f scale = localError.CompDiv(len);
+
+    inout_vMoveX = ezSimdVec4f::MulAdd(dirX, scale, inout_vMoveX);
+    inout_vMoveY = ezSimdVec4f::MulAdd(dirY, scale, inout_vMoveY);
+    inout_vMoveZ = ezSimdVec4f::MulAdd(dirZ, scale, inout_vMoveZ);
+
+    // keep track of how much the cloth had to be moved to fulfill the constraint
+    inout_vError += localError.Abs();
+  }
+} // namespace
+
 void ezClothSimulator::SimulateCloth(const ezTime& diff)
 {
   m_LeftOverTimeStep += diff;
@@ -10,12 +64,30 @@ void ezClothSimulator::SimulateCloth(const ezTime& diff)
   constexpr ezTime tStep = ezTime::MakeFromSeconds(1.0 / 60.0);
   const ezSimdFloat tStepSqr = static_cast<float>(tStep.GetSeconds() * tStep.GetSeconds());
 
+  if (m_LeftOverTimeStep < tStep)
+    return;
+
+  const bool bSimulate = m_Nodes.GetCount() >= 4;
+
+  if (bSimulate)
+  {
+    CopyNodesToSoA();
+  }
+
   while (m_LeftOverTimeStep >= tStep)
   {
-    SimulateStep(tStepSqr, 32, m_vSegmentLength.x);
+    if (bSimulate)
+    {
+      SimulateStepSoA(tStepSqr, 32, m_vSegmentLength.x);
+    }
 
     m_LeftOverTimeStep -= tStep;
   }
+
+  if (bSimulate)
+  {
+    CopyNodesFromSoA();
+  }
 }
 
 void ezClothSimulator::SimulateStep(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError)
@@ -23,111 +95,207 @@ void ezClothSimulator::SimulateStep(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIt
   if (m_Nodes.GetCount() < 4)
     return;
 
-  UpdateNodePositions(fDiffSqr);
+  CopyNodesToSoA();
+  SimulateStepSoA(fDiffSqr, uiMaxIterations, fAllowedError);
+  CopyNodesFromSoA();
+}
+
+void ezClothSimulator::SimulateStepSoA(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError)
+{
+  UpdateNodePositionsSoA(fDiffSqr);
 
   // repeatedly apply the distance constraint, until the overall error is low enough
   for (ezUInt32 i = 0; i < uiMaxIterations; ++i)
   {
-    const ezSimdFloat fError = EnforceDistanceConstraint();
+    const ezSimdFloat fError = EnforceDistanceConstraintSoA(0) + EnforceDistanceConstraintSoA(1);
 
     if (fError < fAllowedError)
       return;
   }
 }
 
-ezSimdFloat ezClothSimulator::EnforceDistanceConstraint()
+float* ezClothSimulator::GetSoAData(ezUInt32 uiColor, ezUInt32 uiChannel, ezInt32 iRow)
 {
-  ezSimdFloat fError = ezSimdFloat::MakeZero();
+  // there is one padding row above and below the cloth and one padding element in front of each row,
+  // so that reading the neighbors of the nodes at the border never goes out of bounds
+  return m_SoAData.GetData() + ((uiColor * NumChannels + uiChannel) * (m_uiSoAHeight + 2) + (iRow + 1)) * m_uiSoAStride + 1;
+}
 
-  for (ezUInt32 y = 0; y < m_uiHeight; ++y)
+void ezClothSimulator::CopyNodesToSoA()
+{
+  EZ_ASSERT_DEV(m_Nodes.GetCount() == static_cast<ezUInt32>(m_uiWidth) * m_uiHeight, "Number of cloth nodes doesn't match the cloth resolution.");
+
+  if (m_uiSoAWidth != m_uiWidth || m_uiSoAHeight != m_uiHeight)
   {
-    for (ezUInt32 x = 0; x < m_uiWidth; ++x)
-    {
-      const ezUInt32 idx = (y * m_uiWidth) + x;
+    m_uiSoAWidth = m_uiWidth;
+    m_uiSoAHeight = m_uiHeight;
 
-      auto& n = m_Nodes[idx];
+    // each row of one color holds every other node, plus enough padding to always load full SIMD vectors
+    m_uiSoAStride = ezMemoryUtils::AlignSize<ezUInt32>((m_uiWidth + 1) / 2 + 5, 4);
 
-      if (n.m_bFixed)
-        continue;
+    m_SoAData.Clear();
+    m_SoAData.SetCount(2 * NumChannels * (m_uiSoAHeight + 2) * m_uiSoAStride);
+  }
 
-      const ezSimdVec4f posThis = n.m_vPosition;
+  for (ezUInt32 uiColor = 0; uiColor < 2; ++uiColor)
+  {
+    for (ezUInt32 y = 0; y < m_uiHeight; ++y)
+    {
+      // the first node in this row that has the given color
+      const ezUInt32 uiFirstX = (y + uiColor) & 1;
 
-      if (x > 0)
+      float* pData[NumChannels];
+      for (ezUInt32 c = 0; c < NumChannels; ++c)
       {
-        const ezSimdVec4f pos = m_Nodes[idx - 1].m_vPosition;
-        n.m_vPosition += MoveTowards(posThis, pos, 0.5f, ezSimdVec4f(-1, 0, 0), fError, m_vSegmentLength.x);
+        pData[c] = GetSoAData(uiColor, c, y);
       }
 
-      if (x + 1 < m_uiWidth)
+      for (ezUInt32 x = uiFirstX, k = 0; x < m_uiWidth; x += 2, ++k)
       {
-        const ezSimdVec4f pos = m_Nodes[idx + 1].m_vPosition;
-        n.m_vPosition += MoveTowards(posThis, pos, 0.5f, ezSimdVec4f(1, 0, 0), fError, m_vSegmentLength.x);
+        const Node& n = m_Nodes[y * m_uiWidth + x];
+
+        const ezVec3 pos = ezSimdConversion::ToVec3(n.m_vPosition);
+        const ezVec3 prev = ezSimdConversion::ToVec3(n.m_vPreviousPosition);
+        const float fMovable = n.m_bFixed ? 0.0f : 1.0f;
+
+        pData[PosX][k] = pos.x;
+        pData[PosY][k] = pos.y;
+        pData[PosZ][k] = pos.z;
+        pData[PrevX][k] = prev.x;
+        pData[PrevY][k] = prev.y;
+        pData[PrevZ][k] = prev.z;
+
+        // every constraint moves the node half the error amount
+        pData[WeightLeft][k] = (x > 0) ? 0.5f * fMovable : 0.0f;
+        pData[WeightRight][k] = (x + 1 < m_uiWidth) ? 0.5f * fMovable : 0.0f;
+        pData[WeightUp][k] = (y > 0) ? 0.5f * fMovable : 0.0f;
+        pData[WeightDown][k] = (y + 1 < m_uiHeight) ? 0.5f * fMovable : 0.0f;
+        pData[Movable][k] = fMovable;
       }
+    }
+  }
+}
 
-      if (y > 0)
-      {
-        const ezSimdVec4f pos = m_Nodes[idx - m_uiWidth].m_vPosition;
-        n.m_vPosition += MoveTowards(posThis, pos, 0.5f, ezSimdVec4f(0, -1, 0), fError, m_vSegmentLength.y);
-      }
+void ezClothSimulator::CopyNodesFromSoA()
+{
+  for (ezUInt32 uiColor = 0; uiColor < 2; ++uiColor)
+  {
+    for (ezUInt32 y = 0; y < m_uiHeight; ++y)
+    {
+      const ezUInt32 uiFirstX = (y + uiColor) & 1;
+
+      const float* pPosX = GetSoAData(uiColor, PosX, y);
+      const float* pPosY = GetSoAData(uiColor, PosY, y);
+      const float* pPosZ = GetSoAData(uiColor, PosZ, y);
+      const float* pPrevX = GetSoAData(uiColor, PrevX, y);
+      const float* pPrevY = GetSoAData(uiColor, PrevY, y);
+      const float* pPrevZ = GetSoAData(uiColor, PrevZ, y);
 
-      if (y + 1 < m_uiHeight)
+      for (ezUInt32 x = uiFirstX, k = 0; x < m_uiWidth; x += 2, ++k)
       {
-        const ezSimdVec4f pos = m_Nodes[idx + m_uiWidth].m_vPosition;
-        n.m_vPosition += MoveTowards(posThis, pos, 0.5f, ezSimdVec4f(0, 1, 0), fError, m_vSegmentLength.y);
+        Node& n = m_Nodes[y * m_uiWidth + x];
+
+        n.m_vPosition.Set(pPosX[k], pPosY[k], pPosZ[k], 0.0f);
+        n.m_vPreviousPosition.Set(pPrevX[k], pPrevY[k], pPrevZ[k], 0.0f);
       }
     }
   }
-
-  return fError;
 }
 
-ezSimdVec4f ezClothSimulator::MoveTowards(const ezSimdVec4f posThis, const ezSimdVec4f posNext, ezSimdFloat factor, const ezSimdVec4f fallbackDir, ezSimdFloat& inout_fError, ezSimdFloat fSegLen)
+ezSimdFloat ezClothSimulator::EnforceDistanceConstraintSoA(ezUInt32 uiColor)
 {
-  ezSimdVec4f vDir = (posNext - posThis);
-  ezSimdFloat fLen = vDir.GetLength<3>();
-
-  if (fLen.IsEqual(ezSimdFloat::MakeZero(), 0.001f))
-  {
-    vDir = fallbackDir;
-    fLen = 1;
-  }
-
-  vDir /= fLen;
-  fLen -= fSegLen;
+  // nodes of one color only have neighbors of the other color
+  // so all nodes of one color can be moved at once, while their neighbors stay in place
 
-  const ezSimdFloat fLocalError = fLen * factor;
+  const ezUInt32 uiOtherColor = 1 - uiColor;
+  const ezSimdFloat fSegLenX = m_vSegmentLength.x;
+  const ezSimdFloat fSegLenY = m_vSegmentLength.y;
 
-  vDir *= fLocalError;
+  ezSimdVec4f vError = ezSimdVec4f::MakeZero();
 
-  // keep track of how much the rope had to be moved to fulfill the constraint
-  inout_fError += fLocalError.Abs();
+  for (ezUInt32 y = 0; y < m_uiHeight; ++y)
+  {
+    const ezUInt32 uiFirstX = (y + uiColor) & 1;
+    const ezUInt32 uiNumNodes = (m_uiWidth - uiFirstX + 1) / 2;
+
+    float* pPosX = GetSoAData(uiColor, PosX, y);
+    float* pPosY = GetSoAData(uiColor, PosY, y);
+    float* pPosZ = GetSoAData(uiColor, PosZ, y);
+    const float* pWeightLeft = GetSoAData(uiColor, WeightLeft, y);
+    const float* pWeightRight = GetSoAData(uiColor, WeightRight, y);
+    const float* pWeightUp = GetSoAData(uiColor, WeightUp, y);
+    const float* pWeightDown = GetSoAData(uiColor, WeightDown, y);
+
+    // node k of this color sits at x = 2k + uiFirstX, its left neighbor is at index k - 1 + uiFirstX in the other color's row,
+    // its right neighbor directly after that, and the neighbors above and below are at index k
+    const float* pLeftX = GetSoAData(uiOtherColor, PosX, y) + uiFirstX - 1;
+    const float* pLeftY = GetSoAData(uiOtherColor, PosY, y) + uiFirstX - 1;
+    const float* pLeftZ = GetSoAData(uiOtherColor, PosZ, y) + uiFirstX - 1;
+    const float* pUpX = GetSoAData(uiOtherColor, PosX, static_cast<ezInt32>(y) - 1);
+    const float* pUpY = GetSoAData(uiOtherColor, PosY, static_cast<ezInt32>(y) - 1);
+    const float* pUpZ = GetSoAData(uiOtherColor, PosZ, static_cast<ezInt32>(y) - 1);
+    const float* pDownX = GetSoAData(uiOtherColor, PosX, y + 1);
+    const float* pDownY = GetSoAData(uiOtherColor, PosY, y + 1);
+    const float* pDownZ = GetSoAData(uiOtherColor, PosZ, y + 1);
+
+    for (ezUInt32 k = 0; k < uiNumNodes; k += 4)
+    {
+      ezSimdVec4f vPosX, vPosY, vPosZ;
+      vPosX.Load<4>(pPosX + k);
+      vPosY.Load<4>(pPosY + k);
+      vPosZ.Load<4>(pPosZ + k);
+
+      ezSimdVec4f moveX = ezSimdVec4f::MakeZero();
+      ezSimdVec4f moveY = ezSimdVec4f::MakeZero();
+      ezSimdVec4f moveZ = ezSimdVec4f::MakeZero();
+
+      ApplyDistanceConstraint(vPosX, vPosY, vPosZ, pLeftX + k, pLeftY + k, pLeftZ + k, pWeightLeft + k, fSegLenX, -1, 0, moveX, moveY, moveZ, vError);
+      ApplyDistanceConstraint(vPosX, vPosY, vPosZ, pLeftX + k + 1, pLeftY + k + 1, pLeftZ + k + 1, pWeightRight + k, fSegLenX, 1, 0, moveX, moveY, moveZ, vError);
+      ApplyDistanceConstraint(vPosX, vPosY, vPosZ, pUpX + k, pUpY + k, pUpZ + k, pWeightUp + k, fSegLenY, 0, -1, moveX, moveY, moveZ, vError);
+      ApplyDistanceConstraint(vPosX, vPosY, vPosZ, pDownX + k, pDownY + k, pDownZ + k, pWeightDown + k, fSegLenY, 0, 1, moveX, moveY, moveZ, vError);
+
+      (vPosX + moveX).Store<4>(pPosX + k);
+      (vPosY + moveY).Store<4>(pPosY + k);
+      (vPosZ + moveZ).Store<4>(pPosZ + k);
+    }
+  }
 
-  return vDir;
+  return vError.HorizontalSum<4>();
 }
 
-void ezClothSimulator::UpdateNodePositions(const ezSimdFloat tDiffSqr)
+void ezClothSimulator::UpdateNodePositionsSoA(const ezSimdFloat tDiffSqr)
 {
   const ezSimdFloat damping = m_fDampingFactor;
-  const ezSimdVec4f acceleration = ezSimdConversion::ToVec3(m_vAcceleration) * tDiffSqr;
+  const ezSimdVec4f acceleration[3] = {ezSimdVec4f(m_vAcceleration.x * tDiffSqr), ezSimdVec4f(m_vAcceleration.y * tDiffSqr), ezSimdVec4f(m_vAcceleration.z * tDiffSqr)};
 
-  for (auto& n : m_Nodes)
+  for (ezUInt32 uiColor = 0; uiColor < 2; ++uiColor)
   {
-    if (n.m_bFixed)
+    for (ezUInt32 y = 0; y < m_uiHeight; ++y)
     {
-      n.m_vPreviousPosition = n.m_vPosition;
-    }
-    else
-    {
-      // this (simple) logic is the so called 'Verlet integration' (+ damping)
+      const ezUInt32 uiNumNodes = (m_uiWidth - ((y + uiColor) & 1) + 1) / 2;
+      const float* pMovable = GetSoAData(uiColor, Movable, y);
+
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        float* pPos = GetSoAData(uiColor, PosX + c, y);
+        float* pPrev = GetSoAData(uiColor, PrevX + c, y);
+
+        for (ezUInt32 k = 0; k < uiNumNodes; k += 4)
+        {
+          // this (simple) logic is the so called 'Verlet integration' (+ damping)
+          // fixed nodes don't move, but their previous position is updated, so that they have no velocity
 
-      const ezSimdVec4f previousPos = n.m_vPosition;
+          ezSimdVec4f pos, prev, movable;
+          pos.Load<4>(pPos + k);
+          prev.Load<4>(pPrev + k);
+          movable.Load<4>(pMovable + k);
 
-      const ezSimdVec4f vel = (n.m_vPosition - n.m_vPreviousPosition) * damping;
+          const ezSimdVec4f vel = (pos - prev) * damping;
 
-      // instead of using a single global acceleration, this could also use individual accelerations per node
-      // this would be needed to affect the rope more localized
-      n.m_vPosition += vel + acceleration;
-      n.m_vPreviousPosition = previousPos;
+          pos.Store<4>(pPrev + k);
+          ezSimdVec4f::MulAdd(vel + acceleration[c], movable, pos).Store<4>(pPos + k);
+        }
+      }
     }
   }
 }
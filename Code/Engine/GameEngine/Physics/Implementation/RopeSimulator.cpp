@@ -3,6 +3,52 @@
 #include <Foundation/SimdMath/SimdConversion.h>
 #include <GameEngine/Physics/RopeSimulator.h>
 
+namespace
+{
+  enum SoAChannel
+  {
+    PosX,
+    PosY,
+    PosZ,
+    PrevX,
+    PrevY,
+    PrevZ,
+    WeightPrev,
+    WeightNext,
+    Movable,
+    NumChannels
+  };
+
+  /// \brief Pulls four nodes towards one neighbor each, if they are further apart than the segment length.
+  ///
+  /// The neighbor weight is zero for nodes that are fixed or don't have this neighbor.
+  EZ_ALWAYS_INLINE void ApplyDistanceConstraint(const ezSimdVec4f& vPosX, const ezSimdVec4f& vPosY, const ezSimdVec4f& vPosZ, const float* pOtherX, const float* pOtherY, const float* pOtherZ, const float* pWeight, const ezSimdVec4f& vSegLen, ezSimdVec4f& inout_vMoveX, ezSimdVec4f& inout_vMoveY, ezSimdVec4f& inout_vMoveZ, ezSimdVec4f& inout_vError)
+  {
+    ezSimdVec4f dirX, dirY, dirZ, weight;
+    dirX.Load<4>(pOtherX);
+    dirY.Load<4>(pOtherY);
+    dirZ.Load<4>(pOtherZ);
+    weight.Load<4>(pWeight);
+
+    dirX -= vPosX;
+    dirY -= vPosY;
+    dirZ -= vPosZ;
+
+    const ezSimdVec4f len = ezSimdVec4f::MulAdd(dirX, dirX, ezSimdVec4f::MulAdd(dirY, dirY, dirZ.CompMul(dirZ))).GetSqrt<ezMathAcc::FULL>();
+
+    // ropes only pull, nodes that are closer than the segment length are not pushed apart
+    const ezSimdVec4f localError = (len - vSegLen).CompMax(ezSimdVec4f::MakeZero()).CompMul(weight);
+    const ezSimdVec4f scale = localError.CompDiv(len.CompMax(ezSimdVec4f(0.001f)));
+
+    inout_vMoveX = ezSimdVec4f::MulAdd(dirX, scale, inout_vMoveX);
+    inout_vMoveY = ezSimdVec4f::MulAdd(dirY, scale, inout_vMoveY);
+    inout_vMoveZ = ezSimdVec4f::MulAdd(dirZ, scale, inout_vMoveZ);
+
+    // keep track of how much the rope had to be moved to fulfill the constraint
+    inout_vError += localError;
+  }
+} // namespace
+
 ezRopeSimulator::ezRopeSimulator() = default;
 ezRopeSimulator::~ezRopeSimulator() = default;
 
@@ -14,12 +60,30 @@ void ezRopeSimulator::SimulateRope(const ezTime& diff)
   const ezSimdFloat tStepSqr = static_cast<float>(tStep.GetSeconds() * tStep.GetSeconds());
   const ezSimdFloat fAllowedError = m_fSegmentLength;
 
+  if (m_LeftOverTimeStep < tStep)
+    return;
+
+  const bool bSimulate = m_Nodes.GetCount() >= 2;
+
+  if (bSimulate)
+  {
+    CopyNodesToSoA();
+  }
+
   while (m_LeftOverTimeStep >= tStep)
   {
-    SimulateStep(tStepSqr, 32, fAllowedError);
+    if (bSimulate)
+    {
+      SimulateStepSoA(tStepSqr, 32, fAllowedError);
+    }
 
     m_LeftOverTimeStep -= tStep;
   }
+
+  if (bSimulate)
+  {
+    CopyNodesFromSoA();
+  }
 }
 
 void ezRopeSimulator::SimulateStep(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError)
@@ -27,12 +91,19 @@ void ezRopeSimulator::SimulateStep(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIte
   if (m_Nodes.GetCount() < 2)
     return;
 
-  UpdateNodePositions(fDiffSqr);
+  CopyNodesToSoA();
+  SimulateStepSoA(fDiffSqr, uiMaxIterations, fAllowedError);
+  CopyNodesFromSoA();
+}
+
+void ezRopeSimulator::SimulateStepSoA(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError)
+{
+  UpdateNodePositionsSoA(fDiffSqr);
 
   // repeatedly apply the distance constraint, until the overall error is low enough
   for (ezUInt32 i = 0; i < uiMaxIterations; ++i)
   {
-    const ezSimdFloat fError = EnforceDistanceConstraint();
+    const ezSimdFloat fError = EnforceDistanceConstraintSoA(0) + EnforceDistanceConstraintSoA(1);
 
     if (fError < fAllowedError)
       return;
@@ -41,23 +112,30 @@ void ezRopeSimulator::SimulateStep(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIte
 
 void ezRopeSimulator::SimulateTillEquilibrium(ezSimdFloat fAllowedMovement, ezUInt32 uiMaxIterations)
 {
+  if (m_Nodes.GetCount() < 2)
+    return;
+
   constexpr ezTime tStep = ezTime::MakeFromSeconds(1.0 / 60.0);
   ezSimdFloat tStepSqr = static_cast<float>(tStep.GetSeconds() * tStep.GetSeconds());
 
   ezUInt8 uiInEquilibrium = 0;
 
+  CopyNodesToSoA();
+
   while (uiInEquilibrium < 100 && uiMaxIterations > 0)
   {
     --uiMaxIterations;
 
-    SimulateStep(tStepSqr, 32, m_fSegmentLength);
+    SimulateStepSoA(tStepSqr, 32, m_fSegmentLength);
     uiInEquilibrium++;
 
-    if (!HasEquilibrium(fAllowedMovement))
+    if (!HasEquilibriumSoA(fAllowedMovement))
     {
       uiInEquilibrium = 0;
     }
   }
+
+  CopyNodesFromSoA();
 }
 
 bool ezRopeSimulator::HasEquilibrium(ezSimdFloat fAllowedMovement) const
@@ -121,103 +199,215 @@ ezSimdVec4f ezRopeSimulator::GetPositionAtLength(float fLength) const
   return m_Nodes.PeekBack().m_vPosition;
 }
 
-ezSimdVec4f ezRopeSimulator::MoveTowards(const ezSimdVec4f posThis, const ezSimdVec4f posNext, ezSimdFloat factor, const ezSimdVec4f fallbackDir, ezSimdFloat& inout_fError)
+float* ezRopeSimulator::GetSoAData(ezUInt32 uiParity, ezUInt32 uiChannel)
+{
+  // there is one padding element in front of each channel, so that the first node can read its (non-existing) previous neighbor
+  return m_SoAData.GetData() + (uiParity * NumChannels + uiChannel) * m_uiSoAStride + 1;
+}
+
+void ezRopeSimulator::CopyNodesToSoA()
 {
-  ezSimdVec4f vDir = (posNext - posThis);
-  ezSimdFloat fLen = vDir.GetLength<3>();
+  const ezUInt32 uiNumNodes = m_Nodes.GetCount();
 
-  if (fLen < m_fSegmentLength)
+  if (m_uiSoANodes != uiNumNodes)
   {
-    return ezSimdVec4f::MakeZero();
-  }
+    m_uiSoANodes = uiNumNodes;
 
-  vDir /= fLen;
-  fLen -= m_fSegmentLength;
+    // each channel holds every other node, plus enough padding to always load full SIMD vectors
+    m_uiSoAStride = ezMemoryUtils::AlignSize<ezUInt32>((uiNumNodes + 1) / 2 + 5, 4);
 
-  const ezSimdFloat fLocalError = fLen * factor;
+    m_SoAData.Clear();
+    m_SoAData.SetCount(2 * NumChannels * m_uiSoAStride);
+  }
 
-  vDir *= fLocalError;
+  for (ezUInt32 uiParity = 0; uiParity < 2; ++uiParity)
+  {
+    float* pData[NumChannels];
+    for (ezUInt32 c = 0; c < NumChannels; ++c)
+    {
+      pData[c] = GetSoAData(uiParity, c);
+    }
 
-  // keep track of how much the rope had to be moved to fulfill the constraint
-  inout_fError += fLocalError.Abs();
+    for (ezUInt32 i = uiParity, k = 0; i < uiNumNodes; i += 2, ++k)
+    {
+      const Node& n = m_Nodes[i];
+
+      const ezVec3 pos = ezSimdConversion::ToVec3(n.m_vPosition);
+      const ezVec3 prev = ezSimdConversion::ToVec3(n.m_vPreviousPosition);
+
+      pData[PosX][k] = pos.x;
+      pData[PosY][k] = pos.y;
+      pData[PosZ][k] = pos.z;
+      pData[PrevX][k] = prev.x;
+      pData[PrevY][k] = prev.y;
+      pData[PrevZ][k] = prev.z;
+
+      // just move each node half the error amount towards the left and right neighboring nodes
+      // the ends are either not moved at all (when they are 'attached' to something)
+      // or they are moved most of the way
+      float fWeightPrev = 0.5f;
+      float fWeightNext = 0.5f;
+      float fMovable = 1.0f;
+
+      if (i == 0)
+      {
+        fWeightPrev = 0.0f;
+        fWeightNext = 0.75f;
+        fMovable = m_bFirstNodeIsFixed ? 0.0f : 1.0f;
+      }
+      else if (i + 1 == uiNumNodes)
+      {
+        fWeightPrev = 0.75f;
+        fWeightNext = 0.0f;
+        fMovable = m_bLastNodeIsFixed ? 0.0f : 1.0f;
+      }
+
+      pData[WeightPrev][k] = fWeightPrev * fMovable;
+      pData[WeightNext][k] = fWeightNext * fMovable;
+      pData[Movable][k] = fMovable;
+    }
+  }
+}
 
-  return vDir;
+void ezRopeSimulator::CopyNodesFromSoA()
+{
+  for (ezUInt32 uiParity = 0; uiParity < 2; ++uiParity)
+  {
+    const float* pPosX = GetSoAData(uiParity, PosX);
+    const float* pPosY = GetSoAData(uiParity, PosY);
+    const float* pPosZ = GetSoAData(uiParity, PosZ);
+    const float* pPrevX = GetSoAData(uiParity, PrevX);
+    const float* pPrevY = GetSoAData(uiParity, PrevY);
+    const float* pPrevZ = GetSoAData(uiParity, PrevZ);
+
+    for (ezUInt32 i = uiParity, k = 0; i < m_Nodes.GetCount(); i += 2, ++k)
+    {
+      Node& n = m_Nodes[i];
+
+      n.m_vPosition.Set(pPosX[k], pPosY[k], pPosZ[k], 0.0f);
+      n.m_vPreviousPosition.Set(pPrevX[k], pPrevY[k], pPrevZ[k], 0.0f);
+    }
+  }
 }
 
-ezSimdFloat ezRopeSimulator::EnforceDistanceConstraint()
+ezSimdFloat ezRopeSimulator::EnforceDistanceConstraintSoA(ezUInt32 uiParity)
 {
   // this is the "Jakobsen method" to enforce the distance constraints in each rope node
-  // just move each node half the error amount towards the left and right neighboring nodes
-  // the ends are either not moved at all (when they are 'attached' to something)
-  // or they are moved most of the way
+  // nodes with even indices only have odd neighbors and vice versa,
+  // so all nodes of one parity can be moved at once, while their neighbors stay in place
   // this is applied iteratively until the overall error is pretty low
 
-  auto& firstNode = m_Nodes[0];
-  auto& lastNode = m_Nodes.PeekBack();
+  const ezUInt32 uiNumNodes = (m_uiSoANodes - uiParity + 1) / 2;
+  const ezSimdVec4f vSegLen(m_fSegmentLength);
 
-  ezSimdFloat fError = ezSimdFloat::MakeZero();
+  float* pPosX = GetSoAData(uiParity, PosX);
+  float* pPosY = GetSoAData(uiParity, PosY);
+  float* pPosZ = GetSoAData(uiParity, PosZ);
+  const float* pWeightPrev = GetSoAData(uiParity, WeightPrev);
+  const float* pWeightNext = GetSoAData(uiParity, WeightNext);
 
-  if (!m_bFirstNodeIsFixed)
-  {
-    const ezSimdVec4f posThis = m_Nodes[0].m_vPosition;
-    const ezSimdVec4f posNext = m_Nodes[1].m_vPosition;
+  // node k with this parity has index 2k + uiParity, its previous neighbor is at k - 1 + uiParity in the other array
+  // and its next neighbor directly after that
+  const float* pPrevX = GetSoAData(1 - uiParity, PosX) + uiParity - 1;
+  const float* pPrevY = GetSoAData(1 - uiParity, PosY) + uiParity - 1;
+  const float* pPrevZ = GetSoAData(1 - uiParity, PosZ) + uiParity - 1;
 
-    m_Nodes[0].m_vPosition += MoveTowards(posThis, posNext, 0.75f, ezSimdVec4f(0, 0, 1), fError);
-  }
+  ezSimdVec4f vError = ezSimdVec4f::MakeZero();
 
-  for (ezUInt32 i = 1; i < m_Nodes.GetCount() - 1; ++i)
+  for (ezUInt32 k = 0; k < uiNumNodes; k += 4)
   {
-    const ezSimdVec4f posThis = m_Nodes[i].m_vPosition;
-    const ezSimdVec4f posPrev = m_Nodes[i - 1].m_vPosition;
-    const ezSimdVec4f posNext = m_Nodes[i + 1].m_vPosition;
+    ezSimdVec4f vPosX, vPosY, vPosZ;
+    vPosX.Load<4>(pPosX + k);
+    vPosY.Load<4>(pPosY + k);
+    vPosZ.Load<4>(pPosZ + k);
 
-    m_Nodes[i].m_vPosition += MoveTowards(posThis, posPrev, 0.5f, ezSimdVec4f(0, 0, 1), fError);
-    m_Nodes[i].m_vPosition += MoveTowards(posThis, posNext, 0.5f, ezSimdVec4f(0, 0, -1), fError);
-  }
+    ezSimdVec4f moveX = ezSimdVec4f::MakeZero();
+    ezSimdVec4f moveY = ezSimdVec4f::MakeZero();
+    ezSimdVec4f moveZ = ezSimdVec4f::MakeZero();
 
-  if (!m_bLastNodeIsFixed)
-  {
-    const ezUInt32 i = m_Nodes.GetCount() - 1;
-    const ezSimdVec4f posThis = m_Nodes[i].m_vPosition;
-    const ezSimdVec4f posPrev = m_Nodes[i - 1].m_vPosition;
+    ApplyDistanceConstraint(vPosX, vPosY, vPosZ, pPrevX + k, pPrevY + k, pPrevZ + k, pWeightPrev + k, vSegLen, moveX, moveY, moveZ, vError);
+    ApplyDistanceConstraint(vPosX, vPosY, vPosZ, pPrevX + k + 1, pPrevY + k + 1, pPrevZ + k + 1, pWeightNext + k, vSegLen, moveX, moveY, moveZ, vError);
 
-    m_Nodes[i].m_vPosition += MoveTowards(posThis, posPrev, 0.75f, ezSimdVec4f(0, 0, 1), fError);
+    (vPosX + moveX).Store<4>(pPosX + k);
+    (vPosY + moveY).Store<4>(pPosY + k);
+    (vPosZ + moveZ).Store<4>(pPosZ + k);
   }
 
-  return fError;
+  return vError.HorizontalSum<4>();
 }
 
-void ezRopeSimulator::UpdateNodePositions(const ezSimdFloat tDiffSqr)
+void ezRopeSimulator::UpdateNodePositionsSoA(const ezSimdFloat tDiffSqr)
 {
-  const ezUInt32 uiFirstNode = m_bFirstNodeIsFixed ? 1 : 0;
-  const ezUInt32 uiNumNodes = m_bLastNodeIsFixed ? m_Nodes.GetCount() - 1 : m_Nodes.GetCount();
-
   const ezSimdFloat damping = m_fDampingFactor;
 
-  const ezSimdVec4f acceleration = ezSimdConversion::ToVec3(m_vAcceleration) * tDiffSqr;
+  // instead of using a single global acceleration, this could also use individual accelerations per node
+  // this would be needed to affect the rope more localized
+  const ezSimdVec4f acceleration[3] = {ezSimdVec4f(m_vAcceleration.x * tDiffSqr), ezSimdVec4f(m_vAcceleration.y * tDiffSqr), ezSimdVec4f(m_vAcceleration.z * tDiffSqr)};
 
-  for (ezUInt32 i = uiFirstNode; i < uiNumNodes; ++i)
+  for (ezUInt32 uiParity = 0; uiParity < 2; ++uiParity)
   {
-    // this (simple) logic is the so called 'Verlet integration' (+ damping)
+    const ezUInt32 uiNumNodes = (m_uiSoANodes - uiParity + 1) / 2;
+    const float* pMovable = GetSoAData(uiParity, Movable);
 
-    auto& n = m_Nodes[i];
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      float* pPos = GetSoAData(uiParity, PosX + c);
+      float* pPrev = GetSoAData(uiParity, PrevX + c);
 
-    const ezSimdVec4f previousPos = n.m_vPosition;
+      for (ezUInt32 k = 0; k < uiNumNodes; k += 4)
+      {
+        // this (simple) logic is the so called 'Verlet integration' (+ damping)
+        // fixed nodes don't move, but their previous position is updated, so that they have no velocity
 
-    const ezSimdVec4f vel = (n.m_vPosition - n.m_vPreviousPosition) * damping;
+        ezSimdVec4f pos, prev, movable;
+        pos.Load<4>(pPos + k);
+        prev.Load<4>(pPrev + k);
+        movable.Load<4>(pMovable + k);
 
-    // instead of using a single global acceleration, this could also use individual accelerations per node
-    // this would be needed to affect the rope more localized
-    n.m_vPosition += vel + acceleration;
-    n.m_vPreviousPosition = previousPos;
-  }
+        const ezSimdVec4f vel = (pos - prev) * damping;
 
-  if (m_bFirstNodeIsFixed)
-  {
-    m_Nodes[0].m_vPreviousPosition = m_Nodes[0].m_vPosition;
+        pos.Store<4>(pPrev + k);
+        ezSimdVec4f::MulAdd(vel + acceleration[c], movable, pos).Store<4>(pPos + k);
+      }
+    }
   }
-  if (m_bLastNodeIsFixed)
+}
+
+bool ezRopeSimulator::HasEquilibriumSoA(ezSimdFloat fAllowedMovement)
+{
+  const ezSimdVec4f vErrorSqr(fAllowedMovement * fAllowedMovement);
+
+  for (ezUInt32 uiParity = 0; uiParity < 2; ++uiParity)
   {
-    m_Nodes.PeekBack().m_vPreviousPosition = m_Nodes.PeekBack().m_vPosition;
+    const ezUInt32 uiNumNodes = (m_uiSoANodes - uiParity + 1) / 2;
+
+    const float* pPosX = GetSoAData(uiParity, PosX);
+    const float* pPosY = GetSoAData(uiParity, PosY);
+    const float* pPosZ = GetSoAData(uiParity, PosZ);
+    const float* pPrevX = GetSoAData(uiParity, PrevX);
+    const float* pPrevY = GetSoAData(uiParity, PrevY);
+    const float* pPrevZ = GetSoAData(uiParity, PrevZ);
+
+    for (ezUInt32 k = 0; k < uiNumNodes; k += 4)
+    {
+      ezSimdVec4f posX, posY, posZ, prevX, prevY, prevZ;
+      posX.Load<4>(pPosX + k);
+      posY.Load<4>(pPosY + k);
+      posZ.Load<4>(pPosZ + k);
+      prevX.Load<4>(pPrevX + k);
+      prevY.Load<4>(pPrevY + k);
+      prevZ.Load<4>(pPrevZ + k);
+
+      const ezSimdVec4f moveX = posX - prevX;
+      const ezSimdVec4f moveY = posY - prevY;
+      const ezSimdVec4f moveZ = posZ - prevZ;
+
+      const ezSimdVec4f moveSqr = ezSimdVec4f::MulAdd(moveX, moveX, ezSimdVec4f::MulAdd(moveY, moveY, moveZ.CompMul(moveZ)));
+
+      if ((moveSqr > vErrorSqr).AnySet<4>())
+        return false;
+    }
   }
+
+  return true;
 }
@@ -12,6 +12,9 @@
 /// Uses Verlet Integration to update the rope positions from velocities, and the "Jakobsen method" to enforce
 /// rope distance constraints.
 ///
+/// For the simulation the nodes are copied into a structure-of-arrays layout, split into nodes with even and odd indices.
+/// Since even nodes only have odd neighbors and vice versa, all nodes of one group can be moved at once, four at a time.
+///
 /// Based on https://owlree.blog/posts/simulating-a-rope.html
 class EZ_GAMEENGINE_DLL ezRopeSimulator
 {
@@ -54,9 +57,19 @@ public:
   ezSimdVec4f GetPositionAtLength(float fLength) const;
 
 private:
-  ezSimdFloat EnforceDistanceConstraint();
-  void UpdateNodePositions(const ezSimdFloat tDiffSqr);
-  ezSimdVec4f MoveTowards(const ezSimdVec4f posThis, const ezSimdVec4f posNext, ezSimdFloat factor, const ezSimdVec4f fallbackDir, ezSimdFloat& inout_fError);
+  void CopyNodesToSoA();
+  void CopyNodesFromSoA();
+
+  void SimulateStepSoA(const ezSimdFloat fDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError);
+  void UpdateNodePositionsSoA(const ezSimdFloat tDiffSqr);
+  ezSimdFloat EnforceDistanceConstraintSoA(ezUInt32 uiParity);
+  bool HasEquilibriumSoA(ezSimdFloat fAllowedMovement);
+
+  float* GetSoAData(ezUInt32 uiParity, ezUInt32 uiChannel);
 
   ezTime m_LeftOverTimeStep;
+
+  ezUInt32 m_uiSoAStride = 0;
+  ezUInt32 m_uiSoANodes = 0;
+  ezDynamicArray<float, ezAlignedAllocatorWrapper> m_SoAData;
 };
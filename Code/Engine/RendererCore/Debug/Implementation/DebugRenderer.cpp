@@ -1921,6 +1921,7 @@ EZ_BEGIN_STATIC_REFLECTED_TYPE(ezScriptExtensionClass_Debug, ezNoBase, 1, ezRTTI
   EZ_BEGIN_ATTRIBUTES
   {
     new ezScriptExtensionAttribute("Debug"),
+    new ezScriptThreadSafeAttribute(),
   }
   EZ_END_ATTRIBUTES;
 }
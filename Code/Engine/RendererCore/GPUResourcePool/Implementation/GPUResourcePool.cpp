@@ -1,6 +1,7 @@
 #include <RendererCore/RendererCorePCH.h>
 
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Metrics.h>
 #include <RendererCore/GPUResourcePool/GPUResourcePool.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Device/Device.h>
@@ -322,8 +323,8 @@ void ezGPUResourcePool::CheckAndPotentiallyRunGC()
 void ezGPUResourcePool::UpdateMemoryStats() const
 {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  float fMegaBytes = float(m_uiCurrentlyAllocatedMemory) / (1024.0f * 1024.0f);
-  ezStats::SetStat("GPU Resource Pool/Memory Consumption (MB)", fMegaBytes);
+  static ezMetricGauge s_MemoryConsumption("GPU Resource Pool/Memory Consumption (MB)");
+  s_MemoryConsumption.Set(double(m_uiCurrentlyAllocatedMemory) / (1024.0 * 1024.0));
 #endif
 }
 
@@ -1,5 +1,6 @@
 #include <RendererCore/RendererCorePCH.h>
 
+#include <Core/WorldSerializer/WorldSerializerAttributes.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 #include <RendererCore/Meshes/CpuMeshResource.h>
 #include <RendererCore/Meshes/MeshComponent.h>
@@ -21,6 +22,11 @@ EZ_BEGIN_COMPONENT_TYPE(ezMeshComponent, 3, ezComponentMode::Static)
     EZ_MESSAGE_HANDLER(ezMsgExtractGeometry, OnMsgExtractGeometry)
   }
   EZ_END_MESSAGEHANDLERS;
+  EZ_BEGIN_ATTRIBUTES
+  {
+    new ezThreadSafeDeserializationAttribute(),
+  }
+  EZ_END_ATTRIBUTES;
 }
 EZ_END_COMPONENT_TYPE
 // clang-format on
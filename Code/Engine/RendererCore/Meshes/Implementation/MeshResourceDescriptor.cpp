@@ -5,11 +5,92 @@
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Utilities/AssetFileHeader.h>
 #include <RendererCore/Meshes/MeshResourceDescriptor.h>
+#include <meshoptimizer/meshoptimizer.h>
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
 #  include <Foundation/IO/CompressedStreamZstd.h>
 #endif
 
+namespace
+{
+  /// \brief How the vertex and index buffer data is stored in the file.
+  ///
+  /// The meshoptimizer codecs exploit the structure of vertex and index data, and their output compresses much better with a general purpose
+  /// compressor afterwards, than the raw data.
+  enum class StreamEncoding : ezUInt8
+  {
+    Raw = 0,
+    MeshOpt = 1,
+  };
+
+  void WriteEncodedStream(ezChunkStreamWriter& inout_chunk, StreamEncoding encoding, ezArrayPtr<const ezUInt8> rawData, ezArrayPtr<const ezUInt8> encodedData)
+  {
+    inout_chunk << static_cast<ezUInt8>(encoding);
+
+    // size in bytes
+    inout_chunk << rawData.GetCount();
+
+    const ezArrayPtr<const ezUInt8> data = (encoding == StreamEncoding::Raw) ? rawData : encodedData;
+
+    if (encoding != StreamEncoding::Raw)
+    {
+      inout_chunk << data.GetCount();
+    }
+
+    if (!data.IsEmpty())
+    {
+      inout_chunk.WriteBytes(data.GetPtr(), data.GetCount()).IgnoreResult();
+    }
+  }
+
+  ezResult ReadEncodedStream(ezChunkStreamReader& inout_chunk, ezDynamicArray<ezUInt8, ezAlignedAllocatorWrapper>& out_data, ezUInt32 uiElementSize, bool bIndices)
+  {
+    ezUInt8 uiEncoding = 0;
+    inout_chunk >> uiEncoding;
+
+    // size in bytes
+    ezUInt32 uiSize = 0;
+    inout_chunk >> uiSize;
+    out_data.SetCountUninitialized(uiSize);
+
+    if (uiEncoding == static_cast<ezUInt8>(StreamEncoding::Raw))
+    {
+      if (!out_data.IsEmpty())
+        inout_chunk.ReadBytes(out_data.GetData(), out_data.GetCount());
+
+      return EZ_SUCCESS;
+    }
+
+    if (uiEncoding != static_cast<ezUInt8>(StreamEncoding::MeshOpt) || uiElementSize == 0 || (uiSize % uiElementSize) != 0)
+    {
+      ezLog::Error("Mesh buffer data is encoded with an unknown or invalid format ({0}).", uiEncoding);
+      return EZ_FAILURE;
+    }
+
+    ezUInt32 uiEncodedSize = 0;
+    inout_chunk >> uiEncodedSize;
+
+    ezDynamicArray<ezUInt8> encodedData;
+    encodedData.SetCountUninitialized(uiEncodedSize);
+
+    if (inout_chunk.ReadBytes(encodedData.GetData(), uiEncodedSize) != uiEncodedSize)
+      return EZ_FAILURE;
+
+    const ezUInt32 uiNumElements = uiSize / uiElementSize;
+
+    const int iResult = bIndices ? meshopt_decodeIndexBuffer(out_data.GetData(), uiNumElements, uiElementSize, encodedData.GetData(), uiEncodedSize)
+                                 : meshopt_decodeVertexBuffer(out_data.GetData(), uiNumElements, uiElementSize, encodedData.GetData(), uiEncodedSize);
+
+    if (iResult != 0)
+    {
+      ezLog::Error("Decoding the mesh {0} buffer failed ({1}).", bIndices ? "index" : "vertex", iResult);
+      return EZ_FAILURE;
+    }
+
+    return EZ_SUCCESS;
+  }
+} // namespace
+
 ezMeshResourceDescriptor::ezMeshResourceDescriptor()
 {
   m_Bounds = ezBoundingBoxSphere::MakeInvalid();
@@ -211,35 +292,81 @@ void ezMeshResourceDescriptor::Save(ezStreamWriter& inout_stream)
     chunk.EndChunk();
   }
 
+  ezUInt32 uiEncodedVertexBytes = 0;
+  ezUInt32 uiEncodedIndexBytes = 0;
+
   {
-    chunk.BeginChunk("VertexBuffer", 1);
+    chunk.BeginChunk("VertexBuffer", 2);
 
-    // size in bytes
-    chunk << m_MeshBufferDescriptor.GetVertexBufferData().GetCount();
+    const ezArrayPtr<const ezUInt8> vertexData = m_MeshBufferDescriptor.GetVertexBufferData();
+    const ezUInt32 uiVertexSize = m_MeshBufferDescriptor.GetVertexDataSize();
 
-    if (!m_MeshBufferDescriptor.GetVertexBufferData().IsEmpty())
+    StreamEncoding encoding = StreamEncoding::Raw;
+    ezDynamicArray<ezUInt8> encodedData;
+
+    // the vertex codec only supports vertex sizes that are a multiple of 4 bytes
+    if (!vertexData.IsEmpty() && uiVertexSize <= 256 && (uiVertexSize % 4) == 0)
     {
-      chunk.WriteBytes(m_MeshBufferDescriptor.GetVertexBufferData().GetData(), m_MeshBufferDescriptor.GetVertexBufferData().GetCount()).IgnoreResult();
+      const ezUInt32 uiVertexCount = m_MeshBufferDescriptor.GetVertexCount();
+
+      encodedData.SetCountUninitialized(static_cast<ezUInt32>(meshopt_encodeVertexBufferBound(uiVertexCount, uiVertexSize)));
+      encodedData.SetCount(static_cast<ezUInt32>(meshopt_encodeVertexBuffer(encodedData.GetData(), encodedData.GetCount(), vertexData.GetPtr(), uiVertexCount, uiVertexSize)));
+
+      if (!encodedData.IsEmpty() && encodedData.GetCount() < vertexData.GetCount())
+      {
+        encoding = StreamEncoding::MeshOpt;
+        uiEncodedVertexBytes = encodedData.GetCount();
+      }
     }
 
+    WriteEncodedStream(chunk, encoding, vertexData, encodedData);
+
     chunk.EndChunk();
   }
 
   // always write the index buffer chunk, even if it is empty
   {
-    chunk.BeginChunk("IndexBuffer", 1);
+    chunk.BeginChunk("IndexBuffer", 2);
 
-    // size in bytes
-    chunk << m_MeshBufferDescriptor.GetIndexBufferData().GetCount();
+    const ezArrayPtr<const ezUInt8> indexData = m_MeshBufferDescriptor.GetIndexBufferData();
 
-    if (!m_MeshBufferDescriptor.GetIndexBufferData().IsEmpty())
+    StreamEncoding encoding = StreamEncoding::Raw;
+    ezDynamicArray<ezUInt8> encodedData;
+
+    // the index codec only supports triangle lists
+    if (!indexData.IsEmpty() && m_MeshBufferDescriptor.GetTopology() == ezGALPrimitiveTopology::Triangles)
     {
-      chunk.WriteBytes(m_MeshBufferDescriptor.GetIndexBufferData().GetData(), m_MeshBufferDescriptor.GetIndexBufferData().GetCount()).IgnoreResult();
+      const ezUInt32 uiIndexCount = m_MeshBufferDescriptor.GetPrimitiveCount() * 3;
+      const ezUInt32 uiVertexCount = m_MeshBufferDescriptor.GetVertexCount();
+
+      encodedData.SetCountUninitialized(static_cast<ezUInt32>(meshopt_encodeIndexBufferBound(uiIndexCount, uiVertexCount)));
+
+      if (m_MeshBufferDescriptor.Uses32BitIndices())
+      {
+        encodedData.SetCount(static_cast<ezUInt32>(meshopt_encodeIndexBuffer(encodedData.GetData(), encodedData.GetCount(), reinterpret_cast<const ezUInt32*>(indexData.GetPtr()), uiIndexCount)));
+      }
+      else
+      {
+        encodedData.SetCount(static_cast<ezUInt32>(meshopt_encodeIndexBuffer(encodedData.GetData(), encodedData.GetCount(), reinterpret_cast<const ezUInt16*>(indexData.GetPtr()), uiIndexCount)));
+      }
+
+      if (!encodedData.IsEmpty() && encodedData.GetCount() < indexData.GetCount())
+      {
+        encoding = StreamEncoding::MeshOpt;
+        uiEncodedIndexBytes = encodedData.GetCount();
+      }
     }
 
+    WriteEncodedStream(chunk, encoding, indexData, encodedData);
+
     chunk.EndChunk();
   }
 
+  if (uiEncodedVertexBytes > 0 || uiEncodedIndexBytes > 0)
+  {
+    ezLog::Dev("Encoded vertex data from {0} KB to {1} KB, index data from {2} KB to {3} KB", ezArgF(m_MeshBufferDescriptor.GetVertexBufferData().GetCount() / 1024.0f, 1), ezArgF(uiEncodedVertexBytes / 1024.0f, 1), ezArgF(m_MeshBufferDescriptor.GetIndexBufferData().GetCount() / 1024.0f, 1), ezArgF(uiEncodedIndexBytes / 1024.0f, 1));
+  }
+
   if (!m_Bones.IsEmpty())
   {
     chunk.BeginChunk("BindPose", 1);
@@ -464,34 +591,50 @@ ezResult ezMeshResourceDescriptor::Load(ezStreamReader& inout_stream)
 
     if (ci.m_sChunkName == "VertexBuffer")
     {
-      if (ci.m_uiChunkVersion != 1)
+      if (ci.m_uiChunkVersion > 2)
       {
         ezLog::Error("Version of chunk '{0}' is invalid ({1})", ci.m_sChunkName, ci.m_uiChunkVersion);
         return EZ_FAILURE;
       }
 
-      // size in bytes
-      chunk >> count;
-      m_MeshBufferDescriptor.GetVertexBufferData().SetCountUninitialized(count);
+      if (ci.m_uiChunkVersion >= 2)
+      {
+        // Version 2: the data may be stored with the meshoptimizer vertex codec, decoding it is fast enough to do it while loading
+        EZ_SUCCEED_OR_RETURN(ReadEncodedStream(chunk, m_MeshBufferDescriptor.GetVertexBufferData(), m_MeshBufferDescriptor.GetVertexDataSize(), false));
+      }
+      else
+      {
+        // size in bytes
+        chunk >> count;
+        m_MeshBufferDescriptor.GetVertexBufferData().SetCountUninitialized(count);
 
-      if (!m_MeshBufferDescriptor.GetVertexBufferData().IsEmpty())
-        chunk.ReadBytes(m_MeshBufferDescriptor.GetVertexBufferData().GetData(), m_MeshBufferDescriptor.GetVertexBufferData().GetCount());
+        if (!m_MeshBufferDescriptor.GetVertexBufferData().IsEmpty())
+          chunk.ReadBytes(m_MeshBufferDescriptor.GetVertexBufferData().GetData(), m_MeshBufferDescriptor.GetVertexBufferData().GetCount());
+      }
     }
 
     if (ci.m_sChunkName == "IndexBuffer")
     {
-      if (ci.m_uiChunkVersion != 1)
+      if (ci.m_uiChunkVersion > 2)
       {
         ezLog::Error("Version of chunk '{0}' is invalid ({1})", ci.m_sChunkName, ci.m_uiChunkVersion);
         return EZ_FAILURE;
       }
 
-      // size in bytes
-      chunk >> count;
-      m_MeshBufferDescriptor.GetIndexBufferData().SetCountUninitialized(count);
+      if (ci.m_uiChunkVersion >= 2)
+      {
+        // Version 2: the data may be stored with the meshoptimizer index codec
+        EZ_SUCCEED_OR_RETURN(ReadEncodedStream(chunk, m_MeshBufferDescriptor.GetIndexBufferData(), b32BitIndices ? 4 : 2, true));
+      }
+      else
+      {
+        // size in bytes
+        chunk >> count;
+        m_MeshBufferDescriptor.GetIndexBufferData().SetCountUninitialized(count);
 
-      if (!m_MeshBufferDescriptor.GetIndexBufferData().IsEmpty())
-        chunk.ReadBytes(m_MeshBufferDescriptor.GetIndexBufferData().GetData(), m_MeshBufferDescriptor.GetIndexBufferData().GetCount());
+        if (!m_MeshBufferDescriptor.GetIndexBufferData().IsEmpty())
+          chunk.ReadBytes(m_MeshBufferDescriptor.GetIndexBufferData().GetData(), m_MeshBufferDescriptor.GetIndexBufferData().GetCount());
+      }
     }
 
     if (ci.m_sChunkName == "BindPose")
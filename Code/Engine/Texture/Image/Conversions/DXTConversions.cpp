@@ -2,6 +2,7 @@
 
 #include <Foundation/Math/Color16f.h>
 #include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/Conversions/DXTConversions.h>
 #include <Texture/Image/Conversions/PixelConversions.h>
 #include <Texture/Image/ImageConversion.h>
@@ -387,6 +388,233 @@ namespace
       }
     }
   }
+
+  /// \brief Returns the squared RGB distance of each of the 4 pixels to the color, alpha is ignored.
+  __m128i getSquaredDistanceRGB(__m128i pixels, __m128i color)
+  {
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i zero = _mm_setzero_si128();
+
+    const __m128i diff = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(pixels, color), _mm_subs_epu8(color, pixels)), rgbMask);
+    const __m128i diffLo = _mm_unpacklo_epi8(diff, zero);
+    const __m128i diffHi = _mm_unpackhi_epi8(diff, zero);
+
+    // madd yields r*r + g*g and b*b + a*a for each pixel, the horizontal add combines the two
+    return _mm_hadd_epi32(_mm_madd_epi16(diffLo, diffLo), _mm_madd_epi16(diffHi, diffHi));
+  }
+
+  /// \brief Finds the closest palette entry of a 4-color block for all 16 pixels. Returns the summed squared error.
+  ezUInt32 findBestIndicesBC1(const __m128i* pPixels, ezUInt16 uiColor0, ezUInt16 uiColor1, ezUInt32& out_uiIndices)
+  {
+    const ezColorBaseUB c0 = ezDecompressB5G6R5(uiColor0);
+    const ezColorBaseUB c1 = ezDecompressB5G6R5(uiColor1);
+
+    // Same interpolation as in ezDecompressBlockBC1
+    ezColorBaseUB palette[4];
+    palette[0] = c0;
+    palette[1] = c1;
+    palette[2] = ezColorBaseUB((2 * c0.r + c1.r + 1) / 3, (2 * c0.g + c1.g + 1) / 3, (2 * c0.b + c1.b + 1) / 3, 0xFF);
+    palette[3] = ezColorBaseUB((c0.r + 2 * c1.r + 1) / 3, (c0.g + 2 * c1.g + 1) / 3, (c0.b + 2 * c1.b + 1) / 3, 0xFF);
+
+    __m128i paletteColors[4];
+    for (ezUInt32 k = 0; k < 4; ++k)
+    {
+      ezUInt32 uiColor;
+      memcpy(&uiColor, &palette[k], sizeof(uiColor));
+      paletteColors[k] = _mm_set1_epi32(uiColor);
+    }
+
+    __m128i indices = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      __m128i bestDistance = getSquaredDistanceRGB(pPixels[row], paletteColors[0]);
+      __m128i bestIndex = _mm_setzero_si128();
+
+      for (ezUInt32 k = 1; k < 4; ++k)
+      {
+        const __m128i distance = getSquaredDistanceRGB(pPixels[row], paletteColors[k]);
+        const __m128i closer = _mm_cmplt_epi32(distance, bestDistance);
+        bestDistance = _mm_min_epi32(distance, bestDistance);
+        bestIndex = _mm_blendv_epi8(bestIndex, _mm_set1_epi32(k), closer);
+      }
+
+      // Move the 2 bit index of each pixel to its position in the index bits of the block
+      const ezUInt32 uiShift = 8 * row;
+      const __m128i multiplier = _mm_setr_epi32(1 << (uiShift + 0), 1 << (uiShift + 2), 1 << (uiShift + 4), 1 << (uiShift + 6));
+      indices = _mm_or_si128(indices, _mm_mullo_epi32(bestIndex, multiplier));
+      error = _mm_add_epi32(error, bestDistance);
+    }
+
+    indices = _mm_or_si128(indices, _mm_shuffle_epi32(indices, _MM_SHUFFLE(1, 0, 3, 2)));
+    indices = _mm_or_si128(indices, _mm_shuffle_epi32(indices, _MM_SHUFFLE(2, 3, 0, 1)));
+    error = _mm_add_epi32(error, _mm_shuffle_epi32(error, _MM_SHUFFLE(1, 0, 3, 2)));
+    error = _mm_add_epi32(error, _mm_shuffle_epi32(error, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    out_uiIndices = _mm_cvtsi128_si32(indices);
+    return _mm_cvtsi128_si32(error);
+  }
+
+  /// \brief Picks the initial endpoints of a color block from the bounding box of its pixels.
+  ///
+  /// The diagonal of the box follows the correlation of the channels and both ends are moved inwards by 1/16 of the range,
+  /// which places them closer to the actual colors than the corners of the box.
+  void findEndpointsBC1(const __m128i* pPixels, const ezUInt8* pPixelData, ezColorBaseUB& out_color0, ezColorBaseUB& out_color1)
+  {
+    __m128i minColor = _mm_min_epu8(_mm_min_epu8(pPixels[0], pPixels[1]), _mm_min_epu8(pPixels[2], pPixels[3]));
+    __m128i maxColor = _mm_max_epu8(_mm_max_epu8(pPixels[0], pPixels[1]), _mm_max_epu8(pPixels[2], pPixels[3]));
+    minColor = _mm_min_epu8(minColor, _mm_shuffle_epi32(minColor, _MM_SHUFFLE(1, 0, 3, 2)));
+    minColor = _mm_min_epu8(minColor, _mm_shuffle_epi32(minColor, _MM_SHUFFLE(2, 3, 0, 1)));
+    maxColor = _mm_max_epu8(maxColor, _mm_shuffle_epi32(maxColor, _MM_SHUFFLE(1, 0, 3, 2)));
+    maxColor = _mm_max_epu8(maxColor, _mm_shuffle_epi32(maxColor, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    ezUInt8 minC[4];
+    ezUInt8 maxC[4];
+    const ezUInt32 uiMin = _mm_cvtsi128_si32(minColor);
+    const ezUInt32 uiMax = _mm_cvtsi128_si32(maxColor);
+    memcpy(minC, &uiMin, 4);
+    memcpy(maxC, &uiMax, 4);
+
+    // The channel with the largest range decides in which direction the other channels run
+    ezUInt32 uiMainChannel = 0;
+    for (ezUInt32 c = 1; c < 3; ++c)
+    {
+      if (maxC[c] - minC[c] > maxC[uiMainChannel] - minC[uiMainChannel])
+      {
+        uiMainChannel = c;
+      }
+    }
+
+    ezInt32 covariance[3] = {};
+    for (ezUInt32 idx = 0; idx < 16; ++idx)
+    {
+      const ezUInt8* pPixel = pPixelData + 4 * idx;
+      const ezInt32 iMain = 2 * pPixel[uiMainChannel] - (minC[uiMainChannel] + maxC[uiMainChannel]);
+
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        covariance[c] += iMain * (2 * pPixel[c] - (minC[c] + maxC[c]));
+      }
+    }
+
+    ezUInt8 color0[3];
+    ezUInt8 color1[3];
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      const ezInt32 iInset = (maxC[c] - minC[c]) >> 4;
+
+      if (covariance[c] >= 0)
+      {
+        color0[c] = ezUInt8(maxC[c] - iInset);
+        color1[c] = ezUInt8(minC[c] + iInset);
+      }
+      else
+      {
+        color0[c] = ezUInt8(minC[c] + iInset);
+        color1[c] = ezUInt8(maxC[c] - iInset);
+      }
+    }
+
+    out_color0 = ezColorBaseUB(color0[0], color0[1], color0[2], 0xFF);
+    out_color1 = ezColorBaseUB(color1[0], color1[1], color1[2], 0xFF);
+  }
+
+  /// \brief Computes the endpoints with the smallest squared error for the given indices with a least squares fit.
+  ///
+  /// Returns false if the indices don't determine both endpoints, e.g. when all pixels use the same palette entry.
+  bool refineEndpointsBC1(const ezUInt8* pPixelData, ezUInt32 uiIndices, ezColorBaseUB& out_color0, ezColorBaseUB& out_color1)
+  {
+    // Weight of color0 in thirds for each palette entry
+    static constexpr ezInt32 s_weights[4] = {3, 0, 2, 1};
+
+    ezInt32 iAlpha2 = 0;
+    ezInt32 iBeta2 = 0;
+    ezInt32 iAlphaBeta = 0;
+    ezInt32 alphaX[3] = {};
+    ezInt32 betaX[3] = {};
+
+    for (ezUInt32 idx = 0; idx < 16; ++idx)
+    {
+      const ezInt32 iAlpha = s_weights[(uiIndices >> (2 * idx)) & 0x03];
+      const ezInt32 iBeta = 3 - iAlpha;
+
+      iAlpha2 += iAlpha * iAlpha;
+      iBeta2 += iBeta * iBeta;
+      iAlphaBeta += iAlpha * iBeta;
+
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        alphaX[c] += iAlpha * pPixelData[4 * idx + c];
+        betaX[c] += iBeta * pPixelData[4 * idx + c];
+      }
+    }
+
+    const ezInt32 iDeterminant = iAlpha2 * iBeta2 - iAlphaBeta * iAlphaBeta;
+    if (iDeterminant == 0)
+      return false;
+
+    // The weights are in thirds, which cancels out with the factor of 3 of the palette colors
+    const float fScale = 3.0f / iDeterminant;
+
+    ezUInt8 color0[3];
+    ezUInt8 color1[3];
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      const float f0 = (alphaX[c] * iBeta2 - betaX[c] * iAlphaBeta) * fScale;
+      const float f1 = (betaX[c] * iAlpha2 - alphaX[c] * iAlphaBeta) * fScale;
+      color0[c] = ezUInt8(ezMath::Clamp(f0 + 0.5f, 0.0f, 255.0f));
+      color1[c] = ezUInt8(ezMath::Clamp(f1 + 0.5f, 0.0f, 255.0f));
+    }
+
+    out_color0 = ezColorBaseUB(color0[0], color0[1], color0[2], 0xFF);
+    out_color1 = ezColorBaseUB(color1[0], color1[1], color1[2], 0xFF);
+    return true;
+  }
+
+  /// \brief Compresses the colors of a block in the 4-color mode that BC2 and BC3 always use. Each row of the block is one __m128i.
+  void packColorBlockBC3(const __m128i* pPixels, ezUInt8* pTargetData)
+  {
+    ezUInt8 pixelData[64];
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(pixelData + 16 * row), pPixels[row]);
+    }
+
+    ezColorBaseUB color0, color1;
+    findEndpointsBC1(pPixels, pixelData, color0, color1);
+
+    ezUInt16 uiColor0 = ezCompressB5G6R5(color0);
+    ezUInt16 uiColor1 = ezCompressB5G6R5(color1);
+    ezUInt32 uiIndices = 0;
+    const ezUInt32 uiError = findBestIndicesBC1(pPixels, uiColor0, uiColor1, uiIndices);
+
+    // One least squares step on the chosen indices, only kept if it actually lowers the error after quantization
+    if (uiError > 0 && refineEndpointsBC1(pixelData, uiIndices, color0, color1))
+    {
+      const ezUInt16 uiRefinedColor0 = ezCompressB5G6R5(color0);
+      const ezUInt16 uiRefinedColor1 = ezCompressB5G6R5(color1);
+      ezUInt32 uiRefinedIndices = 0;
+
+      if (findBestIndicesBC1(pPixels, uiRefinedColor0, uiRefinedColor1, uiRefinedIndices) < uiError)
+      {
+        uiColor0 = uiRefinedColor0;
+        uiColor1 = uiRefinedColor1;
+        uiIndices = uiRefinedIndices;
+      }
+    }
+
+    // Decoders that don't force the 4-color mode expect color0 > color1, swapping the endpoints swaps index 0 with 1 and 2 with 3
+    if (uiColor0 < uiColor1)
+    {
+      ezMath::Swap(uiColor0, uiColor1);
+      uiIndices ^= 0x55555555u;
+    }
+
+    memcpy(pTargetData + 0, &uiColor0, 2);
+    memcpy(pTargetData + 2, &uiColor1, 2);
+    memcpy(pTargetData + 4, &uiIndices, 4);
+  }
 #endif
 
 
@@ -2923,6 +3151,62 @@ public:
 };
 
 #if defined(EZ_SUPPORTS_BC4_COMPRESSOR)
+class ezImageConversion_CompressBC3 : public ezImageConversionStepCompressBlocks
+{
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    static ezImageConversionEntry supportedConversions[] = {
+      ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC3_UNORM, ezImageConversionFlags::Default),
+      ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC3_UNORM_SRGB, ezImageConversionFlags::Default),
+    };
+    return supportedConversions;
+  }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  {
+    ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+
+    const ezUInt8* pSource = source.GetPtr();
+    ezUInt8* pTarget = target.GetPtr();
+
+    ezTaskSystem::ParallelForIndexed(0, numBlocksY, [pSource, pTarget, rowPitch, numBlocksX](ezUInt32 startIndex, ezUInt32 endIndex)
+      {
+        // Gathers the alpha bytes of 4 RGBA pixels
+        const __m128i alphaShuffle = _mm_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+        for (ezUInt32 blockY = startIndex; blockY < endIndex; ++blockY)
+        {
+          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
+          {
+            __m128i sourceBlock[4];
+            ezUInt8 sourceBlockA[16];
+
+            for (ezUInt32 y = 0; y < 4; ++y)
+            {
+              const ezUInt8* sourcePointer = pSource + (4 * blockY + y) * rowPitch + 16 * blockX;
+              sourceBlock[y] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer));
+
+              const ezUInt32 uiAlpha = _mm_cvtsi128_si32(_mm_shuffle_epi8(sourceBlock[y], alphaShuffle));
+              memcpy(sourceBlockA + 4 * y, &uiAlpha, 4);
+            }
+
+            ezUInt8* targetPointer = pTarget + (blockY * numBlocksX + blockX) * 16;
+
+            ezUInt32 a0, a1;
+            findBestPaletteBC4(sourceBlockA, a0, a1);
+            packBlockBC4(sourceBlockA, a0, a1, targetPointer);
+
+            packColorBlockBC3(sourceBlock, targetPointer + 8);
+          }
+        }
+      },
+      "CompressBC3");
+
+    return EZ_SUCCESS;
+  }
+};
+
 class ezImageConversion_CompressBC4 : public ezImageConversionStepCompressBlocks
 {
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
@@ -2951,32 +3235,39 @@ class ezImageConversion_CompressBC4 : public ezImageConversionStepCompressBlocks
       bias = 128;
     }
 
-    for (ezUInt32 blockY = 0; blockY < numBlocksY; ++blockY)
-    {
-      for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
-      {
-        ezUInt8 sourceBlock[16];
+    const ezUInt8* pSource = source.GetPtr();
+    ezUInt8* pTarget = target.GetPtr();
 
-        for (ezUInt32 y = 0; y < 4; ++y)
+    ezTaskSystem::ParallelForIndexed(0, numBlocksY, [pSource, pTarget, rowPitch, numBlocksX, stride, bias](ezUInt32 startIndex, ezUInt32 endIndex)
+      {
+        for (ezUInt32 blockY = startIndex; blockY < endIndex; ++blockY)
         {
-          const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch;
-
-          for (ezUInt32 x = 0; x < 4; ++x)
+          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
           {
-            sourceBlock[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride] + bias;
-          }
-        }
+            ezUInt8 sourceBlock[16];
+
+            for (ezUInt32 y = 0; y < 4; ++y)
+            {
+              const ezUInt8* sourcePointer = pSource + (4 * blockY + y) * rowPitch;
 
-        ezUInt32 a0, a1;
-        findBestPaletteBC4(sourceBlock, a0, a1);
+              for (ezUInt32 x = 0; x < 4; ++x)
+              {
+                sourceBlock[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride] + bias;
+              }
+            }
 
-        ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * 8;
-        packBlockBC4(sourceBlock, a0, a1, targetPointer);
+            ezUInt32 a0, a1;
+            findBestPaletteBC4(sourceBlock, a0, a1);
 
-        targetPointer[0] -= bias;
-        targetPointer[1] -= bias;
-      }
-    }
+            ezUInt8* targetPointer = pTarget + (blockY * numBlocksX + blockX) * 8;
+            packBlockBC4(sourceBlock, a0, a1, targetPointer);
+
+            targetPointer[0] -= bias;
+            targetPointer[1] -= bias;
+          }
+        }
+      },
+      "CompressBC4");
 
     return EZ_SUCCESS;
   }
@@ -3008,52 +3299,60 @@ class ezImageConversion_CompressBC5 : public ezImageConversionStepCompressBlocks
       bias = 128;
     }
 
-    for (ezUInt32 blockY = 0; blockY < numBlocksY; ++blockY)
-    {
-      for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
-      {
-        ezUInt8 sourceBlockR[16];
-        ezUInt8 sourceBlockG[16];
+    const ezUInt8* pSource = source.GetPtr();
+    ezUInt8* pTarget = target.GetPtr();
 
-        for (ezUInt32 y = 0; y < 4; ++y)
+    ezTaskSystem::ParallelForIndexed(0, numBlocksY, [pSource, pTarget, rowPitch, numBlocksX, stride, bias](ezUInt32 startIndex, ezUInt32 endIndex)
+      {
+        for (ezUInt32 blockY = startIndex; blockY < endIndex; ++blockY)
         {
-          const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch;
-
-          for (ezUInt32 x = 0; x < 4; ++x)
+          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
           {
-            sourceBlockR[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 0] + bias;
-            sourceBlockG[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 1] + bias;
-          }
-        }
+            ezUInt8 sourceBlockR[16];
+            ezUInt8 sourceBlockG[16];
 
-        ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * 16;
+            for (ezUInt32 y = 0; y < 4; ++y)
+            {
+              const ezUInt8* sourcePointer = pSource + (4 * blockY + y) * rowPitch;
 
-        {
-          ezUInt32 a0, a1;
-          findBestPaletteBC4(sourceBlockR, a0, a1);
-          packBlockBC4(sourceBlockR, a0, a1, targetPointer);
+              for (ezUInt32 x = 0; x < 4; ++x)
+              {
+                sourceBlockR[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 0] + bias;
+                sourceBlockG[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 1] + bias;
+              }
+            }
 
-          // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
-          targetPointer[0] -= bias;
-          targetPointer[1] -= bias;
-        }
+            ezUInt8* targetPointer = pTarget + (blockY * numBlocksX + blockX) * 16;
 
-        {
-          ezUInt32 a0, a1;
-          findBestPaletteBC4(sourceBlockG, a0, a1);
-          packBlockBC4(sourceBlockG, a0, a1, targetPointer + 8);
+            {
+              ezUInt32 a0, a1;
+              findBestPaletteBC4(sourceBlockR, a0, a1);
+              packBlockBC4(sourceBlockR, a0, a1, targetPointer);
+
+              // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
+              targetPointer[0] -= bias;
+              targetPointer[1] -= bias;
+            }
+
+            {
+              ezUInt32 a0, a1;
+              findBestPaletteBC4(sourceBlockG, a0, a1);
+              packBlockBC4(sourceBlockG, a0, a1, targetPointer + 8);
 
-          // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
-          targetPointer[8] -= bias;
-          targetPointer[9] -= bias;
+              // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
+              targetPointer[8] -= bias;
+              targetPointer[9] -= bias;
+            }
+          }
         }
-      }
-    }
+      },
+      "CompressBC5");
 
     return EZ_SUCCESS;
   }
 };
 
+static ezImageConversion_CompressBC3 s_conversion_compressBC3;
 static ezImageConversion_CompressBC4 s_conversion_compressBC4;
 static ezImageConversion_CompressBC5 s_conversion_compressBC5;
 
@@ -5,8 +5,10 @@
 #  include <Texture/DirectXTex/BC.h>
 #  include <Texture/Image/ImageConversion.h>
 
+#  include <Foundation/Configuration/CVar.h>
 #  include <Foundation/Threading/TaskSystem.h>
 
+ezCVarInt cvar_TextureCompressionQuality("Texture.CompressionQuality", 1, ezCVarFlags::Default, "Speed vs. quality of the CPU based BC7 compression: 0 = fast, 1 = normal, 2 = high");
 
 ezImageConversionEntry g_DXTexCpuConversions[] = {
   ezImageConversionEntry(ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::BC6H_UF16, ezImageConversionFlags::Default),
@@ -18,115 +20,113 @@ ezImageConversionEntry g_DXTexCpuConversions[] = {
   ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC7_UNORM_SRGB, ezImageConversionFlags::Default),
 };
 
-class ezImageConversion_CompressDxTexCpu : public ezImageConversionStepCompressBlocks
+namespace
 {
-public:
-  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
-  {
-    return g_DXTexCpuConversions;
-  }
+  using EncodeBlockFunc = void (*)(uint8_t* pBC, const DirectX::XMVECTOR* pColor, uint32_t flags);
 
-  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  struct CompressBlockRowsContext
   {
-    if (targetFormat == ezImageFormat::BC7_UNORM || targetFormat == ezImageFormat::BC7_UNORM_SRGB)
-    {
-      const ezUInt32 srcStride = numBlocksX * 4 * 4;
-      const ezUInt32 targetStride = numBlocksX * 16;
+    const ezUInt8* m_pSource;
+    ezUInt8* m_pTarget;
+    ezUInt32 m_uiNumBlocksX;
+    ezUInt32 m_uiBytesPerBlock;
+    EncodeBlockFunc m_Encode;
+    uint32_t m_uiFlags;
+  };
+
+  /// \brief Compresses all blocks with the given DirectXTex encoder. The block rows are distributed across the worker threads.
+  template <typename SourceType>
+  void CompressBlockRows(const CompressBlockRowsContext& ctx, ezUInt32 numBlocksY)
+  {
+    ezTaskSystem::ParallelForIndexed(0, numBlocksY, [&ctx](ezUInt32 startIndex, ezUInt32 endIndex)
+      {
+        const ezUInt32 srcStride = ctx.m_uiNumBlocksX * 4 * 4 * sizeof(SourceType);
+        const ezUInt32 targetStride = ctx.m_uiNumBlocksX * ctx.m_uiBytesPerBlock;
 
-      ezTaskSystem::ParallelForIndexed(0, numBlocksY, [srcStride, targetStride, source, target, numBlocksX](ezUInt32 startIndex, ezUInt32 endIndex)
-        {
-        const ezUInt8* srcIt = source.GetPtr() + srcStride * startIndex * 4;
-        ezUInt8* targetIt = target.GetPtr() + targetStride * startIndex;
+        const ezUInt8* srcIt = ctx.m_pSource + srcStride * startIndex * 4;
+        ezUInt8* targetIt = ctx.m_pTarget + targetStride * startIndex;
         for (ezUInt32 blockY = startIndex; blockY < endIndex; ++blockY)
         {
-          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
+          for (ezUInt32 blockX = 0; blockX < ctx.m_uiNumBlocksX; ++blockX)
           {
             DirectX::XMVECTOR temp[16];
             for (ezUInt32 y = 0; y < 4; y++)
             {
               for (ezUInt32 x = 0; x < 4; x++)
               {
-                const ezUInt8* pixel = srcIt + y * srcStride + x * 4;
-                temp[y * 4 + x] = DirectX::XMVectorSet(pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f, pixel[3] / 255.0f);
+                const SourceType* pixel = reinterpret_cast<const SourceType*>(srcIt + y * srcStride + x * 4 * sizeof(SourceType));
+
+                if constexpr (std::is_same_v<SourceType, float>)
+                {
+                  temp[y * 4 + x] = DirectX::XMVectorSet(pixel[0], pixel[1], pixel[2], pixel[3]);
+                }
+                else
+                {
+                  temp[y * 4 + x] = DirectX::XMVectorSet(pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f, pixel[3] / 255.0f);
+                }
               }
             }
-            DirectX::D3DXEncodeBC7(targetIt, temp, 0);
+            ctx.m_Encode(targetIt, temp, ctx.m_uiFlags);
 
-            srcIt += 4 * 4;
-            targetIt += 16;
+            srcIt += 4 * 4 * sizeof(SourceType);
+            targetIt += ctx.m_uiBytesPerBlock;
           }
           srcIt += 3 * srcStride;
-        } });
+        }
+      },
+      "CompressBlockRows");
+  }
+} // namespace
 
-      return EZ_SUCCESS;
-    }
-    else if (targetFormat == ezImageFormat::BC1_UNORM || targetFormat == ezImageFormat::BC1_UNORM_SRGB)
-    {
-      const ezUInt32 srcStride = numBlocksX * 4 * 4;
-      const ezUInt32 targetStride = numBlocksX * 8;
+class ezImageConversion_CompressDxTexCpu : public ezImageConversionStepCompressBlocks
+{
+public:
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    return g_DXTexCpuConversions;
+  }
 
-      ezTaskSystem::ParallelForIndexed(0, numBlocksY, [srcStride, targetStride, source, target, numBlocksX](ezUInt32 startIndex, ezUInt32 endIndex)
-        {
-        const ezUInt8* srcIt = source.GetPtr() + srcStride * startIndex * 4;
-        ezUInt8* targetIt = target.GetPtr() + targetStride * startIndex;
-        for (ezUInt32 blockY = startIndex; blockY < endIndex; ++blockY)
-        {
-          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
-          {
-            DirectX::XMVECTOR temp[16];
-            for (ezUInt32 y = 0; y < 4; y++)
-            {
-              for (ezUInt32 x = 0; x < 4; x++)
-              {
-                const ezUInt8* pixel = srcIt + y * srcStride + x * 4;
-                temp[y * 4 + x] = DirectX::XMVectorSet(pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f, pixel[3] / 255.0f);
-              }
-            }
-            DirectX::D3DXEncodeBC1(targetIt, temp, 1.0f, 0);
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  {
+    const ezInt32 iQuality = cvar_TextureCompressionQuality;
 
-            srcIt += 4 * 4;
-            targetIt += 8;
-          }
-          srcIt += 3 * srcStride;
-        } });
+    CompressBlockRowsContext ctx;
+    ctx.m_pSource = source.GetPtr();
+    ctx.m_pTarget = target.GetPtr();
+    ctx.m_uiNumBlocksX = numBlocksX;
+    ctx.m_uiBytesPerBlock = ezImageFormat::GetBitsPerBlock(targetFormat) / 8;
+    ctx.m_uiFlags = DirectX::BC_FLAGS_NONE;
 
-      return EZ_SUCCESS;
-    }
-    else if (targetFormat == ezImageFormat::BC6H_UF16)
+    switch (targetFormat)
     {
-      const ezUInt32 srcStride = numBlocksX * 4 * 4 * sizeof(float);
-      const ezUInt32 targetStride = numBlocksX * 16;
-
-      ezTaskSystem::ParallelForIndexed(0, numBlocksY, [srcStride, targetStride, source, target, numBlocksX](ezUInt32 startIndex, ezUInt32 endIndex)
-        {
-        const ezUInt8* srcIt = source.GetPtr() + srcStride * startIndex * 4;
-        ezUInt8* targetIt = target.GetPtr() + targetStride * startIndex;
-        for (ezUInt32 blockY = startIndex; blockY < endIndex; ++blockY)
-        {
-          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
-          {
-            DirectX::XMVECTOR temp[16];
-            for (ezUInt32 y = 0; y < 4; y++)
-            {
-              for (ezUInt32 x = 0; x < 4; x++)
-              {
-                const float* pixel = reinterpret_cast<const float*>(srcIt + y * srcStride + x * 4 * sizeof(float));
-                temp[y * 4 + x] = DirectX::XMVectorSet(pixel[0], pixel[1], pixel[2], pixel[3]);
-              }
-            }
-            DirectX::D3DXEncodeBC6HU(targetIt, temp, 0);
-
-            srcIt += 4 * 4 * sizeof(float);
-            targetIt += 16;
-          }
-          srcIt += 3 * srcStride;
-        } });
-
-      return EZ_SUCCESS;
+      case ezImageFormat::BC1_UNORM:
+      case ezImageFormat::BC1_UNORM_SRGB:
+        ctx.m_Encode = [](uint8_t* pBC, const DirectX::XMVECTOR* pColor, uint32_t flags)
+        { DirectX::D3DXEncodeBC1(pBC, pColor, 1.0f, flags); };
+        CompressBlockRows<ezUInt8>(ctx, numBlocksY);
+        return EZ_SUCCESS;
+
+      case ezImageFormat::BC7_UNORM:
+      case ezImageFormat::BC7_UNORM_SRGB:
+        // mode 6 alone is very fast and good enough for most content, the 3 subset modes are rarely chosen but expensive to evaluate
+        if (iQuality <= 0)
+          ctx.m_uiFlags = DirectX::BC_FLAGS_FORCE_BC7_MODE6;
+        else if (iQuality >= 2)
+          ctx.m_uiFlags = DirectX::BC_FLAGS_USE_3SUBSETS;
+
+        ctx.m_Encode = &DirectX::D3DXEncodeBC7;
+        CompressBlockRows<ezUInt8>(ctx, numBlocksY);
+        return EZ_SUCCESS;
+
+      case ezImageFormat::BC6H_UF16:
+        ctx.m_Encode = &DirectX::D3DXEncodeBC6HU;
+        CompressBlockRows<float>(ctx, numBlocksY);
+        return EZ_SUCCESS;
+
+      default:
+        return EZ_FAILURE;
     }
-
-    return EZ_FAILURE;
   }
 };
 
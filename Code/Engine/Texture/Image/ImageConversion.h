@@ -158,8 +158,9 @@ private:
   static ezResult ConvertSingleStepDecompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
     ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep);
 
+  /// \brief Compresses the source image. If linearSteps is not empty, the source is converted to sourceFormat with those steps band by band, right before it is compressed.
   static ezResult ConvertSingleStepCompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
-    ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep);
+    ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep, ezArrayPtr<const ConversionPathNode> linearSteps);
 
   static ezResult ConvertSingleStepDeplanarize(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
     ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep);
@@ -3,6 +3,7 @@
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Math/Math.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageConversion.h>
 
 EZ_ENUMERABLE_CLASS_IMPLEMENTATION(ezImageConversionStep);
@@ -147,6 +148,101 @@ namespace
       return ref_scratchBuffers.GetCount() - 1;
     }
   }
+
+  /// The number of pixels that are passed through all steps of a conversion at once. Small enough that the intermediate results stay in the cache.
+  constexpr ezUInt32 s_uiConversionTileSize = 4096;
+
+  /// The size of the temporary buffer in which rows of an image are padded to the block size before they are compressed.
+  constexpr ezUInt64 s_uiCompressionBandSize = 4 * 1024 * 1024;
+
+  bool IsLinearStep(const ezImageConversion::ConversionPathNode& node)
+  {
+    return ezImageFormat::GetType(node.m_sourceFormat) == ezImageFormatType::LINEAR && ezImageFormat::GetType(node.m_targetFormat) == ezImageFormatType::LINEAR;
+  }
+
+  /// \brief Runs a chain of conversion steps between uncompressed formats on small tiles of pixels, in parallel.
+  ///
+  /// Each tile passes through all steps before the next one is started, so the intermediate formats only need two tile-sized buffers
+  /// per task instead of one full-size buffer per step. Source and target must not overlap.
+  ezResult ConvertLinearStepsTiled(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt64 uiNumElements, ezArrayPtr<const ezImageConversion::ConversionPathNode> steps)
+  {
+    struct TileContext
+    {
+      ezConstByteBlobPtr m_Source;
+      ezByteBlobPtr m_Target;
+      ezUInt64 m_uiNumElements;
+      ezArrayPtr<const ezImageConversion::ConversionPathNode> m_Steps;
+      ezUInt32 m_uiMaxIntermediateBitsPerPixel = 0;
+      ezAtomicBool m_bFailed;
+    };
+
+    TileContext ctx;
+    ctx.m_Source = source;
+    ctx.m_Target = target;
+    ctx.m_uiNumElements = uiNumElements;
+    ctx.m_Steps = steps;
+
+    for (ezUInt32 i = 0; i + 1 < steps.GetCount(); ++i)
+    {
+      ctx.m_uiMaxIntermediateBitsPerPixel = ezMath::Max(ctx.m_uiMaxIntermediateBitsPerPixel, ezImageFormat::GetBitsPerPixel(steps[i].m_targetFormat));
+    }
+
+    const ezUInt64 uiNumTiles = (uiNumElements + s_uiConversionTileSize - 1) / s_uiConversionTileSize;
+
+    ezTaskSystem::ParallelForIndexed(ezUInt64(0), uiNumTiles, [&ctx](ezUInt64 uiStartTile, ezUInt64 uiEndTile)
+      {
+        ezDynamicArray<ezUInt8> scratch[2];
+        for (auto& buffer : scratch)
+        {
+          buffer.SetCountUninitialized(s_uiConversionTileSize * ctx.m_uiMaxIntermediateBitsPerPixel / 8);
+        }
+
+        for (ezUInt64 uiTile = uiStartTile; uiTile < uiEndTile && !ctx.m_bFailed; ++uiTile)
+        {
+          const ezUInt64 uiFirstElement = uiTile * s_uiConversionTileSize;
+          const ezUInt64 uiNumTileElements = ezMath::Min<ezUInt64>(s_uiConversionTileSize, ctx.m_uiNumElements - uiFirstElement);
+
+          ezUInt32 uiSourceBpp = ezImageFormat::GetBitsPerPixel(ctx.m_Steps[0].m_sourceFormat);
+          const ezUInt8* pSource = ctx.m_Source.GetPtr() + uiFirstElement * uiSourceBpp / 8;
+          ezUInt32 uiNextScratch = 0;
+
+          for (ezUInt32 i = 0; i < ctx.m_Steps.GetCount(); ++i)
+          {
+            const auto& step = ctx.m_Steps[i];
+            const bool bLastStep = i + 1 == ctx.m_Steps.GetCount();
+            const ezUInt32 uiTargetBpp = ezImageFormat::GetBitsPerPixel(step.m_targetFormat);
+
+            ezUInt8* pTarget = bLastStep ? ctx.m_Target.GetPtr() + uiFirstElement * uiTargetBpp / 8 : scratch[uiNextScratch].GetData();
+
+            if (step.m_step == nullptr)
+            {
+              // copy steps only matter for the final result
+              if (bLastStep)
+              {
+                memcpy(pTarget, pSource, static_cast<size_t>(uiNumTileElements * uiTargetBpp / 8));
+              }
+              continue;
+            }
+
+            if (static_cast<const ezImageConversionStepLinear*>(step.m_step)
+                  ->ConvertPixels(ezConstByteBlobPtr(pSource, uiNumTileElements * uiSourceBpp / 8), ezByteBlobPtr(pTarget, uiNumTileElements * uiTargetBpp / 8),
+                    uiNumTileElements, step.m_sourceFormat, step.m_targetFormat)
+                  .Failed())
+            {
+              ctx.m_bFailed = true;
+              return;
+            }
+
+            pSource = pTarget;
+            uiSourceBpp = uiTargetBpp;
+            uiNextScratch ^= 1;
+          }
+        }
+      },
+      "ezImageConversion::ConvertLinearSteps");
+
+    return ctx.m_bFailed ? EZ_FAILURE : EZ_SUCCESS;
+  }
 } // namespace
 
 ezImageConversionStep::ezImageConversionStep()
@@ -413,18 +509,66 @@ ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& ref_targ
 
   const ezImageView* pSource = &source;
 
-  for (ezUInt32 i = 0; i < path.GetCount(); ++i)
+  for (ezUInt32 i = 0; i < path.GetCount();)
   {
-    ezUInt32 targetIndex = path[i].m_targetBufferIndex;
+    // Consecutive steps between uncompressed formats, and a compression step right after them, are executed together on small tiles,
+    // so the intermediate formats never need a full-size image.
+    ezUInt32 uiNumLinearSteps = 0;
+    while (i + uiNumLinearSteps < path.GetCount() && IsLinearStep(path[i + uiNumLinearSteps]))
+    {
+      ++uiNumLinearSteps;
+    }
+
+    const bool bCompressAfterLinearSteps = uiNumLinearSteps > 0 && i + uiNumLinearSteps < path.GetCount() &&
+                                           ezImageFormat::GetType(path[i + uiNumLinearSteps].m_sourceFormat) == ezImageFormatType::LINEAR &&
+                                           ezImageFormat::GetType(path[i + uiNumLinearSteps].m_targetFormat) == ezImageFormatType::BLOCK_COMPRESSED;
+
+    const ezUInt32 uiLastStep = bCompressAfterLinearSteps ? i + uiNumLinearSteps : i + ezMath::Max(uiNumLinearSteps, 1u) - 1;
 
+    ezUInt32 targetIndex = path[uiLastStep].m_targetBufferIndex;
     ezImage* pTarget = targetIndex == 0 ? &ref_target : &intermediates[targetIndex - 1];
 
-    if (ConvertSingleStep(path[i].m_step, *pSource, *pTarget, path[i].m_targetFormat).Failed())
+    // in-place conversions are done step by step on the whole image
+    if (uiNumLinearSteps == 0 || pTarget == pSource)
     {
-      return EZ_FAILURE;
+      targetIndex = path[i].m_targetBufferIndex;
+      pTarget = targetIndex == 0 ? &ref_target : &intermediates[targetIndex - 1];
+
+      if (ConvertSingleStep(path[i].m_step, *pSource, *pTarget, path[i].m_targetFormat).Failed())
+      {
+        return EZ_FAILURE;
+      }
+
+      pSource = pTarget;
+      ++i;
+      continue;
+    }
+
+    ezImageHeader header = pSource->GetHeader();
+    header.SetImageFormat(path[uiLastStep].m_targetFormat);
+    pTarget->ResetAndAlloc(header);
+
+    const ezArrayPtr<const ConversionPathNode> linearSteps = path.GetSubArray(i, uiNumLinearSteps);
+
+    if (bCompressAfterLinearSteps)
+    {
+      if (ConvertSingleStepCompress(*pSource, *pTarget, path[uiLastStep].m_sourceFormat, path[uiLastStep].m_targetFormat, path[uiLastStep].m_step, linearSteps).Failed())
+      {
+        return EZ_FAILURE;
+      }
+    }
+    else
+    {
+      const ezUInt64 numElements = ezUInt64(8) * pTarget->GetByteBlobPtr().GetCount() / (ezUInt64)ezImageFormat::GetBitsPerPixel(header.GetImageFormat());
+
+      if (ConvertLinearStepsTiled(pSource->GetByteBlobPtr(), pTarget->GetByteBlobPtr(), numElements, linearSteps).Failed())
+      {
+        return EZ_FAILURE;
+      }
     }
 
     pSource = pTarget;
+    i = uiLastStep + 1;
   }
 
   return EZ_SUCCESS;
@@ -476,6 +620,12 @@ ezResult ezImageConversion::ConvertRaw(
     return EZ_FAILURE;
   }
 
+  if (source.GetPtr() != target.GetPtr())
+  {
+    return ConvertLinearStepsTiled(source, target, uiNumElements, path);
+  }
+
+  // in-place conversions are done step by step on the whole buffer
   ezHybridArray<ezBlob, 16> intermediates;
   intermediates.SetCount(uiNumScratchBuffers);
 
@@ -542,7 +692,7 @@ ezResult ezImageConversion::ConvertSingleStep(
     }
 
     case MakeTypeKey(ezImageFormatType::LINEAR, ezImageFormatType::BLOCK_COMPRESSED):
-      return ConvertSingleStepCompress(source, target, sourceFormat, targetFormat, pStep);
+      return ConvertSingleStepCompress(source, target, sourceFormat, targetFormat, pStep, {});
 
     case MakeTypeKey(ezImageFormatType::LINEAR, ezImageFormatType::PLANAR):
       return ConvertSingleStepPlanarize(source, target, sourceFormat, targetFormat, pStep);
@@ -622,9 +772,16 @@ ezResult ezImageConversion::ConvertSingleStepDecompress(
   return EZ_SUCCESS;
 }
 
-ezResult ezImageConversion::ConvertSingleStepCompress(
-  const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep)
+ezResult ezImageConversion::ConvertSingleStepCompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat,
+  const ezImageConversionStep* pStep, ezArrayPtr<const ConversionPathNode> linearSteps)
 {
+  // sourceFormat is the format that the compressor expects, the source image may still have to be converted to it by linearSteps
+  const ezUInt32 blockWidth = ezImageFormat::GetBlockWidth(targetFormat);
+  const ezUInt32 blockHeight = ezImageFormat::GetBlockHeight(targetFormat);
+  const ezUInt32 sourceBytesPerPixel = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
+
+  ezDynamicArray<ezUInt8> band;
+
   for (ezUInt32 arrayIndex = 0; arrayIndex < source.GetNumArrayIndices(); arrayIndex++)
   {
     for (ezUInt32 face = 0; face < source.GetNumFaces(); face++)
@@ -637,43 +794,88 @@ ezResult ezImageConversion::ConvertSingleStepCompress(
         const ezUInt32 numBlocksX = target.GetNumBlocksX(mipLevel);
         const ezUInt32 numBlocksY = target.GetNumBlocksY(mipLevel);
 
-        const ezUInt32 targetWidth = numBlocksX * ezImageFormat::GetBlockWidth(targetFormat);
-        const ezUInt32 targetHeight = numBlocksY * ezImageFormat::GetBlockHeight(targetFormat);
+        const ezUInt32 targetWidth = numBlocksX * blockWidth;
+        const ezUInt32 targetHeight = numBlocksY * blockHeight;
+
+        const ezUInt64 sourceRowPitch = ezUInt64(sourceWidth) * sourceBytesPerPixel;
+        const ezUInt64 paddedRowPitch = ezUInt64(targetWidth) * sourceBytesPerPixel;
+        const ezUInt64 targetBlockRowPitch = target.GetRowPitch(mipLevel);
 
-        const ezUInt64 sourceRowPitch = source.GetRowPitch(mipLevel);
-        const ezUInt32 sourceBytesPerPixel = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
+        // The source can be handed to the compressor as is, if it neither needs padding to a multiple of the block size nor conversion.
+        // Otherwise it is padded and converted in bands of block rows, so that the temporary buffer stays small.
+        const bool bCompressDirectly = linearSteps.IsEmpty() && sourceWidth == targetWidth && sourceHeight == targetHeight;
 
-        // Pad image to multiple of block size for compression
-        ezImageHeader paddedSliceHeader;
-        paddedSliceHeader.SetWidth(targetWidth);
-        paddedSliceHeader.SetHeight(targetHeight);
-        paddedSliceHeader.SetImageFormat(sourceFormat);
+        const ezUInt32 numBlockRowsPerBand =
+          bCompressDirectly ? numBlocksY : ezMath::Clamp<ezUInt32>(static_cast<ezUInt32>(s_uiCompressionBandSize / (paddedRowPitch * blockHeight)), 1u, numBlocksY);
 
-        ezImage paddedSlice;
-        paddedSlice.ResetAndAlloc(paddedSliceHeader);
+        if (!bCompressDirectly)
+        {
+          band.SetCountUninitialized(static_cast<ezUInt32>(numBlockRowsPerBand * blockHeight * paddedRowPitch));
+        }
 
         for (ezUInt32 slice = 0; slice < source.GetDepth(mipLevel); slice++)
         {
-          for (ezUInt32 y = 0; y < targetHeight; ++y)
+          ezByteBlobPtr targetSlice = target.GetSliceView(mipLevel, face, arrayIndex, slice).GetByteBlobPtr();
+
+          for (ezUInt32 firstBlockRow = 0; firstBlockRow < numBlocksY; firstBlockRow += numBlockRowsPerBand)
           {
-            ezUInt32 sourceY = ezMath::Min(y, sourceHeight - 1);
+            const ezUInt32 numBandBlockRows = ezMath::Min(numBlockRowsPerBand, numBlocksY - firstBlockRow);
+            const ezUInt32 firstRow = firstBlockRow * blockHeight;
+            const ezUInt32 numBandRows = numBandBlockRows * blockHeight;
 
-            memcpy(paddedSlice.GetPixelPointer<void>(0, 0, 0, 0, y), source.GetPixelPointer<void>(mipLevel, face, arrayIndex, 0, sourceY, slice),
-              static_cast<size_t>(sourceRowPitch));
+            ezConstByteBlobPtr bandSource;
 
-            for (ezUInt32 x = sourceWidth; x < targetWidth; ++x)
+            if (bCompressDirectly)
             {
-              memcpy(paddedSlice.GetPixelPointer<void>(0, 0, 0, x, y),
-                source.GetPixelPointer<void>(mipLevel, face, arrayIndex, sourceWidth - 1, sourceY, slice), sourceBytesPerPixel);
+              bandSource = source.GetSliceView(mipLevel, face, arrayIndex, slice).GetByteBlobPtr();
             }
-          }
+            else
+            {
+              const ezUInt32 numSourceRows = ezMath::Min(numBandRows, sourceHeight - firstRow);
+              const ezUInt8* pSourceRows = source.GetPixelPointer<ezUInt8>(mipLevel, face, arrayIndex, 0, firstRow, slice);
 
-          ezResult result = static_cast<const ezImageConversionStepCompressBlocks*>(pStep)->CompressBlocks(paddedSlice.GetByteBlobPtr(),
-            target.GetSliceView(mipLevel, face, arrayIndex, slice).GetByteBlobPtr(), numBlocksX, numBlocksY, sourceFormat, targetFormat);
+              if (linearSteps.IsEmpty())
+              {
+                memcpy(band.GetData(), pSourceRows, static_cast<size_t>(numSourceRows * sourceRowPitch));
+              }
+              else if (ConvertLinearStepsTiled(ezConstByteBlobPtr(pSourceRows, numSourceRows * source.GetRowPitch(mipLevel)),
+                         ezByteBlobPtr(band.GetData(), numSourceRows * sourceRowPitch), ezUInt64(numSourceRows) * sourceWidth, linearSteps)
+                         .Failed())
+              {
+                return EZ_FAILURE;
+              }
 
-          if (result.Failed())
-          {
-            return EZ_FAILURE;
+              // Pad to a multiple of the block size by repeating the last column and row. The rows are spread out from the last one
+              // backwards, so that no row is overwritten before it was moved.
+              if (sourceWidth != targetWidth)
+              {
+                for (ezUInt32 y = numSourceRows; y-- > 0;)
+                {
+                  ezUInt8* pRow = band.GetData() + y * paddedRowPitch;
+                  memmove(pRow, band.GetData() + y * sourceRowPitch, static_cast<size_t>(sourceRowPitch));
+
+                  for (ezUInt32 x = sourceWidth; x < targetWidth; ++x)
+                  {
+                    memcpy(pRow + x * sourceBytesPerPixel, pRow + (sourceWidth - 1) * sourceBytesPerPixel, sourceBytesPerPixel);
+                  }
+                }
+              }
+
+              for (ezUInt32 y = numSourceRows; y < numBandRows; ++y)
+              {
+                memcpy(band.GetData() + y * paddedRowPitch, band.GetData() + (y - 1) * paddedRowPitch, static_cast<size_t>(paddedRowPitch));
+              }
+
+              bandSource = ezConstByteBlobPtr(band.GetData(), numBandRows * paddedRowPitch);
+            }
+
+            ezResult result = static_cast<const ezImageConversionStepCompressBlocks*>(pStep)->CompressBlocks(bandSource,
+              targetSlice.GetSubArray(firstBlockRow * targetBlockRowPitch, numBandBlockRows * targetBlockRowPitch), numBlocksX, numBandBlockRows, sourceFormat, targetFormat);
+
+            if (result.Failed())
+            {
+              return EZ_FAILURE;
+            }
           }
         }
       }
@@ -5,6 +5,7 @@
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Timestamp.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
@@ -740,6 +741,43 @@ inline static void FilterLine(
   }
 }
 
+/// Filters along the Y or Z axis of an image. Instead of walking down a column of texels for every output texel, this accumulates
+/// whole rows of uiLineLength texels for one output index, so that the memory is read sequentially.
+/// The operations per texel are the same as in FilterLine(), so the results are identical.
+static void FilterLines(ezUInt32 uiNumSourceElements, const ezSimdVec4f* __restrict pSourceBegin, ezSimdVec4f* __restrict pTarget, ezUInt32 uiStride, ezUInt32 uiLineLength, const ezImageFilterWeights& weights, ezUInt32 uiTargetIndex, ezImageAddressMode::Enum addressMode, const ezSimdVec4f& vBorderColor)
+{
+  const ezInt32 firstSourceIdx = weights.GetFirstSourceSampleIndex(uiTargetIndex);
+
+  for (ezUInt32 x = 0; x < uiLineLength; ++x)
+  {
+    pTarget[x].SetZero();
+  }
+
+  for (ezUInt32 weightIdx = 0; weightIdx < weights.GetNumWeights(); ++weightIdx)
+  {
+    const ezSimdVec4f weight((float)weights.GetWeight(uiTargetIndex, weightIdx));
+
+    bool useBorderColor = false;
+    const ezInt32 sourceIdx = ezImageUtils::GetSampleIndex(uiNumSourceElements, firstSourceIdx + static_cast<ezInt32>(weightIdx), addressMode, useBorderColor);
+
+    if (useBorderColor)
+    {
+      for (ezUInt32 x = 0; x < uiLineLength; ++x)
+      {
+        pTarget[x] = ezSimdVec4f::MulAdd(vBorderColor, weight, pTarget[x]);
+      }
+    }
+    else
+    {
+      const ezSimdVec4f* __restrict sourcePtr = pSourceBegin + sourceIdx * uiStride;
+      for (ezUInt32 x = 0; x < uiLineLength; ++x)
+      {
+        pTarget[x] = ezSimdVec4f::MulAdd(sourcePtr[x], weight, pTarget[x]);
+      }
+    }
+  }
+}
+
 static void DownScaleFastLine(ezUInt32 uiPixelStride, const ezUInt8* pSrc, ezUInt8* pDest, ezUInt32 uiLengthIn, ezUInt32 uiStrideIn, ezUInt32 uiLengthOut, ezUInt32 uiStrideOut)
 {
   const ezUInt32 downScaleFactor = uiLengthIn / uiLengthOut;
@@ -1005,7 +1043,32 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
   };
 
   ezHybridArray<ezInt32, 256> firstSampleIndices;
-  firstSampleIndices.Reserve(ezMath::Max(uiWidth, uiHeight, uiDepth));
+
+  const ezSimdVec4f vBorderColor(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+
+  // Every pass is split into lines of texels along the X axis, which are filtered in parallel.
+  struct FilterPass
+  {
+    const ezImageView* m_pSource;
+    ezImage* m_pTarget;
+    const ezImageFilterWeights* m_pWeights;
+    ezUInt32 m_uiHeight;
+    ezUInt32 m_uiDepth;
+    ezUInt32 m_uiNumFaces;
+    ezUInt32 m_uiNumSourceElements;
+    ezImageAddressMode::Enum m_AddressMode;
+    ezSimdVec4f m_vBorderColor;
+
+    void GetLineCoordinates(ezUInt32 uiLine, ezUInt32& out_uiFace, ezUInt32& out_uiArrayIndex, ezUInt32& out_uiY, ezUInt32& out_uiZ) const
+    {
+      out_uiY = uiLine % m_uiHeight;
+      uiLine /= m_uiHeight;
+      out_uiZ = uiLine % m_uiDepth;
+      uiLine /= m_uiDepth;
+      out_uiFace = uiLine % m_uiNumFaces;
+      out_uiArrayIndex = uiLine / m_uiNumFaces;
+    }
+  };
 
   if (uiWidth != originalWidth)
   {
@@ -1030,21 +1093,21 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
     stepHeader.SetWidth(uiWidth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
+    const FilterPass pass = {stepSource, stepTarget, &weights, originalHeight, originalDepth, numFaces, originalWidth, addressModeU, vBorderColor};
+
+    ezTaskSystem::ParallelForIndexed(0u, numArrayElements * numFaces * originalDepth * originalHeight, [&pass, &firstSampleIndices](ezUInt32 uiStartRow, ezUInt32 uiEndRow)
       {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
+        for (ezUInt32 row = uiStartRow; row < uiEndRow; ++row)
         {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          ezUInt32 face, arrayIndex, y, z;
+          pass.GetLineCoordinates(row, face, arrayIndex, y, z);
+
+          const ezSimdVec4f* filterSource = pass.m_pSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          ezSimdVec4f* filterTarget = pass.m_pTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterLine(pass.m_uiNumSourceElements, filterSource, filterTarget, 1, *pass.m_pWeights, firstSampleIndices, pass.m_AddressMode, pass.m_vBorderColor);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D X");
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1053,11 +1116,6 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
   if (uiHeight != originalHeight)
   {
     ezImageFilterWeights weights(*pFilter, originalHeight, uiHeight);
-    firstSampleIndices.SetCount(uiHeight);
-    for (ezUInt32 y = 0; y < uiHeight; ++y)
-    {
-      firstSampleIndices[y] = weights.GetFirstSourceSampleIndex(y);
-    }
 
     ezImage* stepTarget;
     if (uiDepth == originalDepth && format == ezImageFormat::R32G32B32A32_FLOAT)
@@ -1073,21 +1131,21 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
     stepHeader.SetHeight(uiHeight);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
+    const FilterPass pass = {stepSource, stepTarget, &weights, uiHeight, originalDepth, numFaces, originalHeight, addressModeV, vBorderColor};
+
+    ezTaskSystem::ParallelForIndexed(0u, numArrayElements * numFaces * originalDepth * uiHeight, [&pass, uiWidth](ezUInt32 uiStartRow, ezUInt32 uiEndRow)
       {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
+        for (ezUInt32 row = uiStartRow; row < uiEndRow; ++row)
         {
-          for (ezUInt32 x = 0; x < uiWidth; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, uiWidth, weights, firstSampleIndices, addressModeV, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          ezUInt32 face, arrayIndex, y, z;
+          pass.GetLineCoordinates(row, face, arrayIndex, y, z);
+
+          const ezSimdVec4f* filterSource = pass.m_pSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, 0, z);
+          ezSimdVec4f* filterTarget = pass.m_pTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterLines(pass.m_uiNumSourceElements, filterSource, filterTarget, uiWidth, uiWidth, *pass.m_pWeights, y, pass.m_AddressMode, pass.m_vBorderColor);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D Y");
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1096,11 +1154,6 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
   if (uiDepth != originalDepth)
   {
     ezImageFilterWeights weights(*pFilter, originalDepth, uiDepth);
-    firstSampleIndices.SetCount(uiDepth);
-    for (ezUInt32 z = 0; z < uiDepth; ++z)
-    {
-      firstSampleIndices[z] = weights.GetFirstSourceSampleIndex(z);
-    }
 
     ezImage* stepTarget;
     if (format == ezImageFormat::R32G32B32A32_FLOAT)
@@ -1116,21 +1169,21 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
     stepHeader.SetDepth(uiDepth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
+    const FilterPass pass = {stepSource, stepTarget, &weights, uiHeight, uiDepth, numFaces, originalDepth, addressModeW, vBorderColor};
+
+    ezTaskSystem::ParallelForIndexed(0u, numArrayElements * numFaces * uiDepth * uiHeight, [&pass, uiWidth](ezUInt32 uiStartRow, ezUInt32 uiEndRow)
       {
-        for (ezUInt32 y = 0; y < uiHeight; ++y)
+        for (ezUInt32 row = uiStartRow; row < uiEndRow; ++row)
         {
-          for (ezUInt32 x = 0; x < uiWidth; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, uiWidth * uiHeight, weights, firstSampleIndices, addressModeW, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          ezUInt32 face, arrayIndex, y, z;
+          pass.GetLineCoordinates(row, face, arrayIndex, y, z);
+
+          const ezSimdVec4f* filterSource = pass.m_pSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, 0);
+          ezSimdVec4f* filterTarget = pass.m_pTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterLines(pass.m_uiNumSourceElements, filterSource, filterTarget, uiWidth * pass.m_uiHeight, uiWidth, *pass.m_pWeights, z, pass.m_AddressMode, pass.m_vBorderColor);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D Z");
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1170,58 +1223,82 @@ void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& ref_targe
 
   ref_target.ResetAndAlloc(header);
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < source.GetNumArrayIndices(); arrayIndex++)
+  struct MipChainContext
   {
-    for (ezUInt32 face = 0; face < source.GetNumFaces(); face++)
-    {
-      ezImageHeader currentMipMapHeader = header;
-      currentMipMapHeader.SetNumMipLevels(1);
-      currentMipMapHeader.SetNumFaces(1);
-      currentMipMapHeader.SetNumArrayIndices(1);
+    const ezImageView* m_pSource;
+    ezImage* m_pTarget;
+    const ezImageHeader* m_pHeader;
+    const ezImageUtils::MipMapOptions* m_pOptions;
+    ezUInt32 m_uiNumMipMaps;
+  };
 
-      auto sourceView = source.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
-      auto targetView = ref_target.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
+  const ezUInt32 uiNumFaces = source.GetNumFaces();
 
-      memcpy(targetView.GetPtr(), sourceView.GetPtr(), static_cast<size_t>(targetView.GetCount()));
+  // every face and array slice has its own mip chain, so those are generated in parallel
+  // Scale3D() waits for its own parallel tasks, so these tasks must allow nesting
+  const MipChainContext ctx = {&source, &ref_target, &header, &mipMapOptions, numMipMaps};
 
-      float targetCoverage = 0.0f;
-      if (mipMapOptions.m_preserveCoverage)
-      {
-        targetCoverage = EvaluateAverageCoverage(source.GetSubImageView(0, face, arrayIndex).GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
-      }
+  ezTaskSystem::ParallelForIndexed(0u, source.GetNumArrayIndices() * uiNumFaces, [&ctx, uiNumFaces](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+    {
+      const ezImageView& source = *ctx.m_pSource;
+      ezImage& ref_target = *ctx.m_pTarget;
+      const ezImageUtils::MipMapOptions& mipMapOptions = *ctx.m_pOptions;
+      const ezUInt32 numMipMaps = ctx.m_uiNumMipMaps;
 
-      for (ezUInt32 mipMapLevel = 0; mipMapLevel < numMipMaps - 1; mipMapLevel++)
+      for (ezUInt32 index = uiStartIndex; index < uiEndIndex; ++index)
       {
-        ezImageHeader nextMipMapHeader = currentMipMapHeader;
-        nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
-        nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
-        nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
+        const ezUInt32 face = index % uiNumFaces;
+        const ezUInt32 arrayIndex = index / uiNumFaces;
 
-        auto sourceData = ref_target.GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
-        ezImage currentMipMap;
-        currentMipMap.ResetAndUseExternalStorage(currentMipMapHeader, sourceData);
+        ezImageHeader currentMipMapHeader = *ctx.m_pHeader;
+        currentMipMapHeader.SetNumMipLevels(1);
+        currentMipMapHeader.SetNumFaces(1);
+        currentMipMapHeader.SetNumArrayIndices(1);
 
-        auto dstData = ref_target.GetSubImageView(mipMapLevel + 1, face, arrayIndex).GetByteBlobPtr();
-        ezImage nextMipMap;
-        nextMipMap.ResetAndUseExternalStorage(nextMipMapHeader, dstData);
+        auto sourceView = source.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
+        auto targetView = ref_target.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
 
-        ezImageUtils::Scale3D(currentMipMap, nextMipMap, nextMipMapHeader.GetWidth(), nextMipMapHeader.GetHeight(), nextMipMapHeader.GetDepth(), mipMapOptions.m_filter, mipMapOptions.m_addressModeU, mipMapOptions.m_addressModeV, mipMapOptions.m_addressModeW, mipMapOptions.m_borderColor)
-          .IgnoreResult();
+        memcpy(targetView.GetPtr(), sourceView.GetPtr(), static_cast<size_t>(targetView.GetCount()));
 
+        float targetCoverage = 0.0f;
         if (mipMapOptions.m_preserveCoverage)
         {
-          NormalizeCoverage(nextMipMap.GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold, targetCoverage);
+          targetCoverage = EvaluateAverageCoverage(source.GetSubImageView(0, face, arrayIndex).GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
         }
 
-        if (mipMapOptions.m_renormalizeNormals)
+        for (ezUInt32 mipMapLevel = 0; mipMapLevel < numMipMaps - 1; mipMapLevel++)
         {
-          RenormalizeNormalMap(nextMipMap);
-        }
+          ezImageHeader nextMipMapHeader = currentMipMapHeader;
+          nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
+          nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
+          nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
 
-        currentMipMapHeader = nextMipMapHeader;
+          auto sourceData = ref_target.GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
+          ezImage currentMipMap;
+          currentMipMap.ResetAndUseExternalStorage(currentMipMapHeader, sourceData);
+
+          auto dstData = ref_target.GetSubImageView(mipMapLevel + 1, face, arrayIndex).GetByteBlobPtr();
+          ezImage nextMipMap;
+          nextMipMap.ResetAndUseExternalStorage(nextMipMapHeader, dstData);
+
+          ezImageUtils::Scale3D(currentMipMap, nextMipMap, nextMipMapHeader.GetWidth(), nextMipMapHeader.GetHeight(), nextMipMapHeader.GetDepth(), mipMapOptions.m_filter, mipMapOptions.m_addressModeU, mipMapOptions.m_addressModeV, mipMapOptions.m_addressModeW, mipMapOptions.m_borderColor)
+            .IgnoreResult();
+
+          if (mipMapOptions.m_preserveCoverage)
+          {
+            NormalizeCoverage(nextMipMap.GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold, targetCoverage);
+          }
+
+          if (mipMapOptions.m_renormalizeNormals)
+          {
+            RenormalizeNormalMap(nextMipMap);
+          }
+
+          currentMipMapHeader = nextMipMapHeader;
+        }
       }
-    }
-  }
+    },
+    "ezImageUtils::GenerateMipMaps", ezTaskNesting::Maybe);
 }
 
 void ezImageUtils::ReconstructNormalZ(ezImage& ref_image)
@@ -23,6 +23,8 @@ public:
 private:
   void Update(const ezWorldModule::UpdateContext& context);
   void UpdateBounds(const ezWorldModule::UpdateContext& context);
+
+  ezDynamicArray<ezClothSheetComponent*> m_ComponentsToUpdate;
 };
 
 //////////////////////////////////////////////////////////////////////////
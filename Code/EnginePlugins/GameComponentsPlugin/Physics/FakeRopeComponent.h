@@ -15,6 +15,8 @@ public:
 
 private:
   void Update(const ezWorldModule::UpdateContext& context);
+
+  ezDynamicArray<ezFakeRopeComponent*> m_ComponentsToSimulate;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -80,7 +82,12 @@ private:
   ezResult ConfigureRopeSimulator();
   void SendCurrentPose();
   void SendPreviewPose();
-  void RuntimeUpdate();
+
+  /// \brief Updates the rope configuration and returns whether the rope needs to be simulated this frame.
+  bool PrepareRuntimeUpdate();
+
+  /// \brief Advances the rope simulation. Only touches the rope's own state, so different ropes can be simulated in parallel.
+  void SimulateRuntimeUpdate();
 
   ezGameObjectHandle m_hAnchor1;
   ezGameObjectHandle m_hAnchor2;
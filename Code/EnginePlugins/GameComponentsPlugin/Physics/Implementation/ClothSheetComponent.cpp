@@ -8,6 +8,7 @@
 #include <Core/World/WorldModule.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <GameComponentsPlugin/Physics/ClothSheetComponent.h>
 #include <RendererCore/../../../Data/Base/Shaders/Common/ObjectConstants.h>
 #include <RendererCore/Material/MaterialResource.h>
@@ -644,13 +645,21 @@ void ezClothSheetComponentManager::Initialize()
 
 void ezClothSheetComponentManager::Update(const ezWorldModule::UpdateContext& context)
 {
+  m_ComponentsToUpdate.Clear();
+
   for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
   {
     if (it->IsActiveAndInitialized())
     {
-      it->Update();
+      m_ComponentsToUpdate.PushBack(&(*it));
     }
   }
+
+  // every cloth only modifies its own simulation state, so they can all be simulated in parallel
+  ezTaskSystem::ParallelForSingle(
+    m_ComponentsToUpdate.GetArrayPtr(), [](ezClothSheetComponent* pComponent)
+    { pComponent->Update(); },
+    "ClothSheetSimulation");
 }
 
 void ezClothSheetComponentManager::UpdateBounds(const ezWorldModule::UpdateContext& context)
@@ -4,6 +4,7 @@
 #include <Core/Interfaces/WindWorldModule.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <GameComponentsPlugin/Physics/FakeRopeComponent.h>
 #include <RendererCore/AnimationSystem/Declarations.h>
 
@@ -264,10 +265,10 @@ void ezFakeRopeComponent::SendPreviewPose()
   SendCurrentPose();
 }
 
-void ezFakeRopeComponent::RuntimeUpdate()
+bool ezFakeRopeComponent::PrepareRuntimeUpdate()
 {
   if (ConfigureRopeSimulator().Failed())
-    return;
+    return false;
 
   ezVec3 acc(0);
 
@@ -302,13 +303,18 @@ void ezFakeRopeComponent::RuntimeUpdate()
   }
 
   if (m_uiSleepCounter > 10)
-    return;
+    return false;
 
   ezVisibilityState visType = GetOwner()->GetVisibilityState();
 
   if (visType == ezVisibilityState::Invisible)
-    return;
+    return false;
 
+  return true;
+}
+
+void ezFakeRopeComponent::SimulateRuntimeUpdate()
+{
   m_RopeSim.SimulateRope(GetWorld()->GetClock().GetTimeDiff());
 
   ++m_uiCheckEquilibriumCounter;
@@ -325,8 +331,6 @@ void ezFakeRopeComponent::RuntimeUpdate()
       m_uiSleepCounter = 0;
     }
   }
-
-  SendCurrentPose();
 }
 
 void ezFakeRopeComponent::SendCurrentPose()
@@ -478,12 +482,25 @@ void ezFakeRopeComponentManager::Update(const ezWorldModule::UpdateContext& cont
 
   if (GetWorld()->GetWorldSimulationEnabled())
   {
+    m_ComponentsToSimulate.Clear();
+
     for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
     {
-      if (it->IsActiveAndInitialized())
+      if (it->IsActiveAndInitialized() && it->PrepareRuntimeUpdate())
       {
-        it->RuntimeUpdate();
+        m_ComponentsToSimulate.PushBack(&(*it));
       }
     }
+
+    ezTaskSystem::ParallelForSingle(
+      m_ComponentsToSimulate.GetArrayPtr(), [](ezFakeRopeComponent* pComponent)
+      { pComponent->SimulateRuntimeUpdate(); },
+      "FakeRopeSimulation");
+
+    // the pose messages update the bounds of the rope render component, which must not happen concurrently
+    for (ezFakeRopeComponent* pComponent : m_ComponentsToSimulate)
+    {
+      pComponent->SendCurrentPose();
+    }
   }
 }
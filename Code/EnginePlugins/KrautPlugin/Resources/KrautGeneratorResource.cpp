@@ -4,9 +4,15 @@
 #include <KrautPlugin/Resources/KrautTreeResource.h>
 
 #include <Core/ResourceManager/ResourceTypeLoader.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Math/BoundingSphere.h>
 #include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Types/Uuid.h>
 #include <Foundation/Utilities/AssetFileHeader.h>
 #include <KrautGenerator/Description/Physics.h>
 #include <KrautGenerator/Lod/TreeStructureLod.h>
@@ -27,6 +33,11 @@ EZ_END_DYNAMIC_REFLECTED_TYPE;
 EZ_RESOURCE_IMPLEMENT_COMMON_CODE(ezKrautGeneratorResource);
 // clang-format on
 
+ezCVarBool cvar_KrautTreeCache("Kraut.TreeCache", true, ezCVarFlags::Default, "Whether generated trees are stored on disk and reused the next time the same tree is needed.");
+
+// increase this when the tree generation changes, to invalidate all cached trees
+static constexpr ezUInt32 s_uiKrautTreeCacheVersion = 3;
+
 ezKrautGeneratorResource::ezKrautGeneratorResource()
   : ezResource(DoUpdate::OnAnyThread, 1)
 {
@@ -159,10 +170,6 @@ public:
 
     ezResourceLock<ezKrautGeneratorResource> pGenerator(m_hGeneratorResource, ezResourceAcquireMode::BlockTillLoaded);
 
-    ezKrautTreeResourceDescriptor desc;
-
-    pGenerator->GenerateTreeDescriptor(desc, m_uiRandomSeed);
-
     ezMemoryStreamWriter writer(&pData->m_Storage);
 
     writer << pResource->GetResourceID();
@@ -170,7 +177,7 @@ public:
     ezAssetFileHeader assetHash;
     assetHash.Write(writer).IgnoreResult();
 
-    desc.Save(writer);
+    pGenerator->GetOrGenerateTreeData(writer, m_uiRandomSeed);
 
     ezResourceLoadData ld;
     ld.m_pDataStream = &pData->m_Reader;
@@ -223,6 +230,87 @@ ezKrautTreeResourceHandle ezKrautGeneratorResource::GenerateTree(ezUInt32 uiRand
   return hRes;
 }
 
+void ezKrautGeneratorResource::GetOrGenerateTreeData(ezStreamWriter& inout_stream, ezUInt32 uiRandomSeed) const
+{
+  // without an asset hash, there is no way to know whether a cached tree is still up to date
+  if (!cvar_KrautTreeCache || m_uiAssetHash == 0)
+  {
+    ezKrautTreeResourceDescriptor desc;
+    GenerateTreeDescriptor(desc, uiRandomSeed);
+    desc.Save(inout_stream);
+    return;
+  }
+
+  ezStringBuilder sCacheFile;
+  sCacheFile.SetFormat(":appdata/KrautTreeCache/{}-{}-{}.ezKrautTree", ezArgU(m_uiAssetHash, 16, true, 16), uiRandomSeed, s_uiKrautTreeCacheVersion);
+
+  {
+    ezFileReader file;
+    if (file.Open(sCacheFile).Succeeded() && file.GetFileSize() <= ezMath::MaxValue<ezUInt32>())
+    {
+      EZ_PROFILE_SCOPE("Kraut: LoadCachedTree");
+
+      ezDynamicArray<ezUInt8> cachedData;
+      cachedData.SetCountUninitialized(static_cast<ezUInt32>(file.GetFileSize()));
+
+      // the cached tree is passed on as it is, the tree resource decodes it anyway
+      // the file may be from an incomplete write though, then the tree is just generated again
+      if (file.ReadBytes(cachedData.GetData(), cachedData.GetCount()) == cachedData.GetCount() && ezKrautTreeResourceDescriptor::ValidateSavedData(cachedData).Succeeded())
+      {
+        inout_stream.WriteBytes(cachedData.GetData(), cachedData.GetCount()).IgnoreResult();
+        return;
+      }
+    }
+  }
+
+  ezContiguousMemoryStreamStorage treeData;
+
+  {
+    ezKrautTreeResourceDescriptor desc;
+    GenerateTreeDescriptor(desc, uiRandomSeed);
+
+    ezMemoryStreamWriter treeWriter(&treeData);
+    desc.Save(treeWriter);
+  }
+
+  inout_stream.WriteBytes(treeData.GetData(), treeData.GetStorageSize64()).IgnoreResult();
+
+  // write to a temporary file first, so that a crash or a second process never leaves a half-written tree behind
+  ezUInt64 uiTempLow = 0, uiTempHigh = 0;
+  ezUuid::MakeUuid().GetValues(uiTempLow, uiTempHigh);
+
+  ezStringBuilder sTempFile;
+  sTempFile.SetFormat("{}.{}.tmp", sCacheFile, ezArgU(uiTempLow, 16, true, 16));
+
+  bool bWritten = false;
+
+  {
+    ezFileWriter file;
+    if (file.Open(sTempFile).Failed())
+      return;
+
+    bWritten = file.WriteBytes(treeData.GetData(), treeData.GetStorageSize64()).Succeeded() && file.Flush().Succeeded();
+  }
+
+  ezStringBuilder sAbsTempFile, sAbsCacheFile;
+  if (!bWritten || ezFileSystem::ResolvePath(sTempFile, &sAbsTempFile, nullptr).Failed() || ezFileSystem::ResolvePath(sCacheFile, &sAbsCacheFile, nullptr).Failed())
+  {
+    ezFileSystem::DeleteFile(sTempFile);
+    return;
+  }
+
+  // replacing the file in one step is atomic on POSIX, other platforms can't move onto an existing file
+  if (ezOSFile::MoveFileOrDirectory(sAbsTempFile, sAbsCacheFile).Failed())
+  {
+    ezOSFile::DeleteFile(sAbsCacheFile).IgnoreResult();
+
+    if (ezOSFile::MoveFileOrDirectory(sAbsTempFile, sAbsCacheFile).Failed())
+    {
+      ezFileSystem::DeleteFile(sTempFile);
+    }
+  }
+}
+
 void ezKrautGeneratorResource::GenerateTreeDescriptor(ezKrautTreeResourceDescriptor& ref_dstDesc, ezUInt32 uiRandomSeed) const
 {
   EZ_LOG_BLOCK("Generate Kraut Tree");
@@ -564,6 +652,7 @@ void ezKrautGeneratorResource::GenerateTreeDescriptor(ezKrautTreeResourceDescrip
 ezResourceLoadDesc ezKrautGeneratorResource::UnloadData(Unload WhatToUnload)
 {
   m_pDescriptor.Clear();
+  m_uiAssetHash = 0;
 
   ezResourceLoadDesc res;
   res.m_uiQualityLevelsDiscardable = 0;
@@ -624,6 +713,8 @@ ezResourceLoadDesc ezKrautGeneratorResource::UpdateContent(ezStreamReader* Strea
     return res;
   }
 
+  m_uiAssetHash = AssetHash.GetFileHash();
+
   m_pDescriptor = EZ_DEFAULT_NEW(ezKrautGeneratorResourceDescriptor);
   if (m_pDescriptor->Deserialize(*Stream).Failed())
   {
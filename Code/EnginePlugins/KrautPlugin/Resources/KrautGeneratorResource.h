@@ -58,12 +58,19 @@ public:
 
   void GenerateTreeDescriptor(ezKrautTreeResourceDescriptor& ref_dstDesc, ezUInt32 uiRandomSeed) const;
 
+  /// \brief Writes the tree in the format of ezKrautTreeResourceDescriptor::Save(), taking it from the on-disk tree cache, if possible.
+  ///
+  /// Trees are cached per generator asset hash and random seed, so a tree only needs to be generated once, as long as the asset doesn't change.
+  /// Cached trees are only validated, not decoded.
+  void GetOrGenerateTreeData(ezStreamWriter& inout_stream, ezUInt32 uiRandomSeed) const;
+
 private:
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override;
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
 
   ezUniquePtr<ezKrautGeneratorResourceDescriptor> m_pDescriptor;
+  ezUInt64 m_uiAssetHash = 0;
 
   struct BranchNodeExtraData
   {
@@ -1,5 +1,7 @@
 #include <KrautPlugin/KrautPluginPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Utilities/AssetFileHeader.h>
 #include <KrautPlugin/Resources/KrautTreeResource.h>
 #include <RendererCore/Material/MaterialResource.h>
@@ -191,19 +193,53 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezKrautTreeResource, ezKrautTreeResourceDescrip
 
 //////////////////////////////////////////////////////////////////////////
 
-void ezKrautTreeResourceDescriptor::Save(ezStreamWriter& inout_stream0) const
+// written after the (compressed) tree data, to detect files that were cut off or corrupted
+static constexpr ezUInt8 s_uiKrautTreeVersion = 17;
+static constexpr ezUInt32 s_uiKrautTreeHeaderSize = sizeof(ezUInt8) + sizeof(ezUInt8) + sizeof(ezUInt64) + sizeof(ezUInt64);
+
+/// \brief Reads exactly as many bytes as the header says and checks them against the stored checksum.
+static ezResult ReadKrautTreeData(ezStreamReader& inout_stream, ezDynamicArray<ezUInt8>& out_data)
 {
-  ezUInt8 uiVersion = 15;
+  ezUInt64 uiDataSize = 0;
+  ezUInt64 uiChecksum = 0;
+  inout_stream >> uiDataSize;
+  inout_stream >> uiChecksum;
+
+  if (uiDataSize > ezMath::MaxValue<ezUInt32>())
+    return EZ_FAILURE;
+
+  // read in chunks, so that a corrupted size can't allocate more memory than the stream actually holds
+  out_data.Clear();
+  while (out_data.GetCount() < uiDataSize)
+  {
+    const ezUInt32 uiOffset = out_data.GetCount();
+    const ezUInt32 uiChunkSize = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiDataSize - uiOffset, 64 * 1024));
+    out_data.SetCountUninitialized(uiOffset + uiChunkSize);
+
+    if (inout_stream.ReadBytes(out_data.GetData() + uiOffset, uiChunkSize) != uiChunkSize)
+      return EZ_FAILURE;
+  }
+
+  if (uiChecksum != ezHashingUtils::xxHash64(out_data.GetData(), out_data.GetCount()))
+    return EZ_FAILURE;
+
+  return EZ_SUCCESS;
+}
 
-  inout_stream0 << uiVersion;
+void ezKrautTreeResourceDescriptor::Save(ezStreamWriter& inout_stream0) const
+{
+  inout_stream0 << s_uiKrautTreeVersion;
 
   ezUInt8 uiCompressionMode = 0;
 
+  ezContiguousMemoryStreamStorage data;
+  ezMemoryStreamWriter dataWriter(&data);
+
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
   uiCompressionMode = 1;
-  ezCompressedStreamWriterZstd stream(&inout_stream0, 0, ezCompressedStreamWriterZstd::Compression::Average);
+  ezCompressedStreamWriterZstd stream(&dataWriter, 0, ezCompressedStreamWriterZstd::Compression::Average);
 #else
-  ezStreamWriter& stream = stream0;
+  ezStreamWriter& stream = dataWriter;
 #endif
 
   inout_stream0 << uiCompressionMode;
@@ -272,6 +308,45 @@ void ezKrautTreeResourceDescriptor::Save(ezStreamWriter& inout_stream0) const
 
   ezLog::Dev("Compressed Kraut tree data from {0} KB to {1} KB ({2}%%)", ezArgF((float)stream.GetUncompressedSize() / 1024.0f, 1), ezArgF((float)stream.GetCompressedSize() / 1024.0f, 1), ezArgF(100.0f * stream.GetCompressedSize() / stream.GetUncompressedSize(), 1));
 #endif
+
+  const ezUInt64 uiDataSize = data.GetStorageSize64();
+  inout_stream0 << uiDataSize;
+  inout_stream0 << ezHashingUtils::xxHash64(data.GetData(), static_cast<size_t>(uiDataSize));
+
+  data.CopyToStream(inout_stream0).IgnoreResult();
+}
+
+ezResult ezKrautTreeResourceDescriptor::ValidateSavedData(ezArrayPtr<const ezUInt8> data)
+{
+  if (data.GetCount() < s_uiKrautTreeHeaderSize)
+    return EZ_FAILURE;
+
+  ezRawMemoryStreamReader reader(data.GetPtr(), data.GetCount());
+
+  ezUInt8 uiVersion = 0;
+  ezUInt8 uiCompressionMode = 0;
+  ezUInt64 uiDataSize = 0;
+  ezUInt64 uiChecksum = 0;
+  reader >> uiVersion;
+  reader >> uiCompressionMode;
+  reader >> uiDataSize;
+  reader >> uiChecksum;
+
+  if (uiVersion != s_uiKrautTreeVersion || uiDataSize != data.GetCount() - s_uiKrautTreeHeaderSize)
+    return EZ_FAILURE;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (uiCompressionMode > 1)
+    return EZ_FAILURE;
+#else
+  if (uiCompressionMode != 0)
+    return EZ_FAILURE;
+#endif
+
+  if (uiChecksum != ezHashingUtils::xxHash64(data.GetPtr() + s_uiKrautTreeHeaderSize, static_cast<size_t>(uiDataSize)))
+    return EZ_FAILURE;
+
+  return EZ_SUCCESS;
 }
 
 ezResult ezKrautTreeResourceDescriptor::Load(ezStreamReader& inout_stream0)
@@ -280,13 +355,32 @@ ezResult ezKrautTreeResourceDescriptor::Load(ezStreamReader& inout_stream0)
 
   inout_stream0 >> uiVersion;
 
-  if (uiVersion < 15)
+  // version 16 had its checksum in a footer and was only ever written to the tree cache
+  if (uiVersion < 15 || uiVersion == 16 || uiVersion > s_uiKrautTreeVersion)
     return EZ_FAILURE;
 
   ezUInt8 uiCompressionMode = 0;
   inout_stream0 >> uiCompressionMode;
 
-  ezStreamReader* pCompressor = &inout_stream0;
+  ezStreamReader* pDataStream = &inout_stream0;
+
+  ezDynamicArray<ezUInt8> data;
+  ezRawMemoryStreamReader dataReader;
+
+  if (uiVersion >= 17)
+  {
+    // validate everything before parsing, the decompressor doesn't cope with truncated data
+    if (ReadKrautTreeData(inout_stream0, data).Failed())
+    {
+      ezLog::Warning("Kraut tree data is incomplete or corrupted.");
+      return EZ_FAILURE;
+    }
+
+    dataReader.Reset(data.GetData(), data.GetCount());
+    pDataStream = &dataReader;
+  }
+
+  ezStreamReader* pCompressor = pDataStream;
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
   ezCompressedStreamReaderZstd decompressorZstd;
@@ -299,7 +393,7 @@ ezResult ezKrautTreeResourceDescriptor::Load(ezStreamReader& inout_stream0)
 
     case 1:
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
-      decompressorZstd.SetInputStream(&inout_stream0);
+      decompressorZstd.SetInputStream(pDataStream);
       pCompressor = &decompressorZstd;
       break;
 #else
@@ -20,9 +20,15 @@ struct EZ_KRAUTPLUGIN_DLL ezKrautTreeResourceDetails
 
 struct EZ_KRAUTPLUGIN_DLL ezKrautTreeResourceDescriptor
 {
+  /// \brief Writes the size and checksum of the tree data, followed by the data itself.
   void Save(ezStreamWriter& inout_stream) const;
+
+  /// \brief Reads exactly the data that Save() wrote. Fails if it is incomplete or doesn't match its checksum.
   ezResult Load(ezStreamReader& inout_stream);
 
+  /// \brief Checks that \a data is exactly one complete tree, as written by Save(), without decoding it.
+  static ezResult ValidateSavedData(ezArrayPtr<const ezUInt8> data);
+
   struct VertexData
   {
     EZ_DECLARE_POD_TYPE();
@@ -85,6 +85,11 @@ void ezParticleBehaviorFactory_Bounds::Load(ezStreamReader& inout_stream)
   }
 }
 
+ezParticleBehavior_Bounds::ezParticleBehavior_Bounds()
+{
+  m_bTileSafe = true;
+}
+
 void ezParticleBehavior_Bounds::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
@@ -99,6 +104,11 @@ void ezParticleBehavior_Bounds::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Bounds");
 
+  ProcessTile(0, uiNumElements);
+}
+
+void ezParticleBehavior_Bounds::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
   const ezSimdTransform trans = ezSimdConversion::ToTransform(GetOwnerSystem()->GetTransform());
   const ezSimdTransform invTrans = trans.GetInverse();
 
@@ -107,7 +117,7 @@ void ezParticleBehavior_Bounds::Process(ezUInt64 uiNumElements)
   const ezSimdVec4f halfExtPos = ezSimdConversion::ToVec3(m_vBoxExtents) * 0.5f;
   const ezSimdVec4f halfExtNeg = -halfExtPos;
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
 
   if (m_OutOfBoundsMode == ezParticleOutOfBoundsMode::Teleport)
   {
@@ -115,7 +125,7 @@ void ezParticleBehavior_Bounds::Process(ezUInt64 uiNumElements)
 
     if (m_pStreamLastPosition)
     {
-      pLastPosition = m_pStreamLastPosition->GetWritableData<ezVec3>();
+      pLastPosition = m_pStreamLastPosition->GetWritableData<ezVec3>() + uiStartIndex;
     }
 
     while (!itPosition.HasReachedEnd())
@@ -146,7 +156,7 @@ void ezParticleBehavior_Bounds::Process(ezUInt64 uiNumElements)
   }
   else
   {
-    ezUInt32 idx = 0;
+    ezUInt64 idx = uiStartIndex;
 
     while (!itPosition.HasReachedEnd())
     {
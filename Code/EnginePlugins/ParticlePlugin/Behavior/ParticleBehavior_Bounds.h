@@ -28,12 +28,15 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleBehavior_Bounds final : public ezParticleB
   EZ_ADD_DYNAMIC_REFLECTION(ezParticleBehavior_Bounds, ezParticleBehavior);
 
 public:
+  ezParticleBehavior_Bounds();
+
   ezVec3 m_vPositionOffset;
   ezVec3 m_vBoxExtents;
   ezEnum<ezParticleOutOfBoundsMode> m_OutOfBoundsMode;
 
 protected:
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   virtual void CreateRequiredStreams() override;
   virtual void QueryOptionalStreams() override;
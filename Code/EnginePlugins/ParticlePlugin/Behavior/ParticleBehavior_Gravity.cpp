@@ -73,16 +73,26 @@ void ezParticleBehavior_Gravity::CreateRequiredStreams()
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
+ezParticleBehavior_Gravity::ezParticleBehavior_Gravity()
+{
+  m_bTileSafe = true;
+}
+
 void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Gravity");
 
+  ProcessTile(0, uiNumElements);
+}
+
+void ezParticleBehavior_Gravity::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
   const ezVec3 vGravity = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity() : ezVec3(0.0f, 0.0f, -10.0f);
 
   const float tDiff = (float)m_TimeDiff.GetSeconds();
   const ezVec3 addGravity = vGravity * m_fGravityFactor * tDiff;
 
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, uiStartIndex);
 
   while (!itVelocity.HasReachedEnd())
   {
@@ -29,6 +29,8 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleBehavior_Gravity final : public ezParticle
   EZ_ADD_DYNAMIC_REFLECTION(ezParticleBehavior_Gravity, ezParticleBehavior);
 
 public:
+  ezParticleBehavior_Gravity();
+
   float m_fGravityFactor;
 
   virtual void CreateRequiredStreams() override;
@@ -37,6 +39,7 @@ protected:
   friend class ezParticleBehaviorFactory_Gravity;
 
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
@@ -73,14 +73,24 @@ void ezParticleBehavior_PullAlong::CreateRequiredStreams()
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
 }
 
+ezParticleBehavior_PullAlong::ezParticleBehavior_PullAlong()
+{
+  m_bTileSafe = true;
+}
+
 void ezParticleBehavior_PullAlong::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: PullAlong");
 
+  ProcessTile(0, uiNumElements);
+}
+
+void ezParticleBehavior_PullAlong::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
   if (m_vApplyPull.IsZero())
     return;
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
   ezSimdVec4f pull;
   pull.Load<3>(&m_vApplyPull.x);
 
@@ -26,12 +26,15 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleBehavior_PullAlong final : public ezPartic
   EZ_ADD_DYNAMIC_REFLECTION(ezParticleBehavior_PullAlong, ezParticleBehavior);
 
 public:
+  ezParticleBehavior_PullAlong();
+
   virtual void CreateRequiredStreams() override;
 
   float m_fStrength = 0.5;
 
 protected:
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
   virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   bool m_bFirstTime = true;
@@ -95,19 +95,25 @@ void ezParticleBehaviorFactory_Velocity::QueryFinalizerDependencies(ezSet<const
   inout_finalizerDeps.Insert(ezGetStaticRTTI<ezParticleFinalizerFactory_ApplyVelocity>());
 }
 
+ezParticleBehavior_Velocity::ezParticleBehavior_Velocity()
+{
+  m_bTileSafe = true;
+}
+
 void ezParticleBehavior_Velocity::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Velocity::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
-  EZ_PROFILE_SCOPE("PFX: Velocity");
+  SUPER::StepParticleSystem(tDiff, uiNumNewParticles);
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  // everything that modifies this behavior happens here, so that ProcessTile() can run concurrently
+  const float fTimeDiff = (float)m_TimeDiff.GetSeconds();
   const ezVec3 vDown = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity().GetNormalized() : ezVec3(0.0f, 0.0f, -1.0f);
-  const ezVec3 vRise = vDown * tDiff * -m_fRiseSpeed;
+  const ezVec3 vRise = vDown * fTimeDiff * -m_fRiseSpeed;
 
   auto pOwner = GetOwnerEffect();
   ezVec3 vWind(0);
@@ -115,9 +121,9 @@ void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
   if (m_iWindSampleIdx >= 0)
   {
     ezVec3 vCurWind = pOwner->GetWindSampleResult(m_iWindSampleIdx);
-    vCurWind = ezMath::Lerp(m_vLastWind, vCurWind, tDiff);
+    vCurWind = ezMath::Lerp(m_vLastWind, vCurWind, fTimeDiff);
 
-    vWind = vCurWind * m_fWindInfluence * tDiff;
+    vWind = vCurWind * m_fWindInfluence * fTimeDiff;
 
     m_vLastWind = vCurWind;
 
@@ -129,16 +135,28 @@ void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
     m_iWindSampleIdx = pOwner->AddWindSampleLocation(GetOwnerSystem()->GetTransform().m_vPosition);
   }
 
-  const ezVec3 vAddPos0 = vRise + vWind;
+  m_vAddPosition = vRise + vWind;
+
+  const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
+  m_fFrictionFactor = ezMath::Pow(0.5f, fTimeDiff * fFriction);
+}
+
+void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+{
+  EZ_PROFILE_SCOPE("PFX: Velocity");
+
+  ProcessTile(0, uiNumElements);
+}
 
+void ezParticleBehavior_Velocity::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
   ezSimdVec4f vAddPos;
-  vAddPos.Load<3>(&vAddPos0.x);
+  vAddPos.Load<3>(&m_vAddPosition.x);
 
-  const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
-  const float fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+  const float fFrictionFactor = m_fFrictionFactor;
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
+  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
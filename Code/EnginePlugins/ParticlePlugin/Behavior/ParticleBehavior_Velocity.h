@@ -32,6 +32,8 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleBehavior_Velocity final : public ezParticl
   EZ_ADD_DYNAMIC_REFLECTION(ezParticleBehavior_Velocity, ezParticleBehavior);
 
 public:
+  ezParticleBehavior_Velocity();
+
   virtual void CreateRequiredStreams() override;
 
   float m_fRiseSpeed = 0;
@@ -42,6 +44,8 @@ protected:
   friend class ezParticleBehaviorFactory_Velocity;
 
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
@@ -54,4 +58,8 @@ protected:
   ezProcessingStream* m_pStreamVelocity;
 
   ezVec3 m_vLastWind = ezVec3::MakeZero();
+
+  // computed once per frame in StepParticleSystem()
+  ezVec3 m_vAddPosition = ezVec3::MakeZero();
+  float m_fFrictionFactor = 1.0f;
 };
@@ -45,7 +45,12 @@ void ezParticleFinalizerFactory_Age::CopyFinalizerProperties(ezParticleFinalizer
   }
 }
 
-ezParticleFinalizer_Age::ezParticleFinalizer_Age() = default;
+ezParticleFinalizer_Age::ezParticleFinalizer_Age()
+{
+  // death events are sent when the removals are applied, which happens on the owning thread
+  m_bTileSafe = true;
+}
+
 
 ezParticleFinalizer_Age::~ezParticleFinalizer_Age()
 {
@@ -107,11 +112,16 @@ void ezParticleFinalizer_Age::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Age");
 
+  ProcessTile(0, uiNumElements);
+}
+
+void ezParticleFinalizer_Age::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
   ezFloat16Vec2* pLifeTime = m_pStreamLifeTime->GetWritableData<ezFloat16Vec2>();
 
   const float tDiff = (float)m_TimeDiff.GetSeconds();
 
-  for (ezUInt32 i = 0; i < uiNumElements; ++i)
+  for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
   {
     pLifeTime[i].x = pLifeTime[i].x - tDiff;
 
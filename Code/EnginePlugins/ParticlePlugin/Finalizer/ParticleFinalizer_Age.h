@@ -40,6 +40,7 @@ protected:
 
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
   void OnParticleDeath(const ezStreamGroupElementRemovedEvent& e);
 
   bool m_bHasOnDeathEventHandler = false;
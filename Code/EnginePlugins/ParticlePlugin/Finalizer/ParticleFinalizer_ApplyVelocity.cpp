@@ -30,6 +30,7 @@ ezParticleFinalizer_ApplyVelocity::ezParticleFinalizer_ApplyVelocity()
 {
   // a bit later than the other finalizers
   m_fPriority = 525.0f;
+  m_bTileSafe = true;
 }
 
 ezParticleFinalizer_ApplyVelocity::~ezParticleFinalizer_ApplyVelocity() = default;
@@ -44,10 +45,15 @@ void ezParticleFinalizer_ApplyVelocity::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: ApplyVelocity");
 
+  ProcessTile(0, uiNumElements);
+}
+
+void ezParticleFinalizer_ApplyVelocity::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
   const float tDiff = (float)m_TimeDiff.GetSeconds();
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
+  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
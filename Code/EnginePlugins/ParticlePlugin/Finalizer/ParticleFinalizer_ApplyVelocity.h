@@ -26,6 +26,7 @@ public:
 
 protected:
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   ezProcessingStream* m_pStreamPosition = nullptr;
   ezProcessingStream* m_pStreamVelocity = nullptr;
@@ -32,6 +32,7 @@ ezParticleFinalizer_LastPosition::ezParticleFinalizer_LastPosition()
 {
   // do this at the start of the frame, but after the initializers
   m_fPriority = -499.0f;
+  m_bTileSafe = true;
 }
 
 ezParticleFinalizer_LastPosition::~ezParticleFinalizer_LastPosition() = default;
@@ -46,8 +47,13 @@ void ezParticleFinalizer_LastPosition::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: LastPosition");
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
+  ProcessTile(0, uiNumElements);
+}
+
+void ezParticleFinalizer_LastPosition::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
+  ezProcessingStreamIterator<ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
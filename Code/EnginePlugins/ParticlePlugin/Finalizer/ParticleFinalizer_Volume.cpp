@@ -31,7 +31,11 @@ void ezParticleFinalizerFactory_Volume::CopyFinalizerProperties(ezParticleFinali
   ezParticleFinalizer_Volume* pFinalizer = static_cast<ezParticleFinalizer_Volume*>(pObject);
 }
 
-ezParticleFinalizer_Volume::ezParticleFinalizer_Volume() = default;
+ezParticleFinalizer_Volume::ezParticleFinalizer_Volume()
+{
+  m_bTileSafe = true;
+}
+
 ezParticleFinalizer_Volume::~ezParticleFinalizer_Volume() = default;
 
 void ezParticleFinalizer_Volume::CreateRequiredStreams()
@@ -56,35 +60,65 @@ void ezParticleFinalizer_Volume::Process(ezUInt64 uiNumElements)
 
   const ezSimdBBoxSphere volume = ezSimdBBoxSphere::MakeFromPoints(pPosition, static_cast<ezUInt32>(uiNumElements));
 
-  float fMaxSize = 0;
+  GetOwnerSystem()->SetBoundingVolume(ezSimdConversion::ToBBoxSphere(volume), ComputeMaxSize(0, uiNumElements));
+}
 
-  if (m_pStreamSize != nullptr)
-  {
-    const ezFloat16* pSize = m_pStreamSize->GetData<ezFloat16>();
+void ezParticleFinalizer_Volume::ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  const ezSimdVec4f* pPosition = m_pStreamPosition->GetData<ezSimdVec4f>();
+
+  const ezSimdBBox tileBounds = ezSimdBBox::MakeFromPoints(pPosition + uiStartIndex, static_cast<ezUInt32>(uiNumElements));
+  const float fTileMaxSize = ComputeMaxSize(uiStartIndex, uiNumElements);
+
+  EZ_LOCK(m_TileBoundsMutex);
+
+  m_TileBounds.ExpandToInclude(tileBounds);
+  m_fTileMaxSize = ezMath::Max(m_fTileMaxSize, fTileMaxSize);
+  m_uiNumTileElementsDone += uiNumElements;
+
+  if (m_uiNumTileElementsDone < m_pStreamGroup->GetNumActiveElements())
+    return;
+
+  // min and max don't depend on the order in which the tiles are merged, but the sphere can't be computed from the tile bounds
+  // without another pass over all positions, so the sphere around the box is used instead
+  GetOwnerSystem()->SetBoundingVolume(ezSimdConversion::ToBBoxSphere(ezSimdBBoxSphere::MakeFromBox(m_TileBounds)), m_fTileMaxSize);
+
+  m_TileBounds = ezSimdBBox::MakeInvalid();
+  m_fTileMaxSize = 0.0f;
+  m_uiNumTileElementsDone = 0;
+}
+
+float ezParticleFinalizer_Volume::ComputeMaxSize(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) const
+{
+  if (m_pStreamSize == nullptr)
+    return 0.0f;
 
-    ezSimdVec4f vMax;
-    vMax.SetZero();
+  const ezFloat16* pSize = m_pStreamSize->GetData<ezFloat16>() + uiStartIndex;
 
-    constexpr ezUInt32 uiElementsPerLoop = 4;
-    for (ezUInt64 i = 0; i < uiNumElements; i += uiElementsPerLoop)
-    {
-      const float x = pSize[i + 0];
-      const float y = pSize[i + 1];
-      const float z = pSize[i + 2];
-      const float w = pSize[i + 3];
+  float fMaxSize = 0;
+
+  ezSimdVec4f vMax;
+  vMax.SetZero();
+
+  constexpr ezUInt32 uiElementsPerLoop = 4;
+  const ezUInt64 uiNumElementsInLoop = (uiNumElements / uiElementsPerLoop) * uiElementsPerLoop;
 
-      vMax = vMax.CompMax(ezSimdVec4f(x, y, z, w));
-    }
+  for (ezUInt64 i = 0; i < uiNumElementsInLoop; i += uiElementsPerLoop)
+  {
+    const float x = pSize[i + 0];
+    const float y = pSize[i + 1];
+    const float z = pSize[i + 2];
+    const float w = pSize[i + 3];
 
-    for (ezUInt64 i = (uiNumElements / uiElementsPerLoop) * uiElementsPerLoop; i < uiNumElements; ++i)
-    {
-      fMaxSize = ezMath::Max(fMaxSize, (float)pSize[i]);
-    }
+    vMax = vMax.CompMax(ezSimdVec4f(x, y, z, w));
+  }
 
-    fMaxSize = ezMath::Max(fMaxSize, (float)vMax.HorizontalMax<4>());
+  for (ezUInt64 i = uiNumElementsInLoop; i < uiNumElements; ++i)
+  {
+    fMaxSize = ezMath::Max(fMaxSize, (float)pSize[i]);
   }
 
-  GetOwnerSystem()->SetBoundingVolume(ezSimdConversion::ToBBoxSphere(volume), fMaxSize);
+  return ezMath::Max(fMaxSize, (float)vMax.HorizontalMax<4>());
 }
 
 
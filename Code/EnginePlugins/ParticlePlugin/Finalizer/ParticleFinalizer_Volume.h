@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Foundation/SimdMath/SimdBBox.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/VarianceTypes.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer.h>
 
@@ -31,7 +33,16 @@ public:
 
 protected:
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+
+  float ComputeMaxSize(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) const;
 
   ezProcessingStream* m_pStreamPosition = nullptr;
   const ezProcessingStream* m_pStreamSize = nullptr;
+
+  // the bounds of the tiles are merged here, the tile that completes them sets the bounding volume
+  ezMutex m_TileBoundsMutex;
+  ezSimdBBox m_TileBounds = ezSimdBBox::MakeInvalid();
+  float m_fTileMaxSize = 0.0f;
+  ezUInt64 m_uiNumTileElementsDone = 0;
 };
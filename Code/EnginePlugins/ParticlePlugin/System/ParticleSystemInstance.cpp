@@ -2,6 +2,7 @@
 
 #include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/DataProcessing/Stream/DefaultImplementations/ZeroInitializer.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
@@ -18,6 +19,8 @@
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 
+ezCVarInt cvar_ParticlesParallelUpdateThreshold("Particles.ParallelUpdateThreshold", 16384, ezCVarFlags::Default, "Particle systems with at least this many particles update their behaviors and finalizers on multiple threads. Zero disables it.");
+
 bool ezParticleSystemInstance::HasActiveParticles() const
 {
   return m_StreamGroup.GetNumActiveElements() > 0;
@@ -448,6 +451,13 @@ ezParticleSystemState::Enum ezParticleSystemInstance::Update(const ezTime& diff)
 
   {
     EZ_PROFILE_SCOPE("PFX: System Process");
+
+    // emitters, initializers and everything that sends events stays on this thread,
+    // only the tile safe behaviors and finalizers are distributed across the workers
+    const ezInt32 iParallelThreshold = cvar_ParticlesParallelUpdateThreshold;
+    const bool bParallel = iParallelThreshold > 0 && m_StreamGroup.GetNumActiveElements() >= static_cast<ezUInt64>(iParallelThreshold);
+    m_StreamGroup.SetExecutionMode(bParallel ? ezProcessingStreamGroup::ExecutionMode::TiledParallel : ezProcessingStreamGroup::ExecutionMode::Sequential);
+
     m_StreamGroup.Process();
   }
 
@@ -3,9 +3,12 @@
 #include <ParticlePlugin/Type/Quad/ParticleTypeQuad.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Algorithm/Sorting.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Math/Color16f.h>
 #include <Foundation/Math/Float16.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_LastPosition.h>
 #include <RendererCore/Pipeline/View.h>
@@ -69,6 +72,11 @@ void ezParticleTypeQuadFactory::CopyTypeProperties(ezParticleType* pObject, bool
     pType->m_hTexture = ezResourceManager::LoadResource<ezTexture2DResource>(m_sTexture);
   if (!m_sDistortionTexture.IsEmpty())
     pType->m_hDistortionTexture = ezResourceManager::LoadResource<ezTexture2DResource>(m_sDistortionTexture);
+
+  if (bFirstTime)
+  {
+    pType->GetOwnerSystem()->AddParticleDeathEventHandler(ezMakeDelegate(&ezParticleTypeQuad::OnParticleDeath, pType));
+  }
 }
 
 enum class TypeQuadVersion
@@ -156,7 +164,14 @@ void ezParticleTypeQuadFactory::QueryFinalizerDependencies(ezSet<const ezRTTI*>&
 }
 
 ezParticleTypeQuad::ezParticleTypeQuad() = default;
-ezParticleTypeQuad::~ezParticleTypeQuad() = default;
+
+ezParticleTypeQuad::~ezParticleTypeQuad()
+{
+  if (m_pStreamPosition != nullptr)
+  {
+    GetOwnerSystem()->RemoveParticleDeathEventHandler(ezMakeDelegate(&ezParticleTypeQuad::OnParticleDeath, this));
+  }
+}
 
 void ezParticleTypeQuad::CreateRequiredStreams()
 {
@@ -187,12 +202,8 @@ void ezParticleTypeQuad::CreateRequiredStreams()
   }
 }
 
-struct sodComparer
-{
-  // sort farther particles to the front, so that they get rendered first (back to front)
-  EZ_ALWAYS_INLINE bool Less(const ezParticleTypeQuad::sod& a, const ezParticleTypeQuad::sod& b) const { return a.dist > b.dist; }
-  EZ_ALWAYS_INLINE bool Equal(const ezParticleTypeQuad::sod& a, const ezParticleTypeQuad::sod& b) const { return a.dist == b.dist; }
-};
+ezCVarFloat cvar_ParticlesQuadSortReuseDistance("Particles.Quad.SortReuseDistance", 0.1f, ezCVarFlags::Default, "Blended quad particles are only sorted again when the camera moved farther than this or particles spawned or died.");
+ezCVarInt cvar_ParticlesQuadSortReuseFrames("Particles.Quad.SortReuseFrames", 4, ezCVarFlags::Default, "The maximum number of frames for which the sort order of blended quad particles is reused.");
 
 void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& ref_msg, const ezTransform& instanceTransform) const
 {
@@ -212,23 +223,20 @@ void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& ref_msg,
 
     if (bNeedsSorting)
     {
-      // TODO: Using the frame allocator this way results in memory corruptions.
-      // Not sure, whether this is supposed to work.
-      ezHybridArray<sod, 64> sorted; // (ezFrameAllocator::GetCurrentAllocator());
-      sorted.SetCountUninitialized(numParticles);
-
       const ezVec3 vCameraPos = ref_msg.m_pView->GetCullingCamera()->GetCenterPosition();
-      const ezVec4* pPosition = m_pStreamPosition->GetData<ezVec4>();
 
-      for (ezUInt32 p = 0; p < numParticles; ++p)
+      // particles move slowly compared to the frame rate, so while the camera stays put, the last order is still good enough
+      const float fReuseDistance = cvar_ParticlesQuadSortReuseDistance;
+      const bool bReuseSortOrder = m_bSortOrderValid && m_SortedIndices.GetCount() == numParticles &&
+                                   m_uiLastExtractedFrame - m_uiLastSortFrame <= static_cast<ezUInt64>(ezMath::Max<int>(cvar_ParticlesQuadSortReuseFrames, 0)) &&
+                                   (vCameraPos - m_vLastSortCameraPos).GetLengthSquared() <= fReuseDistance * fReuseDistance;
+
+      if (!bReuseSortOrder)
       {
-        sorted[p].dist = (pPosition[p].GetAsVec3() - vCameraPos).GetLengthSquared();
-        sorted[p].index = p;
+        SortParticles(vCameraPos);
       }
 
-      sorted.Sort(sodComparer());
-
-      CreateExtractedData(&sorted);
+      CreateExtractedData(m_SortedIndices.GetData());
     }
     else
     {
@@ -239,19 +247,69 @@ void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& ref_msg,
   AddParticleRenderData(ref_msg, instanceTransform);
 }
 
-EZ_ALWAYS_INLINE ezUInt32 noRedirect(ezUInt32 uiIdx, const ezHybridArray<ezParticleTypeQuad::sod, 64>* pSorted)
+void ezParticleTypeQuad::SortParticles(const ezVec3& vCameraPos) const
+{
+  EZ_PROFILE_SCOPE("PFX: Quad Sort");
+
+  const ezUInt32 numParticles = (ezUInt32)GetOwnerSystem()->GetNumActiveParticles();
+
+  m_uiLastSortFrame = m_uiLastExtractedFrame;
+  m_vLastSortCameraPos = vCameraPos;
+  m_bSortOrderValid = true;
+
+  // this will automatically be deallocated at the end of the frame
+  ezArrayPtr<sod> keys = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), sod, numParticles);
+  ezArrayPtr<sod> scratch = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), sod, numParticles);
+
+  SortBackToFront(ezMakeArrayPtr(m_pStreamPosition->GetData<ezSimdVec4f>(), numParticles), vCameraPos, keys, scratch, m_SortedIndices);
+}
+
+void ezParticleTypeQuad::SortBackToFront(ezArrayPtr<const ezSimdVec4f> positions, const ezVec3& vCameraPos, ezArrayPtr<sod> keys, ezArrayPtr<sod> scratch, ezDynamicArray<ezUInt32>& out_sortedIndices)
+{
+  EZ_ASSERT_DEBUG(keys.GetCount() == positions.GetCount() && scratch.GetCount() == positions.GetCount(), "Invalid size of the temporary storage");
+
+  const ezUInt32 numParticles = positions.GetCount();
+  const ezSimdVec4f vSimdCameraPos = ezSimdConversion::ToVec3(vCameraPos);
+
+  for (ezUInt32 p = 0; p < numParticles; ++p)
+  {
+    const float fDistSqr = (positions[p] - vSimdCameraPos).GetLengthSquared<3>();
+
+    // sort farther particles to the front, so that they get rendered first (back to front)
+    keys[p].key = ~ezSorting::FloatToRadixKey(fDistSqr);
+    keys[p].index = p;
+  }
+
+  ezSorting::RadixSort(keys, scratch, [](const sod& s)
+    { return s.key; });
+
+  out_sortedIndices.SetCountUninitialized(numParticles);
+
+  for (ezUInt32 p = 0; p < numParticles; ++p)
+  {
+    out_sortedIndices[p] = keys[p].index;
+  }
+}
+
+void ezParticleTypeQuad::OnParticleDeath(const ezStreamGroupElementRemovedEvent& e)
+{
+  // the last particle gets moved into the slot of the dead one, so the indices of the last sort are wrong now
+  m_bSortOrderValid = false;
+}
+
+EZ_ALWAYS_INLINE ezUInt32 noRedirect(ezUInt32 uiIdx, const ezUInt32* pSortedIndices)
 {
   return uiIdx;
 }
 
-EZ_ALWAYS_INLINE ezUInt32 sortedRedirect(ezUInt32 uiIdx, const ezHybridArray<ezParticleTypeQuad::sod, 64>* pSorted)
+EZ_ALWAYS_INLINE ezUInt32 sortedRedirect(ezUInt32 uiIdx, const ezUInt32* pSortedIndices)
 {
-  return (*pSorted)[uiIdx].index;
+  return pSortedIndices[uiIdx];
 }
 
-void ezParticleTypeQuad::CreateExtractedData(const ezHybridArray<sod, 64>* pSorted) const
+void ezParticleTypeQuad::CreateExtractedData(const ezUInt32* pSortedIndices) const
 {
-  auto redirect = (pSorted != nullptr) ? sortedRedirect : noRedirect;
+  auto redirect = (pSortedIndices != nullptr) ? sortedRedirect : noRedirect;
 
   const ezUInt32 numParticles = (ezUInt32)GetOwnerSystem()->GetNumActiveParticles();
 
@@ -353,14 +411,14 @@ void ezParticleTypeQuad::CreateExtractedData(const ezHybridArray<sod, 64>* pSort
 
   for (ezUInt32 p = 0; p < numParticles; ++p)
   {
-    SetBaseData(p, redirect(p, pSorted));
+    SetBaseData(p, redirect(p, pSortedIndices));
   }
 
   if (bNeedsBillboardData)
   {
     for (ezUInt32 p = 0; p < numParticles; ++p)
     {
-      SetBillboardData(p, redirect(p, pSorted));
+      SetBillboardData(p, redirect(p, pSortedIndices));
     }
   }
 
@@ -370,35 +428,35 @@ void ezParticleTypeQuad::CreateExtractedData(const ezHybridArray<sod, 64>* pSort
     {
       for (ezUInt32 p = 0; p < numParticles; ++p)
       {
-        SetTangentDataEmitterDir(p, redirect(p, pSorted));
+        SetTangentDataEmitterDir(p, redirect(p, pSortedIndices));
       }
     }
     else if (m_Orientation == ezQuadParticleOrientation::Rotating_OrthoEmitterDir)
     {
       for (ezUInt32 p = 0; p < numParticles; ++p)
       {
-        SetTangentDataEmitterDirOrtho(p, redirect(p, pSorted));
+        SetTangentDataEmitterDirOrtho(p, redirect(p, pSortedIndices));
       }
     }
     else if (m_Orientation == ezQuadParticleOrientation::Fixed_EmitterDir || m_Orientation == ezQuadParticleOrientation::Fixed_RandomDir || m_Orientation == ezQuadParticleOrientation::Fixed_WorldUp)
     {
       for (ezUInt32 p = 0; p < numParticles; ++p)
       {
-        SetTangentDataFromAxis(p, redirect(p, pSorted));
+        SetTangentDataFromAxis(p, redirect(p, pSortedIndices));
       }
     }
     else if (m_Orientation == ezQuadParticleOrientation::FixedAxis_EmitterDir)
     {
       for (ezUInt32 p = 0; p < numParticles; ++p)
       {
-        SetTangentDataAligned_Emitter(p, redirect(p, pSorted));
+        SetTangentDataAligned_Emitter(p, redirect(p, pSortedIndices));
       }
     }
     else if (m_Orientation == ezQuadParticleOrientation::FixedAxis_ParticleDir)
     {
       for (ezUInt32 p = 0; p < numParticles; ++p)
       {
-        SetTangentDataAligned_ParticleDir(p, redirect(p, pSorted));
+        SetTangentDataAligned_ParticleDir(p, redirect(p, pSortedIndices));
       }
     }
     else
@@ -474,6 +532,9 @@ void ezParticleTypeQuad::AddParticleRenderData(ezMsgExtractRenderData& msg, cons
 
 void ezParticleTypeQuad::InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
+  // new particles are not part of the last sort
+  m_bSortOrderValid = false;
+
   if (m_pStreamAxis != nullptr)
   {
     ezVec3* pAxis = m_pStreamAxis->GetWritableData<ezVec3>();
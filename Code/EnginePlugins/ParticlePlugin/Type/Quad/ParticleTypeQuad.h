@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ParticlePlugin/Type/ParticleType.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
 #include <ParticlePlugin/Type/Quad/QuadParticleRenderer.h>
 #include <RendererFoundation/RendererFoundationDLL.h>
 
@@ -84,17 +85,26 @@ public:
   {
     EZ_DECLARE_POD_TYPE();
 
-    float dist;
+    ezUInt32 key; ///< Radix sort key of the squared distance to the camera, inverted to sort back to front
     ezUInt32 index;
   };
 
+  /// \brief Writes the indices of all \a positions to \a out_sortedIndices, sorted back to front as seen from \a vCameraPos.
+  ///
+  /// \a keys and \a scratch are temporary storage and must have the same size as \a positions.
+  static void SortBackToFront(ezArrayPtr<const ezSimdVec4f> positions, const ezVec3& vCameraPos, ezArrayPtr<sod> keys, ezArrayPtr<sod> scratch, ezDynamicArray<ezUInt32>& out_sortedIndices);
+
 
 protected:
+  friend class ezParticleTypeQuadFactory;
+
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
   virtual void Process(ezUInt64 uiNumElements) override {}
   void AllocateParticleData(const ezUInt32 numParticles, const bool bNeedsBillboardData, const bool bNeedsTangentData) const;
   void AddParticleRenderData(ezMsgExtractRenderData& msg, const ezTransform& instanceTransform) const;
-  void CreateExtractedData(const ezHybridArray<sod, 64>* pSorted) const;
+  void CreateExtractedData(const ezUInt32* pSortedIndices) const;
+  void SortParticles(const ezVec3& vCameraPos) const;
+  void OnParticleDeath(const ezStreamGroupElementRemovedEvent& e);
 
   ezProcessingStream* m_pStreamLifeTime = nullptr;
   ezProcessingStream* m_pStreamPosition = nullptr;
@@ -109,4 +119,10 @@ protected:
   mutable ezArrayPtr<ezBaseParticleShaderData> m_BaseParticleData;
   mutable ezArrayPtr<ezBillboardQuadParticleShaderData> m_BillboardParticleData;
   mutable ezArrayPtr<ezTangentQuadParticleShaderData> m_TangentParticleData;
+
+  // the back to front order of the last sort, which is reused while the camera doesn't move much
+  mutable ezDynamicArray<ezUInt32> m_SortedIndices;
+  mutable ezVec3 m_vLastSortCameraPos = ezVec3::MakeZero();
+  mutable ezUInt64 m_uiLastSortFrame = 0;
+  mutable bool m_bSortOrderValid = false; ///< Reset whenever particles spawn or die, since that changes which particle is at which index
 };
@@ -1,10 +1,14 @@
 #include <ParticlePlugin/ParticlePluginPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Utilities/Metrics.h>
 #include <ParticlePlugin/Resources/ParticleEffectResource.h>
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 
+static ezMetricCounter s_EffectUpdates("Particles/Effect Updates");
+static ezMetricCounter s_SimulatedParticles("Particles/Simulated Particles");
+
 ezParticleEffectHandle ezParticleWorldModule::InternalCreateEffectInstance(const ezParticleEffectResourceHandle& hResource, ezUInt64 uiRandomSeed,
   bool bIsShared, ezArrayPtr<ezParticleEffectFloatParam> floatParams, ezArrayPtr<ezParticleEffectColorParam> colorParams)
 {
@@ -139,12 +143,18 @@ void ezParticleWorldModule::UpdateEffects(const ezWorldModule::UpdateContext& co
 
   m_EffectUpdateTaskGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::LateThisFrame);
 
+  ezUInt32 uiNumUpdatedEffects = 0;
+  ezUInt64 uiNumParticles = 0;
+
   const ezTime tDiff = GetWorld()->GetClock().GetTimeDiff();
   for (ezUInt32 i = 0; i < m_ParticleEffects.GetCount(); ++i)
   {
     if (!m_ParticleEffects[i].ShouldBeUpdated())
       continue;
 
+    ++uiNumUpdatedEffects;
+    uiNumParticles += m_ParticleEffects[i].GetNumActiveParticles();
+
     m_ParticleEffects[i].ProcessEventQueues();
 
     const ezSharedPtr<ezTask>& pTask = m_ParticleEffects[i].GetUpdateTask();
@@ -154,6 +164,9 @@ void ezParticleWorldModule::UpdateEffects(const ezWorldModule::UpdateContext& co
   }
 
   ezTaskSystem::StartTaskGroup(m_EffectUpdateTaskGroup);
+
+  s_EffectUpdates.Add(uiNumUpdatedEffects);
+  s_SimulatedParticles.Add(static_cast<ezInt64>(uiNumParticles));
 }
 
 void ezParticleWorldModule::DestroyFinishedEffects()
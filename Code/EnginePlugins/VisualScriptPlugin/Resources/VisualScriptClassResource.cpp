@@ -44,6 +44,8 @@ ezResourceLoadDesc ezVisualScriptClassResource::UnloadData(Unload WhatToUnload)
   DeleteScriptType();
   DeleteAllScriptCoroutineTypes();
 
+  m_pParallelFunctions = nullptr;
+
   ezResourceLoadDesc ld;
   ld.m_State = ezResourceState::Unloaded;
   ld.m_uiQualityLevelsDiscardable = 0;
@@ -78,6 +80,7 @@ ezResourceLoadDesc ezVisualScriptClassResource::UpdateContent(ezStreamReader* pS
   const ezRTTI* pBaseClassType = nullptr;
   ezScriptRTTI::FunctionList functions;
   ezScriptRTTI::MessageHandlerList messageHandlers;
+  ezSharedPtr<ezVisualScriptParallelFunctions> pParallelFunctions = EZ_SCRIPT_NEW(ezVisualScriptParallelFunctions);
   {
     ezStringDeduplicationReadContext stringDedup(*pStream);
 
@@ -124,7 +127,14 @@ ezResourceLoadDesc ezVisualScriptClassResource::UpdateContent(ezStreamReader* pS
 
           if (functionType == ezVisualScriptNodeDescription::Type::EntryCall)
           {
+            const bool bCanExecuteInParallel = pDesc->CanExecuteInParallel();
+
             ezUniquePtr<ezVisualScriptFunctionProperty> pFunctionProperty = EZ_SCRIPT_NEW(ezVisualScriptFunctionProperty, sFunctionName, std::move(pDesc));
+            if (bCanExecuteInParallel)
+            {
+              pParallelFunctions->m_Content.Insert(pFunctionProperty.Borrow());
+            }
+
             functions.PushBack(std::move(pFunctionProperty));
           }
           else if (functionType == ezVisualScriptNodeDescription::Type::EntryCall_Coroutine)
@@ -189,6 +199,7 @@ ezResourceLoadDesc ezVisualScriptClassResource::UpdateContent(ezStreamReader* pS
   }
 
   CreateScriptType(sScriptClassName, pBaseClassType, std::move(functions), std::move(messageHandlers));
+  m_pParallelFunctions = pParallelFunctions;
 
   ld.m_State = ezResourceState::Loaded;
   return ld;
@@ -202,5 +213,5 @@ void ezVisualScriptClassResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUs
 
 ezUniquePtr<ezScriptInstance> ezVisualScriptClassResource::Instantiate(ezReflectedClass& inout_owner, ezWorld* pWorld) const
 {
-  return EZ_SCRIPT_NEW(ezVisualScriptInstance, inout_owner, pWorld, m_pConstantDataStorage, m_pInstanceDataDesc, m_pInstanceDataMapping);
+  return EZ_SCRIPT_NEW(ezVisualScriptInstance, inout_owner, pWorld, m_pConstantDataStorage, m_pInstanceDataDesc, m_pInstanceDataMapping, m_pParallelFunctions);
 }
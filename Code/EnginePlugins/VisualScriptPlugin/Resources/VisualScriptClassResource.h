@@ -1,7 +1,7 @@
 #pragma once
 
 #include <Core/Scripting/ScriptClassResource.h>
-#include <VisualScriptPlugin/Runtime/VisualScriptData.h>
+#include <VisualScriptPlugin/Runtime/VisualScriptInstance.h>
 
 class EZ_VISUALSCRIPTPLUGIN_DLL ezVisualScriptClassResource : public ezScriptClassResource
 {
@@ -22,4 +22,5 @@ private:
   ezSharedPtr<ezVisualScriptDataStorage> m_pConstantDataStorage;
   ezSharedPtr<const ezVisualScriptDataDescription> m_pInstanceDataDesc;
   ezSharedPtr<ezVisualScriptInstanceDataMapping> m_pInstanceDataMapping;
+  ezSharedPtr<ezVisualScriptParallelFunctions> m_pParallelFunctions;
 };
@@ -1,5 +1,6 @@
 #include <VisualScriptPlugin/VisualScriptPluginPCH.h>
 
+#include <Core/Scripting/ScriptAttributes.h>
 #include <Core/Scripting/ScriptWorldModule.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/IO/StringDeduplicationContext.h>
@@ -268,6 +269,65 @@ ezScriptMessageDesc ezVisualScriptGraphDescription::GetMessageDesc() const
   return desc;
 }
 
+bool ezVisualScriptGraphDescription::CanExecuteInParallel() const
+{
+  if (IsCoroutine())
+    return false;
+
+  // only nodes that are known to neither modify the world nor any shared state of the script world module are allowed
+  for (auto& node : m_Nodes)
+  {
+    switch (node.m_Type)
+    {
+      case ezVisualScriptNodeDescription::Type::EntryCall:
+      case ezVisualScriptNodeDescription::Type::GetReflectedProperty:
+      case ezVisualScriptNodeDescription::Type::GetScriptOwner:
+        break;
+
+      case ezVisualScriptNodeDescription::Type::ReflectedFunction:
+      {
+        // const functions are the ones that are executed implicitly in visual scripts, since they don't have side effects
+        auto& userData = node.GetUserData<NodeUserData_TypeAndProperty>();
+        if (userData.m_pProperty->GetFlags().IsSet(ezPropertyFlags::Const) == false &&
+            userData.m_pProperty->GetAttributeByType<ezScriptThreadSafeAttribute>() == nullptr &&
+            userData.m_pType->GetAttributeByType<ezScriptThreadSafeAttribute>() == nullptr)
+        {
+          return false;
+        }
+        break;
+      }
+
+      case ezVisualScriptNodeDescription::Type::SendMessage:
+      {
+        // messages are only queued while executing in parallel, so there is no way to get the outputs of a query
+        for (ezUInt32 i = 0; i < node.m_NumOutputDataOffsets; ++i)
+        {
+          if (node.GetOutputDataOffset(i).IsValid())
+            return false;
+        }
+        break;
+      }
+
+      case ezVisualScriptNodeDescription::Type::Builtin_Expression:
+      case ezVisualScriptNodeDescription::Type::Builtin_StartCoroutine:
+      case ezVisualScriptNodeDescription::Type::Builtin_StopCoroutine:
+      case ezVisualScriptNodeDescription::Type::Builtin_StopAllCoroutines:
+      case ezVisualScriptNodeDescription::Type::Builtin_WaitForAll:
+      case ezVisualScriptNodeDescription::Type::Builtin_WaitForAny:
+      case ezVisualScriptNodeDescription::Type::Builtin_Yield:
+        return false;
+
+      default:
+        // all other builtin nodes only work on the data of the script instance
+        if (ezVisualScriptNodeDescription::Type::IsBuiltin(node.m_Type) == false)
+          return false;
+        break;
+    }
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 ezCVarInt cvar_MaxNodeExecutions("VisualScript.MaxNodeExecutions", 100000, ezCVarFlags::Default, "The maximum number of nodes executed within a script invocation");
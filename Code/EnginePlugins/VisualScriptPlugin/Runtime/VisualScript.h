@@ -220,6 +220,13 @@ public:
   bool IsCoroutine() const;
   ezScriptMessageDesc GetMessageDesc() const;
 
+  /// \brief Returns whether this graph can be executed concurrently on multiple instances.
+  ///
+  /// This is only the case if the graph contains no nodes that can modify the world, like setting properties or calling non-const functions,
+  /// and no nodes that access shared state of the script world module, like coroutines or expressions.
+  /// Functions that are marked with ezScriptThreadSafeAttribute are allowed as well.
+  bool CanExecuteInParallel() const;
+
   const ezSharedPtr<const ezVisualScriptDataDescription>& GetLocalDataDesc() const;
 
 private:
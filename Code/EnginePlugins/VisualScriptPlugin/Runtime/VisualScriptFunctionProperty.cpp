@@ -22,15 +22,50 @@ void ezVisualScriptFunctionProperty::Execute(void* pInstance, ezArrayPtr<ezVaria
   EZ_ASSERT_DEBUG(pInstance != nullptr, "Invalid instance");
   auto pVisualScriptInstance = static_cast<ezVisualScriptInstance*>(pInstance);
 
+  ezUniquePtr<ezVisualScriptDataStorage> pParallelLocalDataStorage;
+  if (ezScriptWorldModule::IsExecutingInParallel())
+  {
+    pParallelLocalDataStorage = AcquireParallelLocalDataStorage();
+  }
+
   ezVisualScriptExecutionContext context(m_pDesc);
-  context.Initialize(*pVisualScriptInstance, m_LocalDataStorage, arguments);
+  context.Initialize(*pVisualScriptInstance, pParallelLocalDataStorage != nullptr ? *pParallelLocalDataStorage : m_LocalDataStorage, arguments);
 
   auto result = context.Execute(ezTime::MakeZero());
   EZ_ASSERT_DEBUG(result.m_NextExecAndState != ezVisualScriptExecutionContext::ExecResult::State::ContinueLater, "A non-coroutine function must not return 'ContinueLater'");
 
+  if (pParallelLocalDataStorage != nullptr)
+  {
+    ReleaseParallelLocalDataStorage(std::move(pParallelLocalDataStorage));
+  }
+
   // TODO: return value
 }
 
+ezUniquePtr<ezVisualScriptDataStorage> ezVisualScriptFunctionProperty::AcquireParallelLocalDataStorage() const
+{
+  {
+    EZ_LOCK(m_ParallelLocalDataStoragesMutex);
+
+    if (m_ParallelLocalDataStorages.IsEmpty() == false)
+    {
+      ezUniquePtr<ezVisualScriptDataStorage> pLocalDataStorage = std::move(m_ParallelLocalDataStorages.PeekBack());
+      m_ParallelLocalDataStorages.PopBack();
+      return pLocalDataStorage;
+    }
+  }
+
+  ezUniquePtr<ezVisualScriptDataStorage> pLocalDataStorage = EZ_SCRIPT_NEW(ezVisualScriptDataStorage, m_pDesc->GetLocalDataDesc());
+  pLocalDataStorage->AllocateStorage();
+  return pLocalDataStorage;
+}
+
+void ezVisualScriptFunctionProperty::ReleaseParallelLocalDataStorage(ezUniquePtr<ezVisualScriptDataStorage>&& pLocalDataStorage) const
+{
+  EZ_LOCK(m_ParallelLocalDataStoragesMutex);
+  m_ParallelLocalDataStorages.PushBack(std::move(pLocalDataStorage));
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 ezVisualScriptMessageHandler::ezVisualScriptMessageHandler(const ezScriptMessageDesc& desc, const ezSharedPtr<const ezVisualScriptGraphDescription>& pDesc)
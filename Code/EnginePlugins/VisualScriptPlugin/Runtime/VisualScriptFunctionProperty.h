@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Threading/Mutex.h>
 #include <VisualScriptPlugin/Runtime/VisualScript.h>
 
 class EZ_VISUALSCRIPTPLUGIN_DLL ezVisualScriptFunctionProperty : public ezScriptFunctionProperty
@@ -18,8 +19,15 @@ public:
   virtual void Execute(void* pInstance, ezArrayPtr<ezVariant> arguments, ezVariant& out_returnValue) const override;
 
 private:
+  ezUniquePtr<ezVisualScriptDataStorage> AcquireParallelLocalDataStorage() const;
+  void ReleaseParallelLocalDataStorage(ezUniquePtr<ezVisualScriptDataStorage>&& pLocalDataStorage) const;
+
   ezSharedPtr<const ezVisualScriptGraphDescription> m_pDesc;
   mutable ezVisualScriptDataStorage m_LocalDataStorage;
+
+  // the shared local data storage can't be used when multiple instances execute this function concurrently
+  mutable ezMutex m_ParallelLocalDataStoragesMutex;
+  mutable ezDynamicArray<ezUniquePtr<ezVisualScriptDataStorage>> m_ParallelLocalDataStorages;
 };
 
 class EZ_VISUALSCRIPTPLUGIN_DLL ezVisualScriptMessageHandler : public ezScriptMessageHandler
@@ -2,10 +2,11 @@
 
 #include <VisualScriptPlugin/Runtime/VisualScriptInstance.h>
 
-ezVisualScriptInstance::ezVisualScriptInstance(ezReflectedClass& inout_owner, ezWorld* pWorld, const ezSharedPtr<ezVisualScriptDataStorage>& pConstantDataStorage, const ezSharedPtr<const ezVisualScriptDataDescription>& pInstanceDataDesc, const ezSharedPtr<ezVisualScriptInstanceDataMapping>& pInstanceDataMapping)
+ezVisualScriptInstance::ezVisualScriptInstance(ezReflectedClass& inout_owner, ezWorld* pWorld, const ezSharedPtr<ezVisualScriptDataStorage>& pConstantDataStorage, const ezSharedPtr<const ezVisualScriptDataDescription>& pInstanceDataDesc, const ezSharedPtr<ezVisualScriptInstanceDataMapping>& pInstanceDataMapping, const ezSharedPtr<const ezVisualScriptParallelFunctions>& pParallelFunctions)
   : ezScriptInstance(inout_owner, pWorld)
   , m_pConstantDataStorage(pConstantDataStorage)
   , m_pInstanceDataMapping(pInstanceDataMapping)
+  , m_pParallelFunctions(pParallelFunctions)
 {
   if (pInstanceDataDesc != nullptr)
   {
@@ -53,3 +54,8 @@ ezVariant ezVisualScriptInstance::GetInstanceVariable(const ezHashedString& sNam
 
   return m_pInstanceDataStorage->GetDataAsVariant(pInstanceData->m_DataOffset, nullptr, 0);
 }
+
+bool ezVisualScriptInstance::CanUpdateInParallel(const ezAbstractFunctionProperty* pUpdateFunction) const
+{
+  return m_pParallelFunctions != nullptr && m_pParallelFunctions->m_Content.Contains(pUpdateFunction);
+}
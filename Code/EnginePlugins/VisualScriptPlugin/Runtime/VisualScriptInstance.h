@@ -4,14 +4,19 @@
 #include <Foundation/Containers/Blob.h>
 #include <VisualScriptPlugin/Runtime/VisualScript.h>
 
+/// \brief The set of script functions whose graphs can be executed concurrently on multiple instances.
+using ezVisualScriptParallelFunctions = ezRefCountedContainer<ezHashSet<const ezAbstractFunctionProperty*>>;
+
 class EZ_VISUALSCRIPTPLUGIN_DLL ezVisualScriptInstance : public ezScriptInstance
 {
 public:
-  ezVisualScriptInstance(ezReflectedClass& inout_owner, ezWorld* pWorld, const ezSharedPtr<ezVisualScriptDataStorage>& pConstantDataStorage, const ezSharedPtr<const ezVisualScriptDataDescription>& pInstanceDataDesc, const ezSharedPtr<ezVisualScriptInstanceDataMapping>& pInstanceDataMapping);
+  ezVisualScriptInstance(ezReflectedClass& inout_owner, ezWorld* pWorld, const ezSharedPtr<ezVisualScriptDataStorage>& pConstantDataStorage, const ezSharedPtr<const ezVisualScriptDataDescription>& pInstanceDataDesc, const ezSharedPtr<ezVisualScriptInstanceDataMapping>& pInstanceDataMapping, const ezSharedPtr<const ezVisualScriptParallelFunctions>& pParallelFunctions);
 
   virtual void SetInstanceVariable(const ezHashedString& sName, const ezVariant& value) override;
   virtual ezVariant GetInstanceVariable(const ezHashedString& sName) override;
 
+  virtual bool CanUpdateInParallel(const ezAbstractFunctionProperty* pUpdateFunction) const override;
+
   ezVisualScriptDataStorage* GetConstantDataStorage() { return m_pConstantDataStorage.Borrow(); }
   ezVisualScriptDataStorage* GetInstanceDataStorage() { return m_pInstanceDataStorage.Borrow(); }
 
@@ -19,4 +24,5 @@ private:
   ezSharedPtr<ezVisualScriptDataStorage> m_pConstantDataStorage;
   ezUniquePtr<ezVisualScriptDataStorage> m_pInstanceDataStorage;
   ezSharedPtr<ezVisualScriptInstanceDataMapping> m_pInstanceDataMapping;
+  ezSharedPtr<const ezVisualScriptParallelFunctions> m_pParallelFunctions;
 };
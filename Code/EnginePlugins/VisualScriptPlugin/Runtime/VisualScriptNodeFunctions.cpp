@@ -334,12 +334,30 @@ namespace
       }
     }
 
+    // while scripts are updated in parallel the world must not be modified directly,
+    // so messages are queued and delivered right after the async phase instead
+    const bool bPostMessage = delay.IsPositive() || ezScriptWorldModule::IsExecutingInParallel();
+    const ezObjectMsgQueueType::Enum queueType = delay.IsPositive() ? ezObjectMsgQueueType::NextFrame : ezObjectMsgQueueType::PostAsync;
+
+    if (bPostMessage && delay.IsPositive() == false)
+    {
+      // a queued message can't write back its results, so a query has to be sent directly
+      for (ezUInt32 i = 0; i < userData.m_uiNumProperties; ++i)
+      {
+        if (node.GetOutputDataOffset(i).IsValid())
+        {
+          ezLog::Error("Visual script send '{}': Messages with outputs can't be sent while the script is updated in parallel.", userData.m_pType->GetTypeName());
+          return ExecResult::Error();
+        }
+      }
+    }
+
     bool bWriteOutputs = false;
     if (pTargetComponent != nullptr)
     {
-      if (delay.IsPositive())
+      if (bPostMessage)
       {
-        pTargetComponent->PostMessage(*pMessage, delay);
+        pTargetComponent->PostMessage(*pMessage, delay, queueType);
       }
       else
       {
@@ -348,14 +366,14 @@ namespace
     }
     else if (pTargetObject != nullptr)
     {
-      if (delay.IsPositive())
+      if (bPostMessage)
       {
         if (mode == ezVisualScriptSendMessageMode::Direct)
-          pTargetObject->PostMessage(*pMessage, delay);
+          pTargetObject->PostMessage(*pMessage, delay, queueType);
         else if (mode == ezVisualScriptSendMessageMode::Recursive)
-          pTargetObject->PostMessageRecursive(*pMessage, delay);
+          pTargetObject->PostMessageRecursive(*pMessage, delay, queueType);
         else
-          pTargetObject->PostEventMessage(*pMessage, pSenderComponent, delay);
+          pTargetObject->PostEventMessage(*pMessage, pSenderComponent, delay, queueType);
       }
       else
       {
@@ -85,6 +85,11 @@ Example:\n\
 ",
   "");
 
+ezCommandLineOptionBool opt_Dictionaries("_ArchiveTool", "-dictionaries", "\
+When packing, compresses small files with dictionaries that are shared by all files of the same type.\n\
+This reduces the archive size considerably, if it contains many small files.\n\
+", false);
+
 ezCommandLineOptionDoc opt_Desc("_ArchiveTool", "Description:", "", "\
 -pack and -unpack can take multiple inputs to either aggregate multiple folders into one archive (pack)\n\
 or to unpack multiple archives at the same time.\n\
@@ -118,6 +123,18 @@ protected:
     const ezUInt64 uiPercentage = (uiSourceSize == 0) ? 100 : (uiStoredSize * 100 / uiSourceSize);
     ezLog::Info(" [{}%%] {} ({}%%) - {}", ezArgU(100 * uiCurEntry / uiMaxEntries, 2), sSourceFile, uiPercentage, duration);
   }
+
+  virtual void WriteFileDeduplicatedCallback(ezUInt32 uiCurEntry, ezUInt32 uiMaxEntries, ezStringView sSourceFile, ezStringView sDuplicateOfFile, ezUInt64 uiSourceSize, ezUInt64 uiStoredSize) const override
+  {
+    ++m_uiNumDeduplicatedFiles;
+    m_uiDeduplicatedBytes += uiStoredSize;
+
+    ezLog::Info(" [{}%%] {} (duplicate of {})", ezArgU(100 * uiCurEntry / uiMaxEntries, 2), sSourceFile, sDuplicateOfFile);
+  }
+
+public:
+  mutable ezUInt32 m_uiNumDeduplicatedFiles = 0;
+  mutable ezUInt64 m_uiDeduplicatedBytes = 0;
 };
 
 class ezArchiveReaderImpl : public ezArchiveReader
@@ -227,7 +244,8 @@ public:
       {
         const ezStringView sArg = GetArgument(a);
 
-        if (sArg.IsEqual_NoCase("-out"))
+        // options follow the inputs
+        if (sArg.StartsWith("-"))
           break;
 
         m_sInputs.PushBack(ezOSFile::MakePathAbsoluteWithCWD(sArg));
@@ -298,8 +316,9 @@ public:
     if (ext.IsEqual_NoCase("mp3") || ext.IsEqual_NoCase("ogg"))
       return ezArchiveBuilder::InclusionMode::Uncompressed;
 
+    // textures are often streamed partially (e.g. only the small mips)
     if (ext.IsEqual_NoCase("dds"))
-      return ezArchiveBuilder::InclusionMode::Compress_zstd_fast;
+      return ezArchiveBuilder::InclusionMode::Compress_zstd_seekable;
 
     return ezArchiveBuilder::InclusionMode::Compress_zstd_average;
   }
@@ -307,6 +326,7 @@ public:
   ezResult Pack()
   {
     ezArchiveBuilderImpl archive;
+    archive.m_bUseCompressionDictionaries = opt_Dictionaries.GetOptionValue(ezCommandLineOption::LogMode::Always);
 
     for (const auto& folder : m_sInputs)
     {
@@ -331,6 +351,11 @@ public:
       return EZ_FAILURE;
     }
 
+    if (archive.m_uiNumDeduplicatedFiles > 0)
+    {
+      ezLog::Info("Deduplication: {} files were stored only once, saving {}", archive.m_uiNumDeduplicatedFiles, ezArgFileSize(archive.m_uiDeduplicatedBytes));
+    }
+
     return EZ_SUCCESS;
   }
 
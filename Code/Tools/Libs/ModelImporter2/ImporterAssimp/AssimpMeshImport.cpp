@@ -639,6 +639,105 @@ namespace ezModelImporter2
     return EZ_SUCCESS;
   }
 
+  ezResult ImporterAssimp::OptimizeOutputMesh()
+  {
+    auto& md = m_Options.m_pMeshOutput->MeshBufferDesc();
+
+    if (md.GetVertexCount() == 0)
+      return EZ_SUCCESS;
+
+    if (!md.HasIndexBuffer() || md.GetTopology() != ezGALPrimitiveTopology::Triangles)
+      return EZ_FAILURE;
+
+    const ezUInt32 uiNumVertices = md.GetVertexCount();
+    const ezUInt32 uiNumPrimitives = md.GetPrimitiveCount();
+    const ezUInt32 uiNumIndices = uiNumPrimitives * 3;
+    const ezUInt32 uiVertexSize = md.GetVertexDataSize();
+
+    const float* pPositions = nullptr;
+    for (ezUInt32 i = 0; i < md.GetVertexDeclaration().m_VertexStreams.GetCount(); ++i)
+    {
+      const auto& stream = md.GetVertexDeclaration().m_VertexStreams[i];
+
+      if (stream.m_Semantic == ezGALVertexAttributeSemantic::Position && stream.m_Format == ezGALResourceFormat::XYZFloat)
+      {
+        pPositions = reinterpret_cast<const float*>(md.GetVertexData(i, 0).GetPtr());
+      }
+    }
+
+    if (pPositions == nullptr)
+      return EZ_FAILURE;
+
+    // the vertex size is also the stride of the positions, meshoptimizer requires it to be a multiple of 4 bytes and at most 256 bytes
+    if ((uiVertexSize % 4) != 0 || uiVertexSize < sizeof(ezVec3) || uiVertexSize > 256)
+    {
+      ezLog::Dev("Skipping mesh optimization, vertex size {} is not supported.", uiVertexSize);
+      return EZ_SUCCESS;
+    }
+
+    // the optimizers work on 32 bit indices
+    ezDynamicArray<ezUInt32> indices;
+    indices.SetCountUninitialized(uiNumIndices);
+
+    if (md.Uses32BitIndices())
+    {
+      ezMemoryUtils::Copy(indices.GetData(), reinterpret_cast<const ezUInt32*>(md.GetIndexBufferData().GetData()), uiNumIndices);
+    }
+    else
+    {
+      const ezUInt16* pIndices16 = reinterpret_cast<const ezUInt16*>(md.GetIndexBufferData().GetData());
+      for (ezUInt32 i = 0; i < uiNumIndices; ++i)
+      {
+        indices[i] = pIndices16[i];
+      }
+    }
+
+    const float fAcmrBefore = meshopt_analyzeVertexCache(indices.GetData(), uiNumIndices, uiNumVertices, 16, 0, 0).acmr;
+
+    // every sub-mesh is a separate draw call, so triangles must not be moved across sub-mesh boundaries
+    ezDynamicArray<ezUInt32> tmpIndices;
+    tmpIndices.SetCountUninitialized(uiNumIndices);
+
+    for (const auto& subMesh : m_Options.m_pMeshOutput->GetSubMeshes())
+    {
+      const ezUInt32 uiFirstIndex = subMesh.m_uiFirstPrimitive * 3;
+      const ezUInt32 uiIndexCount = subMesh.m_uiPrimitiveCount * 3;
+
+      if (uiFirstIndex + uiIndexCount > uiNumIndices)
+        return EZ_FAILURE;
+
+      meshopt_optimizeVertexCache(tmpIndices.GetData() + uiFirstIndex, indices.GetData() + uiFirstIndex, uiIndexCount, uiNumVertices);
+      meshopt_optimizeOverdraw(indices.GetData() + uiFirstIndex, tmpIndices.GetData() + uiFirstIndex, uiIndexCount, pPositions, uiNumVertices, uiVertexSize, 1.05f);
+    }
+
+    const float fAcmrAfter = meshopt_analyzeVertexCache(indices.GetData(), uiNumIndices, uiNumVertices, 16, 0, 0).acmr;
+
+    // sort the vertices by first use, this also improves the compression of the vertex stream
+    auto& vertexData = md.GetVertexBufferData();
+    const ezUInt32 uiUsedVertices = static_cast<ezUInt32>(meshopt_optimizeVertexFetch(vertexData.GetData(), indices.GetData(), uiNumIndices, vertexData.GetData(), uiNumVertices, uiVertexSize));
+
+    // unreferenced vertices end up at the end, shrinking the streams drops them and keeps the sorted vertices in front
+    // this can switch the index buffer to 16 bit indices, so the indices are only written back afterwards
+    md.AllocateStreams(uiUsedVertices, ezGALPrimitiveTopology::Triangles, uiNumPrimitives);
+
+    if (md.Uses32BitIndices())
+    {
+      ezMemoryUtils::Copy(reinterpret_cast<ezUInt32*>(md.GetIndexBufferData().GetData()), indices.GetData(), uiNumIndices);
+    }
+    else
+    {
+      ezUInt16* pIndices16 = reinterpret_cast<ezUInt16*>(md.GetIndexBufferData().GetData());
+      for (ezUInt32 i = 0; i < uiNumIndices; ++i)
+      {
+        pIndices16[i] = static_cast<ezUInt16>(indices[i]);
+      }
+    }
+
+    ezLog::Dev("Optimized mesh for rendering: ACMR {} -> {}, vertices {} -> {}", ezArgF(fAcmrBefore, 3), ezArgF(fAcmrAfter, 3), uiNumVertices, uiUsedVertices);
+
+    return EZ_SUCCESS;
+  }
+
   ezResult ImporterAssimp::PrepareOutputMesh()
   {
     if (m_Options.m_pMeshOutput == nullptr)
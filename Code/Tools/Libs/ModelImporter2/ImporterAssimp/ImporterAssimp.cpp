@@ -130,6 +130,12 @@ namespace ezModelImporter2
           // do not return failure here, because we can still continue
         }
       }
+
+      // reorders triangles and vertices for better GPU cache usage and stream compression, and drops unreferenced vertices
+      if (OptimizeOutputMesh().Failed())
+      {
+        ezLog::Warning("Optimizing the mesh for rendering failed.");
+      }
     }
 
     if (m_pScene->mNumTextures > 0 && m_pScene->mTextures)
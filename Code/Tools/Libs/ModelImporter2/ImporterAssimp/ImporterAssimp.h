@@ -24,6 +24,7 @@ namespace ezModelImporter2
 
     ezResult PrepareOutputMesh();
     ezResult RecomputeTangents();
+    ezResult OptimizeOutputMesh();
 
     ezResult TraverseAiNode(aiNode* pNode, const ezMat4& parentTransform, ezEditableSkeletonJoint* pCurJoint);
     ezResult ProcessAiMesh(aiMesh* pMesh, const ezMat4& transform);
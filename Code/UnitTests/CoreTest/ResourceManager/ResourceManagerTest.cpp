@@ -1,6 +1,7 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Types/ScopeExit.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
@@ -286,3 +287,61 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, LoaderFromFile)
+{
+  const ezStringBuilder sOutputDir = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  if (!EZ_TEST_RESULT(ezFileSystem::AddDataDirectory(sOutputDir, "LoaderFromFileTest", "loadertest", ezFileSystem::AllowWrites)))
+    return;
+
+  EZ_SCOPE_EXIT(ezFileSystem::RemoveDataDirectoryGroup("LoaderFromFileTest"));
+
+  // large enough to be read in several chunks through the async file reader, with an incomplete last chunk
+  const ezUInt32 uiNumElements = 1024 * 1024 + 17;
+
+  {
+    ezFileWriter file;
+    if (!EZ_TEST_RESULT(file.Open(":loadertest/LoaderFromFile.dat")))
+      return;
+
+    for (ezUInt32 i = 0; i < uiNumElements; ++i)
+    {
+      file << i;
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "OpenDataStream")
+  {
+    TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>(":loadertest/LoaderFromFile.dat");
+
+    {
+      ezResourceLock<TestResource> pResource(hResource, ezResourceAcquireMode::PointerOnly);
+
+      ezResourceLoaderFromFile loader;
+      ezResourceLoadData data = loader.OpenDataStream(pResource.GetPointer());
+
+      if (EZ_TEST_BOOL(data.m_pDataStream != nullptr))
+      {
+        ezStringBuilder sAbsolutePath;
+        *data.m_pDataStream >> sAbsolutePath;
+        EZ_TEST_BOOL(sAbsolutePath.EndsWith("LoaderFromFile.dat"));
+
+        bool bAllEqual = true;
+        for (ezUInt32 i = 0; i < uiNumElements; ++i)
+        {
+          ezUInt32 uiValue = 0;
+          *data.m_pDataStream >> uiValue;
+          bAllEqual = bAllEqual && (uiValue == i);
+        }
+
+        EZ_TEST_BOOL(bAllEqual);
+        EZ_TEST_INT(data.m_pDataStream->SkipBytes(1), 0);
+
+        loader.CloseDataStream(pResource.GetPointer(), data);
+      }
+    }
+
+    hResource.Invalidate();
+    ezResourceManager::FreeAllUnusedResources();
+  }
+}
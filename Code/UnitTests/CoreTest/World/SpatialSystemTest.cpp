@@ -1,7 +1,10 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_DynamicBVH.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
@@ -56,266 +59,436 @@ namespace
   }
   EZ_END_COMPONENT_TYPE;
   // clang-format on
-} // namespace
 
-EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
-{
-  ezWorldDesc worldDesc("Test");
-  worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  void TestSpatialSystem(ezUniquePtr<ezSpatialSystem>&& pSpatialSystem)
+  {
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+    worldDesc.m_pSpatialSystem = std::move(pSpatialSystem);
 
-  ezWorld world(worldDesc);
-  EZ_LOCK(world.GetWriteMarker());
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
 
-  auto& rng = world.GetRandomNumberGenerator();
+    auto& rng = world.GetRandomNumberGenerator();
 
-  ezDynamicArray<ezGameObject*> objects;
-  objects.Reserve(1000);
+    ezDynamicArray<ezGameObject*> objects;
+    objects.Reserve(1000);
 
-  for (ezUInt32 i = 0; i < 1000; ++i)
-  {
-    constexpr const double range = 10000.0;
+    for (ezUInt32 i = 0; i < 1000; ++i)
+    {
+      constexpr const double range = 10000.0;
 
-    float x = (float)rng.DoubleMinMax(-range, range);
-    float y = (float)rng.DoubleMinMax(-range, range);
-    float z = (float)rng.DoubleMinMax(-range, range);
+      float x = (float)rng.DoubleMinMax(-range, range);
+      float y = (float)rng.DoubleMinMax(-range, range);
+      float z = (float)rng.DoubleMinMax(-range, range);
 
-    ezGameObjectDesc desc;
-    desc.m_bDynamic = (i >= 500);
-    desc.m_LocalPosition = ezVec3(x, y, z);
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = (i >= 500);
+      desc.m_LocalPosition = ezVec3(x, y, z);
 
-    ezGameObject* pObject = nullptr;
-    world.CreateObject(desc, pObject);
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
 
-    objects.PushBack(pObject);
+      objects.PushBack(pObject);
 
-    TestBoundsComponent* pComponent = nullptr;
-    TestBoundsComponent::CreateComponent(pObject, pComponent);
-  }
+      TestBoundsComponent* pComponent = nullptr;
+      TestBoundsComponent::CreateComponent(pObject, pComponent);
+    }
 
-  world.Update();
+    world.Update();
 
-  ezSpatialSystem::QueryParams queryParams;
-  queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
 
-  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInSphere")
-  {
-    ezBoundingSphere testSphere = ezBoundingSphere::MakeFromCenterAndRadius(ezVec3(100.0f, 60.0f, 400.0f), 3000.0f);
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInSphere")
+    {
+      ezBoundingSphere testSphere = ezBoundingSphere::MakeFromCenterAndRadius(ezVec3(100.0f, 60.0f, 400.0f), 3000.0f);
 
-    ezDynamicArray<ezGameObject*> objectsInSphere;
-    ezHashSet<ezGameObject*> uniqueObjects;
-    world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, objectsInSphere);
+      ezDynamicArray<ezGameObject*> objectsInSphere;
+      ezHashSet<ezGameObject*> uniqueObjects;
+      world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, objectsInSphere);
 
-    for (auto pObject : objectsInSphere)
-    {
-      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+      for (auto pObject : objectsInSphere)
+      {
+        ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
 
-      EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
-      EZ_TEST_BOOL(pObject->IsStatic());
-    }
+        EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        EZ_TEST_BOOL(pObject->IsStatic());
+      }
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
-    {
-      ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
-      if (testSphere.Overlaps(objSphere))
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
       {
-        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains((ezGameObject*)it));
+        ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
+        if (testSphere.Overlaps(objSphere))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains((ezGameObject*)it));
+        }
       }
-    }
 
-    objectsInSphere.Clear();
-    uniqueObjects.Clear();
+      objectsInSphere.Clear();
+      uniqueObjects.Clear();
 
-    world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, [&](ezGameObject* pObject)
-      {
-      objectsInSphere.PushBack(pObject);
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, [&](ezGameObject* pObject)
+        {
+        objectsInSphere.PushBack(pObject);
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
 
-      return ezVisitorExecution::Continue; });
+        return ezVisitorExecution::Continue; });
 
-    for (auto pObject : objectsInSphere)
-    {
-      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+      for (auto pObject : objectsInSphere)
+      {
+        ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+
+        EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
+        EZ_TEST_BOOL(pObject->IsStatic());
+      }
 
-      EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
-      EZ_TEST_BOOL(pObject->IsStatic());
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
+        if (testSphere.Overlaps(objSphere))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains((ezGameObject*)it));
+        }
+      }
     }
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInBox")
     {
-      ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
-      if (testSphere.Overlaps(objSphere))
+      ezBoundingBox testBox = ezBoundingBox::MakeFromCenterAndHalfExtents(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(3000.0f));
+
+      ezDynamicArray<ezGameObject*> objectsInBox;
+      ezHashSet<ezGameObject*> uniqueObjects;
+      world.GetSpatialSystem()->FindObjectsInBox(testBox, queryParams, objectsInBox);
+
+      for (auto pObject : objectsInBox)
       {
-        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains((ezGameObject*)it));
+        ezBoundingBox objBox = pObject->GetGlobalBounds().GetBox();
+
+        EZ_TEST_BOOL(testBox.Overlaps(objBox));
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        EZ_TEST_BOOL(pObject->IsStatic());
       }
-    }
-  }
 
-  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInBox")
-  {
-    ezBoundingBox testBox = ezBoundingBox::MakeFromCenterAndHalfExtents(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(3000.0f));
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
+        if (testBox.Overlaps(objBox))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains((ezGameObject*)it));
+        }
+      }
 
-    ezDynamicArray<ezGameObject*> objectsInBox;
-    ezHashSet<ezGameObject*> uniqueObjects;
-    world.GetSpatialSystem()->FindObjectsInBox(testBox, queryParams, objectsInBox);
+      objectsInBox.Clear();
+      uniqueObjects.Clear();
 
-    for (auto pObject : objectsInBox)
-    {
-      ezBoundingBox objBox = pObject->GetGlobalBounds().GetBox();
+      world.GetSpatialSystem()->FindObjectsInBox(testBox, queryParams, [&](ezGameObject* pObject)
+        {
+        objectsInBox.PushBack(pObject);
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
 
-      EZ_TEST_BOOL(testBox.Overlaps(objBox));
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
-      EZ_TEST_BOOL(pObject->IsStatic());
-    }
+        return ezVisitorExecution::Continue; });
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
-    {
-      ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
-      if (testBox.Overlaps(objBox))
+      for (auto pObject : objectsInBox)
       {
-        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains((ezGameObject*)it));
+        ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+
+        EZ_TEST_BOOL(testBox.Overlaps(objSphere));
+        EZ_TEST_BOOL(pObject->IsStatic());
+      }
+
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
+        if (testBox.Overlaps(objBox))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains((ezGameObject*)it));
+        }
       }
     }
 
-    objectsInBox.Clear();
-    uniqueObjects.Clear();
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
+    {
+      constexpr uint32_t numUpdates = 13;
 
-    world.GetSpatialSystem()->FindObjectsInBox(testBox, queryParams, [&](ezGameObject* pObject)
+      // update a few times to increase internal frame counter
+      for (uint32_t i = 0; i < numUpdates; ++i)
       {
-      objectsInBox.PushBack(pObject);
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        world.Update();
+      }
 
-      return ezVisitorExecution::Continue; });
+      queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
 
-    for (auto pObject : objectsInBox)
-    {
-      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+      ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::MakeZero(), ezVec3::MakeAxisX(), ezVec3::MakeAxisZ());
+      ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::MakeFromDegree(80.0f), 1.0f, 1.0f, 10000.0f);
 
-      EZ_TEST_BOOL(testBox.Overlaps(objSphere));
-      EZ_TEST_BOOL(pObject->IsStatic());
-    }
+      ezFrustum testFrustum = ezFrustum::MakeFromMVP(projection * lookAt);
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
-    {
-      ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
-      if (testBox.Overlaps(objBox))
+      ezDynamicArray<const ezGameObject*> visibleObjects;
+      ezHashSet<const ezGameObject*> uniqueObjects;
+      world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, visibleObjects, {}, ezVisibilityState::Direct);
+
+      EZ_TEST_BOOL(!visibleObjects.IsEmpty());
+
+      for (auto pObject : visibleObjects)
       {
-        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains((ezGameObject*)it));
+        EZ_TEST_BOOL(testFrustum.Overlaps(pObject->GetGlobalBoundsSimd().GetSphere()));
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        EZ_TEST_BOOL(pObject->IsDynamic());
+
+        ezVisibilityState visType = pObject->GetVisibilityState();
+        EZ_TEST_BOOL(visType == ezVisibilityState::Direct);
       }
-    }
-  }
 
-  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
-  {
-    constexpr uint32_t numUpdates = 13;
+      // Distributing the query across the task system has to give the same result as the serial one
+      {
+        ezCVarInt* pParallelBinSize = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("Spatial.Queries.ParallelBinSize"));
+        EZ_TEST_BOOL(pParallelBinSize != nullptr);
 
-    // update a few times to increase internal frame counter
-    for (uint32_t i = 0; i < numUpdates; ++i)
-    {
-      world.Update();
-    }
+        const ezInt32 iOldBinSize = pParallelBinSize->GetValue();
+        *pParallelBinSize = 0;
 
-    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+        ezDynamicArray<const ezGameObject*> serialVisibleObjects;
+        world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, serialVisibleObjects, {}, ezVisibilityState::Direct);
 
-    ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::MakeZero(), ezVec3::MakeAxisX(), ezVec3::MakeAxisZ());
-    ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::MakeFromDegree(80.0f), 1.0f, 1.0f, 10000.0f);
+        *pParallelBinSize = 1;
 
-    ezFrustum testFrustum = ezFrustum::MakeFromMVP(projection * lookAt);
+        ezDynamicArray<const ezGameObject*> parallelVisibleObjects;
+        world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, parallelVisibleObjects, {}, ezVisibilityState::Direct);
 
-    ezDynamicArray<const ezGameObject*> visibleObjects;
-    ezHashSet<const ezGameObject*> uniqueObjects;
-    world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, visibleObjects, {}, ezVisibilityState::Direct);
+        *pParallelBinSize = iOldBinSize;
 
-    EZ_TEST_BOOL(!visibleObjects.IsEmpty());
+        EZ_TEST_BOOL(serialVisibleObjects == visibleObjects);
+        EZ_TEST_BOOL(parallelVisibleObjects == visibleObjects);
+      }
 
-    for (auto pObject : visibleObjects)
-    {
-      EZ_TEST_BOOL(testFrustum.Overlaps(pObject->GetGlobalBoundsSimd().GetSphere()));
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
-      EZ_TEST_BOOL(pObject->IsDynamic());
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        ezGameObject* pObject = it;
 
-      ezVisibilityState visType = pObject->GetVisibilityState();
-      EZ_TEST_BOOL(visType == ezVisibilityState::Direct);
-    }
+        if (testFrustum.GetObjectPosition(pObject->GetGlobalBounds().GetSphere()) == ezVolumePosition::Outside)
+        {
+          ezVisibilityState visType = pObject->GetVisibilityState();
+          EZ_TEST_BOOL(visType == ezVisibilityState::Invisible);
+        }
+      }
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
-    {
-      ezGameObject* pObject = it;
+      // Move some objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        constexpr const double range = 500.0f;
+
+        if (it->IsDynamic())
+        {
+          ezVec3 pos = it->GetLocalPosition();
 
-      if (testFrustum.GetObjectPosition(pObject->GetGlobalBounds().GetSphere()) == ezVolumePosition::Outside)
+          pos.x += (float)rng.DoubleMinMax(-range, range);
+          pos.y += (float)rng.DoubleMinMax(-range, range);
+          pos.z += (float)rng.DoubleMinMax(-range, range);
+
+          it->SetLocalPosition(pos);
+        }
+      }
+
+      world.Update();
+
+      // Check that last frame visible doesn't reset entirely after moving
+      for (const ezGameObject* pObject : visibleObjects)
       {
         ezVisibilityState visType = pObject->GetVisibilityState();
-        EZ_TEST_BOOL(visType == ezVisibilityState::Invisible);
+        EZ_TEST_BOOL(visType == ezVisibilityState::Direct);
       }
     }
 
-    // Move some objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsAfterMove")
     {
-      constexpr const double range = 500.0f;
-
-      if (it->IsDynamic())
+      // Move the dynamic objects a few more times so the spatial system has to update its internal structures
+      for (ezUInt32 uiFrame = 0; uiFrame < 5; ++uiFrame)
       {
-        ezVec3 pos = it->GetLocalPosition();
+        for (auto it = world.GetObjects(); it.IsValid(); ++it)
+        {
+          constexpr const double range = 2000.0f;
+
+          if (it->IsDynamic())
+          {
+            ezVec3 pos = it->GetLocalPosition();
+
+            pos.x += (float)rng.DoubleMinMax(-range, range);
+            pos.y += (float)rng.DoubleMinMax(-range, range);
+            pos.z += (float)rng.DoubleMinMax(-range, range);
 
-        pos.x += (float)rng.DoubleMinMax(-range, range);
-        pos.y += (float)rng.DoubleMinMax(-range, range);
-        pos.z += (float)rng.DoubleMinMax(-range, range);
+            it->SetLocalPosition(pos);
+          }
+        }
 
-        it->SetLocalPosition(pos);
+        world.Update();
       }
-    }
 
-    world.Update();
+      ezBoundingSphere testSphere = ezBoundingSphere::MakeFromCenterAndRadius(ezVec3(-500.0f, 200.0f, 100.0f), 4000.0f);
 
-    // Check that last frame visible doesn't reset entirely after moving
-    for (const ezGameObject* pObject : visibleObjects)
-    {
-      ezVisibilityState visType = pObject->GetVisibilityState();
-      EZ_TEST_BOOL(visType == ezVisibilityState::Direct);
-    }
-  }
+      ezDynamicArray<ezGameObject*> objectsInSphere;
+      ezHashSet<ezGameObject*> uniqueObjects;
+      world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, objectsInSphere);
 
-  if (false)
-  {
-    ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
-    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(outputPath.GetData(), "test", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+      for (auto pObject : objectsInSphere)
+      {
+        EZ_TEST_BOOL(testSphere.Overlaps(pObject->GetGlobalBounds().GetSphere()));
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        EZ_TEST_BOOL(pObject->IsDynamic());
+      }
 
-    ezProfilingUtils::SaveProfilingCapture(":output/profiling.json").IgnoreResult();
-  }
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        if (testSphere.Overlaps(it->GetGlobalBounds().GetSphere()))
+        {
+          EZ_TEST_BOOL(it->IsStatic() || uniqueObjects.Contains((ezGameObject*)it));
+        }
+      }
+    }
 
-  // Test multiple categories for spatial data
-  EZ_TEST_BLOCK(ezTestBlock::Enabled, "MultipleCategories")
-  {
-    for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsAlongRay")
     {
-      ezGameObject* pObject = objects[i];
+      queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
 
-      TestBoundsComponent* pComponent = nullptr;
-      TestBoundsComponent::CreateComponent(pObject, pComponent);
-      pComponent->m_SpecialCategory = s_SpecialTestCategory;
+      const ezVec3 vStart(-15000.0f, -14000.0f, -13000.0f);
+
+      for (ezUInt32 uiRay = 0; uiRay < 10; ++uiRay)
+      {
+        // Aim at an object so that every ray hits something
+        const ezVec3 vTarget = objects[rng.UIntInRange(objects.GetCount())]->GetGlobalPosition();
+        const ezVec3 vDirection = (vTarget - vStart).GetNormalized();
+
+        ezUInt32 uiNumExpectedHits = 0;
+        for (auto it = world.GetObjects(); it.IsValid(); ++it)
+        {
+          uiNumExpectedHits += it->GetGlobalBounds().GetBox().GetRayIntersection(vStart, vDirection) ? 1 : 0;
+        }
+
+        ezDynamicArray<ezGameObject*> hitObjects;
+        ezHashSet<ezGameObject*> uniqueObjects;
+        float fLastDistance = 0.0f;
+
+        world.GetSpatialSystem()->FindObjectsAlongRay(vStart, vDirection, 100000.0f, queryParams, [&](ezGameObject* pObject, float fDistance)
+          {
+          float fExpectedDistance = 0.0f;
+          EZ_TEST_BOOL(pObject->GetGlobalBounds().GetBox().GetRayIntersection(vStart, vDirection, &fExpectedDistance));
+          EZ_TEST_FLOAT(fDistance, fExpectedDistance, 0.1f);
+          EZ_TEST_BOOL(fDistance >= fLastDistance);
+          EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+
+          fLastDistance = fDistance;
+          hitObjects.PushBack(pObject);
+
+          return ezVisitorExecution::Continue; });
+
+        EZ_TEST_INT(hitObjects.GetCount(), uiNumExpectedHits);
+        EZ_TEST_BOOL(!hitObjects.IsEmpty());
+
+        // Stopping after the first hit has to return the closest object
+        ezGameObject* pFirstObject = nullptr;
+        world.GetSpatialSystem()->FindObjectsAlongRay(vStart, vDirection, 100000.0f, queryParams, [&](ezGameObject* pObject, float fDistance)
+          {
+          pFirstObject = pObject;
+          return ezVisitorExecution::Stop; });
+
+        EZ_TEST_BOOL(!hitObjects.IsEmpty() && pFirstObject == hitObjects[0]);
+
+        // Hits beyond the max distance are not reported
+        const float fMaxDistance = (vTarget - vStart).GetLength() - 200.0f;
+        world.GetSpatialSystem()->FindObjectsAlongRay(vStart, vDirection, fMaxDistance, queryParams, [&](ezGameObject* pObject, float fDistance)
+          {
+          EZ_TEST_BOOL(fDistance <= fMaxDistance);
+          return ezVisitorExecution::Continue; });
+      }
     }
 
-    world.Update();
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindNearestObjects")
+    {
+      queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
 
-    ezDynamicArray<ezGameObjectHandle> allObjects;
-    allObjects.Reserve(world.GetObjectCount());
+      constexpr ezUInt32 uiMaxObjects = 10;
 
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
-    {
-      allObjects.PushBack(it->GetHandle());
+      for (ezUInt32 uiQuery = 0; uiQuery < 10; ++uiQuery)
+      {
+        const ezVec3 vPosition((float)rng.DoubleMinMax(-10000.0, 10000.0), (float)rng.DoubleMinMax(-10000.0, 10000.0), (float)rng.DoubleMinMax(-10000.0, 10000.0));
+        const float fMaxDistance = (uiQuery % 2 == 0) ? 100000.0f : 3000.0f;
+
+        ezDynamicArray<float> expectedDistances;
+        for (auto it = world.GetObjects(); it.IsValid(); ++it)
+        {
+          const float fDistance = it->GetGlobalBounds().GetBox().GetDistanceTo(vPosition);
+          if (fDistance <= fMaxDistance)
+          {
+            expectedDistances.PushBack(fDistance);
+          }
+        }
+        expectedDistances.Sort();
+
+        ezDynamicArray<ezGameObject*> nearestObjects;
+        world.GetSpatialSystem()->FindNearestObjects(vPosition, uiMaxObjects, fMaxDistance, queryParams, nearestObjects);
+
+        EZ_TEST_INT(nearestObjects.GetCount(), ezMath::Min(expectedDistances.GetCount(), uiMaxObjects));
+
+        for (ezUInt32 i = 0; i < nearestObjects.GetCount(); ++i)
+        {
+          EZ_TEST_FLOAT(nearestObjects[i]->GetGlobalBounds().GetBox().GetDistanceTo(vPosition), expectedDistances[i], 0.1f);
+        }
+      }
     }
 
-    for (ezUInt32 i = allObjects.GetCount(); i-- > 0;)
+    if (false)
     {
-      world.DeleteObjectNow(allObjects[i]);
+      ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+      EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(outputPath.GetData(), "test", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+
+      ezProfilingUtils::SaveProfilingCapture(":output/profiling.json").IgnoreResult();
     }
 
-    world.Update();
+    // Test multiple categories for spatial data
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "MultipleCategories")
+    {
+      for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
+      {
+        ezGameObject* pObject = objects[i];
+
+        TestBoundsComponent* pComponent = nullptr;
+        TestBoundsComponent::CreateComponent(pObject, pComponent);
+        pComponent->m_SpecialCategory = s_SpecialTestCategory;
+      }
+
+      world.Update();
+
+      ezDynamicArray<ezGameObjectHandle> allObjects;
+      allObjects.Reserve(world.GetObjectCount());
+
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        allObjects.PushBack(it->GetHandle());
+      }
+
+      for (ezUInt32 i = allObjects.GetCount(); i-- > 0;)
+      {
+        world.DeleteObjectNow(allObjects[i]);
+      }
+
+      world.Update();
+    }
   }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+{
+  TestSpatialSystem(EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid));
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_DynamicBVH)
+{
+  TestSpatialSystem(EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_DynamicBVH));
 }
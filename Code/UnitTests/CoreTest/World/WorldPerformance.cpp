@@ -1,6 +1,11 @@
 #include <CoreTest/CoreTestPCH.h>
 
+#include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_DynamicBVH.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
+#include <Foundation/Utilities/GraphicsUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 
@@ -55,6 +60,38 @@ namespace
   EZ_END_COMPONENT_TYPE;
   // clang-format on
 
+  using ezMixedScaleBoundsComponentManager = ezComponentManager<class ezMixedScaleBoundsComponent, ezBlockStorageType::Compact>;
+
+  class ezMixedScaleBoundsComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezMixedScaleBoundsComponent, ezComponent, ezMixedScaleBoundsComponentManager);
+
+  public:
+    virtual void Initialize() override { GetOwner()->UpdateLocalBounds(); }
+
+    void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& ref_msg)
+    {
+      ezBoundingBox bounds = ezBoundingBox::MakeFromCenterAndHalfExtents(ezVec3::MakeZero(), ezVec3(m_fHalfExtents));
+
+      ezSpatialData::Category category = GetOwner()->IsDynamic() ? ezDefaultSpatialDataCategories::RenderDynamic : ezDefaultSpatialDataCategories::RenderStatic;
+      ref_msg.AddBounds(ezBoundingBoxSphere::MakeFromBox(bounds), category);
+    }
+
+    float m_fHalfExtents = 1.0f;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezMixedScaleBoundsComponent, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(ezMsgUpdateLocalBounds, OnUpdateLocalBounds)
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
   void AddObjectsToWorld(ezWorld& ref_world, bool bDynamic, ezUInt32 uiNumObjects, ezUInt32 uiTreeLevelNumNodeDiv, ezUInt32 uiTreeDepth,
     ezInt32 iAttachCompsDepth, ezGameObjectHandle hParent = ezGameObjectHandle())
   {
@@ -114,6 +151,196 @@ namespace
     }
   }
 
+
+  /// Builds a scene with object sizes ranging from centimeters to kilometers and measures the spatial system operations on it.
+  template <typename SpatialSystemType>
+  void MeasureSpatialSystem(const char* szName)
+  {
+    constexpr ezUInt32 uiNumObjects = 100000;
+    constexpr ezUInt32 uiNumQueries = 1000;
+    constexpr ezUInt32 uiNumFrames = 10;
+    constexpr double fRange = 4000.0;
+
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_uiRandomNumberGeneratorSeed = 17;
+
+    SpatialSystemType* pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), SpatialSystemType);
+    worldDesc.m_pSpatialSystem = ezUniquePtr<ezSpatialSystem>(pSpatialSystem, ezFoundation::GetAlignedAllocator());
+
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    auto& rng = world.GetRandomNumberGenerator();
+
+    {
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        ezGameObjectDesc desc;
+        desc.m_bDynamic = (i % 4) == 0;
+        desc.m_LocalPosition.x = (float)rng.DoubleMinMax(-fRange, fRange);
+        desc.m_LocalPosition.y = (float)rng.DoubleMinMax(-fRange, fRange);
+        desc.m_LocalPosition.z = (float)rng.DoubleMinMax(-fRange, fRange);
+
+        ezGameObject* pObject = nullptr;
+        world.CreateObject(desc, pObject);
+
+        // 90% small props, 9% buildings, 1% terrain sized objects
+        const ezUInt32 uiSizeClass = rng.UIntInRange(100);
+        float fHalfExtents = (float)rng.DoubleMinMax(0.05, 1.0);
+        if (uiSizeClass == 0)
+          fHalfExtents = (float)rng.DoubleMinMax(200.0, 2000.0);
+        else if (uiSizeClass < 10)
+          fHalfExtents = (float)rng.DoubleMinMax(5.0, 50.0);
+
+        ezMixedScaleBoundsComponent* pComponent = nullptr;
+        ezMixedScaleBoundsComponent::CreateComponent(pObject, pComponent);
+        pComponent->m_fHalfExtents = fHalfExtents;
+      }
+
+      world.Update();
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: Creating %u objects: %.2fms", szName, uiNumObjects, tDiff.GetMilliseconds());
+    }
+
+    if constexpr (std::is_same_v<SpatialSystemType, ezSpatialSystem_DynamicBVH>)
+    {
+      // Like after loading a level, build the trees right away instead of waiting for the background build
+      ezStopwatch sw;
+
+      pSpatialSystem->RebuildAllTrees();
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: Building trees: %.2fms", szName, tDiff.GetMilliseconds());
+    }
+
+    {
+      ezStopwatch sw;
+
+      for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        for (auto it = world.GetObjects(); it.IsValid(); ++it)
+        {
+          if (it->IsDynamic())
+          {
+            ezVec3 pos = it->GetLocalPosition();
+            pos.x += (float)rng.DoubleMinMax(-2.0, 2.0);
+            pos.y += (float)rng.DoubleMinMax(-2.0, 2.0);
+            it->SetLocalPosition(pos);
+          }
+        }
+
+        world.Update();
+
+        // Gives background tasks like spatial system rebuilds the chance to finish like in a regular game loop
+        ezTaskSystem::FinishFrameTasks();
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: Moving %u dynamic objects: %.2fms per frame", szName, uiNumObjects / 4, tDiff.GetMilliseconds() / uiNumFrames);
+    }
+
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+    ezUInt32 uiNumFound = 0;
+    auto countCallback = [&](ezGameObject*)
+    {
+      ++uiNumFound;
+      return ezVisitorExecution::Continue;
+    };
+
+    {
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        const ezVec3 vCenter = ezVec3((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange));
+        world.GetSpatialSystem()->FindObjectsInSphere(ezBoundingSphere::MakeFromCenterAndRadius(vCenter, 50.0f), queryParams, countCallback);
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u sphere queries (%u objects found): %.2fms", szName, uiNumQueries, uiNumFound, tDiff.GetMilliseconds());
+    }
+
+    {
+      uiNumFound = 0;
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        const ezVec3 vCenter = ezVec3((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange));
+        world.GetSpatialSystem()->FindObjectsInBox(ezBoundingBox::MakeFromCenterAndHalfExtents(vCenter, ezVec3(50.0f)), queryParams, countCallback);
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u box queries (%u objects found): %.2fms", szName, uiNumQueries, uiNumFound, tDiff.GetMilliseconds());
+    }
+
+    {
+      uiNumFound = 0;
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        const ezVec3 vStart = ezVec3((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange));
+        const ezVec3 vDir = ezVec3::MakeRandomDirection(rng);
+
+        // Typical picking or line of sight query that only needs the first hit
+        world.GetSpatialSystem()->FindObjectsAlongRay(vStart, vDir, 1000.0f, queryParams, [&](ezGameObject*, float)
+          {
+          ++uiNumFound;
+          return ezVisitorExecution::Stop; });
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u ray queries (%u objects hit): %.2fms", szName, uiNumQueries, uiNumFound, tDiff.GetMilliseconds());
+    }
+
+    {
+      uiNumFound = 0;
+      ezDynamicArray<ezGameObject*> nearestObjects;
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        const ezVec3 vPos = ezVec3((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange));
+
+        world.GetSpatialSystem()->FindNearestObjects(vPos, 8, 1000.0f, queryParams, nearestObjects);
+        uiNumFound += nearestObjects.GetCount();
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u nearest object queries (%u objects found): %.2fms", szName, uiNumQueries, uiNumFound, tDiff.GetMilliseconds());
+    }
+
+    {
+      ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::MakeFromDegree(80.0f), 1.0f, 1.0f, 1000.0f);
+
+      ezDynamicArray<const ezGameObject*> visibleObjects;
+      ezUInt32 uiNumVisible = 0;
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumQueries / 10; ++i)
+      {
+        const ezVec3 vPos = ezVec3((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange));
+        const ezVec3 vDir = ezVec3::MakeRandomDirection(rng);
+        const ezVec3 vUp = ezMath::Abs(vDir.z) < 0.9f ? ezVec3::MakeAxisZ() : ezVec3::MakeAxisX();
+
+        ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(vPos, vPos + vDir, vUp);
+        ezFrustum frustum = ezFrustum::MakeFromMVP(projection * lookAt);
+
+        visibleObjects.Clear();
+        world.GetSpatialSystem()->FindVisibleObjects(frustum, queryParams, visibleObjects, {}, ezVisibilityState::Direct);
+        uiNumVisible += visibleObjects.GetCount();
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u frustum queries (%u objects visible): %.2fms", szName, uiNumQueries / 10, uiNumVisible, tDiff.GetMilliseconds());
+    }
+  }
 } // namespace
 
 
@@ -288,3 +515,12 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystem)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Mixed scale scene")
+  {
+    MeasureSpatialSystem<ezSpatialSystem_RegularGrid>("RegularGrid");
+    MeasureSpatialSystem<ezSpatialSystem_DynamicBVH>("DynamicBVH");
+  }
+}
@@ -0,0 +1,525 @@
+#include <CoreTest/CoreTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Core/WorldSerializer/Implementation/FlatWorldFormat.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldSerializerAttributes.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/IO/MemoryMappedFile.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Time/Stopwatch.h>
+
+namespace
+{
+  class ezSerializerTestComponent;
+  using ezSerializerTestComponentManager = ezComponentManager<ezSerializerTestComponent, ezBlockStorageType::FreeList>;
+
+  class ezSerializerTestComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezSerializerTestComponent, ezComponent, ezSerializerTestComponentManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& inout_stream) const override
+    {
+      ezStreamWriter& s = inout_stream.GetStream();
+      s << m_fValue;
+      s << m_sText;
+      inout_stream.WriteGameObjectHandle(m_hTarget);
+      inout_stream.WriteComponentHandle(m_hOtherComponent);
+    }
+
+    virtual void DeserializeComponent(ezWorldReader& inout_stream) override
+    {
+      m_uiReadVersion = inout_stream.GetComponentTypeVersion(GetStaticRTTI());
+
+      ezStreamReader& s = inout_stream.GetStream();
+      s >> m_fValue;
+      s >> m_sText;
+      m_hTarget = inout_stream.ReadGameObjectHandle();
+      inout_stream.ReadComponentHandle(m_hOtherComponent);
+    }
+
+    float m_fValue = 0.0f;
+    ezString m_sText;
+    ezGameObjectHandle m_hTarget;
+    ezComponentHandle m_hOtherComponent;
+    ezUInt32 m_uiReadVersion = 0;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezSerializerTestComponent, 3, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  class ezSerializerTestParallelComponent;
+  using ezSerializerTestParallelComponentManager = ezComponentManager<ezSerializerTestParallelComponent, ezBlockStorageType::FreeList>;
+
+  /// Same data, but deserialized on worker threads
+  class ezSerializerTestParallelComponent : public ezSerializerTestComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezSerializerTestParallelComponent, ezSerializerTestComponent, ezSerializerTestParallelComponentManager);
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezSerializerTestParallelComponent, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_ATTRIBUTES
+    {
+      new ezThreadSafeDeserializationAttribute(),
+    }
+    EZ_END_ATTRIBUTES;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  void SetParallelDeserialization(bool bEnable)
+  {
+    ezCVarBool* pCVar = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("World.Reader.ParallelDeserialization"));
+    if (EZ_TEST_BOOL(pCVar != nullptr))
+    {
+      *pCVar = bEnable;
+    }
+  }
+
+  void CreateSerializerTestWorld(ezWorld& ref_world, ezUInt32 uiNumRootObjects, ezUInt32 uiNumChildren)
+  {
+    EZ_LOCK(ref_world.GetWriteMarker());
+
+    ezSerializerTestComponentManager* pManager = ref_world.GetOrCreateComponentManager<ezSerializerTestComponentManager>();
+    ezSerializerTestParallelComponentManager* pParallelManager = ref_world.GetOrCreateComponentManager<ezSerializerTestParallelComponentManager>();
+
+    ezGameObjectHandle hPrevObject;
+    ezComponentHandle hPrevComponent;
+    ezStringBuilder sName;
+
+    for (ezUInt32 i = 0; i < uiNumRootObjects; ++i)
+    {
+      ezGameObjectDesc desc;
+      desc.m_LocalPosition.Set(i * 2.0f, 1.0f, -3.0f);
+      desc.m_LocalRotation = ezQuat::MakeFromAxisAndAngle(ezVec3(0, 0, 1), ezAngle::MakeFromDegree(i * 10.0f));
+      desc.m_LocalScaling.Set(1.0f, 2.0f, 1.0f);
+      desc.m_LocalUniformScaling = 1.5f;
+      desc.m_bDynamic = (i % 2) == 1;
+      desc.m_bActiveFlag = (i % 5) != 4;
+      desc.m_uiTeamID = static_cast<ezUInt16>(i % 3);
+      desc.m_uiStableRandomSeed = 1000 + i;
+
+      sName.SetFormat("Root{}", i);
+      desc.m_sName.Assign(sName);
+
+      if (i % 3 == 0)
+        desc.m_Tags.SetByName("SerializerTestA");
+      if (i % 4 == 0)
+        desc.m_Tags.SetByName("SerializerTestB");
+
+      ezGameObject* pRoot = nullptr;
+      const ezGameObjectHandle hRoot = ref_world.CreateObject(desc, pRoot);
+
+      if (i % 7 == 0)
+      {
+        pRoot->SetGlobalKey(sName);
+      }
+
+      for (ezUInt32 c = 0; c < uiNumChildren; ++c)
+      {
+        ezGameObjectDesc childDesc;
+        childDesc.m_hParent = hRoot;
+        childDesc.m_LocalPosition.Set(0, static_cast<float>(c), 0);
+        childDesc.m_uiStableRandomSeed = 5000 + i * uiNumChildren + c;
+
+        sName.SetFormat("Root{}/Child{}", i, c);
+        childDesc.m_sName.Assign(sName);
+
+        ezGameObject* pChild = nullptr;
+        ref_world.CreateObject(childDesc, pChild);
+
+        // every other component is deserialized on a worker thread and references one that isn't
+        ezSerializerTestComponent* pComponent = nullptr;
+        ezComponentHandle hComponent;
+        if (c % 2 == 0)
+        {
+          hComponent = pManager->CreateComponent(pChild, pComponent);
+        }
+        else
+        {
+          ezSerializerTestParallelComponent* pParallelComponent = nullptr;
+          hComponent = pParallelManager->CreateComponent(pChild, pParallelComponent);
+          pComponent = pParallelComponent;
+        }
+
+        pComponent->m_fValue = static_cast<float>(c);
+        pComponent->m_sText = sName;
+        pComponent->m_hTarget = hPrevObject;
+        pComponent->m_hOtherComponent = hPrevComponent;
+        pComponent->SetActiveFlag((c % 3) != 2);
+        pComponent->SetUserFlag(3, (c % 2) == 0);
+
+        hPrevComponent = hComponent;
+      }
+
+      hPrevObject = hRoot;
+    }
+  }
+
+  void CollectSerializerTestObjects(ezWorld& ref_world, ezMap<ezString, const ezGameObject*>& out_objects)
+  {
+    out_objects.Clear();
+
+    ref_world.Traverse([&](ezGameObject* pObject)
+      {
+      out_objects[pObject->GetName()] = pObject;
+      return ezVisitorExecution::Continue; });
+  }
+
+  void CompareSerializerTestWorlds(ezWorld& ref_expected, ezWorld& ref_actual, bool bCompareGlobalTransform)
+  {
+    // traversing the world requires write access
+    EZ_LOCK(ref_expected.GetWriteMarker());
+    EZ_LOCK(ref_actual.GetWriteMarker());
+
+    ezMap<ezString, const ezGameObject*> expectedObjects;
+    ezMap<ezString, const ezGameObject*> actualObjects;
+    CollectSerializerTestObjects(ref_expected, expectedObjects);
+    CollectSerializerTestObjects(ref_actual, actualObjects);
+
+    if (!EZ_TEST_INT(actualObjects.GetCount(), expectedObjects.GetCount()))
+      return;
+
+    for (auto it = expectedObjects.GetIterator(); it.IsValid(); ++it)
+    {
+      const ezGameObject* pExpected = it.Value();
+      const ezGameObject* pActual = nullptr;
+
+      if (!EZ_TEST_BOOL(actualObjects.TryGetValue(it.Key(), pActual)))
+        continue;
+
+      if (bCompareGlobalTransform)
+      {
+        EZ_TEST_BOOL(pActual->GetGlobalTransform().IsEqual(pExpected->GetGlobalTransform(), 0.001f));
+      }
+      else
+      {
+        EZ_TEST_VEC3(pActual->GetLocalPosition(), pExpected->GetLocalPosition(), 0.0f);
+        EZ_TEST_BOOL(pActual->GetLocalRotation() == pExpected->GetLocalRotation());
+        EZ_TEST_VEC3(pActual->GetLocalScaling(), pExpected->GetLocalScaling(), 0.0f);
+        EZ_TEST_FLOAT(pActual->GetLocalUniformScaling(), pExpected->GetLocalUniformScaling(), 0.0f);
+      }
+
+      EZ_TEST_BOOL(pActual->GetActiveFlag() == pExpected->GetActiveFlag());
+      EZ_TEST_BOOL(pActual->IsDynamic() == pExpected->IsDynamic());
+      EZ_TEST_INT(pActual->GetTeamID(), pExpected->GetTeamID());
+      EZ_TEST_INT(pActual->GetStableRandomSeed(), pExpected->GetStableRandomSeed());
+      EZ_TEST_BOOL(pActual->GetTags() == pExpected->GetTags());
+      EZ_TEST_STRING(pActual->GetGlobalKey(), pExpected->GetGlobalKey());
+      EZ_TEST_STRING(pActual->GetParent() ? pActual->GetParent()->GetName() : "", pExpected->GetParent() ? pExpected->GetParent()->GetName() : "");
+
+      const ezSerializerTestComponent* pExpectedComp = nullptr;
+      const ezSerializerTestComponent* pActualComp = nullptr;
+
+      if (!EZ_TEST_BOOL(pActual->TryGetComponentOfBaseType(pActualComp) == pExpected->TryGetComponentOfBaseType(pExpectedComp)) || pExpectedComp == nullptr)
+        continue;
+
+      EZ_TEST_BOOL(pActualComp->GetDynamicRTTI() == pExpectedComp->GetDynamicRTTI());
+      EZ_TEST_INT(pActualComp->m_uiReadVersion, 3);
+      EZ_TEST_FLOAT(pActualComp->m_fValue, pExpectedComp->m_fValue, 0.0f);
+      EZ_TEST_STRING(pActualComp->m_sText, pExpectedComp->m_sText);
+      EZ_TEST_BOOL(pActualComp->GetActiveFlag() == pExpectedComp->GetActiveFlag());
+      EZ_TEST_BOOL(pActualComp->GetUserFlag(3) == pExpectedComp->GetUserFlag(3));
+
+      const ezGameObject* pExpectedTarget = nullptr;
+      const ezGameObject* pActualTarget = nullptr;
+      if (EZ_TEST_BOOL(ref_actual.TryGetObject(pActualComp->m_hTarget, pActualTarget) == ref_expected.TryGetObject(pExpectedComp->m_hTarget, pExpectedTarget)) && pExpectedTarget)
+      {
+        EZ_TEST_STRING(pActualTarget->GetName(), pExpectedTarget->GetName());
+      }
+
+      const ezSerializerTestComponent* pExpectedOther = nullptr;
+      const ezSerializerTestComponent* pActualOther = nullptr;
+      if (EZ_TEST_BOOL(ref_actual.TryGetComponent(pActualComp->m_hOtherComponent, pActualOther) == ref_expected.TryGetComponent(pExpectedComp->m_hOtherComponent, pExpectedOther)) && pExpectedOther)
+      {
+        EZ_TEST_STRING(pActualOther->m_sText, pExpectedOther->m_sText);
+      }
+    }
+  }
+
+  void WriteSerializerTestWorld(ezWorld& ref_world, bool bFlatFormat, ezDynamicArray<ezUInt8>& out_data)
+  {
+    out_data.Clear();
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&out_data);
+    ezMemoryStreamWriter writer(&storage);
+
+    EZ_LOCK(ref_world.GetWriteMarker());
+
+    ezWorldWriter worldWriter;
+    worldWriter.SetFlatFormat(bFlatFormat);
+    worldWriter.WriteWorld(writer, ref_world);
+  }
+
+  void InstantiateSerializerTestWorld(ezWorldReader& ref_reader, ezWorld& ref_world)
+  {
+    EZ_LOCK(ref_world.GetWriteMarker());
+    ref_reader.InstantiateWorld(ref_world);
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, WorldSerializer)
+{
+  ezWorldDesc worldDesc("Source");
+  ezWorld sourceWorld(worldDesc);
+  CreateSerializerTestWorld(sourceWorld, 30, 4);
+
+  ezDynamicArray<ezUInt8> streamData;
+  ezDynamicArray<ezUInt8> flatData;
+  WriteSerializerTestWorld(sourceWorld, false, streamData);
+  WriteSerializerTestWorld(sourceWorld, true, flatData);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Stream Format")
+  {
+    ezRawMemoryStreamReader reader(streamData);
+
+    ezWorldReader worldReader;
+    EZ_TEST_BOOL(worldReader.ReadWorldDescription(reader).Succeeded());
+    EZ_TEST_INT(worldReader.GetRootObjectCount(), 30);
+    EZ_TEST_INT(worldReader.GetChildObjectCount(), 120);
+
+    ezWorldDesc desc("Stream");
+    ezWorld world(desc);
+    InstantiateSerializerTestWorld(worldReader, world);
+
+    CompareSerializerTestWorlds(sourceWorld, world, false);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Flat Format From Stream")
+  {
+    // data after the world must still be readable
+    flatData.PushBack(42);
+
+    ezRawMemoryStreamReader reader(flatData);
+
+    ezWorldReader worldReader;
+    EZ_TEST_BOOL(worldReader.ReadWorldDescription(reader).Succeeded());
+    EZ_TEST_INT(worldReader.GetRootObjectCount(), 30);
+    EZ_TEST_INT(worldReader.GetChildObjectCount(), 120);
+    EZ_TEST_BOOL(worldReader.HasComponentOfType(ezGetStaticRTTI<ezSerializerTestComponent>()));
+
+    ezUInt8 uiTrailing = 0;
+    reader >> uiTrailing;
+    EZ_TEST_INT(uiTrailing, 42);
+    flatData.PopBack();
+
+    // instantiating twice from the same reader
+    for (ezUInt32 i = 0; i < 2; ++i)
+    {
+      ezWorldDesc desc("Flat");
+      ezWorld world(desc);
+      InstantiateSerializerTestWorld(worldReader, world);
+
+      CompareSerializerTestWorlds(sourceWorld, world, false);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Flat Format From Memory")
+  {
+    ezWorldReader worldReader;
+    EZ_TEST_BOOL(worldReader.ReadFlatWorldDescription(flatData).Succeeded());
+
+    // aligned data is used directly
+    EZ_TEST_BOOL(worldReader.GetHeapMemoryUsage() < flatData.GetCount());
+
+    ezWorldDesc desc("Flat");
+    ezWorld world(desc);
+    InstantiateSerializerTestWorld(worldReader, world);
+
+    CompareSerializerTestWorlds(sourceWorld, world, false);
+  }
+
+#if EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE)
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Flat Format From Memory Mapped File")
+  {
+    ezStringBuilder sFile = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    sFile.AppendPath("FlatWorld.ezBinScene");
+
+    {
+      ezOSFile file;
+      if (!EZ_TEST_BOOL(file.Open(sFile, ezFileOpenMode::Write).Succeeded()))
+        return;
+
+      EZ_TEST_BOOL(file.Write(flatData.GetData(), flatData.GetCount()).Succeeded());
+    }
+
+    {
+      ezMemoryMappedFile mappedFile;
+      if (!EZ_TEST_BOOL(mappedFile.Open(sFile, ezMemoryMappedFile::Mode::ReadOnly).Succeeded()))
+        return;
+
+      ezWorldReader worldReader;
+      EZ_TEST_BOOL(worldReader.ReadFlatWorldDescription(ezArrayPtr<const ezUInt8>(static_cast<const ezUInt8*>(mappedFile.GetReadPointer()), static_cast<ezUInt32>(mappedFile.GetFileSize()))).Succeeded());
+
+      ezWorldDesc desc("Mapped");
+      ezWorld world(desc);
+      InstantiateSerializerTestWorld(worldReader, world);
+
+      CompareSerializerTestWorlds(sourceWorld, world, false);
+    }
+
+    EZ_TEST_BOOL(ezOSFile::DeleteFile(sFile).Succeeded());
+  }
+#endif
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Flat Format As Prefab")
+  {
+    const ezTransform rootTransform(ezVec3(10, 20, 30), ezQuat::MakeFromAxisAndAngle(ezVec3(0, 1, 0), ezAngle::MakeFromDegree(45)));
+
+    ezPrefabInstantiationOptions options;
+    options.m_RandomSeedMode = ezPrefabInstantiationOptions::RandomSeedMode::FixedFromSerialization;
+
+    ezWorldDesc streamDesc("StreamPrefab");
+    ezWorld streamWorld(streamDesc);
+    {
+      ezRawMemoryStreamReader reader(streamData);
+      ezWorldReader worldReader;
+      EZ_TEST_BOOL(worldReader.ReadWorldDescription(reader).Succeeded());
+
+      EZ_LOCK(streamWorld.GetWriteMarker());
+      worldReader.InstantiatePrefab(streamWorld, rootTransform, options);
+    }
+
+    // time sliced, one object or component per step
+    ezWorldDesc flatDesc("FlatPrefab");
+    ezWorld flatWorld(flatDesc);
+    {
+      ezWorldReader worldReader;
+      EZ_TEST_BOOL(worldReader.ReadFlatWorldDescription(flatData).Succeeded());
+
+      ezDynamicArray<ezGameObject*> createdRootObjects;
+      options.m_pCreatedRootObjectsOut = &createdRootObjects;
+      options.m_MaxStepTime = ezTime::MakeFromNanoseconds(1);
+
+      ezUniquePtr<ezWorldReader::InstantiationContextBase> pContext;
+      {
+        EZ_LOCK(flatWorld.GetWriteMarker());
+        pContext = worldReader.InstantiatePrefab(flatWorld, rootTransform, options);
+      }
+
+      ezUInt32 uiNumSteps = 0;
+      while (pContext->Step() != ezWorldReader::InstantiationContextBase::StepResult::Finished)
+      {
+        EZ_LOCK(flatWorld.GetWriteMarker());
+        flatWorld.Update();
+        ++uiNumSteps;
+      }
+
+      EZ_TEST_BOOL(uiNumSteps > 150);
+      EZ_TEST_INT(createdRootObjects.GetCount(), 30);
+    }
+
+    CompareSerializerTestWorlds(streamWorld, flatWorld, true);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Without Parallel Deserialization")
+  {
+    SetParallelDeserialization(false);
+
+    ezRawMemoryStreamReader reader(streamData);
+    ezWorldReader streamReader;
+    EZ_TEST_BOOL(streamReader.ReadWorldDescription(reader).Succeeded());
+
+    ezWorldReader flatReader;
+    EZ_TEST_BOOL(flatReader.ReadFlatWorldDescription(flatData).Succeeded());
+
+    ezWorldDesc streamDesc("Stream");
+    ezWorld streamWorld(streamDesc);
+    InstantiateSerializerTestWorld(streamReader, streamWorld);
+    CompareSerializerTestWorlds(sourceWorld, streamWorld, false);
+
+    ezWorldDesc flatDesc("Flat");
+    ezWorld flatWorld(flatDesc);
+    InstantiateSerializerTestWorld(flatReader, flatWorld);
+    CompareSerializerTestWorlds(sourceWorld, flatWorld, false);
+
+    SetParallelDeserialization(true);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid Data")
+  {
+    ezMuteLog logErrorSink;
+    ezLogSystemScope ls(&logErrorSink);
+
+    ezWorldReader worldReader;
+    EZ_TEST_BOOL(worldReader.ReadFlatWorldDescription(streamData).Failed());
+    EZ_TEST_BOOL(worldReader.ReadFlatWorldDescription(flatData.GetArrayPtr().GetSubArray(0, 100)).Failed());
+
+    ezDynamicArray<ezUInt8> corrupted = flatData;
+    corrupted[16 + 4] = 7; // version
+    EZ_TEST_BOOL(worldReader.ReadFlatWorldDescription(corrupted).Failed());
+
+    // no string terminator within the string data
+    corrupted = flatData;
+    const ezFlatWorldFormat::Header& header = *reinterpret_cast<const ezFlatWorldFormat::Header*>(corrupted.GetData() + 16);
+    ezMemoryUtils::PatternFill(corrupted.GetData() + 16 + header.m_uiStringDataOffset, 'x', header.m_uiComponentDataOffset - header.m_uiStringDataOffset);
+    EZ_TEST_BOOL(worldReader.ReadFlatWorldDescription(corrupted).Failed());
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_Serialization)
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezTestBlock::Enum profileBlock = ezTestBlock::DisabledNoWarning;
+#else
+  const ezTestBlock::Enum profileBlock = ezTestBlock::Enabled;
+#endif
+
+  EZ_TEST_BLOCK(profileBlock, "Load 100,000 objects")
+  {
+    ezDynamicArray<ezUInt8> streamData;
+    ezDynamicArray<ezUInt8> flatData;
+
+    {
+      ezWorldDesc worldDesc("Source");
+      ezWorld sourceWorld(worldDesc);
+      CreateSerializerTestWorld(sourceWorld, 20000, 4);
+
+      WriteSerializerTestWorld(sourceWorld, false, streamData);
+      WriteSerializerTestWorld(sourceWorld, true, flatData);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Details, "Stream format: %u KB, flat format: %u KB", streamData.GetCount() / 1024, flatData.GetCount() / 1024);
+
+    for (ezUInt32 uiRun = 0; uiRun < 4; ++uiRun)
+    {
+      const bool bFlat = (uiRun % 2) == 1;
+      const bool bParallel = uiRun >= 2;
+
+      SetParallelDeserialization(bParallel);
+
+      ezWorldDesc worldDesc("Target");
+      ezWorld world(worldDesc);
+
+      ezStopwatch sw;
+
+      ezWorldReader worldReader;
+      if (bFlat)
+      {
+        EZ_TEST_BOOL(worldReader.ReadFlatWorldDescription(flatData).Succeeded());
+      }
+      else
+      {
+        ezRawMemoryStreamReader reader(streamData);
+        EZ_TEST_BOOL(worldReader.ReadWorldDescription(reader).Succeeded());
+      }
+
+      const ezTime tRead = sw.Checkpoint();
+
+      InstantiateSerializerTestWorld(worldReader, world);
+
+      const ezTime tInstantiate = sw.Checkpoint();
+
+      EZ_LOCK(world.GetReadMarker());
+      EZ_TEST_INT(world.GetObjectCount(), 100000);
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s format%s: read %.2fms, instantiate %.2fms", bFlat ? "Flat" : "Stream", bParallel ? ", parallel deserialization" : "", tRead.GetMilliseconds(), tInstantiate.GetMilliseconds());
+    }
+  }
+}
@@ -1,6 +1,7 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
 #include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Time/Stopwatch.h>
 
 namespace
 {
@@ -53,4 +54,103 @@ EZ_CREATE_SIMPLE_TEST(Algorithm, Sorting)
       EZ_TEST_BOOL(a2[i - 1] >= a2[i]);
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FloatToRadixKey")
+  {
+    const float values[] = {-ezMath::Infinity<float>(), -1000.0f, -1.5f, -1.0f, -0.0f, 0.0f, 1e-30f, 1.0f, 1.5f, 1000.0f, ezMath::Infinity<float>()};
+
+    for (ezUInt32 i = 1; i < EZ_ARRAY_SIZE(values); ++i)
+    {
+      EZ_TEST_BOOL(ezSorting::FloatToRadixKey(values[i - 1]) <= ezSorting::FloatToRadixKey(values[i]));
+    }
+
+    EZ_TEST_BOOL(ezSorting::FloatToRadixKey(-1.0f) < ezSorting::FloatToRadixKey(1.0f));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RadixSort")
+  {
+    ezDynamicArray<ezInt32> a2 = a1;
+    ezDynamicArray<ezInt32> scratch;
+    scratch.SetCountUninitialized(a2.GetCount());
+
+    ezSorting::RadixSort(a2.GetArrayPtr(), scratch.GetArrayPtr(), [](ezInt32 i)
+      { return static_cast<ezUInt32>(i); });
+
+    for (ezUInt32 i = 1; i < a2.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(a2[i - 1] <= a2[i]);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RadixSort - Stable")
+  {
+    struct Entry
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      float m_fKey;
+      ezUInt32 m_uiIndex;
+    };
+
+    ezDynamicArray<Entry> entries;
+    for (ezUInt32 i = 0; i < 2000; ++i)
+    {
+      entries.PushBack({static_cast<float>(rand() % 100) - 50.0f, i});
+    }
+
+    ezDynamicArray<Entry> scratch;
+    scratch.SetCountUninitialized(entries.GetCount());
+
+    ezSorting::RadixSort(entries.GetArrayPtr(), scratch.GetArrayPtr(), [](const Entry& e)
+      { return ezSorting::FloatToRadixKey(e.m_fKey); });
+
+    for (ezUInt32 i = 1; i < entries.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(entries[i - 1].m_fKey <= entries[i].m_fKey);
+
+      if (entries[i - 1].m_fKey == entries[i].m_fKey)
+      {
+        EZ_TEST_BOOL(entries[i - 1].m_uiIndex < entries[i].m_uiIndex);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RadixSort - Performance")
+  {
+    // the same kind of data as the back to front sorting of particles
+    struct Entry
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      float m_fDist;
+      ezUInt32 m_uiIndex;
+    };
+
+    ezDynamicArray<Entry> input;
+    for (ezUInt32 i = 0; i < 100000; ++i)
+    {
+      input.PushBack({static_cast<float>(rand()) / RAND_MAX * 10000.0f, i});
+    }
+
+    ezDynamicArray<Entry> quickSorted = input;
+    ezDynamicArray<Entry> radixSorted = input;
+    ezDynamicArray<Entry> scratch;
+    scratch.SetCountUninitialized(input.GetCount());
+
+    ezStopwatch sw;
+    ezSorting::QuickSort(quickSorted, [](const Entry& a, const Entry& b)
+      { return a.m_fDist > b.m_fDist; });
+    const ezTime tQuickSort = sw.Checkpoint();
+
+    ezSorting::RadixSort(radixSorted.GetArrayPtr(), scratch.GetArrayPtr(), [](const Entry& e)
+      { return ~ezSorting::FloatToRadixKey(e.m_fDist); });
+    const ezTime tRadixSort = sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < input.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(quickSorted[i].m_fDist == radixSorted[i].m_fDist);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Sorting 100k elements: QuickSort %.2fms, RadixSort %.2fms", tQuickSort.GetMilliseconds(), tRadixSort.GetMilliseconds());
+  }
 }
@@ -6,6 +6,7 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/Time/Stopwatch.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(DataProcessing);
 
@@ -21,6 +22,7 @@ public:
     = default;
 
   void SetStreamName(ezHashedString sStreamName) { m_sStreamName = sStreamName; }
+  void SetTileSafe(bool bTileSafe) { m_bTileSafe = bTileSafe; }
 
 protected:
   virtual ezResult UpdateStreamBindings() override
@@ -34,7 +36,12 @@ protected:
 
   virtual void Process(ezUInt64 uiNumElements) override
   {
-    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, 0);
+    ProcessTile(0, uiNumElements);
+  }
+
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, uiStartIndex);
 
     while (!streamIterator.HasReachedEnd())
     {
@@ -51,6 +58,65 @@ protected:
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(AddOneStreamProcessor, 1, ezRTTIDefaultAllocator<AddOneStreamProcessor>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+// Assigns consecutive ids to new elements, removes elements whose value reached a limit that depends on the id and spawns one replacement each
+
+class RecycleStreamProcessor : public ezProcessingStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(RecycleStreamProcessor, ezProcessingStreamProcessor);
+
+public:
+  RecycleStreamProcessor() { m_bTileSafe = true; }
+
+  ezUInt32 m_uiNextId = 0;
+
+protected:
+  virtual ezResult UpdateStreamBindings() override
+  {
+    m_pValueStream = m_pStreamGroup->GetStreamByName("Value");
+    m_pIdStream = m_pStreamGroup->GetStreamByName("Id");
+
+    return m_pValueStream && m_pIdStream ? EZ_SUCCESS : EZ_FAILURE;
+  }
+
+  virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    ezProcessingStreamIterator<float> valueIterator(m_pValueStream, uiNumElements, uiStartIndex);
+    ezProcessingStreamIterator<ezUInt32> idIterator(m_pIdStream, uiNumElements, uiStartIndex);
+
+    while (!idIterator.HasReachedEnd())
+    {
+      valueIterator.Current() = 0.0f;
+      idIterator.Current() = m_uiNextId++;
+
+      valueIterator.Advance();
+      idIterator.Advance();
+    }
+  }
+
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessTile(0, uiNumElements); }
+
+  virtual void ProcessTile(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    const float* pValues = m_pValueStream->GetData<float>();
+    const ezUInt32* pIds = m_pIdStream->GetData<ezUInt32>();
+
+    for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
+    {
+      if (pValues[i] >= static_cast<float>(pIds[i] % 13))
+      {
+        m_pStreamGroup->RemoveElement(i);
+        m_pStreamGroup->InitializeElements(1);
+      }
+    }
+  }
+
+  ezProcessingStream* m_pValueStream = nullptr;
+  ezProcessingStream* m_pIdStream = nullptr;
+};
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(RecycleStreamProcessor, 1, ezRTTIDefaultAllocator<RecycleStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
 EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
 {
   ezProcessingStreamGroup Group;
@@ -156,3 +222,75 @@ EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStreamTiled)
+{
+  constexpr ezUInt32 uiNumElements = 20000;
+
+  auto RunGroup = [&](ezProcessingStreamGroup::ExecutionMode mode, bool bWithBarrier, ezDynamicArray<ezUInt32>& out_ids, ezDynamicArray<float>& out_values) -> ezTime
+  {
+    ezProcessingStreamGroup group;
+    group.SetExecutionMode(mode);
+
+    ezProcessingStream* pValueStream = group.AddStream("Value", ezProcessingStream::DataType::Float);
+    ezProcessingStream* pIdStream = group.AddStream("Id", ezProcessingStream::DataType::Int);
+
+    AddOneStreamProcessor* pAddOne1 = EZ_DEFAULT_NEW(AddOneStreamProcessor);
+    pAddOne1->SetStreamName(pValueStream->GetName());
+    pAddOne1->SetTileSafe(true);
+    pAddOne1->m_fPriority = 0.0f;
+    group.AddProcessor(pAddOne1);
+
+    // not tile safe, so all tiles have to be finished before it runs and the tiled processors after it start over with the first tile
+    AddOneStreamProcessor* pAddOne2 = EZ_DEFAULT_NEW(AddOneStreamProcessor);
+    pAddOne2->SetStreamName(pValueStream->GetName());
+    pAddOne2->SetTileSafe(!bWithBarrier);
+    pAddOne2->m_fPriority = 1.0f;
+    group.AddProcessor(pAddOne2);
+
+    RecycleStreamProcessor* pRecycle = EZ_DEFAULT_NEW(RecycleStreamProcessor);
+    pRecycle->m_fPriority = 2.0f;
+    group.AddProcessor(pRecycle);
+
+    group.SetSize(uiNumElements);
+    group.InitializeElements(uiNumElements);
+    group.Process();
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      group.Process();
+    }
+
+    const ezTime duration = sw.GetRunningTotal();
+
+    EZ_TEST_INT(group.GetNumActiveElements(), uiNumElements);
+
+    out_ids = ezArrayPtr<const ezUInt32>(pIdStream->GetData<ezUInt32>(), static_cast<ezUInt32>(group.GetNumActiveElements()));
+    out_values = ezArrayPtr<const float>(pValueStream->GetData<float>(), static_cast<ezUInt32>(group.GetNumActiveElements()));
+
+    return duration;
+  };
+
+  for (bool bWithBarrier : {false, true})
+  {
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, bWithBarrier ? "Tiled with barrier" : "Tiled")
+    {
+      ezDynamicArray<ezUInt32> sequentialIds, tiledIds, parallelIds;
+      ezDynamicArray<float> sequentialValues, tiledValues, parallelValues;
+
+      const ezTime tSequential = RunGroup(ezProcessingStreamGroup::ExecutionMode::Sequential, bWithBarrier, sequentialIds, sequentialValues);
+      const ezTime tTiled = RunGroup(ezProcessingStreamGroup::ExecutionMode::Tiled, bWithBarrier, tiledIds, tiledValues);
+      const ezTime tParallel = RunGroup(ezProcessingStreamGroup::ExecutionMode::TiledParallel, bWithBarrier, parallelIds, parallelValues);
+
+      // removals are applied in the same order in all modes, so the elements must end up in the same order as well
+      EZ_TEST_BOOL(sequentialIds == tiledIds);
+      EZ_TEST_BOOL(sequentialIds == parallelIds);
+      EZ_TEST_BOOL(sequentialValues == tiledValues);
+      EZ_TEST_BOOL(sequentialValues == parallelValues);
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: sequential %.2fms, tiled %.2fms, tiled parallel %.2fms", bWithBarrier ? "With barrier" : "Without barrier", tSequential.GetMilliseconds(), tTiled.GetMilliseconds(), tParallel.GetMilliseconds());
+    }
+  }
+}
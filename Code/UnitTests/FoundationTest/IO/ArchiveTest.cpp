@@ -1,7 +1,10 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/Archive/ArchiveBuilder.h>
+#include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/Archive/DataDirTypeArchive.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
@@ -159,3 +162,314 @@ EZ_CREATE_SIMPLE_TEST(IO, Archive)
 }
 
 #endif
+
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveBuilder)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveBuilderTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+
+  // the builder reads and writes files through absolute paths
+  if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory("", "ArchiveBuilderTest", ":", ezFileSystem::AllowWrites).Succeeded()))
+    return;
+
+  const ezStringBuilder sDataFolder(sOutputFolder, "/Data");
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Data.ezArchive");
+
+  // File1 and File3 have identical content and should share their data in the archive
+  const char* szFileList[] = {"File1.txt", "Folder/File2.txt", "Folder/File3.txt", "File4.txt"};
+  const ezUInt32 uiContent[] = {1, 2, 1, 4};
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Generate Data")
+  {
+    ezStringBuilder sFile;
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < EZ_ARRAY_SIZE(szFileList); ++uiFileIdx)
+    {
+      sFile.Set(sDataFolder, "/", szFileList[uiFileIdx]);
+
+      ezDynamicArray<ezUInt32> data;
+      data.SetCountUninitialized(1024 * 64);
+      for (ezUInt32 i = 0; i < data.GetCount(); ++i)
+      {
+        data[i] = i / 16 * uiContent[uiFileIdx];
+      }
+
+      ezOSFile file;
+      if (!EZ_TEST_BOOL(file.Open(sFile, ezFileOpenMode::Write).Succeeded()))
+        return;
+
+      EZ_TEST_BOOL(file.Write(data.GetData(), data.GetCount() * sizeof(ezUInt32)).Succeeded());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    ezArchiveBuilder builder;
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < EZ_ARRAY_SIZE(szFileList); ++uiFileIdx)
+    {
+      auto& entry = builder.m_Entries.ExpandAndGetRef();
+      entry.m_sAbsSourcePath = ezStringBuilder(sDataFolder, "/", szFileList[uiFileIdx]);
+      entry.m_sRelTargetPath = szFileList[uiFileIdx];
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+      entry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+#  endif
+    }
+
+    EZ_TEST_BOOL(builder.WriteArchive(sArchiveFile).Succeeded());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read Archive")
+  {
+    ezArchiveReader reader;
+    if (!EZ_TEST_BOOL(reader.OpenArchive(sArchiveFile).Succeeded()))
+      return;
+
+    const ezArchiveTOC& toc = reader.GetArchiveTOC();
+    if (!EZ_TEST_INT(toc.m_Entries.GetCount(), EZ_ARRAY_SIZE(szFileList)))
+      return;
+
+    EZ_TEST_INT(toc.m_Entries[0].m_uiDataStartOffset, toc.m_Entries[2].m_uiDataStartOffset);
+    EZ_TEST_BOOL(toc.m_Entries[0].m_uiDataStartOffset != toc.m_Entries[1].m_uiDataStartOffset);
+    EZ_TEST_BOOL(toc.m_Entries[1].m_uiDataStartOffset != toc.m_Entries[3].m_uiDataStartOffset);
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < EZ_ARRAY_SIZE(szFileList); ++uiFileIdx)
+    {
+      const ezUInt32 uiEntry = toc.FindEntry(szFileList[uiFileIdx]);
+      if (!EZ_TEST_BOOL(uiEntry == uiFileIdx))
+        continue;
+
+      ezUniquePtr<ezStreamReader> pEntryReader = reader.CreateEntryReader(uiEntry);
+
+      ezDynamicArray<ezUInt32> data;
+      data.SetCountUninitialized(1024 * 64);
+      EZ_TEST_INT(pEntryReader->ReadBytes(data.GetData(), data.GetCount() * sizeof(ezUInt32)), data.GetCount() * sizeof(ezUInt32));
+
+      for (ezUInt32 i = 0; i < data.GetCount(); ++i)
+      {
+        if (data[i] != i / 16 * uiContent[uiFileIdx])
+        {
+          EZ_TEST_INT(data[i], i / 16 * uiContent[uiFileIdx]);
+          break;
+        }
+      }
+    }
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("ArchiveBuilderTest");
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+}
+
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveDictionaries)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveDictionariesTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+
+  if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory("", "ArchiveDictionariesTest", ":", ezFileSystem::AllowWrites).Succeeded()))
+    return;
+
+  const ezStringBuilder sDataFolder(sOutputFolder, "/Data");
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Dictionary.ezArchive");
+  const ezStringBuilder sArchiveFileNoDict(sOutputFolder, "/NoDictionary.ezArchive");
+
+  // many small files of the same type get a dictionary, the few others don't
+  const ezUInt32 uiNumMaterials = 64;
+  const ezUInt32 uiNumOthers = 2;
+
+  ezDynamicArray<ezString> files;
+  ezDynamicArray<ezString> contents;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Generate Data")
+  {
+    ezStringBuilder sFile, sContent;
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < uiNumMaterials + uiNumOthers; ++uiFileIdx)
+    {
+      sFile.SetFormat("Folder{}/File{}.{}", uiFileIdx % 3, uiFileIdx, uiFileIdx < uiNumMaterials ? "ezMaterial" : "txt");
+
+      sContent.SetFormat("Material {}\n{{\n", uiFileIdx);
+      for (ezUInt32 uiParam = 0; uiParam < 32; ++uiParam)
+      {
+        sContent.AppendFormat("  Parameter{} = {{ Type = \"Float\", Value = {} }}\n", uiParam, ezHashingUtils::xxHash32(&uiParam, sizeof(uiParam), uiFileIdx) % 1000);
+      }
+      sContent.Append("}\n");
+
+      files.PushBack(sFile);
+      contents.PushBack(sContent);
+
+      ezOSFile file;
+      if (!EZ_TEST_BOOL(file.Open(ezStringBuilder(sDataFolder, "/", sFile), ezFileOpenMode::Write).Succeeded()))
+        return;
+
+      EZ_TEST_BOOL(file.Write(sContent.GetData(), sContent.GetElementCount()).Succeeded());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    ezArchiveBuilder builder;
+    for (const ezString& sFile : files)
+    {
+      auto& entry = builder.m_Entries.ExpandAndGetRef();
+      entry.m_sAbsSourcePath = ezStringBuilder(sDataFolder, "/", sFile);
+      entry.m_sRelTargetPath = sFile;
+      entry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+      entry.m_iCompressionLevel = static_cast<ezInt32>(ezCompressedStreamWriterZstd::Compression::Average);
+    }
+
+    EZ_TEST_BOOL(builder.WriteArchive(sArchiveFileNoDict).Succeeded());
+
+    builder.m_bUseCompressionDictionaries = true;
+    EZ_TEST_BOOL(builder.WriteArchive(sArchiveFile).Succeeded());
+
+    ezFileStats stats, statsNoDict;
+    EZ_TEST_BOOL(ezOSFile::GetFileStats(sArchiveFile, stats).Succeeded());
+    EZ_TEST_BOOL(ezOSFile::GetFileStats(sArchiveFileNoDict, statsNoDict).Succeeded());
+    EZ_TEST_BOOL(stats.m_uiFileSize < statsNoDict.m_uiFileSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read Archive")
+  {
+    ezArchiveReader reader;
+    if (!EZ_TEST_BOOL(reader.OpenArchive(sArchiveFile).Succeeded()))
+      return;
+
+    const ezArchiveTOC& toc = reader.GetArchiveTOC();
+    if (!EZ_TEST_INT(toc.m_Entries.GetCount(), files.GetCount()))
+      return;
+
+    EZ_TEST_INT(toc.m_CompressionDictionaries.GetCount(), 1);
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < files.GetCount(); ++uiFileIdx)
+    {
+      const ezUInt32 uiEntry = toc.FindEntry(files[uiFileIdx]);
+      if (!EZ_TEST_BOOL(uiEntry == uiFileIdx))
+        continue;
+
+      EZ_TEST_BOOL((toc.m_Entries[uiEntry].m_uiDictionaryIndex == 0) == (uiFileIdx < uiNumMaterials));
+
+      ezUniquePtr<ezStreamReader> pEntryReader = reader.CreateEntryReader(uiEntry);
+
+      ezDynamicArray<char> data;
+      data.SetCountUninitialized(contents[uiFileIdx].GetElementCount());
+      EZ_TEST_INT(pEntryReader->ReadBytes(data.GetData(), data.GetCount()), data.GetCount());
+      EZ_TEST_BOOL(ezStringView(data.GetData(), data.GetCount()) == contents[uiFileIdx]);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mount as Data Dir")
+  {
+    if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sArchiveFile, "ArchiveDictionariesTest", "archive", ezFileSystem::ReadOnly).Succeeded()))
+      return;
+
+    ezStringBuilder sFile;
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < files.GetCount(); ++uiFileIdx)
+    {
+      sFile.Set(":archive/", files[uiFileIdx]);
+
+      ezFileReader file;
+      if (!EZ_TEST_BOOL(file.Open(sFile).Succeeded()))
+        continue;
+
+      ezStringBuilder sContent;
+      sContent.ReadAll(file);
+      EZ_TEST_STRING(sContent, contents[uiFileIdx]);
+    }
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("ArchiveDictionariesTest");
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+}
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveSeekable)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveSeekableTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+
+  if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory("", "ArchiveSeekableTest", ":", ezFileSystem::AllowWrites).Succeeded()))
+    return;
+
+  const ezStringBuilder sDataFile(sOutputFolder, "/Data/Texture.dds");
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Seekable.ezArchive");
+
+  ezDynamicArray<ezUInt32> data;
+  data.SetCountUninitialized(1024 * 1024);
+  for (ezUInt32 i = 0; i < data.GetCount(); ++i)
+  {
+    data[i] = i / 16;
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    ezOSFile file;
+    if (!EZ_TEST_BOOL(file.Open(sDataFile, ezFileOpenMode::Write).Succeeded()))
+      return;
+
+    EZ_TEST_BOOL(file.Write(data.GetData(), data.GetCount() * sizeof(ezUInt32)).Succeeded());
+    file.Close();
+
+    ezArchiveBuilder builder;
+    auto& entry = builder.m_Entries.ExpandAndGetRef();
+    entry.m_sAbsSourcePath = sDataFile;
+    entry.m_sRelTargetPath = "Texture.dds";
+    entry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd_seekable;
+    entry.m_iCompressionLevel = static_cast<ezInt32>(ezCompressedStreamWriterZstd::Compression::Fast);
+
+    EZ_TEST_BOOL(builder.WriteArchive(sArchiveFile).Succeeded());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read Archive")
+  {
+    ezArchiveReader reader;
+    if (!EZ_TEST_BOOL(reader.OpenArchive(sArchiveFile).Succeeded()))
+      return;
+
+    EZ_TEST_BOOL(reader.GetArchiveTOC().m_Entries[0].m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_seekable);
+
+    ezUniquePtr<ezStreamReader> pEntryReader = reader.CreateEntryReader(0);
+
+    ezDynamicArray<ezUInt32> dataRead;
+    dataRead.SetCount(data.GetCount());
+    EZ_TEST_INT(pEntryReader->ReadBytes(dataRead.GetData(), dataRead.GetCount() * sizeof(ezUInt32)), dataRead.GetCount() * sizeof(ezUInt32));
+    EZ_TEST_BOOL(data == dataRead);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mount as Data Dir")
+  {
+    if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sArchiveFile, "ArchiveSeekableTest", "archive", ezFileSystem::ReadOnly).Succeeded()))
+      return;
+
+    ezFileReader file;
+    if (!EZ_TEST_BOOL(file.Open(":archive/Texture.dds").Succeeded()))
+      return;
+
+    // only read the tail of the file
+    const ezUInt32 uiTailStart = data.GetCount() - 1000;
+    EZ_TEST_INT(file.SkipBytes(uiTailStart * sizeof(ezUInt32)), uiTailStart * sizeof(ezUInt32));
+
+    ezDynamicArray<ezUInt32> tail;
+    tail.SetCount(1000);
+    EZ_TEST_INT(file.ReadBytes(tail.GetData(), tail.GetCount() * sizeof(ezUInt32)), tail.GetCount() * sizeof(ezUInt32));
+    EZ_TEST_BOOL(tail.GetArrayPtr() == data.GetArrayPtr().GetSubArray(uiTailStart, 1000));
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("ArchiveSeekableTest");
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+}
+
+#  endif
+
+#endif
@@ -0,0 +1,167 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/AsyncFileReader.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Threading/AtomicInteger.h>
+
+namespace
+{
+  void TestAsyncFileReads(ezAsyncFileReader::Backend backend, ezStringView sFile, ezUInt32 uiFileSize)
+  {
+    ezAsyncFileReader reader(16, backend);
+
+    const ezUInt32 uiBlockSize = 4096 + 17;
+    const ezUInt32 uiNumBlocks = uiFileSize / uiBlockSize + 1; // the last block reaches past the end of the file
+
+    ezDynamicArray<ezUInt8> data;
+    data.SetCount(uiNumBlocks * uiBlockSize);
+
+    ezDynamicArray<ezAsyncFileRead> reads;
+    for (ezUInt32 i = 0; i < uiNumBlocks; ++i)
+    {
+      ezAsyncFileRead& read = reads.ExpandAndGetRef();
+      read.m_sAbsolutePath = sFile;
+      read.m_uiOffset = i * uiBlockSize;
+      read.m_uiSize = uiBlockSize;
+      read.m_pDestination = data.GetData() + i * uiBlockSize;
+      read.m_pUserData = reinterpret_cast<void*>(static_cast<ezUInt64>(i));
+    }
+
+    ezStringBuilder sMissingFile = sFile;
+    sMissingFile.ChangeFileName("DoesNotExist");
+
+    ezAsyncFileRead& missingRead = reads.ExpandAndGetRef();
+    missingRead.m_sAbsolutePath = sMissingFile;
+    missingRead.m_uiSize = uiBlockSize;
+    missingRead.m_pDestination = data.GetData();
+    missingRead.m_pUserData = reinterpret_cast<void*>(static_cast<ezUInt64>(uiNumBlocks));
+
+    ezAtomicInteger32 iNumSucceeded;
+    ezAtomicInteger32 iNumFailed;
+    ezAtomicInteger64 iBytesRead;
+
+    reader.Submit(reads, [&](const ezAsyncFileRead& read, ezUInt64 uiBytesRead, ezResult result)
+      {
+        if (result.Succeeded())
+          iNumSucceeded.Increment();
+        else
+          iNumFailed.Increment();
+
+        iBytesRead.Add(uiBytesRead);
+
+        // the last regular block and the missing file are the only ones that can't be read completely
+        const ezUInt64 uiIndex = reinterpret_cast<ezUInt64>(read.m_pUserData);
+        if (uiIndex < uiNumBlocks - 1)
+        {
+          EZ_TEST_INT(uiBytesRead, uiBlockSize);
+        } });
+
+    reader.WaitForAll();
+
+    EZ_TEST_INT(reader.GetNumPendingReads(), 0);
+    EZ_TEST_INT(iNumSucceeded, uiNumBlocks);
+    EZ_TEST_INT(iNumFailed, 1);
+    EZ_TEST_INT(iBytesRead, uiFileSize);
+
+    const ezUInt32* pValues = reinterpret_cast<const ezUInt32*>(data.GetData());
+    for (ezUInt32 i = 0; i < uiFileSize / sizeof(ezUInt32); ++i)
+    {
+      if (pValues[i] != i)
+      {
+        EZ_TEST_INT(pValues[i], i);
+        break;
+      }
+    }
+  }
+
+  ezTime MeasureAsyncThroughput(ezAsyncFileReader::Backend backend, ezStringView sFile, ezArrayPtr<ezUInt8> buffer, ezUInt32 uiBlockSize)
+  {
+    ezAsyncFileReader reader(32, backend);
+
+    ezDynamicArray<ezAsyncFileRead> reads;
+    for (ezUInt32 uiOffset = 0; uiOffset < buffer.GetCount(); uiOffset += uiBlockSize)
+    {
+      ezAsyncFileRead& read = reads.ExpandAndGetRef();
+      read.m_sAbsolutePath = sFile;
+      read.m_uiOffset = uiOffset;
+      read.m_uiSize = uiBlockSize;
+      read.m_pDestination = buffer.GetPtr() + uiOffset;
+    }
+
+    const ezTime t0 = ezTime::Now();
+    reader.Submit(reads, [](const ezAsyncFileRead&, ezUInt64, ezResult) {});
+    reader.WaitForAll();
+    return ezTime::Now() - t0;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(IO, AsyncFileReader)
+{
+  ezStringBuilder sOutputFile = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFile.MakeCleanPath();
+  sOutputFile.AppendPath("IO", "AsyncFileReader.dat");
+
+  const ezUInt32 uiFileSize = 1024 * 1024 * 4;
+
+  {
+    ezOSFile file;
+    if (!EZ_TEST_BOOL_MSG(file.Open(sOutputFile, ezFileOpenMode::Write).Succeeded(), "File for reading could not be created"))
+      return;
+
+    ezDynamicArray<ezUInt32> data;
+    data.SetCountUninitialized(uiFileSize / sizeof(ezUInt32));
+
+    for (ezUInt32 i = 0; i < data.GetCount(); ++i)
+    {
+      data[i] = i;
+    }
+
+    file.Write(data.GetData(), data.GetCount() * sizeof(ezUInt32)).IgnoreResult();
+    file.Close();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Default Backend")
+  {
+    TestAsyncFileReads(ezAsyncFileReader::Backend::Default, sOutputFile, uiFileSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Thread Pool Backend")
+  {
+    TestAsyncFileReads(ezAsyncFileReader::Backend::ThreadPool, sOutputFile, uiFileSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Throughput")
+  {
+    const ezUInt32 uiBlockSize = 64 * 1024;
+
+    ezDynamicArray<ezUInt8> buffer;
+    buffer.SetCountUninitialized(uiFileSize);
+
+    // the way resources are loaded so far, one blocking read after the other
+    ezTime tBlocking;
+    {
+      const ezTime t0 = ezTime::Now();
+
+      ezOSFile file;
+      EZ_TEST_BOOL(file.Open(sOutputFile, ezFileOpenMode::Read).Succeeded());
+
+      for (ezUInt32 uiOffset = 0; uiOffset < uiFileSize; uiOffset += uiBlockSize)
+      {
+        file.SetFilePosition(uiOffset, ezFileSeekMode::FromStart);
+        file.Read(buffer.GetData() + uiOffset, uiBlockSize);
+      }
+
+      tBlocking = ezTime::Now() - t0;
+    }
+
+    const ezTime tThreadPool = MeasureAsyncThroughput(ezAsyncFileReader::Backend::ThreadPool, sOutputFile, buffer, uiBlockSize);
+    const ezTime tDefault = MeasureAsyncThroughput(ezAsyncFileReader::Backend::Default, sOutputFile, buffer, uiBlockSize);
+
+    const double fMegaBytes = uiFileSize / (1024.0 * 1024.0);
+    ezLog::Info("[test]Blocking reads: {0} MB/s", ezArgF(fMegaBytes / tBlocking.GetSeconds(), 1));
+    ezLog::Info("[test]Async reads (thread pool): {0} MB/s", ezArgF(fMegaBytes / tThreadPool.GetSeconds(), 1));
+    ezLog::Info("[test]Async reads (default, io_uring: {0}): {1} MB/s", ezAsyncFileReader().UsesIoUring() ? "yes" : "no", ezArgF(fMegaBytes / tDefault.GetSeconds(), 1));
+  }
+
+  ezOSFile::DeleteFile(sOutputFile).IgnoreResult();
+}
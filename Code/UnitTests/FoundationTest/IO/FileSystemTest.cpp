@@ -363,4 +363,63 @@ Only concrete and clocks.\n\
 
     ezFileSystem::RemoveDataDirectoryGroup("remove");
   }
+
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Path Index")
+  {
+    ezStringBuilder sIndexedFolder = sOutputFolderResolved;
+    sIndexedFolder.AppendPath("IO", "PathIndex");
+
+    ezStringBuilder sExternalFile = sIndexedFolder;
+    sExternalFile.AppendPath("Sub", "External.txt");
+
+    EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sIndexedFolder).Succeeded());
+    ezOSFile::DeleteFile(sExternalFile).IgnoreResult();
+
+    ezDataDirectory::FolderType::s_bEnablePathIndex = true;
+    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sIndexedFolder, "PathIndex", "pathindex", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+    ezDataDirectory::FolderType::s_bEnablePathIndex = false;
+
+    auto pDataDir = static_cast<ezDataDirectory::FolderType*>(ezFileSystem::FindDataDirectoryWithRoot("pathindex"));
+    EZ_TEST_BOOL(pDataDir != nullptr && pDataDir->HasPathIndex());
+
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(":pathindex/Sub/External.txt"));
+
+    // files created and deleted behind the back of the file system must be picked up
+    {
+      ezOSFile file;
+      EZ_TEST_BOOL(file.Open(sExternalFile, ezFileOpenMode::Write).Succeeded());
+      EZ_TEST_BOOL(file.Write(sFileContent.GetData(), sFileContent.GetElementCount()).Succeeded());
+      file.Close();
+    }
+
+    // external changes are picked up once per frame
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(":pathindex/Sub/External.txt"));
+    ezFileSystem::PerFrameUpdate();
+    EZ_TEST_BOOL(ezFileSystem::ExistsFile(":pathindex/Sub/External.txt"));
+
+    {
+      ezFileReader FileIn;
+      EZ_TEST_BOOL(FileIn.Open(":pathindex/Sub/External.txt") == EZ_SUCCESS);
+      EZ_TEST_INT(FileIn.GetFileSize(), sFileContent.GetElementCount());
+    }
+
+    EZ_TEST_BOOL(ezOSFile::DeleteFile(sExternalFile).Succeeded());
+    ezFileSystem::PerFrameUpdate();
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(":pathindex/Sub/External.txt"));
+
+    // files written through the file system are available right away
+    {
+      ezFileWriter FileOut;
+      EZ_TEST_BOOL(FileOut.Open(":pathindex/Written.txt") == EZ_SUCCESS);
+      FileOut.Close();
+
+      EZ_TEST_BOOL(ezFileSystem::ExistsFile(":pathindex/Written.txt"));
+      ezFileSystem::DeleteFile(":pathindex/Written.txt");
+      EZ_TEST_BOOL(!ezFileSystem::ExistsFile(":pathindex/Written.txt"));
+    }
+
+    ezFileSystem::RemoveDataDirectoryGroup("PathIndex");
+  }
+#endif
 }
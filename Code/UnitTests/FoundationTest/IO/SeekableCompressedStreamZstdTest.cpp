@@ -0,0 +1,116 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/SeekableCompressedStreamZstd.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+EZ_CREATE_SIMPLE_TEST(IO, SeekableCompressedStreamZstd)
+{
+  ezDynamicArray<ezUInt32> TestData;
+  TestData.SetCountUninitialized(1024 * 1024 + 123);
+
+  for (ezUInt32 i = 0; i < TestData.GetCount(); ++i)
+  {
+    TestData[i] = i / 7;
+  }
+
+  const ezUInt64 uiDataSize = TestData.GetCount() * sizeof(ezUInt32);
+  const ezUInt32 uiFrameSize = 16 * 1024;
+
+  ezDynamicArray<ezUInt8> Compressed;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compress Data")
+  {
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&Compressed);
+    ezMemoryStreamWriter writer(&storage);
+
+    ezSeekableCompressedStreamWriterZstd CompressedWriter(&writer, ezCompressedStreamWriterZstd::Compression::Fast, uiFrameSize / 1024);
+
+    // write in sizes that don't align with the frames
+    const ezUInt8* pData = reinterpret_cast<const ezUInt8*>(TestData.GetData());
+    ezUInt64 uiWrite = 1;
+    for (ezUInt64 uiPos = 0; uiPos < uiDataSize; uiPos += uiWrite)
+    {
+      uiWrite = ezMath::Min<ezUInt64>(uiWrite + 997, uiDataSize - uiPos);
+      EZ_TEST_BOOL(CompressedWriter.WriteBytes(pData + uiPos, uiWrite).Succeeded());
+    }
+
+    EZ_TEST_BOOL(CompressedWriter.FinishCompressedStream().Succeeded());
+
+    EZ_TEST_INT(CompressedWriter.GetUncompressedSize(), uiDataSize);
+    EZ_TEST_INT(CompressedWriter.GetWrittenBytes(), Compressed.GetCount());
+    EZ_TEST_BOOL(Compressed.GetCount() < uiDataSize / 10);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read Sequentially")
+  {
+    ezSeekableCompressedStreamReaderZstd CompressedReader;
+    if (!EZ_TEST_BOOL(CompressedReader.SetInputData(Compressed.GetData(), Compressed.GetCount()).Succeeded()))
+      return;
+
+    EZ_TEST_INT(CompressedReader.GetUncompressedSize(), uiDataSize);
+
+    ezDynamicArray<ezUInt32> TestDataRead;
+    TestDataRead.SetCount(TestData.GetCount());
+
+    // alternate between reading and skipping blocks that get larger and larger
+    bool bSkip = false;
+    ezUInt32 uiStartPos = 0;
+
+    for (ezUInt32 uiRead = 1; uiStartPos < TestData.GetCount(); uiRead += 1013)
+    {
+      const ezUInt32 uiToRead = ezMath::Min(uiRead, TestData.GetCount() - uiStartPos);
+
+      if (bSkip)
+      {
+        EZ_TEST_INT(CompressedReader.SkipBytes(sizeof(ezUInt32) * uiToRead), sizeof(ezUInt32) * uiToRead);
+        ezMemoryUtils::Copy(&TestDataRead[uiStartPos], &TestData[uiStartPos], uiToRead);
+      }
+      else
+      {
+        EZ_TEST_INT(CompressedReader.ReadBytes(&TestDataRead[uiStartPos], sizeof(ezUInt32) * uiToRead), sizeof(ezUInt32) * uiToRead);
+      }
+
+      bSkip = !bSkip;
+      uiStartPos += uiToRead;
+    }
+
+    EZ_TEST_BOOL(TestData == TestDataRead);
+
+    ezUInt32 uiTemp = 0;
+    EZ_TEST_INT(CompressedReader.ReadBytes(&uiTemp, sizeof(ezUInt32)), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Random Access")
+  {
+    ezSeekableCompressedStreamReaderZstd CompressedReader;
+    if (!EZ_TEST_BOOL(CompressedReader.SetInputData(Compressed.GetData(), Compressed.GetCount()).Succeeded()))
+      return;
+
+    // the tail, across a frame boundary, a whole aligned frame, and backwards
+    const ezUInt32 uiPositions[] = {TestData.GetCount() - 100, uiFrameSize / 4 - 10, 2 * uiFrameSize / 4, 17, 0};
+    const ezUInt32 uiCounts[] = {100, 20, uiFrameSize / 4, 1, 5};
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(uiPositions); ++i)
+    {
+      ezDynamicArray<ezUInt32> values;
+      values.SetCount(uiCounts[i]);
+
+      CompressedReader.SetReadPosition(uiPositions[i] * sizeof(ezUInt32));
+      EZ_TEST_INT(CompressedReader.ReadBytes(values.GetData(), values.GetCount() * sizeof(ezUInt32)), values.GetCount() * sizeof(ezUInt32));
+      EZ_TEST_INT(CompressedReader.GetReadPosition(), (uiPositions[i] + uiCounts[i]) * sizeof(ezUInt32));
+
+      EZ_TEST_BOOL(values.GetArrayPtr() == TestData.GetArrayPtr().GetSubArray(uiPositions[i], uiCounts[i]));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid Data")
+  {
+    ezSeekableCompressedStreamReaderZstd CompressedReader;
+    EZ_TEST_BOOL(CompressedReader.SetInputData(Compressed.GetData(), Compressed.GetCount() - 1).Failed());
+    EZ_TEST_BOOL(CompressedReader.SetInputData(TestData.GetData(), 1024).Failed());
+  }
+}
+
+#endif
@@ -1,11 +1,14 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
 
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Math/Random.h>
 #include <Foundation/Memory/MemoryTracker.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Texture/Image/Formats/BmpFileFormat.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/Image/Formats/ImageFileFormat.h>
@@ -230,3 +233,339 @@ private:
 };
 
 static ezImageConversionTest s_ImageConversionTest;
+
+namespace
+{
+  void CreateRandomImage(ezImage& ref_image, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiNumMipLevels)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetNumMipLevels(uiNumMipLevels);
+    ref_image.ResetAndAlloc(header);
+
+    ezRandom rng;
+    rng.Initialize(uiWidth * 7 + uiHeight * 13);
+
+    for (float& f : ref_image.GetBlobPtr<float>())
+    {
+      f = static_cast<float>(rng.DoubleZeroToOneInclusive());
+    }
+  }
+
+  /// Converts a single 2D image by running each step of the conversion path on the full image, the way ezImageConversion did it before
+  /// it processed the steps in tiles.
+  ezResult ReferenceConvert(const ezImageView& source, ezImage& ref_target, ezImageFormat::Enum targetFormat)
+  {
+    ezHybridArray<ezImageConversion::ConversionPathNode, 16> path;
+    ezUInt32 uiNumScratchBuffers = 0;
+    if (ezImageConversion::BuildPath(source.GetImageFormat(), targetFormat, false, path, uiNumScratchBuffers).Failed())
+      return EZ_FAILURE;
+
+    ezImage current;
+    current.ResetAndCopy(source);
+
+    for (const auto& node : path)
+    {
+      ezImageHeader header = current.GetHeader();
+      header.SetImageFormat(node.m_targetFormat);
+
+      ezImage next;
+      next.ResetAndAlloc(header);
+
+      if (node.m_step == nullptr)
+      {
+        next.ResetAndCopy(current);
+      }
+      else if (!ezImageFormat::IsCompressed(node.m_targetFormat))
+      {
+        const ezUInt64 uiNumElements = ezUInt64(current.GetWidth()) * current.GetHeight();
+        if (static_cast<const ezImageConversionStepLinear*>(node.m_step)->ConvertPixels(current.GetByteBlobPtr(), next.GetByteBlobPtr(), uiNumElements, node.m_sourceFormat, node.m_targetFormat).Failed())
+          return EZ_FAILURE;
+      }
+      else
+      {
+        const ezUInt32 uiNumBlocksX = next.GetNumBlocksX();
+        const ezUInt32 uiNumBlocksY = next.GetNumBlocksY();
+
+        ezImageHeader paddedHeader = current.GetHeader();
+        paddedHeader.SetWidth(uiNumBlocksX * ezImageFormat::GetBlockWidth(node.m_targetFormat));
+        paddedHeader.SetHeight(uiNumBlocksY * ezImageFormat::GetBlockHeight(node.m_targetFormat));
+
+        ezImage padded;
+        padded.ResetAndAlloc(paddedHeader);
+
+        const ezUInt32 uiBytesPerPixel = ezImageFormat::GetBitsPerPixel(node.m_sourceFormat) / 8;
+        for (ezUInt32 y = 0; y < padded.GetHeight(); ++y)
+        {
+          for (ezUInt32 x = 0; x < padded.GetWidth(); ++x)
+          {
+            const ezUInt32 sourceX = ezMath::Min(x, current.GetWidth() - 1);
+            const ezUInt32 sourceY = ezMath::Min(y, current.GetHeight() - 1);
+            ezMemoryUtils::Copy(padded.GetPixelPointer<ezUInt8>(0, 0, 0, x, y), current.GetPixelPointer<ezUInt8>(0, 0, 0, sourceX, sourceY), uiBytesPerPixel);
+          }
+        }
+
+        if (static_cast<const ezImageConversionStepCompressBlocks*>(node.m_step)->CompressBlocks(padded.GetByteBlobPtr(), next.GetByteBlobPtr(), uiNumBlocksX, uiNumBlocksY, node.m_sourceFormat, node.m_targetFormat).Failed())
+          return EZ_FAILURE;
+      }
+
+      current.ResetAndMove(std::move(next));
+    }
+
+    ref_target.ResetAndMove(std::move(current));
+    return EZ_SUCCESS;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, ImageConversionTiled)
+{
+  const ezImageFormat::Enum targetFormats[] = {ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::B8G8R8A8_UNORM, ezImageFormat::B5G6R5_UNORM, ezImageFormat::R16G16_FLOAT, ezImageFormat::R8_UNORM, ezImageFormat::BC1_UNORM, ezImageFormat::BC3_UNORM_SRGB, ezImageFormat::BC4_UNORM};
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Convert - Matches Reference")
+  {
+    const ezVec2U32 sizes[] = {ezVec2U32(256, 128), ezVec2U32(301, 203), ezVec2U32(3, 2), ezVec2U32(1, 1)};
+
+    for (const ezVec2U32& size : sizes)
+    {
+      ezImage source;
+      CreateRandomImage(source, size.x, size.y, 1);
+
+      for (ezImageFormat::Enum format : targetFormats)
+      {
+        if (!ezImageConversion::IsConvertible(ezImageFormat::R32G32B32A32_FLOAT, format))
+          continue;
+
+        ezImage result, expected;
+        EZ_TEST_BOOL(ezImageConversion::Convert(source, result, format).Succeeded());
+        EZ_TEST_BOOL(ReferenceConvert(source, expected, format).Succeeded());
+
+        EZ_TEST_INT(result.GetImageFormat(), format);
+        EZ_TEST_BOOL_MSG(result.GetByteBlobPtr().GetCount() == expected.GetByteBlobPtr().GetCount() &&
+                           ezMemoryUtils::IsEqual(result.GetByteBlobPtr().GetPtr(), expected.GetByteBlobPtr().GetPtr(), static_cast<size_t>(result.GetByteBlobPtr().GetCount())),
+          "Converting a %ux%u image to %s differs from the reference", size.x, size.y, ezImageFormat::GetName(format));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Convert - Mip Levels")
+  {
+    ezImage source;
+    CreateRandomImage(source, 64, 32, 7);
+
+    for (ezImageFormat::Enum format : targetFormats)
+    {
+      if (!ezImageConversion::IsConvertible(ezImageFormat::R32G32B32A32_FLOAT, format))
+        continue;
+
+      ezImage result;
+      EZ_TEST_BOOL(ezImageConversion::Convert(source, result, format).Succeeded());
+      EZ_TEST_INT(result.GetNumMipLevels(), 7);
+
+      for (ezUInt32 mipLevel = 0; mipLevel < 7; ++mipLevel)
+      {
+        ezImage mip, expected;
+        mip.ResetAndCopy(source.GetSubImageView(mipLevel));
+        EZ_TEST_BOOL(ReferenceConvert(mip, expected, format).Succeeded());
+
+        const ezConstByteBlobPtr resultData = result.GetSubImageView(mipLevel).GetByteBlobPtr();
+        EZ_TEST_BOOL_MSG(resultData.GetCount() == expected.GetByteBlobPtr().GetCount() &&
+                           ezMemoryUtils::IsEqual(resultData.GetPtr(), expected.GetByteBlobPtr().GetPtr(), static_cast<size_t>(resultData.GetCount())),
+          "Mip level %u of %s differs from the reference", mipLevel, ezImageFormat::GetName(format));
+      }
+    }
+  }
+
+  // BC7 compression is by far the slowest conversion, so it only gets a single small image
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Convert - BC7")
+  {
+    if (ezImageConversion::IsConvertible(ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::BC7_UNORM))
+    {
+      ezImage source;
+      CreateRandomImage(source, 13, 9, 1);
+
+      ezImage result, expected;
+      EZ_TEST_BOOL(ezImageConversion::Convert(source, result, ezImageFormat::BC7_UNORM).Succeeded());
+      EZ_TEST_BOOL(ReferenceConvert(source, expected, ezImageFormat::BC7_UNORM).Succeeded());
+
+      EZ_TEST_INT(result.GetImageFormat(), ezImageFormat::BC7_UNORM);
+      EZ_TEST_BOOL(result.GetByteBlobPtr().GetCount() == expected.GetByteBlobPtr().GetCount() &&
+                   ezMemoryUtils::IsEqual(result.GetByteBlobPtr().GetPtr(), expected.GetByteBlobPtr().GetPtr(), static_cast<size_t>(result.GetByteBlobPtr().GetCount())));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Convert - In Place")
+  {
+    ezImage source, expected;
+    CreateRandomImage(source, 45, 31, 1);
+    EZ_TEST_BOOL(ReferenceConvert(source, expected, ezImageFormat::B5G6R5_UNORM).Succeeded());
+
+    EZ_TEST_BOOL(ezImageConversion::Convert(source, source, ezImageFormat::B5G6R5_UNORM).Succeeded());
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(source.GetByteBlobPtr().GetPtr(), expected.GetByteBlobPtr().GetPtr(), static_cast<size_t>(expected.GetByteBlobPtr().GetCount())));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ConvertRaw - Matches Reference")
+  {
+    ezImage source, expected;
+    CreateRandomImage(source, 1000, 77, 1);
+    EZ_TEST_BOOL(ReferenceConvert(source, expected, ezImageFormat::B5G6R5_UNORM).Succeeded());
+
+    ezDynamicArray<ezUInt8> result;
+    result.SetCount(static_cast<ezUInt32>(expected.GetByteBlobPtr().GetCount()));
+    EZ_TEST_BOOL(ezImageConversion::ConvertRaw(source.GetByteBlobPtr(), ezByteBlobPtr(result.GetData(), result.GetCount()), 1000 * 77, ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::B5G6R5_UNORM).Succeeded());
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(result.GetData(), expected.GetByteBlobPtr().GetPtr(), result.GetCount()));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Performance")
+  {
+    ezImage source;
+    CreateRandomImage(source, 2048, 2048, 1);
+
+    const ezImageFormat::Enum perfFormats[] = {ezImageFormat::B5G6R5_UNORM, ezImageFormat::BC1_UNORM};
+
+    for (ezImageFormat::Enum format : perfFormats)
+    {
+      if (!ezImageConversion::IsConvertible(ezImageFormat::R32G32B32A32_FLOAT, format))
+        continue;
+
+      ezHybridArray<ezImageConversion::ConversionPathNode, 16> path;
+      ezUInt32 uiNumScratchBuffers = 0;
+      EZ_TEST_BOOL(ezImageConversion::BuildPath(ezImageFormat::R32G32B32A32_FLOAT, format, false, path, uiNumScratchBuffers).Succeeded());
+
+      ezImage result;
+      ezStopwatch sw;
+      EZ_TEST_BOOL(ezImageConversion::Convert(source, result, format).Succeeded());
+
+      ezTestFramework::Output(ezTestOutput::Duration, "2048x2048 RGBA32F to %s (%u steps): %.2fms", ezImageFormat::GetName(format), path.GetCount(), sw.GetRunningTotal().GetMilliseconds());
+    }
+  }
+}
+
+namespace
+{
+  void CreateSmoothImage(ezImage& ref_image, ezUInt32 uiSize, float fRange, bool bOpaque)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(uiSize);
+    header.SetHeight(uiSize);
+    ref_image.ResetAndAlloc(header);
+
+    ezRandom rng;
+    rng.Initialize(uiSize);
+
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        const float fx = static_cast<float>(x) / uiSize;
+        const float fy = static_cast<float>(y) / uiSize;
+        const float noise = static_cast<float>(rng.DoubleInRange(-0.02, 0.04));
+
+        ezColor& color = *ref_image.GetPixelPointer<ezColor>(0, 0, 0, x, y);
+        color.r = ezMath::Clamp(0.5f + 0.5f * ezMath::Sin(ezAngle::MakeFromRadian(fx * 9.0f)) * fy + noise, 0.0f, 1.0f) * fRange;
+        color.g = ezMath::Clamp(fy + noise, 0.0f, 1.0f) * fRange;
+        color.b = ezMath::Clamp(0.5f + 0.5f * ezMath::Cos(ezAngle::MakeFromRadian((fx + fy) * 5.0f)) + noise, 0.0f, 1.0f) * fRange;
+        color.a = bOpaque ? 1.0f : ezMath::Clamp(1.0f - fx * fy + noise, 0.0f, 1.0f);
+      }
+    }
+  }
+
+  /// Compresses the image, decompresses it again and returns the root mean square error of the first uiNumChannels channels.
+  float MeasureCompressionError(const ezImage& source, ezImageFormat::Enum format, ezUInt32 uiNumChannels, ezTime& out_duration)
+  {
+    ezImage compressed, decompressed;
+
+    ezStopwatch sw;
+    if (ezImageConversion::Convert(source, compressed, format).Failed())
+      return ezMath::MaxValue<float>();
+    out_duration = sw.GetRunningTotal();
+
+    if (ezImageConversion::Convert(compressed, decompressed, ezImageFormat::R32G32B32A32_FLOAT).Failed())
+      return ezMath::MaxValue<float>();
+
+    double fSumSquaredError = 0.0;
+    const float* pSource = source.GetBlobPtr<float>().GetPtr();
+    const float* pResult = decompressed.GetBlobPtr<float>().GetPtr();
+
+    const ezUInt32 uiNumPixels = source.GetWidth() * source.GetHeight();
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+      {
+        const double fError = pSource[i * 4 + c] - pResult[i * 4 + c];
+        fSumSquaredError += fError * fError;
+      }
+    }
+
+    return static_cast<float>(ezMath::Sqrt(fSumSquaredError / (uiNumPixels * uiNumChannels)));
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, ImageCompressionQuality)
+{
+  struct FormatInfo
+  {
+    ezImageFormat::Enum m_Format;
+    ezUInt32 m_uiNumChannels;
+    float m_fRange;
+    float m_fMaxError;
+    bool m_bHasQualityTiers;
+  };
+
+  const FormatInfo formats[] = {
+    {ezImageFormat::BC1_UNORM, 3, 1.0f, 0.03f, false},
+    {ezImageFormat::BC3_UNORM, 4, 1.0f, 0.03f, false},
+    {ezImageFormat::BC4_UNORM, 1, 1.0f, 0.02f, false},
+    {ezImageFormat::BC5_UNORM, 2, 1.0f, 0.02f, false},
+    {ezImageFormat::BC7_UNORM, 4, 1.0f, 0.02f, true},
+    {ezImageFormat::BC6H_UF16, 3, 8.0f, 0.2f, false},
+  };
+
+  // the quality tiers only exist for the CPU compressors
+  ezCVarInt* pQuality = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("Texture.CompressionQuality"));
+  const ezInt32 iPrevQuality = pQuality ? pQuality->GetValue() : 1;
+
+  for (const FormatInfo& info : formats)
+  {
+    if (!ezImageConversion::IsConvertible(ezImageFormat::R32G32B32A32_FLOAT, info.m_Format))
+      continue;
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, ezImageFormat::GetName(info.m_Format))
+    {
+      // the CPU encoders for BC6H and BC7 are slow, so keep the image small
+      ezImage source;
+      CreateSmoothImage(source, 64, info.m_fRange, info.m_uiNumChannels < 4);
+
+      const ezInt32 iMinQuality = (pQuality && info.m_bHasQualityTiers) ? 0 : 1;
+      const ezInt32 iMaxQuality = (pQuality && info.m_bHasQualityTiers) ? 2 : 1;
+
+      float fPrevError = ezMath::MaxValue<float>();
+
+      for (ezInt32 iQuality = iMinQuality; iQuality <= iMaxQuality; ++iQuality)
+      {
+        if (pQuality)
+        {
+          *pQuality = iQuality;
+        }
+
+        ezTime duration;
+        const float fError = MeasureCompressionError(source, info.m_Format, info.m_uiNumChannels, duration);
+
+        EZ_TEST_FLOAT(fError, 0.0f, info.m_fMaxError);
+
+        // a higher quality must not be worse, allow for tiny differences from the different error metric of the encoder
+        EZ_TEST_BOOL(fError <= fPrevError * 1.01f);
+        fPrevError = fError;
+
+        ezTestFramework::Output(ezTestOutput::Duration, "%s quality %i: 64x64 in %.2fms, RMSE %.5f", ezImageFormat::GetName(info.m_Format), iQuality, duration.GetMilliseconds(), fError);
+      }
+    }
+  }
+
+  if (pQuality)
+  {
+    *pQuality = iPrevQuality;
+  }
+}
@@ -3,6 +3,9 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Texture/Image/ImageUtils.h>
 
 
@@ -118,3 +121,222 @@ EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
 
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
+
+namespace
+{
+  // straightforward version of the separable filtering in ezImageUtils::Scale3D(), one output texel at a time
+  void ReferenceFilterAxis(const ezImageView& source, ezImage& ref_target, ezUInt32 uiAxis, ezUInt32 uiTargetSize, const ezImageFilter& filter, ezImageAddressMode::Enum addressMode, const ezSimdVec4f& vBorderColor)
+  {
+    const ezUInt32 sourceSize[3] = {source.GetWidth(), source.GetHeight(), source.GetDepth()};
+
+    ezImageHeader header = source.GetHeader();
+    if (uiAxis == 0)
+      header.SetWidth(uiTargetSize);
+    else if (uiAxis == 1)
+      header.SetHeight(uiTargetSize);
+    else
+      header.SetDepth(uiTargetSize);
+
+    ref_target.ResetAndAlloc(header);
+
+    const ezImageFilterWeights weights(filter, sourceSize[uiAxis], uiTargetSize);
+
+    for (ezUInt32 arrayIndex = 0; arrayIndex < header.GetNumArrayIndices(); ++arrayIndex)
+    {
+      for (ezUInt32 face = 0; face < header.GetNumFaces(); ++face)
+      {
+        for (ezUInt32 z = 0; z < header.GetDepth(); ++z)
+        {
+          for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+          {
+            for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+            {
+              ezUInt32 coords[3] = {x, y, z};
+              const ezUInt32 uiTargetIndex = coords[uiAxis];
+              const ezInt32 iFirstSourceIndex = weights.GetFirstSourceSampleIndex(uiTargetIndex);
+
+              ezSimdVec4f total(0.0f, 0.0f, 0.0f, 0.0f);
+
+              for (ezUInt32 w = 0; w < weights.GetNumWeights(); ++w)
+              {
+                bool bUseBorderColor = false;
+                coords[uiAxis] = ezImageUtils::GetSampleIndex(sourceSize[uiAxis], iFirstSourceIndex + static_cast<ezInt32>(w), addressMode, bUseBorderColor);
+
+                const ezSimdVec4f sample = bUseBorderColor ? vBorderColor : *source.GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, coords[0], coords[1], coords[2]);
+                total = ezSimdVec4f::MulAdd(sample, ezSimdVec4f((float)weights.GetWeight(uiTargetIndex, w)), total);
+              }
+
+              *ref_target.GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, z) = total;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void ReferenceScale(const ezImageView& source, ezImage& ref_target, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth, const ezImageFilter& filter, ezImageAddressMode::Enum addressMode, const ezColor& borderColor)
+  {
+    const ezSimdVec4f vBorderColor(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+    const ezUInt32 targetSize[3] = {uiWidth, uiHeight, uiDepth};
+
+    ezImage current;
+    current.ResetAndCopy(source);
+
+    for (ezUInt32 uiAxis = 0; uiAxis < 3; ++uiAxis)
+    {
+      const ezUInt32 sourceSize[3] = {current.GetWidth(), current.GetHeight(), current.GetDepth()};
+      if (sourceSize[uiAxis] == targetSize[uiAxis])
+        continue;
+
+      ezImage next;
+      ReferenceFilterAxis(current, next, uiAxis, targetSize[uiAxis], filter, addressMode, vBorderColor);
+      current.ResetAndMove(std::move(next));
+    }
+
+    ref_target.ResetAndMove(std::move(current));
+  }
+
+  void CreateRandomImage(ezImage& ref_image, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth, ezUInt32 uiNumFaces, ezUInt32 uiNumArrayIndices)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetDepth(uiDepth);
+    header.SetNumFaces(uiNumFaces);
+    header.SetNumArrayIndices(uiNumArrayIndices);
+    ref_image.ResetAndAlloc(header);
+
+    ezRandom rng;
+    rng.Initialize(uiWidth * 7 + uiHeight * 13 + uiDepth);
+
+    for (float& f : ref_image.GetBlobPtr<float>())
+    {
+      f = static_cast<float>(rng.DoubleZeroToOneInclusive());
+    }
+  }
+
+  bool IsIdentical(const ezImageView& a, const ezImageView& b)
+  {
+    if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight() || a.GetDepth() != b.GetDepth() || a.GetNumFaces() != b.GetNumFaces() ||
+        a.GetNumArrayIndices() != b.GetNumArrayIndices() || a.GetNumMipLevels() != b.GetNumMipLevels())
+      return false;
+
+    const ezConstByteBlobPtr dataA = a.GetByteBlobPtr();
+    const ezConstByteBlobPtr dataB = b.GetByteBlobPtr();
+    return dataA.GetCount() == dataB.GetCount() && ezMemoryUtils::IsEqual(dataA.GetPtr(), dataB.GetPtr(), static_cast<size_t>(dataA.GetCount()));
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, ImageUtilsScale)
+{
+  const ezImageFilterTriangle triangleFilter;
+  const ezImageFilterSincWithKaiserWindow kaiserFilter;
+  const ezImageFilter* filters[] = {&triangleFilter, &kaiserFilter};
+  const ezImageAddressMode::Enum addressModes[] = {ezImageAddressMode::Clamp, ezImageAddressMode::Repeat, ezImageAddressMode::Mirror, ezImageAddressMode::ClampBorder};
+  const ezColor borderColor(0.1f, 0.2f, 0.3f, 0.4f);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale - Matches Reference")
+  {
+    ezImage source;
+    CreateRandomImage(source, 67, 45, 1, 1, 2);
+
+    const ezVec2U32 targetSizes[] = {ezVec2U32(33, 22), ezVec2U32(130, 91), ezVec2U32(67, 10), ezVec2U32(5, 45), ezVec2U32(1, 1)};
+
+    for (const ezImageFilter* pFilter : filters)
+    {
+      for (ezImageAddressMode::Enum addressMode : addressModes)
+      {
+        for (const ezVec2U32& size : targetSizes)
+        {
+          ezImage result, expected;
+          EZ_TEST_BOOL(ezImageUtils::Scale(source, result, size.x, size.y, pFilter, addressMode, addressMode, borderColor).Succeeded());
+          ReferenceScale(source, expected, size.x, size.y, 1, *pFilter, addressMode, borderColor);
+
+          EZ_TEST_BOOL_MSG(IsIdentical(result, expected), "Scaling to %ux%u differs from the reference", size.x, size.y);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D - Matches Reference")
+  {
+    ezImage source;
+    CreateRandomImage(source, 20, 18, 23, 1, 1);
+
+    for (const ezImageFilter* pFilter : filters)
+    {
+      ezImage result, expected;
+      EZ_TEST_BOOL(ezImageUtils::Scale3D(source, result, 9, 7, 11, pFilter, ezImageAddressMode::Clamp, ezImageAddressMode::Repeat, ezImageAddressMode::Mirror, borderColor).Succeeded());
+
+      ezImage expectedX, expectedY;
+      ReferenceFilterAxis(source, expectedX, 0, 9, *pFilter, ezImageAddressMode::Clamp, ezSimdVec4f::MakeZero());
+      ReferenceFilterAxis(expectedX, expectedY, 1, 7, *pFilter, ezImageAddressMode::Repeat, ezSimdVec4f::MakeZero());
+      ReferenceFilterAxis(expectedY, expected, 2, 11, *pFilter, ezImageAddressMode::Mirror, ezSimdVec4f::MakeZero());
+
+      EZ_TEST_BOOL(IsIdentical(result, expected));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GenerateMipMaps - Matches Reference")
+  {
+    ezImage source;
+    CreateRandomImage(source, 64, 64, 1, 6, 1);
+
+    for (const ezImageFilter* pFilter : filters)
+    {
+      ezImageUtils::MipMapOptions options;
+      options.m_filter = pFilter;
+
+      ezImage result;
+      ezImageUtils::GenerateMipMaps(source, result, options);
+
+      EZ_TEST_INT(result.GetNumMipLevels(), 7);
+
+      for (ezUInt32 face = 0; face < 6; ++face)
+      {
+        ezImage expected;
+        expected.ResetAndCopy(source.GetSubImageView(0, face, 0));
+
+        for (ezUInt32 mip = 1; mip < result.GetNumMipLevels(); ++mip)
+        {
+          ezImage next;
+          ReferenceScale(expected, next, expected.GetWidth() / 2, expected.GetHeight() / 2, 1, *pFilter, ezImageAddressMode::Clamp, ezColor::Black);
+          expected.ResetAndMove(std::move(next));
+
+          EZ_TEST_BOOL_MSG(IsIdentical(result.GetSubImageView(mip, face, 0), expected), "Mip %u of face %u differs from the reference", mip, face);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Performance")
+  {
+    ezImage source;
+    CreateRandomImage(source, 2048, 2048, 1, 1, 1);
+
+    ezImage cubemap;
+    CreateRandomImage(cubemap, 512, 512, 1, 6, 1);
+
+    const char* filterNames[] = {"Linear", "Kaiser"};
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(filters); ++i)
+    {
+      ezImage result;
+
+      ezStopwatch sw;
+      ezImageUtils::Scale(source, result, 1024, 1024, filters[i]).IgnoreResult();
+      const ezTime tScale = sw.Checkpoint();
+
+      ezImageUtils::MipMapOptions options;
+      options.m_filter = filters[i];
+      ezImageUtils::GenerateMipMaps(source, result, options);
+      const ezTime tMipMaps = sw.Checkpoint();
+
+      ezImageUtils::GenerateMipMaps(cubemap, result, options);
+      const ezTime tCubeMipMaps = sw.Checkpoint();
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: scale 2048 to 1024 %.1fms, mipmaps 2048 %.1fms, cubemap mipmaps 6x512 %.1fms", filterNames[i], tScale.GetMilliseconds(), tMipMaps.GetMilliseconds(), tCubeMipMaps.GetMilliseconds());
+    }
+  }
+}
@@ -2,7 +2,9 @@
 
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
 namespace
@@ -21,6 +23,63 @@ namespace
       ezLog::Info("Profiling capture saved to '{0}'.", fileWriter.GetFilePathAbsolute().GetData());
     }
   }
+
+  const ezProfilingSystem::CPUScope* FindCapturedScope(const ezProfilingSystem::ProfilingData& profilingData, ezStringView sName)
+  {
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        if (sName == scope.m_szName)
+          return &scope;
+      }
+    }
+
+    return nullptr;
+  }
+
+  class ProfiledThread : public ezThread
+  {
+  public:
+    ProfiledThread()
+      : ezThread("Profiled Thread")
+    {
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      for (ezUInt32 i = 0; i < 100; ++i)
+      {
+        EZ_PROFILE_SCOPE("Scope of exited thread");
+      }
+
+      return 0;
+    }
+  };
+
+  class RecordingThread : public ezThread
+  {
+  public:
+    RecordingThread(const ezAtomicBool& bStop)
+      : ezThread("Recording Thread")
+      , m_bStop(bStop)
+    {
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (!m_bStop)
+      {
+        EZ_PROFILE_SCOPE("Scope of recording thread");
+      }
+
+      return 0;
+    }
+
+    const ezAtomicBool& m_bStop;
+  };
 } // namespace
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Profiling);
@@ -52,4 +111,315 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
 
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Captured names and times")
+  {
+    ezProfilingSystem::Clear();
+
+    ezStringBuilder sDynamicName;
+    sDynamicName.SetFormat("Dynamic scope {}", 42);
+
+    const ezTime startTime = ezTime::Now();
+
+    {
+      EZ_PROFILE_SCOPE("Literal scope");
+
+      {
+        EZ_PROFILE_SCOPE(sDynamicName);
+        ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(2));
+      }
+    }
+
+    const ezTime endTime = ezTime::Now();
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezProfilingSystem::Capture(profilingData);
+
+    const ezProfilingSystem::CPUScope* pLiteral = FindCapturedScope(profilingData, "Literal scope");
+    const ezProfilingSystem::CPUScope* pDynamic = FindCapturedScope(profilingData, "Dynamic scope 42");
+
+    if (EZ_TEST_BOOL(pLiteral != nullptr && pDynamic != nullptr))
+    {
+      EZ_TEST_BOOL(pLiteral->m_szFunctionName != nullptr);
+      EZ_TEST_BOOL(pLiteral->m_BeginTime >= startTime - ezTime::MakeFromMicroseconds(1));
+      EZ_TEST_BOOL(pLiteral->m_EndTime <= endTime + ezTime::MakeFromMicroseconds(1));
+      EZ_TEST_BOOL(pLiteral->m_BeginTime <= pDynamic->m_BeginTime);
+      EZ_TEST_BOOL(pLiteral->m_EndTime >= pDynamic->m_EndTime);
+      EZ_TEST_BOOL(pDynamic->m_EndTime - pDynamic->m_BeginTime >= ezTime::MakeFromMilliseconds(1.9));
+    }
+
+    EZ_TEST_INT(ezProfilingSystem::InternScopeName("Literal scope", "Function"), ezProfilingSystem::InternScopeName(ezStringBuilder("Literal scope"), "Function"));
+    EZ_TEST_BOOL(ezProfilingSystem::InternScopeName("Literal scope", "Function") != ezProfilingSystem::InternScopeName("Other scope", "Function"));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Dynamic name limit")
+  {
+    ezProfilingSystem::SetDiscardThreshold(ezTime::MakeZero());
+    ezProfilingSystem::Clear();
+
+    // more unique names than the profiling system accepts from one function, the ones beyond the limit share a placeholder name
+    constexpr ezUInt32 uiNumNames = 5000;
+
+    ezStringBuilder sDynamicName;
+    for (ezUInt32 i = 0; i < uiNumNames; ++i)
+    {
+      sDynamicName.SetFormat("Unique dynamic scope {}", i);
+      EZ_PROFILE_SCOPE(sDynamicName);
+    }
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezProfilingSystem::Capture(profilingData);
+
+    EZ_TEST_BOOL(FindCapturedScope(profilingData, "Unique dynamic scope 0") != nullptr);
+    EZ_TEST_BOOL(FindCapturedScope(profilingData, "Unique dynamic scope 4999") == nullptr);
+    EZ_TEST_BOOL(FindCapturedScope(profilingData, "(too many dynamic scope names)") != nullptr);
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::MakeFromMilliseconds(0.1));
+    ezProfilingSystem::Clear();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scope Cost")
+  {
+    constexpr ezUInt32 uiNumScopes = 100000;
+
+    // measures the overhead of scopes that get discarded (the common case) and of scopes that get recorded
+    for (ezUInt32 uiRecord = 0; uiRecord < 2; ++uiRecord)
+    {
+      ezProfilingSystem::SetDiscardThreshold(uiRecord == 0 ? ezTime::MakeFromMilliseconds(0.1) : ezTime::MakeZero());
+      ezProfilingSystem::Clear();
+
+      const ezTime t0 = ezTime::Now();
+
+      for (ezUInt32 i = 0; i < uiNumScopes; ++i)
+      {
+        EZ_PROFILE_SCOPE("Benchmark scope");
+      }
+
+      const ezTime t1 = ezTime::Now();
+
+      ezStringBuilder sDynamicName("Benchmark dynamic scope");
+      for (ezUInt32 i = 0; i < uiNumScopes; ++i)
+      {
+        EZ_PROFILE_SCOPE(sDynamicName);
+      }
+
+      const ezTime t2 = ezTime::Now();
+
+      ezLog::Info("[test]Profiling scope ({}): {} ns (literal name), {} ns (dynamic name)", uiRecord == 0 ? "discarded" : "recorded", ezArgF((t1 - t0).GetNanoseconds() / uiNumScopes, 1), ezArgF((t2 - t1).GetNanoseconds() / uiNumScopes, 1));
+    }
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::MakeFromMilliseconds(0.1));
+    ezProfilingSystem::Clear();
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Profiling, StreamingCapture)
+{
+  ezStringBuilder sFile = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sFile.AppendPath("profilingStream.ezProfile");
+
+  ezProfilingSystem::SetDiscardThreshold(ezTime::MakeZero());
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Continuous")
+  {
+    ezProfilingSystem::StreamingCaptureSettings settings;
+    settings.m_sFile = sFile;
+    settings.m_FlushInterval = ezTime::MakeFromMilliseconds(5);
+    settings.m_HitchThreshold = ezTime::MakeFromMilliseconds(20);
+
+    EZ_TEST_BOOL(ezProfilingSystem::StartStreamingCapture(settings).Succeeded());
+    EZ_TEST_BOOL(ezProfilingSystem::IsStreamingCaptureActive());
+
+    ezProfilingSystem::StartNewFrame();
+
+    // more events than fit into one block
+    for (ezUInt32 i = 0; i < 10000; ++i)
+    {
+      EZ_PROFILE_SCOPE("Streamed scope");
+    }
+
+    ezProfilingSystem::StartNewFrame();
+
+    ezTime middleTime;
+    {
+      EZ_PROFILE_SCOPE("Hitch scope");
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(30));
+      middleTime = ezTime::Now();
+    }
+
+    ezProfilingSystem::StartNewFrame();
+
+    {
+      ezStringBuilder sName("Late scope");
+      EZ_PROFILE_SCOPE(sName);
+    }
+
+    ezProfilingSystem::StopStreamingCapture();
+    EZ_TEST_BOOL(!ezProfilingSystem::IsStreamingCaptureActive());
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezDynamicArray<ezTime> hitches;
+    if (!EZ_TEST_BOOL(ezProfilingSystem::ReadStreamingCapture(sFile, profilingData, ezTime::MakeZero(), ezTime::MakeZero(), &hitches).Succeeded()))
+      return;
+
+    ezUInt32 uiStreamed = 0;
+    ezUInt32 uiHitch = 0;
+    ezUInt32 uiLate = 0;
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        uiStreamed += ezStringUtils::IsEqual(scope.m_szName, "Streamed scope") ? 1 : 0;
+        uiHitch += ezStringUtils::IsEqual(scope.m_szName, "Hitch scope") ? 1 : 0;
+        uiLate += ezStringUtils::IsEqual(scope.m_szName, "Late scope") ? 1 : 0;
+      }
+    }
+
+    EZ_TEST_INT(uiStreamed, 10000);
+    EZ_TEST_INT(uiHitch, 1);
+    EZ_TEST_INT(uiLate, 1);
+    EZ_TEST_INT(profilingData.m_FrameStartTimes.GetCount(), 3);
+    EZ_TEST_INT(hitches.GetCount(), 1);
+
+    // a window after the hitch scope started only contains what overlaps with it
+    if (EZ_TEST_BOOL(ezProfilingSystem::ReadStreamingCapture(sFile, profilingData, middleTime, middleTime).Succeeded()))
+    {
+      ezUInt32 uiNumScopes = 0;
+      for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+      {
+        for (const auto& scope : eventBuffer.m_Data)
+        {
+          EZ_TEST_STRING(scope.m_szName, "Hitch scope");
+          ++uiNumScopes;
+        }
+      }
+
+      EZ_TEST_INT(uiNumScopes, 1);
+    }
+
+    // the result can be converted to JSON like a regular capture
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    EZ_TEST_BOOL(profilingData.Write(writer).Succeeded());
+    EZ_TEST_BOOL(storage.GetStorageSize64() > 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Only Hitches")
+  {
+    ezProfilingSystem::StreamingCaptureSettings settings;
+    settings.m_sFile = sFile;
+    settings.m_FlushInterval = ezTime::MakeFromMilliseconds(5);
+    settings.m_HitchWindow = ezTime::MakeFromMilliseconds(50);
+    settings.m_bOnlyWriteHitches = true;
+
+    EZ_TEST_BOOL(ezProfilingSystem::StartStreamingCapture(settings).Succeeded());
+
+    {
+      EZ_PROFILE_SCOPE("Long before the hitch");
+    }
+
+    // lets the streaming thread discard the first scope
+    ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(200));
+
+    {
+      EZ_PROFILE_SCOPE("Shortly before the hitch");
+    }
+
+    ezProfilingSystem::TriggerStreamingCaptureHitch();
+
+    {
+      EZ_PROFILE_SCOPE("Shortly after the hitch");
+    }
+
+    ezProfilingSystem::StopStreamingCapture();
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezDynamicArray<ezTime> hitches;
+    if (!EZ_TEST_BOOL(ezProfilingSystem::ReadStreamingCapture(sFile, profilingData, ezTime::MakeZero(), ezTime::MakeZero(), &hitches).Succeeded()))
+      return;
+
+    ezHybridArray<ezString, 4> names;
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        names.PushBack(scope.m_szName);
+      }
+    }
+
+    EZ_TEST_INT(hitches.GetCount(), 1);
+    EZ_TEST_BOOL(!names.Contains("Long before the hitch"));
+    EZ_TEST_BOOL(names.Contains("Shortly before the hitch"));
+    EZ_TEST_BOOL(names.Contains("Shortly after the hitch"));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Thread Exit")
+  {
+    ezProfilingSystem::StreamingCaptureSettings settings;
+    settings.m_sFile = sFile;
+
+    EZ_TEST_BOOL(ezProfilingSystem::StartStreamingCapture(settings).Succeeded());
+
+    // the events of a thread that exits before the next flush are still written
+    ProfiledThread thread;
+    thread.Start();
+    thread.Join();
+
+    ezProfilingSystem::StopStreamingCapture();
+
+    ezProfilingSystem::ProfilingData profilingData;
+    if (!EZ_TEST_BOOL(ezProfilingSystem::ReadStreamingCapture(sFile, profilingData).Succeeded()))
+      return;
+
+    ezUInt32 uiNumScopes = 0;
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        uiNumScopes += ezStringUtils::IsEqual(scope.m_szName, "Scope of exited thread") ? 1 : 0;
+      }
+    }
+
+    EZ_TEST_INT(uiNumScopes, 100);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Stop While Recording")
+  {
+    ezProfilingSystem::StreamingCaptureSettings settings;
+    settings.m_sFile = sFile;
+    settings.m_FlushInterval = ezTime::MakeFromMilliseconds(1);
+
+    ezAtomicBool bStop;
+    ezHybridArray<ezUniquePtr<RecordingThread>, 4> threads;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      threads.PushBack(EZ_DEFAULT_NEW(RecordingThread, bStop));
+      threads.PeekBack()->Start();
+    }
+
+    // the threads keep filling and retiring blocks while the capture is stopped
+    for (ezUInt32 uiRun = 0; uiRun < 20; ++uiRun)
+    {
+      EZ_TEST_BOOL(ezProfilingSystem::StartStreamingCapture(settings).Succeeded());
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(5));
+      ezProfilingSystem::StopStreamingCapture();
+    }
+
+    bStop = true;
+    for (auto& pThread : threads)
+    {
+      pThread->Join();
+    }
+
+    EZ_TEST_BOOL(!ezProfilingSystem::IsStreamingCaptureActive());
+
+    ezProfilingSystem::ProfilingData profilingData;
+    if (EZ_TEST_BOOL(ezProfilingSystem::ReadStreamingCapture(sFile, profilingData).Succeeded()))
+    {
+      EZ_TEST_BOOL(FindCapturedScope(profilingData, "Scope of recording thread") != nullptr);
+    }
+  }
+
+  ezProfilingSystem::SetDiscardThreshold(ezTime::MakeFromMilliseconds(0.1));
+  ezProfilingSystem::Clear();
 }
@@ -0,0 +1,167 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Utilities/Metrics.h>
+#include <Foundation/Utilities/Stats.h>
+
+EZ_CREATE_SIMPLE_TEST(Utility, Metrics)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Counter")
+  {
+    ezMetricCounter counter("MetricsTest/Counter");
+    EZ_TEST_INT(counter.GetValue(), 0);
+    EZ_TEST_INT(counter.GetType(), ezMetricType::Counter);
+
+    counter.Add();
+    counter.Add(9);
+    EZ_TEST_INT(counter.GetValue(), 10);
+
+    ezTaskSystem::ParallelForIndexed(0u, 10000u, [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+      for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+      {
+        counter.Add(2);
+      }
+    });
+
+    EZ_TEST_INT(counter.GetValue(), 20010);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Gauge")
+  {
+    ezMetricGauge gauge("MetricsTest/Gauge");
+    EZ_TEST_DOUBLE(gauge.GetValue(), 0.0, 0.0);
+
+    gauge.Set(2.5);
+    EZ_TEST_DOUBLE(gauge.GetValue(), 2.5, 0.0);
+
+    gauge.Add(-4.0);
+    EZ_TEST_DOUBLE(gauge.GetValue(), -1.5, 0.0);
+
+    ezTaskSystem::ParallelForIndexed(0u, 1000u, [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+      for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+      {
+        gauge.Add(0.5);
+      }
+    });
+
+    EZ_TEST_DOUBLE(gauge.GetValue(), 498.5, 0.0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Histogram")
+  {
+    const double bounds[] = {1.0, 2.0, 4.0, 8.0};
+    ezMetricHistogram histogram("MetricsTest/Histogram", bounds);
+
+    EZ_TEST_INT(histogram.GetBucketCount(), 4);
+    EZ_TEST_DOUBLE(histogram.GetBucketUpperBound(2), 4.0, 0.0);
+    EZ_TEST_DOUBLE(histogram.GetPercentile(0.5), 0.0, 0.0);
+
+    // 50 values in [0, 1], 30 in (1, 2], 19 in (4, 8] and one that overflows
+    for (ezUInt32 i = 0; i < 50; ++i)
+      histogram.Record(1.0);
+    for (ezUInt32 i = 0; i < 30; ++i)
+      histogram.Record(1.5);
+    for (ezUInt32 i = 0; i < 19; ++i)
+      histogram.Record(5.0);
+    histogram.Record(100.0);
+
+    EZ_TEST_INT(histogram.GetCount(), 100);
+    EZ_TEST_DOUBLE(histogram.GetSum(), 50.0 + 45.0 + 95.0 + 100.0, 0.0);
+    EZ_TEST_INT(histogram.GetBucketValueCount(0), 50);
+    EZ_TEST_INT(histogram.GetBucketValueCount(1), 30);
+    EZ_TEST_INT(histogram.GetBucketValueCount(2), 0);
+    EZ_TEST_INT(histogram.GetBucketValueCount(3), 19);
+    EZ_TEST_INT(histogram.GetBucketValueCount(4), 1);
+
+    EZ_TEST_DOUBLE(histogram.GetPercentile(0.25), 0.5, 0.0001);
+    EZ_TEST_DOUBLE(histogram.GetPercentile(0.5), 1.0, 0.0001);
+    EZ_TEST_DOUBLE(histogram.GetPercentile(0.65), 1.5, 0.0001);
+    EZ_TEST_DOUBLE(histogram.GetPercentile(0.99), 8.0, 0.0001);
+    EZ_TEST_DOUBLE(histogram.GetPercentile(1.0), 8.0, 0.0001);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Publish")
+  {
+    ezMetricCounter counter("MetricsTest/Published/Counter");
+    ezMetricGauge gauge("MetricsTest/Published/Gauge");
+
+    const double bounds[] = {10.0, 20.0};
+    ezMetricHistogram histogram("MetricsTest/Published/Histogram", bounds);
+
+    counter.Add(7);
+    gauge.Set(0.25);
+    histogram.Record(5.0);
+    histogram.Record(15.0);
+
+    ezMetrics::Publish();
+
+    EZ_TEST_INT(ezStats::GetStat("MetricsTest/Published/Counter").ConvertTo<ezInt64>(), 7);
+    EZ_TEST_DOUBLE(ezStats::GetStat("MetricsTest/Published/Gauge").ConvertTo<double>(), 0.25, 0.0);
+    EZ_TEST_INT(ezStats::GetStat("MetricsTest/Published/Histogram/Count").ConvertTo<ezInt64>(), 2);
+    EZ_TEST_DOUBLE(ezStats::GetStat("MetricsTest/Published/Histogram/Mean").ConvertTo<double>(), 10.0, 0.0);
+    EZ_TEST_DOUBLE(ezStats::GetStat("MetricsTest/Published/Histogram/P50").ConvertTo<double>(), 10.0, 0.0001);
+
+    ezStats::RemoveStat("MetricsTest/Published/Counter");
+    ezStats::RemoveStat("MetricsTest/Published/Gauge");
+    ezStats::RemoveStat("MetricsTest/Published/Histogram/Count");
+    ezStats::RemoveStat("MetricsTest/Published/Histogram/Mean");
+    ezStats::RemoveStat("MetricsTest/Published/Histogram/P50");
+    ezStats::RemoveStat("MetricsTest/Published/Histogram/P95");
+    ezStats::RemoveStat("MetricsTest/Published/Histogram/P99");
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "WriteText")
+  {
+    ezMetricCounter counter("MetricsTest/Text Counter");
+
+    const double bounds[] = {1.0, 2.0};
+    ezMetricHistogram histogram("MetricsTest/Text Histogram", bounds);
+
+    counter.Add(3);
+    histogram.Record(0.5);
+    histogram.Record(1.5);
+    histogram.Record(3.0);
+
+    ezStringBuilder sText;
+    ezMetrics::WriteText(sText);
+
+    EZ_TEST_BOOL(sText.FindSubString("# TYPE ez_MetricsTest_Text_Counter counter\nez_MetricsTest_Text_Counter 3\n") != nullptr);
+    EZ_TEST_BOOL(sText.FindSubString("# TYPE ez_MetricsTest_Text_Histogram histogram\n") != nullptr);
+    EZ_TEST_BOOL(sText.FindSubString("ez_MetricsTest_Text_Histogram_bucket{le=\"1\"} 1\n") != nullptr);
+    EZ_TEST_BOOL(sText.FindSubString("ez_MetricsTest_Text_Histogram_bucket{le=\"2\"} 2\n") != nullptr);
+    EZ_TEST_BOOL(sText.FindSubString("ez_MetricsTest_Text_Histogram_bucket{le=\"+Inf\"} 3\n") != nullptr);
+    EZ_TEST_BOOL(sText.FindSubString("ez_MetricsTest_Text_Histogram_sum 5\n") != nullptr);
+    EZ_TEST_BOOL(sText.FindSubString("ez_MetricsTest_Text_Histogram_count 3\n") != nullptr);
+
+    ezStringBuilder sFile = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    sFile.AppendPath("Metrics.prom");
+
+    // the second write replaces the existing file
+    EZ_TEST_BOOL(ezMetrics::WriteToFile(sFile).Succeeded());
+    EZ_TEST_BOOL(ezMetrics::WriteToFile(sFile).Succeeded());
+
+    ezOSFile file;
+    if (EZ_TEST_BOOL(file.Open(sFile, ezFileOpenMode::Read).Succeeded()))
+    {
+      ezDynamicArray<ezUInt8> content;
+      file.ReadAll(content);
+      file.Close();
+
+      EZ_TEST_INT(content.GetCount(), sText.GetElementCount());
+    }
+
+    EZ_TEST_BOOL(ezOSFile::DeleteFile(sFile).Succeeded());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Unregister")
+  {
+    {
+      ezMetricCounter counter("MetricsTest/Temporary");
+    }
+
+    ezStringBuilder sText;
+    ezMetrics::WriteText(sText);
+    EZ_TEST_BOOL(sText.FindSubString("MetricsTest_Temporary") == nullptr);
+  }
+}
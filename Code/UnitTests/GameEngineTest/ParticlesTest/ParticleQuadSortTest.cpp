@@ -0,0 +1,101 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Foundation/Algorithm/Sorting.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <ParticlePlugin/Type/Quad/ParticleTypeQuad.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Particles);
+
+EZ_CREATE_SIMPLE_TEST(Particles, QuadSorting)
+{
+  constexpr ezUInt32 uiNumParticles = 100000;
+  constexpr ezUInt32 uiNumFrames = 10;
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> positions;
+  positions.SetCountUninitialized(uiNumParticles);
+  for (ezUInt32 i = 0; i < uiNumParticles; ++i)
+  {
+    positions[i] = ezSimdVec4f(rng.FloatMinMax(-100.0f, 100.0f), rng.FloatMinMax(-100.0f, 100.0f), rng.FloatMinMax(-100.0f, 100.0f), 0.0f);
+  }
+
+  ezDynamicArray<ezParticleTypeQuad::sod> keys;
+  ezDynamicArray<ezParticleTypeQuad::sod> scratch;
+  keys.SetCountUninitialized(uiNumParticles);
+  scratch.SetCountUninitialized(uiNumParticles);
+
+  ezDynamicArray<ezUInt32> sortedIndices;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Back to front")
+  {
+    const ezVec3 vCameraPos(10, 20, 30);
+    ezParticleTypeQuad::SortBackToFront(positions, vCameraPos, keys, scratch, sortedIndices);
+
+    EZ_TEST_INT(sortedIndices.GetCount(), uiNumParticles);
+
+    const ezSimdVec4f vSimdCameraPos = ezSimdConversion::ToVec3(vCameraPos);
+
+    ezUInt32 uiNumWrongOrder = 0;
+    float fPrevDistSqr = ezMath::MaxValue<float>();
+    for (ezUInt32 idx : sortedIndices)
+    {
+      const float fDistSqr = (positions[idx] - vSimdCameraPos).GetLengthSquared<3>();
+      uiNumWrongOrder += fDistSqr > fPrevDistSqr ? 1 : 0;
+      fPrevDistSqr = fDistSqr;
+    }
+
+    EZ_TEST_INT(uiNumWrongOrder, 0);
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezTestBlock::Enum profileBlock = ezTestBlock::DisabledNoWarning;
+#else
+  const ezTestBlock::Enum profileBlock = ezTestBlock::Enabled;
+#endif
+
+  EZ_TEST_BLOCK(profileBlock, "Extract 100,000 particles")
+  {
+    // what the extraction did before it used the radix sort: compute the distances and sort them with a comparison sort
+    struct DistanceAndIndex
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      float m_fDistance;
+      ezUInt32 m_uiIndex;
+    };
+
+    ezDynamicArray<DistanceAndIndex> comparisonSorted;
+    comparisonSorted.SetCountUninitialized(uiNumParticles);
+
+    ezStopwatch sw;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      const ezSimdVec4f vSimdCameraPos = ezSimdConversion::ToVec3(ezVec3(static_cast<float>(uiFrame), 0, 0));
+
+      for (ezUInt32 p = 0; p < uiNumParticles; ++p)
+      {
+        comparisonSorted[p].m_fDistance = (positions[p] - vSimdCameraPos).GetLengthSquared<3>();
+        comparisonSorted[p].m_uiIndex = p;
+      }
+
+      comparisonSorted.Sort([](const DistanceAndIndex& a, const DistanceAndIndex& b)
+        { return a.m_fDistance > b.m_fDistance; });
+    }
+
+    const ezTime tComparisonSort = sw.Checkpoint();
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      ezParticleTypeQuad::SortBackToFront(positions, ezVec3(static_cast<float>(uiFrame), 0, 0), keys, scratch, sortedIndices);
+    }
+
+    const ezTime tRadixSort = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Sorting %u particles: comparison sort %.2fms, radix sort %.2fms per frame", uiNumParticles, tComparisonSort.GetMilliseconds() / uiNumFrames, tRadixSort.GetMilliseconds() / uiNumFrames);
+  }
+}
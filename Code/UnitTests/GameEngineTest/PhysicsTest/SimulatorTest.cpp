@@ -0,0 +1,162 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <GameEngine/Physics/ClothSheetSimulator.h>
+#include <GameEngine/Physics/RopeSimulator.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Physics);
+
+namespace
+{
+  void SetupRope(ezRopeSimulator& ref_rope, ezUInt32 uiNumNodes, float fAnchorDistance)
+  {
+    ref_rope.m_fSegmentLength = 0.1f;
+    ref_rope.m_Nodes.SetCount(uiNumNodes);
+
+    for (ezUInt32 i = 0; i < uiNumNodes; ++i)
+    {
+      ref_rope.m_Nodes[i].m_vPosition = ezSimdVec4f(i * fAnchorDistance / (uiNumNodes - 1), 0, 0);
+      ref_rope.m_Nodes[i].m_vPreviousPosition = ref_rope.m_Nodes[i].m_vPosition;
+    }
+  }
+
+  void SetupCloth(ezClothSimulator& ref_cloth, ezUInt8 uiSize)
+  {
+    ref_cloth.m_uiWidth = uiSize;
+    ref_cloth.m_uiHeight = uiSize;
+    ref_cloth.m_vAcceleration.Set(0, 0, -10);
+    ref_cloth.m_Nodes.SetCount(uiSize * uiSize);
+
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        auto& node = ref_cloth.m_Nodes[y * uiSize + x];
+        node.m_vPosition = ezSimdVec4f(x * ref_cloth.m_vSegmentLength.x, y * ref_cloth.m_vSegmentLength.y, 0);
+        node.m_vPreviousPosition = node.m_vPosition;
+      }
+    }
+
+    // hang the cloth at its two top corners
+    ref_cloth.m_Nodes[0].m_bFixed = true;
+    ref_cloth.m_Nodes[uiSize - 1].m_bFixed = true;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Physics, RopeSimulator)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Settled Positions")
+  {
+    // a 2m rope, hanging between two points that are 1.5m apart
+    ezRopeSimulator rope;
+    SetupRope(rope, 21, 1.5f);
+    rope.SimulateTillEquilibrium(0.001f, 1000);
+
+    EZ_TEST_BOOL(rope.HasEquilibrium(0.001f));
+    EZ_TEST_FLOAT(rope.GetTotalLength(), 2.105f, 0.005f);
+
+    // where the nodes settled with the previous solver, which moved one node after the other
+    const ezVec3 expected[] = {
+      ezVec3(0.0f, 0, 0.0f),
+      ezVec3(0.0957f, 0, -0.1892f),
+      ezVec3(0.2147f, 0, -0.3635f),
+      ezVec3(0.3634f, 0, -0.5115f),
+      ezVec3(0.5445f, 0, -0.6153f),
+      ezVec3(0.7489f, 0, -0.6537f),
+      ezVec3(0.9536f, 0, -0.6160f),
+      ezVec3(1.1352f, 0, -0.5124f),
+      ezVec3(1.2846f, 0, -0.3641f),
+      ezVec3(1.4041f, 0, -0.1893f),
+      ezVec3(1.5f, 0, 0.0f),
+    };
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(expected); ++i)
+    {
+      EZ_TEST_VEC3(ezSimdConversion::ToVec3(rope.m_Nodes[i * 2].m_vPosition), expected[i], 0.005f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Loose End")
+  {
+    ezRopeSimulator rope;
+    SetupRope(rope, 10, 0.9f);
+    rope.m_bLastNodeIsFixed = false;
+    rope.SimulateRope(ezTime::MakeFromSeconds(60));
+
+    // the rope ends up hanging straight down from its fixed end
+    // the constraints are only solved up to the allowed error, so it stretches a bit under its own weight and keeps bobbing slightly
+    EZ_TEST_VEC3(ezSimdConversion::ToVec3(rope.m_Nodes[0].m_vPosition), ezVec3(0, 0, 0), 0.0001f);
+    EZ_TEST_VEC3(ezSimdConversion::ToVec3(rope.m_Nodes.PeekBack().m_vPosition), ezVec3(0, 0, -1.0f), 0.01f);
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezTestBlock::Enum profileBlock = ezTestBlock::DisabledNoWarning;
+#else
+  const ezTestBlock::Enum profileBlock = ezTestBlock::Enabled;
+#endif
+
+  EZ_TEST_BLOCK(profileBlock, "Simulate 1,000 nodes")
+  {
+    ezRopeSimulator rope;
+    SetupRope(rope, 1000, 80.0f);
+
+    ezStopwatch sw;
+    rope.SimulateRope(ezTime::MakeFromSeconds(10));
+    const ezTime tSimulate = sw.GetRunningTotal();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Rope with 1,000 nodes: %.3fms per step", tSimulate.GetMilliseconds() / 600.0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Physics, ClothSimulator)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Settled Positions")
+  {
+    ezClothSimulator cloth;
+    SetupCloth(cloth, 16);
+    cloth.SimulateCloth(ezTime::MakeFromSeconds(60));
+
+    EZ_TEST_BOOL(cloth.HasEquilibrium(0.001f));
+
+    // where the nodes settled with the previous solver, which moved one node after the other
+    struct Expected
+    {
+      ezUInt32 m_uiNode;
+      ezVec3 m_vPosition;
+    };
+
+    const Expected expected[] = {
+      {0, ezVec3(0.0f, 0, 0.0f)},
+      {15, ezVec3(1.5f, 0, 0.0f)},
+      {7, ezVec3(0.6962f, 0, -0.2733f)},
+      {136, ezVec3(0.7999f, 0, -1.0786f)},
+      {240, ezVec3(0.0781f, 0, -1.4941f)},
+      {247, ezVec3(0.6996f, 0, -1.7804f)},
+      {255, ezVec3(1.4216f, 0, -1.4941f)},
+    };
+
+    for (const Expected& e : expected)
+    {
+      EZ_TEST_VEC3(ezSimdConversion::ToVec3(cloth.m_Nodes[e.m_uiNode].m_vPosition), e.m_vPosition, 0.005f);
+    }
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezTestBlock::Enum profileBlock = ezTestBlock::DisabledNoWarning;
+#else
+  const ezTestBlock::Enum profileBlock = ezTestBlock::Enabled;
+#endif
+
+  EZ_TEST_BLOCK(profileBlock, "Simulate 32x32 nodes")
+  {
+    ezClothSimulator cloth;
+    SetupCloth(cloth, 32);
+
+    ezStopwatch sw;
+    cloth.SimulateCloth(ezTime::MakeFromSeconds(10));
+    const ezTime tSimulate = sw.GetRunningTotal();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Cloth with 32x32 nodes: %.3fms per step", tSimulate.GetMilliseconds() / 600.0);
+  }
+}
@@ -1,6 +1,8 @@
 #include <GameEngineTest/GameEngineTestPCH.h>
 
 #include "VisualScriptTest.h"
+#include <Core/Scripting/ScriptComponent.h>
+#include <Core/Scripting/ScriptWorldModule.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 
@@ -29,6 +31,7 @@ void ezGameEngineTestVisualScript::SetupSubTests()
   AddSubTest("Properties", SubTests::Properties);
   AddSubTest("Arrays", SubTests::Arrays);
   AddSubTest("Expressions", SubTests::Expressions);
+  AddSubTest("ParallelUpdate", SubTests::ParallelUpdate);
 }
 
 ezResult ezGameEngineTestVisualScript::InitializeSubTest(ezInt32 iIdentifier)
@@ -126,12 +129,27 @@ ezResult ezGameEngineTestVisualScript::InitializeSubTest(ezInt32 iIdentifier)
     EZ_SUCCEED_OR_RETURN(m_pOwnApplication->LoadScene("VisualScript/AssetCache/Common/Scenes/Expressions.ezObjectGraph"));
     return EZ_SUCCESS;
   }
+  else if (iIdentifier == SubTests::ParallelUpdate)
+  {
+    m_pTestLog = EZ_DEFAULT_NEW(TestLog);
+    m_pTestLog->m_Interface.ExpectMessage("can't be updated in parallel and is updated serially instead", ezLogMsgType::WarningMsg);
+
+    EZ_SUCCEED_OR_RETURN(m_pOwnApplication->LoadScene("VisualScript/AssetCache/Common/Scenes/Variables.ezObjectGraph"));
+
+    CreateParallelUpdateTestObjects();
+    return EZ_SUCCESS;
+  }
 
   return EZ_FAILURE;
 }
 
 ezTestAppRun ezGameEngineTestVisualScript::RunSubTest(ezInt32 iIdentifier, ezUInt32 uiInvocationCount)
 {
+  if (iIdentifier == SubTests::ParallelUpdate)
+  {
+    return RunParallelUpdateTest();
+  }
+
   const bool bVulkan = ezGameApplication::GetActiveRenderer().IsEqual_NoCase("Vulkan");
   ++m_iFrame;
 
@@ -155,3 +173,161 @@ ezTestAppRun ezGameEngineTestVisualScript::RunSubTest(ezInt32 iIdentifier, ezUIn
 
   return ezTestAppRun::Continue;
 }
+
+static constexpr ezUInt32 s_uiNumParallelUpdateObjects = 256;
+static constexpr ezInt32 s_iNumParallelUpdateFrames = 30;
+
+void ezGameEngineTestVisualScript::CreateParallelUpdateTestObjects()
+{
+  m_ParallelUpdateComponents.Clear();
+  m_hSerialReferenceComponent.Invalidate();
+  m_hSerialFallbackComponent.Invalidate();
+  m_uiNumParallelCallsBefore = 0;
+  m_SerialUpdateTime = ezTime::MakeZero();
+  m_ParallelUpdateTime = ezTime::MakeZero();
+
+  ezWorld* pWorld = m_pOwnApplication->GetWorld();
+  EZ_LOCK(pWorld->GetWriteMarker());
+
+  auto pManager = pWorld->GetOrCreateComponentManager<ezScriptComponentManager>();
+
+  // use the first script in the scene as the template for all clones
+  const ezScriptComponent* pTemplate = nullptr;
+  for (auto it = pManager->GetComponents(); it.IsValid(); ++it)
+  {
+    pTemplate = it;
+    break;
+  }
+
+  if (!EZ_TEST_BOOL(pTemplate != nullptr))
+    return;
+
+  ezGameObjectDesc desc;
+  desc.m_LocalPosition = pTemplate->GetOwner()->GetGlobalPosition();
+
+  // the last clone is always updated serially and serves as the reference for all others
+  for (ezUInt32 i = 0; i < s_uiNumParallelUpdateObjects + 1; ++i)
+  {
+    ezGameObject* pObject = nullptr;
+    pWorld->CreateObject(desc, pObject);
+
+    ezScriptComponent* pComponent = nullptr;
+    ezComponentHandle hComponent = pManager->CreateComponent(pObject, pComponent);
+
+    for (const char* szKey : pTemplate->GetParameters())
+    {
+      ezVariant value;
+      if (pTemplate->GetParameter(szKey, value))
+      {
+        pComponent->SetParameter(szKey, value);
+      }
+    }
+
+    pComponent->SetScriptClass(pTemplate->GetScriptClass());
+
+    if (i < s_uiNumParallelUpdateObjects)
+    {
+      m_ParallelUpdateComponents.PushBack(hComponent);
+    }
+    else
+    {
+      m_hSerialReferenceComponent = hComponent;
+    }
+  }
+
+  // a script that modifies the world, it must be updated serially even though it asks for a parallel update
+  {
+    ezGameObject* pObject = nullptr;
+    pWorld->CreateObject(desc, pObject);
+
+    ezScriptComponent* pComponent = nullptr;
+    m_hSerialFallbackComponent = pManager->CreateComponent(pObject, pComponent);
+    pComponent->SetScriptClassFile("{ 71425a36-fe5c-4145-a9eb-3ba4dc5f0b8d }"); // ExpressionScript
+  }
+}
+
+ezTestAppRun ezGameEngineTestVisualScript::RunParallelUpdateTest()
+{
+  ++m_iFrame;
+
+  // first measure all scripts being updated serially, then the same number of frames with the clones updated in parallel
+  if (m_iFrame == s_iNumParallelUpdateFrames)
+  {
+    ezWorld* pWorld = m_pOwnApplication->GetWorld();
+    EZ_LOCK(pWorld->GetWriteMarker());
+
+    for (auto hComponent : m_ParallelUpdateComponents)
+    {
+      ezScriptComponent* pComponent = nullptr;
+      if (pWorld->TryGetComponent(hComponent, pComponent))
+      {
+        pComponent->SetUpdateInParallel(true);
+      }
+    }
+
+    ezScriptComponent* pComponent = nullptr;
+    if (pWorld->TryGetComponent(m_hSerialFallbackComponent, pComponent))
+    {
+      pComponent->SetUpdateInParallel(true);
+    }
+
+    m_uiNumParallelCallsBefore = pWorld->GetOrCreateModule<ezScriptWorldModule>()->GetNumParallelUpdateFunctionCalls();
+  }
+
+  const ezTime startTime = ezTime::Now();
+
+  if (m_pOwnApplication->Run() == ezApplication::Execution::Quit)
+  {
+    m_pTestLog = nullptr;
+    return ezTestAppRun::Quit;
+  }
+
+  // skip the first frame, it includes loading and initializing the scene
+  if (m_iFrame > 0)
+  {
+    const ezTime frameTime = ezTime::Now() - startTime;
+    (m_iFrame < s_iNumParallelUpdateFrames ? m_SerialUpdateTime : m_ParallelUpdateTime) += frameTime;
+  }
+
+  if (m_iFrame < 2 * s_iNumParallelUpdateFrames)
+    return ezTestAppRun::Continue;
+
+  m_pTestLog = nullptr;
+
+  ezWorld* pWorld = m_pOwnApplication->GetWorld();
+  EZ_LOCK(pWorld->GetWriteMarker());
+
+  // the clones have to be updated through the parallel update, at least once per frame
+  const ezUInt64 uiNumParallelCalls = pWorld->GetOrCreateModule<ezScriptWorldModule>()->GetNumParallelUpdateFunctionCalls() - m_uiNumParallelCallsBefore;
+  EZ_TEST_BOOL(uiNumParallelCalls >= s_uiNumParallelUpdateObjects * s_iNumParallelUpdateFrames);
+
+  const ezScriptComponent* pFallback = nullptr;
+  if (EZ_TEST_BOOL(pWorld->TryGetComponent(m_hSerialFallbackComponent, pFallback)))
+  {
+    EZ_TEST_BOOL(pFallback->GetUpdateInParallel());
+    EZ_TEST_BOOL(!pFallback->IsUpdatedInParallel());
+  }
+
+  const ezScriptComponent* pReference = nullptr;
+  if (EZ_TEST_BOOL(pWorld->TryGetComponent(m_hSerialReferenceComponent, pReference)))
+  {
+    const ezHashedString sCounter = ezMakeHashedString("Counter");
+    const ezVariant referenceCounter = pReference->GetScriptVariable(sCounter);
+
+    for (auto hComponent : m_ParallelUpdateComponents)
+    {
+      const ezScriptComponent* pComponent = nullptr;
+      if (EZ_TEST_BOOL(pWorld->TryGetComponent(hComponent, pComponent)))
+      {
+        EZ_TEST_BOOL(pComponent->IsUpdatedInParallel());
+        EZ_TEST_BOOL(pComponent->GetScriptVariable(sCounter) == referenceCounter);
+      }
+    }
+  }
+
+  const double fSerialFrameMS = m_SerialUpdateTime.GetMilliseconds() / (s_iNumParallelUpdateFrames - 1);
+  const double fParallelFrameMS = m_ParallelUpdateTime.GetMilliseconds() / s_iNumParallelUpdateFrames;
+  ezLog::Info("Updating {} scripts: serial {} ms/frame, parallel {} ms/frame, speedup {}x", s_uiNumParallelUpdateObjects, ezArgF(fSerialFrameMS, 3), ezArgF(fParallelFrameMS, 3), ezArgF(fSerialFrameMS / ezMath::Max(fParallelFrameMS, 0.001), 2));
+
+  return ezTestAppRun::Quit;
+}
@@ -26,7 +26,8 @@ protected:
     Properties,
     Arrays,
     Maps,
-    Expressions
+    Expressions,
+    ParallelUpdate
   };
 
   virtual void SetupSubTests() override;
@@ -35,12 +36,22 @@ protected:
 
   void RunBuiltinsTest();
 
+  void CreateParallelUpdateTestObjects();
+  ezTestAppRun RunParallelUpdateTest();
+
   ezInt32 m_iFrame = 0;
   ezGameEngineTestApplication* m_pOwnApplication = nullptr;
 
   ezUInt32 m_uiImgCompIdx = 0;
   ezHybridArray<ezUInt32, 8> m_ImgCompFrames;
 
+  ezDynamicArray<ezComponentHandle> m_ParallelUpdateComponents;
+  ezComponentHandle m_hSerialReferenceComponent;
+  ezComponentHandle m_hSerialFallbackComponent;
+  ezUInt64 m_uiNumParallelCallsBefore = 0;
+  ezTime m_SerialUpdateTime;
+  ezTime m_ParallelUpdateTime;
+
   struct TestLog
   {
     ezTestLogInterface m_Interface;
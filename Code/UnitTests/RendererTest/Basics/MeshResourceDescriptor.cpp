@@ -0,0 +1,272 @@
+#include <RendererTest/RendererTestPCH.h>
+
+#include <Foundation/IO/ChunkStream.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+#  include <Foundation/IO/CompressedStreamZstd.h>
+#endif
+
+namespace
+{
+  /// Creates a grid with uiSize * uiSize vertices, with the triangles in random order, like an unoptimized mesh.
+  void CreateGridMesh(ezMeshResourceDescriptor& ref_desc, ezUInt32 uiSize, ezGALResourceFormat::Enum secondStreamFormat)
+  {
+    auto& mb = ref_desc.MeshBufferDesc();
+    mb.AddStream(ezGALVertexAttributeSemantic::Position, ezGALResourceFormat::XYZFloat);
+    mb.AddStream(ezGALVertexAttributeSemantic::TexCoord0, secondStreamFormat);
+
+    const ezUInt32 uiNumTriangles = (uiSize - 1) * (uiSize - 1) * 2;
+    mb.AllocateStreams(uiSize * uiSize, ezGALPrimitiveTopology::Triangles, uiNumTriangles, true);
+
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        mb.SetVertexData<ezVec3>(0, y * uiSize + x, ezVec3(static_cast<float>(x), static_cast<float>(y), 0.01f * ((x * y) % 7)));
+      }
+    }
+
+    ezDynamicArray<ezUInt32> triangles;
+    triangles.SetCountUninitialized(uiNumTriangles);
+    for (ezUInt32 i = 0; i < uiNumTriangles; ++i)
+    {
+      triangles[i] = i;
+    }
+
+    ezRandom rng;
+    rng.Initialize(uiSize);
+
+    for (ezUInt32 i = uiNumTriangles - 1; i > 0; --i)
+    {
+      ezMath::Swap(triangles[i], triangles[rng.UIntInRange(i + 1)]);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumTriangles; ++i)
+    {
+      const ezUInt32 uiQuad = triangles[i] / 2;
+      const ezUInt32 x = uiQuad % (uiSize - 1);
+      const ezUInt32 y = uiQuad / (uiSize - 1);
+      const ezUInt32 v = y * uiSize + x;
+
+      if ((triangles[i] % 2) == 0)
+        mb.SetTriangleIndices(i, v, v + 1, v + uiSize);
+      else
+        mb.SetTriangleIndices(i, v + 1, v + uiSize + 1, v + uiSize);
+    }
+
+    ref_desc.AddSubMesh(uiNumTriangles, 0, 0);
+    ref_desc.ComputeBounds();
+  }
+
+  /// Writes the mesh the way ezMeshResourceDescriptor::Save() did before the vertex and index buffer chunks got version 2.
+  void SaveVersion1(const ezMeshResourceDescriptor& desc, ezStreamWriter& inout_stream)
+  {
+    const auto& mb = desc.MeshBufferDesc();
+
+    ezUInt8 uiVersion = 7;
+    inout_stream << uiVersion;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    ezUInt8 uiCompressionMode = 1;
+    ezCompressedStreamWriterZstd compressor(&inout_stream, 0, ezCompressedStreamWriterZstd::Compression::Average);
+    ezChunkStreamWriter chunk(compressor);
+#else
+    ezUInt8 uiCompressionMode = 0;
+    ezChunkStreamWriter chunk(inout_stream);
+#endif
+
+    inout_stream << uiCompressionMode;
+
+    chunk.BeginStream(1);
+
+    {
+      chunk.BeginChunk("MeshInfo", 4);
+
+      chunk << mb.GetVertexCount();
+      chunk << mb.GetPrimitiveCount();
+      chunk << mb.HasIndexBuffer();
+      chunk << (mb.HasIndexBuffer() && mb.Uses32BitIndices());
+      chunk << mb.GetVertexDeclaration().m_VertexStreams.GetCount();
+      chunk << (ezUInt8)mb.GetTopology();
+
+      for (ezUInt32 idx = 0; idx < mb.GetVertexDeclaration().m_VertexStreams.GetCount(); ++idx)
+      {
+        const auto& vs = mb.GetVertexDeclaration().m_VertexStreams[idx];
+
+        chunk << idx;
+        chunk << (ezInt32)vs.m_Format;
+        chunk << (ezInt32)vs.m_Semantic;
+        chunk << vs.m_uiElementSize;
+        chunk << vs.m_uiOffset;
+      }
+
+      chunk << desc.GetBounds().m_vCenter;
+      chunk << desc.GetBounds().m_vBoxHalfExtends;
+      chunk << desc.GetBounds().m_fSphereRadius;
+      chunk << desc.m_fMaxBoneVertexOffset;
+
+      chunk.EndChunk();
+    }
+
+    {
+      chunk.BeginChunk("VertexBuffer", 1);
+      chunk << mb.GetVertexBufferData().GetCount();
+      chunk.WriteBytes(mb.GetVertexBufferData().GetPtr(), mb.GetVertexBufferData().GetCount()).IgnoreResult();
+      chunk.EndChunk();
+    }
+
+    {
+      chunk.BeginChunk("IndexBuffer", 1);
+      chunk << mb.GetIndexBufferData().GetCount();
+      chunk.WriteBytes(mb.GetIndexBufferData().GetPtr(), mb.GetIndexBufferData().GetCount()).IgnoreResult();
+      chunk.EndChunk();
+    }
+
+    chunk.EndStream();
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    compressor.FinishCompressedStream().IgnoreResult();
+#endif
+  }
+
+  /// The index codec may rotate the vertices of a triangle, but keeps the winding order and the order of the triangles.
+  bool HasSameTriangles(const ezMeshBufferResourceDescriptor& expected, const ezMeshBufferResourceDescriptor& actual)
+  {
+    if (expected.GetPrimitiveCount() != actual.GetPrimitiveCount() || expected.Uses32BitIndices() != actual.Uses32BitIndices())
+      return false;
+
+    auto GetIndex = [](const ezMeshBufferResourceDescriptor& mb, ezUInt32 i) -> ezUInt32
+    {
+      if (mb.Uses32BitIndices())
+        return reinterpret_cast<const ezUInt32*>(mb.GetIndexBufferData().GetPtr())[i];
+
+      return reinterpret_cast<const ezUInt16*>(mb.GetIndexBufferData().GetPtr())[i];
+    };
+
+    for (ezUInt32 t = 0; t < expected.GetPrimitiveCount(); ++t)
+    {
+      bool bFound = false;
+
+      for (ezUInt32 uiRotation = 0; uiRotation < 3 && !bFound; ++uiRotation)
+      {
+        bFound = true;
+
+        for (ezUInt32 v = 0; v < 3; ++v)
+        {
+          bFound &= GetIndex(expected, t * 3 + v) == GetIndex(actual, t * 3 + (v + uiRotation) % 3);
+        }
+      }
+
+      if (!bFound)
+        return false;
+    }
+
+    return true;
+  }
+
+  bool HasSameVertices(const ezMeshBufferResourceDescriptor& expected, const ezMeshBufferResourceDescriptor& actual)
+  {
+    return expected.GetVertexCount() == actual.GetVertexCount() && expected.GetVertexBufferData().GetCount() == actual.GetVertexBufferData().GetCount() &&
+           ezMemoryUtils::IsEqual(expected.GetVertexBufferData().GetPtr(), actual.GetVertexBufferData().GetPtr(), expected.GetVertexBufferData().GetCount());
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Meshes);
+
+EZ_CREATE_SIMPLE_TEST(Meshes, MeshResourceDescriptor)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Save and Load")
+  {
+    ezMeshResourceDescriptor desc;
+    CreateGridMesh(desc, 64, ezGALResourceFormat::XYFloat);
+
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    desc.Save(writer);
+
+    ezMeshResourceDescriptor loaded;
+    ezMemoryStreamReader reader(&storage);
+    EZ_TEST_BOOL(loaded.Load(reader).Succeeded());
+
+    EZ_TEST_BOOL(HasSameVertices(desc.MeshBufferDesc(), loaded.MeshBufferDesc()));
+    EZ_TEST_BOOL(HasSameTriangles(desc.MeshBufferDesc(), loaded.MeshBufferDesc()));
+    EZ_TEST_INT(loaded.GetSubMeshes().GetCount(), 1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Vertex Size Not Supported By The Codec")
+  {
+    // 14 byte vertices are not a multiple of 4 bytes, so the vertex data is stored raw
+    ezMeshResourceDescriptor desc;
+    CreateGridMesh(desc, 16, ezGALResourceFormat::RHalf);
+    EZ_TEST_INT(desc.MeshBufferDesc().GetVertexDataSize(), 14);
+
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    desc.Save(writer);
+
+    ezMeshResourceDescriptor loaded;
+    ezMemoryStreamReader reader(&storage);
+    EZ_TEST_BOOL(loaded.Load(reader).Succeeded());
+
+    EZ_TEST_BOOL(HasSameVertices(desc.MeshBufferDesc(), loaded.MeshBufferDesc()));
+    EZ_TEST_BOOL(HasSameTriangles(desc.MeshBufferDesc(), loaded.MeshBufferDesc()));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Load Version 1")
+  {
+    ezMeshResourceDescriptor desc;
+    CreateGridMesh(desc, 32, ezGALResourceFormat::XYFloat);
+
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    SaveVersion1(desc, writer);
+
+    ezMeshResourceDescriptor loaded;
+    ezMemoryStreamReader reader(&storage);
+    EZ_TEST_BOOL(loaded.Load(reader).Succeeded());
+
+    EZ_TEST_BOOL(HasSameVertices(desc.MeshBufferDesc(), loaded.MeshBufferDesc()));
+    EZ_TEST_BOOL(desc.MeshBufferDesc().GetIndexBufferData().GetCount() == loaded.MeshBufferDesc().GetIndexBufferData().GetCount() &&
+                 ezMemoryUtils::IsEqual(desc.MeshBufferDesc().GetIndexBufferData().GetData(), loaded.MeshBufferDesc().GetIndexBufferData().GetData(), desc.MeshBufferDesc().GetIndexBufferData().GetCount()));
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezTestBlock::Enum profileBlock = ezTestBlock::DisabledNoWarning;
+#else
+  const ezTestBlock::Enum profileBlock = ezTestBlock::Enabled;
+#endif
+
+  EZ_TEST_BLOCK(profileBlock, "Size and Load Time")
+  {
+    ezMeshResourceDescriptor desc;
+    CreateGridMesh(desc, 300, ezGALResourceFormat::XYZFloat);
+
+    ezDefaultMemoryStreamStorage storage1;
+    ezDefaultMemoryStreamStorage storage2;
+
+    {
+      ezMemoryStreamWriter writer1(&storage1);
+      SaveVersion1(desc, writer1);
+
+      ezMemoryStreamWriter writer2(&storage2);
+      desc.Save(writer2);
+    }
+
+    ezTime tLoad[2];
+    for (ezUInt32 uiVersion = 0; uiVersion < 2; ++uiVersion)
+    {
+      ezMeshResourceDescriptor loaded;
+      ezMemoryStreamReader reader(uiVersion == 0 ? &storage1 : &storage2);
+
+      ezStopwatch sw;
+      EZ_TEST_BOOL(loaded.Load(reader).Succeeded());
+      tLoad[uiVersion] = sw.GetRunningTotal();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u vertices, %u triangles: raw %.1f KB, loaded in %.2fms; encoded %.1f KB, loaded in %.2fms", desc.MeshBufferDesc().GetVertexCount(), desc.MeshBufferDesc().GetPrimitiveCount(), storage1.GetStorageSize64() / 1024.0, tLoad[0].GetMilliseconds(), storage2.GetStorageSize64() / 1024.0, tLoad[1].GetMilliseconds());
+  }
+}